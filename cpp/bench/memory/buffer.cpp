@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstring>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/detail/host_copy.hpp>
+#include <rapids_triton/memory/detail/host_resource.hpp>
+#include <rapids_triton/memory/detail/owned_host_buffer.hpp>
+#include <rapids_triton/memory/scratch_arena.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/* Allocation and release of a host buffer of state.range(0) bytes from
+ * different host resources */
+template <typename Resource>
+static void bench_host_allocation(benchmark::State& state)
+{
+  auto upstream = Resource{};
+  auto size     = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto buffer = detail::owned_host_buffer<char>(size, cudaStream_t{}, &upstream);
+    benchmark::DoNotOptimize(buffer.get());
+  }
+}
+
+static void bench_host_pool_allocation(benchmark::State& state)
+{
+  auto upstream = detail::pageable_host_resource{};
+  auto pool     = detail::host_pool_resource{&upstream};
+  auto size     = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto buffer = detail::owned_host_buffer<char>(size, cudaStream_t{}, &pool);
+    benchmark::DoNotOptimize(buffer.get());
+  }
+}
+
+BENCHMARK_TEMPLATE(bench_host_allocation, detail::pageable_host_resource)
+  ->RangeMultiplier(16)
+  ->Range(1 << 10, 1 << 26);
+BENCHMARK(bench_host_pool_allocation)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+/* Temporary host storage of state.range(0) bytes obtained from a scratch
+ * arena which is reset after every use */
+static void bench_scratch_allocation(benchmark::State& state)
+{
+  auto arena = scratch_arena{HostMemory, 0};
+  auto size  = static_cast<std::size_t>(state.range(0));
+  for (auto _ : state) {
+    auto buffer = arena.allocate<char>(size, cudaStream_t{});
+    benchmark::DoNotOptimize(buffer.data());
+    arena.reset();
+  }
+}
+
+BENCHMARK(bench_scratch_allocation)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+/* Copy of state.range(0) floats between buffers in the given locations */
+static void bench_buffer_copy(benchmark::State& state,
+                              MemoryType dst_mem_type,
+                              MemoryType src_mem_type)
+{
+  auto size = static_cast<std::size_t>(state.range(0));
+  auto src  = Buffer<float>(size, src_mem_type);
+  auto dst  = Buffer<float>(size, dst_mem_type);
+  for (auto _ : state) {
+    copy(dst, src);
+    dst.stream_synchronize();
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(float));
+}
+
+BENCHMARK_CAPTURE(bench_buffer_copy, host_to_host, HostMemory, HostMemory)
+  ->RangeMultiplier(16)
+  ->Range(1 << 8, 1 << 24);
+/* Gather of state.range(0) bytes from state.range(1) separate host segments,
+ * either through the host copy engine or with one memcpy per segment */
+static void bench_host_gather(benchmark::State& state, bool batched)
+{
+  auto total         = static_cast<std::size_t>(state.range(0));
+  auto segment_count = static_cast<std::size_t>(state.range(1));
+  auto segment_bytes = total / segment_count;
+  auto dst           = std::vector<char>(total);
+  auto segments      = std::vector<detail::host_copy_segment>{};
+
+  auto sources = std::vector<std::vector<char>>(segment_count, std::vector<char>(segment_bytes));
+  for (auto i = std::size_t{}; i < segment_count; ++i) {
+    segments.push_back(
+      detail::host_copy_segment{dst.data() + i * segment_bytes, sources[i].data(), segment_bytes});
+  }
+  for (auto _ : state) {
+    if (batched) {
+      detail::host_copy(segments.data(), segments.data() + segments.size());
+    } else {
+      for (auto& segment : segments) {
+        std::memcpy(segment.dst, segment.src, segment.bytes);
+      }
+    }
+    benchmark::DoNotOptimize(dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * segment_count * segment_bytes);
+}
+
+BENCHMARK_CAPTURE(bench_host_gather, batched, true)
+  ->ArgsProduct({{1 << 16, 1 << 24, 1 << 26}, {1, 16, 256}});
+BENCHMARK_CAPTURE(bench_host_gather, memcpy, false)
+  ->ArgsProduct({{1 << 16, 1 << 24, 1 << 26}, {1, 16, 256}});
+
+#ifdef TRITON_ENABLE_GPU
+BENCHMARK_CAPTURE(bench_buffer_copy, host_to_device, DeviceMemory, HostMemory)
+  ->RangeMultiplier(16)
+  ->Range(1 << 8, 1 << 24);
+BENCHMARK_CAPTURE(bench_buffer_copy, device_to_host, HostMemory, DeviceMemory)
+  ->RangeMultiplier(16)
+  ->Range(1 << 8, 1 << 24);
+BENCHMARK_CAPTURE(bench_buffer_copy, device_to_device, DeviceMemory, DeviceMemory)
+  ->RangeMultiplier(16)
+  ->Range(1 << 8, 1 << 24);
+
+/* Host-device copies to or from pinned host memory */
+static void bench_pinned_copy(benchmark::State& state, bool to_device)
+{
+  auto size   = static_cast<std::size_t>(state.range(0));
+  auto pinned = detail::pinned_host_resource{};
+  auto host   = detail::owned_host_buffer<float>(size, cudaStream_t{}, &pinned);
+  auto device = Buffer<float>(size, DeviceMemory);
+  auto stream = cudaStream_t{};
+  for (auto _ : state) {
+    if (to_device) {
+      detail::copy(device.data(), host.get(), size, stream, DeviceMemory, HostMemory);
+    } else {
+      detail::copy(host.get(), device.data(), size, stream, HostMemory, DeviceMemory);
+    }
+    cudaStreamSynchronize(stream);
+  }
+  state.SetBytesProcessed(state.iterations() * size * sizeof(float));
+}
+
+BENCHMARK_CAPTURE(bench_pinned_copy, pinned_to_device, true)
+  ->RangeMultiplier(16)
+  ->Range(1 << 8, 1 << 24);
+BENCHMARK_CAPTURE(bench_pinned_copy, device_to_pinned, false)
+  ->RangeMultiplier(16)
+  ->Range(1 << 8, 1 << 24);
+#endif
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/segmented_tensor.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/* Collation of state.range(0) per-request buffers of state.range(1) floats
+ * each into a single tensor, with the source buffers either adjacent or
+ * separately allocated */
+static void bench_tensor_collation(benchmark::State& state, bool adjacent)
+{
+  auto buffer_count = static_cast<std::size_t>(state.range(0));
+  auto buffer_size  = static_cast<std::size_t>(state.range(1));
+  auto storage      = std::vector<std::vector<float>>{};
+  if (adjacent) {
+    storage.emplace_back(buffer_count * buffer_size);
+  } else {
+    storage.resize(buffer_count, std::vector<float>(buffer_size));
+  }
+  auto buffers = std::vector<Buffer<float>>{};
+  for (auto i = std::size_t{}; i < buffer_count; ++i) {
+    auto* data = adjacent ? storage[0].data() + i * buffer_size : storage[i].data();
+    buffers.emplace_back(data, buffer_size, HostMemory);
+  }
+  auto shape = std::vector<std::size_t>{buffer_count, buffer_size};
+  for (auto _ : state) {
+    auto tensor =
+      Tensor<float>(shape, buffers.begin(), buffers.end(), HostMemory, 0, cudaStream_t{});
+    benchmark::DoNotOptimize(tensor.data());
+  }
+  state.SetBytesProcessed(state.iterations() * buffer_count * buffer_size * sizeof(float));
+}
+
+BENCHMARK_CAPTURE(bench_tensor_collation, adjacent, true)
+  ->ArgsProduct({{1, 16, 256}, {16, 1024, 65536}});
+BENCHMARK_CAPTURE(bench_tensor_collation, separate, false)
+  ->ArgsProduct({{1, 16, 256}, {16, 1024, 65536}});
+
+/* Scatter of a batch-wide output of state.range(0) requests with
+ * state.range(1) floats each into per-request segments */
+static void bench_segmented_scatter(benchmark::State& state)
+{
+  auto request_count = static_cast<std::size_t>(state.range(0));
+  auto row_size      = static_cast<std::size_t>(state.range(1));
+  auto source        = std::vector<float>(request_count * row_size);
+  auto responses     = std::vector<std::vector<float>>(request_count, std::vector<float>(row_size));
+  for (auto _ : state) {
+    auto segments = std::vector<TensorView<float>>{};
+    segments.reserve(request_count);
+    for (auto& response : responses) {
+      segments.emplace_back(
+        response.data(), std::vector<std::size_t>{1, row_size}, HostMemory, 0, cudaStream_t{});
+    }
+    auto output = SegmentedTensor<float>({request_count, row_size}, std::move(segments));
+    copy(output,
+         TensorView<float const>{
+           source.data(), {request_count, row_size}, HostMemory, 0, cudaStream_t{}});
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * request_count * row_size * sizeof(float));
+}
+
+BENCHMARK(bench_segmented_scatter)->ArgsProduct({{1, 16, 256}, {16, 1024}});
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
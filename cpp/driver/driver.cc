@@ -0,0 +1,831 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * A load driver which measures the throughput and latency of a backend
+ * without tritonserver or a client. It loads the backend library itself,
+ * serves the TRITONBACKEND API in process (see server_api.cc) and calls
+ * TRITONBACKEND_ModelInstanceExecute directly with synthetic requests, so the
+ * numbers it reports exclude the cost of the network and of Triton's
+ * scheduler. Alternatively, it replays the batches of a traffic capture
+ * recorded by a rapids_triton backend, at their original or scaled timing.
+ *
+ * Usage: rapids_triton_driver [options] BACKEND_LIBRARY MODEL_DIRECTORY
+ * (run with --help for the options)
+ */
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <rapids_triton/utils/traffic_file.hpp>
+#include <server.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <triton/backend/backend_common.h>
+#include <utility>
+#include <vector>
+
+namespace driver {
+namespace {
+
+auto constexpr usage = R"(Usage: rapids_triton_driver [options] BACKEND_LIBRARY MODEL_DIRECTORY
+
+Execute a model directly with the backend in BACKEND_LIBRARY and report its
+throughput and latency. MODEL_DIRECTORY is passed to the backend as the
+model's repository path.
+
+Options:
+  --config PATH         JSON model configuration, in the form returned by
+                        Triton's model configuration endpoint
+                        (default: MODEL_DIRECTORY/config.json)
+  --batch-size N        rows in each request (default: 1)
+  --requests N          requests passed to each execution (default: 1)
+  --concurrency N       clients executing at once (default: 1)
+  --instances N         model instances (default: 1)
+  --kind cpu|gpu        kind of each instance (default: gpu in GPU builds)
+  --device N            device of GPU instances (default: 0)
+  --input-memory cpu|pinned|gpu
+                        memory holding request inputs (default: cpu)
+  --output-memory cpu|gpu
+                        memory requested for outputs (default: cpu)
+  --shape NAME:D1,D2... shape of an input with variable dimensions, without
+                        the batch dimension (default: 1 for each)
+  --warmup N            unmeasured executions per client (default: 10)
+  --iterations N        measured executions per client (default: 1000)
+  --replay PATH         execute the batches of a traffic capture instead of
+                        synthetic requests, each once and in order; inputs
+                        captured without data are filled synthetically
+  --replay-speed X      replay at X times the captured rate, or as fast as
+                        the clients allow if 0 (default: 1)
+  --verbose             print verbose backend log messages
+)";
+
+struct options {
+  std::string library{};
+  std::string model_directory{};
+  std::string config_path{};
+  std::size_t batch_size{1};
+  std::size_t requests{1};
+  std::size_t concurrency{1};
+  std::size_t instances{1};
+#ifdef TRITON_ENABLE_GPU
+  TRITONSERVER_InstanceGroupKind kind{TRITONSERVER_INSTANCEGROUPKIND_GPU};
+#else
+  TRITONSERVER_InstanceGroupKind kind{TRITONSERVER_INSTANCEGROUPKIND_CPU};
+#endif
+  std::int32_t device{};
+  TRITONSERVER_MemoryType input_mem_type{TRITONSERVER_MEMORY_CPU};
+  TRITONSERVER_MemoryType output_mem_type{TRITONSERVER_MEMORY_CPU};
+  std::map<std::string, std::vector<std::int64_t>> shapes{};
+  std::size_t warmup{10};
+  std::size_t iterations{1000};
+  std::string replay{};
+  double replay_speed{1.0};
+  bool verbose{false};
+};
+
+struct io_spec {
+  std::string name;
+  TRITONSERVER_DataType dtype;
+  std::vector<std::int64_t> dims;
+};
+
+struct model_spec {
+  std::string name;
+  std::string backend;
+  std::int64_t max_batch_size;
+  std::vector<io_spec> inputs;
+  std::vector<std::string> outputs;
+};
+
+/* The entry points of a backend library, of which only execution is
+ * required */
+struct backend_library {
+  using backend_fn  = TRITONSERVER_Error* (*)(TRITONBACKEND_Backend*);
+  using model_fn    = TRITONSERVER_Error* (*)(TRITONBACKEND_Model*);
+  using instance_fn = TRITONSERVER_Error* (*)(TRITONBACKEND_ModelInstance*);
+  using execute_fn  = TRITONSERVER_Error* (*)(TRITONBACKEND_ModelInstance*,
+                                             TRITONBACKEND_Request**,
+                                             std::uint32_t const);
+
+  explicit backend_library(std::string const& path)
+    : handle{dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)}
+  {
+    if (handle == nullptr) {
+      auto const* reason = dlerror();
+      throw std::runtime_error{"could not load backend " + path + ": " +
+                               (reason == nullptr ? "unknown error" : reason)};
+    }
+    initialize          = symbol<backend_fn>("TRITONBACKEND_Initialize");
+    finalize            = symbol<backend_fn>("TRITONBACKEND_Finalize");
+    model_initialize    = symbol<model_fn>("TRITONBACKEND_ModelInitialize");
+    model_finalize      = symbol<model_fn>("TRITONBACKEND_ModelFinalize");
+    instance_initialize = symbol<instance_fn>("TRITONBACKEND_ModelInstanceInitialize");
+    instance_finalize   = symbol<instance_fn>("TRITONBACKEND_ModelInstanceFinalize");
+    execute             = symbol<execute_fn>("TRITONBACKEND_ModelInstanceExecute");
+    if (execute == nullptr) {
+      throw std::runtime_error{path + " does not define TRITONBACKEND_ModelInstanceExecute"};
+    }
+  }
+
+  // The backend is never unloaded, since its threads may outlive finalization
+  void* handle;
+  backend_fn initialize{};
+  backend_fn finalize{};
+  model_fn model_initialize{};
+  model_fn model_finalize{};
+  instance_fn instance_initialize{};
+  instance_fn instance_finalize{};
+  execute_fn execute{};
+
+ private:
+  template <typename T>
+  T symbol(char const* name)
+  {
+    return reinterpret_cast<T>(dlsym(handle, name));
+  }
+};
+
+/* Throw if a call into the backend or the driver's own API failed */
+void check(TRITONSERVER_Error* err)
+{
+  if (err != nullptr) {
+    auto message = std::string{TRITONSERVER_ErrorMessage(err)};
+    TRITONSERVER_ErrorDelete(err);
+    throw std::runtime_error{message};
+  }
+}
+
+std::size_t parse_count(std::string const& option, std::string const& value)
+{
+  try {
+    auto pos    = std::size_t{};
+    auto result = std::stoull(value, &pos);
+    if (pos == value.size()) { return result; }
+  } catch (std::exception const&) {
+  }
+  throw std::invalid_argument{option + " expects a non-negative integer, not '" + value + "'"};
+}
+
+double parse_speed(std::string const& option, std::string const& value)
+{
+  try {
+    auto pos    = std::size_t{};
+    auto result = std::stod(value, &pos);
+    if (pos == value.size() && result >= 0.0) { return result; }
+  } catch (std::exception const&) {
+  }
+  throw std::invalid_argument{option + " expects a non-negative number, not '" + value + "'"};
+}
+
+TRITONSERVER_MemoryType parse_mem_type(std::string const& option, std::string const& value)
+{
+  if (value == "cpu") { return TRITONSERVER_MEMORY_CPU; }
+  if (value == "pinned") { return TRITONSERVER_MEMORY_CPU_PINNED; }
+  if (value == "gpu") { return TRITONSERVER_MEMORY_GPU; }
+  throw std::invalid_argument{option + " expects cpu, pinned or gpu, not '" + value + "'"};
+}
+
+std::optional<options> parse_options(int argc, char** argv)
+{
+  auto result     = options{};
+  auto positional = std::vector<std::string>{};
+  for (auto i = 1; i < argc; ++i) {
+    auto arg = std::string{argv[i]};
+    if (arg == "--help" || arg == "-h") {
+      std::cout << usage;
+      return std::nullopt;
+    }
+    if (arg == "--verbose") {
+      result.verbose = true;
+      continue;
+    }
+    if (arg.rfind("--", 0) != 0) {
+      positional.push_back(arg);
+      continue;
+    }
+    if (i + 1 == argc) { throw std::invalid_argument{arg + " expects a value"}; }
+    auto value = std::string{argv[++i]};
+    if (arg == "--config") {
+      result.config_path = value;
+    } else if (arg == "--batch-size") {
+      result.batch_size = parse_count(arg, value);
+    } else if (arg == "--requests") {
+      result.requests = std::max(parse_count(arg, value), std::size_t{1});
+    } else if (arg == "--concurrency") {
+      result.concurrency = std::max(parse_count(arg, value), std::size_t{1});
+    } else if (arg == "--instances") {
+      result.instances = std::max(parse_count(arg, value), std::size_t{1});
+    } else if (arg == "--kind") {
+      if (value == "cpu") {
+        result.kind = TRITONSERVER_INSTANCEGROUPKIND_CPU;
+      } else if (value == "gpu") {
+        result.kind = TRITONSERVER_INSTANCEGROUPKIND_GPU;
+      } else {
+        throw std::invalid_argument{"--kind expects cpu or gpu, not '" + value + "'"};
+      }
+    } else if (arg == "--device") {
+      result.device = static_cast<std::int32_t>(parse_count(arg, value));
+    } else if (arg == "--input-memory") {
+      result.input_mem_type = parse_mem_type(arg, value);
+    } else if (arg == "--output-memory") {
+      result.output_mem_type = parse_mem_type(arg, value);
+    } else if (arg == "--shape") {
+      auto separator = value.find(':');
+      if (separator == std::string::npos) {
+        throw std::invalid_argument{"--shape expects NAME:D1,D2..., not '" + value + "'"};
+      }
+      auto& shape = result.shapes[value.substr(0, separator)];
+      auto dims   = std::istringstream{value.substr(separator + 1)};
+      for (auto dim = std::string{}; std::getline(dims, dim, ',');) {
+        shape.push_back(static_cast<std::int64_t>(parse_count(arg, dim)));
+      }
+    } else if (arg == "--warmup") {
+      result.warmup = parse_count(arg, value);
+    } else if (arg == "--iterations") {
+      result.iterations = std::max(parse_count(arg, value), std::size_t{1});
+    } else if (arg == "--replay") {
+      result.replay = value;
+    } else if (arg == "--replay-speed") {
+      result.replay_speed = parse_speed(arg, value);
+    } else {
+      throw std::invalid_argument{"unknown option " + arg};
+    }
+  }
+  if (positional.size() != 2) { throw std::invalid_argument{usage}; }
+  result.library         = positional[0];
+  result.model_directory = positional[1];
+  if (result.config_path.empty()) { result.config_path = result.model_directory + "/config.json"; }
+  return result;
+}
+
+std::string read_file(std::string const& path)
+{
+  auto file = std::ifstream{path, std::ios::binary};
+  if (!file) { throw std::runtime_error{"could not read " + path}; }
+  auto result = std::ostringstream{};
+  result << file.rdbuf();
+  return result.str();
+}
+
+/* The name of a directory or file without its parent directories */
+std::string base_name(std::string path)
+{
+  while (!path.empty() && path.back() == '/') {
+    path.pop_back();
+  }
+  return path.substr(path.find_last_of('/') + 1);
+}
+
+/* The name of the backend in a library named libtriton_<name>.so */
+std::string backend_name(std::string const& library)
+{
+  auto result = base_name(library);
+  if (result.rfind("libtriton_", 0) == 0) { result = result.substr(10); }
+  return result.substr(0, result.find('.'));
+}
+
+TRITONSERVER_DataType parse_dtype(std::string const& config_dtype)
+{
+  auto name = config_dtype.rfind("TYPE_", 0) == 0 ? config_dtype.substr(5) : config_dtype;
+  if (name == "STRING") { name = "BYTES"; }
+  auto result = TRITONSERVER_StringToDataType(name.c_str());
+  if (result == TRITONSERVER_TYPE_INVALID) {
+    throw std::runtime_error{"unsupported data type " + config_dtype};
+  }
+  return result;
+}
+
+model_spec parse_model_spec(std::string const& config_json, options const& opts)
+{
+  auto config = triton::common::TritonJson::Value{};
+  check(config.Parse(config_json));
+
+  auto result = model_spec{};
+  if (config.Find("name")) {
+    check(config.MemberAsString("name", &result.name));
+  } else {
+    result.name = base_name(opts.model_directory);
+  }
+  if (config.Find("backend")) { check(config.MemberAsString("backend", &result.backend)); }
+  if (result.backend.empty()) { result.backend = backend_name(opts.library); }
+  result.max_batch_size = 0;
+  if (config.Find("max_batch_size")) {
+    check(config.MemberAsInt("max_batch_size", &result.max_batch_size));
+  }
+
+  auto ios = triton::common::TritonJson::Value{};
+  if (config.Find("input", &ios)) {
+    for (auto i = std::size_t{}; i < ios.ArraySize(); ++i) {
+      auto io = triton::common::TritonJson::Value{};
+      check(ios.IndexAsObject(i, &io));
+      auto spec  = io_spec{};
+      auto dtype = std::string{};
+      check(io.MemberAsString("name", &spec.name));
+      check(io.MemberAsString("data_type", &dtype));
+      spec.dtype = parse_dtype(dtype);
+      check(triton::backend::ParseShape(io, "dims", &spec.dims));
+      result.inputs.push_back(std::move(spec));
+    }
+  }
+  if (config.Find("output", &ios)) {
+    for (auto i = std::size_t{}; i < ios.ArraySize(); ++i) {
+      auto io   = triton::common::TritonJson::Value{};
+      auto name = std::string{};
+      check(ios.IndexAsObject(i, &io));
+      check(io.MemberAsString("name", &name));
+      result.outputs.push_back(std::move(name));
+    }
+  }
+  return result;
+}
+
+/* Synthetic data for an input of the given type and number of elements,
+ * which is small and finite so that it is valid for most models */
+std::vector<char> synthetic_data(TRITONSERVER_DataType dtype, std::size_t count, std::mt19937& rng)
+{
+  auto result = std::vector<char>{};
+  auto append = [&result](auto value) {
+    auto const* bytes = reinterpret_cast<char const*>(&value);
+    result.insert(std::end(result), bytes, bytes + sizeof(value));
+  };
+  auto digit = std::uniform_int_distribution<int>{0, 9};
+  auto unit  = std::uniform_real_distribution<double>{0.0, 1.0};
+  for (auto i = std::size_t{}; i < count; ++i) {
+    switch (dtype) {
+      case TRITONSERVER_TYPE_BOOL: append(static_cast<bool>(digit(rng) % 2)); break;
+      case TRITONSERVER_TYPE_UINT8: append(static_cast<std::uint8_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_UINT16: append(static_cast<std::uint16_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_UINT32: append(static_cast<std::uint32_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_UINT64: append(static_cast<std::uint64_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_INT8: append(static_cast<std::int8_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_INT16: append(static_cast<std::int16_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_INT32: append(static_cast<std::int32_t>(digit(rng))); break;
+      case TRITONSERVER_TYPE_INT64: append(static_cast<std::int64_t>(digit(rng))); break;
+      // 1.0 in IEEE half precision
+      case TRITONSERVER_TYPE_FP16: append(std::uint16_t{0x3c00}); break;
+      case TRITONSERVER_TYPE_FP32: append(static_cast<float>(unit(rng))); break;
+      case TRITONSERVER_TYPE_FP64: append(unit(rng)); break;
+      case TRITONSERVER_TYPE_BYTES: {
+        // Serialized as Triton does: a 4-byte length followed by the bytes
+        auto constexpr length = std::uint32_t{8};
+        append(length);
+        for (auto j = std::uint32_t{}; j < length; ++j) {
+          result.push_back(static_cast<char>('a' + digit(rng)));
+        }
+        break;
+      }
+      default: throw std::runtime_error{"unsupported data type for synthetic input"};
+    }
+  }
+  return result;
+}
+
+std::size_t element_count(std::vector<std::int64_t> const& shape)
+{
+  auto result = std::size_t{1};
+  for (auto coord : shape) {
+    result *= static_cast<std::size_t>(coord);
+  }
+  return result;
+}
+
+/* A request for every output of the model, without inputs */
+auto new_request(model_spec const& spec, options const& opts, std::string id)
+{
+  auto result             = std::make_unique<TRITONBACKEND_Request>();
+  result->id              = std::move(id);
+  result->correlation_id  = 0;
+  result->flags           = 0;
+  result->outputs         = spec.outputs;
+  result->output_mem_type = opts.output_mem_type;
+  result->output_device   = opts.device;
+  return result;
+}
+
+/* Copy the given host bytes into a new buffer for the input */
+void set_input_data(TRITONBACKEND_Input& input,
+                    options const& opts,
+                    void const* data,
+                    std::size_t bytes)
+{
+  input.buffer = allocation{bytes, opts.input_mem_type, opts.device};
+  input.buffer.fill(data, bytes);
+}
+
+auto make_requests(model_spec const& spec, options const& opts, std::size_t client)
+{
+  auto rng    = std::mt19937{static_cast<std::mt19937::result_type>(client)};
+  auto result = std::vector<std::unique_ptr<TRITONBACKEND_Request>>{};
+  for (auto i = std::size_t{}; i < opts.requests; ++i) {
+    auto request = new_request(spec, opts, std::to_string(client) + "_" + std::to_string(i));
+    for (auto const& input_spec : spec.inputs) {
+      auto input  = TRITONBACKEND_Input{};
+      input.name  = input_spec.name;
+      input.dtype = input_spec.dtype;
+      if (spec.max_batch_size > 0) {
+        input.shape.push_back(static_cast<std::int64_t>(opts.batch_size));
+      }
+      auto override = opts.shapes.find(input_spec.name);
+      auto dim      = std::size_t{};
+      for (auto coord : input_spec.dims) {
+        if (coord < 0) {
+          auto const* given = (override == std::end(opts.shapes) ||
+                               dim >= override->second.size())
+                                ? nullptr
+                                : &override->second[dim];
+          coord = (given == nullptr) ? 1 : *given;
+          ++dim;
+        }
+        input.shape.push_back(coord);
+      }
+      auto data = synthetic_data(input.dtype, element_count(input.shape), rng);
+      set_input_data(input, opts, data.data(), data.size());
+      request->inputs.push_back(std::move(input));
+    }
+    result.push_back(std::move(request));
+  }
+  return result;
+}
+
+/* Requests reproducing one captured batch, with synthetic data for any input
+ * whose data were not captured */
+auto make_replay_requests(model_spec const& spec,
+                          options const& opts,
+                          triton::backend::rapids::traffic_batch const& batch,
+                          std::size_t index)
+{
+  auto rng    = std::mt19937{static_cast<std::mt19937::result_type>(index)};
+  auto result = std::vector<std::unique_ptr<TRITONBACKEND_Request>>{};
+  for (auto i = std::size_t{}; i < batch.requests.size(); ++i) {
+    auto request = new_request(spec, opts, std::to_string(index) + "_" + std::to_string(i));
+    for (auto const& captured : batch.requests[i].inputs) {
+      auto input  = TRITONBACKEND_Input{};
+      input.name  = captured.name;
+      input.dtype = captured.dtype;
+      input.shape = captured.shape;
+      if (captured.data != nullptr) {
+        set_input_data(input, opts, captured.data, captured.byte_size);
+      } else {
+        auto data = synthetic_data(input.dtype, element_count(input.shape), rng);
+        set_input_data(input, opts, data.data(), data.size());
+      }
+      request->inputs.push_back(std::move(input));
+    }
+    result.push_back(std::move(request));
+  }
+  return result;
+}
+
+/* Released once every client has finished warming up, calling the given
+ * function as it opens */
+struct start_gate {
+  start_gate(std::size_t clients, std::function<void()> on_open)
+    : waiting_{clients}, on_open_{std::move(on_open)}
+  {
+  }
+
+  void arrive_and_wait()
+  {
+    auto lock = std::unique_lock<std::mutex>{lock_};
+    if (--waiting_ == 0) {
+      on_open_();
+      opened_ = clock::now();
+      lock.unlock();
+      open_.notify_all();
+    } else {
+      open_.wait(lock, [this]() { return waiting_ == 0; });
+    }
+  }
+
+  auto opened() const noexcept { return opened_; }
+
+ private:
+  std::mutex lock_{};
+  std::condition_variable open_{};
+  std::size_t waiting_;
+  std::function<void()> on_open_;
+  clock::time_point opened_{};
+};
+
+struct client_result {
+  std::vector<double> latencies_us{};
+  std::size_t rows{};
+  std::size_t failures{};
+  std::optional<std::string> first_error{};
+};
+
+/* Execute requests on an instance and wait for all of them to complete,
+ * measuring their latency from the given start time or, if there is none,
+ * from the start of the execution */
+void execute_once(backend_library const& library,
+                  TRITONBACKEND_ModelInstance& instance,
+                  std::mutex& instance_lock,
+                  std::vector<std::unique_ptr<TRITONBACKEND_Request>>& requests,
+                  std::optional<clock::time_point> start,
+                  bool batched,
+                  client_result* result)
+{
+  auto raw_requests = std::vector<TRITONBACKEND_Request*>{};
+  for (auto& request : requests) {
+    request->reset();
+    raw_requests.push_back(request.get());
+  }
+  if (!start) { start = clock::now(); }
+  auto* err = static_cast<TRITONSERVER_Error*>(nullptr);
+  {
+    // Triton never executes on one instance from two threads at once
+    auto lock = std::lock_guard<std::mutex>{instance_lock};
+    err       = library.execute(&instance, raw_requests.data(), raw_requests.size());
+  }
+  if (err != nullptr) {
+    for (auto& request : requests) {
+      request->fail(err->message);
+    }
+    TRITONSERVER_ErrorDelete(err);
+  }
+  for (auto& request : requests) {
+    auto [end, error] = request->wait();
+    if (result == nullptr) { continue; }
+    if (error) {
+      ++result->failures;
+      if (!result->first_error) { result->first_error = std::move(error); }
+    } else {
+      result->latencies_us.push_back(
+        std::chrono::duration<double, std::micro>(end - *start).count());
+      auto const& inputs = request->inputs;
+      result->rows += (batched && !inputs.empty() && !inputs[0].shape.empty())
+                        ? static_cast<std::size_t>(inputs[0].shape[0])
+                        : std::size_t{1};
+    }
+  }
+}
+
+/* Execute the client's requests on an instance the given number of times,
+ * waiting for each execution to complete before starting the next */
+void run_client(backend_library const& library,
+                TRITONBACKEND_ModelInstance& instance,
+                std::mutex& instance_lock,
+                std::vector<std::unique_ptr<TRITONBACKEND_Request>>& requests,
+                std::size_t iterations,
+                bool batched,
+                client_result* result)
+{
+  for (auto i = std::size_t{}; i < iterations; ++i) {
+    execute_once(library, instance, instance_lock, requests, std::nullopt, batched, result);
+  }
+}
+
+/* Execute captured batches, taking each from the shared position in turn. If
+ * there is a schedule, each batch is executed no earlier than its scheduled
+ * time after the start, and its latency includes any time for which it was
+ * held back by the clients being busy. */
+void run_replay_client(backend_library const& library,
+                       TRITONBACKEND_ModelInstance& instance,
+                       std::mutex& instance_lock,
+                       std::vector<std::vector<std::unique_ptr<TRITONBACKEND_Request>>>& batches,
+                       std::vector<clock::duration> const& schedule,
+                       clock::time_point start,
+                       std::atomic<std::size_t>& next,
+                       bool batched,
+                       client_result* result)
+{
+  for (auto i = next.fetch_add(1); i < batches.size(); i = next.fetch_add(1)) {
+    auto scheduled = std::optional<clock::time_point>{};
+    if (!schedule.empty()) {
+      scheduled = start + schedule[i];
+      std::this_thread::sleep_until(*scheduled);
+    }
+    execute_once(library, instance, instance_lock, batches[i], scheduled, batched, result);
+  }
+}
+
+double percentile(std::vector<double> const& sorted, double fraction)
+{
+  if (sorted.empty()) { return 0.0; }
+  auto index = static_cast<std::size_t>(std::ceil(fraction * sorted.size()));
+  return sorted[std::clamp(index, std::size_t{1}, sorted.size()) - 1];
+}
+
+int run(options const& opts)
+{
+  set_verbose(opts.verbose);
+  auto library = backend_library{opts.library};
+
+  auto config_json = read_file(opts.config_path);
+  auto spec        = parse_model_spec(config_json, opts);
+
+  auto server         = TRITONSERVER_Server{};
+  auto backend        = TRITONBACKEND_Backend{};
+  backend.name        = spec.backend;
+  backend.directory   = opts.library.substr(0, opts.library.find_last_of('/') + 1);
+  backend.config.json = R"({"cmdline":{}})";
+  backend.policy      = TRITONBACKEND_EXECUTION_BLOCKING;
+  backend.state       = nullptr;
+  if (library.initialize != nullptr) { check(library.initialize(&backend)); }
+
+  auto model       = TRITONBACKEND_Model{};
+  model.backend    = &backend;
+  model.server     = &server;
+  model.name       = spec.name;
+  model.version    = 1;
+  model.repository = opts.model_directory;
+  model.config     = config_json;
+  model.state      = nullptr;
+  if (library.model_initialize != nullptr) { check(library.model_initialize(&model)); }
+
+  auto instances      = std::vector<std::unique_ptr<TRITONBACKEND_ModelInstance>>{};
+  auto instance_locks = std::vector<std::mutex>(opts.instances);
+  for (auto i = std::size_t{}; i < opts.instances; ++i) {
+    auto instance       = std::make_unique<TRITONBACKEND_ModelInstance>();
+    instance->model     = &model;
+    instance->name      = spec.name + "_0_" + std::to_string(i);
+    instance->kind      = opts.kind;
+    instance->device_id = (opts.kind == TRITONSERVER_INSTANCEGROUPKIND_GPU) ? opts.device : 0;
+    instance->host_policy.json =
+      (opts.kind == TRITONSERVER_INSTANCEGROUPKIND_GPU)
+        ? R"({"gpu_)" + std::to_string(instance->device_id) + R"(":{}})"
+        : std::string{R"({"cpu":{}})"};
+    instance->state = nullptr;
+    if (library.instance_initialize != nullptr) {
+      check(library.instance_initialize(instance.get()));
+    }
+    instances.push_back(std::move(instance));
+  }
+
+  // Requests of each client, or of each captured batch when replaying
+  auto requests = std::vector<std::vector<std::unique_ptr<TRITONBACKEND_Request>>>{};
+  auto schedule = std::vector<clock::duration>{};
+  if (opts.replay.empty()) {
+    for (auto client = std::size_t{}; client < opts.concurrency; ++client) {
+      requests.push_back(make_requests(spec, opts, client));
+    }
+  } else {
+    // The capture is only needed until its batches have been copied
+    auto capture        = triton::backend::rapids::traffic_reader{opts.replay};
+    auto const& batches = capture.batches();
+    for (auto i = std::size_t{}; i < batches.size(); ++i) {
+      requests.push_back(make_replay_requests(spec, opts, batches[i], i));
+      if (opts.replay_speed > 0.0) {
+        schedule.push_back(std::chrono::duration_cast<clock::duration>(
+          (batches[i].offset - batches.front().offset) / opts.replay_speed));
+      }
+    }
+  }
+  auto batched = spec.max_batch_size > 0;
+
+  // Only measured executions count toward the backend's statistics
+  auto reset_statistics = [&instances]() {
+    for (auto& instance : instances) {
+      auto lock            = std::lock_guard<std::mutex>{instance->statistics_lock};
+      instance->statistics = execution_statistics{};
+    }
+  };
+
+  auto results     = std::vector<client_result>(opts.concurrency);
+  auto gate        = start_gate{opts.concurrency, reset_statistics};
+  auto next_replay = std::atomic<std::size_t>{};
+  auto clients     = std::vector<std::thread>{};
+  for (auto client = std::size_t{}; client < opts.concurrency; ++client) {
+    clients.emplace_back([&, client]() {
+      auto instance_index = client % opts.instances;
+      auto& instance      = *instances[instance_index];
+      auto& lock          = instance_locks[instance_index];
+      auto* result        = &results[client];
+      if (opts.replay.empty()) {
+        run_client(library, instance, lock, requests[client], opts.warmup, batched, nullptr);
+        gate.arrive_and_wait();
+        run_client(library, instance, lock, requests[client], opts.iterations, batched, result);
+      } else {
+        gate.arrive_and_wait();
+        run_replay_client(library,
+                          instance,
+                          lock,
+                          requests,
+                          schedule,
+                          gate.opened(),
+                          next_replay,
+                          batched,
+                          result);
+      }
+    });
+  }
+  for (auto& client : clients) {
+    client.join();
+  }
+  auto elapsed = std::chrono::duration<double>(clock::now() - gate.opened()).count();
+
+  auto latencies   = std::vector<double>{};
+  auto rows        = std::size_t{};
+  auto failures    = std::size_t{};
+  auto first_error = std::optional<std::string>{};
+  for (auto& result : results) {
+    latencies.insert(
+      std::end(latencies), std::begin(result.latencies_us), std::end(result.latencies_us));
+    rows += result.rows;
+    failures += result.failures;
+    if (!first_error) { first_error = result.first_error; }
+  }
+  std::sort(std::begin(latencies), std::end(latencies));
+
+  auto statistics = execution_statistics{};
+  for (auto& instance : instances) {
+    auto lock = std::lock_guard<std::mutex>{instance->statistics_lock};
+    statistics.batches += instance->statistics.batches;
+    statistics.input_ns += instance->statistics.input_ns;
+    statistics.infer_ns += instance->statistics.infer_ns;
+    statistics.output_ns += instance->statistics.output_ns;
+  }
+
+  for (auto& instance : instances) {
+    if (library.instance_finalize != nullptr) { check(library.instance_finalize(instance.get())); }
+  }
+  if (library.model_finalize != nullptr) { check(library.model_finalize(&model)); }
+  if (library.finalize != nullptr) { check(library.finalize(&backend)); }
+
+  auto completed = latencies.size();
+  std::cout << std::fixed << std::setprecision(1);
+  std::cout << "Model: " << spec.name << " (backend " << spec.backend << ")\n";
+  if (opts.replay.empty()) {
+    std::cout << "Clients: " << opts.concurrency << ", instances: " << opts.instances
+              << ", requests per execution: " << opts.requests
+              << ", rows per request: " << opts.batch_size << "\n";
+  } else {
+    std::cout << "Clients: " << opts.concurrency << ", instances: " << opts.instances
+              << ", replaying " << requests.size() << " executions from " << opts.replay;
+    if (opts.replay_speed > 0.0) {
+      std::cout << " at " << opts.replay_speed << "x speed\n";
+    } else {
+      std::cout << " as fast as possible\n";
+    }
+  }
+  std::cout << "Requests: " << completed << " completed, " << failures << " failed in "
+            << std::setprecision(3) << elapsed << " s\n"
+            << std::setprecision(1);
+  std::cout << "Throughput: " << completed / elapsed << " requests/s, " << rows / elapsed
+            << " rows/s\n";
+  auto mean =
+    latencies.empty()
+      ? 0.0
+      : std::accumulate(std::begin(latencies), std::end(latencies), 0.0) / latencies.size();
+  std::cout << "Latency (us): mean " << mean << ", p50 " << percentile(latencies, 0.5) << ", p90 "
+            << percentile(latencies, 0.9) << ", p95 " << percentile(latencies, 0.95) << ", p99 "
+            << percentile(latencies, 0.99) << ", max " << percentile(latencies, 1.0) << "\n";
+  if (statistics.batches != 0) {
+    auto per_batch_us = [&statistics](std::uint64_t total_ns) {
+      return total_ns / 1000.0 / statistics.batches;
+    };
+    std::cout << "Backend time per execution (us): input " << per_batch_us(statistics.input_ns)
+              << ", compute " << per_batch_us(statistics.infer_ns) << ", output "
+              << per_batch_us(statistics.output_ns) << "\n";
+  }
+  if (first_error) { std::cout << "First error: " << *first_error << "\n"; }
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+}  // namespace driver
+
+int main(int argc, char** argv)
+{
+  try {
+    auto opts = driver::parse_options(argc, argv);
+    return opts ? driver::run(*opts) : EXIT_SUCCESS;
+  } catch (std::exception const& err) {
+    std::cerr << err.what() << "\n";
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The objects behind the opaque handles of the TRITONSERVER and TRITONBACKEND
+ * APIs, as the load driver implements them in place of tritonserver (see
+ * server_api.cc). Only what a backend needs to load a model and execute
+ * requests is provided: one model, loaded from a JSON configuration, with
+ * requests whose inputs are each a single buffer.
+ */
+
+#pragma once
+#include <triton/core/tritonbackend.h>
+#include <triton/core/tritonserver.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace driver {
+
+using clock = std::chrono::steady_clock;
+
+/** Whether TRITONSERVER_LOG_VERBOSE messages are printed */
+void set_verbose(bool verbose) noexcept;
+
+/** Free memory obtained from an allocation */
+void deallocate(void* data, TRITONSERVER_MemoryType mem_type, std::int64_t device) noexcept;
+
+/**
+ * @brief An allocation of host, pinned host or device memory, freed on
+ * destruction
+ */
+struct allocation {
+  allocation() noexcept;
+  allocation(std::size_t bytes, TRITONSERVER_MemoryType mem_type, std::int64_t device);
+  allocation(allocation&& other) noexcept;
+  allocation& operator=(allocation&& other) noexcept;
+  allocation(allocation const& other) = delete;
+  allocation& operator=(allocation const& other) = delete;
+  ~allocation();
+
+  auto* data() const noexcept { return data_; }
+  auto size() const noexcept { return size_; }
+  auto mem_type() const noexcept { return mem_type_; }
+  auto device() const noexcept { return device_; }
+
+  /** Copy the given host bytes into this allocation */
+  void fill(void const* src, std::size_t bytes);
+
+  /** Give up ownership of the memory, which must then be passed to
+   * deallocate */
+  void* release() noexcept;
+
+ private:
+  void* data_;
+  std::size_t size_;
+  TRITONSERVER_MemoryType mem_type_;
+  std::int64_t device_;
+};
+
+/** The time spent in each phase of execution as reported by the backend */
+struct execution_statistics {
+  std::uint64_t batches{};
+  std::uint64_t rows{};
+  std::uint64_t input_ns{};
+  std::uint64_t infer_ns{};
+  std::uint64_t output_ns{};
+};
+
+}  // namespace driver
+
+struct TRITONSERVER_Error {
+  TRITONSERVER_Error_Code code;
+  std::string message;
+};
+
+struct TRITONSERVER_Message {
+  std::string json;
+};
+
+struct TRITONSERVER_Server {
+};
+
+struct TRITONBACKEND_MemoryManager {
+};
+
+struct TRITONBACKEND_Backend {
+  std::string name;
+  std::string directory;
+  TRITONSERVER_Message config;
+  TRITONBACKEND_ExecutionPolicy policy;
+  TRITONBACKEND_MemoryManager memory_manager;
+  void* state;
+};
+
+struct TRITONBACKEND_Model {
+  TRITONBACKEND_Backend* backend;
+  TRITONSERVER_Server* server;
+  std::string name;
+  std::uint64_t version;
+  std::string repository;
+  std::string config;
+  void* state;
+};
+
+struct TRITONBACKEND_ModelInstance {
+  TRITONBACKEND_Model* model;
+  std::string name;
+  TRITONSERVER_InstanceGroupKind kind;
+  std::int32_t device_id;
+  TRITONSERVER_Message host_policy;
+  void* state;
+  std::mutex statistics_lock;
+  driver::execution_statistics statistics;
+};
+
+struct TRITONBACKEND_Input {
+  std::string name;
+  TRITONSERVER_DataType dtype;
+  std::vector<std::int64_t> shape;
+  driver::allocation buffer;
+};
+
+struct TRITONBACKEND_Output {
+  std::string name;
+  TRITONSERVER_DataType dtype;
+  std::vector<std::int64_t> shape;
+  driver::allocation buffer;
+};
+
+/**
+ * A request, which is reused for every execution by one client of the
+ * driver. It is complete once the backend has both released it and sent its
+ * final response.
+ */
+struct TRITONBACKEND_Request {
+  std::string id;
+  std::uint64_t correlation_id;
+  std::uint32_t flags;
+  std::vector<TRITONBACKEND_Input> inputs;
+  std::vector<std::string> outputs;
+  TRITONSERVER_MemoryType output_mem_type;
+  std::int64_t output_device;
+
+  /** Prepare the request to be executed again */
+  void reset();
+  /** Record a response sent with the given flags and error */
+  void respond(std::uint32_t send_flags, TRITONSERVER_Error const* error);
+  /** Record the release of the request by the backend */
+  void release();
+  /** Record a failure of the execution to which the request was given */
+  void fail(std::string const& message);
+  /** Wait until the request is complete, returning when it completed and
+   * the first error it received */
+  std::pair<driver::clock::time_point, std::optional<std::string>> wait();
+
+ private:
+  void finish_if_complete();
+
+  std::mutex lock_;
+  std::condition_variable completed_;
+  bool released_{false};
+  bool final_{false};
+  bool complete_{false};
+  driver::clock::time_point completion_time_;
+  std::optional<std::string> error_;
+};
+
+struct TRITONBACKEND_Response {
+  TRITONBACKEND_Request* request;
+  std::vector<std::unique_ptr<TRITONBACKEND_Output>> outputs;
+  std::map<std::string, std::string> parameters;
+};
+
+struct TRITONBACKEND_ResponseFactory {
+  TRITONBACKEND_Request* request;
+};
+
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+struct TRITONSERVER_Parameter {
+  std::string name;
+  std::string value;
+};
+
+struct TRITONSERVER_MetricFamily {
+  TRITONSERVER_MetricKind kind;
+  std::string name;
+};
+
+struct TRITONSERVER_Metric {
+  TRITONSERVER_MetricFamily* family;
+  std::mutex lock;
+  double value;
+};
+#endif
@@ -0,0 +1,977 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The server side of the TRITONSERVER and TRITONBACKEND APIs. The driver
+ * exports these symbols from its executable, so a backend it loads binds to
+ * them rather than to the stub library it was linked against.
+ */
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <server.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace driver {
+namespace {
+auto verbose_logging = std::atomic<bool>{false};
+
+auto* new_error(TRITONSERVER_Error_Code code, std::string message)
+{
+  return new TRITONSERVER_Error{code, std::move(message)};
+}
+
+auto* not_found(char const* what, std::string const& name)
+{
+  return new_error(TRITONSERVER_ERROR_NOT_FOUND, std::string{what} + " '" + name + "' not found");
+}
+
+#ifdef TRITON_ENABLE_GPU
+void cuda_check(cudaError_t err)
+{
+  if (err != cudaSuccess) { throw std::runtime_error{cudaGetErrorString(err)}; }
+}
+#endif
+
+/* Report any exception thrown while serving a call as an error */
+template <typename F>
+TRITONSERVER_Error* serve(F&& f) noexcept
+{
+  try {
+    f();
+    return nullptr;
+  } catch (std::bad_alloc const& err) {
+    return new_error(TRITONSERVER_ERROR_UNAVAILABLE, err.what());
+  } catch (std::exception const& err) {
+    return new_error(TRITONSERVER_ERROR_INTERNAL, err.what());
+  }
+}
+
+/* The memory in which to place a buffer the backend asked for in the given
+ * memory, which falls back to host memory in builds without GPU support */
+auto available_mem_type(TRITONSERVER_MemoryType requested)
+{
+#ifdef TRITON_ENABLE_GPU
+  return requested;
+#else
+  return TRITONSERVER_MEMORY_CPU;
+#endif
+}
+}  // namespace
+
+void set_verbose(bool verbose) noexcept { verbose_logging = verbose; }
+
+void deallocate(void* data, TRITONSERVER_MemoryType mem_type, std::int64_t device) noexcept
+{
+  if (data == nullptr) { return; }
+  switch (mem_type) {
+#ifdef TRITON_ENABLE_GPU
+    case TRITONSERVER_MEMORY_GPU:
+      cudaSetDevice(static_cast<int>(device));
+      cudaFree(data);
+      break;
+    case TRITONSERVER_MEMORY_CPU_PINNED: cudaFreeHost(data); break;
+#endif
+    default: std::free(data);
+  }
+}
+
+allocation::allocation() noexcept
+  : data_{nullptr}, size_{}, mem_type_{TRITONSERVER_MEMORY_CPU}, device_{}
+{
+}
+
+allocation::allocation(std::size_t bytes, TRITONSERVER_MemoryType mem_type, std::int64_t device)
+  : data_{nullptr}, size_{bytes}, mem_type_{available_mem_type(mem_type)}, device_{device}
+{
+  // Zero-sized buffers still get a distinct address
+  auto alloc_bytes = std::max(bytes, std::size_t{1});
+  switch (mem_type_) {
+#ifdef TRITON_ENABLE_GPU
+    case TRITONSERVER_MEMORY_GPU:
+      cuda_check(cudaSetDevice(static_cast<int>(device_)));
+      cuda_check(cudaMalloc(&data_, alloc_bytes));
+      break;
+    case TRITONSERVER_MEMORY_CPU_PINNED: cuda_check(cudaMallocHost(&data_, alloc_bytes)); break;
+#endif
+    default:
+      data_ = std::malloc(alloc_bytes);
+      if (data_ == nullptr) { throw std::bad_alloc{}; }
+  }
+}
+
+allocation::allocation(allocation&& other) noexcept
+  : data_{std::exchange(other.data_, nullptr)},
+    size_{other.size_},
+    mem_type_{other.mem_type_},
+    device_{other.device_}
+{
+}
+
+allocation& allocation::operator=(allocation&& other) noexcept
+{
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+  std::swap(mem_type_, other.mem_type_);
+  std::swap(device_, other.device_);
+  return *this;
+}
+
+allocation::~allocation() { deallocate(data_, mem_type_, device_); }
+
+void* allocation::release() noexcept { return std::exchange(data_, nullptr); }
+
+void allocation::fill(void const* src, std::size_t bytes)
+{
+#ifdef TRITON_ENABLE_GPU
+  if (mem_type_ == TRITONSERVER_MEMORY_GPU) {
+    cuda_check(cudaSetDevice(static_cast<int>(device_)));
+    cuda_check(cudaMemcpy(data_, src, bytes, cudaMemcpyHostToDevice));
+    return;
+  }
+#endif
+  std::memcpy(data_, src, bytes);
+}
+
+}  // namespace driver
+
+void TRITONBACKEND_Request::reset()
+{
+  auto lock = std::lock_guard<std::mutex>{lock_};
+  released_ = false;
+  final_    = false;
+  complete_ = false;
+  error_.reset();
+}
+
+void TRITONBACKEND_Request::respond(std::uint32_t send_flags, TRITONSERVER_Error const* error)
+{
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    if (error != nullptr && !error_) { error_ = error->message; }
+    final_ = final_ || (send_flags & TRITONSERVER_RESPONSE_COMPLETE_FINAL) != 0;
+    finish_if_complete();
+  }
+  completed_.notify_all();
+}
+
+void TRITONBACKEND_Request::release()
+{
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    released_ = true;
+    finish_if_complete();
+  }
+  completed_.notify_all();
+}
+
+void TRITONBACKEND_Request::fail(std::string const& message)
+{
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    if (!error_) { error_ = message; }
+    released_ = true;
+    final_    = true;
+    finish_if_complete();
+  }
+  completed_.notify_all();
+}
+
+std::pair<driver::clock::time_point, std::optional<std::string>> TRITONBACKEND_Request::wait()
+{
+  auto lock = std::unique_lock<std::mutex>{lock_};
+  completed_.wait(lock, [this]() { return complete_; });
+  return {completion_time_, error_};
+}
+
+void TRITONBACKEND_Request::finish_if_complete()
+{
+  if (!complete_ && released_ && final_) {
+    complete_        = true;
+    completion_time_ = driver::clock::now();
+  }
+}
+
+extern "C" {
+
+/* ------------------------------------------------------------------------
+ * TRITONSERVER
+ * ------------------------------------------------------------------------ */
+
+TRITONSERVER_Error* TRITONSERVER_ErrorNew(TRITONSERVER_Error_Code code, char const* msg)
+{
+  return driver::new_error(code, msg == nullptr ? "" : msg);
+}
+
+void TRITONSERVER_ErrorDelete(TRITONSERVER_Error* error) { delete error; }
+
+TRITONSERVER_Error_Code TRITONSERVER_ErrorCode(TRITONSERVER_Error* error) { return error->code; }
+
+char const* TRITONSERVER_ErrorCodeString(TRITONSERVER_Error* error)
+{
+  switch (error->code) {
+    case TRITONSERVER_ERROR_INTERNAL: return "Internal";
+    case TRITONSERVER_ERROR_NOT_FOUND: return "Not found";
+    case TRITONSERVER_ERROR_INVALID_ARG: return "Invalid argument";
+    case TRITONSERVER_ERROR_UNAVAILABLE: return "Unavailable";
+    case TRITONSERVER_ERROR_UNSUPPORTED: return "Unsupported";
+    case TRITONSERVER_ERROR_ALREADY_EXISTS: return "Already exists";
+    default: return "Unknown";
+  }
+}
+
+char const* TRITONSERVER_ErrorMessage(TRITONSERVER_Error* error) { return error->message.c_str(); }
+
+TRITONSERVER_Error* TRITONSERVER_MessageNewFromSerializedJson(TRITONSERVER_Message** message,
+                                                             char const* base,
+                                                             size_t byte_size)
+{
+  return driver::serve(
+    [&]() { *message = new TRITONSERVER_Message{std::string(base, byte_size)}; });
+}
+
+TRITONSERVER_Error* TRITONSERVER_MessageDelete(TRITONSERVER_Message* message)
+{
+  delete message;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONSERVER_MessageSerializeToJson(TRITONSERVER_Message* message,
+                                                       char const** base,
+                                                       size_t* byte_size)
+{
+  *base      = message->json.c_str();
+  *byte_size = message->json.size();
+  return nullptr;
+}
+
+bool TRITONSERVER_LogIsEnabled(TRITONSERVER_LogLevel level)
+{
+  return level != TRITONSERVER_LOG_VERBOSE || driver::verbose_logging;
+}
+
+TRITONSERVER_Error* TRITONSERVER_LogMessage(TRITONSERVER_LogLevel level,
+                                           char const* filename,
+                                           int const line,
+                                           char const* msg)
+{
+  static auto lock = std::mutex{};
+  if (TRITONSERVER_LogIsEnabled(level)) {
+    auto prefix = 'I';
+    switch (level) {
+      case TRITONSERVER_LOG_WARN: prefix = 'W'; break;
+      case TRITONSERVER_LOG_ERROR: prefix = 'E'; break;
+      case TRITONSERVER_LOG_VERBOSE: prefix = 'V'; break;
+      default: break;
+    }
+    auto guard = std::lock_guard<std::mutex>{lock};
+    std::cerr << prefix << ' ' << filename << ':' << line << "] " << msg << '\n';
+  }
+  return nullptr;
+}
+
+char const* TRITONSERVER_DataTypeString(TRITONSERVER_DataType datatype)
+{
+  switch (datatype) {
+    case TRITONSERVER_TYPE_BOOL: return "BOOL";
+    case TRITONSERVER_TYPE_UINT8: return "UINT8";
+    case TRITONSERVER_TYPE_UINT16: return "UINT16";
+    case TRITONSERVER_TYPE_UINT32: return "UINT32";
+    case TRITONSERVER_TYPE_UINT64: return "UINT64";
+    case TRITONSERVER_TYPE_INT8: return "INT8";
+    case TRITONSERVER_TYPE_INT16: return "INT16";
+    case TRITONSERVER_TYPE_INT32: return "INT32";
+    case TRITONSERVER_TYPE_INT64: return "INT64";
+    case TRITONSERVER_TYPE_FP16: return "FP16";
+    case TRITONSERVER_TYPE_FP32: return "FP32";
+    case TRITONSERVER_TYPE_FP64: return "FP64";
+    case TRITONSERVER_TYPE_BYTES: return "BYTES";
+    default: return "<invalid>";
+  }
+}
+
+TRITONSERVER_DataType TRITONSERVER_StringToDataType(char const* dtype)
+{
+  for (auto candidate : {TRITONSERVER_TYPE_BOOL,
+                         TRITONSERVER_TYPE_UINT8,
+                         TRITONSERVER_TYPE_UINT16,
+                         TRITONSERVER_TYPE_UINT32,
+                         TRITONSERVER_TYPE_UINT64,
+                         TRITONSERVER_TYPE_INT8,
+                         TRITONSERVER_TYPE_INT16,
+                         TRITONSERVER_TYPE_INT32,
+                         TRITONSERVER_TYPE_INT64,
+                         TRITONSERVER_TYPE_FP16,
+                         TRITONSERVER_TYPE_FP32,
+                         TRITONSERVER_TYPE_FP64,
+                         TRITONSERVER_TYPE_BYTES}) {
+    if (std::strcmp(dtype, TRITONSERVER_DataTypeString(candidate)) == 0) { return candidate; }
+  }
+  return TRITONSERVER_TYPE_INVALID;
+}
+
+uint32_t TRITONSERVER_DataTypeByteSize(TRITONSERVER_DataType datatype)
+{
+  switch (datatype) {
+    case TRITONSERVER_TYPE_BOOL:
+    case TRITONSERVER_TYPE_UINT8:
+    case TRITONSERVER_TYPE_INT8: return 1;
+    case TRITONSERVER_TYPE_UINT16:
+    case TRITONSERVER_TYPE_INT16:
+    case TRITONSERVER_TYPE_FP16: return 2;
+    case TRITONSERVER_TYPE_UINT32:
+    case TRITONSERVER_TYPE_INT32:
+    case TRITONSERVER_TYPE_FP32: return 4;
+    case TRITONSERVER_TYPE_UINT64:
+    case TRITONSERVER_TYPE_INT64:
+    case TRITONSERVER_TYPE_FP64: return 8;
+    default: return 0;
+  }
+}
+
+char const* TRITONSERVER_MemoryTypeString(TRITONSERVER_MemoryType memtype)
+{
+  switch (memtype) {
+    case TRITONSERVER_MEMORY_CPU: return "CPU";
+    case TRITONSERVER_MEMORY_CPU_PINNED: return "CPU_PINNED";
+    case TRITONSERVER_MEMORY_GPU: return "GPU";
+    default: return "<invalid>";
+  }
+}
+
+char const* TRITONSERVER_InstanceGroupKindString(TRITONSERVER_InstanceGroupKind kind)
+{
+  switch (kind) {
+    case TRITONSERVER_INSTANCEGROUPKIND_AUTO: return "AUTO";
+    case TRITONSERVER_INSTANCEGROUPKIND_CPU: return "CPU";
+    case TRITONSERVER_INSTANCEGROUPKIND_GPU: return "GPU";
+    case TRITONSERVER_INSTANCEGROUPKIND_MODEL: return "MODEL";
+    default: return "<invalid>";
+  }
+}
+
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+TRITONSERVER_Parameter* TRITONSERVER_ParameterNew(char const* name,
+                                                  TRITONSERVER_ParameterType type,
+                                                  void const* value)
+{
+  if (type != TRITONSERVER_PARAMETER_STRING) { return nullptr; }
+  return new TRITONSERVER_Parameter{name, static_cast<char const*>(value)};
+}
+
+void TRITONSERVER_ParameterDelete(TRITONSERVER_Parameter* parameter) { delete parameter; }
+
+TRITONSERVER_Error* TRITONSERVER_MetricFamilyNew(TRITONSERVER_MetricFamily** family,
+                                                 TRITONSERVER_MetricKind kind,
+                                                 char const* name,
+                                                 char const* description)
+{
+  return driver::serve([&]() { *family = new TRITONSERVER_MetricFamily{kind, name}; });
+}
+
+TRITONSERVER_Error* TRITONSERVER_MetricFamilyDelete(TRITONSERVER_MetricFamily* family)
+{
+  delete family;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONSERVER_MetricNew(TRITONSERVER_Metric** metric,
+                                           TRITONSERVER_MetricFamily* family,
+                                           TRITONSERVER_Parameter const** labels,
+                                           uint64_t const label_count)
+{
+  return driver::serve([&]() {
+    *metric           = new TRITONSERVER_Metric{};
+    (*metric)->family = family;
+    (*metric)->value  = 0.0;
+  });
+}
+
+TRITONSERVER_Error* TRITONSERVER_MetricDelete(TRITONSERVER_Metric* metric)
+{
+  delete metric;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONSERVER_MetricValue(TRITONSERVER_Metric* metric, double* value)
+{
+  auto lock = std::lock_guard<std::mutex>{metric->lock};
+  *value    = metric->value;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONSERVER_MetricIncrement(TRITONSERVER_Metric* metric, double value)
+{
+  auto lock = std::lock_guard<std::mutex>{metric->lock};
+  metric->value += value;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONSERVER_MetricSet(TRITONSERVER_Metric* metric, double value)
+{
+  auto lock     = std::lock_guard<std::mutex>{metric->lock};
+  metric->value = value;
+  return nullptr;
+}
+#endif
+
+/* ------------------------------------------------------------------------
+ * TRITONBACKEND
+ * ------------------------------------------------------------------------ */
+
+TRITONSERVER_Error* TRITONBACKEND_ApiVersion(uint32_t* major, uint32_t* minor)
+{
+  *major = TRITONBACKEND_API_VERSION_MAJOR;
+  *minor = TRITONBACKEND_API_VERSION_MINOR;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_MemoryManagerAllocate(TRITONBACKEND_MemoryManager* manager,
+                                                       void** buffer,
+                                                       TRITONSERVER_MemoryType const memory_type,
+                                                       int64_t const memory_type_id,
+                                                       uint64_t const byte_size)
+{
+  if (driver::available_mem_type(memory_type) != memory_type) {
+    return driver::new_error(
+      TRITONSERVER_ERROR_UNSUPPORTED,
+      std::string{TRITONSERVER_MemoryTypeString(memory_type)} + " memory is not available");
+  }
+  return driver::serve([&]() {
+    // Ownership passes to the backend until TRITONBACKEND_MemoryManagerFree
+    *buffer = driver::allocation{byte_size, memory_type, memory_type_id}.release();
+  });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_MemoryManagerFree(TRITONBACKEND_MemoryManager* manager,
+                                                   void* buffer,
+                                                   TRITONSERVER_MemoryType const memory_type,
+                                                   int64_t const memory_type_id)
+{
+  driver::deallocate(buffer, memory_type, memory_type_id);
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_InputProperties(TRITONBACKEND_Input* input,
+                                                 char const** name,
+                                                 TRITONSERVER_DataType* datatype,
+                                                 int64_t const** shape,
+                                                 uint32_t* dims_count,
+                                                 uint64_t* byte_size,
+                                                 uint32_t* buffer_count)
+{
+  if (name != nullptr) { *name = input->name.c_str(); }
+  if (datatype != nullptr) { *datatype = input->dtype; }
+  if (shape != nullptr) { *shape = input->shape.data(); }
+  if (dims_count != nullptr) { *dims_count = input->shape.size(); }
+  if (byte_size != nullptr) { *byte_size = input->buffer.size(); }
+  if (buffer_count != nullptr) { *buffer_count = 1; }
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_InputPropertiesForHostPolicy(TRITONBACKEND_Input* input,
+                                                              char const* host_policy_name,
+                                                              char const** name,
+                                                              TRITONSERVER_DataType* datatype,
+                                                              int64_t const** shape,
+                                                              uint32_t* dims_count,
+                                                              uint64_t* byte_size,
+                                                              uint32_t* buffer_count)
+{
+  return TRITONBACKEND_InputProperties(
+    input, name, datatype, shape, dims_count, byte_size, buffer_count);
+}
+
+TRITONSERVER_Error* TRITONBACKEND_InputBuffer(TRITONBACKEND_Input* input,
+                                             uint32_t const index,
+                                             void const** buffer,
+                                             uint64_t* buffer_byte_size,
+                                             TRITONSERVER_MemoryType* memory_type,
+                                             int64_t* memory_type_id)
+{
+  if (index != 0) {
+    return driver::new_error(TRITONSERVER_ERROR_INVALID_ARG,
+                             "input '" + input->name + "' has only one buffer");
+  }
+  *buffer           = input->buffer.data();
+  *buffer_byte_size = input->buffer.size();
+  *memory_type      = input->buffer.mem_type();
+  *memory_type_id   = input->buffer.device();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_InputBufferForHostPolicy(TRITONBACKEND_Input* input,
+                                                          char const* host_policy_name,
+                                                          uint32_t const index,
+                                                          void const** buffer,
+                                                          uint64_t* buffer_byte_size,
+                                                          TRITONSERVER_MemoryType* memory_type,
+                                                          int64_t* memory_type_id)
+{
+  return TRITONBACKEND_InputBuffer(
+    input, index, buffer, buffer_byte_size, memory_type, memory_type_id);
+}
+
+TRITONSERVER_Error* TRITONBACKEND_OutputBuffer(TRITONBACKEND_Output* output,
+                                              void** buffer,
+                                              uint64_t const buffer_byte_size,
+                                              TRITONSERVER_MemoryType* memory_type,
+                                              int64_t* memory_type_id)
+{
+  return driver::serve([&]() {
+    output->buffer  = driver::allocation{buffer_byte_size, *memory_type, *memory_type_id};
+    *buffer         = output->buffer.data();
+    *memory_type    = output->buffer.mem_type();
+    *memory_type_id = output->buffer.device();
+  });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestId(TRITONBACKEND_Request* request, char const** id)
+{
+  *id = request->id.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestCorrelationId(TRITONBACKEND_Request* request,
+                                                      uint64_t* id)
+{
+  *id = request->correlation_id;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestFlags(TRITONBACKEND_Request* request, uint32_t* flags)
+{
+  *flags = request->flags;
+  return nullptr;
+}
+
+#if TRITONBACKEND_API_VERSION_MAJOR > 1 || TRITONBACKEND_API_VERSION_MINOR >= 16
+TRITONSERVER_Error* TRITONBACKEND_RequestTimeoutMicroseconds(TRITONBACKEND_Request* request,
+                                                            uint64_t* timeout)
+{
+  *timeout = 0;
+  return nullptr;
+}
+#endif
+
+TRITONSERVER_Error* TRITONBACKEND_RequestInputCount(TRITONBACKEND_Request* request,
+                                                   uint32_t* count)
+{
+  *count = request->inputs.size();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestInputName(TRITONBACKEND_Request* request,
+                                                  uint32_t const index,
+                                                  char const** input_name)
+{
+  if (index >= request->inputs.size()) {
+    return driver::not_found("input", std::to_string(index));
+  }
+  *input_name = request->inputs[index].name.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestInput(TRITONBACKEND_Request* request,
+                                              char const* name,
+                                              TRITONBACKEND_Input** input)
+{
+  for (auto& candidate : request->inputs) {
+    if (candidate.name == name) {
+      *input = &candidate;
+      return nullptr;
+    }
+  }
+  return driver::not_found("input", name);
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestInputByIndex(TRITONBACKEND_Request* request,
+                                                     uint32_t const index,
+                                                     TRITONBACKEND_Input** input)
+{
+  if (index >= request->inputs.size()) {
+    return driver::not_found("input", std::to_string(index));
+  }
+  *input = &request->inputs[index];
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestOutputCount(TRITONBACKEND_Request* request,
+                                                    uint32_t* count)
+{
+  *count = request->outputs.size();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestOutputName(TRITONBACKEND_Request* request,
+                                                   uint32_t const index,
+                                                   char const** output_name)
+{
+  if (index >= request->outputs.size()) {
+    return driver::not_found("output", std::to_string(index));
+  }
+  *output_name = request->outputs[index].c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestOutputBufferProperties(
+  TRITONBACKEND_Request* request,
+  char const* name,
+  size_t* byte_size,
+  TRITONSERVER_MemoryType* memory_type,
+  int64_t* memory_type_id)
+{
+  *byte_size      = 0;
+  *memory_type    = request->output_mem_type;
+  *memory_type_id = request->output_device;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestRelease(TRITONBACKEND_Request* request,
+                                                uint32_t release_flags)
+{
+  request->release();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseFactoryNew(TRITONBACKEND_ResponseFactory** factory,
+                                                    TRITONBACKEND_Request* request)
+{
+  return driver::serve([&]() { *factory = new TRITONBACKEND_ResponseFactory{request}; });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseFactoryDelete(TRITONBACKEND_ResponseFactory* factory)
+{
+  delete factory;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseFactorySendFlags(TRITONBACKEND_ResponseFactory* factory,
+                                                          uint32_t const send_flags)
+{
+  factory->request->respond(send_flags, nullptr);
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseNew(TRITONBACKEND_Response** response,
+                                             TRITONBACKEND_Request* request)
+{
+  return driver::serve([&]() {
+    *response            = new TRITONBACKEND_Response{};
+    (*response)->request = request;
+  });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseNewFromFactory(TRITONBACKEND_Response** response,
+                                                        TRITONBACKEND_ResponseFactory* factory)
+{
+  return TRITONBACKEND_ResponseNew(response, factory->request);
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseDelete(TRITONBACKEND_Response* response)
+{
+  delete response;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseSetStringParameter(TRITONBACKEND_Response* response,
+                                                            char const* name,
+                                                            char const* value)
+{
+  return driver::serve([&]() { response->parameters[name] = value; });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseSetIntParameter(TRITONBACKEND_Response* response,
+                                                         char const* name,
+                                                         int64_t const value)
+{
+  return driver::serve([&]() { response->parameters[name] = std::to_string(value); });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseSetBoolParameter(TRITONBACKEND_Response* response,
+                                                          char const* name,
+                                                          bool const value)
+{
+  return driver::serve([&]() { response->parameters[name] = value ? "true" : "false"; });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseOutput(TRITONBACKEND_Response* response,
+                                                TRITONBACKEND_Output** output,
+                                                char const* name,
+                                                TRITONSERVER_DataType const datatype,
+                                                int64_t const* shape,
+                                                uint32_t const dims_count)
+{
+  return driver::serve([&]() {
+    auto result   = std::make_unique<TRITONBACKEND_Output>();
+    result->name  = name;
+    result->dtype = datatype;
+    result->shape.assign(shape, shape + dims_count);
+    *output = result.get();
+    response->outputs.push_back(std::move(result));
+  });
+}
+
+/* Responses are discarded once sent: the driver measures only how long the
+ * backend takes to produce them */
+TRITONSERVER_Error* TRITONBACKEND_ResponseSend(TRITONBACKEND_Response* response,
+                                              uint32_t const send_flags,
+                                              TRITONSERVER_Error* error)
+{
+  auto* request = response->request;
+  delete response;
+  request->respond(send_flags, error);
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendName(TRITONBACKEND_Backend* backend, char const** name)
+{
+  *name = backend->name.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendConfig(TRITONBACKEND_Backend* backend,
+                                               TRITONSERVER_Message** backend_config)
+{
+  *backend_config = &backend->config;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendExecutionPolicy(TRITONBACKEND_Backend* backend,
+                                                        TRITONBACKEND_ExecutionPolicy* policy)
+{
+  *policy = backend->policy;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendSetExecutionPolicy(TRITONBACKEND_Backend* backend,
+                                                           TRITONBACKEND_ExecutionPolicy policy)
+{
+  backend->policy = policy;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendArtifacts(TRITONBACKEND_Backend* backend,
+                                                  TRITONBACKEND_ArtifactType* artifact_type,
+                                                  char const** location)
+{
+  *artifact_type = TRITONBACKEND_ARTIFACT_FILESYSTEM;
+  *location      = backend->directory.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendMemoryManager(TRITONBACKEND_Backend* backend,
+                                                      TRITONBACKEND_MemoryManager** manager)
+{
+  *manager = &backend->memory_manager;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendState(TRITONBACKEND_Backend* backend, void** state)
+{
+  *state = backend->state;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_BackendSetState(TRITONBACKEND_Backend* backend, void* state)
+{
+  backend->state = state;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelName(TRITONBACKEND_Model* model, char const** name)
+{
+  *name = model->name.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelVersion(TRITONBACKEND_Model* model, uint64_t* version)
+{
+  *version = model->version;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelRepository(TRITONBACKEND_Model* model,
+                                                 TRITONBACKEND_ArtifactType* artifact_type,
+                                                 char const** location)
+{
+  *artifact_type = TRITONBACKEND_ARTIFACT_FILESYSTEM;
+  *location      = model->repository.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelConfig(TRITONBACKEND_Model* model,
+                                             uint32_t const config_version,
+                                             TRITONSERVER_Message** model_config)
+{
+  return driver::serve([&]() { *model_config = new TRITONSERVER_Message{model->config}; });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelAutoCompleteConfig(TRITONBACKEND_Model* model,
+                                                         bool* auto_complete_config)
+{
+  *auto_complete_config = false;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelSetConfig(TRITONBACKEND_Model* model,
+                                                uint32_t const config_version,
+                                                TRITONSERVER_Message* model_config)
+{
+  return driver::serve([&]() { model->config = model_config->json; });
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelServer(TRITONBACKEND_Model* model,
+                                             TRITONSERVER_Server** server)
+{
+  *server = model->server;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelBackend(TRITONBACKEND_Model* model,
+                                              TRITONBACKEND_Backend** backend)
+{
+  *backend = model->backend;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelState(TRITONBACKEND_Model* model, void** state)
+{
+  *state = model->state;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelSetState(TRITONBACKEND_Model* model, void* state)
+{
+  model->state = state;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceName(TRITONBACKEND_ModelInstance* instance,
+                                                   char const** name)
+{
+  *name = instance->name.c_str();
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceKind(TRITONBACKEND_ModelInstance* instance,
+                                                   TRITONSERVER_InstanceGroupKind* kind)
+{
+  *kind = instance->kind;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceDeviceId(TRITONBACKEND_ModelInstance* instance,
+                                                       int32_t* device_id)
+{
+  *device_id = instance->device_id;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceHostPolicy(TRITONBACKEND_ModelInstance* instance,
+                                                         TRITONSERVER_Message** host_policy)
+{
+  *host_policy = &instance->host_policy;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceIsPassive(TRITONBACKEND_ModelInstance* instance,
+                                                        bool* is_passive)
+{
+  *is_passive = false;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceProfileCount(TRITONBACKEND_ModelInstance* instance,
+                                                           uint32_t* count)
+{
+  *count = 0;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceProfileName(TRITONBACKEND_ModelInstance* instance,
+                                                          uint32_t const index,
+                                                          char const** profile_name)
+{
+  return driver::not_found("profile", std::to_string(index));
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceModel(TRITONBACKEND_ModelInstance* instance,
+                                                    TRITONBACKEND_Model** model)
+{
+  *model = instance->model;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceState(TRITONBACKEND_ModelInstance* instance,
+                                                    void** state)
+{
+  *state = instance->state;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceSetState(TRITONBACKEND_ModelInstance* instance,
+                                                       void* state)
+{
+  instance->state = state;
+  return nullptr;
+}
+
+/* Per-request statistics repeat those reported for the whole batch, so only
+ * the batch statistics are recorded */
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceReportStatistics(
+  TRITONBACKEND_ModelInstance* instance,
+  TRITONBACKEND_Request* request,
+  bool const success,
+  uint64_t const exec_start_ns,
+  uint64_t const compute_start_ns,
+  uint64_t const compute_end_ns,
+  uint64_t const exec_end_ns)
+{
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ModelInstanceReportBatchStatistics(
+  TRITONBACKEND_ModelInstance* instance,
+  uint64_t const batch_size,
+  uint64_t const exec_start_ns,
+  uint64_t const compute_start_ns,
+  uint64_t const compute_end_ns,
+  uint64_t const exec_end_ns)
+{
+  auto lock        = std::lock_guard<std::mutex>{instance->statistics_lock};
+  auto& statistics = instance->statistics;
+  ++statistics.batches;
+  statistics.rows += batch_size;
+  statistics.input_ns += compute_start_ns - exec_start_ns;
+  statistics.infer_ns += compute_end_ns - compute_start_ns;
+  statistics.output_ns += exec_end_ns - compute_end_ns;
+  return nullptr;
+}
+
+}  // extern "C"
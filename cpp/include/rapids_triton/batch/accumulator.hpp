@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <triton/core/tritonbackend.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Measured processing latency of batches in each of a set of size
+ * buckets
+ *
+ * Each bucket keeps exponentially weighted moving averages of the latency of
+ * batches falling into it and of their absolute deviation from that mean,
+ * from which a 99th percentile is estimated. Buckets which have not been
+ * observed are estimated by scaling the nearest observed bucket in
+ * proportion to its size. Observations may be made and estimates read from
+ * different threads.
+ */
+struct batch_latency_model {
+  /**
+   * @param buckets Bucket sizes in increasing order; if empty, powers of two
+   * up to max_batch_size are used
+   */
+  batch_latency_model(std::vector<std::size_t> buckets, std::size_t max_batch_size)
+    : buckets_{}, lock_{}
+  {
+    if (buckets.empty()) {
+      for (auto size = std::size_t{1}; size < max_batch_size; size *= 2) {
+        buckets.push_back(size);
+      }
+    }
+    if (buckets.empty() || buckets.back() < max_batch_size) { buckets.push_back(max_batch_size); }
+    std::transform(std::begin(buckets),
+                   std::end(buckets),
+                   std::back_inserter(buckets_),
+                   [](auto size) { return bucket_stats{size, 0.0, 0.0, false}; });
+  }
+
+  batch_latency_model(batch_latency_model const& other) = delete;
+  batch_latency_model& operator=(batch_latency_model const& other) = delete;
+
+  /** Record that a batch of the given number of rows took the given time,
+   * from the start of its computation until its responses were sent */
+  void observe(std::size_t rows, std::chrono::nanoseconds elapsed)
+  {
+    if (rows == 0) { return; }
+    auto sample = std::chrono::duration<double, std::micro>{elapsed}.count();
+    auto lock   = std::lock_guard<std::mutex>{lock_};
+    auto& entry = buckets_[bucket_index(rows)];
+    if (entry.observed) {
+      auto deviation = sample > entry.mean ? sample - entry.mean : entry.mean - sample;
+      entry.mean += (sample - entry.mean) * weight;
+      entry.deviation += (deviation - entry.deviation) * weight;
+    } else {
+      entry.mean     = sample;
+      entry.observed = true;
+    }
+  }
+
+  /** The estimated 99th percentile latency of a batch of the given number
+   * of rows, or zero if no batch has been observed */
+  std::chrono::microseconds p99(std::size_t rows) const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return p99_locked(bucket_index(rows));
+  }
+
+  /**
+   * @brief The largest bucket size whose estimated 99th percentile latency
+   * is within the given target, or the smallest bucket if none are
+   */
+  std::size_t best_rows(std::chrono::microseconds target) const
+  {
+    auto lock   = std::lock_guard<std::mutex>{lock_};
+    auto result = buckets_.front().size;
+    for (auto i = std::size_t{}; i < buckets_.size() && p99_locked(i) <= target; ++i) {
+      result = buckets_[i].size;
+    }
+    return result;
+  }
+
+ private:
+  struct bucket_stats {
+    std::size_t size;
+    double mean;
+    double deviation;
+    bool observed;
+  };
+  /* Weight given to each new observation */
+  static auto constexpr weight = 0.125;
+  /* Mean absolute deviations from the mean at which the 99th percentile of
+   * a normal distribution lies */
+  static auto constexpr p99_deviations = 3.0;
+
+  std::vector<bucket_stats> buckets_;
+  std::mutex mutable lock_;
+
+  std::size_t bucket_index(std::size_t rows) const
+  {
+    auto bucket = std::lower_bound(
+      std::begin(buckets_), std::end(buckets_), rows, [](auto const& entry, auto value) {
+        return entry.size < value;
+      });
+    if (bucket == std::end(buckets_)) { --bucket; }
+    return static_cast<std::size_t>(std::distance(std::begin(buckets_), bucket));
+  }
+
+  // Must be called with lock_ held
+  std::chrono::microseconds p99_locked(std::size_t index) const
+  {
+    auto estimate = [](bucket_stats const& entry, std::size_t size) {
+      auto scale = static_cast<double>(size) / static_cast<double>(entry.size);
+      return std::chrono::microseconds{static_cast<std::chrono::microseconds::rep>(
+        (entry.mean + p99_deviations * entry.deviation) * scale)};
+    };
+    auto size = buckets_[index].size;
+    for (auto i = index + 1; i-- > 0;) {
+      if (buckets_[i].observed) { return estimate(buckets_[i], size); }
+    }
+    for (auto i = index + 1; i < buckets_.size(); ++i) {
+      if (buckets_[i].observed) { return estimate(buckets_[i], size); }
+    }
+    return std::chrono::microseconds{};
+  }
+};
+
+/**
+ * @brief A queue which holds requests across calls to execute and releases
+ * them in batches sized to meet a latency target
+ *
+ * Requests are processed on the accumulator's background thread, in the
+ * order in which they were added. At any time the accumulator aims for a
+ * batch of the largest size whose estimated 99th percentile latency is
+ * within the target, and processes the queued requests as soon as they reach
+ * that size or as soon as waiting any longer would keep the oldest of them
+ * from completing within the target. Since the accumulator holds requests
+ * after execute returns, its processing function is responsible for sending
+ * their responses and releasing them. Any requests still queued when the
+ * accumulator is destroyed are processed before it returns.
+ */
+struct request_accumulator {
+  using time_point = std::chrono::steady_clock::time_point;
+  using process_fn =
+    std::function<void(std::vector<TRITONBACKEND_Request*>&, std::vector<time_point> const&)>;
+
+  /**
+   * @param target The latency target for each request, from the time it is
+   * added until its response is sent
+   * @param max_batch_size The largest number of rows in one batch
+   * @param latency The model of batch latency used to size batches, which
+   * should be updated as batches are processed
+   * @param process Called on the background thread with each batch's
+   * requests and the time at which each was added, oldest first
+   */
+  request_accumulator(std::chrono::microseconds target,
+                      std::size_t max_batch_size,
+                      batch_latency_model const& latency,
+                      process_fn process)
+    : target_{target},
+      max_batch_size_{max_batch_size},
+      latency_{&latency},
+      process_{std::move(process)},
+      queue_{},
+      queued_rows_{},
+      shutdown_{false},
+      lock_{},
+      cv_{},
+      worker_{}
+  {
+    worker_ = std::thread{[this]() { run(); }};
+  }
+
+  request_accumulator(request_accumulator const& other) = delete;
+  request_accumulator& operator=(request_accumulator const& other) = delete;
+
+  ~request_accumulator()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+  /** Add a request with the given number of rows to the queue */
+  void add(TRITONBACKEND_Request* request, std::size_t rows)
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      queue_.push_back(queued_request{request, rows, std::chrono::steady_clock::now()});
+      queued_rows_ += rows;
+    }
+    cv_.notify_all();
+  }
+
+  /** The number of requests currently waiting to be processed */
+  auto size() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return queue_.size();
+  }
+
+ private:
+  struct queued_request {
+    TRITONBACKEND_Request* request;
+    std::size_t rows;
+    time_point added;
+  };
+
+  std::chrono::microseconds target_;
+  std::size_t max_batch_size_;
+  batch_latency_model const* latency_;
+  process_fn process_;
+  std::deque<queued_request> queue_;
+  std::size_t queued_rows_;
+  bool shutdown_;
+  std::mutex mutable lock_;
+  std::condition_variable cv_;
+  std::thread worker_;
+
+  void run()
+  {
+    auto lock = std::unique_lock<std::mutex>{lock_};
+    while (true) {
+      cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+      if (queue_.empty()) { break; }
+
+      auto batch_rows = std::min(latency_->best_rows(target_), max_batch_size_);
+      // The oldest request must leave the queue in time to be processed
+      // within the target
+      auto flush_time = queue_.front().added + target_ - latency_->p99(queued_rows_);
+      if (!shutdown_ && queued_rows_ < batch_rows &&
+          cv_.wait_until(lock, flush_time) == std::cv_status::no_timeout) {
+        // Re-evaluate with the newly added requests
+        continue;
+      }
+
+      auto requests = std::vector<TRITONBACKEND_Request*>{};
+      auto received = std::vector<time_point>{};
+      auto rows     = std::size_t{};
+      while (!queue_.empty() && (requests.empty() || rows + queue_.front().rows <= batch_rows)) {
+        rows += queue_.front().rows;
+        requests.push_back(queue_.front().request);
+        received.push_back(queue_.front().added);
+        queue_.pop_front();
+      }
+      queued_rows_ -= rows;
+
+      lock.unlock();
+      try {
+        process_(requests, received);
+      } catch (TritonException const& err) {
+        log_error(__FILE__, __LINE__) << "Processing of accumulated batch failed: " << err.what();
+      }
+      lock.lock();
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
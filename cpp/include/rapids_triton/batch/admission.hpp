@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <rapids_triton/triton/device.hpp>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A limit on the device work which the instances of one model may
+ * have in flight on one device at once
+ *
+ * Each batch is admitted before it enqueues device work and holds its
+ * admission until that work is complete. Unweighted admission counts
+ * batches; weighted admission counts their rows, so that a few large
+ * batches take the place of many small ones. A batch with more rows than
+ * the limit is admitted once it can run alone.
+ */
+struct predict_admission {
+  predict_admission(device_id_t device, std::size_t limit, bool weighted)
+    : device_{device}, limit_{std::max(limit, std::size_t{1})}, weighted_{weighted}, current_{}
+  {
+  }
+
+  predict_admission(predict_admission const& other) = delete;
+  predict_admission& operator=(predict_admission const& other) = delete;
+
+  auto device() const noexcept { return device_; }
+  auto limit() const noexcept { return limit_; }
+  auto weighted() const noexcept { return weighted_; }
+
+  /** The share of the limit taken by a batch of the given number of rows */
+  std::size_t weight(std::size_t rows) const noexcept
+  {
+    return weighted_ ? std::clamp(rows, std::size_t{1}, limit_) : std::size_t{1};
+  }
+
+  /** Take the given weight, waiting until it fits within the limit */
+  void acquire(std::size_t weight)
+  {
+    auto lock = std::unique_lock<std::mutex>{lock_};
+    released_.wait(lock, [this, weight]() { return current_ <= limit_ - weight; });
+    current_ += weight;
+  }
+
+  /** Take the given weight if it fits within the limit within the given
+   * time, returning whether it was taken */
+  bool try_acquire(std::size_t weight, std::chrono::milliseconds wait)
+  {
+    auto lock     = std::unique_lock<std::mutex>{lock_};
+    auto admitted = released_.wait_for(
+      lock, wait, [this, weight]() { return current_ <= limit_ - weight; });
+    if (admitted) { current_ += weight; }
+    return admitted;
+  }
+
+  void release(std::size_t weight) noexcept
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      current_ -= weight;
+    }
+    released_.notify_all();
+  }
+
+ private:
+  device_id_t device_;
+  std::size_t limit_;
+  bool weighted_;
+  std::size_t current_;
+  std::mutex lock_;
+  std::condition_variable released_;
+};
+
+/**
+ * @brief Admission granted by a predict_admission, which is returned to it
+ * when the ticket is released or destroyed
+ */
+struct admission_ticket {
+  admission_ticket() noexcept : admission_{nullptr}, weight_{} {}
+  admission_ticket(predict_admission& admission, std::size_t rows)
+    : admission_{&admission}, weight_{admission.weight(rows)}
+  {
+    admission_->acquire(weight_);
+  }
+  admission_ticket(admission_ticket&& other) noexcept
+    : admission_{std::exchange(other.admission_, nullptr)}, weight_{other.weight_}
+  {
+  }
+  admission_ticket& operator=(admission_ticket&& other) noexcept
+  {
+    if (this != &other) {
+      release();
+      admission_ = std::exchange(other.admission_, nullptr);
+      weight_    = other.weight_;
+    }
+    return *this;
+  }
+  admission_ticket(admission_ticket const& other) = delete;
+  admission_ticket& operator=(admission_ticket const& other) = delete;
+  ~admission_ticket() { release(); }
+
+  /** Admission if it can be granted within the given time, or else an empty
+   * ticket */
+  static admission_ticket try_admit(predict_admission& admission,
+                                    std::size_t rows,
+                                    std::chrono::milliseconds wait)
+  {
+    auto result = admission_ticket{};
+    auto weight = admission.weight(rows);
+    if (admission.try_acquire(weight, wait)) {
+      result.admission_ = &admission;
+      result.weight_    = weight;
+    }
+    return result;
+  }
+
+  explicit operator bool() const noexcept { return admission_ != nullptr; }
+
+  void release() noexcept
+  {
+    if (admission_ != nullptr) {
+      admission_->release(weight_);
+      admission_ = nullptr;
+    }
+  }
+
+ private:
+  predict_admission* admission_;
+  std::size_t weight_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -25,23 +25,55 @@
 #include <triton/backend/backend_input_collector.h>
 #include <triton/backend/backend_output_responder.h>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <deque>
 #include <functional>
 #include <iterator>
 #include <memory>
 #include <numeric>
+#include <optional>
+#include <rapids_triton/batch/admission.hpp>
+#include <rapids_triton/batch/batch_activity.hpp>
+#include <rapids_triton/batch/bucket.hpp>
+#include <rapids_triton/batch/compression_plan.hpp>
+#include <rapids_triton/batch/predict_graph.hpp>
+#include <rapids_triton/batch/result_cache.hpp>
+#include <rapids_triton/batch/transform_plan.hpp>
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
 #include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/convert.hpp>
+#include <rapids_triton/memory/decompress.hpp>
+#include <rapids_triton/memory/scratch_arena.hpp>
 #include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/tensor/layout.hpp>
+#include <rapids_triton/tensor/ragged_tensor.hpp>
+#include <rapids_triton/tensor/segmented_tensor.hpp>
+#include <rapids_triton/tensor/sparse_tensor.hpp>
+#include <rapids_triton/tensor/string_tensor.hpp>
 #include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <rapids_triton/tensor/transforms.hpp>
 #include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/triton/input.hpp>
 #include <rapids_triton/triton/requests.hpp>
+#include <rapids_triton/triton/response_stream.hpp>
 #include <rapids_triton/triton/responses.hpp>
 #include <rapids_triton/triton/statistics.hpp>
+#include <rapids_triton/utils/cuda_event.hpp>
+#include <rapids_triton/utils/function_ref.hpp>
 #include <rapids_triton/utils/narrow.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+#include <rapids_triton/utils/stream_pool.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace triton {
@@ -69,45 +101,603 @@ namespace rapids {
  */
 struct Batch {
   using size_type = std::size_t;
+  using output_shape_fetcher =
+    function_ref<std::vector<size_type>(std::string const&, size_type)>;
+  using statistics_reporter = function_ref<void(TRITONBACKEND_Request*,
+                                                time_point const&,
+                                                time_point const&,
+                                                time_point const&,
+                                                time_point const&)>;
 
+  /**
+   * @brief Construct a batch for the given requests
+   *
+   * The output shape fetcher and statistics reporter are held by reference,
+   * so they must outlive the batch, including any reuse of it via reset.
+   */
   Batch(TRITONBACKEND_Request** raw_requests,
         request_size_t count,
         TRITONBACKEND_MemoryManager& triton_mem_manager,
-        std::function<std::vector<size_type>(std::string const&, size_type)>&& get_output_shape,
-        std::function<void(TRITONBACKEND_Request*,
-                           time_point const&,
-                           time_point const&,
-                           time_point const&,
-                           time_point const&)>&& report_request_statistics,
+        output_shape_fetcher get_output_shape,
+        statistics_reporter report_request_statistics,
         bool use_pinned_input,
         bool use_pinned_output,
         size_type max_batch_size,
         cudaStream_t stream)
-    : requests_{raw_requests, raw_requests + count},
-      responses_{construct_responses(requests_.begin(), requests_.end())},
-      get_output_shape_{std::move(get_output_shape)},
-      report_statistics_{std::move(report_request_statistics)},
-      collector_(raw_requests, count, &responses_, &triton_mem_manager, use_pinned_input, stream),
-      responder_{std::make_shared<BackendOutputResponder>(raw_requests,
-                                                          count,
-                                                          &responses_,
-                                                          max_batch_size,
-                                                          &triton_mem_manager,
-                                                          use_pinned_output,
-                                                          stream)},
+    : requests_{},
+      responses_{},
+      get_output_shape_{get_output_shape},
+      report_statistics_{report_request_statistics},
+      collector_{},
+      responder_{},
+      triton_mem_manager_{&triton_mem_manager},
+      use_pinned_input_{use_pinned_input},
+      use_pinned_output_{use_pinned_output},
+      max_batch_size_{max_batch_size},
       stream_{stream},
-      start_time_{std::chrono::steady_clock::now()},
-      compute_start_time_{std::chrono::steady_clock::now()},
-      batch_size_{}
+      input_copy_stream_{stream},
+      output_copy_stream_{stream},
+      output_copies_{},
+      compute_events_{},
+      device_timing_{false},
+      device_compute_timed_{false},
+      admission_{nullptr},
+      admission_ticket_{},
+      host_dispatch_{false},
+      collection_pool_{nullptr},
+      collection_streams_{nullptr},
+      concurrent_collectors_{},
+      staged_outputs_{},
+      pending_decompressions_{},
+      start_time_{},
+      compute_start_time_{},
+      compute_end_time_{},
+      batch_size_{},
+      request_rows_{},
+      staged_input_bytes_{},
+      activity_{},
+      has_response_outputs_{false},
+      has_segmented_outputs_{false},
+      allowed_memory_configs_{},
+      streams_{},
+      cache_{nullptr},
+      cache_keys_{},
+      captured_outputs_{},
+      capture_storage_{},
+      slice_{},
+      sliced_inputs_{},
+      sliced_outputs_{},
+      scratch_{},
+      staged_device_inputs_{},
+      recording_{nullptr},
+      graph_{nullptr},
+      padded_rows_{},
+      request_errors_{},
+      isolated_requests_{},
+      isolated_responses_{},
+      isolated_errors_{},
+      synthetic_inputs_{},
+      synthetic_rows_{},
+      retained_{},
+      transforms_{nullptr},
+      compression_{nullptr},
+      decompression_pool_{nullptr},
+      requested_outputs_{},
+      output_placements_{},
+      saved_output_copy_bytes_{},
+      intermediates_{}
   {
+    reset(raw_requests,
+          count,
+          triton_mem_manager,
+          use_pinned_input,
+          use_pinned_output,
+          max_batch_size,
+          stream);
   }
 
+  /**
+   * @brief Prepare this batch to process a new set of requests
+   *
+   * Storage allocated for previous requests is reused where possible, so
+   * recycling completed batches avoids much of the cost of constructing a
+   * new one.
+   */
+  void reset(TRITONBACKEND_Request** raw_requests,
+             request_size_t count,
+             TRITONBACKEND_MemoryManager& triton_mem_manager,
+             bool use_pinned_input,
+             bool use_pinned_output,
+             size_type max_batch_size,
+             cudaStream_t stream)
+  {
+    requests_.assign(raw_requests, raw_requests + count);
+    // Batches of no requests (e.g. for synthetic inputs) have no responses
+    if (count == 0) {
+      responses_.clear();
+    } else {
+      construct_responses(std::begin(requests_), std::end(requests_), responses_);
+    }
+    // The input collector and output responder are only constructed if they
+    // are needed, since single-request batches can usually avoid them
+    collector_.reset();
+    responder_.reset();
+    concurrent_collectors_.clear();
+    staged_outputs_.clear();
+    pending_decompressions_.clear();
+    triton_mem_manager_    = &triton_mem_manager;
+    use_pinned_input_      = use_pinned_input;
+    use_pinned_output_     = use_pinned_output;
+    max_batch_size_        = max_batch_size;
+    stream_                = stream;
+    input_copy_stream_     = stream;
+    output_copy_stream_    = stream;
+    start_time_            = std::chrono::steady_clock::now();
+    compute_start_time_    = start_time_;
+    compute_end_time_      = start_time_;
+    has_response_outputs_  = false;
+    has_segmented_outputs_ = false;
+    device_timing_         = false;
+    device_compute_timed_  = false;
+    admission_             = nullptr;
+    host_dispatch_         = false;
+    admission_ticket_.release();
+    batch_size_.reset();
+    request_rows_.clear();
+    staged_input_bytes_ = std::size_t{};
+    staged_device_inputs_.clear();
+    activity_ = batch_activity{};
+    streams_.clear();
+    clear_capture();
+    cache_ = nullptr;
+    clear_slices();
+    reset_scratch();
+    recording_ = nullptr;
+    graph_     = nullptr;
+    padded_rows_.reset();
+    delete_errors(request_errors_);
+    isolated_requests_.clear();
+    isolated_responses_.clear();
+    delete_errors(isolated_errors_);
+    synthetic_inputs_.clear();
+    synthetic_rows_.reset();
+    retained_.clear();
+    transforms_         = nullptr;
+    compression_        = nullptr;
+    decompression_pool_ = nullptr;
+    collection_pool_    = nullptr;
+    collection_streams_ = nullptr;
+    requested_outputs_.reset();
+    output_placements_.clear();
+    saved_output_copy_bytes_ = std::size_t{};
+    intermediates_.clear();
+  }
+
+  /**
+   * @brief Give this batch of no requests synthetic inputs of the given
+   * number of rows
+   *
+   * Synthetic batches run predict without any request, e.g. to warm up a
+   * model before it receives traffic. Each input is filled with zeros and
+   * has the type and shape of its specification, with the given rows as the
+   * batch dimension of batched models and 1 for any other variable
+   * dimension. Outputs are computed but never sent, and ragged or string
+   * inputs cannot be retrieved. This must be called before any input is
+   * retrieved.
+   */
+  void synthesize_inputs(std::vector<input_spec> specs, size_type rows)
+  {
+    if (!requests_.empty()) {
+      throw TritonException(Error::Internal, "synthetic inputs require a batch of no requests");
+    }
+    synthetic_inputs_ = std::move(specs);
+    synthetic_rows_   = rows;
+  }
+
+  /**
+   * @brief Keep the given object alive until this batch completes
+   *
+   * Work enqueued by predict may still be reading model data after predict
+   * returns. Retaining the copy of a versioned_resource used by the batch
+   * keeps it from being freed by a concurrent reload until that work is
+   * done.
+   */
+  void retain(std::shared_ptr<void const> object) { retained_.push_back(std::move(object)); }
+
+  /**
+   * @brief Store the results of this batch in the given cache once it
+   * completes successfully
+   *
+   * @param keys The cache key for each request in the batch, or std::nullopt
+   * for requests whose results should not be cached
+   */
+  void cache_results(result_cache& cache, std::vector<std::optional<request_key>> keys)
+  {
+    if (keys.size() != requests_.size()) {
+      throw TritonException(Error::Internal, "one cache key is required for each request");
+    }
+    cache_      = &cache;
+    cache_keys_ = std::move(keys);
+  }
+
+  /**
+   * @brief The memory location in which an output retrieved with no
+   * required location is allocated
+   *
+   * The location minimizes the data copied into the batch's response
+   * buffers. Device memory is chosen if the rows of requests whose clients
+   * want the output on the device (e.g. in CUDA shared memory) outnumber
+   * the rows of those which want it on the host, and host memory otherwise.
+   * Models which can produce an output in either location may pass
+   * std::nullopt to get_output and consult this to decide how to compute it.
+   */
+  auto output_placement(std::string const& name) { return get_output_placement(name).mem_type; }
+
+  /**
+   * @brief The number of bytes of output copies avoided by placing outputs
+   * with output_placement rather than always on the host
+   */
+  auto saved_output_copy_bytes() const { return saved_output_copy_bytes_; }
+
+  /**
+   * @brief Apply the pre- and post-processing stages of the given plan to
+   * the inputs and outputs it names
+   *
+   * Input stages are applied as each input is retrieved and output stages
+   * as each output is finalized, so that predict sees transformed inputs
+   * and writes untransformed outputs. The plan must outlive the batch's
+   * current requests.
+   */
+  void use_transforms(transform_plan const& plan)
+  {
+    transforms_ = plan.empty() ? nullptr : &plan;
+  }
+
+  /**
+   * @brief Decompress the inputs named by the given plan as they are
+   * retrieved
+   *
+   * Each such input is sent as a BYTES tensor holding one compressed row in
+   * each element. The rows of all requests are gathered on the host and
+   * decompressed together: by one batched nvCOMP call if the input is
+   * retrieved in device memory and rapids_triton was built with nvCOMP, or
+   * otherwise on the host by the given pool's threads. Predict receives an
+   * ordinary tensor of rows of the type it retrieves. Compressed inputs
+   * cannot be captured in CUDA graphs. The plan and pool must outlive the
+   * batch's current requests.
+   */
+  void use_compression(compression_plan const& plan, thread_pool* pool = nullptr)
+  {
+    compression_        = plan.empty() ? nullptr : &plan;
+    decompression_pool_ = pool;
+  }
+
+  /**
+   * @brief Collect inputs and copy outputs into responses on the given
+   * streams rather than the batch's compute stream
+   *
+   * Work on the compute stream is ordered after input copies, and output
+   * copies after the work which produced each output, with events rather
+   * than host synchronization, so the transfers of one batch can overlap
+   * with the kernels of another. This must be called before any input or
+   * output is retrieved, and the streams must outlive the batch's current
+   * requests.
+   */
+  void use_copy_streams(cudaStream_t input_stream, cudaStream_t output_stream)
+  {
+    input_copy_stream_  = input_stream;
+    output_copy_stream_ = output_stream;
+  }
+
+  /**
+   * @brief Gather the inputs retrieved together by get_inputs concurrently,
+   * each with its own input collector
+   *
+   * Each input is gathered by one of the given pool's threads on one of the
+   * given streams (or on the input copy stream if none are given), and the
+   * batch's stream waits on all of them via events, so that collection
+   * takes about as long as the largest input rather than the sum of all of
+   * them. The pool and streams must outlive the batch's current requests.
+   */
+  void use_concurrent_collection(thread_pool& pool, std::vector<pooled_stream> const& streams)
+  {
+    collection_pool_    = &pool;
+    collection_streams_ = &streams;
+  }
+
+  /**
+   * @brief Allocate the given number of bytes of pinned staging storage
+   * before it is first needed
+   *
+   * When Triton's pinned input or output buffers are enabled, inputs which
+   * lie on the host are gathered, and device outputs bound for host
+   * responses are copied, through a pinned scratch arena held by the batch.
+   * Since batches are reused, the arena is allocated once rather than for
+   * every batch. Reserving storage for a full batch avoids growing it while
+   * requests are being served. This has no effect once the batch has
+   * allocated scratch storage for its current requests.
+   */
+  void reserve_pinned_staging(std::size_t bytes)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    if constexpr (IS_GPU_BUILD) {
+      if (use_pinned_input_ || use_pinned_output_) {
+        get_scratch_arena(PinnedMemory, 0).reserve(bytes, stream_);
+      }
+    }
+  }
+
+  /**
+   * @brief Remove from the batch each request whose inputs do not match the
+   * given specifications
+   *
+   * Removed requests receive their errors when the batch completes, and
+   * everything else (including predict) sees only the remaining requests, so
+   * that one malformed request does not fail every request batched with it.
+   * This must be called before any inputs are retrieved.
+   *
+   * @return The number of requests remaining in the batch
+   */
+  auto isolate_invalid_requests(std::vector<input_spec> const& specs)
+  {
+    auto valid = std::size_t{};
+    for (auto i = std::size_t{}; i < requests_.size(); ++i) {
+      try {
+        for (auto const& spec : specs) {
+          check_triton_input(requests_[i], spec);
+        }
+      } catch (TritonException const& err) {
+        isolated_requests_.push_back(requests_[i]);
+        isolated_responses_.push_back(responses_[i]);
+        isolated_errors_.push_back(err.error());
+        continue;
+      }
+      requests_[valid]  = requests_[i];
+      responses_[valid] = responses_[i];
+      if (!cache_keys_.empty() && valid != i) { cache_keys_[valid] = std::move(cache_keys_[i]); }
+      ++valid;
+    }
+    requests_.resize(valid);
+    responses_.resize(valid);
+    if (!cache_keys_.empty()) { cache_keys_.resize(valid); }
+    requested_outputs_.reset();
+    return valid;
+  }
+
+  /**
+   * @brief Whether any request in the batch asked for the named output
+   *
+   * Outputs which no request asked for are never sent, so predict may skip
+   * the work of computing them. get_output still returns a tensor for such
+   * an output, backed by scratch storage rather than a response buffer, so
+   * models which do not check can write it as usual. Synthetic batches ask
+   * for every output.
+   */
+  auto output_requested(std::string const& name)
+  {
+    if (requests_.empty()) { return true; }
+    if (!requested_outputs_) {
+      auto names = std::vector<std::string>{};
+      for (auto* request : requests_) {
+        auto request_names = get_requested_outputs(request);
+        std::move(std::begin(request_names), std::end(request_names), std::back_inserter(names));
+      }
+      std::sort(std::begin(names), std::end(names));
+      names.erase(std::unique(std::begin(names), std::end(names)), std::end(names));
+      requested_outputs_ = std::move(names);
+    }
+    return std::binary_search(std::begin(*requested_outputs_), std::end(*requested_outputs_), name);
+  }
+
+  /**
+   * @brief Return the sequence control information for each request in the
+   * batch, in request order
+   */
+  auto get_sequence_controls() const
+  {
+    auto result = std::vector<sequence_control>(requests_.size());
+    std::transform(std::begin(requests_),
+                   std::end(requests_),
+                   std::begin(result),
+                   [](auto* request) { return get_sequence_control(request); });
+    return result;
+  }
+
+  /** A range of consecutive rows of the batch */
+  struct row_range {
+    size_type first;
+    size_type count;
+  };
+
+  /**
+   * @brief Call `fn(*this)` once for each slice of at most `max_rows`
+   * consecutive rows of the batch, in order
+   *
+   * During each call, get_input, get_converted_input, get_inputs and
+   * get_output return tensors holding only the rows of the current slice.
+   * Each input is collected for the whole batch on first use, and later
+   * slices receive views of the same data. Each output is likewise
+   * allocated once for the whole batch, and slices write into their own
+   * rows of it; finalizing these views has no effect, since the whole
+   * output is finalized after the last slice. Ragged, string and response
+   * outputs cannot be used in sliced calls. If `max_rows` is 0 or the
+   * batch has no more than `max_rows` rows, `fn` is called once for the
+   * whole batch.
+   */
+  template <typename F>
+  void for_each_row_slice(size_type max_rows, F&& fn)
+  {
+    auto total_rows = batch_size_.has_value()
+                        ? batch_size_.value()
+                        : triton_batch_rows();
+    if (max_rows == 0 || total_rows <= max_rows) {
+      fn(*this);
+      return;
+    }
+    try {
+      for (auto first = size_type{}; first < total_rows; first += max_rows) {
+        slice_ = row_range{first, std::min(max_rows, total_rows - first)};
+        fn(*this);
+      }
+      slice_.reset();
+      for (auto& output : sliced_outputs_) {
+        output.finalize();
+      }
+    } catch (...) {
+      clear_slices();
+      throw;
+    }
+    clear_slices();
+  }
+
+  /**
+   * @brief Call `fn(*this)` through the CUDA graph of `graphs` for this
+   * batch's bucket of batch sizes
+   *
+   * The first batch in a bucket records the inputs and outputs requested by
+   * `fn`, and the second captures the work `fn` enqueues on this batch's
+   * stream into a graph; later batches only collect their inputs, replay
+   * the graph and send their outputs. While capturing, get_input,
+   * get_inputs, get_converted_input and get_output return tensors at fixed
+   * device addresses whose first dimension is the bucket's number of rows;
+   * rows past the end of the batch hold arbitrary data and their results
+   * are discarded. `fn` must therefore enqueue the same work for every batch
+   * in a bucket, must not synchronize with the host and must not depend on
+   * the values of its inputs on the host. Ragged inputs, string inputs,
+   * response outputs and response streams cannot be used. If `fn` does
+   * anything which prevents capture, the graph is disabled and `fn` is
+   * called directly for later batches in the bucket.
+   */
+  template <typename F>
+  void predict_with_graph(predict_graph_cache& graphs, F&& fn)
+  {
+    auto& graph = graphs.get(get_triton_batch_rows(std::begin(requests_), std::end(requests_)));
+    if (graph.get_status() == predict_graph::status::unrecorded) {
+      recording_ = &graph;
+      try {
+        fn(*this);
+      } catch (...) {
+        recording_ = nullptr;
+        graph.abandon_recording();
+        throw;
+      }
+      recording_ = nullptr;
+      graph.finish_recording();
+      return;
+    }
+    if (graph.get_status() == predict_graph::status::disabled || !graph_inputs_match(graph)) {
+      fn(*this);
+      return;
+    }
+
+    for (auto& input : graph.inputs()) {
+      input.transfer(*this, input);
+    }
+    graph_ = &graph;
+    auto direct = false;
+    try {
+      if (graph.get_status() == predict_graph::status::recorded) {
+        direct = !capture_graph(graph, fn);
+      }
+      if (direct) {
+        // Work which could not be captured is run directly, this once, on
+        // the graph's storage, whose inputs have already been collected
+        fn(*this);
+      } else {
+        graph.launch(stream_);
+      }
+    } catch (...) {
+      graph_ = nullptr;
+      graph.disable();
+      throw;
+    }
+    graph_ = nullptr;
+    for (auto& output : graph.outputs()) {
+      output.transfer(*this, output);
+    }
+    if (direct) { graph.disable(); }
+  }
+
+  /**
+   * @brief The number of rows of outputs obtained without an explicit shape
+   *
+   * This is the batch size, or the rows of the current slice, graph bucket
+   * or padding bucket if one is in effect. At least one input must have been
+   * retrieved first.
+   */
+  size_type output_rows() const
+  {
+    if (!batch_size_.has_value()) {
+      throw TritonException(Error::Internal,
+                            "At least one input must be retrieved before any output");
+    }
+    return slice_ ? slice_->count
+                  : (graph_ ? graph_->rows() : padded_rows_.value_or(batch_size_.value()));
+  }
+
+  /**
+   * @brief Pad this batch up to the smallest of the given bucket sizes which
+   * can hold it
+   *
+   * Inputs are then returned with the bucket's number of rows, followed by
+   * zeros, and outputs obtained with the bucket's number of rows have their
+   * padding rows removed before they are sent. If no bucket can hold the
+   * batch, it is not padded. This must be called before any input is
+   * retrieved.
+   *
+   * @param buckets Bucket sizes in increasing order
+   */
+  void pad_to_bucket(std::vector<size_type> const& buckets)
+  {
+    auto rows   = triton_batch_rows();
+    auto bucket = find_bucket(buckets, rows);
+    if (bucket.has_value() && bucket.value() != rows) {
+      padded_rows_ = bucket;
+    } else {
+      padded_rows_.reset();
+    }
+  }
+
+  /**
+   * @brief The number of rows of this batch's inputs and outputs, including
+   * any padding added by pad_to_bucket
+   *
+   * Models with kernels specialized for particular bucket sizes can pass
+   * this to dispatch_bucket.
+   */
+  auto bucket() const
+  {
+    return padded_rows_.value_or(batch_size_.value_or(triton_batch_rows()));
+  }
+
+  /** The rows visible to the current call of a for_each_row_slice
+   * function, or std::nullopt if the whole batch is visible */
+  auto const& current_rows() const { return slice_; }
+
   template <typename T>
   auto get_input_shape(std::string const& name)
   {
-    auto result = std::vector<size_type>{};
-    if (!requests_.empty()) {
-      result = get_triton_input_shape<T>(std::begin(requests_), std::end(requests_), name);
+    return get_input_shape(name, TritonDtype<T>::value);
+  }
+
+  auto get_input_shape(std::string const& name, DType dtype)
+  {
+    auto result             = std::vector<size_type>{};
+    auto const* compression = compressed(name);
+    // Compressed inputs are sent as one BYTES element for each row
+    if (compression != nullptr) { dtype = DTypeBytes; }
+    if (auto const* intermediate = find_intermediate(name); intermediate != nullptr) {
+      if (intermediate->data == nullptr) {
+        throw TritonException(Error::Internal,
+                              "intermediate tensor " + name + " has not been produced");
+      }
+      result = intermediate->shape;
+      if (!batch_size_.has_value()) { batch_size_ = result.empty() ? size_type{} : result[0]; }
+    } else if (synthetic_rows_) {
+      result = synthetic_shape(name);
+      if (!batch_size_.has_value()) { batch_size_ = result.empty() ? size_type{} : result[0]; }
+    } else if (!requests_.empty()) {
+      result = get_triton_input_shape(std::begin(requests_), std::end(requests_), name, dtype);
 
       auto input_batch_dim = size_type{};
       if (result.size() > 0) { input_batch_dim = result[0]; }
@@ -118,72 +708,200 @@ struct Batch {
                                 "all input tensors must have same batch dimension");
         }
       } else {
-        batch_size_ = input_batch_dim;
+        batch_size_   = input_batch_dim;
+        request_rows_ = get_triton_input_rows(std::begin(requests_), std::end(requests_), name);
       }
     }
+    if (compression != nullptr) {
+      result.resize(std::min(result.size(), std::size_t{1}));
+      result.push_back(compression->row_elements);
+    }
+    return result;
+  }
+
+  template <typename T>
+  Tensor<T> get_input(std::string const& name,
+                      std::optional<MemoryType> const& memory_type,
+                      device_id_t device_id,
+                      cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    if (slice_) {
+      auto& input = whole_batch_input<T>(
+        name, [&]() { return get_input<T>(name, memory_type, device_id, stream); });
+      return Tensor<T>(slice_shape(input), slice_buffer<T>(input, stream));
+    }
+    if (auto const* intermediate = find_intermediate(name); intermediate != nullptr) {
+      return intermediate_input<T>(*intermediate, memory_type, device_id, stream);
+    }
+    if (graph_) { return graph_input<T>(name, stream); }
+    if (synthetic_rows_) {
+      return pad_input(
+        transform_input(name, synthetic_input<T>(name, memory_type, device_id, stream), stream),
+        stream);
+    }
+    if (auto const* compression = compressed(name); compression != nullptr) {
+      return pad_input(
+        transform_input(
+          name,
+          decompressed_input<T>(name, *compression, memory_type, device_id, stream),
+          stream),
+        stream);
+    }
+    auto input = pending_input{};
+    process_input<T>(input, name, memory_type, device_id);
+    finalize_inputs();
+    auto result = pad_input(
+      transform_input(name, make_input_tensor<T>(input, memory_type, device_id, stream), stream),
+      stream);
+    if (recording_) { record_graph_input<T>(name, result.shape(), memory_type, device_id); }
     return result;
   }
 
+  /**
+   * @brief Retrieve an input tensor stored in the given layout
+   *
+   * The shape of the returned tensor is the same in either layout. A
+   * column-major input is written from the collected rows by a single
+   * transpose, which also fills any padding rows, using a tiled kernel on
+   * the device or cache-sized blocks on the host. Device transposes require
+   * the transpose kernel to be registered (see
+   * rapids_triton/tensor/transforms.cuh). Column-major inputs cannot be
+   * sliced or captured in CUDA graphs.
+   */
+  template <typename T>
+  Tensor<T> get_input(std::string const& name,
+                      std::optional<MemoryType> const& memory_type,
+                      device_id_t device_id,
+                      cudaStream_t stream,
+                      TensorLayout layout)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    if (layout == RowMajor) { return get_input<T>(name, memory_type, device_id, stream); }
+    if (slice_) { unsupported_in_slice("column-major inputs"); }
+    if (find_intermediate(name) != nullptr) {
+      throw TritonException(Error::Unsupported,
+                            "intermediate tensors cannot be retrieved in column-major layout");
+    }
+    check_graph_support("column-major inputs");
+    if (synthetic_rows_) {
+      return transpose_input(
+        transform_input(name, synthetic_input<T>(name, memory_type, device_id, stream), stream),
+        stream);
+    }
+    if (auto const* compression = compressed(name); compression != nullptr) {
+      return transpose_input(
+        transform_input(
+          name,
+          decompressed_input<T>(name, *compression, memory_type, device_id, stream),
+          stream),
+        stream);
+    }
+    auto input = pending_input{};
+    process_input<T>(input, name, memory_type, device_id);
+    finalize_inputs();
+    return transpose_input(
+      transform_input(name, make_input_tensor<T>(input, memory_type, device_id, stream), stream),
+      stream);
+  }
+
   template <typename T>
   auto get_input(std::string const& name,
                  std::optional<MemoryType> const& memory_type,
                  device_id_t device_id,
-                 cudaStream_t stream)
+                 TensorLayout layout)
   {
-    auto shape = get_input_shape<T>(name);
-    auto size_bytes =
-      sizeof(T) * std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
-    auto allowed_memory_configs = std::vector<std::pair<MemoryType, int64_t>>{};
-    if (memory_type.has_value()) {
-      allowed_memory_configs.emplace_back(memory_type.value(), device_id);
+    return get_input<T>(name, memory_type, device_id, stream_, layout);
+  }
+
+  /**
+   * @brief Retrieve an input tensor, converting it to type T if the client
+   * sent it as one of the given source types
+   *
+   * Inputs already of type T are returned exactly as by get_input. Inputs of
+   * any of the types in Sources are collected as their original type and
+   * then converted in place: on the host with a vectorizable loop, or on the
+   * device with a conversion kernel. Unless the kernel converting a source
+   * type to T has been registered with `register_device_conversion` (see
+   * rapids_triton/memory/convert.cuh), device inputs of that type are
+   * collected and converted on the host and then copied to the device.
+   * Inputs of any other type are rejected.
+   */
+  template <typename T, typename... Sources>
+  Tensor<T> get_converted_input(std::string const& name,
+                                std::optional<MemoryType> const& memory_type,
+                                device_id_t device_id,
+                                cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    if (slice_) {
+      auto& input = whole_batch_input<T>(name, [&]() {
+        return get_converted_input<T, Sources...>(name, memory_type, device_id, stream);
+      });
+      return Tensor<T>(slice_shape(input), slice_buffer<T>(input, stream));
+    }
+    // Intermediates are never converted, since the producing stage chooses
+    // their type, and compressed inputs are decompressed to any type
+    if (find_intermediate(name) != nullptr || compressed(name) != nullptr) {
+      return get_input<T>(name, memory_type, device_id, stream);
+    }
+    if (graph_) { return graph_input<T>(name, stream); }
+    // Synthetic inputs are zeros of whatever type is required
+    if (synthetic_rows_) { return get_input<T>(name, memory_type, device_id, stream); }
+    auto result = std::optional<Tensor<T>>{};
+    auto dtype  = get_triton_input_dtype(std::begin(requests_), std::end(requests_), name);
+    if (dtype == TritonDtype<T>::value) {
+      result.emplace(get_input<T>(name, memory_type, device_id, stream));
     } else {
-      allowed_memory_configs.emplace_back(HostMemory, int64_t{});
-      allowed_memory_configs.emplace_back(DeviceMemory, device_id);
-    }
-
-    auto const* raw_buffer  = static_cast<char*>(nullptr);
-    auto reported_bytes     = std::size_t{};
-    auto reported_mem_type  = MemoryType{};
-    auto reported_device_id = int64_t{};
-
-    triton_check(
-      collector_.ProcessTensor(name.c_str(),
-                               static_cast<char*>(nullptr),  // Return data without copy if possible
-                               size_bytes,
-                               allowed_memory_configs,
-                               &raw_buffer,
-                               &reported_bytes,
-                               &reported_mem_type,
-                               &reported_device_id));
-
-    if(collector_.Finalize()){
-      if constexpr (IS_GPU_BUILD) {
-        cuda_check(cudaStreamSynchronize(stream_));
-      } else {
-        throw TritonException(Error::Internal, "stream synchronization required in non-GPU build");
+      check_graph_support("converted inputs");
+      auto converted =
+        (convert_input<T, Sources>(result, dtype, name, memory_type, device_id, stream) || ...);
+      if (!converted) {
+        auto log_stream = std::stringstream{};
+        log_stream << "input " << name << " cannot be converted from type " << dtype
+                   << " to required type " << TritonDtype<T>::value;
+        throw TritonException(Error::InvalidArg, log_stream.str());
       }
     }
+    return std::move(*result);
+  }
 
-    std::for_each(std::begin(responses_), std::end(responses_), [](auto* response) {
-      if (response == nullptr) {
-        throw TritonException(Error::Internal, "Input collection failed");
-      }
-    });
-
-    auto buffer = Buffer(reinterpret_cast<T*>(raw_buffer),
-                         reported_bytes / sizeof(T),
-                         reported_mem_type,
-                         reported_device_id,
-                         stream);
-
-    if (memory_type && (reported_mem_type != memory_type || reported_device_id != device_id)) {
-      throw TritonException(Error::Internal, "data collected in wrong location");
-    }
+  template <typename T, typename... Sources>
+  auto get_converted_input(std::string const& name,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id)
+  {
+    return get_converted_input<T, Sources...>(name, memory_type, device_id, stream_);
+  }
 
-    // Set start time of batch to time latest input tensor was retrieved
-    compute_start_time_ = std::chrono::steady_clock::now();
+  /**
+   * @brief Retrieve several input tensors at once
+   *
+   * All requested inputs are gathered before the input collector is
+   * finalized, so that copies for every input are issued together and at
+   * most one stream synchronization is required. This should be preferred
+   * over successive calls to get_input for models with many inputs.
+   *
+   * @return A tuple of Tensors with the given element types, in the same
+   * order as the given names
+   */
+  template <typename... Ts>
+  auto get_inputs(std::array<std::string, sizeof...(Ts)> const& names,
+                  std::optional<MemoryType> const& memory_type,
+                  device_id_t device_id,
+                  cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    return collect_inputs<Ts...>(
+      names, memory_type, device_id, stream, std::index_sequence_for<Ts...>{});
+  }
 
-    return Tensor(std::move(shape), std::move(buffer));
+  template <typename... Ts>
+  auto get_inputs(std::array<std::string, sizeof...(Ts)> const& names,
+                  std::optional<MemoryType> const& memory_type,
+                  device_id_t device_id)
+  {
+    return get_inputs<Ts...>(names, memory_type, device_id, stream_);
   }
 
   template <typename T>
@@ -194,28 +912,299 @@ struct Batch {
     return get_input<T>(name, memory_type, device_id, stream_);
   }
 
+  /**
+   * @brief Retrieve an input whose shape may differ between requests
+   *
+   * The data of all requests are packed one after another into a single
+   * buffer with no padding, and the shape of each request is recorded
+   * separately. Ragged inputs do not determine the batch size used for
+   * outputs; the offsets and shapes are computed from the request properties
+   * in a single pass.
+   */
+  template <typename T>
+  auto get_ragged_input(std::string const& name,
+                        std::optional<MemoryType> const& memory_type,
+                        device_id_t device_id,
+                        cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    if (slice_) { unsupported_in_slice("ragged inputs"); }
+    check_graph_support("ragged inputs");
+    check_synthetic_support("ragged inputs");
+    auto shapes = get_triton_input_shapes(
+      std::begin(requests_), std::end(requests_), name, TritonDtype<T>::value);
+    auto offsets = std::vector<size_type>{};
+    offsets.reserve(shapes.size() + 1);
+    offsets.push_back(size_type{});
+    for (auto const& shape : shapes) {
+      offsets.push_back(offsets.back() + std::reduce(shape.begin(),
+                                                     shape.end(),
+                                                     size_type{1},
+                                                     std::multiplies<>()));
+    }
+
+    auto input      = pending_input{};
+    auto size_bytes = offsets.back() * sizeof(T);
+    collect_raw_input(input, name, size_bytes, memory_type, device_id);
+    finalize_inputs();
+
+    auto buffer = Buffer<T>(reinterpret_cast<T*>(input.raw_buffer),
+                            input.reported_bytes / sizeof(T),
+                            input.reported_mem_type,
+                            input.reported_device_id,
+                            stream);
+    if (memory_type && (!satisfies_memory_type(input.reported_mem_type, *memory_type) ||
+                        input.reported_device_id != device_id)) {
+      throw TritonException(Error::Internal, "data collected in wrong location");
+    }
+    activity_.add_input(input.reported_mem_type, input.reported_bytes);
+    mark_compute_start();
+    return RaggedTensor<T>(std::move(shapes), std::move(offsets), std::move(buffer));
+  }
+
+  template <typename T>
+  auto get_ragged_input(std::string const& name,
+                        std::optional<MemoryType> const& memory_type,
+                        device_id_t device_id)
+  {
+    return get_ragged_input<T>(name, memory_type, device_id, stream_);
+  }
+
+  /**
+   * @brief Retrieve a sparse matrix which each request sends as three
+   * inputs in compressed sparse row (CSR) format
+   *
+   * Each request sends INT64 row pointers (one more than its number of
+   * rows), INT64 column indices and values of type T as the inputs with the
+   * given names. These are collected as ragged inputs, so only the nonzero
+   * elements are transferred, and the matrices of all requests are stacked
+   * into one SparseTensor with the given number of columns. Row pointers
+   * are rebased onto the stacked values on the device by a kernel if they
+   * are collected in device memory and the kernel has been registered with
+   * `register_device_sparse_inputs` (see
+   * rapids_triton/tensor/sparse_tensor.cuh), or else on the host before
+   * being copied to the device. Row pointers which decrease or do not span
+   * exactly their request's values are rejected on either path; on the
+   * device, this waits on the stream for the result of the check. The total
+   * number of rows is the batch size used for outputs.
+   */
+  template <typename T>
+  auto get_sparse_input(std::string const& indptr_name,
+                        std::string const& indices_name,
+                        std::string const& values_name,
+                        size_type cols,
+                        std::optional<MemoryType> const& memory_type,
+                        device_id_t device_id,
+                        cudaStream_t stream)
+  {
+    using offset_type = typename SparseTensor<T>::offset_type;
+    using index_type  = typename SparseTensor<T>::index_type;
+    auto site         = scoped_allocation_site{allocation_site::input};
+    if (slice_) { unsupported_in_slice("sparse inputs"); }
+    check_graph_support("sparse inputs");
+    check_synthetic_support("sparse inputs");
+
+    auto device_rebase = IS_GPU_BUILD && detail::device_rebase_available<offset_type>();
+    auto packed_indptr = get_ragged_input<offset_type const>(
+      indptr_name,
+      device_rebase ? memory_type : std::optional<MemoryType>{HostMemory},
+      device_id,
+      stream);
+    auto indices = get_ragged_input<index_type const>(indices_name, memory_type, device_id, stream);
+    auto values  = get_ragged_input<T>(values_name, memory_type, device_id, stream);
+
+    auto range =
+      nvtx_range{"get_sparse_input ", values_name, ": ", values.size(), " nonzero elements"};
+    auto rows = std::vector<size_type>(packed_indptr.num_segments());
+    for (auto i = std::size_t{}; i < rows.size(); ++i) {
+      if (packed_indptr.segment_size(i) == 0 ||
+          indices.segment_size(i) != values.segment_size(i)) {
+        throw TritonException(Error::InvalidArg, "malformed sparse input " + values_name);
+      }
+      rows[i] = packed_indptr.segment_size(i) - 1;
+    }
+    auto total_rows = std::reduce(rows.begin(), rows.end(), size_type{});
+
+    auto rebase_type   = packed_indptr.mem_type();
+    auto rebase_device = packed_indptr.device();
+    // The offsets of each request's values are needed where the row
+    // pointers are rebased
+    auto const* value_offsets = values.offsets().data();
+    auto moved_offsets        = std::optional<Buffer<offset_type>>{};
+    if (is_host_memory(values.mem_type()) != is_host_memory(rebase_type) ||
+        (!is_host_memory(rebase_type) && values.device() != rebase_device)) {
+      moved_offsets.emplace(values.offsets(), rebase_type, rebase_device);
+      if (is_host_memory(rebase_type)) { moved_offsets->stream_synchronize(); }
+      value_offsets = moved_offsets->data();
+    }
+    // Row pointers are checked against the values they index wherever they
+    // are rebased, so that no row reaches outside its own request's values
+    if (!detail::valid_indptr(packed_indptr.data(),
+                              packed_indptr.offsets().data(),
+                              value_offsets,
+                              packed_indptr.num_segments(),
+                              packed_indptr.size(),
+                              rebase_device,
+                              stream,
+                              rebase_type)) {
+      throw TritonException(Error::InvalidArg,
+                            "row pointers of sparse input " + values_name +
+                              " do not match its values");
+    }
+    auto indptr = Buffer<offset_type>(total_rows + 1, rebase_type, rebase_device, stream);
+    detail::concat_indptr(indptr.data(),
+                          packed_indptr.data(),
+                          packed_indptr.offsets().data(),
+                          value_offsets,
+                          packed_indptr.num_segments(),
+                          packed_indptr.size(),
+                          stream,
+                          rebase_type);
+    if (memory_type && (!satisfies_memory_type(indptr.mem_type(), *memory_type) ||
+                        (!is_host_memory(*memory_type) && indptr.device() != device_id))) {
+      indptr = Buffer<offset_type>(indptr, *memory_type, device_id);
+    }
+
+    if (batch_size_.has_value()) {
+      if (batch_size_.value() != total_rows) {
+        throw TritonException(Error::Internal,
+                              "all input tensors must have same batch dimension");
+      }
+    } else {
+      batch_size_   = total_rows;
+      request_rows_ = std::move(rows);
+    }
+    return SparseTensor<T>(total_rows,
+                           cols,
+                           std::move(indptr),
+                           Buffer<index_type const>(std::move(indices.buffer())),
+                           std::move(values.buffer()));
+  }
+
+  template <typename T>
+  auto get_sparse_input(std::string const& indptr_name,
+                        std::string const& indices_name,
+                        std::string const& values_name,
+                        size_type cols,
+                        std::optional<MemoryType> const& memory_type,
+                        device_id_t device_id)
+  {
+    return get_sparse_input<T>(
+      indptr_name, indices_name, values_name, cols, memory_type, device_id, stream_);
+  }
+
+  /**
+   * @brief Retrieve a BYTES input as a StringTensor
+   *
+   * The serialized strings for the whole batch are gathered on the host and
+   * parsed once into a flattened offsets and characters layout. If device
+   * memory is requested, the parsed tensor is then moved to the device with
+   * one copy for each of those two buffers.
+   */
+  auto get_string_input(std::string const& name,
+                        std::optional<MemoryType> const& memory_type,
+                        device_id_t device_id,
+                        cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::input};
+    if (slice_) { unsupported_in_slice("string inputs"); }
+    check_graph_support("string inputs");
+    check_synthetic_support("string inputs");
+    auto input  = pending_input{};
+    input.shape = get_input_shape(name, DTypeBytes);
+
+    auto size_bytes = get_triton_input_byte_size(std::begin(requests_), std::end(requests_), name);
+
+    auto range = nvtx_range{"get_string_input ", name, ": ", size_bytes, " bytes"};
+
+    collect_raw_input(input, name, size_bytes, HostMemory, 0);
+    finalize_inputs();
+
+    auto result = parse_serialized_strings(
+      std::move(input.shape), input.raw_buffer, input.reported_bytes, stream);
+    if (memory_type.value_or(HostMemory) != HostMemory) {
+      result = StringTensor(result, memory_type.value(), device_id);
+    }
+
+    mark_compute_start();
+    return result;
+  }
+
+  auto get_string_input(std::string const& name,
+                        std::optional<MemoryType> const& memory_type,
+                        device_id_t device_id)
+  {
+    return get_string_input(name, memory_type, device_id, stream_);
+  }
+
   template <typename T>
   auto get_output(std::string const& name,
                   std::optional<MemoryType> const& memory_type,
                   device_id_t device_id,
                   cudaStream_t stream)
   {
-    if (!batch_size_.has_value()) {
-      throw TritonException(Error::Internal,
-                            "At least one input must be retrieved before any output");
+    return get_output<T>(
+      name, get_output_shape_(name, output_rows()), memory_type, device_id, stream);
+  }
+
+  /**
+   * @brief Get an output of the given shape for the whole batch
+   *
+   * This is used for outputs whose shape is not fully specified by the model
+   * configuration and is only known at predict time. For batches of several
+   * requests, the first dimension must be the batch dimension, since the
+   * output is divided among requests along it; outputs whose shape varies
+   * from request to request should instead be obtained from the overload of
+   * get_response_output which accepts a shape for each request.
+   */
+  template <typename T>
+  OutputTensor<T> get_output(std::string const& name,
+                             std::vector<size_type> shape,
+                             std::optional<MemoryType> const& memory_type,
+                             device_id_t device_id,
+                             cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::output};
+    admit_device_work();
+    if (slice_) {
+      if (!batch_size_.has_value()) {
+        throw TritonException(Error::Internal,
+                              "At least one input must be retrieved before any output");
+      }
+      if (shape.empty() || shape[0] != slice_->count) {
+        throw TritonException(Error::Internal,
+                              "outputs for a slice of a batch must have the slice's rows as "
+                              "their first dimension");
+      }
+      auto& output = whole_batch_output<T>(name, [&]() {
+        auto batch_shape = shape;
+        batch_shape[0]   = batch_size_.value();
+        return get_output<T>(name, std::move(batch_shape), memory_type, device_id, stream);
+      });
+      return OutputTensor<T>(std::move(shape), slice_buffer<T>(output, stream), name);
     }
-    auto shape       = get_output_shape_(name, batch_size_.value());
-    auto buffer_size = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
-    auto final_memory_type = MemoryType{};
-    if (memory_type.has_value()) {
-      final_memory_type = memory_type.value();
-    } else {
-      // If consumer doesn't care, use HostMemory to avoid additional copy on
-      // non-shared-memory responses.
-      final_memory_type = HostMemory;
+    if (auto* intermediate = find_intermediate(name); intermediate != nullptr) {
+      return intermediate_output<T>(
+        *intermediate, std::move(shape), memory_type, device_id, stream);
     }
-    auto buffer = Buffer<T>(buffer_size, final_memory_type, device_id, stream);
-    return OutputTensor<T>(std::move(shape), std::move(buffer), name, responder_);
+    if (graph_) { return graph_output<T>(name, std::move(shape), stream); }
+    if (!output_requested(name)) {
+      // Graphs record only the outputs which were sent
+      stop_graph_recording();
+      auto mem_type = memory_type.value_or(HostMemory);
+      auto count = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+      auto storage = scratch<T>(count, mem_type, device_id, stream);
+      return OutputTensor<T>(std::move(shape),
+                             Buffer<T>(storage.data(), count, mem_type, device_id, stream),
+                             name);
+    }
+    if (transforms_ != nullptr) {
+      if (auto const* stages = transforms_->output_stages(name); stages != nullptr) {
+        return transformed_output<T>(
+          name, std::move(shape), *stages, memory_type, device_id, stream);
+      }
+    }
+    return make_output<T>(name, std::move(shape), memory_type, device_id, stream);
   }
 
   template <typename T>
@@ -226,47 +1215,2256 @@ struct Batch {
     return get_output<T>(name, memory_type, device_id, stream_);
   }
 
-  auto const& compute_start_time() const { return compute_start_time_; }
+  template <typename T>
+  auto get_output(std::string const& name,
+                  std::vector<size_type> shape,
+                  std::optional<MemoryType> const& memory_type,
+                  device_id_t device_id)
+  {
+    return get_output<T>(name, std::move(shape), memory_type, device_id, stream_);
+  }
 
-  auto stream() const { return stream_; }
+  /**
+   * @brief Get an output which is written directly into the response buffer
+   * of each request
+   *
+   * Unlike get_output, no batch-wide buffer is allocated and no copy is
+   * required when the batch is finalized. Instead, Triton is asked for the
+   * final output buffer of each response (which may be in a shared memory
+   * region registered by the client), and these buffers are returned as the
+   * segments of a SegmentedTensor. Triton may provide a buffer in a
+   * different memory location than the one requested, so callers should
+   * check the mem_type of each segment or use rapids::copy to fill them.
+   */
+  template <typename T>
+  auto get_response_output(std::string const& name,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id,
+                           cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::output};
+    if (!batch_size_.has_value()) {
+      throw TritonException(Error::Internal,
+                            "At least one input must be retrieved before any output");
+    }
+    admit_device_work();
+    auto shapes = std::vector<std::vector<size_type>>{};
+    shapes.reserve(responses_.size());
+    std::transform(std::begin(request_rows_),
+                   std::end(request_rows_),
+                   std::back_inserter(shapes),
+                   [this, &name](auto rows) { return get_output_shape_(name, rows); });
+    return get_response_output<T>(name, std::move(shapes), memory_type, device_id, stream);
+  }
+
+  /**
+   * @brief Get an output written directly into the response buffer of each
+   * request, with separately-specified shapes for each request
+   *
+   * This allows outputs whose size is only known after computation (e.g.
+   * top-k results or variable-length sequences) to be returned without
+   * allocating the largest possible output: the model first determines the
+   * output shape for each request and then receives exactly that much
+   * response memory. If all shapes agree on every dimension after the
+   * first, the returned tensor's shape is their concatenation along the
+   * first dimension, so that rapids::copy can scatter a batch-wide result
+   * into it. Otherwise, its shape is the flat total number of elements, and
+   * each segment should be written separately.
+   */
+  template <typename T>
+  auto get_response_output(std::string const& name,
+                           std::vector<std::vector<size_type>> shapes,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id,
+                           cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::output};
+    if (slice_) { unsupported_in_slice("response outputs"); }
+    admit_device_work();
+    check_graph_support("response outputs");
+    if (shapes.size() != responses_.size()) {
+      throw TritonException(Error::Internal, "one output shape is required for each request");
+    }
+    auto segments = std::vector<TensorView<T>>{};
+    segments.reserve(responses_.size());
+    for (auto i = std::size_t{}; i < responses_.size(); ++i) {
+      auto buffer = response_output_buffer<T>(
+        i, name, shapes[i], memory_type.value_or(HostMemory), device_id);
+      segments.emplace_back(
+        buffer.data(), std::move(shapes[i]), buffer.mem_type(), buffer.device(), stream);
+    }
+    has_response_outputs_  = true;
+    has_segmented_outputs_ = true;
+    return SegmentedTensor<T>(concatenated_shape(segments), std::move(segments));
+  }
 
-  void finalize(TRITONSERVER_Error* err)
+  template <typename T>
+  auto get_response_output(std::string const& name,
+                           std::vector<std::vector<size_type>> shapes,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id)
   {
-    auto compute_end_time = std::chrono::steady_clock::now();
-    if (responder_->Finalize()) { cuda_check(cudaStreamSynchronize(stream_)); }
+    return get_response_output<T>(name, std::move(shapes), memory_type, device_id, stream_);
+  }
 
-    send_responses(std::begin(responses_), std::end(responses_), err);
+  template <typename T>
+  auto get_response_output(std::string const& name,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id)
+  {
+    return get_response_output<T>(name, memory_type, device_id, stream_);
+  }
 
-    // Triton resumes ownership of failed requests; only release on success
-    if (err == nullptr) {
-      std::for_each(
-        std::begin(requests_), std::end(requests_), [this, &compute_end_time](auto& request) {
-          report_statistics_(request,
-                             start_time_,
-                             compute_start_time_,
-                             compute_end_time,
-                             std::chrono::steady_clock::now());
-        });
-      release_requests(std::begin(requests_), std::end(requests_));
+  /**
+   * @brief Wait for admission under the given limit before enqueueing
+   * device work for this batch
+   *
+   * Admission is taken when predict first requests an output or device
+   * scratch storage, so that inputs are still collected while other batches
+   * occupy the device, and is held until the batch's device work is
+   * complete.
+   */
+  void use_admission(predict_admission& admission) { admission_ = &admission; }
+
+  /**
+   * @brief Wait for admission to enqueue device work, if this batch is
+   * subject to admission and has not yet been admitted
+   *
+   * This is called automatically when outputs or device scratch storage are
+   * requested. Models which launch device work before requesting either
+   * should call it first.
+   */
+  void admit_device_work()
+  {
+    if (admission_ != nullptr && !admission_ticket_) {
+      admission_ticket_ = admission_ticket{*admission_, batch_size_.value_or(size_type{1})};
     }
   }
 
- private:
-  std::vector<TRITONBACKEND_Request*> requests_;
-  std::vector<TRITONBACKEND_Response*> responses_;
-  std::function<std::vector<size_type>(std::string const&, size_type)> get_output_shape_;
-  std::function<void(TRITONBACKEND_Request*,
-                     time_point const&,
-                     time_point const&,
-                     time_point const&,
-                     time_point const&)>
-    report_statistics_;
-  BackendInputCollector collector_;
-  std::shared_ptr<BackendOutputResponder> responder_;
-  cudaStream_t stream_;
-  std::chrono::time_point<std::chrono::steady_clock> start_time_;
-  std::chrono::time_point<std::chrono::steady_clock> compute_start_time_;
-  std::optional<size_type> batch_size_;
+  /** Give up this batch's admission without waiting for its device work,
+   * e.g. when it is abandoned without being completed */
+  void release_admission() noexcept { admission_ticket_.release(); }
+
+  /**
+   * @brief Take admission to enqueue device work for a batch of the given
+   * number of rows now, rather than when predict first requests an output,
+   * waiting no longer than the given time
+   *
+   * @return false if this batch is subject to admission and was not
+   * admitted in time
+   */
+  bool try_admit_device_work(size_type rows, std::chrono::milliseconds wait)
+  {
+    if (admission_ != nullptr && !admission_ticket_) {
+      admission_ticket_ = admission_ticket::try_admit(*admission_, rows, wait);
+    }
+    return admission_ == nullptr || static_cast<bool>(admission_ticket_);
+  }
+
+  /**
+   * @brief Predict this batch with the model's host path rather than on its
+   * device
+   *
+   * This must be chosen before any input is retrieved, since the base
+   * Model::preferred_mem_type then places the batch's data on the host.
+   */
+  void dispatch_to_host()
+  {
+    host_dispatch_ = true;
+    // Host work does not count against the device's limit
+    admission_ = nullptr;
+    admission_ticket_.release();
+  }
+
+  /**
+   * @brief Discard the work done by predict for this batch so that it may
+   * be predicted again on the host, e.g. after running out of device memory
+   *
+   * This waits for any device work already enqueued for the batch. It is
+   * not possible once outputs have been written into responses, sent
+   * through response streams or failed for individual requests, or for a
+   * batch which is already on the host.
+   *
+   * @return Whether the batch may now be predicted on the host
+   */
+  bool redispatch_to_host()
+  {
+    if (host_dispatch_ || has_response_outputs_ || !streams_.empty() || !request_errors_.empty() ||
+        std::find(std::begin(responses_), std::end(responses_), nullptr) != std::end(responses_)) {
+      return false;
+    }
+    // Work already enqueued may still use storage which is about to be
+    // recycled
+    if constexpr (IS_GPU_BUILD) { synchronize(stream_); }
+    collector_.reset();
+    responder_.reset();
+    concurrent_collectors_.clear();
+    staged_outputs_.clear();
+    pending_decompressions_.clear();
+    clear_capture();
+    clear_slices();
+    reset_scratch();
+    output_placements_.clear();
+    intermediates_.clear();
+    batch_size_.reset();
+    request_rows_.clear();
+    staged_device_inputs_.clear();
+    staged_input_bytes_   = std::size_t{};
+    device_timing_        = false;
+    device_compute_timed_ = false;
+    dispatch_to_host();
+    return true;
+  }
+
+  /** Whether this batch is predicted by the model's host path */
+  auto dispatched_to_host() const { return host_dispatch_; }
+
+  auto const& compute_start_time() const { return compute_start_time_; }
+  auto const& compute_end_time() const { return compute_end_time_; }
+
+  /**
+   * @brief Measure the device time taken by the work enqueued during predict
+   *
+   * Timing events are recorded on the batch's stream by
+   * begin_device_compute and end_device_compute. This has no effect in
+   * non-GPU builds.
+   */
+  void use_device_timing() { device_timing_ = IS_GPU_BUILD; }
+
+  /** Mark the point on the batch's stream at which predict begins; the mark
+   * moves to the retrieval of each later input */
+  void begin_device_compute()
+  {
+    if (device_timing_) {
+      if (!compute_events_) { compute_events_.emplace(cuda_event{true}, cuda_event{true}); }
+      compute_events_->first.record(stream_);
+    }
+  }
+
+  /** Mark the point on the batch's stream at which predict ends */
+  void end_device_compute()
+  {
+    if (device_timing_ && compute_events_) {
+      compute_events_->second.record(stream_);
+      device_compute_timed_ = true;
+    }
+  }
+
+  /**
+   * @brief Return the device time taken by the work enqueued during predict
+   * or nullopt if it was not measured
+   *
+   * Blocks until that work is complete.
+   */
+  std::optional<std::chrono::nanoseconds> device_compute_time() const
+  {
+    auto result = std::optional<std::chrono::nanoseconds>{};
+    if (device_compute_timed_) {
+      compute_events_->second.synchronize();
+      result = compute_events_->second.elapsed_since(compute_events_->first);
+    }
+    return result;
+  }
+
+  auto stream() const { return stream_; }
+
+  /**
+   * @brief The number of input bytes which had to be copied from another
+   * memory location (e.g. from host to device) to collect this batch's
+   * inputs in the requested locations
+   *
+   * Gathering data which are already in the right location into one
+   * contiguous buffer is not counted.
+   */
+  auto staged_input_bytes() const { return staged_input_bytes_; }
+
+  /**
+   * @brief The bytes this batch has collected and placed in each memory
+   * location, the times it has waited on a stream and how often its scratch
+   * storage was reused, since it was last reset
+   */
+  auto const& activity() const { return activity_; }
+
+  /**
+   * @brief Return temporary storage for `count` elements of type T which
+   * remains valid until the batch completes
+   *
+   * Storage is carved from an arena kept with this batch and reused by the
+   * requests it processes later, so obtaining it costs no more than bumping
+   * an offset and nothing is freed per batch. The returned Buffer is a
+   * non-owning view of uninitialized memory; it must not be used after
+   * `complete` (or `finalize`) has been called, at which point all scratch
+   * storage is recycled. Work enqueued on a different stream must be
+   * ordered after work on `stream`.
+   */
+  template <typename T>
+  auto scratch(size_type count,
+               MemoryType memory_type,
+               device_id_t device_id,
+               cudaStream_t stream)
+  {
+    auto site = scoped_allocation_site{allocation_site::scratch};
+    if (!is_host_memory(memory_type)) { admit_device_work(); }
+    auto& arena   = get_scratch_arena(memory_type, device_id);
+    auto capacity = arena.capacity();
+    auto result   = arena.template allocate<T>(count, stream);
+    // The arena only grows when no block it holds has room
+    if (arena.capacity() == capacity) {
+      ++activity_.scratch_hits;
+    } else {
+      ++activity_.scratch_misses;
+    }
+    return result;
+  }
+
+  template <typename T>
+  auto scratch(size_type count, MemoryType memory_type = DeviceMemory, device_id_t device_id = 0)
+  {
+    return scratch<T>(count, memory_type, device_id, stream_);
+  }
+
+  /**
+   * @brief The largest number of bytes of scratch storage used by any one
+   * set of requests processed by this batch, summed over memory locations
+   *
+   * This may be used to size a model's memory budget or pool.
+   */
+  auto scratch_high_water_mark() const
+  {
+    auto result = std::size_t{};
+    for (auto const& arena : scratch_) {
+      result += arena.high_water_mark();
+    }
+    return result;
+  }
+
+  /**
+   * @brief Declare a tensor which one stage of a composed model produces and
+   * a later stage consumes within this batch
+   *
+   * Once declared, the name is no longer looked up among the requests'
+   * inputs or outputs. The output obtained for it through get_output is
+   * backed by scratch storage in the location the producing stage asks for
+   * and is never sent in responses; get_input and its variants then return a
+   * view of that same storage, on the consuming stage's stream, so a device
+   * tensor passes between stages with neither a copy nor a host
+   * synchronization. A copy is made only if the consuming stage requires
+   * another memory location. Since intermediates do not appear in the model
+   * configuration, their outputs must be obtained with an explicit shape.
+   * Intermediates cannot be used in graph-captured predict.
+   */
+  void declare_intermediate(std::string const& name)
+  {
+    check_graph_support("intermediate tensors");
+    if (find_intermediate(name) == nullptr) {
+      intermediates_.push_back(
+        intermediate_tensor{name, DType{}, nullptr, {}, HostMemory, device_id_t{}, stream_});
+    }
+  }
+
+  /**
+   * @brief Issue any outstanding copies of output data into responses
+   *
+   * @return true if the batch's stream must be synchronized before responses
+   * can be sent
+   */
+  auto finalize_outputs()
+  {
+    compute_end_time_ = std::chrono::steady_clock::now();
+    auto range        = nvtx_range{"output finalize: ", requests_.size(), " requests"};
+    if (!staged_outputs_.empty()) {
+      // Staged outputs are sent from host memory, so their copies must be
+      // complete before the responder reads them
+      if constexpr (IS_GPU_BUILD) {
+        auto synchronized = std::vector<cudaStream_t>{};
+        for (auto const& entry : staged_outputs_) {
+          if (std::find(std::begin(synchronized), std::end(synchronized), entry.first) ==
+              std::end(synchronized)) {
+            synchronize(entry.first);
+            synchronized.push_back(entry.first);
+          }
+        }
+      }
+      std::for_each(std::begin(staged_outputs_), std::end(staged_outputs_), [](auto& entry) {
+        entry.second();
+      });
+      staged_outputs_.clear();
+    }
+    // Outputs written directly into responses may still be the target of
+    // asynchronous work on this stream
+    auto responder_needs_sync = responder_ && responder_->Finalize();
+    auto needs_sync           = responder_needs_sync || (IS_GPU_BUILD && has_response_outputs_);
+    if constexpr (IS_GPU_BUILD) {
+      if (needs_sync && output_copy_stream_ != stream_) {
+        if (!output_copies_) { output_copies_.emplace(); }
+        // Response outputs are written by predict without any copy
+        if (has_segmented_outputs_) {
+          output_copies_->record(stream_);
+          output_copies_->wait(output_copy_stream_);
+        }
+        output_copies_->record(output_copy_stream_);
+      }
+    }
+    return needs_sync;
+  }
+
+  /**
+   * @brief Send responses for all requests in this batch, report statistics
+   * and release requests
+   *
+   * This method may be called from a thread other than the one which
+   * constructed the batch, provided that finalize_outputs has already been
+   * called. The batch takes ownership of the given error, which is deleted
+   * once it has been sent.
+   */
+  void complete(TRITONSERVER_Error* err, bool needs_sync)
+  {
+    auto range     = nvtx_range{"send responses: ", requests_.size(), " requests"};
+    auto owned_err = std::unique_ptr<TRITONSERVER_Error, decltype(&TRITONSERVER_ErrorDelete)>{
+      err, &TRITONSERVER_ErrorDelete};
+    // This is the only point at which the host waits on output copies; output
+    // tensors order their work with respect to the copy stream via events.
+    // With a dedicated copy stream, only the copies themselves are awaited.
+    if (IS_GPU_BUILD && needs_sync && output_copy_stream_ != stream_) {
+      output_copies_->synchronize();
+      ++activity_.synchronizations;
+      needs_sync = false;
+    }
+    // Admission is held until the batch's device work is complete
+    if (needs_sync || (IS_GPU_BUILD && (!retained_.empty() || admission_ticket_))) {
+      synchronize(stream_);
+    }
+    retained_.clear();
+    admission_ticket_.release();
+    // Rows decompressed on the device are only checked once decompression
+    // is complete; malformed rows fail the whole batch, as they would have
+    // had they been found while predict retrieved the input
+    if (err == nullptr && !pending_decompressions_.empty()) {
+      err = check_decompressions();
+      owned_err.reset(err);
+    }
+    pending_decompressions_.clear();
+
+    if (err == nullptr && cache_ != nullptr && streams_.empty()) {
+      try {
+        store_results();
+      } catch (TritonException const& cache_err) {
+        log_warn(__FILE__, __LINE__) << "Failed to cache results: " << cache_err.what();
+      }
+    }
+    clear_capture();
+
+    auto per_request = err == nullptr && !request_errors_.empty();
+    if (streams_.empty()) {
+      if (per_request) {
+        send_responses(std::begin(responses_), std::end(responses_), request_errors_);
+      } else {
+        send_responses(std::begin(responses_), std::end(responses_), err);
+      }
+    } else {
+      for (auto i = std::size_t{}; i < responses_.size(); ++i) {
+        auto* request_err = per_request ? request_errors_[i] : err;
+        if (streams_[i]) {
+          finish_stream(i, request_err);
+        } else {
+          send_response(responses_[i], TRITONSERVER_RESPONSE_COMPLETE_FINAL, request_err);
+        }
+      }
+      streams_.clear();
+    }
+
+    // Every request has now had a response sent, so all are released whether
+    // or not the batch failed; statistics are reported only for requests
+    // which succeeded
+    if (err == nullptr) {
+      for (auto i = std::size_t{}; i < requests_.size(); ++i) {
+        if (per_request && request_errors_[i] != nullptr) { continue; }
+        report_statistics_(requests_[i],
+                           start_time_,
+                           compute_start_time_,
+                           compute_end_time_,
+                           std::chrono::steady_clock::now());
+      }
+    }
+    release_requests(std::begin(requests_), std::end(requests_));
+
+    // Requests removed for invalid inputs failed alone, whatever the outcome
+    // of the rest of the batch
+    if (!isolated_requests_.empty()) {
+      send_responses(
+        std::begin(isolated_responses_), std::end(isolated_responses_), isolated_errors_);
+      release_requests(std::begin(isolated_requests_), std::end(isolated_requests_));
+      isolated_requests_.clear();
+      isolated_responses_.clear();
+    }
+    // Triton copies errors as they are sent, so they are no longer needed
+    delete_errors(request_errors_);
+    delete_errors(isolated_errors_);
+
+    // Release staging buffers held for this batch's copies rather than
+    // retaining them until the batch is reset or destroyed
+    collector_.reset();
+    responder_.reset();
+    concurrent_collectors_.clear();
+    staged_outputs_.clear();
+    reset_scratch();
+  }
+
+  void finalize(TRITONSERVER_Error* err) { complete(err, finalize_outputs()); }
+
+  /**
+   * @brief Return a stream for sending several responses to the request at
+   * the given index
+   *
+   * This may only be used by models with a decoupled transaction policy.
+   * Responses sent through the stream reach the client immediately. When
+   * the batch completes, any outputs obtained from the batch itself (e.g.
+   * with get_output) are sent as one more response, and the stream is then
+   * closed; if the batch failed, the error is sent through the stream
+   * instead.
+   */
+  auto& response_stream(std::size_t index)
+  {
+    if (index >= requests_.size()) {
+      throw TritonException(Error::Internal, "no request at given index");
+    }
+    check_graph_support("response streams");
+    if (streams_.empty()) { streams_.resize(requests_.size()); }
+    if (!streams_[index]) { streams_[index].emplace(requests_[index]); }
+    return *streams_[index];
+  }
+
+  /**
+   * @brief Fail only the request at the given index with the given error
+   *
+   * When the batch completes, the error is sent in response to this request
+   * alone; other requests receive their outputs as usual, and no result is
+   * cached for the failed request. An error for the batch as a whole still
+   * fails every request. If a request is failed more than once, the first
+   * error is reported. The batch keeps its own copy of the error, so `err`
+   * may still be thrown.
+   */
+  void fail_request(std::size_t index, TritonException const& err)
+  {
+    if (index >= requests_.size()) {
+      throw TritonException(Error::Internal, "no request at given index");
+    }
+    check_graph_support("request failures");
+    if (request_errors_.empty()) { request_errors_.resize(requests_.size(), nullptr); }
+    if (request_errors_[index] == nullptr) {
+      request_errors_[index] =
+        TRITONSERVER_ErrorNew(TRITONSERVER_ErrorCode(err.error()), err.what());
+    }
+    if (index < cache_keys_.size()) { cache_keys_[index].reset(); }
+  }
+
+  /** Whether the request at the given index has been failed individually */
+  auto request_failed(std::size_t index) const
+  {
+    return index < request_errors_.size() && request_errors_[index] != nullptr;
+  }
+
+ private:
+  std::vector<TRITONBACKEND_Request*> requests_;
+  std::vector<TRITONBACKEND_Response*> responses_;
+  output_shape_fetcher get_output_shape_;
+  statistics_reporter report_statistics_;
+  std::optional<BackendInputCollector> collector_;
+  std::shared_ptr<BackendOutputResponder> responder_;
+  TRITONBACKEND_MemoryManager* triton_mem_manager_;
+  bool use_pinned_input_;
+  bool use_pinned_output_;
+  size_type max_batch_size_;
+  cudaStream_t stream_;
+  // Streams on which inputs are collected and outputs copied into responses
+  cudaStream_t input_copy_stream_;
+  cudaStream_t output_copy_stream_;
+  // The output copies issued by finalize_outputs on a dedicated copy stream
+  std::optional<cuda_event> output_copies_;
+  // Timing events recorded on the batch's stream before and after predict,
+  // kept across reuse of the batch
+  std::optional<std::pair<cuda_event, cuda_event>> compute_events_;
+  bool device_timing_;
+  bool device_compute_timed_;
+  // The limit on device work in flight for this batch's model and the
+  // admission held by this batch under it, if any
+  predict_admission* admission_;
+  admission_ticket admission_ticket_;
+  // Whether the batch is predicted by the model's host path
+  bool host_dispatch_;
+  // The threads and streams used to gather inputs concurrently, if any
+  thread_pool* collection_pool_;
+  std::vector<pooled_stream> const* collection_streams_;
+  /* An input collector used for a single input gathered concurrently with
+   * others. Each has its own copy of the batch's responses, since a
+   * collector clears the response of any request it fails. */
+  struct concurrent_collector {
+    std::vector<TRITONBACKEND_Response*> responses{};
+    std::optional<BackendInputCollector> collector{};
+  };
+  std::vector<std::unique_ptr<concurrent_collector>> concurrent_collectors_;
+  // Outputs copied into pinned staging, with the stream of each copy and a
+  // function which sends the staged data through the responder
+  std::vector<std::pair<cudaStream_t, std::function<void()>>> staged_outputs_;
+  // Rows decompressed on the device, with the stream of each decompression,
+  // which are checked once it is complete
+  std::vector<std::pair<cudaStream_t, detail::pending_decompression>> pending_decompressions_;
+  std::chrono::time_point<std::chrono::steady_clock> start_time_;
+  std::chrono::time_point<std::chrono::steady_clock> compute_start_time_;
+  std::chrono::time_point<std::chrono::steady_clock> compute_end_time_;
+  std::optional<size_type> batch_size_;
+  std::vector<size_type> request_rows_;
+  std::size_t staged_input_bytes_;
+  batch_activity activity_;
+  bool has_response_outputs_;
+  // Whether predict wrote outputs into responses through get_response_output
+  bool has_segmented_outputs_;
+  std::vector<std::pair<MemoryType, int64_t>> allowed_memory_configs_;
+  std::vector<std::optional<ResponseStream>> streams_;
+
+  /* Location of output data to be copied into the result cache once the
+   * batch's work is complete: either one request's response buffer or, if
+   * request is empty, data for the whole batch to be divided by rows */
+  struct captured_output {
+    std::optional<std::size_t> request;
+    std::string name;
+    DType dtype;
+    std::vector<size_type> shape;
+    std::byte const* data;
+    MemoryType mem_type;
+    device_id_t device;
+  };
+
+  result_cache* cache_;
+  std::vector<std::optional<request_key>> cache_keys_;
+  std::vector<captured_output> captured_outputs_;
+  std::vector<std::shared_ptr<void>> capture_storage_;
+
+  /* A whole-batch input or output retrieved while processing a slice of the
+   * batch, of which each slice receives a view of its own rows */
+  struct sliced_tensor {
+    std::string name;
+    DType dtype;
+    std::shared_ptr<void> tensor;
+    void* data;
+    std::vector<size_type> shape;
+    MemoryType mem_type;
+    device_id_t device;
+    std::function<void()> finalize;
+  };
+
+  std::optional<row_range> slice_;
+  // Deques are used so that entries remain valid as more are added
+  std::deque<sliced_tensor> sliced_inputs_;
+  std::deque<sliced_tensor> sliced_outputs_;
+  // Arenas are not movable, so a deque is used to hold one per location
+  std::deque<scratch_arena> scratch_;
+
+  scratch_arena& get_scratch_arena(MemoryType memory_type, device_id_t device_id)
+  {
+    auto arena = std::find_if(std::begin(scratch_), std::end(scratch_), [&](auto const& entry) {
+      return entry.mem_type() == memory_type &&
+             (is_host_memory(memory_type) || entry.device() == device_id);
+    });
+    if (arena == std::end(scratch_)) { return scratch_.emplace_back(memory_type, device_id); }
+    return *arena;
+  }
+
+  /* Block until work on the given stream is complete, counting the wait */
+  void synchronize(cudaStream_t stream)
+  {
+    cuda_check(cudaStreamSynchronize(stream));
+    ++activity_.synchronizations;
+  }
+
+  /* Wait for each decompression on the device and check its rows,
+   * returning the error for the first malformed row, if any */
+  TRITONSERVER_Error* check_decompressions()
+  {
+    auto synchronized = std::vector<cudaStream_t>{};
+    try {
+      for (auto const& [decompression_stream, pending] : pending_decompressions_) {
+        if (std::find(std::begin(synchronized), std::end(synchronized), decompression_stream) ==
+            std::end(synchronized)) {
+          synchronize(decompression_stream);
+          synchronized.push_back(decompression_stream);
+        }
+        pending.check();
+      }
+    } catch (TritonException const& err) {
+      return err.error();
+    }
+    return nullptr;
+  }
+
+  void reset_scratch() noexcept
+  {
+    for (auto& arena : scratch_) {
+      arena.reset();
+    }
+  }
+
+  /* Delete and clear the given errors, any of which may be nullptr */
+  static void delete_errors(std::vector<TRITONSERVER_Error*>& errors) noexcept
+  {
+    for (auto* err : errors) {
+      if (err != nullptr) { TRITONSERVER_ErrorDelete(err); }
+    }
+    errors.clear();
+  }
+
+  /* Location and shape of an input tensor which has been passed to the
+   * input collector but for which the collector may not yet have been
+   * finalized */
+  struct pending_input {
+    std::vector<size_type> shape;
+    char const* raw_buffer;
+    std::size_t reported_bytes;
+    MemoryType reported_mem_type;
+    int64_t reported_device_id;
+    // Pinned storage from the batch's staging arena into which the input is
+    // gathered, or nullptr if the collector chooses where to gather it
+    char* staging;
+    // Device storage to which a staged input is copied once its collector
+    // is finalized, or nullptr if it is used from the staging storage
+    char* device_staging;
+    device_id_t staging_device;
+  };
+  // Inputs gathered by collector_ into pinned staging which are copied to
+  // the device when it is finalized
+  std::vector<pending_input*> staged_device_inputs_;
+
+  void clear_slices()
+  {
+    slice_.reset();
+    sliced_inputs_.clear();
+    sliced_outputs_.clear();
+  }
+
+  predict_graph* recording_;
+  predict_graph* graph_;
+  std::optional<size_type> padded_rows_;
+  // Errors for individually failed requests, indexed like requests_; empty
+  // if no request has failed alone
+  std::vector<TRITONSERVER_Error*> request_errors_;
+  // Requests removed from the batch by isolate_invalid_requests, with their
+  // responses and errors
+  std::vector<TRITONBACKEND_Request*> isolated_requests_;
+  std::vector<TRITONBACKEND_Response*> isolated_responses_;
+  std::vector<TRITONSERVER_Error*> isolated_errors_;
+  std::vector<input_spec> synthetic_inputs_;
+  std::optional<size_type> synthetic_rows_;
+  std::vector<std::shared_ptr<void const>> retained_;
+  transform_plan const* transforms_;
+  // The inputs sent compressed and the threads which decompress them on the
+  // host
+  compression_plan const* compression_;
+  thread_pool* decompression_pool_;
+  // The names of all outputs requested by the batch's requests, sorted
+  std::optional<std::vector<std::string>> requested_outputs_;
+
+  /* The location chosen for an output and the weight (in rows) of the
+   * requests which receive it there without the copy that host memory
+   * would have required */
+  struct output_placement_choice {
+    std::string name;
+    MemoryType mem_type;
+    std::size_t saved_weight;
+    std::size_t total_weight;
+  };
+  std::vector<output_placement_choice> output_placements_;
+  std::size_t saved_output_copy_bytes_;
+
+  /* A tensor passed from one stage of a composed model to the next without
+   * leaving the batch, whose data is null until a stage has produced it */
+  struct intermediate_tensor {
+    std::string name;
+    DType dtype;
+    void* data;
+    std::vector<size_type> shape;
+    MemoryType mem_type;
+    device_id_t device;
+    cudaStream_t stream;
+  };
+  std::vector<intermediate_tensor> intermediates_;
+
+  intermediate_tensor* find_intermediate(std::string const& name)
+  {
+    auto result = std::find_if(std::begin(intermediates_),
+                               std::end(intermediates_),
+                               [&name](auto const& entry) { return entry.name == name; });
+    return result == std::end(intermediates_) ? nullptr : &*result;
+  }
+
+  template <typename T>
+  OutputTensor<T> intermediate_output(intermediate_tensor& tensor,
+                                      std::vector<size_type>&& shape,
+                                      std::optional<MemoryType> const& memory_type,
+                                      device_id_t device_id,
+                                      cudaStream_t stream)
+  {
+    if (tensor.data != nullptr) {
+      throw TritonException(Error::Internal,
+                            "intermediate tensor " + tensor.name + " produced more than once");
+    }
+    auto mem_type = memory_type.value_or(HostMemory);
+    auto count    = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+    auto storage  = scratch<T>(count, mem_type, device_id, stream);
+    tensor.dtype    = TritonDtype<T>::value;
+    tensor.data     = storage.data();
+    tensor.shape    = shape;
+    tensor.mem_type = mem_type;
+    tensor.device   = device_id;
+    tensor.stream   = stream;
+    // No responder is set, so finalizing the tensor sends nothing
+    return OutputTensor<T>(
+      std::move(shape), Buffer<T>(storage.data(), count, mem_type, device_id, stream), tensor.name);
+  }
+
+  /* A view of an intermediate tensor in the location required by the stage
+   * consuming it, which is copied only if it was produced elsewhere */
+  template <typename T>
+  Tensor<T> intermediate_input(intermediate_tensor const& tensor,
+                               std::optional<MemoryType> const& memory_type,
+                               device_id_t device_id,
+                               cudaStream_t stream)
+  {
+    if (tensor.data == nullptr) {
+      throw TritonException(Error::Internal,
+                            "intermediate tensor " + tensor.name + " has not been produced");
+    }
+    if (tensor.dtype != TritonDtype<T>::value) {
+      auto log_stream = std::stringstream{};
+      log_stream << "intermediate tensor " << tensor.name << " was produced as type "
+                 << tensor.dtype << " but retrieved as type " << TritonDtype<T>::value;
+      throw TritonException(Error::Internal, log_stream.str());
+    }
+    if constexpr (IS_GPU_BUILD) {
+      if (tensor.stream != stream) {
+        auto ready = cuda_event{};
+        ready.record(tensor.stream);
+        ready.wait(stream);
+      }
+    }
+    if (!batch_size_.has_value()) {
+      batch_size_ = tensor.shape.empty() ? size_type{} : tensor.shape[0];
+    }
+    auto count  = std::reduce(
+      tensor.shape.begin(), tensor.shape.end(), std::size_t{1}, std::multiplies<>());
+    auto buffer =
+      Buffer<T>(static_cast<T*>(tensor.data), count, tensor.mem_type, tensor.device, stream);
+    if (memory_type && (!satisfies_memory_type(tensor.mem_type, *memory_type) ||
+                        (!is_host_memory(*memory_type) && tensor.device != device_id))) {
+      buffer = Buffer<T>(buffer, *memory_type, device_id);
+    }
+    return Tensor<T>(tensor.shape, std::move(buffer));
+  }
+
+  output_placement_choice const& get_output_placement(std::string const& name)
+  {
+    auto cached = std::find_if(std::begin(output_placements_),
+                               std::end(output_placements_),
+                               [&name](auto const& choice) { return choice.name == name; });
+    if (cached != std::end(output_placements_)) { return *cached; }
+    auto choice = output_placement_choice{name, HostMemory, std::size_t{}, std::size_t{}};
+    if constexpr (IS_GPU_BUILD) {
+      auto device_weight = std::size_t{};
+      auto host_weight   = std::size_t{};
+      for (auto i = std::size_t{}; i < requests_.size(); ++i) {
+        // Each request is weighted by its rows once these are known
+        auto weight    = (request_rows_.size() == requests_.size()) ? request_rows_[i] : 1;
+        auto placement = rapids::get_output_placement(requests_[i], name.c_str());
+        if (placement == DeviceMemory) {
+          device_weight += weight;
+        } else if (placement.has_value()) {
+          host_weight += weight;
+        }
+      }
+      choice.total_weight = device_weight + host_weight;
+      if (device_weight > host_weight) {
+        choice.mem_type     = DeviceMemory;
+        choice.saved_weight = device_weight - host_weight;
+      }
+    }
+    output_placements_.push_back(std::move(choice));
+    return output_placements_.back();
+  }
+
+  /* The number of rows in this batch's requests or synthetic inputs */
+  size_type triton_batch_rows() const
+  {
+    return synthetic_rows_.value_or(
+      get_triton_batch_rows(std::begin(requests_), std::end(requests_)));
+  }
+
+  /* The shape of the named synthetic input */
+  std::vector<size_type> synthetic_shape(std::string const& name) const
+  {
+    auto spec = std::find_if(std::begin(synthetic_inputs_),
+                             std::end(synthetic_inputs_),
+                             [&name](auto const& entry) { return entry.name == name; });
+    if (spec == std::end(synthetic_inputs_)) {
+      throw TritonException(Error::InvalidArg, "no synthetic input named " + name);
+    }
+    auto result = std::vector<size_type>{};
+    result.reserve(spec->shape.size());
+    for (auto dim : spec->shape) {
+      auto batch_dim = result.empty() && max_batch_size_ > 0;
+      result.push_back(batch_dim ? synthetic_rows_.value()
+                                 : (dim < 0 ? size_type{1} : static_cast<size_type>(dim)));
+    }
+    return result;
+  }
+
+  /* A zero-filled input of the named synthetic input's shape */
+  template <typename T>
+  Tensor<T> synthetic_input(std::string const& name,
+                            std::optional<MemoryType> const& memory_type,
+                            device_id_t device_id,
+                            cudaStream_t stream)
+  {
+    using value_type = std::remove_const_t<T>;
+    auto shape       = get_input_shape(name, TritonDtype<T>::value);
+    auto count    = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+    auto mem_type = memory_type.value_or(HostMemory);
+    auto storage  = scratch<value_type>(count, mem_type, device_id, stream);
+    if (mem_type == DeviceMemory) {
+      if constexpr (IS_GPU_BUILD) {
+        cuda_check(cudaMemsetAsync(storage.data(), 0, count * sizeof(value_type), stream));
+      }
+    } else {
+      std::fill(storage.data(), storage.data() + count, value_type{});
+    }
+    mark_compute_start();
+    return Tensor<T>(std::move(shape),
+                     Buffer<T>(storage.data(), count, mem_type, device_id, stream));
+  }
+
+  // Mark the retrieval of the latest input on the host and, if device time
+  // is measured, on the batch's stream
+  void mark_compute_start()
+  {
+    compute_start_time_ = std::chrono::steady_clock::now();
+    if (device_timing_ && compute_events_) { compute_events_->first.record(stream_); }
+  }
+
+  void check_synthetic_support(char const* feature) const
+  {
+    if (synthetic_rows_) {
+      throw TritonException(Error::Unsupported,
+                            std::string{feature} + " cannot be used in synthetic batches");
+    }
+  }
+
+  /* Allocate an output of the given shape which is sent as it was written */
+  template <typename T>
+  OutputTensor<T> make_output(std::string const& name,
+                              std::vector<size_type> shape,
+                              std::optional<MemoryType> const& memory_type,
+                              device_id_t device_id,
+                              cudaStream_t stream)
+  {
+    if (recording_) { record_graph_output<T>(name, shape, memory_type, device_id); }
+    // Outputs of padded batches are delivered without their padding rows
+    auto padded = padded_rows_.has_value() && batch_size_.has_value() && !shape.empty() &&
+                  shape[0] == padded_rows_.value() && shape[0] != batch_size_.value();
+    auto sent_shape = shape;
+    if (padded) { sent_shape[0] = batch_size_.value(); }
+    if (requests_.size() > 1 && (!batch_size_.has_value() || sent_shape.empty() ||
+                                 sent_shape[0] != batch_size_.value())) {
+      throw TritonException(Error::Internal,
+                            "outputs for several requests must have the batch size as their "
+                            "first dimension");
+    }
+    auto buffer_size = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+
+    auto range = nvtx_range{"get_output ", name, ": ", buffer_size * sizeof(T), " bytes"};
+
+    auto final_memory_type = MemoryType{};
+    if (memory_type.has_value()) {
+      final_memory_type = memory_type.value();
+    } else {
+      // If consumer doesn't care, place the output where most responses
+      // want it to avoid additional copies
+      auto const& placement = get_output_placement(name);
+      final_memory_type     = placement.mem_type;
+      saved_output_copy_bytes_ +=
+        std::reduce(sent_shape.begin(), sent_shape.end(), std::size_t{1}, std::multiplies<>()) *
+        sizeof(T) * placement.saved_weight / std::max(placement.total_weight, std::size_t{1});
+    }
+    activity_.add_output(final_memory_type, buffer_size * sizeof(T));
+
+    // Outputs of synthetic batches have no response to be sent to
+    if (synthetic_rows_) {
+      return OutputTensor<T>(
+        std::move(shape), Buffer<T>(buffer_size, final_memory_type, device_id, stream), name);
+    }
+
+    // With a single request, the output can be written into (or copied
+    // directly to) the response's own buffer without a responder
+    if (requests_.size() == 1) {
+      auto response_buffer =
+        response_output_buffer<T>(0, name, sent_shape, final_memory_type, device_id);
+      has_response_outputs_ = true;
+      if (!padded && satisfies_memory_type(response_buffer.mem_type(), final_memory_type) &&
+          (is_host_memory(final_memory_type) || response_buffer.device() == device_id)) {
+        auto buffer = Buffer<T>(response_buffer.data(),
+                                response_buffer.size(),
+                                response_buffer.mem_type(),
+                                response_buffer.device(),
+                                stream);
+        return OutputTensor<T>(std::move(shape),
+                               std::move(buffer),
+                               name,
+                               std::move(response_buffer),
+                               output_copy_stream_);
+      } else {
+        auto buffer = Buffer<T>(buffer_size, final_memory_type, device_id, stream);
+        return trim_padding(OutputTensor<T>(std::move(shape),
+                                            std::move(buffer),
+                                            name,
+                                            std::move(response_buffer),
+                                            output_copy_stream_),
+                            padded);
+      }
+    }
+
+    if (cache_ != nullptr) {
+      // Keep the batch-wide data alive until the batch completes so that
+      // each request's rows can be cached
+      auto storage = std::make_shared<Buffer<T>>(buffer_size, final_memory_type, device_id, stream);
+      capture_output(
+        std::nullopt, name, TritonDtype<T>::value, sent_shape, storage->data(), *storage);
+      capture_storage_.push_back(storage);
+      auto buffer = Buffer<T>(storage->data(), buffer_size, final_memory_type, device_id, stream);
+      return trim_padding(
+        OutputTensor<T>(
+          std::move(shape), std::move(buffer), name, responder(), output_copy_stream_),
+        padded);
+    }
+
+    if (IS_GPU_BUILD && use_pinned_output_ && final_memory_type == DeviceMemory &&
+        is_host_memory(get_output_placement(name).mem_type)) {
+      return staged_output<T>(name, std::move(shape), std::move(sent_shape), device_id, stream);
+    }
+
+    auto buffer = Buffer<T>(buffer_size, final_memory_type, device_id, stream);
+    return trim_padding(
+      OutputTensor<T>(std::move(shape), std::move(buffer), name, responder(), output_copy_stream_),
+      padded);
+  }
+
+  /* Allocate a device output which most responses want on the host. On
+   * finalization, its sent rows are copied once into the batch's pinned
+   * staging arena, from which the responder sends them once the copy is
+   * complete, so that the responder needs no pinned staging of its own. */
+  template <typename T>
+  OutputTensor<T> staged_output(std::string const& name,
+                                std::vector<size_type> shape,
+                                std::vector<size_type> sent_shape,
+                                device_id_t device_id,
+                                cudaStream_t stream)
+  {
+    auto count  = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+    auto buffer = Buffer<T>(count, DeviceMemory, device_id, stream);
+    auto data   = buffer.data();
+    auto deliver = [this, name, sent_shape, data, device_id, stream]() {
+      auto sent_count =
+        std::reduce(sent_shape.begin(), sent_shape.end(), std::size_t{1}, std::multiplies<>());
+      auto staging = scratch<T>(sent_count, PinnedMemory, 0, stream);
+      rapids::copy(staging, Buffer<T>(data, sent_count, DeviceMemory, device_id, stream));
+      auto triton_shape = std::vector<std::int64_t>{};
+      triton_shape.reserve(sent_shape.size());
+      std::transform(std::begin(sent_shape),
+                     std::end(sent_shape),
+                     std::back_inserter(triton_shape),
+                     [](auto dim) { return narrow<std::int64_t>(dim); });
+      staged_outputs_.emplace_back(
+        stream, [this, name, triton_shape = std::move(triton_shape), staged = staging.data()]() {
+          responder()->ProcessTensor(name.c_str(),
+                                     TritonDtype<T>::value,
+                                     triton_shape,
+                                     reinterpret_cast<char*>(staged),
+                                     PinnedMemory,
+                                     0);
+        });
+    };
+    return OutputTensor<T>(std::move(shape), std::move(buffer), name, std::move(deliver));
+  }
+
+  /* Allocate an output in scratch storage whose post-processing stages are
+   * applied as it is finalized. All but the last stage are applied in place,
+   * and the last (with any cast) writes directly into the output sent. */
+  template <typename T>
+  OutputTensor<T> transformed_output(std::string const& name,
+                                     std::vector<size_type> shape,
+                                     transform_stages const& stages,
+                                     std::optional<MemoryType> const& memory_type,
+                                     device_id_t device_id,
+                                     cudaStream_t stream)
+  {
+    if constexpr (!is_transformable<T>()) {
+      throw TritonException(Error::InvalidArg,
+                            "transform stages require a floating-point output but " + name +
+                              " is not");
+    } else {
+      stop_graph_recording();
+      auto mem_type = memory_type.has_value() ? memory_type.value() : output_placement(name);
+      auto count    = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+      auto storage  = scratch<T>(count, mem_type, device_id, stream);
+      auto data     = storage.data();
+      auto deliver  = [this, name, shape, &stages, mem_type, device_id, stream, data, count]() {
+        auto computed = Tensor<T>(shape, Buffer<T>(data, count, mem_type, device_id, stream));
+        auto range = nvtx_range{"transform output ", name, ": ", computed.size(), " elements"};
+        auto last  = stages.back().op;
+        auto cast  = last == transform_op::fp16 || last == transform_op::fp32;
+        auto applied = stages.size() - (cast ? 1 : 0);
+        for (auto i = std::size_t{1}; i < applied; ++i) {
+          apply_output_stage(stages[i - 1], computed, computed);
+        }
+        auto send = [&](auto* type_tag) {
+          using sent_type = std::remove_pointer_t<decltype(type_tag)>;
+          auto sent       = make_output<sent_type>(name, shape, mem_type, device_id, stream);
+          if (applied == 0) {
+            detail::convert(sent.data(), computed.data(), computed.size(), stream, mem_type);
+          } else {
+            apply_output_stage(stages[applied - 1], sent, computed);
+          }
+          sent.finalize();
+        };
+        if (!cast) {
+          send(static_cast<T*>(nullptr));
+        } else if (last == transform_op::fp16) {
+          send(static_cast<__half*>(nullptr));
+        } else {
+          send(static_cast<float*>(nullptr));
+        }
+      };
+      return OutputTensor<T>(std::move(shape),
+                             Buffer<T>(data, count, mem_type, device_id, stream),
+                             name,
+                             std::move(deliver));
+    }
+  }
+
+  template <typename T>
+  static constexpr bool is_transformable()
+  {
+    using value_type = std::remove_const_t<T>;
+    return std::is_floating_point_v<value_type> || std::is_same_v<value_type, __half>;
+  }
+
+  /* Scratch storage in the given location holding the given values */
+  template <typename T>
+  auto scratch_values(std::vector<T> const& values,
+                      MemoryType memory_type,
+                      device_id_t device_id,
+                      cudaStream_t stream)
+  {
+    auto host_values = scratch<T>(values.size(), HostMemory, 0, stream);
+    std::copy(std::begin(values), std::end(values), host_values.data());
+    if (is_host_memory(memory_type)) { return host_values; }
+    auto result = scratch<T>(values.size(), memory_type, device_id, stream);
+    copy(result, host_values);
+    return result;
+  }
+
+  /* The compression of the named input, or nullptr if it is sent
+   * uncompressed */
+  compressed_input const* compressed(std::string const& name) const
+  {
+    return (compression_ == nullptr) ? nullptr : compression_->input(name);
+  }
+
+  /* Gather the compressed rows of an input from all requests on the host
+   * and decompress them into a tensor of rows in the required location */
+  template <typename T>
+  Tensor<T> decompressed_input(std::string const& name,
+                               compressed_input const& compression,
+                               std::optional<MemoryType> const& memory_type,
+                               device_id_t device_id,
+                               cudaStream_t stream)
+  {
+    using value_type = std::remove_const_t<T>;
+    check_graph_support("compressed inputs");
+    auto shape = get_input_shape(name, TritonDtype<T>::value);
+    auto count = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+    auto rows  = count / compression.row_elements;
+
+    auto input      = pending_input{};
+    auto size_bytes = get_triton_input_byte_size(std::begin(requests_), std::end(requests_), name);
+    auto range      = nvtx_range{"get compressed input ", name, ": ", size_bytes, " bytes"};
+    collect_raw_input(input, name, size_bytes, HostMemory, 0);
+    finalize_inputs();
+    auto compressed_rows = parse_serialized_strings(
+      std::vector<size_type>{rows}, input.raw_buffer, input.reported_bytes, stream);
+
+    // Without nvCOMP, rows are decompressed on the host and then copied
+    auto constexpr device_decompression = IS_GPU_BUILD && detail::device_decompression_available;
+    auto mem_type =
+      (device_decompression && memory_type == DeviceMemory) ? DeviceMemory : HostMemory;
+    auto storage = scratch<value_type>(count, mem_type, device_id, stream);
+    auto bytes   = Buffer<std::byte>(reinterpret_cast<std::byte*>(storage.data()),
+                                     count * sizeof(value_type),
+                                     mem_type,
+                                     device_id,
+                                     stream);
+    auto row_bytes = compression.row_elements * sizeof(value_type);
+    if (mem_type == DeviceMemory) {
+      // Metadata and temporary storage come from scratch, and the rows are
+      // checked when the batch completes rather than by waiting here
+      auto sizes =
+        detail::device_decompression_storage(compression.codec, row_bytes, compressed_rows);
+      auto host_storage   = scratch<std::byte>(sizes.host_bytes, PinnedMemory, 0, stream);
+      auto device_storage = scratch<std::byte>(sizes.device_bytes, DeviceMemory, device_id, stream);
+      auto pending        = detail::device_decompress_rows(compression.codec,
+                                                           bytes.data(),
+                                                           row_bytes,
+                                                           compressed_rows,
+                                                           host_storage,
+                                                           device_storage,
+                                                           stream);
+      pending_decompressions_.emplace_back(stream, pending);
+    } else {
+      decompress_rows(bytes, compressed_rows, compression.codec, row_bytes, decompression_pool_);
+    }
+    auto buffer = Buffer<T>(storage.data(), count, mem_type, device_id, stream);
+    if (memory_type && !satisfies_memory_type(mem_type, *memory_type)) {
+      buffer = Buffer<T>(buffer, *memory_type, device_id);
+    }
+    mark_compute_start();
+    return Tensor<T>(std::move(shape), std::move(buffer));
+  }
+
+  /* Apply the pre-processing stages of the named input, if it has any. A
+   * leading column reordering takes one pass, and all scale and offset
+   * stages after it are fused into a second. */
+  template <typename T>
+  Tensor<T> transform_input(std::string const& name, Tensor<T>&& input, cudaStream_t stream)
+  {
+    auto const* stages = (transforms_ == nullptr) ? nullptr : transforms_->input_stages(name);
+    if (stages == nullptr) { return std::move(input); }
+    if constexpr (!is_transformable<T>()) {
+      throw TritonException(Error::InvalidArg,
+                            "transform stages require a floating-point input but " + name +
+                              " is not");
+    } else {
+      using value_type = std::remove_const_t<T>;
+      stop_graph_recording();
+      auto range     = nvtx_range{"transform input ", name, ": ", input.size(), " elements"};
+      auto cols      = detail::transform_cols(input);
+      auto mem_type  = input.mem_type();
+      auto device_id = input.device();
+      auto storage   = scratch<value_type>(input.size(), mem_type, device_id, stream);
+      auto result    = Tensor<value_type>(
+        input.shape(),
+        Buffer<value_type>(storage.data(), storage.size(), mem_type, device_id, stream));
+
+      auto stage     = std::begin(*stages);
+      auto reordered = stage->op == transform_op::columns;
+      if (reordered) {
+        auto columns = std::vector<std::int64_t>(std::begin(stage->args), std::end(stage->args));
+        auto valid   = columns.size() == cols &&
+                     std::all_of(std::begin(columns), std::end(columns), [cols](auto column) {
+                       return static_cast<std::size_t>(column) < cols;
+                     });
+        if (!valid) {
+          throw TritonException(Error::InvalidArg,
+                                "columns stage of input " + name +
+                                  " must give one index for each of its " +
+                                  std::to_string(cols) + " columns");
+        }
+        select_columns(result, input, scratch_values(columns, mem_type, device_id, stream));
+        ++stage;
+      }
+
+      if (stage != std::end(*stages)) {
+        // x -> a * x + b is applied as (x - mean) / scale
+        auto a = 1.0;
+        auto b = 0.0;
+        for (; stage != std::end(*stages); ++stage) {
+          if (stage->op == transform_op::scale) {
+            a *= stage->args[0];
+            b *= stage->args[0];
+          } else {
+            b += stage->args[0];
+          }
+        }
+        using param_t = detail::transform_t<value_type>;
+        auto mean     = scratch_values(
+          std::vector<param_t>(cols, static_cast<param_t>(-b / a)), mem_type, device_id, stream);
+        auto scale = scratch_values(
+          std::vector<param_t>(cols, static_cast<param_t>(1.0 / a)), mem_type, device_id, stream);
+        if (reordered) {
+          standardize(result, result, mean, scale);
+        } else {
+          standardize(result, input, mean, scale);
+        }
+      }
+      return Tensor<T>(result.shape(),
+                       Buffer<T>(storage.data(), storage.size(), mem_type, device_id, stream));
+    }
+  }
+
+  template <typename U, typename T>
+  static void apply_output_stage(transform_stage const& stage,
+                                 BaseTensor<U>& dst,
+                                 BaseTensor<T> const& src)
+  {
+    switch (stage.op) {
+      case transform_op::sigmoid: sigmoid(dst, src); break;
+      case transform_op::softmax: softmax(dst, src); break;
+      case transform_op::threshold:
+        threshold(dst, src, static_cast<detail::transform_t<T>>(stage.args[0]));
+        break;
+      default: throw TritonException(Error::Internal, "bad output transform stage");
+    }
+  }
+
+  /* Write a collected input in column-major order into scratch storage
+   * padded to the batch's bucket, with zeros in its padding rows */
+  template <typename T>
+  Tensor<T> transpose_input(Tensor<T>&& input, cudaStream_t stream)
+  {
+    auto shape = input.shape();
+    // Tensors of a single column are stored identically in either layout
+    if (shape.size() < 2 || input.size() == shape[0]) {
+      return pad_input(std::move(input), stream);
+    }
+    if (padded_rows_.has_value() && batch_size_.has_value() && shape[0] == batch_size_.value()) {
+      shape[0] = std::max(shape[0], padded_rows_.value());
+    }
+    using value_type = std::remove_const_t<T>;
+    auto count = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+    auto storage = scratch<value_type>(count, input.mem_type(), input.device(), stream);
+    auto result  = Tensor<value_type>(
+      shape,
+      Buffer<value_type>(storage.data(), count, input.mem_type(), input.device(), stream));
+    transpose(result, input);
+    return Tensor<T>(std::move(shape),
+                     Buffer<T>(storage.data(), count, input.mem_type(), input.device(), stream));
+  }
+
+  /* Copy a collected input into scratch storage padded to the batch's
+   * bucket, with zeros in its padding rows */
+  template <typename T>
+  Tensor<T> pad_input(Tensor<T>&& input, cudaStream_t stream)
+  {
+    auto const& shape = input.shape();
+    if (!padded_rows_.has_value() || shape.empty() || !batch_size_.has_value() ||
+        shape[0] != batch_size_.value() || shape[0] == padded_rows_.value()) {
+      return std::move(input);
+    }
+    using value_type  = std::remove_const_t<T>;
+    auto padded_shape = shape;
+    padded_shape[0]   = padded_rows_.value();
+    auto count = std::reduce(
+      padded_shape.begin(), padded_shape.end(), std::size_t{1}, std::multiplies<>());
+    auto storage = scratch<value_type>(count, input.mem_type(), input.device(), stream);
+    copy(storage, input.buffer());
+    auto padding = (count - input.size()) * sizeof(value_type);
+    if (input.mem_type() == DeviceMemory) {
+      if constexpr (IS_GPU_BUILD) {
+        cuda_check(cudaMemsetAsync(storage.data() + input.size(), 0, padding, stream));
+      }
+    } else {
+      std::fill(storage.data() + input.size(), storage.data() + count, value_type{});
+    }
+    return Tensor<T>(std::move(padded_shape),
+                     Buffer<T>(storage.data(), count, input.mem_type(), input.device(), stream));
+  }
+
+  template <typename T>
+  OutputTensor<T> trim_padding(OutputTensor<T>&& output, bool padded) const
+  {
+    if (padded) { output.trim_rows(batch_size_.value()); }
+    return std::move(output);
+  }
+
+  /* Reject a feature which cannot be captured in a predict graph, or stop
+   * recording if a graph is being recorded */
+  void check_graph_support(char const* feature)
+  {
+    if (graph_ != nullptr) {
+      throw TritonException(Error::Unsupported,
+                            std::string{feature} + " cannot be used in graph-captured predict");
+    }
+    stop_graph_recording();
+  }
+
+  void stop_graph_recording() noexcept
+  {
+    if (recording_ != nullptr) {
+      recording_->disable();
+      recording_ = nullptr;
+    }
+  }
+
+  template <typename T>
+  void record_graph_input(std::string const& name,
+                          std::vector<size_type> const& shape,
+                          std::optional<MemoryType> const& memory_type,
+                          device_id_t device_id)
+  {
+    if (recording_->find_input(name, TritonDtype<T>::value) != nullptr) { return; }
+    if ((memory_type.has_value() && memory_type.value() != DeviceMemory) || shape.empty()) {
+      stop_graph_recording();
+      return;
+    }
+    auto padded = shape;
+    padded[0]   = recording_->rows();
+    recording_->inputs().push_back(
+      graph_tensor{name,
+                   TritonDtype<T>::value,
+                   padded,
+                   DeviceMemory,
+                   device_id,
+                   Buffer<std::byte>(graph_bytes<T>(padded), DeviceMemory, device_id, stream_),
+                   [](Batch& batch, graph_tensor& tensor) { batch.fill_graph_input<T>(tensor); }});
+  }
+
+  template <typename T>
+  void record_graph_output(std::string const& name,
+                           std::vector<size_type> const& shape,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id)
+  {
+    if (recording_->find_output(name, TritonDtype<T>::value) != nullptr) { return; }
+    if (shape.empty() || !batch_size_.has_value() || shape[0] != batch_size_.value()) {
+      stop_graph_recording();
+      return;
+    }
+    auto padded = shape;
+    padded[0]   = recording_->rows();
+    recording_->outputs().push_back(
+      graph_tensor{name,
+                   TritonDtype<T>::value,
+                   padded,
+                   memory_type,
+                   device_id,
+                   Buffer<std::byte>(graph_bytes<T>(padded), DeviceMemory, device_id, stream_),
+                   [](Batch& batch, graph_tensor& tensor) { batch.emit_graph_output<T>(tensor); }});
+  }
+
+  template <typename T>
+  static std::size_t graph_bytes(std::vector<size_type> const& shape)
+  {
+    return sizeof(T) * std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>());
+  }
+
+  template <typename T>
+  auto graph_view(graph_tensor& tensor, cudaStream_t stream)
+  {
+    return Buffer<T>(reinterpret_cast<T*>(tensor.storage.data()),
+                     tensor.storage.size() / sizeof(T),
+                     DeviceMemory,
+                     tensor.device,
+                     stream);
+  }
+
+  template <typename T>
+  Tensor<T> graph_input(std::string const& name, cudaStream_t stream)
+  {
+    auto* tensor = graph_->find_input(name, TritonDtype<T>::value);
+    if (tensor == nullptr) {
+      throw TritonException(Error::Internal,
+                            "input " + name + " was not requested when predict was recorded");
+    }
+    return Tensor<T>(std::vector<size_type>(tensor->shape), graph_view<T>(*tensor, stream));
+  }
+
+  template <typename T>
+  OutputTensor<T> graph_output(std::string const& name,
+                               std::vector<size_type>&& shape,
+                               cudaStream_t stream)
+  {
+    auto* tensor = graph_->find_output(name, TritonDtype<T>::value);
+    if (tensor == nullptr || tensor->shape != shape) {
+      throw TritonException(Error::Internal,
+                            "output " + name + " does not match the output recorded for predict");
+    }
+    return OutputTensor<T>(std::move(shape), graph_view<T>(*tensor, stream), name);
+  }
+
+  /* Collect the batch's rows of an input into the graph's storage */
+  template <typename T>
+  void fill_graph_input(graph_tensor& tensor)
+  {
+    auto input   = get_input<T>(tensor.name, DeviceMemory, tensor.device, stream_);
+    auto storage = graph_view<std::remove_const_t<T>>(tensor, stream_);
+    copy(storage, input.buffer());
+  }
+
+  /* Copy the batch's rows of an output from the graph's storage into the
+   * responses */
+  template <typename T>
+  void emit_graph_output(graph_tensor& tensor)
+  {
+    auto shape = tensor.shape;
+    shape[0]   = batch_size_.value();
+    auto output =
+      get_output<T>(tensor.name, std::move(shape), tensor.mem_type, tensor.device, stream_);
+    auto storage = graph_view<T>(tensor, stream_);
+    copy(output.buffer(), storage, 0, output.size());
+    output.finalize();
+  }
+
+  /* Whether this batch's inputs fit the storage recorded for a graph */
+  bool graph_inputs_match(predict_graph& graph)
+  {
+    return std::all_of(
+      std::begin(graph.inputs()), std::end(graph.inputs()), [this, &graph](auto& input) {
+        auto shape = get_input_shape(input.name, input.dtype);
+        return shape.size() == input.shape.size() && !shape.empty() && shape[0] <= graph.rows() &&
+               std::equal(std::next(shape.begin()), shape.end(), std::next(input.shape.begin()));
+      });
+  }
+
+  /* Capture the work enqueued by fn into the given graph, returning false if
+   * it could not be captured */
+  template <typename F>
+  bool capture_graph(predict_graph& graph, F& fn)
+  {
+    auto failure = std::string{};
+    if constexpr (IS_GPU_BUILD) {
+      cuda_check(cudaStreamBeginCapture(stream_, cudaStreamCaptureModeThreadLocal));
+      try {
+        fn(*this);
+      } catch (std::exception const& err) {
+        failure = err.what();
+      }
+      auto captured = cudaGraph_t{};
+      auto status   = cudaStreamEndCapture(stream_, &captured);
+      if (failure.empty() && status != cudaSuccess) { failure = cudaGetErrorString(status); }
+      if (failure.empty()) {
+        try {
+          graph.instantiate(captured);
+        } catch (TritonException const& err) {
+          failure = err.what();
+        }
+      }
+      if (captured != cudaGraph_t{}) { cudaGraphDestroy(captured); }
+    } else {
+      failure = "CUDA graphs require a GPU build";
+    }
+    if (!failure.empty()) {
+      cudaGetLastError();
+      log_warn(__FILE__, __LINE__) << "Predict could not be captured for batches of "
+                                   << graph.rows() << " rows and will not use a graph: "
+                                   << failure;
+    }
+    return failure.empty();
+  }
+
+  [[noreturn]] static void unsupported_in_slice(char const* feature)
+  {
+    throw TritonException(Error::Unsupported,
+                          std::string{feature} + " cannot be used when predicting by row slices");
+  }
+
+  /* Return the stored whole-batch tensor with the given name, or retrieve it
+   * with `get` (with slicing suspended) and store it */
+  template <typename TensorType, typename Get>
+  auto& whole_batch_tensor(std::deque<sliced_tensor>& tensors,
+                           std::string const& name,
+                           DType dtype,
+                           Get&& get)
+  {
+    auto found = std::find_if(std::begin(tensors), std::end(tensors), [&name](auto& entry) {
+      return entry.name == name;
+    });
+    if (found != std::end(tensors)) {
+      if (found->dtype != dtype) {
+        throw TritonException(Error::Internal,
+                              "tensor " + name + " retrieved with different types in one batch");
+      }
+      return *found;
+    }
+    auto slice  = std::exchange(slice_, std::nullopt);
+    auto tensor = std::shared_ptr<TensorType>{};
+    try {
+      tensor = std::make_shared<TensorType>(get());
+    } catch (...) {
+      slice_ = slice;
+      throw;
+    }
+    slice_ = slice;
+    if (tensor->shape().empty() || tensor->shape()[0] != batch_size_.value_or(size_type{})) {
+      throw TritonException(Error::Internal,
+                            "tensor " + name + " does not have the batch size as its first "
+                            "dimension");
+    }
+    auto* data = const_cast<void*>(static_cast<void const*>(tensor->data()));
+    tensors.push_back(sliced_tensor{
+      name, dtype, tensor, data, tensor->shape(), tensor->mem_type(), tensor->device(), {}});
+    return tensors.back();
+  }
+
+  template <typename T, typename Get>
+  auto& whole_batch_input(std::string const& name, Get&& get)
+  {
+    return whole_batch_tensor<Tensor<T>>(sliced_inputs_, name, TritonDtype<T>::value, get);
+  }
+
+  auto has_whole_batch_input(std::string const& name) const
+  {
+    return std::any_of(std::begin(sliced_inputs_),
+                       std::end(sliced_inputs_),
+                       [&name](auto& entry) { return entry.name == name; });
+  }
+
+  template <typename T>
+  void store_whole_batch_input(std::string const& name, Tensor<T>&& input)
+  {
+    if (!has_whole_batch_input(name)) {
+      whole_batch_input<T>(name, [&input]() { return std::move(input); });
+    }
+  }
+
+  template <typename T, typename Get>
+  auto& whole_batch_output(std::string const& name, Get&& get)
+  {
+    auto& result = whole_batch_tensor<OutputTensor<T>>(
+      sliced_outputs_, name, TritonDtype<T>::value, get);
+    if (!result.finalize) {
+      result.finalize = [tensor = std::static_pointer_cast<OutputTensor<T>>(result.tensor)]() {
+        tensor->finalize();
+      };
+    }
+    return result;
+  }
+
+  /* Shape of the current slice's rows of a whole-batch tensor */
+  auto slice_shape(sliced_tensor const& tensor) const
+  {
+    auto result = tensor.shape;
+    result[0]   = slice_->count;
+    return result;
+  }
+
+  /* Non-owning buffer holding the current slice's rows of a whole-batch
+   * tensor */
+  template <typename T>
+  auto slice_buffer(sliced_tensor const& tensor, cudaStream_t stream) const
+  {
+    auto row_size = std::reduce(
+      tensor.shape.begin() + 1, tensor.shape.end(), size_type{1}, std::multiplies<>());
+    return Buffer<T>(static_cast<T*>(tensor.data) + slice_->first * row_size,
+                     slice_->count * row_size,
+                     tensor.mem_type,
+                     tensor.device,
+                     stream);
+  }
+
+  BackendInputCollector& collector()
+  {
+    if (!collector_) {
+      collector_.emplace(requests_.data(),
+                         narrow<request_size_t>(requests_.size()),
+                         &responses_,
+                         triton_mem_manager_,
+                         use_pinned_input_,
+                         input_copy_stream_);
+    }
+    return *collector_;
+  }
+
+  auto& responder()
+  {
+    if (!responder_) {
+      auto count = narrow<request_size_t>(requests_.size());
+      responder_ = std::make_shared<BackendOutputResponder>(requests_.data(),
+                                                            count,
+                                                            &responses_,
+                                                            max_batch_size_,
+                                                            triton_mem_manager_,
+                                                            use_pinned_output_,
+                                                            output_copy_stream_);
+    }
+    return responder_;
+  }
+
+  /* For a batch with a single request, use the request's input buffer
+   * directly if it is contiguous and already in an acceptable location.
+   * Device buffers are only acceptable on the requested device. Returns
+   * false if the input collector must be used instead. */
+  bool process_single_input(pending_input& input,
+                            std::string const& name,
+                            std::size_t size_bytes,
+                            std::optional<MemoryType> const& memory_type,
+                            device_id_t device_id)
+  {
+    auto* triton_input = get_triton_input(requests_[0], name);
+    auto buffer_count  = uint32_t{};
+    triton_check(TRITONBACKEND_InputProperties(
+      triton_input, nullptr, nullptr, nullptr, nullptr, nullptr, &buffer_count));
+    auto result = false;
+    if (buffer_count == 1) {
+      auto const* buffer     = static_cast<void const*>(nullptr);
+      auto byte_size         = uint64_t{};
+      auto reported_mem_type = memory_type.value_or(HostMemory);
+      auto reported_device   = int64_t{};
+      triton_check(TRITONBACKEND_InputBuffer(
+        triton_input, 0, &buffer, &byte_size, &reported_mem_type, &reported_device));
+      auto acceptable_location = memory_type.has_value()
+                                   ? satisfies_memory_type(reported_mem_type, memory_type.value())
+                                   : (IS_GPU_BUILD || is_host_memory(reported_mem_type));
+      acceptable_location =
+        acceptable_location && (is_host_memory(reported_mem_type) || reported_device == device_id);
+      if (acceptable_location && byte_size == size_bytes) {
+        input.raw_buffer         = static_cast<char const*>(buffer);
+        input.reported_bytes     = byte_size;
+        input.reported_mem_type  = reported_mem_type;
+        input.reported_device_id = reported_device;
+        result                   = true;
+      }
+    }
+    return result;
+  }
+
+  /* Finish a request whose responses were sent through a ResponseStream.
+   * The batch's own response for that request is sent only if it carries
+   * outputs, and the stream then sends Triton's final flag. */
+  void finish_stream(std::size_t index, TRITONSERVER_Error* err)
+  {
+    auto& stream     = *streams_[index];
+    auto* response   = std::exchange(responses_[index], nullptr);
+    auto has_outputs = has_response_outputs_ || responder_ != nullptr;
+    try {
+      if (stream.closed()) {
+        if (err != nullptr || has_outputs) {
+          log_error(__FILE__, __LINE__) << "Response stream closed before batch completed";
+        }
+      } else if (err != nullptr) {
+        stream.send_error(err);
+      } else {
+        stream.send();
+        if (has_outputs) {
+          send_response(response, 0, nullptr);
+          response = nullptr;
+        }
+        stream.close();
+      }
+    } catch (TritonException const& stream_err) {
+      log_error(__FILE__, __LINE__, stream_err.what());
+    }
+    if (response != nullptr) { TRITONBACKEND_ResponseDelete(response); }
+  }
+
+  /* Return the shape formed by concatenating the given segments along their
+   * first dimension, or their flattened total size if they cannot be
+   * concatenated */
+  template <typename T>
+  static auto concatenated_shape(std::vector<TensorView<T>> const& segments)
+  {
+    auto result         = segments.empty() ? std::vector<size_type>{} : segments[0].shape();
+    auto total_size     = size_type{};
+    auto concatenatable = !result.empty();
+    for (auto i = std::size_t{}; i < segments.size(); ++i) {
+      auto const& shape = segments[i].shape();
+      total_size += segments[i].size();
+      if (i != 0) {
+        concatenatable = concatenatable && shape.size() == result.size() &&
+                         std::equal(shape.begin() + 1, shape.end(), result.begin() + 1);
+        if (concatenatable) { result[0] += shape[0]; }
+      }
+    }
+    if (!concatenatable) { result = std::vector<size_type>{total_size}; }
+    return result;
+  }
+
+  /* Obtain the final output buffer for the given output of a single
+   * response as a non-owning Buffer */
+  template <typename T>
+  auto response_output_buffer(std::size_t response_index,
+                              std::string const& name,
+                              std::vector<size_type> const& shape,
+                              MemoryType memory_type,
+                              device_id_t device_id)
+  {
+    auto result = get_response_buffer<T>(
+      responses_[response_index], name, shape, memory_type, device_id, stream_);
+    if (cache_ != nullptr) {
+      capture_output(response_index, name, TritonDtype<T>::value, shape, result.data(), result);
+    }
+    return result;
+  }
+
+  template <typename T>
+  void capture_output(std::optional<std::size_t> request,
+                      std::string const& name,
+                      DType dtype,
+                      std::vector<size_type> const& shape,
+                      T const* data,
+                      Buffer<T> const& location)
+  {
+    captured_outputs_.push_back(captured_output{request,
+                                                name,
+                                                dtype,
+                                                shape,
+                                                reinterpret_cast<std::byte const*>(data),
+                                                location.mem_type(),
+                                                location.device()});
+  }
+
+  void clear_capture()
+  {
+    captured_outputs_.clear();
+    capture_storage_.clear();
+  }
+
+  /* Copy each cacheable request's outputs to host memory and insert them into
+   * the result cache. Must be called after the batch's work is complete. */
+  void store_results()
+  {
+    if (captured_outputs_.empty()) { return; }
+    auto range       = nvtx_range{"cache results: ", requests_.size(), " requests"};
+    auto results     = std::vector<cached_result>(requests_.size());
+    auto row_offsets = std::vector<size_type>(request_rows_.size());
+    std::exclusive_scan(
+      std::begin(request_rows_), std::end(request_rows_), std::begin(row_offsets), size_type{});
+
+    auto add_output = [this, &results](std::size_t request,
+                                       captured_output const& output,
+                                       std::vector<size_type> shape,
+                                       std::byte const* data) {
+      if (!cache_keys_[request]) { return; }
+      auto bytes = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>()) *
+                   TRITONSERVER_DataTypeByteSize(output.dtype);
+      // Source data are not modified; the non-const pointer is required only
+      // to construct a non-owning Buffer
+      auto src  = Buffer<std::byte>(
+        const_cast<std::byte*>(data), bytes, output.mem_type, output.device, stream_);
+      auto host = Buffer<std::byte>(bytes, HostMemory, 0, stream_);
+      copy(host, src);
+      results[request].push_back(
+        cached_output{output.name, output.dtype, std::move(shape), std::move(host)});
+    };
+
+    for (auto& output : captured_outputs_) {
+      if (output.request) {
+        add_output(*output.request, output, output.shape, output.data);
+      } else {
+        auto row_bytes = std::reduce(output.shape.begin() + 1,
+                                     output.shape.end(),
+                                     std::size_t{1},
+                                     std::multiplies<>()) *
+                         TRITONSERVER_DataTypeByteSize(output.dtype);
+        for (auto i = std::size_t{}; i < request_rows_.size(); ++i) {
+          auto shape = output.shape;
+          shape[0]   = request_rows_[i];
+          add_output(i, output, std::move(shape), output.data + row_offsets[i] * row_bytes);
+        }
+      }
+    }
+    if constexpr (IS_GPU_BUILD) { synchronize(stream_); }
+
+    for (auto i = std::size_t{}; i < results.size(); ++i) {
+      if (!results[i].empty()) {
+        for (auto& output : results[i]) {
+          output.data.set_stream(cudaStream_t{});
+        }
+        cache_->insert(std::move(*cache_keys_[i]), std::move(results[i]));
+      }
+    }
+  }
+
+  /* Record the shape of the named input and return its size in bytes */
+  template <typename T>
+  std::size_t prepare_input(pending_input& input, std::string const& name)
+  {
+    input.shape = get_input_shape<T>(name);
+    return sizeof(T) *
+           std::reduce(input.shape.begin(), input.shape.end(), std::size_t{1}, std::multiplies<>());
+  }
+
+  template <typename T>
+  void process_input(pending_input& input,
+                     std::string const& name,
+                     std::optional<MemoryType> const& memory_type,
+                     device_id_t device_id)
+  {
+    auto size_bytes = prepare_input<T>(input, name);
+    auto range      = nvtx_range{"get_input ", name, ": ", size_bytes, " bytes"};
+    collect_raw_input(input, name, size_bytes, memory_type, device_id);
+  }
+
+  /* Gather the raw bytes of the named input for all requests into one
+   * location */
+  void collect_raw_input(pending_input& input,
+                         std::string const& name,
+                         std::size_t size_bytes,
+                         std::optional<MemoryType> const& memory_type,
+                         device_id_t device_id)
+  {
+    if (requests_.size() == 1 &&
+        process_single_input(input, name, size_bytes, memory_type, device_id)) {
+      return;
+    }
+    stage_input(input, name, size_bytes, memory_type, device_id, input_copy_stream_);
+    staged_input_bytes_ += gather_input(
+      collector(), allowed_memory_configs_, input, name, size_bytes, memory_type, device_id);
+    if (input.device_staging != nullptr) { staged_device_inputs_.push_back(&input); }
+  }
+
+  /* Gather the named input with the given collector, using allowed_configs
+   * as storage for the locations it may choose. Returns the bytes which had
+   * to be staged between host and device. */
+  std::size_t gather_input(BackendInputCollector& input_collector,
+                           std::vector<std::pair<MemoryType, int64_t>>& allowed_configs,
+                           pending_input& input,
+                           std::string const& name,
+                           std::size_t size_bytes,
+                           std::optional<MemoryType> const& memory_type,
+                           device_id_t device_id)
+  {
+    if (input.staging != nullptr) {
+      triton_check(
+        input_collector.ProcessTensor(name.c_str(), input.staging, size_bytes, PinnedMemory, 0));
+      input.raw_buffer         = input.staging;
+      input.reported_bytes     = size_bytes;
+      input.reported_mem_type  = PinnedMemory;
+      input.reported_device_id = int64_t{};
+      // Staged inputs lie entirely on the host; any wanted on the device are
+      // copied there by copy_staged_input
+      return (memory_type == DeviceMemory) ? size_bytes : std::size_t{};
+    }
+
+    auto placements = get_triton_input_placements(std::begin(requests_), std::end(requests_), name);
+    allowed_configs.clear();
+    // Pinned host memory is accepted wherever host memory is, so that
+    // buffers already pinned by Triton are used in place
+    if (memory_type.has_value()) {
+      allowed_configs.emplace_back(memory_type.value(), device_id);
+      if (memory_type.value() == HostMemory) {
+        allowed_configs.emplace_back(PinnedMemory, int64_t{});
+      }
+    } else if (IS_GPU_BUILD && placed_bytes(placements, DeviceMemory, device_id) >
+                                 placed_bytes(placements, HostMemory, device_id_t{})) {
+      // Most of the data are already on the device (e.g. in CUDA shared
+      // memory registered by the client), so gather them there rather than
+      // staging them through the host
+      allowed_configs.emplace_back(DeviceMemory, device_id);
+      allowed_configs.emplace_back(HostMemory, int64_t{});
+      allowed_configs.emplace_back(PinnedMemory, int64_t{});
+    } else {
+      allowed_configs.emplace_back(HostMemory, int64_t{});
+      allowed_configs.emplace_back(PinnedMemory, int64_t{});
+      allowed_configs.emplace_back(DeviceMemory, device_id);
+    }
+
+    // A null buffer is given so that data are returned without a copy if possible
+    triton_check(input_collector.ProcessTensor(name.c_str(),
+                                               static_cast<char*>(nullptr),
+                                               size_bytes,
+                                               allowed_configs,
+                                               &input.raw_buffer,
+                                               &input.reported_bytes,
+                                               &input.reported_mem_type,
+                                               &input.reported_device_id));
+    auto in_place = placed_bytes(
+      placements, input.reported_mem_type, narrow<device_id_t>(input.reported_device_id));
+    return size_bytes - std::min(size_bytes, in_place);
+  }
+
+  /* Gather an input which lies entirely in host memory into the batch's
+   * pinned staging arena, which persists across batches, rather than
+   * letting the collector allocate pinned staging of its own. Inputs wanted
+   * on the device are then copied there in a single transfer, for which
+   * device storage is also reserved here, since the arenas are not shared
+   * safely between collection threads. */
+  void stage_input(pending_input& input,
+                   std::string const& name,
+                   std::size_t size_bytes,
+                   std::optional<MemoryType> const& memory_type,
+                   device_id_t device_id,
+                   cudaStream_t stream)
+  {
+    input.staging        = nullptr;
+    input.device_staging = nullptr;
+    if (!IS_GPU_BUILD || !use_pinned_input_ || size_bytes == 0) { return; }
+    auto placements = get_triton_input_placements(std::begin(requests_), std::end(requests_), name);
+    auto on_host    = std::all_of(std::begin(placements), std::end(placements), [](auto& entry) {
+      return is_host_memory(entry.mem_type);
+    });
+    if (on_host) {
+      input.staging = scratch<char>(size_bytes, PinnedMemory, 0, stream).data();
+      if (memory_type == DeviceMemory) {
+        input.device_staging = scratch<char>(size_bytes, DeviceMemory, device_id, stream).data();
+        input.staging_device = device_id;
+      }
+    }
+  }
+
+  /* Copy a staged input to the device storage reserved for it, which must
+   * follow the finalization of the collector which gathered it */
+  static void copy_staged_input(pending_input& input, cudaStream_t stream)
+  {
+    if (input.device_staging == nullptr) { return; }
+    auto dst = Buffer<char>(
+      input.device_staging, input.reported_bytes, DeviceMemory, input.staging_device, stream);
+    rapids::copy(dst, Buffer<char>(input.staging, input.reported_bytes, PinnedMemory, 0, stream));
+    input.raw_buffer         = input.device_staging;
+    input.reported_mem_type  = DeviceMemory;
+    input.reported_device_id = input.staging_device;
+  }
+
+  /* Whether the given number of inputs should be gathered concurrently */
+  bool collects_concurrently(std::size_t input_count) const
+  {
+    return collection_pool_ != nullptr && collection_pool_->size() != 0 && input_count > 1;
+  }
+
+  /* Gather each of the given inputs, whose shapes have already been
+   * recorded, with its own collector on its own stream, using the
+   * collection pool's threads. The batch's stream then waits on every
+   * collection stream. */
+  void collect_concurrently(std::string const* names,
+                            pending_input* inputs,
+                            std::size_t const* sizes,
+                            std::size_t count,
+                            std::optional<MemoryType> const& memory_type,
+                            device_id_t device_id)
+  {
+    auto range = nvtx_range{"concurrent input collection: ", count, " inputs"};
+    auto first = concurrent_collectors_.size();
+    for (auto i = std::size_t{}; i < count; ++i) {
+      concurrent_collectors_.push_back(std::make_unique<concurrent_collector>());
+      concurrent_collectors_.back()->responses = responses_;
+    }
+    auto streams = std::vector<cudaStream_t>(count, input_copy_stream_);
+    if (collection_streams_ != nullptr && !collection_streams_->empty()) {
+      for (auto i = std::size_t{}; i < count; ++i) {
+        streams[i] = (*collection_streams_)[i % collection_streams_->size()].get();
+      }
+    }
+    auto staged = std::vector<std::size_t>(count);
+    auto waits  = std::vector<std::size_t>(count);
+    // Staging storage is allocated up front, since the arena is not shared
+    // safely between threads
+    auto gathered = std::vector<bool>(count);
+    for (auto i = std::size_t{}; i < count; ++i) {
+      gathered[i] = requests_.size() != 1 ||
+                    !process_single_input(inputs[i], names[i], sizes[i], memory_type, device_id);
+      if (gathered[i]) {
+        stage_input(inputs[i], names[i], sizes[i], memory_type, device_id, streams[i]);
+      }
+    }
+
+    collection_pool_->parallel_for(0, count, 1, [&](std::size_t begin, std::size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        if (!gathered[i]) { continue; }
+        auto& entry = *concurrent_collectors_[first + i];
+        entry.collector.emplace(requests_.data(),
+                                narrow<request_size_t>(requests_.size()),
+                                &entry.responses,
+                                triton_mem_manager_,
+                                use_pinned_input_,
+                                streams[i]);
+        auto allowed = std::vector<std::pair<MemoryType, int64_t>>{};
+        staged[i]    = gather_input(
+          *entry.collector, allowed, inputs[i], names[i], sizes[i], memory_type, device_id);
+        if (entry.collector->Finalize()) {
+          if constexpr (IS_GPU_BUILD) {
+            cuda_check(cudaStreamSynchronize(streams[i]));
+            waits[i] = 1;
+          } else {
+            throw TritonException(Error::Internal,
+                                  "stream synchronization required in non-GPU build");
+          }
+        }
+        copy_staged_input(inputs[i], streams[i]);
+      }
+    });
+
+    for (auto i = std::size_t{}; i < count; ++i) {
+      auto& entry = *concurrent_collectors_[first + i];
+      for (auto j = std::size_t{}; j < responses_.size(); ++j) {
+        if (entry.responses[j] == nullptr) { responses_[j] = nullptr; }
+      }
+      staged_input_bytes_ += staged[i];
+      activity_.synchronizations += waits[i];
+    }
+    if constexpr (IS_GPU_BUILD) {
+      std::sort(std::begin(streams), std::end(streams));
+      auto last = std::unique(std::begin(streams), std::end(streams));
+      std::for_each(std::begin(streams), last, [this](auto collection_stream) {
+        if (collection_stream != stream_) {
+          auto collected = cuda_event{};
+          collected.record(collection_stream);
+          collected.wait(stream_);
+        }
+      });
+    }
+    check_collected_responses();
+  }
+
+  /* The bytes of an input which reside in the given location */
+  static std::size_t placed_bytes(std::vector<input_placement> const& placements,
+                                  MemoryType mem_type,
+                                  device_id_t device)
+  {
+    if (mem_type == TRITONSERVER_MEMORY_CPU_PINNED) { mem_type = HostMemory; }
+    auto placement = std::find_if(std::begin(placements), std::end(placements), [&](auto& entry) {
+      return entry.mem_type == mem_type && (mem_type == HostMemory || entry.device == device);
+    });
+    return (placement == std::end(placements)) ? std::size_t{} : placement->bytes;
+  }
+
+  void finalize_inputs()
+  {
+    auto range        = nvtx_range{"input collection finalize: ", requests_.size(), " requests"};
+    auto synchronized = collector_ && collector_->Finalize();
+    if (synchronized) {
+      if constexpr (IS_GPU_BUILD) {
+        // Inputs may be read on the host, so the copies must be complete, but
+        // work already enqueued on the compute stream need not be
+        synchronize(input_copy_stream_);
+      } else {
+        throw TritonException(Error::Internal, "stream synchronization required in non-GPU build");
+      }
+    }
+    // Staged inputs wanted on the device are copied once the collector has
+    // filled their staging storage
+    auto copied = !staged_device_inputs_.empty();
+    for (auto* input : staged_device_inputs_) {
+      copy_staged_input(*input, input_copy_stream_);
+    }
+    staged_device_inputs_.clear();
+    if (collector_ && (!synchronized || copied) && input_copy_stream_ != stream_) {
+      if constexpr (IS_GPU_BUILD) {
+        auto collected = cuda_event{};
+        collected.record(input_copy_stream_);
+        collected.wait(stream_);
+      }
+    }
+    check_collected_responses();
+  }
+
+  /* Fail the batch if input collection failed any of its requests */
+  void check_collected_responses() const
+  {
+    std::for_each(std::begin(responses_), std::end(responses_), [](auto* response) {
+      if (response == nullptr) {
+        throw TritonException(Error::Internal, "Input collection failed");
+      }
+    });
+  }
+
+  template <typename T>
+  auto make_input_tensor(pending_input& input,
+                         std::optional<MemoryType> const& memory_type,
+                         device_id_t device_id,
+                         cudaStream_t stream)
+  {
+    auto buffer = Buffer(reinterpret_cast<T*>(input.raw_buffer),
+                         input.reported_bytes / sizeof(T),
+                         input.reported_mem_type,
+                         input.reported_device_id,
+                         stream);
+
+    if (memory_type && (!satisfies_memory_type(input.reported_mem_type, *memory_type) ||
+                        input.reported_device_id != device_id)) {
+      throw TritonException(Error::Internal, "data collected in wrong location");
+    }
+    activity_.add_input(input.reported_mem_type, input.reported_bytes);
+
+    // Set start time of batch to time latest input tensor was retrieved
+    mark_compute_start();
+
+    return Tensor(std::move(input.shape), std::move(buffer));
+  }
+
+  /* If the input's type is S, collect it and convert it to T in result,
+   * returning whether a conversion was performed */
+  template <typename T, typename S>
+  auto convert_input(std::optional<Tensor<T>>& result,
+                     DType dtype,
+                     std::string const& name,
+                     std::optional<MemoryType> const& memory_type,
+                     device_id_t device_id,
+                     cudaStream_t stream)
+  {
+    if (dtype != TritonDtype<S>::value) { return false; }
+
+    auto device_conversion =
+      IS_GPU_BUILD && detail::device_conversion_available<std::remove_const_t<T>, S>();
+    auto source_memory_type =
+      device_conversion ? memory_type : std::optional<MemoryType>{HostMemory};
+    auto source = get_input<S const>(name, source_memory_type, device_id, stream);
+
+    auto range  = nvtx_range{"convert input ", name, ": ", source.size(), " elements"};
+    auto buffer = Buffer<T>(source.size(), source.mem_type(), source.device(), stream);
+    detail::convert(const_cast<std::remove_const_t<T>*>(buffer.data()),
+                    source.data(),
+                    source.size(),
+                    stream,
+                    source.mem_type());
+    if (memory_type && !satisfies_memory_type(buffer.mem_type(), memory_type.value())) {
+      buffer = Buffer<T>(buffer, memory_type.value(), device_id);
+    }
+    result.emplace(source.shape(), std::move(buffer));
+    return true;
+  }
+
+  template <typename... Ts, std::size_t... Is>
+  std::tuple<Tensor<Ts>...> collect_inputs(std::array<std::string, sizeof...(Ts)> const& names,
+                                           std::optional<MemoryType> const& memory_type,
+                                           device_id_t device_id,
+                                           cudaStream_t stream,
+                                           std::index_sequence<Is...>)
+  {
+    if (slice_) {
+      auto missing = (... || !has_whole_batch_input(names[Is]));
+      if (missing) {
+        // Collect every input for the whole batch together on the first slice
+        auto slice  = std::exchange(slice_, std::nullopt);
+        auto inputs = std::optional<std::tuple<Tensor<Ts>...>>{};
+        try {
+          inputs.emplace(collect_inputs<Ts...>(
+            names, memory_type, device_id, stream, std::index_sequence<Is...>{}));
+        } catch (...) {
+          slice_ = slice;
+          throw;
+        }
+        slice_ = slice;
+        (store_whole_batch_input<Ts>(names[Is], std::move(std::get<Is>(*inputs))), ...);
+      }
+      return std::tuple<Tensor<Ts>...>{get_input<Ts>(names[Is], memory_type, device_id, stream)...};
+    }
+    // Intermediates are views of data already in the batch and compressed
+    // inputs are gathered separately, so there is nothing to gather
+    // together with them
+    if ((... || (find_intermediate(names[Is]) != nullptr || compressed(names[Is]) != nullptr))) {
+      return std::tuple<Tensor<Ts>...>{get_input<Ts>(names[Is], memory_type, device_id, stream)...};
+    }
+    // Inputs are processed in place so that the output locations passed to
+    // the collector remain valid until it is finalized
+    if (graph_) { return std::tuple<Tensor<Ts>...>{graph_input<Ts>(names[Is], stream)...}; }
+    if (synthetic_rows_) {
+      return std::tuple<Tensor<Ts>...>{get_input<Ts>(names[Is], memory_type, device_id, stream)...};
+    }
+    auto inputs = std::array<pending_input, sizeof...(Ts)>{};
+    if (collects_concurrently(sizeof...(Ts))) {
+      // Shapes are recorded first, since they also determine the batch size
+      auto sizes =
+        std::array<std::size_t, sizeof...(Ts)>{prepare_input<Ts>(inputs[Is], names[Is])...};
+      collect_concurrently(
+        names.data(), inputs.data(), sizes.data(), sizeof...(Ts), memory_type, device_id);
+    } else {
+      (process_input<Ts>(inputs[Is], names[Is], memory_type, device_id), ...);
+      finalize_inputs();
+    }
+    auto result = std::tuple<Tensor<Ts>...>{pad_input(
+      transform_input(
+        names[Is], make_input_tensor<Ts>(inputs[Is], memory_type, device_id, stream), stream),
+      stream)...};
+    if (recording_) {
+      (record_graph_input<Ts>(names[Is], std::get<Is>(result).shape(), memory_type, device_id),
+       ...);
+    }
+    return result;
+  }
 };
 }  // namespace rapids
 }  // namespace backend
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <rapids_triton/memory/types.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Counts of the data movement and waiting done by one batch
+ *
+ * A batch only ever updates its own activity from the thread processing it,
+ * so these are plain counters; they are published to an instance's shared
+ * performance_counters once the batch completes.
+ */
+struct batch_activity {
+  // Bytes by TRITONSERVER_MemoryType, i.e. host, pinned host and device
+  using bytes_by_location = std::array<std::size_t, 3>;
+
+  // Input bytes collected from requests into the location predict read them
+  bytes_by_location input_bytes{};
+  // Output bytes allocated in each location
+  bytes_by_location output_bytes{};
+  // Times the host waited on a stream
+  std::size_t synchronizations{};
+  // Scratch allocations served from storage the batch already held
+  std::size_t scratch_hits{};
+  // Scratch allocations which required a new block
+  std::size_t scratch_misses{};
+
+  void add_input(MemoryType mem_type, std::size_t bytes) { input_bytes[index(mem_type)] += bytes; }
+  void add_output(MemoryType mem_type, std::size_t bytes)
+  {
+    output_bytes[index(mem_type)] += bytes;
+  }
+
+ private:
+  static std::size_t index(MemoryType mem_type)
+  {
+    return (mem_type == DeviceMemory) ? 2 : ((mem_type == PinnedMemory) ? 1 : 0);
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/triton/requests.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A cache of Batch objects which are reset and reused for new sets
+ * of requests
+ *
+ * Batches acquired from a pool are returned to it when their owning pointer
+ * is destroyed, so that the storage they allocated for previous requests may
+ * be reused rather than reconstructing a Batch for every call to execute.
+ * All batches from a pool share the same output shape fetcher and
+ * statistics reporter, which must outlive the pool. The pool itself must
+ * outlive every batch acquired from it.
+ */
+struct batch_pool {
+  struct recycler {
+    void operator()(Batch* batch) const noexcept { pool->release(batch); }
+    batch_pool* pool;
+  };
+  using pointer = std::unique_ptr<Batch, recycler>;
+
+  batch_pool(Batch::output_shape_fetcher get_output_shape,
+             Batch::statistics_reporter report_request_statistics)
+    : get_output_shape_{get_output_shape},
+      report_statistics_{report_request_statistics},
+      idle_batches_{},
+      lock_{}
+  {
+  }
+
+  batch_pool(batch_pool const& other) = delete;
+  batch_pool& operator=(batch_pool const& other) = delete;
+
+  auto acquire(TRITONBACKEND_Request** raw_requests,
+               request_size_t count,
+               TRITONBACKEND_MemoryManager& triton_mem_manager,
+               bool use_pinned_input,
+               bool use_pinned_output,
+               Batch::size_type max_batch_size,
+               cudaStream_t stream)
+  {
+    auto recycled = std::unique_ptr<Batch>{};
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      if (!idle_batches_.empty()) {
+        recycled = std::move(idle_batches_.back());
+        idle_batches_.pop_back();
+      }
+    }
+    if (recycled) {
+      recycled->reset(raw_requests,
+                      count,
+                      triton_mem_manager,
+                      use_pinned_input,
+                      use_pinned_output,
+                      max_batch_size,
+                      stream);
+    } else {
+      recycled = std::make_unique<Batch>(raw_requests,
+                                         count,
+                                         triton_mem_manager,
+                                         get_output_shape_,
+                                         report_statistics_,
+                                         use_pinned_input,
+                                         use_pinned_output,
+                                         max_batch_size,
+                                         stream);
+    }
+    return pointer{recycled.release(), recycler{this}};
+  }
+
+  /** The largest scratch high-water mark of any batch available for reuse
+   * (see Batch::scratch_high_water_mark) */
+  auto scratch_high_water_mark() const
+  {
+    auto lock   = std::lock_guard<std::mutex>{lock_};
+    auto result = std::size_t{};
+    for (auto const& batch : idle_batches_) {
+      result = std::max(result, batch->scratch_high_water_mark());
+    }
+    return result;
+  }
+
+  /** The number of batches available for reuse */
+  auto idle_count() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return idle_batches_.size();
+  }
+
+ private:
+  Batch::output_shape_fetcher get_output_shape_;
+  Batch::statistics_reporter report_statistics_;
+  std::vector<std::unique_ptr<Batch>> idle_batches_;
+  std::mutex mutable lock_;
+
+  void release(Batch* batch) noexcept
+  {
+    auto owned = std::unique_ptr<Batch>{batch};
+    // An idle batch must not hold back other batches awaiting admission
+    owned->release_admission();
+    try {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      idle_batches_.push_back(std::move(owned));
+    } catch (std::bad_alloc const& err) {
+      // The batch is simply destroyed if it cannot be retained
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <rapids_triton/exceptions.hpp>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Parse a comma-separated list of batch bucket sizes (e.g.
+ * "8,32,128"), returning them sorted in increasing order without duplicates
+ */
+inline auto parse_batch_buckets(std::string const& spec)
+{
+  auto result       = std::vector<std::size_t>{};
+  auto input_stream = std::istringstream{spec};
+  auto entry        = std::string{};
+  while (std::getline(input_stream, entry, ',')) {
+    auto entry_stream = std::istringstream{entry};
+    auto value        = std::size_t{};
+    entry_stream >> value;
+    if (entry_stream.fail() || !(entry_stream >> std::ws).eof() || value == 0) {
+      throw TritonException(Error::InvalidArg, "bad batch bucket size '" + entry + "'");
+    }
+    result.push_back(value);
+  }
+  std::sort(std::begin(result), std::end(result));
+  result.erase(std::unique(std::begin(result), std::end(result)), std::end(result));
+  return result;
+}
+
+/**
+ * @brief Return the smallest bucket which can hold the given number of
+ * rows, or std::nullopt if all buckets are smaller
+ *
+ * @param buckets Bucket sizes in increasing order
+ */
+inline auto find_bucket(std::vector<std::size_t> const& buckets, std::size_t rows)
+{
+  auto bucket = std::lower_bound(std::begin(buckets), std::end(buckets), rows);
+  return (bucket == std::end(buckets)) ? std::optional<std::size_t>{}
+                                       : std::make_optional(*bucket);
+}
+
+/**
+ * @brief Call `fn` with the bucket size `rows` as a compile-time constant
+ *
+ * `fn` is called with a `std::integral_constant<std::size_t, B>` for the
+ * element B of Buckets equal to `rows`, so that kernels specialized for
+ * each bucket can be selected:
+ *
+ * ```cpp
+ * auto dispatched = dispatch_bucket<8, 32, 128>(batch.bucket(), [&](auto rows) {
+ *   launch_kernel<decltype(rows)::value>(...);
+ * });
+ * ```
+ *
+ * @return true if `rows` was one of Buckets and `fn` was called
+ */
+template <std::size_t... Buckets, typename F>
+auto dispatch_bucket(std::size_t rows, F&& fn)
+{
+  return ((rows == Buckets ? (fn(std::integral_constant<std::size_t, Buckets>{}), true) : false) ||
+          ...);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
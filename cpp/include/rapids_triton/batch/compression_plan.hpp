@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief An input sent as a BYTES tensor with one compressed row in each
+ * element, which is decompressed into row_elements elements of the type
+ * retrieved
+ */
+struct compressed_input {
+  compression_codec codec;
+  std::size_t row_elements;
+};
+
+/**
+ * @brief The compressed inputs declared for a model
+ *
+ * Inputs sent uncompressed are absent from the plan.
+ */
+struct compression_plan {
+  /* Entries sorted by input name */
+  std::vector<std::pair<std::string, compressed_input>> inputs;
+
+  /** The compression of the named input, or nullptr if it is uncompressed */
+  compressed_input const* input(std::string const& name) const
+  {
+    auto entry = std::lower_bound(
+      std::begin(inputs), std::end(inputs), name, [](auto& entry, auto& value) {
+        return entry.first < value;
+      });
+    return (entry != std::end(inputs) && entry->first == name) ? &entry->second : nullptr;
+  }
+
+  auto empty() const { return inputs.empty(); }
+};
+
+/**
+ * @brief Parse the compression of an input, given as the codec (`lz4` or
+ * `zstd`) and the number of elements in each decompressed row, e.g.
+ * "zstd:512"
+ */
+inline auto parse_compressed_input(std::string const& spec)
+{
+  auto bad_spec = [&spec]() {
+    return TritonException(Error::InvalidArg, "bad input compression '" + spec + "'");
+  };
+  auto separator = spec.find(':');
+  if (separator == std::string::npos) { throw bad_spec(); }
+  auto codec  = spec.substr(0, separator);
+  auto result = compressed_input{};
+  if (codec == "lz4") {
+    result.codec = compression_codec::lz4;
+  } else if (codec == "zstd") {
+    result.codec = compression_codec::zstd;
+  } else {
+    throw bad_spec();
+  }
+  auto elements_stream = std::istringstream{spec.substr(separator + 1)};
+  auto elements        = std::int64_t{};
+  elements_stream >> elements;
+  if (elements_stream.fail() || !(elements_stream >> std::ws).eof() || elements <= 0) {
+    throw bad_spec();
+  }
+  result.row_elements = static_cast<std::size_t>(elements);
+  return result;
+}
+
+/**
+ * @brief Collect the compressed inputs declared by `input_compression:<name>`
+ * parameters from the given (name, value) parameter pairs
+ */
+inline auto make_compression_plan(
+  std::vector<std::pair<std::string, std::string>> const& parameters)
+{
+  auto const prefix = std::string{"input_compression:"};
+  auto result       = compression_plan{};
+  for (auto const& [key, value] : parameters) {
+    if (key.rfind(prefix, 0) != 0) { continue; }
+    try {
+      result.inputs.emplace_back(key.substr(prefix.size()), parse_compressed_input(value));
+    } catch (TritonException const& err) {
+      throw TritonException(Error::InvalidArg, "parameter " + key + ": " + err.what());
+    }
+  }
+  std::sort(std::begin(result.inputs), std::end(result.inputs), [](auto& lhs, auto& rhs) {
+    return lhs.first < rhs.first;
+  });
+  return result;
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief The time taken by a model's host and device predict paths for a
+ * batch of the given number of rows
+ */
+struct dispatch_sample {
+  std::size_t rows;
+  std::chrono::nanoseconds host_time;
+  std::chrono::nanoseconds device_time;
+};
+
+/**
+ * @brief The largest number of rows for which the host path is faster,
+ * given measurements of both paths
+ *
+ * Only the smallest sizes are sent to the host, so the threshold is the
+ * largest size below which every measured size was faster on the host.
+ * Zero is returned if the smallest measured size was faster on the device.
+ */
+inline std::size_t learn_host_threshold(std::vector<dispatch_sample> samples)
+{
+  std::sort(std::begin(samples), std::end(samples), [](auto const& a, auto const& b) {
+    return a.rows < b.rows;
+  });
+  auto slower = std::find_if(std::begin(samples), std::end(samples), [](auto const& sample) {
+    return sample.host_time >= sample.device_time;
+  });
+  return slower == std::begin(samples) ? std::size_t{} : std::prev(slower)->rows;
+}
+
+/**
+ * @brief The choice between a model's host and device predict paths for
+ * each batch, by the number of rows in the batch
+ *
+ * Batches of at most max_host_rows() rows are predicted on the host, where
+ * they avoid the cost of transfers and kernel launches. The threshold may
+ * be given by configuration or learned from measurements at warmup, and may
+ * be read by several threads while it is set.
+ */
+struct hybrid_dispatch {
+  /** Dispatch batches of up to the given number of rows to the host, or
+   * none until calibrated if it is zero */
+  explicit hybrid_dispatch(std::size_t max_host_rows = std::size_t{})
+    : max_host_rows_{max_host_rows}, configured_{max_host_rows != 0}
+  {
+  }
+
+  /** Whether a batch of the given number of rows should be predicted on the
+   * host */
+  auto to_host(std::size_t rows) const noexcept
+  {
+    return rows != 0 && rows <= max_host_rows_.load(std::memory_order_relaxed);
+  }
+
+  auto max_host_rows() const noexcept { return max_host_rows_.load(std::memory_order_relaxed); }
+
+  /** Whether the threshold must be learned from measurements rather than
+   * having been given by configuration */
+  auto needs_calibration() const noexcept { return !configured_; }
+
+  /** Set the threshold from measurements of both paths */
+  void calibrate(std::vector<dispatch_sample> samples)
+  {
+    max_host_rows_.store(learn_host_threshold(std::move(samples)), std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::size_t> max_host_rows_;
+  bool configured_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/deployment.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/numa.hpp>
+#include <thread>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Execution state allowing several batches to be in flight for a
+ * single model instance
+ *
+ * A batch_pipeline owns a rotating set of CUDA streams and a background
+ * thread. Once the outputs of a batch have been submitted, the remaining
+ * work of waiting for output copies, sending responses, reporting statistics
+ * and releasing requests is handed to the background thread so that the
+ * execute thread can return to Triton and begin collecting the next batch.
+ * At most `depth` batches are in flight at once; submitting a batch beyond
+ * that limit blocks until the oldest in-flight batch has completed. Because
+ * batches are assigned streams in rotation, a stream is never reused until
+ * the batch which last used it has completed. A pipeline of depth 1 uses only
+ * the default stream but still completes batches in the background, so the
+ * completion of one batch may overlap with the collection and prediction of
+ * the next, whose device work is ordered after it on that stream. If a NUMA
+ * node is given, the background thread is bound to it.
+ */
+struct batch_pipeline {
+  batch_pipeline(std::size_t depth,
+                 device_id_t device_id,
+                 DeploymentType deployment_type,
+                 cudaStream_t default_stream,
+                 std::optional<int> numa_node = std::nullopt)
+    : device_id_{device_id},
+      numa_node_{numa_node},
+      use_device_{IS_GPU_BUILD && deployment_type == GPUDeployment},
+      streams_{},
+      owned_streams_{},
+      next_stream_{},
+      pending_{},
+      in_flight_{},
+      max_in_flight_{std::max(depth, std::size_t{2}) - 1},
+      shutdown_{false},
+      lock_{},
+      cv_{},
+      worker_{}
+  {
+    streams_.push_back(default_stream);
+    if constexpr (IS_GPU_BUILD) {
+      if (use_device_) {
+        cuda_check(cudaSetDevice(device_id_));
+        for (auto i = std::size_t{1}; i < depth; ++i) {
+          auto stream = cudaStream_t{};
+          cuda_check(cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking));
+          owned_streams_.push_back(stream);
+          streams_.push_back(stream);
+        }
+      }
+    }
+    worker_ = std::thread{[this]() { run(); }};
+  }
+
+  batch_pipeline(batch_pipeline const& other) = delete;
+  batch_pipeline& operator=(batch_pipeline const& other) = delete;
+
+  ~batch_pipeline()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+    std::for_each(std::begin(owned_streams_), std::end(owned_streams_), [](auto stream) {
+      cudaStreamDestroy(stream);
+    });
+  }
+
+  /** Return the stream which should be used for the next batch */
+  auto next_stream()
+  {
+    auto result  = streams_[next_stream_];
+    next_stream_ = (next_stream_ + 1) % streams_.size();
+    return result;
+  }
+
+  /**
+   * @brief Hand the remaining work for a batch to the background thread
+   *
+   * Blocks until fewer than `max(depth - 1, 1)` earlier batches remain
+   * incomplete.
+   */
+  void submit(std::function<void()>&& completion)
+  {
+    auto lock = std::unique_lock<std::mutex>{lock_};
+    cv_.wait(lock, [this]() { return in_flight_ < max_in_flight_; });
+    pending_.push_back(std::move(completion));
+    ++in_flight_;
+    cv_.notify_all();
+  }
+
+  /** Block until all submitted batches have completed */
+  void drain()
+  {
+    auto lock = std::unique_lock<std::mutex>{lock_};
+    cv_.wait(lock, [this]() { return in_flight_ == 0; });
+  }
+
+ private:
+  device_id_t device_id_;
+  std::optional<int> numa_node_;
+  bool use_device_;
+  std::vector<cudaStream_t> streams_;
+  std::vector<cudaStream_t> owned_streams_;
+  std::size_t next_stream_;
+  std::deque<std::function<void()>> pending_;
+  std::size_t in_flight_;
+  std::size_t max_in_flight_;
+  bool shutdown_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::thread worker_;
+
+  void run()
+  {
+    if constexpr (IS_GPU_BUILD) {
+      if (use_device_) { cudaSetDevice(device_id_); }
+    }
+    if (numa_node_) { bind_thread_to_numa_node(*numa_node_); }
+    auto lock = std::unique_lock<std::mutex>{lock_};
+    while (true) {
+      cv_.wait(lock, [this]() { return shutdown_ || !pending_.empty(); });
+      if (pending_.empty()) { break; }
+      auto completion = std::move(pending_.front());
+      pending_.pop_front();
+      lock.unlock();
+      try {
+        completion();
+      } catch (TritonException& err) {
+        log_error(__FILE__, __LINE__) << "Batch completion failed: " << err.what();
+      }
+      lock.lock();
+      --in_flight_;
+      cv_.notify_all();
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <rapids_triton/batch/bucket.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+struct Batch;
+
+/**
+ * @brief An input or output of a captured predict graph, held at a fixed
+ * device address
+ *
+ * The first dimension of `shape` is the number of rows of the graph's
+ * bucket. `transfer` moves data for a batch between this tensor's storage
+ * and the batch: for inputs, it collects the batch's rows into the storage
+ * before the graph runs; for outputs, it copies the batch's rows out to the
+ * responses afterwards.
+ */
+struct graph_tensor {
+  std::string name;
+  DType dtype;
+  std::vector<std::size_t> shape;
+  std::optional<MemoryType> mem_type;
+  device_id_t device;
+  Buffer<std::byte> storage;
+  std::function<void(Batch&, graph_tensor&)> transfer;
+};
+
+/**
+ * @brief A CUDA graph of the work enqueued by one model instance's predict
+ * for batches padded to a fixed number of rows
+ *
+ * The first batch in a bucket runs predict normally while recording the
+ * inputs and outputs it requests, for which fixed device storage is then
+ * allocated. The next batch captures predict into a graph reading from and
+ * writing to that storage, and every later batch simply replays the graph.
+ * If predict requests anything which cannot be held at a fixed address, or
+ * its work cannot be captured, the graph is disabled and predict is called
+ * normally from then on.
+ */
+struct predict_graph {
+  enum struct status { unrecorded, recorded, captured, disabled };
+
+  explicit predict_graph(std::size_t rows)
+    : rows_{rows}, status_{status::unrecorded}, inputs_{}, outputs_{}, exec_{}
+  {
+  }
+
+  predict_graph(predict_graph const& other) = delete;
+  predict_graph& operator=(predict_graph const& other) = delete;
+
+  ~predict_graph()
+  {
+    if (exec_ != cudaGraphExec_t{}) { cudaGraphExecDestroy(exec_); }
+  }
+
+  /** The number of rows to which batches using this graph are padded */
+  auto rows() const noexcept { return rows_; }
+  auto get_status() const noexcept { return status_; }
+
+  auto& inputs() noexcept { return inputs_; }
+  auto& outputs() noexcept { return outputs_; }
+
+  auto* find_input(std::string const& name, DType dtype)
+  {
+    return find_tensor(inputs_, name, dtype);
+  }
+  auto* find_output(std::string const& name, DType dtype)
+  {
+    return find_tensor(outputs_, name, dtype);
+  }
+
+  /** Mark the recording of inputs and outputs as complete */
+  void finish_recording() noexcept
+  {
+    if (status_ == status::unrecorded) {
+      status_ = (inputs_.empty() || outputs_.empty()) ? status::disabled : status::recorded;
+    }
+    if (status_ == status::disabled) { release(); }
+  }
+
+  /** Discard a partial recording so that the next batch records again */
+  void abandon_recording() noexcept
+  {
+    if (status_ == status::unrecorded) { release(); }
+  }
+
+  /** Stop using this graph and release its storage */
+  void disable() noexcept
+  {
+    status_ = status::disabled;
+    release();
+  }
+
+  /** Instantiate the captured graph for replay */
+  void instantiate(cudaGraph_t graph)
+  {
+    cuda_check(cudaGraphInstantiateWithFlags(&exec_, graph, 0));
+    status_ = status::captured;
+  }
+
+  void launch(cudaStream_t stream) const { cuda_check(cudaGraphLaunch(exec_, stream)); }
+
+ private:
+  std::size_t rows_;
+  status status_;
+  std::vector<graph_tensor> inputs_;
+  std::vector<graph_tensor> outputs_;
+  cudaGraphExec_t exec_;
+
+  static graph_tensor* find_tensor(std::vector<graph_tensor>& tensors,
+                                   std::string const& name,
+                                   DType dtype)
+  {
+    auto tensor = std::find_if(std::begin(tensors), std::end(tensors), [&](auto& entry) {
+      return entry.name == name && entry.dtype == dtype;
+    });
+    return (tensor == std::end(tensors)) ? nullptr : &(*tensor);
+  }
+
+  void release() noexcept
+  {
+    inputs_.clear();
+    outputs_.clear();
+    if (exec_ != cudaGraphExec_t{}) {
+      cudaGraphExecDestroy(exec_);
+      exec_ = cudaGraphExec_t{};
+    }
+  }
+};
+
+/**
+ * @brief The predict graphs of one model instance, one for each bucket of
+ * batch sizes
+ *
+ * Batches are assigned to the smallest of the given bucket sizes which can
+ * hold them or, if there is none, by rounding their number of rows up to
+ * the next power of two, but no higher than the model's maximum batch size.
+ * Graphs are bound to their instance's storage, so a cache must only be
+ * used by one batch at a time.
+ */
+struct predict_graph_cache {
+  explicit predict_graph_cache(std::size_t max_batch_size,
+                               std::vector<std::size_t> buckets = std::vector<std::size_t>{})
+    : max_batch_size_{max_batch_size}, buckets_{std::move(buckets)}, graphs_{}
+  {
+  }
+
+  auto bucket_rows(std::size_t rows) const
+  {
+    auto bucket = find_bucket(buckets_, rows);
+    if (bucket.has_value()) { return bucket.value(); }
+    auto result = std::size_t{1};
+    while (result < rows) {
+      result <<= 1;
+    }
+    return std::max(rows, std::min(result, max_batch_size_));
+  }
+
+  /** Return the graph for the bucket containing batches of the given number
+   * of rows */
+  auto& get(std::size_t rows)
+  {
+    return graphs_.try_emplace(bucket_rows(rows), bucket_rows(rows)).first->second;
+  }
+
+ private:
+  std::size_t max_batch_size_;
+  std::vector<std::size_t> buckets_;
+  // Graphs are held in a map so that their addresses remain stable
+  std::map<std::size_t, predict_graph> graphs_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A running estimate of the time taken to process each row of a
+ * batch
+ *
+ * Observations are combined in an exponentially weighted moving average, so
+ * the estimate follows changes in load without being thrown off by a single
+ * slow batch. Observations may be made and estimates read from different
+ * threads.
+ */
+struct latency_estimator {
+  latency_estimator() noexcept : per_row_{0.0} {}
+
+  /** The estimated time to process the given number of rows, or zero if no
+   * batch has been observed */
+  std::chrono::microseconds estimate(std::size_t rows) const noexcept
+  {
+    return std::chrono::microseconds{
+      static_cast<std::chrono::microseconds::rep>(per_row_.load(std::memory_order_relaxed) * rows)};
+  }
+
+  /** Record that the given number of rows took the given time to process */
+  void observe(std::size_t rows, std::chrono::nanoseconds elapsed) noexcept
+  {
+    if (rows == 0) { return; }
+    auto sample =
+      std::chrono::duration<double, std::micro>{elapsed}.count() / static_cast<double>(rows);
+    auto current = per_row_.load(std::memory_order_relaxed);
+    per_row_.store(current == 0.0 ? sample : current + (sample - current) * weight,
+                   std::memory_order_relaxed);
+  }
+
+ private:
+  /* Weight given to each new observation */
+  static auto constexpr weight = 0.125;
+  std::atomic<double> per_row_;
+};
+
+/**
+ * @brief Reorder requests so that those with deadlines come first,
+ * preserving the relative order of each group
+ *
+ * @param requests The requests to reorder
+ * @param deadlines The deadline of each request, or std::nullopt for those
+ * without one; reordered along with the requests
+ * @return The number of requests with deadlines
+ */
+template <typename Request, typename TimePoint>
+auto partition_urgent(std::vector<Request>& requests,
+                      std::vector<std::optional<TimePoint>>& deadlines)
+{
+  auto order = std::vector<std::size_t>(requests.size());
+  std::iota(std::begin(order), std::end(order), std::size_t{});
+  auto boundary = std::stable_partition(
+    std::begin(order), std::end(order), [&deadlines](auto i) { return deadlines[i].has_value(); });
+
+  auto sorted_requests  = std::vector<Request>{};
+  auto sorted_deadlines = std::vector<std::optional<TimePoint>>{};
+  sorted_requests.reserve(requests.size());
+  sorted_deadlines.reserve(deadlines.size());
+  for (auto i : order) {
+    sorted_requests.push_back(requests[i]);
+    sorted_deadlines.push_back(deadlines[i]);
+  }
+  requests  = std::move(sorted_requests);
+  deadlines = std::move(sorted_deadlines);
+  return static_cast<std::size_t>(std::distance(std::begin(order), boundary));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <triton/core/tritonbackend.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/triton/responses.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+auto constexpr hash_seed = std::uint64_t{0xcbf29ce484222325};
+
+/* Fold bytes into a 64-bit hash. This is FNV-1a applied to 8-byte words
+ * (with the remaining bytes folded in one at a time), which is fast enough
+ * to run on every request and is not intended to resist deliberate
+ * collisions; cache lookups compare the full key on every hit. */
+inline auto hash_bytes(std::uint64_t hash, void const* data, std::size_t bytes)
+{
+  auto constexpr prime = std::uint64_t{0x100000001b3};
+  auto* bytes_ptr      = static_cast<unsigned char const*>(data);
+  auto word            = std::uint64_t{};
+  auto i               = std::size_t{};
+  for (; i + sizeof(word) <= bytes; i += sizeof(word)) {
+    std::memcpy(&word, bytes_ptr + i, sizeof(word));
+    hash = (hash ^ word) * prime;
+    hash ^= hash >> 32;
+  }
+  for (; i < bytes; ++i) {
+    hash = (hash ^ bytes_ptr[i]) * prime;
+  }
+  return hash;
+}
+
+template <typename T>
+void append_value(std::string& bytes, T const& value)
+{
+  bytes.append(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+}  // namespace detail
+
+/**
+ * @brief The key under which a request's result is cached: the canonical
+ * bytes of everything which determines the result, and their hash
+ *
+ * Keys are equal only if their bytes are, so requests whose hashes collide
+ * never share a result.
+ */
+struct request_key {
+  std::uint64_t hash;
+  std::string bytes;
+
+  bool operator==(request_key const& other) const
+  {
+    return hash == other.hash && bytes == other.bytes;
+  }
+  bool operator!=(request_key const& other) const { return !(*this == other); }
+};
+
+inline auto make_request_key(std::string bytes)
+{
+  auto hash = detail::hash_bytes(detail::hash_seed, bytes.data(), bytes.size());
+  return request_key{hash, std::move(bytes)};
+}
+
+/** A copy of one output of a response, held in host memory */
+struct cached_output {
+  std::string name;
+  DType dtype;
+  std::vector<std::size_t> shape;
+  Buffer<std::byte> data;
+};
+
+using cached_result = std::vector<cached_output>;
+
+/**
+ * @brief A thread-safe LRU cache of complete inference results keyed by the
+ * contents of the request
+ *
+ * Entries are indexed by the hash of their key, and a lookup only hits if
+ * the whole key matches, so a request never receives the result of another
+ * whose hash collides with its own. Of two keys with the same hash, only the
+ * most recently inserted is retained. At most `capacity` results are
+ * retained, with the least-recently used result discarded first. If a
+ * time-to-live is given, results older than it are discarded when next
+ * looked up.
+ */
+struct result_cache {
+  using clock = std::chrono::steady_clock;
+
+  result_cache(std::size_t capacity, std::optional<clock::duration> time_to_live = std::nullopt)
+    : capacity_{capacity}, time_to_live_{time_to_live}, entries_{}, index_{}, lock_{}
+  {
+    if (capacity_ == 0) {
+      throw TritonException(Error::Internal, "result cache must have nonzero capacity");
+    }
+  }
+
+  result_cache(result_cache const& other) = delete;
+  result_cache& operator=(result_cache const& other) = delete;
+
+  /** Return the cached result for the given key, or nullptr if there is none */
+  std::shared_ptr<cached_result const> find(request_key const& key)
+  {
+    auto result = std::shared_ptr<cached_result const>{};
+    auto lock   = std::lock_guard<std::mutex>{lock_};
+    auto found  = index_.find(key.hash);
+    if (found != std::end(index_) && found->second->key == key) {
+      auto entry = found->second;
+      if (time_to_live_ && clock::now() - entry->inserted >= *time_to_live_) {
+        entries_.erase(entry);
+        index_.erase(found);
+      } else {
+        entries_.splice(std::begin(entries_), entries_, entry);
+        result = entry->result;
+      }
+    }
+    return result;
+  }
+
+  void insert(request_key key, cached_result&& result)
+  {
+    auto value = std::make_shared<cached_result const>(std::move(result));
+    auto lock  = std::lock_guard<std::mutex>{lock_};
+    auto found = index_.find(key.hash);
+    if (found != std::end(index_)) {
+      found->second->key      = std::move(key);
+      found->second->result   = std::move(value);
+      found->second->inserted = clock::now();
+      entries_.splice(std::begin(entries_), entries_, found->second);
+    } else {
+      auto hash = key.hash;
+      entries_.push_front(entry{std::move(key), std::move(value), clock::now()});
+      index_.emplace(hash, std::begin(entries_));
+      if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().key.hash);
+        entries_.pop_back();
+      }
+    }
+  }
+
+  auto size() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return entries_.size();
+  }
+  auto capacity() const noexcept { return capacity_; }
+
+ private:
+  struct entry {
+    request_key key;
+    std::shared_ptr<cached_result const> result;
+    clock::time_point inserted;
+  };
+
+  std::size_t capacity_;
+  std::optional<clock::duration> time_to_live_;
+  // Ordered from most to least recently used
+  std::list<entry> entries_;
+  std::unordered_map<std::uint64_t, std::list<entry>::iterator> index_;
+  std::mutex mutable lock_;
+};
+
+/**
+ * @brief Compute the result cache key for a request from the names, types,
+ * shapes and contents of its inputs and the names of its requested outputs
+ *
+ * Requests with any input outside of host memory are not cached, and
+ * std::nullopt is returned for them.
+ */
+inline std::optional<request_key> get_request_key(TRITONBACKEND_Request* request)
+{
+  auto bytes       = std::string{};
+  auto input_count = std::uint32_t{};
+  triton_check(TRITONBACKEND_RequestInputCount(request, &input_count));
+  detail::append_value(bytes, input_count);
+  for (auto i = std::uint32_t{}; i < input_count; ++i) {
+    auto* input       = static_cast<TRITONBACKEND_Input*>(nullptr);
+    auto* name        = static_cast<char const*>(nullptr);
+    auto dtype        = DType{};
+    auto* shape       = static_cast<int64_t const*>(nullptr);
+    auto dims         = std::uint32_t{};
+    auto byte_size    = std::uint64_t{};
+    auto buffer_count = std::uint32_t{};
+    triton_check(TRITONBACKEND_RequestInputByIndex(request, i, &input));
+    triton_check(TRITONBACKEND_InputProperties(
+      input, &name, &dtype, &shape, &dims, &byte_size, &buffer_count));
+    bytes.append(name, std::strlen(name) + 1);
+    detail::append_value(bytes, dtype);
+    detail::append_value(bytes, dims);
+    bytes.append(reinterpret_cast<char const*>(shape), dims * sizeof(*shape));
+    detail::append_value(bytes, byte_size);
+    for (auto j = std::uint32_t{}; j < buffer_count; ++j) {
+      auto* data     = static_cast<void const*>(nullptr);
+      auto size      = std::uint64_t{};
+      auto mem_type  = TRITONSERVER_MEMORY_CPU;
+      auto device_id = int64_t{};
+      triton_check(TRITONBACKEND_InputBuffer(input, j, &data, &size, &mem_type, &device_id));
+      if (mem_type == TRITONSERVER_MEMORY_GPU) { return std::nullopt; }
+      bytes.append(static_cast<char const*>(data), size);
+    }
+  }
+
+  auto output_count = std::uint32_t{};
+  triton_check(TRITONBACKEND_RequestOutputCount(request, &output_count));
+  detail::append_value(bytes, output_count);
+  for (auto i = std::uint32_t{}; i < output_count; ++i) {
+    auto* name = static_cast<char const*>(nullptr);
+    triton_check(TRITONBACKEND_RequestOutputName(request, i, &name));
+    bytes.append(name, std::strlen(name) + 1);
+  }
+  return make_request_key(std::move(bytes));
+}
+
+/**
+ * @brief Respond to a request with a cached result
+ *
+ * If the response cannot be constructed, it is discarded and an exception
+ * is thrown, so that the request may instead be processed normally.
+ */
+inline void send_cached_response(TRITONBACKEND_Request* request, cached_result const& result)
+{
+  auto* response = static_cast<TRITONBACKEND_Response*>(nullptr);
+  triton_check(TRITONBACKEND_ResponseNew(&response, request));
+  try {
+    for (auto& output : result) {
+      auto buffer = get_response_buffer(
+        response, output.name, output.dtype, output.shape, HostMemory, 0, cudaStream_t{});
+      copy(buffer, output.data);
+      buffer.stream_synchronize();
+    }
+  } catch (TritonException const&) {
+    TRITONBACKEND_ResponseDelete(response);
+    throw;
+  }
+  send_response(response, TRITONSERVER_RESPONSE_COMPLETE_FINAL, nullptr);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
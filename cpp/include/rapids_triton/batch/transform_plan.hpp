@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/** The operation performed by one pre- or post-processing stage */
+enum class transform_op { columns, scale, offset, sigmoid, softmax, threshold, fp16, fp32 };
+
+/** A pre- or post-processing stage declared in the model configuration */
+struct transform_stage {
+  transform_op op;
+  std::vector<double> args;
+};
+
+using transform_stages = std::vector<transform_stage>;
+
+/**
+ * @brief The stages declared for each input and output of a model
+ *
+ * Inputs and outputs without stages are absent from the plan.
+ */
+struct transform_plan {
+  /* Entries sorted by input or output name */
+  std::vector<std::pair<std::string, transform_stages>> inputs;
+  std::vector<std::pair<std::string, transform_stages>> outputs;
+
+  /** The stages of the named input, or nullptr if it has none */
+  auto const* input_stages(std::string const& name) const { return find(inputs, name); }
+  /** The stages of the named output, or nullptr if it has none */
+  auto const* output_stages(std::string const& name) const { return find(outputs, name); }
+
+  auto empty() const { return inputs.empty() && outputs.empty(); }
+
+ private:
+  static transform_stages const* find(
+    std::vector<std::pair<std::string, transform_stages>> const& entries, std::string const& name)
+  {
+    auto entry = std::lower_bound(
+      std::begin(entries), std::end(entries), name, [](auto& entry, auto& value) {
+        return entry.first < value;
+      });
+    return (entry != std::end(entries) && entry->first == name) ? &entry->second : nullptr;
+  }
+};
+
+/**
+ * @brief Parse a comma-separated list of pre-processing (e.g.
+ * "columns:2:0:1,scale:0.5,offset:-1") or post-processing (e.g.
+ * "softmax,fp16") stages
+ *
+ * Input stages are `columns:i:j:...`, which reorders the columns of each
+ * row so that column k holds the original column given by the k-th index
+ * and may only be the first stage, `scale:a`, which multiplies by a nonzero
+ * factor, and `offset:b`, which adds a constant. Output stages are
+ * `sigmoid`, `softmax`, `threshold:c`, and `fp16` or `fp32`, which casts the
+ * result sent to clients and may only be the last stage.
+ */
+inline auto parse_transform_stages(std::string const& spec, bool output)
+{
+  auto result       = transform_stages{};
+  auto input_stream = std::istringstream{spec};
+  auto entry        = std::string{};
+  while (std::getline(input_stream, entry, ',')) {
+    auto bad_stage = [&entry]() {
+      return TritonException(Error::InvalidArg, "bad transform stage '" + entry + "'");
+    };
+    auto entry_stream = std::istringstream{entry};
+    auto name         = std::string{};
+    std::getline(entry_stream, name, ':');
+    name.erase(0, name.find_first_not_of(' '));
+    name.erase(name.find_last_not_of(' ') + 1);
+
+    auto stage = transform_stage{};
+    auto arg   = std::string{};
+    while (std::getline(entry_stream, arg, ':')) {
+      auto arg_stream = std::istringstream{arg};
+      auto value      = double{};
+      arg_stream >> value;
+      if (arg_stream.fail() || !(arg_stream >> std::ws).eof() || !std::isfinite(value)) {
+        throw bad_stage();
+      }
+      stage.args.push_back(value);
+    }
+
+    auto arg_count = std::size_t{};
+    if (!output && name == "columns") {
+      stage.op  = transform_op::columns;
+      arg_count = stage.args.size();
+      auto valid_columns =
+        result.empty() && arg_count != 0 &&
+        std::all_of(std::begin(stage.args), std::end(stage.args), [](auto index) {
+          return index >= 0 && index == std::floor(index);
+        });
+      if (!valid_columns) { throw bad_stage(); }
+    } else if (!output && name == "scale") {
+      stage.op  = transform_op::scale;
+      arg_count = 1;
+      if (stage.args.size() == arg_count && stage.args[0] == 0) { throw bad_stage(); }
+    } else if (!output && name == "offset") {
+      stage.op  = transform_op::offset;
+      arg_count = 1;
+    } else if (output && name == "sigmoid") {
+      stage.op = transform_op::sigmoid;
+    } else if (output && name == "softmax") {
+      stage.op = transform_op::softmax;
+    } else if (output && name == "threshold") {
+      stage.op  = transform_op::threshold;
+      arg_count = 1;
+    } else if (output && name == "fp16") {
+      stage.op = transform_op::fp16;
+    } else if (output && name == "fp32") {
+      stage.op = transform_op::fp32;
+    } else {
+      throw bad_stage();
+    }
+    if (stage.args.size() != arg_count) { throw bad_stage(); }
+    // A cast must be the final stage
+    if (!result.empty() &&
+        (result.back().op == transform_op::fp16 || result.back().op == transform_op::fp32)) {
+      throw bad_stage();
+    }
+    result.push_back(std::move(stage));
+  }
+  return result;
+}
+
+/**
+ * @brief Gather the stages declared by `input_transform:<name>` and
+ * `output_transform:<name>` parameters
+ *
+ * @param parameters The name and raw value of each configuration parameter
+ */
+inline auto make_transform_plan(
+  std::vector<std::pair<std::string, std::string>> const& parameters)
+{
+  auto const input_prefix  = std::string{"input_transform:"};
+  auto const output_prefix = std::string{"output_transform:"};
+  auto result              = transform_plan{};
+  for (auto const& [key, value] : parameters) {
+    auto output = key.rfind(output_prefix, 0) == 0;
+    if (!output && key.rfind(input_prefix, 0) != 0) { continue; }
+    auto name = key.substr((output ? output_prefix : input_prefix).size());
+    try {
+      auto stages = parse_transform_stages(value, output);
+      if (stages.empty()) { continue; }
+      auto& entries = output ? result.outputs : result.inputs;
+      entries.emplace_back(std::move(name), std::move(stages));
+    } catch (TritonException const& err) {
+      throw TritonException(Error::InvalidArg, "parameter " + key + ": " + err.what());
+    }
+  }
+  auto by_name = [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; };
+  std::sort(std::begin(result.inputs), std::end(result.inputs), by_name);
+  std::sort(std::begin(result.outputs), std::end(result.outputs), by_name);
+  return result;
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -27,6 +27,18 @@ auto constexpr IS_GPU_BUILD = true;
 auto constexpr IS_GPU_BUILD = false;
 #endif
 
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+auto constexpr IS_NVTX_BUILD = true;
+#else
+auto constexpr IS_NVTX_BUILD = false;
+#endif
+
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+auto constexpr IS_METRICS_BUILD = true;
+#else
+auto constexpr IS_METRICS_BUILD = false;
+#endif
+
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
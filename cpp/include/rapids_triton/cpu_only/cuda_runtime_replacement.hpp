@@ -18,12 +18,16 @@
 #ifdef TRITON_ENABLE_GPU
 #include <cuda_runtime_api.h>
 #else
+#include <cstddef>
 
 namespace triton {
 namespace backend {
 namespace rapids {
 
 using cudaStream_t = void*;
+using cudaEvent_t  = void*;
+using cudaGraph_t  = void*;
+using cudaGraphExec_t = void*;
 
 enum struct cudaError_t {cudaSuccess, cudaErrorNonGpuBuild};
 using cudaError = cudaError_t;
@@ -39,6 +43,20 @@ inline auto cudaStreamSynchronize(cudaStream_t stream) {
   return cudaError_t::cudaErrorNonGpuBuild;
 }
 
+auto constexpr cudaStreamNonBlocking = 0x01;
+
+inline auto cudaStreamCreateWithFlags(cudaStream_t* stream, unsigned int flags) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaStreamDestroy(cudaStream_t stream) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaSetDevice(int device_id) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
 inline auto cudaGetDevice(int* device_id) {
   return cudaError_t::cudaErrorNonGpuBuild;
 }
@@ -47,6 +65,76 @@ inline auto cudaGetDeviceCount(int* count) {
   return cudaError_t::cudaErrorNonGpuBuild;
 }
 
+auto constexpr cudaEventDisableTiming = 0x02;
+
+inline auto cudaEventCreateWithFlags(cudaEvent_t* event, unsigned int flags) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaEventDestroy(cudaEvent_t event) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaEventRecord(cudaEvent_t event, cudaStream_t stream = nullptr) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaEventQuery(cudaEvent_t event) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaEventSynchronize(cudaEvent_t event) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaStreamWaitEvent(cudaStream_t stream, cudaEvent_t event, unsigned int flags = 0) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaEventElapsedTime(float* ms, cudaEvent_t start, cudaEvent_t end) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+enum cudaStreamCaptureMode {
+  cudaStreamCaptureModeGlobal,
+  cudaStreamCaptureModeThreadLocal,
+  cudaStreamCaptureModeRelaxed
+};
+
+inline auto cudaStreamBeginCapture(cudaStream_t stream, cudaStreamCaptureMode mode) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaStreamEndCapture(cudaStream_t stream, cudaGraph_t* graph) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaGraphInstantiateWithFlags(cudaGraphExec_t* exec,
+                                          cudaGraph_t graph,
+                                          unsigned long long flags) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaGraphLaunch(cudaGraphExec_t exec, cudaStream_t stream) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaGraphDestroy(cudaGraph_t graph) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaGraphExecDestroy(cudaGraphExec_t exec) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaMallocHost(void** ptr, std::size_t size) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
+inline auto cudaFreeHost(void* ptr) {
+  return cudaError_t::cudaErrorNonGpuBuild;
+}
+
 
 }  // namespace rapids
 }  // namespace backend
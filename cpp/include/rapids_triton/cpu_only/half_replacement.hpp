@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+/* Allow half-precision types to be named as rapids::__half in both GPU and
+ * non-GPU builds */
+using ::__half;
+using ::__nv_bfloat16;
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
+#else
+#include <cstdint>
+#include <cstring>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+inline auto float_bits(float value)
+{
+  auto result = std::uint32_t{};
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+inline auto bits_float(std::uint32_t bits)
+{
+  auto result = float{};
+  std::memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+// Round-to-nearest-even conversion from float to IEEE binary16
+inline std::uint16_t float_to_half_bits(float value)
+{
+  auto bits     = float_bits(value);
+  auto sign     = (bits >> 16) & 0x8000u;
+  auto exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+  auto mantissa = bits & 0x7fffffu;
+
+  auto result = std::uint32_t{};
+  if (exponent == 0xff - 127 + 15) {
+    // Infinity or NaN
+    result = sign | 0x7c00u | (mantissa != 0 ? 0x200u : 0u);
+  } else if (exponent >= 0x1f) {
+    result = sign | 0x7c00u;
+  } else if (exponent <= 0) {
+    // Subnormal half, or zero if too small to represent
+    result = sign;
+    if (exponent >= -10) {
+      mantissa |= 0x800000u;
+      auto shift     = 14 - exponent;
+      auto remainder = mantissa & ((1u << shift) - 1);
+      auto halfway   = 1u << (shift - 1);
+      result |= mantissa >> shift;
+      if (remainder > halfway || (remainder == halfway && (result & 1u))) { ++result; }
+    }
+  } else {
+    auto remainder = mantissa & 0x1fffu;
+    result         = sign | (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+    // A carry out of the mantissa correctly rounds up to the next exponent
+    if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1u))) { ++result; }
+  }
+  return static_cast<std::uint16_t>(result);
+}
+
+inline float half_bits_to_float(std::uint16_t bits)
+{
+  auto sign     = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+  auto exponent = static_cast<std::uint32_t>((bits >> 10) & 0x1fu);
+  auto mantissa = static_cast<std::uint32_t>(bits & 0x3ffu);
+
+  auto result = sign;
+  if (exponent == 0x1fu) {
+    result |= 0x7f800000u | (mantissa << 13);
+  } else if (exponent != 0) {
+    result |= ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  } else if (mantissa != 0) {
+    // Normalize subnormal half
+    auto shift = std::uint32_t{};
+    while ((mantissa & 0x400u) == 0) {
+      mantissa <<= 1;
+      ++shift;
+    }
+    result |= ((127 - 14 - shift) << 23) | ((mantissa & 0x3ffu) << 13);
+  }
+  return bits_float(result);
+}
+
+// Round-to-nearest-even conversion from float to bfloat16
+inline std::uint16_t float_to_bfloat16_bits(float value)
+{
+  auto bits   = float_bits(value);
+  auto result = std::uint32_t{};
+  if ((bits & 0x7fffffffu) > 0x7f800000u) {
+    // Preserve NaN rather than rounding it to infinity
+    result = (bits >> 16) | 0x40u;
+  } else {
+    result = (bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16;
+  }
+  return static_cast<std::uint16_t>(result);
+}
+
+inline float bfloat16_bits_to_float(std::uint16_t bits)
+{
+  return bits_float(static_cast<std::uint32_t>(bits) << 16);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Host-only stand-in for CUDA's __half in non-GPU builds
+ *
+ * Like __half, this type is stored as IEEE binary16 and converts implicitly
+ * to and from float.
+ */
+struct __half {
+  __half() = default;
+  __half(float value) : __x{detail::float_to_half_bits(value)} {}
+  operator float() const { return detail::half_bits_to_float(__x); }
+
+  std::uint16_t __x;
+};
+
+/** Host-only stand-in for CUDA's __nv_bfloat16 in non-GPU builds */
+struct __nv_bfloat16 {
+  __nv_bfloat16() = default;
+  __nv_bfloat16(float value) : __x{detail::float_to_bfloat16_bits(value)} {}
+  operator float() const { return detail::bfloat16_bits_to_float(__x); }
+
+  std::uint16_t __x;
+};
+
+inline auto __float2half(float value) { return __half{value}; }
+inline auto __half2float(__half value) { return static_cast<float>(value); }
+inline auto __float2bfloat16(float value) { return __nv_bfloat16{value}; }
+inline auto __bfloat162float(__nv_bfloat16 value) { return static_cast<float>(value); }
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
+#endif
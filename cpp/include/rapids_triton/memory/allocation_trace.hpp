@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <signal.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/** The purpose for which memory was allocated */
+enum struct allocation_site : std::size_t {
+  input,       // Collection, conversion and staging of inputs
+  output,      // Storage for outputs and their copies into responses
+  scratch,     // Batch::scratch storage requested by predict
+  model_load,  // Loading a model or one of its instances
+  other        // Any allocation made outside the above
+};
+auto constexpr allocation_site_count = std::size_t{5};
+
+/** The kind of memory allocated */
+enum struct allocation_location : std::size_t { host, pinned, device, managed };
+auto constexpr allocation_location_count = std::size_t{4};
+
+inline auto const* allocation_site_name(allocation_site site)
+{
+  auto static constexpr names = std::array<char const*, allocation_site_count>{
+    "input", "output", "scratch", "model_load", "other"};
+  return names[static_cast<std::size_t>(site)];
+}
+
+inline auto const* allocation_location_name(allocation_location location)
+{
+  auto static constexpr names =
+    std::array<char const*, allocation_location_count>{"host", "pinned", "device", "managed"};
+  return names[static_cast<std::size_t>(location)];
+}
+
+namespace detail {
+/* Incremented by the trace dump signal handler; each trace remembers the
+ * last value it reported */
+inline auto& trace_dump_requests()
+{
+  static auto requests = std::atomic<unsigned>{};
+  return requests;
+}
+
+/* Install a SIGUSR1 handler requesting a dump of every allocation trace,
+ * unless the process already handles that signal */
+inline void install_trace_dump_handler()
+{
+  static auto once = std::once_flag{};
+  std::call_once(once, []() {
+    trace_dump_requests();
+    struct sigaction current {};
+    if (sigaction(SIGUSR1, nullptr, &current) == 0 && current.sa_handler == SIG_DFL) {
+      struct sigaction handler {};
+      handler.sa_handler = [](int) {
+        trace_dump_requests().fetch_add(1, std::memory_order_relaxed);
+      };
+      sigemptyset(&handler.sa_mask);
+      handler.sa_flags = SA_RESTART;
+      sigaction(SIGUSR1, &handler, nullptr);
+    }
+  });
+}
+}  // namespace detail
+
+/**
+ * @brief A record of the allocations made by a model, used to size memory
+ * pools and budgets from real traffic
+ *
+ * For each site and kind of memory, a trace counts allocations and keeps
+ * histograms of their sizes and lifetimes; bucket i of each histogram counts
+ * values of at most 2^i bytes or microseconds. It also counts allocations
+ * made on each stream, tracks the bytes live at once, and keeps a timeline of
+ * the peak bytes live during each window of the given length, retaining at
+ * most max_windows windows. Sending SIGUSR1 to the process (if it does not
+ * otherwise handle that signal) requests a report from every trace, which
+ * is checked with dump_requested.
+ */
+struct allocation_trace {
+  using clock                        = std::chrono::steady_clock;
+  static auto constexpr bucket_count = std::size_t{48};
+
+  explicit allocation_trace(std::string label,
+                            clock::duration window  = std::chrono::seconds{1},
+                            std::size_t max_windows = std::size_t{3600})
+    : label_{std::move(label)},
+      window_{window},
+      max_windows_{std::max(max_windows, std::size_t{1})},
+      start_{clock::now()},
+      stats_{},
+      streams_{},
+      live_bytes_{},
+      peak_bytes_{},
+      timeline_{},
+      reported_requests_{},
+      lock_{}
+  {
+    detail::install_trace_dump_handler();
+    reported_requests_ = detail::trace_dump_requests().load(std::memory_order_relaxed);
+  }
+
+  allocation_trace(allocation_trace const& other) = delete;
+  allocation_trace& operator=(allocation_trace const& other) = delete;
+
+  auto const& label() const noexcept { return label_; }
+
+  /** Record an allocation, returning the time at which it was made */
+  auto allocate(allocation_site site,
+                allocation_location location,
+                std::size_t bytes,
+                cudaStream_t stream)
+  {
+    auto now   = clock::now();
+    auto lock  = std::lock_guard<std::mutex>{lock_};
+    auto& stat = stats_[index(site, location)];
+    ++stat.count;
+    stat.bytes += bytes;
+    stat.live_bytes += bytes;
+    stat.peak_bytes = std::max(stat.peak_bytes, stat.live_bytes);
+    stat.sizes.observe(bytes);
+    ++streams_[stream];
+    live_bytes_ += bytes;
+    peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+    sample_locked(now);
+    return now;
+  }
+
+  /** Record the release of an allocation made at the given time */
+  void deallocate(allocation_site site,
+                  allocation_location location,
+                  std::size_t bytes,
+                  clock::time_point allocated) noexcept
+  {
+    auto now      = clock::now();
+    auto lifetime = std::chrono::duration_cast<std::chrono::microseconds>(now - allocated);
+    auto lock     = std::lock_guard<std::mutex>{lock_};
+    auto& stat    = stats_[index(site, location)];
+    stat.live_bytes -= bytes;
+    stat.lifetimes.observe(
+      static_cast<std::uint64_t>(std::max(lifetime.count(), decltype(lifetime)::rep{})));
+    live_bytes_ -= bytes;
+    sample_locked(now);
+  }
+
+  /** Number of allocations recorded for the given site and kind of memory */
+  auto allocation_count(allocation_site site, allocation_location location) const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return stats_[index(site, location)].count;
+  }
+  /** Bytes currently allocated */
+  auto live_bytes() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return live_bytes_;
+  }
+  /** Largest number of bytes ever allocated at once */
+  auto peak_bytes() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return peak_bytes_;
+  }
+
+  /** Return whether a report has been requested by signal since the last
+   * call */
+  auto dump_requested() noexcept
+  {
+    auto requests = detail::trace_dump_requests().load(std::memory_order_relaxed);
+    auto lock     = std::lock_guard<std::mutex>{lock_};
+    return std::exchange(reported_requests_, requests) != requests;
+  }
+
+  /** A human-readable summary of all allocations recorded so far */
+  std::string report() const
+  {
+    auto lock   = std::lock_guard<std::mutex>{lock_};
+    auto result = std::ostringstream{};
+    result << "Allocation trace for " << label_ << ": " << live_bytes_ << " bytes live, "
+           << peak_bytes_ << " bytes peak\n";
+    for (auto site = std::size_t{}; site < allocation_site_count; ++site) {
+      for (auto location = std::size_t{}; location < allocation_location_count; ++location) {
+        auto const& stat = stats_[site * allocation_location_count + location];
+        if (stat.count == 0) { continue; }
+        result << "  " << allocation_site_name(static_cast<allocation_site>(site)) << " "
+               << allocation_location_name(static_cast<allocation_location>(location)) << ": "
+               << stat.count << " allocations, " << stat.bytes << " bytes, " << stat.peak_bytes
+               << " bytes peak\n";
+        result << "    size (bytes):";
+        stat.sizes.write(result);
+        result << "\n    lifetime (us):";
+        stat.lifetimes.write(result);
+        result << "\n";
+      }
+    }
+    result << "  streams:";
+    for (auto const& [stream, count] : streams_) {
+      result << " " << static_cast<void const*>(stream) << "=" << count;
+    }
+    auto window_ms = std::chrono::duration_cast<std::chrono::milliseconds>(window_).count();
+    result << "\n  peak bytes per " << window_ms << " ms window:";
+    for (auto const& entry : timeline_) {
+      result << " +"
+             << std::chrono::duration_cast<std::chrono::milliseconds>(entry.first - start_).count()
+             << "ms=" << entry.second;
+    }
+    return result.str();
+  }
+
+ private:
+  struct histogram {
+    std::array<std::uint64_t, bucket_count> counts{};
+
+    void observe(std::uint64_t value)
+    {
+      auto bucket = std::size_t{};
+      while (bucket + 1 < bucket_count && (std::uint64_t{1} << bucket) < value) {
+        ++bucket;
+      }
+      ++counts[bucket];
+    }
+
+    /* Write the non-empty buckets as "<=bound:count" */
+    void write(std::ostream& out) const
+    {
+      for (auto bucket = std::size_t{}; bucket < bucket_count; ++bucket) {
+        if (counts[bucket] != 0) {
+          out << " <=" << (std::uint64_t{1} << bucket) << ":" << counts[bucket];
+        }
+      }
+    }
+  };
+
+  struct site_stats {
+    std::uint64_t count{};
+    std::uint64_t bytes{};
+    std::size_t live_bytes{};
+    std::size_t peak_bytes{};
+    histogram sizes{};
+    histogram lifetimes{};
+  };
+
+  std::string label_;
+  clock::duration window_;
+  std::size_t max_windows_;
+  clock::time_point start_;
+  std::array<site_stats, allocation_site_count * allocation_location_count> stats_;
+  std::map<cudaStream_t, std::uint64_t> streams_;
+  std::size_t live_bytes_;
+  std::size_t peak_bytes_;
+  // The start of each window and the peak bytes live during it
+  std::deque<std::pair<clock::time_point, std::size_t>> timeline_;
+  unsigned reported_requests_;
+  std::mutex mutable lock_;
+
+  static std::size_t index(allocation_site site, allocation_location location)
+  {
+    return static_cast<std::size_t>(site) * allocation_location_count +
+           static_cast<std::size_t>(location);
+  }
+
+  // Must be called with lock_ held
+  void sample_locked(clock::time_point now)
+  {
+    if (timeline_.empty() || now - timeline_.back().first >= window_) {
+      auto windows = (now - start_) / window_;
+      timeline_.emplace_back(start_ + windows * window_, live_bytes_);
+      if (timeline_.size() > max_windows_) { timeline_.pop_front(); }
+    } else {
+      timeline_.back().second = std::max(timeline_.back().second, live_bytes_);
+    }
+  }
+};
+
+namespace detail {
+inline auto& current_allocation_trace()
+{
+  thread_local auto trace = std::shared_ptr<allocation_trace>{};
+  return trace;
+}
+
+inline auto& current_allocation_site()
+{
+  thread_local auto site = std::optional<allocation_site>{};
+  return site;
+}
+}  // namespace detail
+
+/**
+ * @brief Record allocations made by Buffers on this thread in the given
+ * trace for the lifetime of this object
+ *
+ * A null trace leaves allocations untraced.
+ */
+struct scoped_allocation_trace {
+  explicit scoped_allocation_trace(std::shared_ptr<allocation_trace> trace)
+    : previous_{std::exchange(detail::current_allocation_trace(), std::move(trace))}
+  {
+  }
+  scoped_allocation_trace(scoped_allocation_trace const& other) = delete;
+  scoped_allocation_trace& operator=(scoped_allocation_trace const& other) = delete;
+  ~scoped_allocation_trace() { detail::current_allocation_trace() = std::move(previous_); }
+
+ private:
+  std::shared_ptr<allocation_trace> previous_;
+};
+
+/**
+ * @brief Attribute allocations made on this thread to the given site for the
+ * lifetime of this object
+ *
+ * The outermost scope takes precedence, so that e.g. scratch storage used
+ * while collecting an input is attributed to the input.
+ */
+struct scoped_allocation_site {
+  explicit scoped_allocation_site(allocation_site site)
+    : previous_{detail::current_allocation_site()}
+  {
+    if (!previous_) { detail::current_allocation_site() = site; }
+  }
+  scoped_allocation_site(scoped_allocation_site const& other) = delete;
+  scoped_allocation_site& operator=(scoped_allocation_site const& other) = delete;
+  ~scoped_allocation_site() { detail::current_allocation_site() = previous_; }
+
+ private:
+  std::optional<allocation_site> previous_;
+};
+
+namespace detail {
+/**
+ * @brief An allocation recorded in the trace current on the allocating
+ * thread, whose release is recorded when this object is destroyed
+ */
+struct traced_allocation {
+  traced_allocation() noexcept : trace_{}, site_{}, location_{}, bytes_{}, allocated_{} {}
+  traced_allocation(allocation_location location, std::size_t bytes, cudaStream_t stream)
+    : trace_{current_allocation_trace()},
+      site_{current_allocation_site().value_or(allocation_site::other)},
+      location_{location},
+      bytes_{bytes},
+      allocated_{}
+  {
+    if (trace_ && bytes_ != 0) {
+      allocated_ = trace_->allocate(site_, location_, bytes_, stream);
+    } else {
+      trace_.reset();
+    }
+  }
+  traced_allocation(traced_allocation&& other) noexcept
+    : trace_{std::move(other.trace_)},
+      site_{other.site_},
+      location_{other.location_},
+      bytes_{other.bytes_},
+      allocated_{other.allocated_}
+  {
+    other.trace_.reset();
+  }
+  traced_allocation& operator=(traced_allocation&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      trace_     = std::move(other.trace_);
+      site_      = other.site_;
+      location_  = other.location_;
+      bytes_     = other.bytes_;
+      allocated_ = other.allocated_;
+      other.trace_.reset();
+    }
+    return *this;
+  }
+  traced_allocation(traced_allocation const& other) = delete;
+  traced_allocation& operator=(traced_allocation const& other) = delete;
+  ~traced_allocation() { reset(); }
+
+ private:
+  std::shared_ptr<allocation_trace> trace_;
+  allocation_site site_;
+  allocation_location location_;
+  std::size_t bytes_;
+  allocation_trace::clock::time_point allocated_;
+
+  void reset() noexcept
+  {
+    if (trace_) {
+      trace_->deallocate(site_, location_, bytes_, allocated_);
+      trace_.reset();
+    }
+  }
+};
+}  // namespace detail
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -18,24 +18,31 @@
 #include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 #include <variant>
 
 #ifdef TRITON_ENABLE_GPU
 #include <cuda_runtime_api.h>
 #include <rapids_triton/memory/detail/gpu_only/copy.hpp>
 #include <rapids_triton/memory/detail/gpu_only/owned_device_buffer.hpp>
+#include <rapids_triton/memory/detail/gpu_only/owned_managed_buffer.hpp>
 #else
 #include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
 #include <rapids_triton/memory/detail/cpu_only/copy.hpp>
 #include <rapids_triton/memory/detail/cpu_only/owned_device_buffer.hpp>
+#include <rapids_triton/memory/detail/cpu_only/owned_managed_buffer.hpp>
 #endif
 
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/inline_host_buffer.hpp>
+#include <rapids_triton/memory/detail/owned_host_buffer.hpp>
 #include <rapids_triton/memory/resource.hpp>
 #include <rapids_triton/memory/types.hpp>
 #include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/cuda_event.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
 
 namespace triton {
 namespace backend {
@@ -45,19 +52,33 @@ struct Buffer {
   using size_type  = std::size_t;
   using value_type = T;
 
-  using h_buffer       = T*;
-  using d_buffer       = T*;
-  using owned_h_buffer = std::unique_ptr<T[]>;
-  using owned_d_buffer = detail::owned_device_buffer<T, IS_GPU_BUILD>;
-  using data_store = std::variant<h_buffer, d_buffer, owned_h_buffer, owned_d_buffer>;
+  using h_buffer        = T*;
+  using d_buffer        = T*;
+  using owned_h_buffer  = detail::owned_host_buffer<T>;
+  using owned_d_buffer  = detail::owned_device_buffer<T, IS_GPU_BUILD>;
+  using p_buffer        = T*;
+  using owned_p_buffer  = detail::owned_host_buffer<T>;
+  using owned_m_buffer  = detail::owned_managed_buffer<T, IS_GPU_BUILD>;
+  using inline_h_buffer = detail::inline_host_buffer<T>;
+  using data_store      = std::variant<h_buffer,
+                                       d_buffer,
+                                       owned_h_buffer,
+                                       owned_d_buffer,
+                                       p_buffer,
+                                       owned_p_buffer,
+                                       owned_m_buffer,
+                                       inline_h_buffer>;
 
   Buffer() noexcept : device_{}, data_{std::in_place_index<0>, nullptr}, size_{}, stream_{} {}
 
   /**
-   * @brief Construct buffer of given size in given memory location (either
-   * on host or on device)
+   * @brief Construct buffer of given size in given memory location (on
+   * host, in pinned host memory, or on device)
    * A buffer constructed in this way is owning and will release allocated
-   * resources on deletion
+   * resources on deletion. In non-GPU builds, pinned memory cannot be
+   * allocated, and a request for it yields ordinary host memory. A host
+   * buffer of only a few elements is stored within the Buffer object itself
+   * rather than allocated, so its data pointer changes if it is moved.
    */
   Buffer(size_type size,
          MemoryType memory_type = DeviceMemory,
@@ -94,6 +115,8 @@ struct Buffer {
         auto result = data_store{};
         if (memory_type == HostMemory) {
           result = data_store{std::in_place_index<0>, input_data};
+        } else if (memory_type == PinnedMemory) {
+          result = data_store{std::in_place_index<4>, input_data};
         } else {
           if constexpr (!IS_GPU_BUILD) {
             throw TritonException(
@@ -120,7 +143,7 @@ struct Buffer {
     : device_{device},
       data_([&other, &memory_type, &device]() {
         auto result = allocate(other.size_, device, memory_type, other.stream_);
-        copy(result, other.data_, other.size_, other.stream_);
+        copy(result, other.data_, other.size_, other.stream_, device, other.device_);
         return result;
       }()),
       size_{other.size_},
@@ -141,8 +164,8 @@ struct Buffer {
         if (memory_type == other.mem_type()) {
           result = std::move(other.data_);
         } else {
-          result = allocate(other.size_, memory_type, other.device(), other.stream());
-          copy(result, other.data_, other.size_, other.stream_);
+          result = allocate(other.size_, other.device(), memory_type, other.stream());
+          copy(result, other.data_, other.size_, other.stream_, other.device_, other.device_);
         }
         return result;
       }()},
@@ -151,6 +174,23 @@ struct Buffer {
   {
   }
 
+  /**
+   * @brief Construct an owning buffer of given size in managed (unified)
+   * memory associated with the given device
+   *
+   * Managed memory may exceed the memory free on the device, so it is not
+   * charged to the device's memory budget; pages migrate between host and
+   * device on demand. The buffer reports DeviceMemory and can be used
+   * wherever a device buffer can, but pages which have not been prefetched
+   * (see `rapids_triton/memory/managed.hpp`) are slower to access.
+   */
+  static auto managed(size_type size, device_id_t device = 0, cudaStream_t stream = 0)
+  {
+    auto range = nvtx_range{"Managed buffer allocation: ", size * sizeof(T), " bytes"};
+    auto data  = data_store{std::in_place_index<6>, device, size, stream};
+    return Buffer<T>{std::move(data), size, device, stream};
+  }
+
   Buffer(Buffer<T>&& other) = default;
 
   Buffer<T>& operator=(Buffer<T>&& other) = default;
@@ -158,9 +198,10 @@ struct Buffer {
   ~Buffer() {}
 
   /**
-   * @brief Return where memory for this buffer is located (host or device)
+   * @brief Return where memory for this buffer is located (host, pinned
+   * host, or device)
    */
-  auto mem_type() const noexcept { return data_.index() % 2 == 0 ? HostMemory : DeviceMemory; }
+  auto mem_type() const noexcept { return get_mem_type(data_); }
 
   /**
    * @brief Return number of elements in buffer
@@ -172,8 +213,21 @@ struct Buffer {
    */
   auto* data() const noexcept { return get_raw_ptr(data_); }
 
+  /**
+   * @brief Return whether this buffer owns managed memory
+   */
+  auto is_managed() const noexcept { return data_.index() == 6; }
+
   auto device() const noexcept { return device_; }
 
+  /**
+   * @brief Return an owning copy of this buffer's data on the given device
+   *
+   * If this buffer is already on a different device, data are copied
+   * between devices directly with peer access enabled where supported.
+   */
+  auto to_device(device_id_t device) const { return Buffer<T>(*this, DeviceMemory, device); }
+
   /**
    * @brief Return CUDA stream associated with this buffer
    */
@@ -187,14 +241,27 @@ struct Buffer {
   /**
    * @brief Set CUDA stream for this buffer to new value
    *
-   * @warning This method calls cudaStreamSynchronize on the old stream
-   * before updating. Be aware of performance implications and try to avoid
-   * interactions between buffers on different streams where possible.
+   * This method does not block the host. An event is recorded on the old
+   * stream, and the new stream waits on it, so work subsequently enqueued on
+   * the new stream is ordered after all work already enqueued on the old
+   * one. Memory owned by this buffer is released in stream order on the new
+   * stream. Host code which reads or writes the buffer directly must still
+   * synchronize with the new stream first.
    */
   void set_stream(cudaStream_t new_stream)
   {
-    stream_synchronize();
+    if (new_stream == stream_) { return; }
+    if constexpr (IS_GPU_BUILD) {
+      auto handoff = cuda_event{};
+      handoff.record(stream_);
+      handoff.wait(new_stream);
+    }
     stream_ = new_stream;
+    switch (data_.index()) {
+      case 2: std::get<2>(data_).set_stream(new_stream); break;
+      case 3: std::get<3>(data_).set_stream(new_stream); break;
+      case 5: std::get<5>(data_).set_stream(new_stream); break;
+    }
   }
 
  private:
@@ -203,6 +270,11 @@ struct Buffer {
   size_type size_;
   cudaStream_t stream_;
 
+  Buffer(data_store&& data, size_type size, device_id_t device, cudaStream_t stream)
+    : device_{device}, data_{std::move(data)}, size_{size}, stream_{stream}
+  {
+  }
+
   // Helper function for accessing raw pointer to underlying data of
   // data_store
   static auto* get_raw_ptr(data_store const& ptr) noexcept
@@ -215,6 +287,24 @@ struct Buffer {
       case 1: result = std::get<1>(ptr); break;
       case 2: result = std::get<2>(ptr).get(); break;
       case 3: result = std::get<3>(ptr).get(); break;
+      case 4: result = std::get<4>(ptr); break;
+      case 5: result = std::get<5>(ptr).get(); break;
+      case 6: result = std::get<6>(ptr).get(); break;
+      case 7: result = std::get<7>(ptr).get(); break;
+    }
+    return result;
+  }
+
+  // Helper function for determining the memory type of data_store
+  static auto get_mem_type(data_store const& ptr) noexcept
+  {
+    auto result = HostMemory;
+    switch (ptr.index()) {
+      case 1:
+      case 3:
+      case 6: result = DeviceMemory; break;
+      case 4:
+      case 5: result = PinnedMemory; break;
     }
     return result;
   }
@@ -225,20 +315,25 @@ struct Buffer {
                        MemoryType memory_type = DeviceMemory,
                        cudaStream_t stream    = 0)
   {
+    auto range  = nvtx_range{"Buffer allocation: ", size * sizeof(T), " bytes"};
     auto result = data_store{};
     if (memory_type == DeviceMemory) {
       if constexpr (IS_GPU_BUILD) {
-        result = data_store{owned_d_buffer{
-          device,
-          size,
-          stream,
-        }};
+        result = data_store{std::in_place_index<3>, device, size, stream};
       } else {
         throw TritonException(Error::Internal,
                               "DeviceMemory requested in CPU-only build of FIL backend");
       }
+    } else if (IS_GPU_BUILD && memory_type == PinnedMemory) {
+      // A pooled host resource built on pinned memory is used if configured
+      // so that pinned allocations are reused as well
+      auto* mr = detail::get_host_memory_resource();
+      if (!mr->is_pinned()) { mr = detail::get_host_resources().get_pinned_resource(); }
+      result = data_store{std::in_place_index<5>, size, stream, mr};
+    } else if (inline_h_buffer::fits(size)) {
+      result = data_store{std::in_place_index<7>};
     } else {
-      result = std::make_unique<T[]>(size);
+      result = data_store{std::in_place_index<2>, size, stream};
     }
     return result;
   }
@@ -246,7 +341,12 @@ struct Buffer {
   // Helper function for copying memory in constructors, where there are
   // stronger guarantees on conditions that would otherwise need to be
   // checked
-  static void copy(data_store const& dst, data_store const& src, size_type len, cudaStream_t stream)
+  static void copy(data_store const& dst,
+                   data_store const& src,
+                   size_type len,
+                   cudaStream_t stream,
+                   device_id_t dst_device,
+                   device_id_t src_device)
   {
     // This function will only be called in constructors, so we allow a
     // const_cast here to perform the initial copy of data from a
@@ -254,10 +354,14 @@ struct Buffer {
     auto raw_dst = const_cast<std::remove_const_t<T>*>(get_raw_ptr(dst));
     auto raw_src = get_raw_ptr(src);
 
-    auto dst_mem_type = dst.index() % 2 == 0 ? HostMemory : DeviceMemory;
-    auto src_mem_type = src.index() % 2 == 0 ? HostMemory : DeviceMemory;
-
-    detail::copy(raw_dst, raw_src, len, stream, dst_mem_type, src_mem_type);
+    detail::copy(raw_dst,
+                 raw_src,
+                 len,
+                 stream,
+                 get_mem_type(dst),
+                 get_mem_type(src),
+                 dst_device,
+                 src_device);
   }
 };
 
@@ -280,16 +384,31 @@ void copy(Buffer<T>& dst,
           typename Buffer<U>::size_type src_begin,
           typename Buffer<U>::size_type src_end)
 {
-  if (dst.stream() != src.stream()) { dst.set_stream(src.stream()); }
+  if (dst.stream() != src.stream()) {
+    // Copies between host buffers are performed by the calling thread, so
+    // they cannot be ordered with respect to dst's stream by an event
+    if (is_host_memory(dst.mem_type()) && is_host_memory(src.mem_type())) {
+      dst.stream_synchronize();
+    }
+    dst.set_stream(src.stream());
+  }
   auto len = src_end - src_begin;
   if (len < 0 || src_end > src.size() || len > dst.size() - dst_begin) {
     throw TritonException(Error::Internal, "bad copy between buffers");
   }
 
+  auto range   = nvtx_range{"Buffer copy: ", len * sizeof(U), " bytes"};
   auto raw_dst = dst.data() + dst_begin;
   auto raw_src = src.data() + src_begin;
 
-  detail::copy(raw_dst, raw_src, len, dst.stream(), dst.mem_type(), src.mem_type());
+  detail::copy(raw_dst,
+               raw_src,
+               len,
+               dst.stream(),
+               dst.mem_type(),
+               src.mem_type(),
+               dst.device(),
+               src.device());
 }
 
 template <typename T, typename U>
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+namespace triton {
+namespace backend {
+namespace rapids {
+/**
+ * @brief The format in which each row of a compressed input is compressed
+ *
+ * LZ4 rows are raw LZ4 blocks, as produced by LZ4_compress_default. Zstandard
+ * rows are single frames, as produced by ZSTD_compress.
+ */
+enum struct compression_codec { lz4, zstd };
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
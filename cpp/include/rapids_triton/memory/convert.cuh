@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __CUDACC__
+#error "rapids_triton/memory/convert.cuh must be compiled with a CUDA compiler"
+#endif
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/convert.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+template <typename T, typename U>
+__global__ void convert_kernel(T* __restrict__ dst, U const* __restrict__ src, std::size_t len)
+{
+  auto stride = std::size_t{blockDim.x} * gridDim.x;
+  for (auto i = std::size_t{blockIdx.x} * blockDim.x + threadIdx.x; i < len; i += stride) {
+    dst[i] = static_cast<T>(src[i]);
+  }
+}
+
+template <typename T, typename U>
+void launch_convert(T* dst, U const* src, std::size_t len, cudaStream_t stream)
+{
+  auto constexpr threads_per_block = std::size_t{256};
+  auto constexpr max_blocks        = std::size_t{4096};
+  auto blocks = std::min((len + threads_per_block - 1) / threads_per_block, max_blocks);
+  convert_kernel<<<blocks, threads_per_block, 0, stream>>>(dst, src, len);
+  cuda_check(cudaPeekAtLastError());
+}
+
+}  // namespace detail
+
+/**
+ * @brief Convert device buffers of U to T with a kernel in every
+ * translation unit, including those compiled without a CUDA compiler
+ *
+ * Until this is called, such conversions throw, and
+ * `Batch::get_converted_input` converts device inputs on the host.
+ */
+template <typename T, typename U>
+void register_device_conversion()
+{
+  detail::set_device_launcher<detail::convert_kernel_tag, detail::convert_launcher<T, U>>(
+    &detail::launch_convert<T, U>);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <rapids_triton/memory/detail/gpu_only/convert.hpp>
+#else
+#include <rapids_triton/memory/detail/cpu_only/convert.hpp>
+#endif
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Convert the elements of one buffer to the element type of another
+ *
+ * Both buffers must be the same size and lie in the same memory location.
+ * Host buffers are converted by the calling thread; device buffers are
+ * converted by a kernel launched on dst's stream, which is only possible
+ * once the kernel for these types has been registered with
+ * `register_device_conversion` (see rapids_triton/memory/convert.cuh).
+ */
+template <typename T, typename U>
+void convert(Buffer<T>& dst, Buffer<U> const& src)
+{
+  if (dst.size() != src.size() ||
+      is_host_memory(dst.mem_type()) != is_host_memory(src.mem_type()) ||
+      (dst.mem_type() == DeviceMemory && dst.device() != src.device())) {
+    throw TritonException(Error::Internal, "bad conversion between buffers");
+  }
+  if (dst.stream() != src.stream()) {
+    if (is_host_memory(dst.mem_type())) { dst.stream_synchronize(); }
+    dst.set_stream(src.stream());
+  }
+  auto range = nvtx_range{"Buffer conversion: ", src.size(), " elements"};
+  detail::convert(dst.data(), src.data(), src.size(), dst.stream(), dst.mem_type());
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
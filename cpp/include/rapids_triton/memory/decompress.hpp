@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <rapids_triton/memory/detail/gpu_only/decompress.hpp>
+#else
+#include <rapids_triton/memory/detail/cpu_only/decompress.hpp>
+#endif
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+#include <rapids_triton/memory/detail/host_decompress.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/string_tensor.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Decompress each element of a host StringTensor, which holds one
+ * independently compressed row, into consecutive rows of row_bytes bytes
+ * of dst
+ *
+ * Device buffers are filled by a single batched nvCOMP call for all rows,
+ * which requires rapids_triton to be built with nvCOMP (see
+ * `detail::device_decompression_available`); this waits for the call to
+ * complete before checking the rows, whereas `Batch` decompresses with its
+ * scratch storage and checks the rows when it completes. Host buffers are
+ * filled by the calling thread together with the threads of the given
+ * pool, if any, which requires rapids_triton to be built with LZ4 and
+ * Zstandard (see `detail::host_decompression_available`). Rows which are
+ * malformed or do not decompress to exactly row_bytes bytes are rejected.
+ */
+inline void decompress_rows(Buffer<std::byte>& dst,
+                            StringTensor const& compressed,
+                            compression_codec codec,
+                            std::size_t row_bytes,
+                            thread_pool* pool = nullptr)
+{
+  auto rows = compressed.size();
+  if (dst.size() != rows * row_bytes || !is_host_memory(compressed.mem_type())) {
+    throw TritonException(Error::Internal, "bad decompression of compressed rows");
+  }
+  auto range = nvtx_range{"decompress: ", rows, " rows"};
+  if (!is_host_memory(dst.mem_type())) {
+    auto storage      = detail::device_decompression_storage(codec, row_bytes, compressed);
+    auto host_storage = Buffer<std::byte>(storage.host_bytes, PinnedMemory, 0, dst.stream());
+    auto device_storage =
+      Buffer<std::byte>(storage.device_bytes, DeviceMemory, dst.device(), dst.stream());
+    auto pending = detail::device_decompress_rows(
+      codec, dst.data(), row_bytes, compressed, host_storage, device_storage, dst.stream());
+    dst.stream_synchronize();
+    pending.check();
+    return;
+  }
+  dst.stream_synchronize();
+  auto const* offsets = compressed.offsets().data();
+  auto const* chars   = compressed.chars().data();
+  auto decompress     = [&](std::size_t begin, std::size_t end) {
+    for (auto row = begin; row < end; ++row) {
+      auto size = detail::host_decompress(codec,
+                                          dst.data() + row * row_bytes,
+                                          row_bytes,
+                                          chars + offsets[row],
+                                          offsets[row + 1] - offsets[row]);
+      if (size != row_bytes) {
+        throw TritonException(Error::InvalidArg,
+                              "row " + std::to_string(row) + " of compressed input does not hold " +
+                                std::to_string(row_bytes) + " bytes of data");
+      }
+    }
+  };
+  if (pool == nullptr) {
+    decompress(std::size_t{}, rows);
+  } else {
+    pool->parallel_for(std::size_t{}, rows, decompress);
+  }
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -16,13 +16,14 @@
 
 #pragma once
 #include <cstddef>
-#include <cstring>
 
 #ifndef TRITON_ENABLE_GPU
 #include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
 #endif
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/host_copy.hpp>
 #include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/device.hpp>
 
 namespace triton {
 namespace backend {
@@ -40,10 +41,23 @@ void copy(T* dst,
   if (dst_type == DeviceMemory || src_type == DeviceMemory) {
     throw TritonException(Error::Internal, "Cannot copy device memory in non-GPU build");
   } else {
-    std::memcpy(dst, src, len * sizeof(T));
+    host_copy(dst, src, len * sizeof(T));
   }
 }
 
+template <typename T>
+void copy(T* dst,
+          T const* src,
+          std::size_t len,
+          cudaStream_t stream,
+          MemoryType dst_type,
+          MemoryType src_type,
+          device_id_t dst_device,
+          device_id_t src_device)
+{
+  copy(dst, src, len, stream, dst_type, src_type);
+}
+
 }  // namespace detail
 }  // namespace rapids
 }  // namespace backend
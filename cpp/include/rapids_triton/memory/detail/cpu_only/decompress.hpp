@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cstddef>
+
+#ifndef TRITON_ENABLE_GPU
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+#include <rapids_triton/tensor/string_tensor.hpp>
+#include <rapids_triton/triton/device.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+auto constexpr device_decompression_available = false;
+
+struct decompression_storage {
+  std::size_t host_bytes;
+  std::size_t device_bytes;
+};
+
+struct pending_decompression {
+  void check() const {}
+};
+
+inline decompression_storage device_decompression_storage(compression_codec codec,
+                                                          std::size_t row_bytes,
+                                                          StringTensor const& compressed)
+{
+  throw TritonException(Error::Internal, "Cannot decompress to device memory in non-GPU build");
+}
+
+inline pending_decompression device_decompress_rows(compression_codec codec,
+                                                    std::byte* dst,
+                                                    std::size_t row_bytes,
+                                                    StringTensor const& compressed,
+                                                    Buffer<std::byte>& host_storage,
+                                                    Buffer<std::byte>& device_storage,
+                                                    cudaStream_t stream)
+{
+  throw TritonException(Error::Internal, "Cannot decompress to device memory in non-GPU build");
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
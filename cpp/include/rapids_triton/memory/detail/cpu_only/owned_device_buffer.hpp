@@ -37,6 +37,8 @@ struct owned_device_buffer<T, false> {
   }
 
   auto* get() const { return static_cast<T*>(nullptr); }
+
+  void set_stream(cudaStream_t stream) noexcept {}
 };
 
 }  // namespace detail
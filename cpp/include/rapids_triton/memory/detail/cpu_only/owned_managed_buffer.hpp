@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/owned_managed_buffer.hpp>
+#include <rapids_triton/triton/device.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+template<typename T>
+struct owned_managed_buffer<T, false> {
+  using non_const_T = std::remove_const_t<T>;
+  owned_managed_buffer(device_id_t device_id, std::size_t size, cudaStream_t stream)
+  {
+    throw TritonException(Error::Internal,
+                          "Attempted to use managed buffer in non-GPU build");
+  }
+
+  auto* get() const { return static_cast<T*>(nullptr); }
+
+  void set_stream(cudaStream_t stream) noexcept {}
+};
+
+inline void prefetch_managed(void const* data,
+                             std::size_t bytes,
+                             device_id_t device_id,
+                             cudaStream_t stream)
+{
+  throw TritonException(Error::Internal, "Attempted to prefetch memory in non-GPU build");
+}
+
+inline void advise_managed_read_mostly(void const* data, std::size_t bytes, device_id_t device_id)
+{
+  throw TritonException(Error::Internal, "Attempted to advise memory in non-GPU build");
+}
+
+inline void advise_managed_preferred_location(void const* data,
+                                              std::size_t bytes,
+                                              device_id_t device_id)
+{
+  throw TritonException(Error::Internal, "Attempted to advise memory in non-GPU build");
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -17,7 +17,9 @@
 #pragma once
 #include <triton/core/tritonbackend.h>
 
+#include <optional>
 #include <rapids_triton/memory/detail/resource.hpp>
+#include <rapids_triton/memory/pool_config.hpp>
 #include <rapids_triton/triton/device.hpp>
 
 namespace triton {
@@ -27,7 +29,8 @@ namespace detail {
 
 template<>
 inline void setup_memory_resource<false>(device_id_t device_id,
-                                         TRITONBACKEND_MemoryManager* triton_manager) { }
+                                         TRITONBACKEND_MemoryManager* triton_manager,
+                                         std::optional<pool_config> const& device_pool) { }
 
 }  // namespace detail
 }  // namespace rapids
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/host_convert.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* Device conversions are launched through launchers registered by
+ * rapids_triton/memory/convert.cuh */
+struct convert_kernel_tag {};
+template <typename T, typename U>
+using convert_launcher = void(T*, U const*, std::size_t, cudaStream_t);
+
+/** Whether device buffers of U can be converted to T on the device */
+template <typename T, typename U>
+auto device_conversion_available()
+{
+  return get_device_launcher<convert_kernel_tag, convert_launcher<T, U>>() != nullptr;
+}
+
+template <typename T, typename U>
+void convert(T* dst, U const* src, std::size_t len, cudaStream_t stream, MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_device_launcher<convert_kernel_tag, convert_launcher<T, U>>();
+    if (launch == nullptr) {
+      throw TritonException(Error::Internal,
+                            "Device conversion requires registering its kernel from a "
+                            "translation unit compiled with a CUDA compiler");
+    }
+    if (len != 0) { launch(dst, src, len, stream); }
+  } else {
+    host_convert(dst, src, len);
+  }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
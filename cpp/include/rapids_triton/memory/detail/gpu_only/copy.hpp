@@ -21,9 +21,11 @@
 #endif
 
 #include <cstddef>
-#include <cstring>
-#include <rapids_triton/memory/types.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/host_copy.hpp>
+#include <rapids_triton/memory/detail/gpu_only/peer_access.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/device.hpp>
 
 namespace triton {
 namespace backend {
@@ -45,7 +47,32 @@ void copy(T* dst,
       throw TritonException(Error::Internal, err.what());
     }
   } else {
-    std::memcpy(dst, src, len * sizeof(T));
+    host_copy(dst, src, len * sizeof(T));
+  }
+}
+
+/**
+ * @brief Copy between locations which may be on different devices
+ *
+ * Copies between two distinct devices are made with cudaMemcpyPeerAsync
+ * after enabling peer access between them, rather than relying on whichever
+ * device happens to be current.
+ */
+template <typename T>
+void copy(T* dst,
+          T const* src,
+          std::size_t len,
+          cudaStream_t stream,
+          MemoryType dst_type,
+          MemoryType src_type,
+          device_id_t dst_device,
+          device_id_t src_device)
+{
+  if (dst_type == DeviceMemory && src_type == DeviceMemory && dst_device != src_device) {
+    enable_peer_access(dst_device, src_device);
+    cuda_check(cudaMemcpyPeerAsync(dst, dst_device, src, src_device, len * sizeof(T), stream));
+  } else {
+    copy(dst, src, len, stream, dst_type, src_type);
   }
 }
 
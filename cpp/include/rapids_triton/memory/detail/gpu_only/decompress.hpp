@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cuda_runtime_api.h>
+#ifdef RAPIDS_TRITON_ENABLE_NVCOMP
+#include <nvcomp/lz4.h>
+#include <nvcomp/zstd.h>
+#endif
+
+#include <cstddef>
+#include <cstring>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+#include <rapids_triton/memory/detail/gpu_only/copy.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/string_tensor.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* The bytes of pinned host and device storage used by a batched device
+ * decompression */
+struct decompression_storage {
+  std::size_t host_bytes;
+  std::size_t device_bytes;
+};
+
+#ifdef RAPIDS_TRITON_ENABLE_NVCOMP
+auto constexpr device_decompression_available = true;
+
+inline void nvcomp_check(nvcompStatus_t status)
+{
+  if (status != nvcompSuccess) {
+    throw TritonException(Error::Internal, "nvCOMP error " + std::to_string(status));
+  }
+}
+
+/* Byte offsets of each array within the storage for a batched decompression
+ * of the given rows. The arrays which nvCOMP reads, including the compressed
+ * data, come first so that they are copied to the device at once, followed
+ * by those it writes, which are copied back at once. Only device storage
+ * holds nvCOMP's temporary storage, which comes last. */
+struct decompression_layout {
+  static auto constexpr alignment = std::size_t{256};
+
+  std::size_t compressed_ptrs;
+  std::size_t compressed_bytes;
+  std::size_t decompressed_ptrs;
+  std::size_t decompressed_bytes;
+  std::size_t chars;
+  std::size_t actual_bytes;
+  std::size_t statuses;
+  std::size_t temp;
+  std::size_t end;
+
+  decompression_layout(std::size_t rows, std::size_t chars_bytes, std::size_t temp_bytes)
+    : compressed_ptrs{},
+      compressed_bytes{align(compressed_ptrs + rows * sizeof(void const*))},
+      decompressed_ptrs{align(compressed_bytes + rows * sizeof(std::size_t))},
+      decompressed_bytes{align(decompressed_ptrs + rows * sizeof(void*))},
+      chars{align(decompressed_bytes + rows * sizeof(std::size_t))},
+      actual_bytes{align(chars + chars_bytes)},
+      statuses{align(actual_bytes + rows * sizeof(std::size_t))},
+      temp{align(statuses + rows * sizeof(nvcompStatus_t))},
+      end{temp + temp_bytes}
+  {
+  }
+
+ private:
+  static std::size_t align(std::size_t offset)
+  {
+    return ((offset + alignment - 1) / alignment) * alignment;
+  }
+};
+
+inline auto decompress_temp_bytes(compression_codec codec, std::size_t rows, std::size_t row_bytes)
+{
+  auto result = std::size_t{};
+  if (codec == compression_codec::lz4) {
+    nvcomp_check(nvcompBatchedLZ4DecompressGetTempSize(rows, row_bytes, &result));
+  } else {
+    nvcomp_check(nvcompBatchedZstdDecompressGetTempSize(rows, row_bytes, &result));
+  }
+  return result;
+}
+
+inline auto make_decompression_layout(compression_codec codec,
+                                      std::size_t row_bytes,
+                                      StringTensor const& compressed)
+{
+  auto rows = compressed.size();
+  return decompression_layout{
+    rows, compressed.chars().size(), decompress_temp_bytes(codec, rows, row_bytes)};
+}
+
+/* The bytes of pinned host and device storage required to decompress each
+ * row of compressed on the device */
+inline auto device_decompression_storage(compression_codec codec,
+                                         std::size_t row_bytes,
+                                         StringTensor const& compressed)
+{
+  if (compressed.size() == 0) { return decompression_storage{}; }
+  auto layout = make_decompression_layout(codec, row_bytes, compressed);
+  return decompression_storage{layout.temp, layout.end};
+}
+
+/* The outcome of each row of a batched decompression, which may only be
+ * checked once work on the stream on which it was enqueued is complete */
+struct pending_decompression {
+  std::size_t const* actual_bytes;
+  nvcompStatus_t const* statuses;
+  std::size_t rows;
+  std::size_t row_bytes;
+
+  void check() const
+  {
+    for (auto row = std::size_t{}; row < rows; ++row) {
+      if (statuses[row] != nvcompSuccess || actual_bytes[row] != row_bytes) {
+        throw TritonException(Error::InvalidArg,
+                              "row " + std::to_string(row) + " of compressed input does not hold " +
+                                std::to_string(row_bytes) + " bytes of data");
+      }
+    }
+  }
+};
+
+/* Decompress each element of a host StringTensor, which holds one
+ * compressed row, into consecutive rows of row_bytes bytes starting at dst
+ * on the device, using storage of at least the sizes given by
+ * device_decompression_storage. The metadata and compressed data are
+ * gathered in pinned host storage and copied to the device at once, all
+ * rows are decompressed by a single batched call, and the outcome of each
+ * row is copied back without waiting for it; the returned outcome must only
+ * be checked once work on the stream is complete. */
+inline auto device_decompress_rows(compression_codec codec,
+                                   std::byte* dst,
+                                   std::size_t row_bytes,
+                                   StringTensor const& compressed,
+                                   Buffer<std::byte>& host_storage,
+                                   Buffer<std::byte>& device_storage,
+                                   cudaStream_t stream)
+{
+  auto rows = compressed.size();
+  if (rows == 0) { return pending_decompression{nullptr, nullptr, rows, row_bytes}; }
+  auto layout = make_decompression_layout(codec, row_bytes, compressed);
+  if (host_storage.size() < layout.temp || device_storage.size() < layout.end ||
+      host_storage.mem_type() != PinnedMemory || device_storage.mem_type() != DeviceMemory) {
+    throw TritonException(Error::Internal, "bad storage for device decompression");
+  }
+  auto* host   = host_storage.data();
+  auto* device = device_storage.data();
+
+  auto const* offsets     = compressed.offsets().data();
+  auto compressed_ptrs    = reinterpret_cast<void const**>(host + layout.compressed_ptrs);
+  auto compressed_bytes   = reinterpret_cast<std::size_t*>(host + layout.compressed_bytes);
+  auto decompressed_ptrs  = reinterpret_cast<void**>(host + layout.decompressed_ptrs);
+  auto decompressed_bytes = reinterpret_cast<std::size_t*>(host + layout.decompressed_bytes);
+  auto const* chars       = device + layout.chars;
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    compressed_ptrs[row]    = chars + offsets[row];
+    compressed_bytes[row]   = offsets[row + 1] - offsets[row];
+    decompressed_ptrs[row]  = dst + row * row_bytes;
+    decompressed_bytes[row] = row_bytes;
+  }
+  std::memcpy(host + layout.chars, compressed.chars().data(), compressed.chars().size());
+  copy(device, host, layout.actual_bytes, stream, DeviceMemory, PinnedMemory);
+
+  auto decompress = (codec == compression_codec::lz4) ? nvcompBatchedLZ4DecompressAsync
+                                                      : nvcompBatchedZstdDecompressAsync;
+  auto* device_actual_bytes = reinterpret_cast<std::size_t*>(device + layout.actual_bytes);
+  auto* device_statuses     = reinterpret_cast<nvcompStatus_t*>(device + layout.statuses);
+  nvcomp_check(
+    decompress(reinterpret_cast<void const* const*>(device + layout.compressed_ptrs),
+               reinterpret_cast<std::size_t const*>(device + layout.compressed_bytes),
+               reinterpret_cast<std::size_t const*>(device + layout.decompressed_bytes),
+               device_actual_bytes,
+               rows,
+               device + layout.temp,
+               layout.end - layout.temp,
+               reinterpret_cast<void* const*>(device + layout.decompressed_ptrs),
+               device_statuses,
+               stream));
+
+  // Malformed rows are only reported once decompression is complete
+  copy(host + layout.actual_bytes,
+       device + layout.actual_bytes,
+       layout.temp - layout.actual_bytes,
+       stream,
+       PinnedMemory,
+       DeviceMemory);
+  return pending_decompression{
+    reinterpret_cast<std::size_t const*>(host + layout.actual_bytes),
+    reinterpret_cast<nvcompStatus_t const*>(host + layout.statuses),
+    rows,
+    row_bytes};
+}
+#else
+auto constexpr device_decompression_available = false;
+
+struct pending_decompression {
+  void check() const {}
+};
+
+inline decompression_storage device_decompression_storage(compression_codec codec,
+                                                          std::size_t row_bytes,
+                                                          StringTensor const& compressed)
+{
+  throw TritonException(Error::Internal,
+                        "Device decompression requires rapids_triton built with nvCOMP");
+}
+
+inline pending_decompression device_decompress_rows(compression_codec codec,
+                                                    std::byte* dst,
+                                                    std::size_t row_bytes,
+                                                    StringTensor const& compressed,
+                                                    Buffer<std::byte>& host_storage,
+                                                    Buffer<std::byte>& device_storage,
+                                                    cudaStream_t stream)
+{
+  throw TritonException(Error::Internal,
+                        "Device decompression requires rapids_triton built with nvCOMP");
+}
+#endif
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -16,10 +16,16 @@
 
 #pragma once
 #include <cstddef>
+#include <new>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/detail/gpu_only/resource.hpp>
 #include <rapids_triton/memory/detail/owned_device_buffer.hpp>
+#include <rapids_triton/memory/memory_budget.hpp>
 #include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/utils/device_setter.hpp>
 #include <rmm/device_buffer.hpp>
+#include <string>
 
 namespace triton {
 namespace backend {
@@ -30,16 +36,36 @@ template<typename T>
 struct owned_device_buffer<T, true> {
   using non_const_T = std::remove_const_t<T>;
   owned_device_buffer(device_id_t device_id, std::size_t size, cudaStream_t stream)
-    : data_{[&device_id, &size, &stream]() {
+    : reservation_{get_memory_budget(device_id), size * sizeof(T)},
+      trace_{allocation_location::device, size * sizeof(T), stream},
+      data_{[&device_id, &size, &stream]() {
       auto device_context = device_setter{device_id};
-      return rmm::device_buffer{size * sizeof(T), rmm::cuda_stream_view{stream}};
+      try {
+        return rmm::device_buffer{
+          size * sizeof(T), rmm::cuda_stream_view{stream}, get_memory_resource(device_id)};
+      } catch (std::bad_alloc const& err) {
+        // Reported like an exhausted memory budget, as a condition from
+        // which the server may recover
+        throw TritonException(Error::Unavailable,
+                              "failed to allocate " + std::to_string(size * sizeof(T)) +
+                                " bytes on device " + std::to_string(device_id) + ": " +
+                                err.what());
+      }
     }()}
   {
   }
 
   auto* get() const { return reinterpret_cast<T*>(data_.data()); }
 
+  /** Set the stream on which memory will be released when this buffer is
+   * destroyed */
+  void set_stream(cudaStream_t stream) { data_.set_stream(rmm::cuda_stream_view{stream}); }
+
  private:
+  // Declared before data_ so that reserved bytes are returned and the release
+  // traced only once the allocation itself has been freed
+  budget_reservation reservation_;
+  traced_allocation trace_;
   mutable rmm::device_buffer data_;
 };
 
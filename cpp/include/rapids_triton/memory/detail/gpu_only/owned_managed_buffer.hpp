@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cuda_runtime_api.h>
+#include <cstddef>
+#include <memory>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/detail/owned_managed_buffer.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/device_setter.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/**
+ * @brief An owning handle to memory allocated with cudaMallocManaged
+ *
+ * Managed memory is not drawn from the RMM pool and is not charged to the
+ * device's memory budget, since it may exceed the memory the device has free;
+ * pages migrate to whichever processor touches them.
+ */
+template<typename T>
+struct owned_managed_buffer<T, true> {
+  using non_const_T = std::remove_const_t<T>;
+  owned_managed_buffer(device_id_t device_id, std::size_t size, cudaStream_t stream)
+    : trace_{allocation_location::managed, size * sizeof(T), stream},
+      data_{[&device_id, &size]() {
+      auto* result = static_cast<void*>(nullptr);
+      if (size != 0) {
+        auto device_context = device_setter{device_id};
+        cuda_check(cudaMallocManaged(&result, size * sizeof(T)));
+      }
+      return static_cast<non_const_T*>(result);
+    }()}
+  {
+  }
+
+  auto* get() const { return static_cast<T*>(data_.get()); }
+
+  /** Managed memory is freed with cudaFree, which is not stream-ordered */
+  void set_stream(cudaStream_t stream) noexcept {}
+
+ private:
+  struct deleter {
+    void operator()(non_const_T* ptr) const noexcept { cudaFree(ptr); }
+  };
+  // Declared before data_ so that the release is traced once it is freed
+  traced_allocation trace_;
+  std::unique_ptr<non_const_T, deleter> data_;
+};
+
+/** Migrate the given bytes of managed memory to the device on the stream */
+inline void prefetch_managed(void const* data,
+                             std::size_t bytes,
+                             device_id_t device_id,
+                             cudaStream_t stream)
+{
+  cuda_check(cudaMemPrefetchAsync(data, bytes, device_id, stream));
+}
+
+/** Let each device read the given bytes of managed memory from its own
+ * copy, so that pages read on the device are not migrated back and forth */
+inline void advise_managed_read_mostly(void const* data, std::size_t bytes, device_id_t device_id)
+{
+  cuda_check(cudaMemAdvise(data, bytes, cudaMemAdviseSetReadMostly, device_id));
+}
+
+/** Keep the given bytes of managed memory resident on the device unless it
+ * runs out of memory */
+inline void advise_managed_preferred_location(void const* data,
+                                              std::size_t bytes,
+                                              device_id_t device_id)
+{
+  cuda_check(cudaMemAdvise(data, bytes, cudaMemAdviseSetPreferredLocation, device_id));
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cuda_runtime_api.h>
+#include <mutex>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/device_setter.hpp>
+#include <set>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/**
+ * @brief Allow kernels and copies on device `accessor` to access memory on
+ * device `owner` directly, if the hardware supports it
+ *
+ * Each pair of devices is only set up once; subsequent calls return
+ * immediately. Where peer access is unsupported, copies between the two
+ * devices are still possible but are staged through host memory by the
+ * CUDA driver.
+ *
+ * @return true if peer access is enabled between the two devices
+ */
+inline auto enable_peer_access(device_id_t accessor, device_id_t owner)
+{
+  static auto lock    = std::mutex{};
+  static auto enabled = std::set<std::pair<device_id_t, device_id_t>>{};
+  static auto checked = std::set<std::pair<device_id_t, device_id_t>>{};
+
+  auto key   = std::make_pair(accessor, owner);
+  auto guard = std::lock_guard<std::mutex>{lock};
+  if (accessor != owner && checked.find(key) == checked.end()) {
+    auto can_access = int{};
+    cuda_check(cudaDeviceCanAccessPeer(&can_access, accessor, owner));
+    if (can_access != 0) {
+      auto device_context = device_setter{accessor};
+      auto result         = cudaDeviceEnablePeerAccess(owner, 0);
+      if (result == cudaErrorPeerAccessAlreadyEnabled) {
+        // Clear the sticky error state set by the redundant call
+        cudaGetLastError();
+      } else {
+        cuda_check(result);
+      }
+      enabled.insert(key);
+    }
+    checked.insert(key);
+  }
+  return accessor == owner || enabled.find(key) != enabled.end();
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
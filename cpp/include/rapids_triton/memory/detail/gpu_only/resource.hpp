@@ -15,17 +15,26 @@
  */
 
 #pragma once
+#include <cuda_runtime_api.h>
 #include <triton/core/tritonbackend.h>
+
+#include <atomic>
+#include <cstddef>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/gpu_only/shared_pool.hpp>
 #include <rapids_triton/memory/detail/resource.hpp>
+#include <rapids_triton/memory/pool_config.hpp>
 #include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/triton/triton_memory_resource.hpp>
 #include <rmm/cuda_device.hpp>
 #include <rmm/mr/device/cuda_memory_resource.hpp>
 #include <rmm/mr/device/per_device_resource.hpp>
+#include <rmm/mr/device/pool_memory_resource.hpp>
+#include <vector>
 
 namespace triton {
 namespace backend {
@@ -38,10 +47,12 @@ inline auto& resource_lock()
   return lock;
 }
 
+using pool_resource = rmm::mr::pool_memory_resource<triton_memory_resource>;
+
 /** A struct used solely to keep memory resources in-scope for the lifetime
  * of the backend */
 struct resource_data {
-  resource_data() : base_mr_{}, triton_mrs_{} {}
+  resource_data() : base_mr_{}, triton_mrs_{}, pool_mrs_{} {}
   auto* make_new_resource(device_id_t device_id, TRITONBACKEND_MemoryManager* manager)
   {
     if (manager == nullptr && triton_mrs_.size() != 0) {
@@ -51,9 +62,16 @@ struct resource_data {
     return &(triton_mrs_.back());
   }
 
+  auto* make_new_pool(triton_memory_resource* upstream, pool_config const& config)
+  {
+    pool_mrs_.emplace_back(upstream, config.initial_size, config.maximum_size);
+    return &(pool_mrs_.back());
+  }
+
  private:
   rmm::mr::cuda_memory_resource base_mr_;
   std::deque<triton_memory_resource> triton_mrs_;
+  std::deque<pool_resource> pool_mrs_;
 };
 
 inline auto& get_device_resources()
@@ -62,35 +80,92 @@ inline auto& get_device_resources()
   return device_resources;
 }
 
-inline auto is_triton_resource(rmm::cuda_device_id const& device_id)
+/* The resources rapids_triton has installed for a single device */
+struct device_resource_entry {
+  triton_memory_resource* triton_mr{};
+  pool_resource* pool_mr{};
+  rmm::mr::device_memory_resource* shared_mr{};
+  std::atomic<rmm::mr::device_memory_resource*> current_mr{};
+};
+
+/**
+ * @brief Table of the resources installed for each visible device
+ *
+ * The table is sized once, on first use, and never resized, so entries may
+ * be read without holding resource_lock(). Entries are only modified while
+ * that lock is held.
+ */
+inline auto& get_device_resource_table()
+{
+  static auto table = []() {
+    auto device_count = int{};
+    if (cudaGetDeviceCount(&device_count) != cudaSuccess) {
+      cudaGetLastError();
+      device_count = 0;
+    }
+    return std::vector<device_resource_entry>(device_count);
+  }();
+  return table;
+}
+
+/**
+ * @brief Get the resource used for allocations on the given device
+ *
+ * Resources installed by setup_memory_resource are found with a single
+ * atomic load. For any other device, the resource registered with RMM is
+ * used.
+ */
+inline rmm::mr::device_memory_resource* get_memory_resource(device_id_t device_id)
 {
-  auto* triton_mr =
-    dynamic_cast<triton_memory_resource*>(rmm::mr::get_per_device_resource(device_id));
-  return (triton_mr != nullptr && triton_mr->get_triton_manager() != nullptr);
+  auto& table  = get_device_resource_table();
+  auto* result = static_cast<rmm::mr::device_memory_resource*>(nullptr);
+  if (device_id >= 0 && static_cast<std::size_t>(device_id) < table.size()) {
+    result = table[device_id].current_mr.load(std::memory_order_acquire);
+  }
+  if (result == nullptr) {
+    result = rmm::mr::get_per_device_resource(rmm::cuda_device_id{device_id});
+  }
+  return result;
 }
 
 template<>
 inline void setup_memory_resource<true>(device_id_t device_id,
-                                   TRITONBACKEND_MemoryManager* triton_manager)
+                                   TRITONBACKEND_MemoryManager* triton_manager,
+                                   std::optional<pool_config> const& device_pool)
 {
-  auto lock          = std::lock_guard<std::mutex>{detail::resource_lock()};
+  auto& table = get_device_resource_table();
+  if (device_id < 0 || static_cast<std::size_t>(device_id) >= table.size()) {
+    throw TritonException(Error::InvalidArg, "invalid device id for memory resource");
+  }
+  auto& entry        = table[device_id];
   auto rmm_device_id = rmm::cuda_device_id{device_id};
+  auto install       = [&entry, &rmm_device_id](rmm::mr::device_memory_resource* mr) {
+    rmm::mr::set_per_device_resource(rmm_device_id, mr);
+    entry.current_mr.store(mr, std::memory_order_release);
+  };
 
-  if (!detail::is_triton_resource(rmm_device_id)) {
+  auto lock = std::lock_guard<std::mutex>{detail::resource_lock()};
+  // A pool is only ever constructed on top of a triton_memory_resource, so
+  // once one is in place for this device, there is nothing left to set up.
+  // The same holds for a pool shared with other backends.
+  if (entry.pool_mr == nullptr && entry.shared_mr == nullptr) {
+    if (device_pool && device_pool->shared_library) {
+      entry.shared_mr = detail::get_shared_pool(device_id, *device_pool);
+      install(entry.shared_mr);
+      return;
+    }
     auto& device_resources = detail::get_device_resources();
-    rmm::mr::set_per_device_resource(rmm_device_id,
-                                     device_resources.make_new_resource(device_id, triton_manager));
+    if (entry.triton_mr == nullptr || entry.triton_mr->get_triton_manager() == nullptr) {
+      entry.triton_mr = device_resources.make_new_resource(device_id, triton_manager);
+      install(entry.triton_mr);
+    }
+    if (device_pool) {
+      entry.pool_mr = device_resources.make_new_pool(entry.triton_mr, *device_pool);
+      install(entry.pool_mr);
+    }
   }
 }
 
-/* inline auto* get_memory_resource(device_id_t device_id)
-{
-  auto rmm_device_id = rmm::cuda_device_id{device_id};
-  return rmm::mr::get_per_device_resource(rmm_device_id);
-}
-
-inline auto* get_memory_resource() { return rmm::mr::get_current_device_resource(); } */
-
 }  // namespace detail
 }  // namespace rapids
 }  // namespace backend
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <dlfcn.h>
+
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/pool_config.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rmm/mr/device/device_memory_resource.hpp>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/**
+ * @brief The entry point exported by the shared pool library
+ *
+ * Given a device, an initial size and a maximum size (0 for no maximum), it
+ * returns the rmm::mr::device_memory_resource pooling that device's memory
+ * for the whole process, or nullptr on failure. The pool is created by the
+ * first call for a device, which determines its size. The version suffix of
+ * the exported name changes whenever this signature or the layout of the
+ * returned resource does, so all backends sharing a pool must be built
+ * against the same version of RMM.
+ */
+using shared_pool_entry_point = void* (*)(int, std::size_t, std::size_t);
+auto constexpr shared_pool_symbol = "rapids_triton_shared_device_pool_v1";
+
+/**
+ * @brief Return the device pool shared by every backend in the process which
+ * loads the given library
+ *
+ * Each backend built on rapids_triton has its own copy of this library's
+ * state, but the dynamic loader maps a shared library only once per process,
+ * so every backend which loads the same library obtains the same pool. The
+ * library is never unloaded.
+ */
+inline rmm::mr::device_memory_resource* get_shared_pool(device_id_t device_id,
+                                                        pool_config const& config)
+{
+  auto const& library = config.shared_library.value();
+  auto* handle        = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (handle == nullptr) {
+    auto const* reason = dlerror();
+    throw TritonException(Error::Unavailable,
+                          "could not load shared device memory pool library " + library + ": " +
+                            (reason == nullptr ? "unknown error" : reason));
+  }
+  auto entry_point = reinterpret_cast<shared_pool_entry_point>(dlsym(handle, shared_pool_symbol));
+  if (entry_point == nullptr) {
+    throw TritonException(Error::Unavailable,
+                          library + " does not provide a compatible shared device memory pool");
+  }
+  auto* result = static_cast<rmm::mr::device_memory_resource*>(
+    entry_point(device_id, config.initial_size, config.maximum_size.value_or(std::size_t{})));
+  if (result == nullptr) {
+    throw TritonException(Error::Internal,
+                          "could not create shared device memory pool on device " +
+                            std::to_string(device_id));
+  }
+  return result;
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cstddef>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* A simple element-wise loop without aliasing between source and
+ * destination, which compilers vectorize for arithmetic types */
+template <typename T, typename U>
+void host_convert(T* __restrict__ dst, U const* __restrict__ src, std::size_t len)
+{
+  for (auto i = std::size_t{}; i < len; ++i) {
+    dst[i] = static_cast<T>(src[i]);
+  }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <thread>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/** One contiguous host-to-host copy within a gather or scatter */
+struct host_copy_segment {
+  void* dst;
+  void const* src;
+  std::size_t bytes;
+};
+
+/* Copies of at least this many bytes bypass the cache with non-temporal
+ * stores, since their destination would otherwise evict most of it */
+auto constexpr non_temporal_copy_bytes = std::size_t{1} << 22;
+/* Gathers or scatters of at least this many bytes in total are divided among
+ * several threads */
+auto constexpr parallel_copy_bytes = std::size_t{1} << 23;
+
+inline void non_temporal_copy(void* dst, void const* src, std::size_t bytes)
+{
+#if defined(__SSE2__)
+  auto* dst_bytes = static_cast<char*>(dst);
+  auto* src_bytes = static_cast<char const*>(src);
+  auto alignment  = sizeof(__m128i);
+  auto head = (alignment - reinterpret_cast<std::uintptr_t>(dst_bytes) % alignment) % alignment;
+  head      = std::min(head, bytes);
+  std::memcpy(dst_bytes, src_bytes, head);
+  auto i = head;
+  for (; i + 4 * alignment <= bytes; i += 4 * alignment) {
+    auto* out = reinterpret_cast<__m128i*>(dst_bytes + i);
+    auto* in  = reinterpret_cast<__m128i const*>(src_bytes + i);
+    auto a    = _mm_loadu_si128(in);
+    auto b    = _mm_loadu_si128(in + 1);
+    auto c    = _mm_loadu_si128(in + 2);
+    auto d    = _mm_loadu_si128(in + 3);
+    _mm_stream_si128(out, a);
+    _mm_stream_si128(out + 1, b);
+    _mm_stream_si128(out + 2, c);
+    _mm_stream_si128(out + 3, d);
+  }
+  std::memcpy(dst_bytes + i, src_bytes + i, bytes - i);
+  // Make streamed data visible to other threads before returning
+  _mm_sfence();
+#else
+  std::memcpy(dst, src, bytes);
+#endif
+}
+
+/** Copy between two host locations */
+inline void host_copy(void* dst, void const* src, std::size_t bytes)
+{
+  if (bytes >= non_temporal_copy_bytes) {
+    non_temporal_copy(dst, src, bytes);
+  } else if (bytes != 0) {
+    std::memcpy(dst, src, bytes);
+  }
+}
+
+/* Threads used for large gathers and scatters, started on first use */
+inline auto& host_copy_pool()
+{
+  static auto pool =
+    thread_pool{std::min(std::max(std::thread::hardware_concurrency(), 2u), 8u) - 1};
+  return pool;
+}
+
+/**
+ * @brief Perform all of the given host-to-host copies
+ *
+ * Small copies are made one after another on the calling thread. If the
+ * total size is large, the copies are instead divided into ranges of about
+ * equal size, splitting individual copies where necessary, and the ranges
+ * are copied in parallel.
+ */
+inline void host_copy(host_copy_segment const* begin, host_copy_segment const* end)
+{
+  auto total = std::transform_reduce(
+    begin, end, std::size_t{}, std::plus<>{}, [](auto& segment) { return segment.bytes; });
+  if (total < parallel_copy_bytes || host_copy_pool().size() == 0) {
+    std::for_each(begin, end, [](auto& segment) {
+      host_copy(segment.dst, segment.src, segment.bytes);
+    });
+    return;
+  }
+
+  // Byte offset at which each segment begins within the whole copy
+  auto offsets = std::vector<std::size_t>(std::distance(begin, end) + 1);
+  std::transform_exclusive_scan(begin,
+                                end,
+                                std::begin(offsets),
+                                std::size_t{},
+                                std::plus<>{},
+                                [](auto& segment) { return segment.bytes; });
+  offsets.back() = total;
+
+  auto& pool       = host_copy_pool();
+  auto pieces      = pool.size() + 1;
+  auto piece_bytes = (total + pieces - 1) / pieces;
+  pool.parallel_for(std::size_t{}, pieces, 1, [&](auto piece_begin, auto piece_end) {
+    for (auto piece = piece_begin; piece < piece_end; ++piece) {
+      auto start = piece * piece_bytes;
+      auto stop  = std::min(start + piece_bytes, total);
+      auto index = std::distance(
+        std::begin(offsets), std::upper_bound(std::begin(offsets), std::end(offsets), start) - 1);
+      for (auto position = start; position < stop; ++index) {
+        auto& segment = begin[index];
+        auto skip     = position - offsets[index];
+        auto bytes    = std::min(segment.bytes - skip, stop - position);
+        host_copy(static_cast<char*>(segment.dst) + skip,
+                  static_cast<char const*>(segment.src) + skip,
+                  bytes);
+        position += bytes;
+      }
+    }
+  });
+}
+
+/**
+ * @brief Collects the copies making up one gather or scatter
+ *
+ * If the expected total size is too small to benefit from parallel copies,
+ * each copy is made as soon as it is added; otherwise, copies are recorded
+ * and made together when `flush` is called.
+ */
+struct host_copy_list {
+  explicit host_copy_list(std::size_t total_bytes)
+    : deferred_{total_bytes >= parallel_copy_bytes && host_copy_pool().size() != 0}, segments_{}
+  {
+  }
+
+  void add(void* dst, void const* src, std::size_t bytes)
+  {
+    if (deferred_) {
+      segments_.push_back(host_copy_segment{dst, src, bytes});
+    } else {
+      host_copy(dst, src, bytes);
+    }
+  }
+
+  void flush()
+  {
+    host_copy(segments_.data(), segments_.data() + segments_.size());
+    segments_.clear();
+  }
+
+ private:
+  bool deferred_;
+  std::vector<host_copy_segment> segments_;
+};
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef RAPIDS_TRITON_ENABLE_COMPRESSION
+#include <lz4.h>
+#include <zstd.h>
+#endif
+#include <cstddef>
+#include <optional>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+#ifdef RAPIDS_TRITON_ENABLE_COMPRESSION
+auto constexpr host_decompression_available = true;
+#else
+auto constexpr host_decompression_available = false;
+#endif
+
+/* Decompress one row on the host, returning its decompressed size or
+ * std::nullopt if it is malformed or larger than dst */
+inline std::optional<std::size_t> host_decompress(compression_codec codec,
+                                                  std::byte* dst,
+                                                  std::size_t dst_bytes,
+                                                  char const* src,
+                                                  std::size_t src_bytes)
+{
+#ifdef RAPIDS_TRITON_ENABLE_COMPRESSION
+  if (codec == compression_codec::lz4) {
+    // LZ4 block sizes are limited to what an int can express
+    if (src_bytes > LZ4_MAX_INPUT_SIZE || dst_bytes > LZ4_MAX_INPUT_SIZE) { return std::nullopt; }
+    auto result = LZ4_decompress_safe(
+      src, reinterpret_cast<char*>(dst), static_cast<int>(src_bytes), static_cast<int>(dst_bytes));
+    return result < 0 ? std::nullopt : std::make_optional(static_cast<std::size_t>(result));
+  }
+  auto result = ZSTD_decompress(dst, dst_bytes, src, src_bytes);
+  return ZSTD_isError(result) ? std::nullopt : std::make_optional(result);
+#else
+  throw TritonException(Error::Unsupported,
+                        "rapids_triton was built without support for compressed inputs");
+#endif
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/utils/numa.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/** Alignment (in bytes) of all host allocations made by rapids_triton */
+auto constexpr host_alignment = std::size_t{64};
+
+/**
+ * @brief Interface for resources used to allocate host memory for Buffers
+ *
+ * Unlike std::make_unique<T[]>, host resources return uninitialized memory.
+ * Deallocation accepts the last stream on which the memory was used so that
+ * resources which recycle memory can avoid handing out a block which is still
+ * the target of an asynchronous copy.
+ */
+struct host_memory_resource {
+  virtual ~host_memory_resource() = default;
+
+  void* allocate(std::size_t bytes, cudaStream_t stream = cudaStream_t{})
+  {
+    return do_allocate(bytes, stream);
+  }
+  void deallocate(void* ptr, std::size_t bytes, cudaStream_t stream = cudaStream_t{}) noexcept
+  {
+    do_deallocate(ptr, bytes, stream);
+  }
+
+  /** Whether memory from this resource is page-locked */
+  virtual bool is_pinned() const noexcept { return false; }
+
+ private:
+  virtual void* do_allocate(std::size_t bytes, cudaStream_t stream)                   = 0;
+  virtual void do_deallocate(void* ptr, std::size_t bytes, cudaStream_t stream) noexcept = 0;
+};
+
+/** Resource for ordinary (pageable) host allocations */
+struct pageable_host_resource final : public host_memory_resource {
+ private:
+  void* do_allocate(std::size_t bytes, cudaStream_t stream) override
+  {
+    return ::operator new(bytes, std::align_val_t{host_alignment});
+  }
+  void do_deallocate(void* ptr, std::size_t bytes, cudaStream_t stream) noexcept override
+  {
+    ::operator delete(ptr, std::align_val_t{host_alignment});
+  }
+};
+
+/** Resource for page-locked host allocations (GPU builds only) */
+struct pinned_host_resource final : public host_memory_resource {
+  bool is_pinned() const noexcept override { return true; }
+
+ private:
+  void* do_allocate(std::size_t bytes, cudaStream_t stream) override
+  {
+    auto* ptr = static_cast<void*>(nullptr);
+    if constexpr (IS_GPU_BUILD) {
+      cuda_check(cudaMallocHost(&ptr, bytes));
+    } else {
+      throw TritonException(Error::Internal, "Pinned memory requested in non-GPU build");
+    }
+    return ptr;
+  }
+  void do_deallocate(void* ptr, std::size_t bytes, cudaStream_t stream) noexcept override
+  {
+    cudaFreeHost(ptr);
+  }
+};
+
+/**
+ * @brief A host resource which recycles freed blocks rather than returning
+ * them to its upstream resource
+ *
+ * Requests are rounded up to a power-of-two size class, and freed blocks are
+ * retained in a per-class free list until they are requested again. Blocks
+ * are also kept separately for each NUMA node to which the allocating
+ * thread was bound (see bind_thread_to_numa_node), so that threads bound to
+ * one node are not handed memory placed on another. If the
+ * upstream resource is pinned, a CUDA event is recorded on the deallocating
+ * stream and the block is not reused until that event has completed. At most
+ * maximum_cached_bytes will be retained in the free lists; beyond that, freed
+ * blocks are returned to the upstream resource.
+ */
+struct host_pool_resource final : public host_memory_resource {
+  host_pool_resource(host_memory_resource* upstream,
+                     std::optional<std::size_t> maximum_cached_bytes = std::nullopt)
+    : upstream_{upstream},
+      maximum_cached_bytes_{maximum_cached_bytes},
+      cached_bytes_{},
+      free_blocks_{},
+      block_nodes_{},
+      events_{},
+      lock_{}
+  {
+  }
+
+  host_pool_resource(host_pool_resource const& other) = delete;
+  host_pool_resource& operator=(host_pool_resource const& other) = delete;
+
+  ~host_pool_resource()
+  {
+    std::for_each(std::begin(free_blocks_), std::end(free_blocks_), [this](auto& size_class) {
+      std::for_each(
+        std::begin(size_class.second), std::end(size_class.second), [this, &size_class](auto ptr) {
+          release_block(ptr, size_class.first.second);
+        });
+    });
+  }
+
+  bool is_pinned() const noexcept override { return upstream_->is_pinned(); }
+
+  auto cached_bytes() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return cached_bytes_;
+  }
+
+ private:
+  host_memory_resource* upstream_;
+  std::optional<std::size_t> maximum_cached_bytes_;
+  std::size_t cached_bytes_;
+  // Free blocks keyed by NUMA node and size class
+  std::map<std::pair<int, std::size_t>, std::vector<void*>> free_blocks_;
+  // The NUMA node of each block allocated from upstream on a bound thread
+  std::unordered_map<void*, int> block_nodes_;
+  std::unordered_map<void*, cudaEvent_t> events_;
+  std::mutex mutable lock_;
+
+  static auto constexpr min_block_size = std::size_t{256};
+
+  static auto size_class(std::size_t bytes)
+  {
+    auto result = min_block_size;
+    while (result < bytes) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  auto uses_events() const noexcept { return IS_GPU_BUILD && upstream_->is_pinned(); }
+
+  // Must be called with lock_ held
+  auto block_ready(void* ptr) const
+  {
+    auto result = true;
+    if (uses_events()) {
+      auto event = events_.find(ptr);
+      if (event != std::end(events_)) { result = (cudaEventQuery(event->second) == cudaSuccess); }
+    }
+    return result;
+  }
+
+  void release_block(void* ptr, std::size_t bytes) noexcept
+  {
+    auto event = events_.find(ptr);
+    if (event != std::end(events_)) {
+      cudaEventSynchronize(event->second);
+      cudaEventDestroy(event->second);
+      events_.erase(event);
+    }
+    block_nodes_.erase(ptr);
+    upstream_->deallocate(ptr, bytes);
+  }
+
+  void* do_allocate(std::size_t bytes, cudaStream_t stream) override
+  {
+    auto block_size = size_class(bytes);
+    auto node       = current_numa_node();
+    {
+      auto lock   = std::lock_guard<std::mutex>{lock_};
+      auto blocks = free_blocks_.find(std::make_pair(node, block_size));
+      if (blocks != std::end(free_blocks_)) {
+        auto& free_list = blocks->second;
+        auto ready      = std::find_if(std::begin(free_list), std::end(free_list), [this](auto ptr) {
+          return block_ready(ptr);
+        });
+        if (ready != std::end(free_list)) {
+          auto* result = *ready;
+          free_list.erase(ready);
+          cached_bytes_ -= block_size;
+          return result;
+        }
+      }
+    }
+    auto* result = upstream_->allocate(block_size, stream);
+    if (node >= 0) {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      block_nodes_.emplace(result, node);
+    }
+    return result;
+  }
+
+  void do_deallocate(void* ptr, std::size_t bytes, cudaStream_t stream) noexcept override
+  {
+    auto block_size = size_class(bytes);
+    auto lock       = std::lock_guard<std::mutex>{lock_};
+    if (maximum_cached_bytes_ && cached_bytes_ + block_size > *maximum_cached_bytes_) {
+      release_block(ptr, block_size);
+      return;
+    }
+    if (uses_events()) {
+      auto event = events_.find(ptr);
+      if (event == std::end(events_)) {
+        auto new_event = cudaEvent_t{};
+        if (cudaEventCreateWithFlags(&new_event, cudaEventDisableTiming) != cudaSuccess) {
+          cudaGetLastError();
+          block_nodes_.erase(ptr);
+          upstream_->deallocate(ptr, block_size);
+          return;
+        }
+        event = events_.emplace(ptr, new_event).first;
+      }
+      cudaEventRecord(event->second, stream);
+    }
+    auto node = block_nodes_.find(ptr);
+    free_blocks_[std::make_pair(node == std::end(block_nodes_) ? -1 : node->second, block_size)]
+      .push_back(ptr);
+    cached_bytes_ += block_size;
+  }
+};
+
+/** A struct used solely to keep host memory resources in-scope for the
+ * lifetime of the backend */
+struct host_resource_data {
+  host_resource_data() : pageable_mr_{}, pinned_mr_{}, pool_mrs_{} {}
+
+  auto* get_pageable_resource() { return &pageable_mr_; }
+  auto* get_pinned_resource() { return &pinned_mr_; }
+  auto* make_new_pool(host_memory_resource* upstream,
+                      std::optional<std::size_t> maximum_cached_bytes)
+  {
+    pool_mrs_.emplace_back(std::make_unique<host_pool_resource>(upstream, maximum_cached_bytes));
+    return pool_mrs_.back().get();
+  }
+
+ private:
+  pageable_host_resource pageable_mr_;
+  pinned_host_resource pinned_mr_;
+  std::vector<std::unique_ptr<host_pool_resource>> pool_mrs_;
+};
+
+inline auto& get_host_resources()
+{
+  static auto host_resources = host_resource_data{};
+  return host_resources;
+}
+
+inline auto& host_resource_lock()
+{
+  static auto lock = std::mutex{};
+  return lock;
+}
+
+inline auto& current_host_resource()
+{
+  static auto resource =
+    std::atomic<host_memory_resource*>{get_host_resources().get_pageable_resource()};
+  return resource;
+}
+
+inline auto* get_host_memory_resource()
+{
+  return current_host_resource().load(std::memory_order_acquire);
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <type_traits>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/**
+ * @brief Host storage for a few elements held within the owning object
+ * itself, so that tiny buffers (e.g. scalars or per-request lengths) require
+ * no allocation
+ *
+ * Because the storage moves along with its owner, pointers to it do not
+ * remain valid once the owner has been moved.
+ */
+template <typename T>
+struct inline_host_buffer {
+  using non_const_T = std::remove_const_t<T>;
+
+  static auto constexpr capacity_bytes = std::size_t{32};
+
+  /** Whether the given number of elements may be stored inline */
+  static auto constexpr fits(std::size_t size) noexcept
+  {
+    return std::is_trivially_copyable_v<non_const_T> && size != 0 &&
+           size <= capacity_bytes / sizeof(T);
+  }
+
+  auto* get() const noexcept { return reinterpret_cast<T*>(storage_); }
+
+ private:
+  alignas(non_const_T) mutable std::byte storage_[capacity_bytes];
+};
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <cstddef>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/detail/host_resource.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/**
+ * @brief An owning handle to uninitialized host memory obtained from a
+ * host_memory_resource
+ *
+ * The stream associated with the handle is passed back to the resource when
+ * the memory is released so that pooled resources can defer reuse until any
+ * work enqueued on that stream has completed.
+ */
+template <typename T>
+struct owned_host_buffer {
+  using non_const_T = std::remove_const_t<T>;
+
+  owned_host_buffer() noexcept : data_{nullptr}, bytes_{}, stream_{}, mr_{nullptr}, trace_{} {}
+
+  owned_host_buffer(std::size_t size,
+                    cudaStream_t stream       = cudaStream_t{},
+                    host_memory_resource* mr = get_host_memory_resource())
+    : data_{nullptr}, bytes_{size * sizeof(T)}, stream_{stream}, mr_{mr}, trace_{}
+  {
+    if (bytes_ != 0) {
+      data_         = static_cast<T*>(mr_->allocate(bytes_, stream_));
+      auto location = mr_->is_pinned() ? allocation_location::pinned : allocation_location::host;
+      trace_        = traced_allocation{location, bytes_, stream_};
+    }
+  }
+
+  owned_host_buffer(owned_host_buffer const& other) = delete;
+  owned_host_buffer& operator=(owned_host_buffer const& other) = delete;
+
+  owned_host_buffer(owned_host_buffer&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      bytes_{std::exchange(other.bytes_, 0)},
+      stream_{other.stream_},
+      mr_{other.mr_},
+      trace_{std::move(other.trace_)}
+  {
+  }
+
+  owned_host_buffer& operator=(owned_host_buffer&& other) noexcept
+  {
+    if (this != &other) {
+      release();
+      data_   = std::exchange(other.data_, nullptr);
+      bytes_  = std::exchange(other.bytes_, 0);
+      stream_ = other.stream_;
+      mr_     = other.mr_;
+      trace_  = std::move(other.trace_);
+    }
+    return *this;
+  }
+
+  ~owned_host_buffer() { release(); }
+
+  auto* get() const noexcept { return data_; }
+  auto stream() const noexcept { return stream_; }
+  void set_stream(cudaStream_t new_stream) noexcept { stream_ = new_stream; }
+
+ private:
+  T* data_;
+  std::size_t bytes_;
+  cudaStream_t stream_;
+  host_memory_resource* mr_;
+  traced_allocation trace_;
+
+  void release() noexcept
+  {
+    if (data_ != nullptr) {
+      mr_->deallocate(const_cast<non_const_T*>(data_), bytes_, stream_);
+      data_ = nullptr;
+    }
+  }
+};
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
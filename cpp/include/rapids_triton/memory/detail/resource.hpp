@@ -17,6 +17,8 @@
 #pragma once
 #include <triton/core/tritonbackend.h>
 
+#include <optional>
+#include <rapids_triton/memory/pool_config.hpp>
 #include <rapids_triton/triton/device.hpp>
 
 namespace triton {
@@ -26,7 +28,8 @@ namespace detail {
 
 template<bool enable_gpu>
 inline void setup_memory_resource(device_id_t device_id,
-                                   TRITONBACKEND_MemoryManager* triton_manager = nullptr) {
+                                   TRITONBACKEND_MemoryManager* triton_manager = nullptr,
+                                   std::optional<pool_config> const& device_pool = std::nullopt) {
 }
 
 }  // namespace detail
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/memory/detail/host_resource.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+using detail::host_memory_resource;
+
+/**
+ * @brief Return the resource currently used for HostMemory Buffer
+ * allocations
+ */
+inline auto* get_host_memory_resource() { return detail::get_host_memory_resource(); }
+
+/**
+ * @brief Set up the resource used for HostMemory Buffer allocations
+ *
+ * If pool is true, freed host buffers are cached and reused for subsequent
+ * allocations rather than being returned to the system, with at most
+ * maximum_cached_bytes retained (or without limit if none is given). If
+ * pinned is true, host allocations will be page-locked so that transfers to
+ * and from device can proceed asynchronously; pinned memory is only
+ * available in GPU builds and is ignored otherwise. The host resource is
+ * process-wide, and the first call which installs a pool is used for the
+ * lifetime of the backend; subsequent calls will not replace it.
+ */
+inline void setup_host_memory_resource(
+  bool pool,
+  bool pinned                                     = IS_GPU_BUILD,
+  std::optional<std::size_t> maximum_cached_bytes = std::nullopt)
+{
+  auto lock       = std::lock_guard<std::mutex>{detail::host_resource_lock()};
+  auto& resources = detail::get_host_resources();
+  auto& current   = detail::current_host_resource();
+  auto* existing  = current.load(std::memory_order_acquire);
+  if (existing != resources.get_pageable_resource() &&
+      existing != resources.get_pinned_resource()) {
+    return;
+  }
+
+  auto* upstream = static_cast<host_memory_resource*>(resources.get_pageable_resource());
+  if (IS_GPU_BUILD && pinned) { upstream = resources.get_pinned_resource(); }
+
+  if (pool) {
+    current.store(resources.make_new_pool(upstream, maximum_cached_bytes),
+                  std::memory_order_release);
+  } else {
+    current.store(upstream, std::memory_order_release);
+  }
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
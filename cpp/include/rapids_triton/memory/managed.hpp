@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <rapids_triton/memory/detail/gpu_only/owned_managed_buffer.hpp>
+#else
+#include <rapids_triton/memory/detail/cpu_only/owned_managed_buffer.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/*
+ * Hints for buffers in managed memory (see `Buffer::managed`), e.g. model
+ * weights larger than the memory free on the device. Each hint applies to
+ * the elements of the buffer in [begin, end), so that the frequently used
+ * part of a model can be kept resident on the device while the rest is paged
+ * in on demand.
+ */
+
+namespace detail {
+template <typename T>
+auto managed_range(Buffer<T> const& buffer, std::size_t begin, std::size_t end)
+{
+  if (!buffer.is_managed()) {
+    throw TritonException(Error::Internal, "memory hints require a managed buffer");
+  }
+  end   = std::min(end, buffer.size());
+  begin = std::min(begin, end);
+  return std::make_pair(static_cast<void const*>(buffer.data() + begin), (end - begin) * sizeof(T));
+}
+}  // namespace detail
+
+/**
+ * @brief Migrate elements of a managed buffer to its device, in order with
+ * other work on the given stream (e.g. the batch's stream), so that they are
+ * resident before kernels which read them run
+ */
+template <typename T>
+void prefetch(Buffer<T> const& buffer,
+              cudaStream_t stream,
+              std::size_t begin = std::size_t{},
+              std::size_t end   = std::numeric_limits<std::size_t>::max())
+{
+  auto [data, bytes] = detail::managed_range(buffer, begin, end);
+  auto range         = nvtx_range{"prefetch managed memory: ", bytes, " bytes"};
+  if (bytes != 0) { detail::prefetch_managed(data, bytes, buffer.device(), stream); }
+}
+
+/**
+ * @brief Mark elements of a managed buffer as read-mostly, so that the device
+ * reads its own copy of each page instead of migrating it; suited to weights
+ * which are written once when a model is loaded
+ */
+template <typename T>
+void advise_read_mostly(Buffer<T> const& buffer,
+                        std::size_t begin = std::size_t{},
+                        std::size_t end   = std::numeric_limits<std::size_t>::max())
+{
+  auto [data, bytes] = detail::managed_range(buffer, begin, end);
+  if (bytes != 0) { detail::advise_managed_read_mostly(data, bytes, buffer.device()); }
+}
+
+/**
+ * @brief Prefer to keep elements of a managed buffer resident on its device,
+ * so that they are evicted only when the device runs out of memory
+ */
+template <typename T>
+void advise_resident(Buffer<T> const& buffer,
+                     std::size_t begin = std::size_t{},
+                     std::size_t end   = std::numeric_limits<std::size_t>::max())
+{
+  auto [data, bytes] = detail::managed_range(buffer, begin, end);
+  if (bytes != 0) { detail::advise_managed_preferred_location(data, bytes, buffer.device()); }
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
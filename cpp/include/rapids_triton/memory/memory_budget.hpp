@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <string>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A limit on the device memory which one model may hold on one device
+ *
+ * Allocations reserve bytes from the budget before they are made and return
+ * them once freed. An allocation which would exceed the limit waits for up
+ * to the budget's wait time for other allocations to be freed (e.g. by
+ * another instance finishing its batch) and throws a TritonException with
+ * code Error::Unavailable if it cannot be satisfied in that time or could
+ * never fit within the limit.
+ */
+struct memory_budget {
+  memory_budget(device_id_t device,
+                std::size_t limit,
+                std::chrono::milliseconds wait_time = std::chrono::milliseconds{})
+    : device_{device},
+      limit_{limit},
+      wait_time_{wait_time},
+      current_{},
+      peak_{},
+      lock_{},
+      released_{}
+  {
+  }
+
+  memory_budget(memory_budget const& other) = delete;
+  memory_budget& operator=(memory_budget const& other) = delete;
+
+  auto device() const noexcept { return device_; }
+  auto limit() const noexcept { return limit_; }
+  /** Number of bytes currently reserved */
+  auto current() const noexcept { return current_.load(std::memory_order_relaxed); }
+  /** Largest number of bytes ever reserved at once */
+  auto peak() const noexcept { return peak_.load(std::memory_order_relaxed); }
+
+  /** Reserve the given number of bytes if they fit without waiting */
+  auto try_reserve(std::size_t bytes)
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return reserve_locked(bytes);
+  }
+
+  /** Reserve the given number of bytes, waiting for room if necessary */
+  void reserve(std::size_t bytes)
+  {
+    if (bytes > limit_) {
+      throw TritonException(Error::Unavailable,
+                            "allocation of " + std::to_string(bytes) +
+                              " bytes exceeds device memory budget of " + std::to_string(limit_) +
+                              " bytes");
+    }
+    auto lock     = std::unique_lock<std::mutex>{lock_};
+    auto deadline = std::chrono::steady_clock::now() + wait_time_;
+    while (!reserve_locked(bytes)) {
+      if (released_.wait_until(lock, deadline) == std::cv_status::timeout &&
+          !reserve_locked(bytes)) {
+        throw TritonException(Error::Unavailable,
+                              "device memory budget of " + std::to_string(limit_) +
+                                " bytes exhausted");
+      }
+    }
+  }
+
+  void release(std::size_t bytes) noexcept
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      current_.store(current_.load(std::memory_order_relaxed) - bytes, std::memory_order_relaxed);
+    }
+    released_.notify_all();
+  }
+
+ private:
+  device_id_t device_;
+  std::size_t limit_;
+  std::chrono::milliseconds wait_time_;
+  std::atomic<std::size_t> current_;
+  std::atomic<std::size_t> peak_;
+  std::mutex lock_;
+  std::condition_variable released_;
+
+  // Must be called with lock_ held
+  bool reserve_locked(std::size_t bytes)
+  {
+    auto current = current_.load(std::memory_order_relaxed);
+    auto result  = bytes <= limit_ && current <= limit_ - bytes;
+    if (result) {
+      current += bytes;
+      current_.store(current, std::memory_order_relaxed);
+      if (current > peak_.load(std::memory_order_relaxed)) {
+        peak_.store(current, std::memory_order_relaxed);
+      }
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Bytes reserved from a memory_budget, which are returned to it when
+ * the reservation is destroyed
+ */
+struct budget_reservation {
+  budget_reservation() noexcept : budget_{}, bytes_{} {}
+  budget_reservation(std::shared_ptr<memory_budget> budget, std::size_t bytes)
+    : budget_{std::move(budget)}, bytes_{bytes}
+  {
+    if (budget_) { budget_->reserve(bytes_); }
+  }
+  budget_reservation(budget_reservation&& other) noexcept
+    : budget_{std::move(other.budget_)}, bytes_{other.bytes_}
+  {
+    other.budget_.reset();
+  }
+  budget_reservation& operator=(budget_reservation&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      budget_ = std::move(other.budget_);
+      bytes_  = other.bytes_;
+      other.budget_.reset();
+    }
+    return *this;
+  }
+  budget_reservation(budget_reservation const& other) = delete;
+  budget_reservation& operator=(budget_reservation const& other) = delete;
+  ~budget_reservation() { reset(); }
+
+ private:
+  std::shared_ptr<memory_budget> budget_;
+  std::size_t bytes_;
+
+  void reset() noexcept
+  {
+    if (budget_) {
+      budget_->release(bytes_);
+      budget_.reset();
+    }
+  }
+};
+
+namespace detail {
+inline auto& current_memory_budget()
+{
+  thread_local auto budget = std::shared_ptr<memory_budget>{};
+  return budget;
+}
+}  // namespace detail
+
+/**
+ * @brief Charge device allocations made by Buffers on this thread to the
+ * given budget for the lifetime of this object
+ *
+ * Only allocations on the budget's device are charged. A null budget leaves
+ * allocations unbudgeted.
+ */
+struct scoped_memory_budget {
+  explicit scoped_memory_budget(std::shared_ptr<memory_budget> budget)
+    : previous_{std::exchange(detail::current_memory_budget(), std::move(budget))}
+  {
+  }
+  scoped_memory_budget(scoped_memory_budget const& other) = delete;
+  scoped_memory_budget& operator=(scoped_memory_budget const& other) = delete;
+  ~scoped_memory_budget() { detail::current_memory_budget() = std::move(previous_); }
+
+ private:
+  std::shared_ptr<memory_budget> previous_;
+};
+
+/** The budget to which a new device allocation on the given device should
+ * be charged, or nullptr if it is unbudgeted */
+inline auto get_memory_budget(device_id_t device)
+{
+  auto const& budget = detail::current_memory_budget();
+  return (budget && budget->device() == device) ? budget : std::shared_ptr<memory_budget>{};
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/device_setter.hpp>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief The time taken by transfers in one direction between host and
+ * device, modeled as a fixed latency plus a cost per byte
+ */
+struct transfer_model {
+  std::chrono::nanoseconds latency;
+  double ns_per_byte;
+
+  /**
+   * @brief The size below which the fixed cost of a transfer, together with
+   * any given overhead, exceeds the time spent moving its bytes
+   *
+   * Transfers smaller than this achieve less than half the link's bandwidth.
+   */
+  std::size_t break_even_bytes(std::chrono::nanoseconds overhead = std::chrono::nanoseconds{}) const
+  {
+    auto fixed = static_cast<double>((latency + overhead).count());
+    if (ns_per_byte <= 0.0 || fixed / ns_per_byte >= std::numeric_limits<std::size_t>::max()) {
+      return std::numeric_limits<std::size_t>::max();
+    }
+    return static_cast<std::size_t>(fixed / ns_per_byte);
+  }
+};
+
+/**
+ * @brief Fit a transfer_model to measured (bytes, time) pairs by least
+ * squares
+ *
+ * A negative fitted latency is clamped to zero. At least two distinct sizes
+ * must be given.
+ */
+inline transfer_model fit_transfer_model(
+  std::vector<std::pair<std::size_t, std::chrono::nanoseconds>> const& samples)
+{
+  auto count = static_cast<double>(samples.size());
+  auto sum_x = 0.0;
+  auto sum_y = 0.0;
+  for (auto const& [bytes, time] : samples) {
+    sum_x += static_cast<double>(bytes);
+    sum_y += static_cast<double>(time.count());
+  }
+  auto mean_x = sum_x / count;
+  auto mean_y = sum_y / count;
+  auto cov    = 0.0;
+  auto var    = 0.0;
+  for (auto const& [bytes, time] : samples) {
+    auto dx = static_cast<double>(bytes) - mean_x;
+    cov += dx * (static_cast<double>(time.count()) - mean_y);
+    var += dx * dx;
+  }
+  if (var == 0.0) {
+    throw TritonException(Error::Internal, "transfer model requires samples of distinct sizes");
+  }
+  auto slope     = cov / var;
+  auto intercept = std::max(mean_y - slope * mean_x, 0.0);
+  return transfer_model{
+    std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(intercept)}, slope};
+}
+
+/**
+ * @brief The cost of moving data to and from one device and of submitting
+ * work to it, as measured by run_placement_probe
+ */
+struct placement_probe {
+  transfer_model host_to_device;
+  transfer_model device_to_host;
+  std::chrono::nanoseconds launch_latency;
+};
+
+namespace detail {
+/* The median time taken by repetitions of fn */
+template <typename F>
+auto median_time(F&& fn, std::size_t repetitions)
+{
+  auto times = std::vector<std::chrono::nanoseconds>(repetitions);
+  for (auto& time : times) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    time = std::chrono::steady_clock::now() - start;
+  }
+  auto middle = std::next(std::begin(times), repetitions / 2);
+  std::nth_element(std::begin(times), middle, std::end(times));
+  return *middle;
+}
+}  // namespace detail
+
+/**
+ * @brief Measure host-to-device and device-to-host transfers between pinned
+ * host memory and the given device at sizes from 4 KiB to 16 MiB, and the
+ * round trip of the smallest possible unit of device work
+ *
+ * Each measurement is the median of several synchronous repetitions, so the
+ * probe takes a few tens of milliseconds. Available only in GPU builds.
+ */
+inline placement_probe run_placement_probe(device_id_t device)
+{
+  auto constexpr min_bytes   = std::size_t{1} << 12;
+  auto constexpr max_bytes   = std::size_t{1} << 24;
+  auto constexpr repetitions = std::size_t{5};
+  if constexpr (IS_GPU_BUILD) {
+    auto setter = device_setter{device};
+    auto stream = cudaStream_t{};
+    auto size   = static_cast<Buffer<char>::size_type>(max_bytes);
+    auto host   = Buffer<char>{size, PinnedMemory, device, stream};
+    auto dev    = Buffer<char>{size, DeviceMemory, device, stream};
+
+    auto time_copy = [&](auto& dst, auto const& src, std::size_t bytes) {
+      return detail::median_time(
+        [&]() {
+          copy(dst, src, 0, 0, static_cast<Buffer<char>::size_type>(bytes));
+          cuda_check(cudaStreamSynchronize(stream));
+        },
+        repetitions);
+    };
+    // Untimed transfers absorb any lazy initialization of the context
+    time_copy(dev, host, min_bytes);
+    time_copy(host, dev, min_bytes);
+
+    auto to_device = std::vector<std::pair<std::size_t, std::chrono::nanoseconds>>{};
+    auto to_host   = std::vector<std::pair<std::size_t, std::chrono::nanoseconds>>{};
+    for (auto bytes = min_bytes; bytes <= max_bytes; bytes *= 4) {
+      to_device.emplace_back(bytes, time_copy(dev, host, bytes));
+      to_host.emplace_back(bytes, time_copy(host, dev, bytes));
+    }
+    // A one-byte copy within the device is the smallest unit of work which
+    // can be submitted without a kernel of our own
+    auto launch = detail::median_time(
+      [&]() {
+        copy(dev, dev, 0, size - 1, size);
+        cuda_check(cudaStreamSynchronize(stream));
+      },
+      repetitions);
+    return placement_probe{fit_transfer_model(to_device), fit_transfer_model(to_host), launch};
+  } else {
+    throw TritonException(Error::Internal, "placement probe used in non-GPU build");
+  }
+}
+
+/**
+ * @brief A choice of memory type for a batch's inputs and outputs by the
+ * number of bytes they occupy
+ *
+ * Data are placed on the device only if moving them there (or back) is
+ * bandwidth-bound, i.e. if they are at least as large as the size at which
+ * the fixed cost of a transfer and a launch equals the time spent moving
+ * bytes. Smaller batches are left on the host. Inputs or outputs whose size
+ * per row is unknown are always placed on the device.
+ */
+struct memory_placement {
+  /**
+   * @param probe The measured costs of the device
+   * @param input_row_bytes The bytes per row of all of a model's inputs
+   * @param output_row_bytes The bytes per row of all of a model's outputs
+   */
+  memory_placement(placement_probe const& probe,
+                   std::size_t input_row_bytes,
+                   std::size_t output_row_bytes)
+    : min_device_input_bytes_{probe.host_to_device.break_even_bytes(probe.launch_latency)},
+      min_device_output_bytes_{probe.device_to_host.break_even_bytes(probe.launch_latency)},
+      input_row_bytes_{input_row_bytes},
+      output_row_bytes_{output_row_bytes}
+  {
+  }
+
+  /** The smallest total input size placed on the device */
+  auto min_device_input_bytes() const noexcept { return min_device_input_bytes_; }
+  /** The smallest total output size placed on the device */
+  auto min_device_output_bytes() const noexcept { return min_device_output_bytes_; }
+
+  /** The memory type for the inputs of a batch of the given number of rows */
+  MemoryType input_mem_type(std::size_t rows) const noexcept
+  {
+    return choose(rows, input_row_bytes_, min_device_input_bytes_);
+  }
+
+  /** The memory type for the outputs of a batch of the given number of rows */
+  MemoryType output_mem_type(std::size_t rows) const noexcept
+  {
+    return choose(rows, output_row_bytes_, min_device_output_bytes_);
+  }
+
+ private:
+  std::size_t min_device_input_bytes_;
+  std::size_t min_device_output_bytes_;
+  std::size_t input_row_bytes_;
+  std::size_t output_row_bytes_;
+
+  static MemoryType choose(std::size_t rows, std::size_t row_bytes, std::size_t min_bytes) noexcept
+  {
+    return (row_bytes == 0 || rows * row_bytes >= min_bytes) ? DeviceMemory : HostMemory;
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
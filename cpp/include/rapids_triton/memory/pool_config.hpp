@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Sizing information for a memory pool
+ *
+ * The pool will reserve `initial_size` bytes when it is first constructed and
+ * grow on demand up to `maximum_size` bytes (or without limit if no maximum
+ * is given). If `shared_library` is given, the pool is instead the one
+ * shared by every backend in the process which loads that library, sized by
+ * whichever backend first creates it.
+ */
+struct pool_config {
+  std::size_t initial_size;
+  std::optional<std::size_t> maximum_size;
+  std::optional<std::string> shared_library{};
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
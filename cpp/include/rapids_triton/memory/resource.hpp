@@ -17,8 +17,10 @@
 #pragma once
 #include <triton/core/tritonbackend.h>
 
+#include <optional>
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/memory/detail/resource.hpp>
+#include <rapids_triton/memory/pool_config.hpp>
 #include <rapids_triton/triton/device.hpp>
 #ifdef TRITON_ENABLE_GPU
 #include <rapids_triton/memory/detail/gpu_only/resource.hpp>
@@ -30,8 +32,24 @@ namespace triton {
 namespace backend {
 namespace rapids {
 
-inline void setup_memory_resource(device_id_t device_id, TRITONBACKEND_MemoryManager* triton_manager = nullptr) {
-  detail::setup_memory_resource<IS_GPU_BUILD>(device_id, triton_manager);
+/**
+ * @brief Set up the RMM device resource used for allocations on the given
+ * device
+ *
+ * Allocations are routed through Triton's memory manager if one is provided.
+ * If a device_pool configuration is given, a stream-ordered pool is placed
+ * in front of that resource so that steady-state allocations do not require
+ * a call to the driver. If the configuration names a shared pool library,
+ * the pool shared with all other backends in the process which load it is
+ * used instead, and Triton's memory manager is bypassed. The first pool
+ * configured for a device is used for the lifetime of the backend;
+ * subsequent calls for the same device will not replace it.
+ */
+inline void setup_memory_resource(device_id_t device_id,
+                                  TRITONBACKEND_MemoryManager* triton_manager = nullptr,
+                                  std::optional<pool_config> const& device_pool = std::nullopt)
+{
+  detail::setup_memory_resource<IS_GPU_BUILD>(device_id, triton_manager, device_pool);
 }
 
 }  // namespace rapids
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A bump allocator for temporary storage in one memory location
+ *
+ * Each allocation is carved from the end of the arena's current block, so
+ * it costs no more than advancing an offset, and nothing is freed until the
+ * whole arena is reset. If a request does not fit, a larger block is
+ * allocated and the old one is retained until reset; at the next reset, the
+ * blocks are discarded so that a single block large enough for the
+ * high-water mark is allocated on next use. Buffers returned by the arena
+ * are non-owning views which must not be used after reset.
+ *
+ * The arena is stream-ordered: on reset, an event is recorded on the stream
+ * of its most recent allocation, and the first allocation after reset
+ * waits for that event, on the new stream for device memory or on the host
+ * for host memory, so that a block is not handed out while earlier work may
+ * still be using it.
+ */
+struct scratch_arena {
+  /** Alignment (in bytes) of each allocation from an arena */
+  static auto constexpr alignment = std::size_t{256};
+  /** Smallest block an arena will allocate */
+  static auto constexpr min_block_bytes = std::size_t{1} << 16;
+
+  scratch_arena(MemoryType mem_type, device_id_t device)
+    : mem_type_{mem_type},
+      device_{device},
+      blocks_{},
+      offset_{},
+      used_bytes_{},
+      high_water_mark_{},
+      stream_{},
+      event_{},
+      pending_event_{false}
+  {
+  }
+
+  scratch_arena(scratch_arena const& other) = delete;
+  scratch_arena& operator=(scratch_arena const& other) = delete;
+
+  ~scratch_arena()
+  {
+    if (event_ != cudaEvent_t{}) { cudaEventDestroy(event_); }
+  }
+
+  auto mem_type() const noexcept { return mem_type_; }
+  auto device() const noexcept { return device_; }
+
+  /** The bytes allocated from the arena since it was last reset */
+  auto used_bytes() const noexcept { return used_bytes_; }
+
+  /** The largest number of bytes allocated between any two resets */
+  auto high_water_mark() const noexcept { return high_water_mark_; }
+
+  /** The total size of the blocks currently held by the arena */
+  auto capacity() const noexcept
+  {
+    auto result = std::size_t{};
+    for (auto const& block : blocks_) {
+      result += block.size();
+    }
+    return result;
+  }
+
+  /**
+   * @brief Return a view of uninitialized storage for `count` elements of
+   * type T, valid until the arena is reset
+   */
+  template <typename T>
+  auto allocate(std::size_t count, cudaStream_t stream)
+  {
+    auto bytes = round_up(count * sizeof(T));
+    if (pending_event_) { wait_for_reset(stream); }
+    auto start = blocks_.empty() ? std::size_t{} : aligned_offset(blocks_.back());
+    if (blocks_.empty() || start + bytes > blocks_.back().size()) {
+      auto block_bytes = std::max({bytes, high_water_mark_, min_block_bytes});
+      if (!blocks_.empty()) { block_bytes = std::max(block_bytes, 2 * blocks_.back().size()); }
+      // Blocks carry enough slack to align their first allocation
+      blocks_.emplace_back(block_bytes + alignment, mem_type_, device_, stream);
+      offset_ = std::size_t{};
+      start   = aligned_offset(blocks_.back());
+    }
+    auto* data = reinterpret_cast<T*>(blocks_.back().data() + start);
+    offset_    = start + bytes;
+    used_bytes_ += bytes;
+    high_water_mark_ = std::max(high_water_mark_, used_bytes_);
+    stream_          = stream;
+    return Buffer<T>(data, count, mem_type_, device_, stream);
+  }
+
+  /**
+   * @brief Ensure that the arena holds a single block of at least the given
+   * number of bytes, so that allocations totalling no more than that never
+   * allocate
+   *
+   * This has no effect while any storage is allocated from the arena. It
+   * allows storage sized from a model's configuration to be allocated once,
+   * before it is first needed.
+   */
+  void reserve(std::size_t bytes, cudaStream_t stream)
+  {
+    auto block_bytes = round_up(bytes) + alignment;
+    if (used_bytes_ != 0 || (!blocks_.empty() && blocks_.back().size() >= block_bytes)) { return; }
+    if (pending_event_) { wait_for_reset(stream); }
+    blocks_.clear();
+    blocks_.emplace_back(block_bytes, mem_type_, device_, stream);
+    offset_ = std::size_t{};
+    stream_ = stream;
+  }
+
+  /**
+   * @brief Make all storage in the arena available for reuse
+   *
+   * All views previously returned by allocate become invalid.
+   */
+  void reset() noexcept
+  {
+    if (used_bytes_ == 0) { return; }
+    // Blocks are consolidated so that a single block will suffice next time
+    if (blocks_.size() > 1) { blocks_.clear(); }
+    if constexpr (IS_GPU_BUILD) {
+      if (!blocks_.empty()) { pending_event_ = record_event(); }
+    }
+    offset_     = std::size_t{};
+    used_bytes_ = std::size_t{};
+  }
+
+ private:
+  MemoryType mem_type_;
+  device_id_t device_;
+  std::vector<Buffer<std::byte>> blocks_;
+  std::size_t offset_;
+  std::size_t used_bytes_;
+  std::size_t high_water_mark_;
+  cudaStream_t stream_;
+  cudaEvent_t event_;
+  bool pending_event_;
+
+  static std::size_t round_up(std::size_t bytes)
+  {
+    return ((bytes + alignment - 1) / alignment) * alignment;
+  }
+
+  /* The first offset at or after offset_ at which the address of an element
+   * of the given block is aligned */
+  auto aligned_offset(Buffer<std::byte> const& block) const
+  {
+    auto address = reinterpret_cast<std::uintptr_t>(block.data());
+    return round_up(address + offset_) - address;
+  }
+
+  /* Record the completion of work on the most recent stream, returning false
+   * if the stream had to be synchronized instead */
+  bool record_event() noexcept
+  {
+    if (event_ == cudaEvent_t{} &&
+        cudaEventCreateWithFlags(&event_, cudaEventDisableTiming) != cudaSuccess) {
+      cudaGetLastError();
+      event_ = cudaEvent_t{};
+    }
+    if (event_ == cudaEvent_t{} || cudaEventRecord(event_, stream_) != cudaSuccess) {
+      cudaGetLastError();
+      cudaStreamSynchronize(stream_);
+      return false;
+    }
+    return true;
+  }
+
+  void wait_for_reset(cudaStream_t stream)
+  {
+    if (mem_type_ == DeviceMemory) {
+      if (stream != stream_) { cuda_check(cudaStreamWaitEvent(stream, event_)); }
+    } else {
+      cuda_check(cudaEventSynchronize(event_));
+    }
+    pending_event_ = false;
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
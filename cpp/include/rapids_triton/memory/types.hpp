@@ -23,6 +23,22 @@ namespace rapids {
 using MemoryType            = TRITONSERVER_MemoryType;
 auto constexpr DeviceMemory = TRITONSERVER_MEMORY_GPU;
 auto constexpr HostMemory   = TRITONSERVER_MEMORY_CPU;
+auto constexpr PinnedMemory = TRITONSERVER_MEMORY_CPU_PINNED;
+
+/** Whether memory of the given type may be read and written by the host */
+inline constexpr bool is_host_memory(MemoryType mem_type) { return mem_type != DeviceMemory; }
+
+/**
+ * @brief Whether data in memory of type `actual` may be used where memory of
+ * type `wanted` was requested
+ *
+ * Pinned memory is host memory, so it may be used wherever host memory is
+ * wanted, but not the other way around.
+ */
+inline constexpr bool satisfies_memory_type(MemoryType actual, MemoryType wanted)
+{
+  return actual == wanted || (wanted == HostMemory && actual == PinnedMemory);
+}
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
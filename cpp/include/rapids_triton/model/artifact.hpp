@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#ifdef RAPIDS_TRITON_ENABLE_GDS
+#include <cufile.h>
+#endif
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/device_setter.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/** Options controlling how a model artifact is mapped into memory */
+struct artifact_options {
+  /** Read the whole file into the page cache when it is mapped (MAP_POPULATE)
+   * rather than faulting it in as it is accessed */
+  bool populate = false;
+  /** Ask the kernel to back the mapping with transparent huge pages where the
+   * filesystem supports it */
+  bool huge_pages = false;
+};
+
+namespace detail {
+[[noreturn]] inline void throw_artifact_error(std::string const& path, char const* action)
+{
+  auto const err = errno;
+  auto code      = (err == ENOENT) ? Error::NotFound : Error::Internal;
+  throw TritonException(code, "Could not " + std::string{action} + " model artifact " + path +
+                                ": " + std::strerror(err));
+}
+
+struct file_descriptor {
+  file_descriptor(std::string const& path) : fd_{::open(path.c_str(), O_RDONLY | O_CLOEXEC)}
+  {
+    if (fd_ < 0) { throw_artifact_error(path, "open"); }
+  }
+  file_descriptor(file_descriptor const& other) = delete;
+  file_descriptor& operator=(file_descriptor const& other) = delete;
+  ~file_descriptor() { ::close(fd_); }
+
+  auto get() const { return fd_; }
+
+ private:
+  int fd_;
+};
+
+#ifdef RAPIDS_TRITON_ENABLE_GDS
+/** Read a file directly into device memory with GPUDirect Storage, returning
+ * false if GDS cannot be used for this file */
+inline auto gds_read(int fd, void* dst, std::size_t bytes)
+{
+  auto result = cuFileDriverOpen().err == CU_FILE_SUCCESS;
+  if (result) {
+    auto descr      = CUfileDescr_t{};
+    descr.handle.fd = fd;
+    descr.type      = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+    auto handle     = CUfileHandle_t{};
+    result          = cuFileHandleRegister(&handle, &descr).err == CU_FILE_SUCCESS;
+    if (result) {
+      auto offset = std::size_t{};
+      while (result && offset < bytes) {
+        auto bytes_read = cuFileRead(handle, dst, bytes - offset, offset, offset);
+        result          = bytes_read > 0;
+        offset += result ? bytes_read : 0;
+      }
+      cuFileHandleDeregister(handle);
+    }
+  }
+  return result;
+}
+#endif
+}  // namespace detail
+
+/**
+ * @brief A read-only, memory-mapped view of a model artifact
+ *
+ * Mapping an artifact avoids reading it into a separate heap allocation before
+ * it is parsed or copied to the device: its contents are read directly from
+ * the page cache, and the pages may be reclaimed by the kernel once they are
+ * no longer needed. The mapping is released when the mapped_artifact is
+ * destroyed, so any Buffer returned by `view` must not outlive it.
+ */
+struct mapped_artifact {
+  mapped_artifact(std::string const& path, artifact_options options = artifact_options{})
+    : path_{path}, data_{nullptr}, size_{}
+  {
+    auto fd   = detail::file_descriptor{path_};
+    struct stat info {};
+    if (fstat(fd.get(), &info) != 0) { detail::throw_artifact_error(path_, "stat"); }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ != 0) {
+      auto flags = MAP_PRIVATE;
+      if (options.populate) { flags |= MAP_POPULATE; }
+      auto* data = mmap(nullptr, size_, PROT_READ, flags, fd.get(), 0);
+      if (data == MAP_FAILED) { detail::throw_artifact_error(path_, "map"); }
+      data_ = static_cast<std::byte const*>(data);
+      if (options.huge_pages) {
+        // Huge pages are only a hint; not all filesystems support them
+        if (madvise(data, size_, MADV_HUGEPAGE) != 0) {
+          log_info(__FILE__, __LINE__) << "Huge pages unavailable for " << path_;
+        }
+      }
+    }
+  }
+
+  mapped_artifact(mapped_artifact const& other) = delete;
+  mapped_artifact& operator=(mapped_artifact const& other) = delete;
+  mapped_artifact(mapped_artifact&& other) noexcept
+    : path_{std::move(other.path_)},
+      data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)}
+  {
+  }
+  mapped_artifact& operator=(mapped_artifact&& other) noexcept
+  {
+    unmap();
+    path_ = std::move(other.path_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    return *this;
+  }
+
+  ~mapped_artifact() { unmap(); }
+
+  auto const& path() const { return path_; }
+  auto size() const { return size_; }
+  auto* data() const { return data_; }
+
+  /** Return a non-owning host Buffer over the mapped artifact */
+  auto view(cudaStream_t stream = 0) const
+  {
+    return Buffer<std::byte const>{data_, size_, HostMemory, 0, stream};
+  }
+
+  /**
+   * @brief Read the artifact into a new device Buffer
+   *
+   * If rapids_triton was built with GPUDirect Storage support and the
+   * artifact's filesystem supports it, the data are read from storage
+   * directly to the device. Otherwise, they are copied from the mapping,
+   * avoiding any intermediate host allocation. The copy is complete when this
+   * method returns, so the mapped_artifact may be destroyed immediately.
+   */
+  auto to_device(device_id_t device, cudaStream_t stream = 0) const
+  {
+    auto result = Buffer<std::byte>{size_, DeviceMemory, device, stream};
+#ifdef RAPIDS_TRITON_ENABLE_GDS
+    auto device_context = device_setter{device};
+    auto fd             = detail::file_descriptor{path_};
+    if (size_ != 0 && detail::gds_read(fd.get(), result.data(), size_)) { return result; }
+#endif
+    copy(result, view(stream));
+    result.stream_synchronize();
+    return result;
+  }
+
+ private:
+  std::string path_;
+  std::byte const* data_;
+  std::size_t size_;
+
+  void unmap() noexcept
+  {
+    if (data_ != nullptr) {
+      munmap(const_cast<std::byte*>(data_), size_);
+      data_ = nullptr;
+    }
+  }
+};
+
+/**
+ * @brief Call a function on a background thread whenever a model artifact is
+ * replaced
+ *
+ * The artifact's modification time and size are checked at the given
+ * interval. A change is only reported once they have stayed the same for one
+ * further interval, so that an artifact which is still being written is not
+ * loaded, and the artifact as it was when the watcher was constructed is
+ * never reported. If the artifact is removed, nothing is reported until it
+ * reappears.
+ */
+struct artifact_watcher {
+  artifact_watcher(std::string path,
+                   std::chrono::milliseconds interval,
+                   std::function<void()> on_change)
+    : path_{std::move(path)},
+      interval_{interval},
+      on_change_{std::move(on_change)},
+      shutdown_{false},
+      lock_{},
+      cv_{},
+      worker_{}
+  {
+    worker_ = std::thread{[this]() { run(); }};
+  }
+
+  artifact_watcher(artifact_watcher const& other) = delete;
+  artifact_watcher& operator=(artifact_watcher const& other) = delete;
+
+  ~artifact_watcher()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+ private:
+  struct file_state {
+    std::int64_t modified_ns;
+    std::int64_t size;
+    bool operator==(file_state const& other) const
+    {
+      return modified_ns == other.modified_ns && size == other.size;
+    }
+  };
+
+  std::string path_;
+  std::chrono::milliseconds interval_;
+  std::function<void()> on_change_;
+  bool shutdown_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::thread worker_;
+
+  std::optional<file_state> stat_artifact() const
+  {
+    struct stat info {};
+    if (::stat(path_.c_str(), &info) != 0) { return std::nullopt; }
+    return file_state{
+      std::int64_t{info.st_mtim.tv_sec} * 1000000000 + std::int64_t{info.st_mtim.tv_nsec},
+      std::int64_t{info.st_size}};
+  }
+
+  void run()
+  {
+    auto reported = stat_artifact();
+    auto pending  = reported;
+    auto lock     = std::unique_lock<std::mutex>{lock_};
+    while (!cv_.wait_for(lock, interval_, [this]() { return shutdown_; })) {
+      auto current = stat_artifact();
+      if (current == reported) {
+        pending = current;
+      } else if (current.has_value() && current == pending) {
+        reported = current;
+        lock.unlock();
+        try {
+          on_change_();
+        } catch (TritonException const& err) {
+          log_error(__FILE__, __LINE__) << "Reloading " << path_ << " failed: " << err.what();
+        }
+        lock.lock();
+      } else {
+        pending = current;
+      }
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
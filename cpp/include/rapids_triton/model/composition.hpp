@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief One stage of a composed model, which reads the named inputs from
+ * the batch and writes the named outputs to it
+ */
+struct composition_stage {
+  std::string name;
+  std::vector<std::string> inputs;
+  std::vector<std::string> outputs;
+  std::function<void(Batch&)> predict;
+};
+
+/**
+ * @brief A graph of models run in sequence within one backend's predict
+ *
+ * Stages are connected by name: an output of one stage which another stage
+ * takes as an input becomes an intermediate tensor of the batch, passed to
+ * its consumer in whatever location its producer wrote it, on the batch's
+ * stream. Only inputs which no stage produces are gathered from requests,
+ * and only outputs which no stage consumes are sent in responses, so the
+ * whole graph costs one input collection and one response per batch.
+ */
+struct composition {
+  /** Order the given stages so that each follows every stage producing one
+   * of its inputs, throwing if they form a cycle or if two stages produce
+   * the same tensor */
+  explicit composition(std::vector<composition_stage> stages)
+    : stages_{}, intermediates_{}
+  {
+    auto producer_of = [&stages](std::string const& tensor) {
+      return std::find_if(std::begin(stages), std::end(stages), [&tensor](auto const& stage) {
+        return std::find(std::begin(stage.outputs), std::end(stage.outputs), tensor) !=
+               std::end(stage.outputs);
+      });
+    };
+    for (auto stage = std::begin(stages); stage != std::end(stages); ++stage) {
+      for (auto const& output : stage->outputs) {
+        if (producer_of(output) != stage) {
+          throw TritonException(Error::InvalidArg,
+                                "more than one stage produces tensor " + output);
+        }
+      }
+    }
+
+    // Kahn's algorithm, preferring the order in which stages were given
+    auto pending = std::vector<std::size_t>(stages.size());
+    for (auto i = std::size_t{}; i < stages.size(); ++i) {
+      for (auto const& input : stages[i].inputs) {
+        auto producer = producer_of(input);
+        if (producer != std::end(stages)) {
+          ++pending[i];
+          if (std::find(std::begin(intermediates_), std::end(intermediates_), input) ==
+              std::end(intermediates_)) {
+            intermediates_.push_back(input);
+          }
+        }
+      }
+    }
+    auto done = std::vector<bool>(stages.size());
+    while (stages_.size() < stages.size()) {
+      auto ready = std::size_t{};
+      while (ready < stages.size() && (done[ready] || pending[ready] != 0)) {
+        ++ready;
+      }
+      if (ready == stages.size()) {
+        auto blocked = std::find(std::begin(done), std::end(done), false);
+        throw TritonException(Error::InvalidArg,
+                              "stage " + stages[std::distance(std::begin(done), blocked)].name +
+                                " of composed model depends on its own outputs");
+      }
+      done[ready] = true;
+      for (auto i = std::size_t{}; i < stages.size(); ++i) {
+        pending[i] -= std::count_if(
+          std::begin(stages[i].inputs), std::end(stages[i].inputs), [&](auto const& input) {
+            return std::find(std::begin(stages[ready].outputs),
+                             std::end(stages[ready].outputs),
+                             input) != std::end(stages[ready].outputs);
+          });
+      }
+      stages_.push_back(std::move(stages[ready]));
+    }
+  }
+
+  /** The stages in the order in which they are run */
+  auto const& stages() const noexcept { return stages_; }
+
+  /** The tensors passed from one stage to another */
+  auto const& intermediates() const noexcept { return intermediates_; }
+
+  /** Run every stage on the given batch */
+  void predict(Batch& batch) const
+  {
+    for (auto const& name : intermediates_) {
+      batch.declare_intermediate(name);
+    }
+    for (auto const& stage : stages_) {
+      auto range = nvtx_range{"stage: ", stage.name};
+      stage.predict(batch);
+    }
+  }
+
+ private:
+  std::vector<composition_stage> stages_;
+  std::vector<std::string> intermediates_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
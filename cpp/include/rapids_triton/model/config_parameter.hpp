@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <optional>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A typed declaration of a parameter read from the `parameters`
+ * section of a model's configuration
+ *
+ * Declaring parameters once and passing the declaration to
+ * `get_config_param` keeps the name, type and default value of each
+ * parameter in a single place:
+ *
+ * ```cpp
+ * inline auto constexpr tree_depth = config_parameter<std::size_t>{"tree_depth", 8};
+ * auto depth = get_config_param(tree_depth);
+ * ```
+ *
+ * A parameter declared without a default value is required, and reading it
+ * from a configuration which does not provide it is an error.
+ */
+template <typename T>
+struct config_parameter {
+  using value_type = T;
+
+  constexpr explicit config_parameter(char const* param_name) : name{param_name}, default_value{}
+  {
+  }
+  constexpr config_parameter(char const* param_name, T param_default)
+    : name{param_name}, default_value{param_default}
+  {
+  }
+
+  char const* name;
+  std::optional<T> default_value;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
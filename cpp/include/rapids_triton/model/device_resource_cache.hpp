@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <map>
+#include <memory>
+#include <mutex>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A cache of reference-counted resources keyed by name and device
+ *
+ * The first request for a given name and device constructs the resource;
+ * later requests for the same name and device receive the existing object
+ * for as long as any holder keeps it alive. Once every holder has released
+ * it, the next request constructs it anew. Resources for different keys may
+ * be constructed concurrently, but each is constructed only once.
+ */
+struct device_resource_cache {
+  device_resource_cache() : entries_{}, lock_{} {}
+  device_resource_cache(device_resource_cache const& other) = delete;
+  device_resource_cache& operator=(device_resource_cache const& other) = delete;
+
+  /**
+   * @brief Get the resource with the given name on the given device,
+   * constructing it with `factory` if it does not currently exist
+   *
+   * @param factory A callable returning either a T or a std::shared_ptr<T>
+   */
+  template <typename T, typename Factory>
+  auto get(std::string const& name, device_id_t device, Factory&& factory)
+  {
+    auto entry = get_entry(name, device);
+
+    auto guard = std::lock_guard<std::mutex>{entry->lock};
+    if (entry->type != std::type_index{typeid(T)} && !entry->resource.expired()) {
+      throw TritonException(Error::Internal,
+                            std::string{"Shared resource "} + name +
+                              " requested with a different type than it was created with");
+    }
+    auto result = std::static_pointer_cast<T>(entry->resource.lock());
+    if (!result) {
+      result          = make_resource<T>(std::forward<Factory>(factory));
+      entry->resource = result;
+      entry->type     = std::type_index{typeid(T)};
+    }
+    return result;
+  }
+
+ private:
+  struct entry_type {
+    entry_type() : lock{}, resource{}, type{typeid(void)} {}
+    std::mutex lock;
+    std::weak_ptr<void> resource;
+    std::type_index type;
+  };
+
+  std::map<std::pair<std::string, device_id_t>, std::shared_ptr<entry_type>> entries_;
+  std::mutex lock_;
+
+  auto get_entry(std::string const& name, device_id_t device)
+  {
+    auto guard  = std::lock_guard<std::mutex>{lock_};
+    auto& entry = entries_[std::make_pair(name, device)];
+    if (!entry) { entry = std::make_shared<entry_type>(); }
+    return entry;
+  }
+
+  template <typename T, typename Factory>
+  static auto make_resource(Factory&& factory)
+  {
+    auto result = std::shared_ptr<T>{};
+    if constexpr (std::is_convertible_v<std::invoke_result_t<Factory>, std::shared_ptr<T>>) {
+      result = factory();
+    } else {
+      result = std::make_shared<T>(factory());
+    }
+    return result;
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -20,15 +20,32 @@
 #else
 #include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
 #endif
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/batch/bucket.hpp>
+#include <rapids_triton/memory/placement_probe.hpp>
 #include <rapids_triton/memory/resource.hpp>
+#include <rapids_triton/model/artifact.hpp>
+#include <rapids_triton/model/config_parameter.hpp>
+#include <rapids_triton/model/schema.hpp>
+#include <rapids_triton/model/shard_group.hpp>
 #include <rapids_triton/model/shared_state.hpp>
+#include <rapids_triton/model/versioned_resource.hpp>
+#include <rapids_triton/tensor/layout.hpp>
+#include <rapids_triton/tensor/parallel_for_rows.hpp>
 #include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/triton/config.hpp>
 #include <rapids_triton/triton/deployment.hpp>
 #include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/utils/narrow.hpp>
+#include <rapids_triton/utils/stream_pool.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace triton {
@@ -38,34 +55,101 @@ template <typename SharedState = SharedModelState>
 struct Model {
   virtual void predict(Batch& batch) const = 0;
 
+  /**
+   * @brief Predict on a batch using only the host
+   *
+   * Models deployed on a GPU which implement this may opt into hybrid
+   * dispatch (see use_hybrid_dispatch), in which case batches too small to
+   * benefit from the device are passed here instead of to predict. The base
+   * implementation does not support host prediction.
+   */
+  virtual void predict_on_host(Batch& batch) const
+  {
+    throw TritonException(Error::Unsupported, "model does not support prediction on the host");
+  }
+
   virtual void load() {}
   virtual void unload() {}
 
+  /**
+   * @brief Prepare the model to serve its first requests without delay
+   *
+   * This is called after load and before the instance is ready for
+   * requests, followed by a synthetic batch of each of the sizes returned by
+   * warmup_batch_sizes. Models may override it for any preparation which
+   * synthetic batches cannot trigger, such as creating library handles for
+   * code paths that zero-filled inputs do not reach. The base implementation
+   * does nothing.
+   */
+  virtual void warmup() {}
+
+  /**
+   * @brief Load a new copy of the model's resources from its artifact while
+   * batches continue to use the current copy
+   *
+   * If the `reload_poll_interval_ms` configuration parameter is set, this is
+   * called on a background thread each time the artifact at get_filepath()
+   * is replaced, concurrently with predict. Implementations should build the
+   * new copy separately and publish it only once it is complete, e.g. with
+   * versioned_resource, so that each batch sees either the old copy or the
+   * new one. If this throws, the error is logged and the current copy
+   * remains in use. The base implementation does not support reloading.
+   */
+  virtual void reload()
+  {
+    throw TritonException(Error::Unsupported, "model does not support reloading its artifact");
+  }
+
   /**
    * @brief Return the preferred memory type in which to store data for this
    * batch or std::nullopt to accept whatever Triton returns
    *
    * The base implementation of this method will require data on-host if the
    * model itself is deployed on the host OR if this backend has not been
-   * compiled with GPU support. Otherwise, models deployed on device will
+   * compiled with GPU support, or if the batch is dispatched to the host
+   * (see use_hybrid_dispatch). Otherwise, models deployed on device will
    * receive memory on device. Overriding this method will allow derived
    * model classes to select a preferred memory location based on properties
    * of the batch or to simply return std::nullopt if device memory or host
    * memory will do equally well.
+   *
+   * If placement is calibrated (see get_memory_placement), the base
+   * implementations of preferred_mem_type_in and preferred_mem_type_out
+   * instead choose host or device memory for each batch by the size of its
+   * inputs and outputs, so models which enable it must accept either.
    */
   virtual std::optional<MemoryType> preferred_mem_type(Batch& batch) const
   {
-    return (IS_GPU_BUILD && deployment_type_ == GPUDeployment) ? DeviceMemory : HostMemory;
+    return (IS_GPU_BUILD && deployment_type_ == GPUDeployment && !batch.dispatched_to_host())
+             ? DeviceMemory
+             : HostMemory;
   }
   virtual std::optional<MemoryType> preferred_mem_type_in(Batch& batch) const
   {
+    if (memory_placement_ && !batch.dispatched_to_host()) {
+      return memory_placement_->input_mem_type(batch.bucket());
+    }
     return preferred_mem_type(batch);
   }
   virtual std::optional<MemoryType> preferred_mem_type_out(Batch& batch) const
   {
+    if (memory_placement_ && !batch.dispatched_to_host()) {
+      return memory_placement_->output_mem_type(batch.bucket());
+    }
     return preferred_mem_type(batch);
   }
 
+  /**
+   * @brief The choice of memory type for each batch by the size of its
+   * inputs and outputs, or nullptr if placement is not calibrated
+   *
+   * Placement is calibrated for GPU deployments with the
+   * `calibrate_memory_placement` configuration parameter set to true, by
+   * probing the transfer and launch costs of the model's device when the
+   * instance is initialized. See SharedModelState::get_memory_placement.
+   */
+  auto const* get_memory_placement() const { return memory_placement_.get(); }
+
   /**
    * @brief Retrieve a stream used to set up batches for this model
    *
@@ -78,6 +162,240 @@ struct Model {
    */
   virtual cudaStream_t get_stream() const { return default_stream_; }
 
+  /**
+   * @brief Acquire a stream from a pool owned by this model instance
+   *
+   * Pooled streams allow independent work within a single batch to proceed
+   * concurrently. Use `wait_for` to make a pooled stream wait on work
+   * already enqueued on the batch's stream and `join_into` to make the
+   * batch's stream wait on work enqueued on the pooled stream before
+   * returning from predict. The stream is returned to the pool when the
+   * returned object goes out of scope. Available only in GPU builds.
+   */
+  auto acquire_stream() const { return stream_pool_->acquire(); }
+
+  /**
+   * @brief Get the pool of worker threads shared by all instances of this
+   * model, e.g. to parallelize host computation for a batch
+   */
+  auto& get_thread_pool() const { return shared_state_->get_thread_pool(); }
+
+  /**
+   * @brief Call `fn(rows, first_row)` for blocks of rows of a host tensor in
+   * parallel on this model's thread pool
+   *
+   * `rows` is a TensorView of a block of consecutive rows and `first_row` is
+   * the index of its first row. See rapids::parallel_for_rows.
+   */
+  template <typename TensorType, typename F>
+  void parallel_for_rows(TensorType& tensor, F&& fn, std::size_t min_rows = 1) const
+  {
+    rapids::parallel_for_rows(get_thread_pool(), tensor, std::forward<F>(fn), min_rows);
+  }
+
+  /**
+   * @brief Return the maximum number of batches which may be in flight at
+   * once for a single instance of this model
+   *
+   * If this returns a value greater than 1, batches will be processed in a
+   * pipeline: while responses for one batch are being copied and sent, the
+   * next batch may be collected and predicted on a different stream. Each
+   * batch is assigned a stream which overrides get_stream, and models which
+   * opt into pipelining must enqueue all work for a batch on batch.stream()
+   * and must not share mutable state between predict calls. The base
+   * implementation reads the `max_in_flight_batches` configuration
+   * parameter, defaulting to 1 (no pipelining).
+   */
+  virtual std::size_t max_in_flight_batches() const
+  {
+    return get_config_param<std::size_t>("max_in_flight_batches", std::size_t{1});
+  }
+
+  /**
+   * @brief Return whether each instance should wait for output copies, send
+   * responses, report statistics and release requests on a background thread
+   *
+   * The execute thread then returns to Triton as soon as the work for a
+   * batch has been enqueued, which shortens the time between batches made
+   * up of many requests. Batches remain on the model's stream, so unlike
+   * pipelined execution this requires no changes to predict. It is implied
+   * whenever max_in_flight_batches is greater than 1. The base implementation
+   * reads the `completion_thread` configuration parameter, defaulting to
+   * false.
+   */
+  virtual bool use_completion_thread() const
+  {
+    return get_config_param<bool>("completion_thread", false);
+  }
+
+  /**
+   * @brief Return the maximum number of rows which may be passed to a single
+   * call of predict, or 0 for no limit
+   *
+   * If a batch has more rows than this, predict is called once for each
+   * slice of at most this many rows, and inputs and outputs obtained during
+   * each call cover only the rows of that slice (see
+   * Batch::for_each_row_slice). This bounds the working memory of models
+   * whose scratch requirements grow faster than their batch size. The base
+   * implementation reads the `max_rows_per_predict` configuration
+   * parameter, defaulting to 0.
+   */
+  virtual std::size_t max_rows_per_predict() const
+  {
+    return get_config_param<std::size_t>("max_rows_per_predict", std::size_t{});
+  }
+
+  /**
+   * @brief Return whether the work enqueued by predict should be captured in
+   * CUDA graphs and replayed for later batches
+   *
+   * This is only honored for GPU deployments of batched models which process
+   * one batch at a time and do not predict in row slices. Models which opt
+   * in must meet the requirements of Batch::predict_with_graph. The base
+   * implementation reads the `cuda_graphs` configuration parameter,
+   * defaulting to false.
+   */
+  virtual bool use_cuda_graphs() const { return get_config_param<bool>("cuda_graphs", false); }
+
+  /**
+   * @brief Return whether the device time taken by the work enqueued during
+   * predict should be measured with CUDA events on the batch's stream
+   *
+   * Host timestamps around predict mostly measure kernel launches, so this
+   * distinguishes instances bound by device work from those bound by the
+   * host. It is reported as the `device` phase of the latency metrics and is
+   * only honored for GPU deployments with latency metrics enabled. The base
+   * implementation reads the `device_timing` configuration parameter,
+   * defaulting to false.
+   */
+  virtual bool use_device_timing() const { return get_config_param<bool>("device_timing", false); }
+
+  /**
+   * @brief Return whether each batch should be predicted either by predict
+   * on the device or by predict_on_host, according to its size
+   *
+   * Batches of up to a threshold number of rows are dispatched to the host.
+   * The threshold is read from the `hybrid_dispatch_max_host_rows`
+   * configuration parameter if it is nonzero and is otherwise learned at
+   * warmup by timing both paths for each of warmup_batch_sizes. This is only
+   * honored for GPU deployments. The base implementation reads the
+   * `hybrid_dispatch` configuration parameter, defaulting to false.
+   */
+  virtual bool use_hybrid_dispatch() const
+  {
+    return get_config_param<bool>("hybrid_dispatch", false);
+  }
+
+  /**
+   * @brief Return whether batches which cannot be processed on the device
+   * should be predicted by predict_on_host instead of failing or waiting
+   *
+   * A batch falls back to the host if it is not admitted under the model's
+   * device_predict_concurrency within `host_fallback_wait_ms` milliseconds
+   * (0 by default), or if predict fails with Error::Unavailable because
+   * device memory or the model's device memory budget is exhausted. This is
+   * only honored for GPU deployments. The base implementation reads the
+   * `host_fallback` configuration parameter, defaulting to false.
+   */
+  virtual bool use_host_fallback() const { return get_config_param<bool>("host_fallback", false); }
+
+  /**
+   * @brief Return whether each instance should collect inputs and copy
+   * outputs into responses on dedicated copy streams
+   *
+   * Transfers are then ordered with respect to the batch's stream by events,
+   * so that with pipelined execution the copies of one batch can overlap
+   * with the kernels of another. This is only honored for GPU deployments.
+   * The base implementation reads the `copy_streams` configuration
+   * parameter, defaulting to false.
+   */
+  virtual bool use_copy_streams() const { return get_config_param<bool>("copy_streams", false); }
+
+  /**
+   * @brief Return whether inputs retrieved together with get_inputs should
+   * be gathered concurrently, each on its own thread and stream
+   *
+   * This benefits models with several large inputs, whose collection then
+   * takes about as long as the largest of them. Threads are taken from the
+   * model's thread pool. The base implementation reads the
+   * `concurrent_input_collection` configuration parameter, defaulting to
+   * false.
+   */
+  virtual bool use_concurrent_input_collection() const
+  {
+    return get_config_param<bool>("concurrent_input_collection", false);
+  }
+
+  /**
+   * @brief Return the batch sizes to which batches should be padded before
+   * they are passed to predict, in increasing order
+   *
+   * Each batch is padded with zeros up to the smallest of these sizes which
+   * can hold it, so that models with kernels specialized for particular
+   * batch sizes see only those sizes (see Batch::pad_to_bucket and
+   * dispatch_bucket). Batches larger than every bucket are not padded. This
+   * is ignored for models which predict in row slices. The base
+   * implementation parses the comma-separated `batch_buckets` configuration
+   * parameter, defaulting to no buckets.
+   */
+  virtual std::vector<std::size_t> batch_buckets() const
+  {
+    return parse_batch_buckets(get_config_param<std::string>("batch_buckets", std::string{}));
+  }
+
+  /**
+   * @brief Return the latency which a batch may add to requests with
+   * deadlines, or zero for no limit
+   *
+   * If a batch is estimated to take longer than this, the requests in it
+   * whose clients set a timeout are predicted and answered first, as a
+   * separate batch, before the remaining requests are processed. This keeps
+   * large bulk batches from delaying interactive requests. The estimate is
+   * based on the time per row of recent batches. The base implementation
+   * reads the `latency_budget_us` configuration parameter, defaulting to 0.
+   */
+  virtual std::chrono::microseconds latency_budget() const
+  {
+    return std::chrono::microseconds{
+      get_config_param<std::uint64_t>("latency_budget_us", std::uint64_t{})};
+  }
+
+  /**
+   * @brief Return the latency target for requests held by rapids_triton's own
+   * accumulation queue, or zero to process each call to execute at once
+   *
+   * If this is nonzero for a batched model, requests are held across calls
+   * to execute and released in batches sized from the measured latency of
+   * recent batches of each size (see request_accumulator), so that batches
+   * are as large as possible while the 99th percentile latency of each
+   * request stays within the target. This is most useful for models whose
+   * throughput rises sharply with batch size. The base implementation reads
+   * the `accumulation_target_us` configuration parameter, defaulting to 0.
+   */
+  virtual std::chrono::microseconds accumulation_target() const
+  {
+    return std::chrono::microseconds{
+      get_config_param<std::uint64_t>("accumulation_target_us", std::uint64_t{})};
+  }
+
+  /**
+   * @brief Return the numbers of rows of the synthetic batches passed to
+   * predict before the instance is ready for requests
+   *
+   * Each synthetic batch has zero-filled inputs of the types and shapes in
+   * the model configuration and is processed as a batch of requests would
+   * be (see Batch::synthesize_inputs), so that lazy CUDA module loading,
+   * memory pool growth and library handle creation are paid for before the
+   * first request rather than by it. Sizes larger than max_batch_size are
+   * skipped, and models without batching run one batch if any size is
+   * given. The base implementation parses the comma-separated
+   * `warmup_batch_sizes` configuration parameter, defaulting to no sizes.
+   */
+  virtual std::vector<std::size_t> warmup_batch_sizes() const
+  {
+    return parse_batch_buckets(get_config_param<std::string>("warmup_batch_sizes", std::string{}));
+  }
+
   /**
    * @brief Get input tensor of a particular named input for an entire batch
    */
@@ -94,12 +412,208 @@ struct Model {
                  std::string const& name,
                  std::optional<MemoryType> const& mem_type) const
   {
-    return get_input<T>(batch, name, mem_type, default_stream_);
+    return get_input<T>(batch, name, mem_type, batch.stream());
   }
   template <typename T>
   auto get_input(Batch& batch, std::string const& name) const
   {
-    return get_input<T>(batch, name, preferred_mem_type(batch), default_stream_);
+    return get_input<T>(batch, name, preferred_mem_type_in(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get an input tensor for an entire batch stored in the given
+   * layout (e.g. ColumnMajor)
+   *
+   * See Batch::get_input.
+   */
+  template <typename T>
+  auto get_input(Batch& batch,
+                 std::string const& name,
+                 std::optional<MemoryType> const& mem_type,
+                 TensorLayout layout) const
+  {
+    return batch.get_input<T const>(name, mem_type, device_id_, batch.stream(), layout);
+  }
+  template <typename T>
+  auto get_input(Batch& batch, std::string const& name, TensorLayout layout) const
+  {
+    return get_input<T>(batch, name, preferred_mem_type_in(batch), layout);
+  }
+
+  /**
+   * @brief Get the input at index I of a schema bound with bind_schema for
+   * an entire batch
+   *
+   * The element type of the returned tensor is fixed by the schema, and its
+   * type and rank were checked against the configuration when the schema
+   * was bound.
+   */
+  template <std::size_t I, typename Inputs, typename Outputs>
+  auto get_input(Batch& batch,
+                 bound_schema<Inputs, Outputs> const& schema,
+                 std::optional<MemoryType> const& mem_type,
+                 cudaStream_t stream) const
+  {
+    using value_type = typename Inputs::template field_type<I>::value_type;
+    return batch.get_input<value_type const>(
+      schema.inputs.template field<I>().name, mem_type, device_id_, stream);
+  }
+  template <std::size_t I, typename Inputs, typename Outputs>
+  auto get_input(Batch& batch,
+                 bound_schema<Inputs, Outputs> const& schema,
+                 std::optional<MemoryType> const& mem_type) const
+  {
+    return get_input<I>(batch, schema, mem_type, batch.stream());
+  }
+  template <std::size_t I, typename Inputs, typename Outputs>
+  auto get_input(Batch& batch, bound_schema<Inputs, Outputs> const& schema) const
+  {
+    return get_input<I>(batch, schema, preferred_mem_type_in(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get an input tensor for an entire batch, converting it to type T
+   * if it was sent as any of the types in Sources
+   *
+   * See Batch::get_converted_input.
+   */
+  template <typename T, typename... Sources>
+  auto get_converted_input(Batch& batch,
+                           std::string const& name,
+                           std::optional<MemoryType> const& mem_type,
+                           cudaStream_t stream) const
+  {
+    return batch.get_converted_input<T const, Sources...>(name, mem_type, device_id_, stream);
+  }
+  template <typename T, typename... Sources>
+  auto get_converted_input(Batch& batch,
+                           std::string const& name,
+                           std::optional<MemoryType> const& mem_type) const
+  {
+    return get_converted_input<T, Sources...>(batch, name, mem_type, batch.stream());
+  }
+  template <typename T, typename... Sources>
+  auto get_converted_input(Batch& batch, std::string const& name) const
+  {
+    return get_converted_input<T, Sources...>(
+      batch, name, preferred_mem_type_in(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get an input whose shape may differ between requests as a
+   * RaggedTensor, with the data of all requests packed without padding
+   */
+  template <typename T>
+  auto get_ragged_input(Batch& batch,
+                        std::string const& name,
+                        std::optional<MemoryType> const& mem_type,
+                        cudaStream_t stream) const
+  {
+    return batch.get_ragged_input<T const>(name, mem_type, device_id_, stream);
+  }
+  template <typename T>
+  auto get_ragged_input(Batch& batch,
+                        std::string const& name,
+                        std::optional<MemoryType> const& mem_type) const
+  {
+    return get_ragged_input<T>(batch, name, mem_type, batch.stream());
+  }
+  template <typename T>
+  auto get_ragged_input(Batch& batch, std::string const& name) const
+  {
+    return get_ragged_input<T>(batch, name, preferred_mem_type_in(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get a sparse matrix sent as three CSR inputs (row pointers,
+   * column indices and values) as a SparseTensor stacking the rows of every
+   * request
+   */
+  template <typename T>
+  auto get_sparse_input(Batch& batch,
+                        std::string const& indptr_name,
+                        std::string const& indices_name,
+                        std::string const& values_name,
+                        std::size_t cols,
+                        std::optional<MemoryType> const& mem_type,
+                        cudaStream_t stream) const
+  {
+    return batch.get_sparse_input<T const>(
+      indptr_name, indices_name, values_name, cols, mem_type, device_id_, stream);
+  }
+  template <typename T>
+  auto get_sparse_input(Batch& batch,
+                        std::string const& indptr_name,
+                        std::string const& indices_name,
+                        std::string const& values_name,
+                        std::size_t cols,
+                        std::optional<MemoryType> const& mem_type) const
+  {
+    return get_sparse_input<T>(
+      batch, indptr_name, indices_name, values_name, cols, mem_type, batch.stream());
+  }
+  template <typename T>
+  auto get_sparse_input(Batch& batch,
+                        std::string const& indptr_name,
+                        std::string const& indices_name,
+                        std::string const& values_name,
+                        std::size_t cols) const
+  {
+    return get_sparse_input<T>(batch,
+                               indptr_name,
+                               indices_name,
+                               values_name,
+                               cols,
+                               preferred_mem_type_in(batch),
+                               batch.stream());
+  }
+
+  /**
+   * @brief Get a BYTES input for an entire batch as a StringTensor
+   */
+  auto get_string_input(Batch& batch,
+                        std::string const& name,
+                        std::optional<MemoryType> const& mem_type,
+                        cudaStream_t stream) const
+  {
+    return batch.get_string_input(name, mem_type, device_id_, stream);
+  }
+  auto get_string_input(Batch& batch,
+                        std::string const& name,
+                        std::optional<MemoryType> const& mem_type) const
+  {
+    return get_string_input(batch, name, mem_type, batch.stream());
+  }
+  auto get_string_input(Batch& batch, std::string const& name) const
+  {
+    return get_string_input(batch, name, preferred_mem_type_in(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get input tensors for several named inputs for an entire batch
+   *
+   * All inputs are collected together, requiring at most one stream
+   * synchronization, and returned as a tuple in the order of the given names
+   */
+  template <typename... Ts>
+  auto get_inputs(Batch& batch,
+                  std::array<std::string, sizeof...(Ts)> const& names,
+                  std::optional<MemoryType> const& mem_type,
+                  cudaStream_t stream) const
+  {
+    return batch.get_inputs<Ts const...>(names, mem_type, device_id_, stream);
+  }
+  template <typename... Ts>
+  auto get_inputs(Batch& batch,
+                  std::array<std::string, sizeof...(Ts)> const& names,
+                  std::optional<MemoryType> const& mem_type) const
+  {
+    return get_inputs<Ts...>(batch, names, mem_type, batch.stream());
+  }
+  template <typename... Ts>
+  auto get_inputs(Batch& batch, std::array<std::string, sizeof...(Ts)> const& names) const
+  {
+    return get_inputs<Ts...>(batch, names, preferred_mem_type_in(batch), batch.stream());
   }
 
   /**
@@ -127,16 +641,165 @@ struct Model {
                   std::string const& name,
                   std::optional<MemoryType> const& mem_type) const
   {
-    return get_output<T>(batch, name, mem_type, device_id_, default_stream_);
+    return get_output<T>(batch, name, mem_type, device_id_, batch.stream());
   }
   template <typename T>
   auto get_output(Batch& batch, std::string const& name) const
   {
-    return get_output<T>(batch, name, preferred_mem_type(batch), device_id_, default_stream_);
+    return get_output<T>(batch, name, preferred_mem_type_out(batch), device_id_, batch.stream());
+  }
+
+  /**
+   * @brief Get the output at index I of a schema bound with bind_schema for
+   * an entire batch
+   *
+   * The shape is computed from the configured shape cached when the schema
+   * was bound, without looking it up by name.
+   */
+  template <std::size_t I, typename Inputs, typename Outputs>
+  auto get_output(Batch& batch,
+                  bound_schema<Inputs, Outputs> const& schema,
+                  std::optional<MemoryType> const& mem_type,
+                  cudaStream_t stream) const
+  {
+    using value_type = typename Outputs::template field_type<I>::value_type;
+    return batch.get_output<value_type>(
+      schema.outputs.template field<I>().name,
+      resolve_output_shape(std::get<I>(schema.output_shapes), batch.output_rows()),
+      mem_type,
+      device_id_,
+      stream);
+  }
+  template <std::size_t I, typename Inputs, typename Outputs>
+  auto get_output(Batch& batch,
+                  bound_schema<Inputs, Outputs> const& schema,
+                  std::optional<MemoryType> const& mem_type) const
+  {
+    return get_output<I>(batch, schema, mem_type, batch.stream());
+  }
+  template <std::size_t I, typename Inputs, typename Outputs>
+  auto get_output(Batch& batch, bound_schema<Inputs, Outputs> const& schema) const
+  {
+    return get_output<I>(batch, schema, preferred_mem_type_out(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get an output tensor of a shape determined at predict time
+   *
+   * See Batch::get_output.
+   */
+  template <typename T>
+  auto get_output(Batch& batch,
+                  std::string const& name,
+                  std::vector<Batch::size_type> shape,
+                  std::optional<MemoryType> const& mem_type,
+                  cudaStream_t stream) const
+  {
+    return batch.get_output<T>(name, std::move(shape), mem_type, device_id_, stream);
+  }
+  template <typename T>
+  auto get_output(Batch& batch, std::string const& name, std::vector<Batch::size_type> shape) const
+  {
+    return get_output<T>(
+      batch, name, std::move(shape), preferred_mem_type_out(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get temporary storage for `count` elements which remains valid
+   * until the batch completes
+   *
+   * See Batch::scratch. Without an explicit location, storage is on the
+   * model's device for GPU deployments and on the host otherwise.
+   */
+  template <typename T>
+  auto get_scratch(Batch& batch,
+                   Batch::size_type count,
+                   MemoryType mem_type,
+                   cudaStream_t stream) const
+  {
+    return batch.scratch<T>(count, mem_type, device_id_, stream);
+  }
+  template <typename T>
+  auto get_scratch(Batch& batch, Batch::size_type count, MemoryType mem_type) const
+  {
+    return get_scratch<T>(batch, count, mem_type, batch.stream());
+  }
+  template <typename T>
+  auto get_scratch(Batch& batch, Batch::size_type count) const
+  {
+    auto mem_type = (get_deployment_type() == GPUDeployment) ? DeviceMemory : HostMemory;
+    return get_scratch<T>(batch, count, mem_type, batch.stream());
+  }
+
+  /**
+   * @brief Get an output for an entire batch which is written directly into
+   * the response buffer of each request
+   *
+   * The returned SegmentedTensor has one segment per request. Writing
+   * results directly into these segments avoids the additional copy
+   * required to scatter a batch-wide output into responses.
+   */
+  template <typename T>
+  auto get_response_output(Batch& batch,
+                           std::string const& name,
+                           std::optional<MemoryType> const& mem_type,
+                           cudaStream_t stream) const
+  {
+    return batch.get_response_output<T>(name, mem_type, device_id_, stream);
+  }
+  template <typename T>
+  auto get_response_output(Batch& batch, std::string const& name) const
+  {
+    return get_response_output<T>(batch, name, preferred_mem_type_out(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get an output written directly into each response, allocating
+   * exactly the given shape for each request
+   *
+   * This supports outputs whose size is only known after computation. See
+   * Batch::get_response_output.
+   */
+  template <typename T>
+  auto get_response_output(Batch& batch,
+                           std::string const& name,
+                           std::vector<std::vector<Batch::size_type>> shapes,
+                           std::optional<MemoryType> const& mem_type,
+                           cudaStream_t stream) const
+  {
+    return batch.get_response_output<T>(name, std::move(shapes), mem_type, device_id_, stream);
+  }
+  template <typename T>
+  auto get_response_output(Batch& batch,
+                           std::string const& name,
+                           std::vector<std::vector<Batch::size_type>> shapes) const
+  {
+    return get_response_output<T>(
+      batch, name, std::move(shapes), preferred_mem_type_out(batch), batch.stream());
+  }
+
+  /**
+   * @brief Get a stream for sending several responses to one request of
+   * the batch, e.g. to return partial results as they become available
+   *
+   * The model must be configured with a decoupled transaction policy. See
+   * Batch::response_stream.
+   */
+  auto& get_response_stream(Batch& batch, std::size_t request_index) const
+  {
+    if (!shared_state_->is_decoupled()) {
+      throw TritonException(Error::Internal,
+                            "Response streams require a decoupled transaction policy");
+    }
+    return batch.response_stream(request_index);
   }
 
   /**
    * @brief Retrieve value of configuration parameter
+   *
+   * Parameters are parsed from the model configuration once, and typed values
+   * are cached after the first successful read, so this may be called from
+   * `predict` without re-parsing the configuration.
    */
   template <typename T>
   auto get_config_param(std::string const& name) const
@@ -158,6 +821,11 @@ struct Model {
   {
     return get_config_param<T>(std::string(name), default_value);
   }
+  template <typename T>
+  auto get_config_param(config_parameter<T> const& parameter) const
+  {
+    return shared_state_->get_config_param(parameter);
+  }
 
   Model(std::shared_ptr<SharedState> shared_state,
         device_id_t device_id,
@@ -168,20 +836,99 @@ struct Model {
       device_id_{device_id},
       default_stream_{default_stream},
       deployment_type_{deployment_type},
-      filepath_{filepath}
+      filepath_{filepath},
+      stream_pool_{std::make_shared<stream_pool>(device_id)},
+      shards_{make_shards()},
+      memory_placement_{}
   {
-    if constexpr (IS_GPU_BUILD) { setup_memory_resource(device_id_); }
+    if constexpr (IS_GPU_BUILD) {
+      setup_memory_resource(device_id_);
+      if (shards_) {
+        for (auto device : shards_->devices()) {
+          setup_memory_resource(device);
+        }
+      }
+      // Probed only once the device's memory resource is in place
+      if (deployment_type_ == GPUDeployment) {
+        memory_placement_ = shared_state_->get_memory_placement(device_id_);
+      }
+    }
   }
 
   auto get_device_id() const { return device_id_; }
   auto get_deployment_type() const { return deployment_type_; }
   auto const& get_filepath() const { return filepath_; }
 
-  auto get_output_shape(std::string const& name) const
+  /**
+   * @brief Memory-map the model artifact at `get_filepath()`
+   *
+   * See mapped_artifact for details. The returned object must be kept alive
+   * for as long as any view of its data is in use.
+   */
+  auto map_artifact(artifact_options options = artifact_options{}) const
+  {
+    return mapped_artifact{filepath_, options};
+  }
+
+  /**
+   * @brief Get a resource shared with all other instances of this model on
+   * the same device, constructing it with `factory` if necessary
+   *
+   * This is typically called from `load` to obtain model weights, which are
+   * then loaded only by the first instance on each device. See
+   * SharedModelState::get_device_resource.
+   */
+  template <typename T, typename Factory>
+  auto get_device_resource(std::string const& name, Factory&& factory) const
+  {
+    return shared_state_->template get_device_resource<T>(
+      name, device_id_, std::forward<Factory>(factory));
+  }
+
+  auto const& get_output_shape(std::string const& name) const
   {
     return shared_state_->get_output_shape(name);
   }
 
+  /**
+   * @brief Check declared input and output schemas against the model
+   * configuration, for use with the index-based get_input and get_output
+   *
+   * See SharedModelState::bind_schema.
+   */
+  template <typename Inputs, typename Outputs>
+  auto bind_schema(Inputs const& inputs, Outputs const& outputs) const
+  {
+    return shared_state_->bind_schema(inputs, outputs);
+  }
+
+  /**
+   * @brief The devices over which this instance is sharded, or nullptr if it
+   * runs on its own device alone
+   *
+   * Sharding is enabled by setting the `shard_devices` parameter to a
+   * comma-separated list of device IDs for a GPU deployment. See
+   * shard_group for how inputs and outputs are divided among the shards.
+   */
+  auto const* get_shards() const { return shards_.get(); }
+
+  /**
+   * @brief Get a resource split across the devices of this sharded instance,
+   * constructing any shard which does not exist with `factory(shard,
+   * shard_count)`
+   *
+   * See SharedModelState::get_sharded_resource.
+   */
+  template <typename T, typename Factory>
+  auto get_sharded_resource(std::string const& name, Factory&& factory) const
+  {
+    if (!shards_) {
+      throw TritonException(Error::Internal, "Sharded resource requested for unsharded model");
+    }
+    return shared_state_->template get_sharded_resource<T>(
+      name, shards_->devices(), std::forward<Factory>(factory));
+  }
+
  protected:
   auto get_shared_state() const { return shared_state_; }
 
@@ -191,6 +938,20 @@ struct Model {
   cudaStream_t default_stream_;
   DeploymentType deployment_type_;
   std::string filepath_;
+  std::shared_ptr<stream_pool> stream_pool_;
+  std::shared_ptr<shard_group> shards_;
+  std::shared_ptr<memory_placement const> memory_placement_;
+
+  std::shared_ptr<shard_group> make_shards() const
+  {
+    auto devices = parse_device_list(
+      shared_state_->template get_config_param<std::string>("shard_devices", std::string{}));
+    if (devices.empty()) { return std::shared_ptr<shard_group>{}; }
+    if (deployment_type_ != GPUDeployment) {
+      throw TritonException(Error::InvalidArg, "shard_devices requires a GPU deployment");
+    }
+    return std::make_shared<shard_group>(std::move(devices));
+  }
 };
 }  // namespace rapids
 }  // namespace backend
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A typed declaration of one input or output of a model, with the
+ * element type and number of dimensions (including any batch dimension)
+ * which the model expects for it
+ */
+template <typename T, std::size_t Rank>
+struct tensor_field {
+  using value_type           = T;
+  static auto constexpr rank = Rank;
+
+  constexpr explicit tensor_field(char const* field_name) : name{field_name} {}
+
+  char const* name;
+};
+
+/**
+ * @brief An ordered list of tensor_field declarations for the inputs or
+ * outputs of a model
+ *
+ * Declaring inputs and outputs once allows them to be checked against the
+ * model configuration when the model is loaded (see
+ * SharedModelState::bind_schema) and then retrieved by index, with their
+ * types fixed at compile time:
+ *
+ * ```cpp
+ * inline auto constexpr inputs  = tensor_schema{tensor_field<float, 2>{"input__0"}};
+ * inline auto constexpr outputs = tensor_schema{tensor_field<float, 2>{"output__0"}};
+ * ```
+ */
+template <typename... Fields>
+struct tensor_schema {
+  static auto constexpr size = sizeof...(Fields);
+  template <std::size_t I>
+  using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+  constexpr explicit tensor_schema(Fields... schema_fields) : fields{schema_fields...} {}
+
+  template <std::size_t I>
+  constexpr auto const& field() const
+  {
+    return std::get<I>(fields);
+  }
+
+  std::tuple<Fields...> fields;
+};
+
+/**
+ * @brief The input and output schemas of a model, together with the
+ * configured shapes of its outputs, once both have been checked against the
+ * model configuration
+ *
+ * Objects of this type should be obtained from SharedModelState::bind_schema
+ * (or Model::bind_schema) at load time and passed to the index-based
+ * overloads of Model::get_input and Model::get_output.
+ */
+template <typename Inputs, typename Outputs>
+struct bound_schema {
+  using output_shape_type = std::vector<std::int64_t>;
+
+  bound_schema(Inputs schema_inputs,
+               Outputs schema_outputs,
+               std::array<output_shape_type, Outputs::size> configured_output_shapes)
+    : inputs{schema_inputs},
+      outputs{schema_outputs},
+      output_shapes{std::move(configured_output_shapes)}
+  {
+  }
+
+  Inputs inputs;
+  Outputs outputs;
+  /** The configured shape of each output, in the same form as
+   * SharedModelState::get_output_shape */
+  std::array<output_shape_type, Outputs::size> output_shapes;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/triton/requests.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/** The state slot assigned to one request of a batch */
+struct sequence_slot {
+  std::size_t index;
+  /** Whether the slot's contents must be initialized before use */
+  bool fresh;
+};
+
+/**
+ * @brief Storage for per-sequence model state which persists between
+ * requests
+ *
+ * The store holds a fixed number of state slots of `state_size` elements
+ * each in a single allocation, so that state can remain in device memory
+ * across calls and be indexed by slot from within a kernel. Each call to
+ * `assign` maps the correlation IDs of a batch to slots: a request which
+ * starts a sequence receives a fresh slot, and later requests in the same
+ * sequence receive that slot again. Slots of sequences which have ended are
+ * reclaimed on the following call to `assign`, so they remain valid
+ * throughout the batch in which they end.
+ *
+ * If more sequences are active than there are slots, the least-recently
+ * used sequence which is not part of the current batch is evicted. A later
+ * request from an evicted sequence receives a fresh slot. Stores are
+ * intended to be owned by a single model instance and are not thread-safe.
+ */
+template <typename T>
+struct SequenceStateStore {
+  using size_type = std::size_t;
+
+  SequenceStateStore(size_type max_sequences,
+                     size_type state_size,
+                     MemoryType mem_type = DeviceMemory,
+                     device_id_t device  = 0,
+                     cudaStream_t stream = 0)
+    : states_{max_sequences * state_size, mem_type, device, stream},
+      state_size_{state_size},
+      slots_{},
+      owners_(max_sequences),
+      last_use_(max_sequences),
+      free_slots_(max_sequences),
+      ended_{},
+      clock_{}
+  {
+    if (max_sequences == 0) {
+      throw TritonException(Error::Internal, "sequence state store must have at least one slot");
+    }
+    // Hand out low slots first
+    std::generate(std::rbegin(free_slots_), std::rend(free_slots_), [next = size_type{}]() mutable {
+      return next++;
+    });
+  }
+
+  /**
+   * @brief Assign a state slot to each request of a batch
+   *
+   * @param controls The sequence control information for each request, as
+   * returned by Batch::get_sequence_controls
+   */
+  auto assign(std::vector<sequence_control> const& controls)
+  {
+    ++clock_;
+    std::for_each(std::begin(ended_), std::end(ended_), [this](auto id) { release(id); });
+    ended_.clear();
+
+    auto result = std::vector<sequence_slot>{};
+    result.reserve(controls.size());
+    std::transform(
+      std::begin(controls), std::end(controls), std::back_inserter(result), [this](auto& control) {
+        auto slot = assign_slot(control);
+        if (control.end) { ended_.push_back(control.correlation_id); }
+        return slot;
+      });
+    return result;
+  }
+
+  /** Immediately release the slot held by the given sequence, if any */
+  void release(std::uint64_t correlation_id)
+  {
+    auto found = slots_.find(correlation_id);
+    if (found != std::end(slots_)) {
+      owners_[found->second].reset();
+      free_slots_.push_back(found->second);
+      slots_.erase(found);
+    }
+  }
+
+  /** A view of the state held in the given slot */
+  auto state(size_type slot, cudaStream_t stream = 0)
+  {
+    if (slot >= capacity()) { throw TritonException(Error::Internal, "invalid state slot"); }
+    return TensorView<T>{states_.data() + slot * state_size_,
+                         std::vector<size_type>{state_size_},
+                         states_.mem_type(),
+                         states_.device(),
+                         stream};
+  }
+
+  /** Pointer to the state of slot 0; slot i begins i * state_size() elements later */
+  auto* data() { return states_.data(); }
+  auto state_size() const noexcept { return state_size_; }
+  auto capacity() const noexcept { return owners_.size(); }
+  auto active_sequences() const noexcept { return slots_.size(); }
+  auto mem_type() const noexcept { return states_.mem_type(); }
+  auto device() const noexcept { return states_.device(); }
+
+ private:
+  Buffer<T> states_;
+  size_type state_size_;
+  std::unordered_map<std::uint64_t, size_type> slots_;
+  std::vector<std::optional<std::uint64_t>> owners_;
+  std::vector<std::uint64_t> last_use_;
+  std::vector<size_type> free_slots_;
+  std::vector<std::uint64_t> ended_;
+  std::uint64_t clock_;
+
+  sequence_slot assign_slot(sequence_control const& control)
+  {
+    if (control.correlation_id == 0) {
+      throw TritonException(Error::InvalidArg, "sequence request has no correlation ID");
+    }
+    auto result = sequence_slot{};
+    auto found  = slots_.find(control.correlation_id);
+    if (found == std::end(slots_)) {
+      if (!control.start) {
+        log_warn(__FILE__, __LINE__) << "No state for sequence " << control.correlation_id
+                                     << "; it may have been evicted";
+      }
+      result.index = take_slot();
+      result.fresh = true;
+      slots_.emplace(control.correlation_id, result.index);
+      owners_[result.index] = control.correlation_id;
+    } else {
+      result.index = found->second;
+      result.fresh = control.start;
+    }
+    last_use_[result.index] = clock_;
+    return result;
+  }
+
+  size_type take_slot()
+  {
+    if (free_slots_.empty()) {
+      // Evict the least-recently used sequence not seen in this batch
+      auto victim = std::optional<size_type>{};
+      for (auto slot = size_type{}; slot < capacity(); ++slot) {
+        if (owners_[slot] && last_use_[slot] < clock_ &&
+            (!victim || last_use_[slot] < last_use_[*victim])) {
+          victim = slot;
+        }
+      }
+      if (!victim) {
+        throw TritonException(Error::Unavailable,
+                              "batch contains more sequences than available state slots");
+      }
+      log_warn(__FILE__, __LINE__) << "Evicting state for sequence " << *owners_[*victim];
+      release(*owners_[*victim]);
+    }
+    auto result = free_slots_.back();
+    free_slots_.pop_back();
+    return result;
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
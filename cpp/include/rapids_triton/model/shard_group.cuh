@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __CUDACC__
+#error "rapids_triton/model/shard_group.cuh must be compiled with a CUDA compiler"
+#endif
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/model/shard_group.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+template <typename T>
+__global__ void accumulate_kernel(T* __restrict__ dst, T const* __restrict__ src, std::size_t len)
+{
+  auto stride = std::size_t{blockDim.x} * gridDim.x;
+  for (auto i = std::size_t{blockIdx.x} * blockDim.x + threadIdx.x; i < len; i += stride) {
+    dst[i] += src[i];
+  }
+}
+
+template <typename T>
+void launch_accumulate(T* dst, T const* src, std::size_t len, cudaStream_t stream)
+{
+  auto constexpr threads_per_block = std::size_t{256};
+  auto constexpr max_blocks        = std::size_t{4096};
+  auto blocks = std::min((len + threads_per_block - 1) / threads_per_block, max_blocks);
+  accumulate_kernel<<<blocks, threads_per_block, 0, stream>>>(dst, src, len);
+  cuda_check(cudaPeekAtLastError());
+}
+
+}  // namespace detail
+
+/**
+ * @brief Reduce partial device outputs of type T on their device in every
+ * translation unit, including those compiled without a CUDA compiler
+ *
+ * Until this is called, `shard_group::reduce` sums such outputs on the host.
+ */
+template <typename T>
+void register_device_reduction()
+{
+  detail::set_device_launcher<detail::accumulate_kernel_tag, detail::accumulate_launcher<T>>(
+    &detail::launch_accumulate<T>);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
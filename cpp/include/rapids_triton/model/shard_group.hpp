@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/cuda_event.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+#include <rapids_triton/utils/device_setter.hpp>
+#include <rapids_triton/utils/stream_pool.hpp>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+/* Partial device outputs are reduced through launchers registered by
+ * rapids_triton/model/shard_group.cuh */
+struct accumulate_kernel_tag {};
+template <typename T>
+using accumulate_launcher = void(T*, T const*, std::size_t, cudaStream_t);
+
+/** Whether partial device outputs of type T can be reduced on the device */
+template <typename T>
+auto device_reduction_available()
+{
+  return get_device_launcher<accumulate_kernel_tag, accumulate_launcher<T>>() != nullptr;
+}
+
+template <typename T>
+void accumulate(T* dst, T const* src, std::size_t len, cudaStream_t stream)
+{
+  auto* launch = get_device_launcher<accumulate_kernel_tag, accumulate_launcher<T>>();
+  if (launch == nullptr) {
+    throw TritonException(Error::Internal,
+                          "Device reduction requires registering its kernel from a "
+                          "translation unit compiled with a CUDA compiler");
+  }
+  if (len != 0) { launch(dst, src, len, stream); }
+}
+}  // namespace detail
+
+/**
+ * @brief Parse a comma-separated list of device IDs (e.g. "0,1,2,3")
+ */
+inline auto parse_device_list(std::string const& spec)
+{
+  auto result       = std::vector<device_id_t>{};
+  auto input_stream = std::istringstream{spec};
+  auto entry        = std::string{};
+  while (std::getline(input_stream, entry, ',')) {
+    auto entry_stream = std::istringstream{entry};
+    auto device       = device_id_t{-1};
+    entry_stream >> device;
+    if (entry_stream.fail() || !(entry_stream >> std::ws).eof() || device < 0 ||
+        std::find(std::begin(result), std::end(result), device) != std::end(result)) {
+      throw TritonException(Error::InvalidArg, "bad shard device '" + entry + "'");
+    }
+    result.push_back(device);
+  }
+  return result;
+}
+
+/** A range of consecutive rows assigned to one shard */
+struct row_range {
+  std::size_t begin;
+  std::size_t count;
+};
+
+/**
+ * @brief Divide `rows` rows among `shards` shards as evenly as possible,
+ * giving any remainder to the first shards
+ */
+inline auto partition_rows(std::size_t rows, std::size_t shards)
+{
+  auto result = std::vector<row_range>{};
+  result.reserve(shards);
+  auto begin = std::size_t{};
+  for (auto i = std::size_t{}; i < shards; ++i) {
+    auto count = rows / shards + (i < rows % shards ? 1 : 0);
+    result.push_back(row_range{begin, count});
+    begin += count;
+  }
+  return result;
+}
+
+/**
+ * @brief A set of devices over which a single model instance is sharded
+ *
+ * Each device has its own pool of streams, and allocations on each device
+ * use that device's memory resource. For each batch, `acquire_streams`
+ * provides one stream per shard which is ordered after work already
+ * enqueued on the batch's stream. Inputs may then be copied in full to
+ * every shard with `broadcast` or divided by rows among them with
+ * `partition`, and partial outputs brought back to the batch's output with
+ * `gather` (for outputs partitioned by rows) or `reduce` (for outputs which
+ * are the elementwise sum of the shards' partial results). Copies between
+ * devices are made directly between peers where the hardware allows it.
+ */
+struct shard_group {
+  explicit shard_group(std::vector<device_id_t> devices) : devices_{std::move(devices)}, streams_{}
+  {
+    if constexpr (!IS_GPU_BUILD) {
+      throw TritonException(Error::Unsupported, "Sharded models require a GPU build");
+    }
+    if (devices_.empty()) {
+      throw TritonException(Error::InvalidArg, "A shard group requires at least one device");
+    }
+    streams_.reserve(devices_.size());
+    std::transform(std::begin(devices_),
+                   std::end(devices_),
+                   std::back_inserter(streams_),
+                   [](auto device) { return std::make_unique<stream_pool>(device); });
+  }
+
+  auto size() const noexcept { return devices_.size(); }
+  auto const& devices() const noexcept { return devices_; }
+  auto device(std::size_t shard) const { return devices_.at(shard); }
+
+  /**
+   * @brief Acquire one stream on each shard's device, ordered after all
+   * work currently enqueued on `stream`, which belongs to `stream_device`
+   */
+  auto acquire_streams(cudaStream_t stream, device_id_t stream_device) const
+  {
+    auto result = std::vector<pooled_stream>{};
+    result.reserve(streams_.size());
+    for (auto shard = std::size_t{}; shard < streams_.size(); ++shard) {
+      result.push_back(streams_[shard]->acquire());
+      wait(result.back().get(), stream, stream_device);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Make all future work on `stream` wait for all work enqueued on the
+   * given shard streams
+   */
+  void join(std::vector<pooled_stream> const& shard_streams, cudaStream_t stream) const
+  {
+    for (auto shard = std::size_t{}; shard < shard_streams.size(); ++shard) {
+      wait(stream, shard_streams[shard].get(), device(shard));
+    }
+  }
+
+  /**
+   * @brief Copy the whole of a tensor to device memory on every shard
+   *
+   * Each copy is enqueued on its shard's stream.
+   */
+  template <typename T>
+  auto broadcast(Tensor<T>& input, std::vector<pooled_stream> const& shard_streams) const
+  {
+    auto result = std::vector<Tensor<std::remove_const_t<T>>>{};
+    result.reserve(size());
+    for (auto shard = std::size_t{}; shard < size(); ++shard) {
+      result.emplace_back(
+        input.shape(), copy_elements(input, 0, input.size(), shard, shard_streams[shard].get()));
+    }
+    return result;
+  }
+
+  /**
+   * @brief Divide a tensor by rows among the shards, copying each shard's
+   * rows to device memory on its device
+   *
+   * Rows are assigned as by partition_rows. Each copy is enqueued on its
+   * shard's stream.
+   */
+  template <typename T>
+  auto partition(Tensor<T>& input, std::vector<pooled_stream> const& shard_streams) const
+  {
+    auto const& shape = input.shape();
+    auto rows         = shape.empty() ? std::size_t{1} : shape[0];
+    auto row_size     = (rows == 0) ? std::size_t{} : input.size() / rows;
+    auto result       = std::vector<Tensor<std::remove_const_t<T>>>{};
+    result.reserve(size());
+    auto ranges = partition_rows(rows, size());
+    for (auto shard = std::size_t{}; shard < size(); ++shard) {
+      auto shard_shape = shape;
+      if (!shard_shape.empty()) { shard_shape[0] = ranges[shard].count; }
+      result.emplace_back(shard_shape,
+                          copy_elements(input,
+                                        ranges[shard].begin * row_size,
+                                        ranges[shard].count * row_size,
+                                        shard,
+                                        shard_streams[shard].get()));
+    }
+    return result;
+  }
+
+  /**
+   * @brief Copy partial results for the rows assigned to each shard by
+   * `partition` into the corresponding rows of the output
+   *
+   * The output's stream is first made to wait for each shard's stream.
+   */
+  template <typename T, typename OutputType>
+  void gather(std::vector<Tensor<T>>& partials,
+              OutputType& output,
+              std::vector<pooled_stream> const& shard_streams) const
+  {
+    auto& dst    = output.buffer();
+    auto dst_end = std::size_t{};
+    for (auto shard = std::size_t{}; shard < partials.size(); ++shard) {
+      wait(dst.stream(), shard_streams[shard].get(), device(shard));
+      auto& partial = partials[shard].buffer();
+      if (dst_end + partial.size() > dst.size()) {
+        throw TritonException(Error::Internal, "partial outputs do not fit in output");
+      }
+      copy(dst, view(partial, dst.stream()), dst_end);
+      dst_end += partial.size();
+    }
+  }
+
+  /**
+   * @brief Sum the partial results of every shard elementwise into the
+   * output
+   *
+   * Device outputs are reduced on their device by a kernel once it has been
+   * registered with `register_device_reduction` (see
+   * rapids_triton/model/shard_group.cuh) and on the host otherwise.
+   */
+  template <typename T, typename OutputType>
+  void reduce(std::vector<Tensor<T>>& partials,
+              OutputType& output,
+              std::vector<pooled_stream> const& shard_streams) const
+  {
+    auto& dst = output.buffer();
+    for (auto shard = std::size_t{}; shard < partials.size(); ++shard) {
+      wait(dst.stream(), shard_streams[shard].get(), device(shard));
+      if (partials[shard].size() != dst.size()) {
+        throw TritonException(Error::Internal, "partial outputs must match output size");
+      }
+    }
+    if (partials.empty()) { return; }
+    if (dst.mem_type() == DeviceMemory && detail::device_reduction_available<T>()) {
+      copy(dst, view(partials[0].buffer(), dst.stream()));
+      auto staged = Buffer<T>(dst.size(), DeviceMemory, dst.device(), dst.stream());
+      for (auto shard = std::size_t{1}; shard < partials.size(); ++shard) {
+        copy(staged, view(partials[shard].buffer(), dst.stream()));
+        auto device_context = device_setter{dst.device()};
+        detail::accumulate(dst.data(), staged.data(), dst.size(), dst.stream());
+      }
+    } else {
+      auto total  = Buffer<T>(dst.size(), HostMemory, 0, dst.stream());
+      auto staged = Buffer<T>(dst.size(), HostMemory, 0, dst.stream());
+      copy(total, view(partials[0].buffer(), dst.stream()));
+      for (auto shard = std::size_t{1}; shard < partials.size(); ++shard) {
+        copy(staged, view(partials[shard].buffer(), dst.stream()));
+        staged.stream_synchronize();
+        std::transform(
+          total.data(), total.data() + total.size(), staged.data(), total.data(), std::plus<>{});
+      }
+      total.stream_synchronize();
+      copy(dst, total);
+    }
+  }
+
+ private:
+  std::vector<device_id_t> devices_;
+  std::vector<std::unique_ptr<stream_pool>> streams_;
+
+  /* Make `waiting` wait for work on `signaling`. Events must be recorded on
+   * the device of the stream which signals them, but may be waited on from
+   * any device. */
+  static void wait(cudaStream_t waiting, cudaStream_t signaling, device_id_t signaling_device)
+  {
+    if constexpr (IS_GPU_BUILD) {
+      if (waiting != signaling) {
+        auto device_context = device_setter{signaling_device};
+        auto event          = cuda_event{};
+        event.record(signaling);
+        event.wait(waiting);
+      }
+    }
+  }
+
+  /* A non-owning view of a buffer whose copies are enqueued on `stream` */
+  template <typename T>
+  static auto view(Buffer<T>& buffer, cudaStream_t stream)
+  {
+    return Buffer<T>(buffer.data(), buffer.size(), buffer.mem_type(), buffer.device(), stream);
+  }
+
+  /* Copy `count` elements of a tensor to device memory on a shard */
+  template <typename T>
+  auto copy_elements(Tensor<T>& input,
+                     std::size_t begin,
+                     std::size_t count,
+                     std::size_t shard,
+                     cudaStream_t stream) const
+  {
+    auto result = Buffer<std::remove_const_t<T>>(count, DeviceMemory, device(shard), stream);
+    copy(result, view(input.buffer(), stream), begin, begin + count);
+    return result;
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -21,19 +21,45 @@
 #include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
 #endif
 #include <algorithm>
+#include <any>
+#include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <triton/backend/backend_common.h>
+#include <rapids_triton/batch/admission.hpp>
 #include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/batch/compression_plan.hpp>
+#include <rapids_triton/batch/result_cache.hpp>
+#include <rapids_triton/batch/transform_plan.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/memory_budget.hpp>
+#include <rapids_triton/memory/placement_probe.hpp>
+#include <rapids_triton/model/config_parameter.hpp>
+#include <rapids_triton/model/device_resource_cache.hpp>
+#include <rapids_triton/model/schema.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
 #include <rapids_triton/tensor/tensor.hpp>
 #include <rapids_triton/triton/config.hpp>
 #include <rapids_triton/triton/deployment.hpp>
+#include <rapids_triton/triton/input.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/triton/traffic_capture.hpp>
+#include <rapids_triton/utils/device_setter.hpp>
 #include <rapids_triton/utils/narrow.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
 
 namespace triton {
 namespace backend {
@@ -49,6 +75,7 @@ struct SharedModelState {
                             bool squeeze_output = false)
     : config_{std::move(config)},
       max_batch_size_{get_max_batch_size(*config_)},
+      decoupled_{rapids::is_decoupled(*config_)},
       output_shapes_([this, squeeze_output]() {
         auto result         = std::vector<std::pair<std::string, std::vector<std::int64_t>>>{};
         auto output_entries = triton::common::TritonJson::Value{};
@@ -88,7 +115,73 @@ struct SharedModelState {
         }
 
         return result;
-      }())
+      }()),
+      input_specs_([this]() {
+        auto result        = std::vector<input_spec>{};
+        auto input_entries = triton::common::TritonJson::Value{};
+        if (!config_->Find("input", &input_entries)) { return result; }
+        result.reserve(input_entries.ArraySize());
+
+        for (std::size_t i = 0; i < input_entries.ArraySize(); ++i) {
+          auto input_entry = triton::common::TritonJson::Value{};
+          triton_check(input_entries.IndexAsObject(i, &input_entry));
+          auto spec = input_spec{};
+          triton_check(input_entry.MemberAsString("name", &spec.name));
+          auto data_type = std::string{};
+          triton_check(input_entry.MemberAsString("data_type", &data_type));
+          spec.dtype = ModelConfigDataTypeToTritonServerDataType(data_type);
+          // Inputs are presented to the backend in their reshaped form
+          auto reshape_entry = triton::common::TritonJson::Value{};
+          if (input_entry.Find("reshape", &reshape_entry)) {
+            ParseShape(reshape_entry, "shape", &spec.shape);
+          } else {
+            ParseShape(input_entry, "dims", &spec.shape);
+          }
+          if (max_batch_size_ > 0) { spec.shape.insert(spec.shape.begin(), -1); }
+          spec.optional = false;
+          if (input_entry.Find("optional")) {
+            triton_check(input_entry.MemberAsBool("optional", &spec.optional));
+          }
+          result.push_back(std::move(spec));
+        }
+        return result;
+      }()),
+      parameters_([this]() {
+        auto result     = std::vector<std::pair<std::string, std::string>>{};
+        auto parameters = common::TritonJson::Value{};
+        if (config_->Find("parameters", &parameters)) {
+          auto names = std::vector<std::string>{};
+          triton_check(parameters.Members(&names));
+          result.reserve(names.size());
+          for (auto& name : names) {
+            auto json_value  = common::TritonJson::Value{};
+            auto string_repr = std::string{};
+            parameters.Find(name.c_str(), &json_value);
+            triton_check(json_value.MemberAsString("string_value", &string_repr));
+            result.emplace_back(name, std::move(string_repr));
+          }
+          std::sort(std::begin(result), std::end(result), [](auto& lhs, auto& rhs) {
+            return lhs.first < rhs.first;
+          });
+        }
+        return result;
+      }()),
+      transforms_{make_transform_plan(parameters_)},
+      compression_{make_compression_plan(parameters_)},
+      parsed_parameters_{},
+      parameter_lock_{},
+      device_resources_{},
+      result_cache_{make_result_cache()},
+      memory_budgets_{},
+      memory_budget_lock_{},
+      predict_admissions_{},
+      predict_admission_lock_{},
+      memory_placements_{},
+      memory_placement_lock_{},
+      allocation_trace_{make_allocation_trace()},
+      traffic_capture_{make_traffic_capture()},
+      thread_pool_{},
+      thread_pool_init_{}
   {
   }
 
@@ -104,7 +197,168 @@ struct SharedModelState {
     return get_config_param<T>(name, std::make_optional(default_value));
   }
 
-  auto get_output_shape(std::string const& name) const
+  /** Get the value of a parameter declared with config_parameter */
+  template <typename T>
+  auto get_config_param(config_parameter<T> const& parameter)
+  {
+    return get_config_param<T>(std::string{parameter.name}, parameter.default_value);
+  }
+
+  /**
+   * @brief Get a resource shared by all instances of this model on the given
+   * device
+   *
+   * If no instance on `device` currently holds a resource with this name,
+   * `factory` is called to construct it (returning either a T or a
+   * std::shared_ptr<T>). Otherwise, the existing resource is returned. This
+   * allows large, read-only data such as model weights to be loaded once per
+   * device rather than once per instance. The resource is freed once the
+   * last instance releases it.
+   */
+  template <typename T, typename Factory>
+  auto get_device_resource(std::string const& name, device_id_t device, Factory&& factory)
+  {
+    return device_resources_.template get<T>(name, device, std::forward<Factory>(factory));
+  }
+
+  /**
+   * @brief Get one resource for each device of a sharded model, constructing
+   * any which do not currently exist
+   *
+   * `factory(shard, shard_count)` is called with each shard's device set as
+   * the current device and should construct that shard's part of the
+   * resource (e.g. its slice of the model weights). As with
+   * get_device_resource, instances sharing the same devices share the
+   * resulting objects.
+   *
+   * @return A std::vector with the std::shared_ptr<T> of each shard, in the
+   * order of `devices`
+   */
+  template <typename T, typename Factory>
+  auto get_sharded_resource(std::string const& name,
+                            std::vector<device_id_t> const& devices,
+                            Factory&& factory)
+  {
+    auto result = std::vector<std::shared_ptr<T>>{};
+    result.reserve(devices.size());
+    for (auto shard = std::size_t{}; shard < devices.size(); ++shard) {
+      // Shards of differently sized groups hold different parts of the data
+      auto shard_name =
+        name + "/shard" + std::to_string(shard) + "of" + std::to_string(devices.size());
+      result.push_back(device_resources_.template get<T>(shard_name, devices[shard], [&]() {
+        if constexpr (IS_GPU_BUILD) {
+          auto device_context = device_setter{devices[shard]};
+          return factory(shard, devices.size());
+        } else {
+          return factory(shard, devices.size());
+        }
+      }));
+    }
+    return result;
+  }
+
+  /**
+   * @brief The cache of results shared by all instances of this model, or
+   * nullptr if result caching is disabled
+   *
+   * Caching is enabled by setting the `result_cache_size` parameter to the
+   * maximum number of results to retain, and results may be expired after
+   * `result_cache_ttl_ms` milliseconds. Decoupled models are never cached.
+   */
+  auto* get_result_cache() const { return result_cache_.get(); }
+
+  /**
+   * @brief The budget for device memory allocated by this model on the
+   * given device, or nullptr if its allocations are unbudgeted
+   *
+   * Budgets are enabled by setting the `device_memory_budget` parameter to
+   * the maximum number of bytes which all instances of this model on one
+   * device may hold at once. An allocation which would exceed the budget
+   * waits up to `device_memory_budget_wait_ms` milliseconds (0 by default)
+   * for other batches to free memory before failing.
+   */
+  std::shared_ptr<memory_budget> get_memory_budget(device_id_t device);
+
+  /**
+   * @brief The limit on device work which instances of this model may have
+   * in flight on the given device at once, or nullptr if it is unlimited
+   *
+   * Admission is enabled by setting the `device_predict_concurrency`
+   * parameter to the number of batches which all instances of this model on
+   * one device may process at once. If `device_predict_concurrency_rows` is
+   * true, the limit instead counts the rows of those batches.
+   */
+  std::shared_ptr<predict_admission> get_predict_admission(device_id_t device);
+
+  /**
+   * @brief The choice of memory type for batches of this model on the given
+   * device by their size, or nullptr if placement is not calibrated
+   *
+   * Calibration is enabled by setting the `calibrate_memory_placement`
+   * parameter to true. The device's transfer and launch costs are then
+   * probed once, when the first instance on it is initialized, and shared
+   * by all instances of this model on that device.
+   */
+  std::shared_ptr<memory_placement const> get_memory_placement(device_id_t device);
+
+  /**
+   * @brief The trace recording allocations made by this model, or nullptr if
+   * they are not traced
+   *
+   * Tracing is enabled by setting the `allocation_trace` parameter to true.
+   * Its report is logged when the model is unloaded and after the next batch
+   * once the process receives SIGUSR1.
+   */
+  auto const& get_allocation_trace() const { return allocation_trace_; }
+
+  /**
+   * @brief The capture recording every batch given to this model, or nullptr
+   * if traffic is not captured
+   *
+   * Capture is enabled by setting the `traffic_capture_path` parameter to the
+   * file to write. The inputs' data are kept for the fraction
+   * `traffic_capture_data_rate` of batches (0 by default, recording only
+   * shapes), and batches are dropped rather than delaying execution once
+   * `traffic_capture_max_pending_mb` megabytes (64 by default) are waiting
+   * to be written.
+   */
+  auto* get_traffic_capture() const { return traffic_capture_.get(); }
+
+  /**
+   * @brief A pool of worker threads shared by all instances of this model
+   * for parallelizing host work within a batch
+   *
+   * The pool is started on first use with `cpu_worker_threads` workers (one
+   * fewer than the number of hardware threads by default, since callers of
+   * thread_pool::parallel_for also process work), pinned to the CPUs listed
+   * in `cpu_worker_affinity` (e.g. "0-15,32-47") if it is set.
+   */
+  auto& get_thread_pool()
+  {
+    std::call_once(thread_pool_init_, [this]() { thread_pool_ = make_thread_pool(); });
+    return *thread_pool_;
+  }
+
+  /**
+   * @brief The pre- and post-processing stages declared for inputs and
+   * outputs by `input_transform:<name>` and `output_transform:<name>`
+   * parameters
+   */
+  auto const& get_transforms() const { return transforms_; }
+
+  /**
+   * @brief The inputs sent compressed, as declared by
+   * `input_compression:<name>` parameters
+   */
+  auto const& get_compression() const { return compression_; }
+
+  /** The type and shape required of each input by the configuration */
+  auto const& get_input_specs() const { return input_specs_; }
+
+  /** Whether any number of responses may be sent for each request */
+  auto is_decoupled() const { return decoupled_; }
+
+  auto const& get_output_shape(std::string const& name) const
   {
     auto cached_shape = std::lower_bound(
       std::begin(output_shapes_), std::end(output_shapes_), name, [](auto& entry, auto& value) {
@@ -119,10 +373,125 @@ struct SharedModelState {
     }
   }
 
+  /**
+   * @brief Check declared input and output schemas against the model
+   * configuration
+   *
+   * Every field must name an entry of the configuration's `input` or
+   * `output` section with the field's element type and rank, counting the
+   * batch dimension of batched models. The configured output shapes are
+   * cached in the returned object so that outputs retrieved by index need
+   * no lookup by name. This should be called once, when the model is
+   * loaded.
+   *
+   * @throws TritonException with code Error::InvalidArg if any field does
+   * not match the configuration
+   */
+  template <typename Inputs, typename Outputs>
+  auto bind_schema(Inputs const& inputs, Outputs const& outputs)
+  {
+    check_schema(inputs, "input", std::make_index_sequence<Inputs::size>{});
+    check_schema(outputs, "output", std::make_index_sequence<Outputs::size>{});
+    return bound_schema<Inputs, Outputs>{
+      inputs, outputs, output_schema_shapes(outputs, std::make_index_sequence<Outputs::size>{})};
+  }
+
  private:
   std::unique_ptr<common::TritonJson::Value> config_;
   Batch::size_type max_batch_size_;
+  bool decoupled_;
   std::vector<std::pair<std::string, std::vector<std::int64_t>>> mutable output_shapes_;
+  std::vector<input_spec> input_specs_;
+
+  // The raw string values of all entries in the parameters section of the
+  // configuration, sorted by name
+  std::vector<std::pair<std::string, std::string>> parameters_;
+  transform_plan transforms_;
+  compression_plan compression_;
+  // Typed values of parameters which have already been parsed, keyed by name
+  std::unordered_map<std::string, std::any> mutable parsed_parameters_;
+  std::shared_mutex mutable parameter_lock_;
+  device_resource_cache device_resources_;
+  std::unique_ptr<result_cache> result_cache_;
+  std::map<device_id_t, std::shared_ptr<memory_budget>> memory_budgets_;
+  std::mutex memory_budget_lock_;
+  std::map<device_id_t, std::shared_ptr<predict_admission>> predict_admissions_;
+  std::mutex predict_admission_lock_;
+  std::map<device_id_t, std::shared_ptr<memory_placement const>> memory_placements_;
+  std::mutex memory_placement_lock_;
+  std::shared_ptr<allocation_trace> allocation_trace_;
+  std::unique_ptr<traffic_capture> traffic_capture_;
+
+  std::unique_ptr<thread_pool> thread_pool_;
+  std::once_flag thread_pool_init_;
+
+  template <typename Schema, std::size_t... Is>
+  void check_schema(Schema const& schema, char const* section, std::index_sequence<Is...>)
+  {
+    (check_schema_field(schema.template field<Is>(), section), ...);
+  }
+
+  template <typename Schema, std::size_t... Is>
+  auto output_schema_shapes(Schema const& schema, std::index_sequence<Is...>) const
+  {
+    return std::array<std::vector<std::int64_t>, Schema::size>{
+      get_output_shape(schema.template field<Is>().name)...};
+  }
+
+  template <typename Field>
+  void check_schema_field(Field const& field, char const* section)
+  {
+    auto entries = common::TritonJson::Value{};
+    triton_check(config_->MemberAsArray(section, &entries));
+    for (std::size_t i = 0; i < entries.ArraySize(); ++i) {
+      auto entry = common::TritonJson::Value{};
+      triton_check(entries.IndexAsObject(i, &entry));
+      auto name = std::string{};
+      triton_check(entry.MemberAsString("name", &name));
+      if (name != field.name) { continue; }
+
+      auto data_type = std::string{};
+      triton_check(entry.MemberAsString("data_type", &data_type));
+      auto expected_type =
+        std::string{"TYPE_"} +
+        TRITONSERVER_DataTypeString(TritonDtype<typename Field::value_type>::value);
+      if (data_type != expected_type) {
+        throw TritonException(Error::InvalidArg,
+                              std::string{section} + " " + name + " has type " + data_type +
+                                " in configuration but " + expected_type + " in schema");
+      }
+
+      auto rank = std::size_t{};
+      if (section == std::string{"output"}) {
+        rank = get_output_shape(name).size();
+      } else {
+        auto shape         = std::vector<std::int64_t>{};
+        auto reshape_entry = triton::common::TritonJson::Value{};
+        if (entry.Find("reshape", &reshape_entry)) {
+          ParseShape(reshape_entry, "shape", &shape);
+        } else {
+          ParseShape(entry, "dims", &shape);
+        }
+        rank = shape.size() + (max_batch_size_ > 0 ? 1 : 0);
+      }
+      if (rank != Field::rank) {
+        throw TritonException(Error::InvalidArg,
+                              std::string{section} + " " + name + " has " + std::to_string(rank) +
+                                " dimensions in configuration but " +
+                                std::to_string(Field::rank) + " in schema");
+      }
+      return;
+    }
+    throw TritonException(Error::InvalidArg,
+                          std::string{"no "} + section + " named " + field.name +
+                            " in configuration");
+  }
+
+  std::unique_ptr<result_cache> make_result_cache();
+  std::shared_ptr<allocation_trace> make_allocation_trace();
+  std::unique_ptr<traffic_capture> make_traffic_capture();
+  std::unique_ptr<thread_pool> make_thread_pool();
+  std::size_t fixed_output_row_bytes() const;
 
   template <typename T>
   auto get_config_param(std::string const& name, std::optional<T> const& default_value)
@@ -132,13 +501,23 @@ struct SharedModelState {
       result = max_batch_size_;
       return result;
     }
-    auto parameters = common::TritonJson::Value{};
-    auto json_value = common::TritonJson::Value{};
-    if (config_->Find("parameters", &parameters) && parameters.Find(name.c_str(), &json_value)) {
-      auto string_repr = std::string{};
-      triton_check(json_value.MemberAsString("string_value", &string_repr));
-
-      auto input_stream = std::istringstream{string_repr};
+    {
+      auto lock   = std::shared_lock<std::shared_mutex>{parameter_lock_};
+      auto cached = parsed_parameters_.find(name);
+      if (cached != std::end(parsed_parameters_)) {
+        auto* cached_value = std::any_cast<T>(&cached->second);
+        if (cached_value != nullptr) {
+          result = *cached_value;
+          return result;
+        }
+      }
+    }
+    auto raw_value = std::lower_bound(
+      std::begin(parameters_), std::end(parameters_), name, [](auto& entry, auto& value) {
+        return entry.first < value;
+      });
+    if (raw_value != std::end(parameters_) && raw_value->first == name) {
+      auto input_stream = std::istringstream{raw_value->second};
 
       if constexpr (std::is_same_v<T, bool>) {
         input_stream >> std::boolalpha >> result;
@@ -152,6 +531,11 @@ struct SharedModelState {
         } else {
           throw TritonException(Error::InvalidArg, std::string("Bad input for parameter ") + name);
         }
+      } else {
+        // Only values parsed from the configuration are cached, since the
+        // default may differ between calls
+        auto lock = std::unique_lock<std::shared_mutex>{parameter_lock_};
+        parsed_parameters_.insert_or_assign(name, result);
       }
     } else {
       if (default_value) {
@@ -166,6 +550,136 @@ struct SharedModelState {
     return result;
   }
 };
+
+inline std::unique_ptr<result_cache> SharedModelState::make_result_cache()
+{
+  auto result   = std::unique_ptr<result_cache>{};
+  auto capacity = get_config_param<std::size_t>("result_cache_size", std::size_t{});
+  if (capacity > 0 && !decoupled_) {
+    auto ttl    = std::optional<result_cache::clock::duration>{};
+    auto ttl_ms = get_config_param<std::size_t>("result_cache_ttl_ms", std::size_t{});
+    if (ttl_ms > 0) {
+      ttl = std::chrono::milliseconds{narrow<std::chrono::milliseconds::rep>(ttl_ms)};
+    }
+    result = std::make_unique<result_cache>(capacity, ttl);
+  }
+  return result;
+}
+
+inline std::shared_ptr<allocation_trace> SharedModelState::make_allocation_trace()
+{
+  auto result = std::shared_ptr<allocation_trace>{};
+  if (get_config_param<bool>("allocation_trace", false)) {
+    auto name = std::string{};
+    triton_check(config_->MemberAsString("name", &name));
+    result = std::make_shared<allocation_trace>(std::move(name));
+  }
+  return result;
+}
+
+inline std::unique_ptr<traffic_capture> SharedModelState::make_traffic_capture()
+{
+  auto result = std::unique_ptr<traffic_capture>{};
+  auto path   = get_config_param<std::string>("traffic_capture_path", std::string{});
+  if (!path.empty()) {
+    auto data_rate  = get_config_param<double>("traffic_capture_data_rate", 0.0);
+    auto pending_mb = get_config_param<std::size_t>("traffic_capture_max_pending_mb",
+                                                    std::size_t{64});
+    result          = std::make_unique<traffic_capture>(path, data_rate, pending_mb << 20);
+  }
+  return result;
+}
+
+inline std::shared_ptr<memory_budget> SharedModelState::get_memory_budget(device_id_t device)
+{
+  auto result = std::shared_ptr<memory_budget>{};
+  auto limit  = get_config_param<std::size_t>("device_memory_budget", std::size_t{});
+  if (limit > 0) {
+    auto lock   = std::lock_guard<std::mutex>{memory_budget_lock_};
+    auto& entry = memory_budgets_[device];
+    if (!entry) {
+      auto wait_ms = get_config_param<std::size_t>("device_memory_budget_wait_ms", std::size_t{});
+      entry        = std::make_shared<memory_budget>(
+        device, limit, std::chrono::milliseconds{narrow<std::chrono::milliseconds::rep>(wait_ms)});
+    }
+    result = entry;
+  }
+  return result;
+}
+
+inline std::shared_ptr<predict_admission> SharedModelState::get_predict_admission(
+  device_id_t device)
+{
+  auto result = std::shared_ptr<predict_admission>{};
+  auto limit  = get_config_param<std::size_t>("device_predict_concurrency", std::size_t{});
+  if (limit > 0) {
+    auto lock   = std::lock_guard<std::mutex>{predict_admission_lock_};
+    auto& entry = predict_admissions_[device];
+    if (!entry) {
+      auto weighted = get_config_param<bool>("device_predict_concurrency_rows", false);
+      entry         = std::make_shared<predict_admission>(device, limit, weighted);
+    }
+    result = entry;
+  }
+  return result;
+}
+
+inline std::shared_ptr<memory_placement const> SharedModelState::get_memory_placement(
+  device_id_t device)
+{
+  auto result = std::shared_ptr<memory_placement const>{};
+  if (IS_GPU_BUILD && get_config_param<bool>("calibrate_memory_placement", false)) {
+    auto lock   = std::lock_guard<std::mutex>{memory_placement_lock_};
+    auto& entry = memory_placements_[device];
+    if (!entry) {
+      entry = std::make_shared<memory_placement const>(
+        run_placement_probe(device), fixed_input_bytes(input_specs_, 1), fixed_output_row_bytes());
+      log_info(__FILE__, __LINE__)
+        << "Batches with at least " << entry->min_device_input_bytes()
+        << " bytes of input and " << entry->min_device_output_bytes()
+        << " bytes of output will be placed on device " << device;
+    }
+    result = entry;
+  }
+  return result;
+}
+
+/* The bytes per row of all outputs with fixed dimensions, or 0 if any
+ * output's size cannot be known in advance */
+inline std::size_t SharedModelState::fixed_output_row_bytes() const
+{
+  auto result         = std::size_t{};
+  auto output_entries = triton::common::TritonJson::Value{};
+  triton_check(config_->MemberAsArray("output", &output_entries));
+  for (std::size_t i = 0; i < output_entries.ArraySize(); ++i) {
+    auto output_entry = triton::common::TritonJson::Value{};
+    triton_check(output_entries.IndexAsObject(i, &output_entry));
+    auto name      = std::string{};
+    auto data_type = std::string{};
+    triton_check(output_entry.MemberAsString("name", &name));
+    triton_check(output_entry.MemberAsString("data_type", &data_type));
+    auto dtype = ModelConfigDataTypeToTritonServerDataType(data_type);
+    if (dtype == DTypeBytes) { return std::size_t{}; }
+    auto row_bytes    = std::size_t{TRITONSERVER_DataTypeByteSize(dtype)};
+    auto const& shape = get_output_shape(name);
+    for (auto dim = std::next(std::begin(shape)); dim != std::end(shape); ++dim) {
+      if (*dim < 0) { return std::size_t{}; }
+      row_bytes *= narrow<std::size_t>(*dim);
+    }
+    result += row_bytes;
+  }
+  return result;
+}
+
+inline std::unique_ptr<thread_pool> SharedModelState::make_thread_pool()
+{
+  auto hardware_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  auto thread_count =
+    get_config_param<std::size_t>("cpu_worker_threads", std::size_t{hardware_threads - 1});
+  auto cpus = detail::parse_cpu_list(
+    get_config_param<std::string>("cpu_worker_affinity", std::string{}));
+  return std::make_unique<thread_pool>(thread_count, cpus);
+}
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
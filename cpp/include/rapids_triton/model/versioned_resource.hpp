@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A read-only resource (such as model weights) which may be replaced
+ * while it is in use
+ *
+ * Readers take a reference to the current copy with `get` and hold it for as
+ * long as they use it; batches should pass it to Batch::retain so that it
+ * outlives any asynchronous work enqueued by predict. `publish` replaces the
+ * current copy atomically, so batches which begin afterwards see the new copy
+ * while those already in flight finish with the old one, which is freed when
+ * the last of them releases it. A new copy can therefore be built alongside
+ * the current one (e.g. in Model::reload) and swapped in without pausing
+ * inference.
+ */
+template <typename T>
+struct versioned_resource {
+  versioned_resource() : current_{}, version_{}, lock_{} {}
+  explicit versioned_resource(std::shared_ptr<T const> initial)
+    : current_{std::move(initial)}, version_{}, lock_{}
+  {
+  }
+
+  versioned_resource(versioned_resource const& other) = delete;
+  versioned_resource& operator=(versioned_resource const& other) = delete;
+
+  /** A reference to the current copy, or nullptr if none has been published */
+  std::shared_ptr<T const> get() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return current_;
+  }
+
+  /** The number of copies published since construction */
+  std::uint64_t version() const
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    return version_;
+  }
+
+  /**
+   * @brief Make the given copy current
+   *
+   * The previous copy is released by the calling thread if no reader still
+   * holds it.
+   */
+  void publish(std::shared_ptr<T const> next)
+  {
+    // The previous copy is destroyed outside the lock
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    std::swap(current_, next);
+    ++version_;
+  }
+
+ private:
+  std::shared_ptr<T const> current_;
+  std::uint64_t version_;
+  std::mutex mutable lock_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+#ifndef TRITON_ENABLE_GPU
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/detail/host_sparse.hpp>
+#include <rapids_triton/triton/device.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+template <typename O>
+auto constexpr device_rebase_available()
+{
+  return false;
+}
+
+inline void check_host_sparse(MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    throw TritonException(Error::Internal,
+                          "Cannot process sparse device tensors in non-GPU build");
+  }
+}
+
+template <typename O>
+void concat_indptr(O* dst,
+                   O const* src,
+                   O const* segments,
+                   O const* value_offsets,
+                   std::size_t num_segments,
+                   std::size_t src_len,
+                   cudaStream_t stream,
+                   MemoryType mem_type)
+{
+  check_host_sparse(mem_type);
+  host_concat_indptr(dst, src, segments, value_offsets, num_segments);
+}
+
+template <typename O>
+auto valid_indptr(O const* src,
+                  O const* segments,
+                  O const* value_offsets,
+                  std::size_t num_segments,
+                  std::size_t src_len,
+                  device_id_t device_id,
+                  cudaStream_t stream,
+                  MemoryType mem_type)
+{
+  check_host_sparse(mem_type);
+  return host_valid_indptr(src, segments, value_offsets, num_segments);
+}
+
+template <typename T, typename U, typename O, typename I>
+void densify_csr(T* dst,
+                 O const* indptr,
+                 I const* indices,
+                 U const* values,
+                 std::size_t rows,
+                 std::size_t cols,
+                 cudaStream_t stream,
+                 MemoryType mem_type)
+{
+  check_host_sparse(mem_type);
+  std::fill(dst, dst + rows * cols, T{});
+  host_densify_csr(dst, indptr, indices, values, rows, cols);
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <cstddef>
+
+#ifndef TRITON_ENABLE_GPU
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/detail/host_transforms.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+inline void check_host_transform(MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    throw TritonException(Error::Internal, "Cannot transform device memory in non-GPU build");
+  }
+}
+
+template <typename T, typename U>
+void sigmoid(T* dst, U const* src, std::size_t len, cudaStream_t stream, MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  host_sigmoid(dst, src, len);
+}
+
+template <typename T, typename U>
+void threshold(T* dst,
+               U const* src,
+               std::size_t len,
+               transform_t<U> cutoff,
+               cudaStream_t stream,
+               MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  host_threshold(dst, src, len, cutoff);
+}
+
+template <typename T, typename U, typename V>
+void standardize(T* dst,
+                 U const* src,
+                 V const* mean,
+                 V const* scale,
+                 std::size_t rows,
+                 std::size_t cols,
+                 cudaStream_t stream,
+                 MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  host_standardize(dst, src, mean, scale, rows, cols);
+}
+
+template <typename T, typename U, typename I>
+void select_columns(T* dst,
+                    U const* src,
+                    I const* columns,
+                    std::size_t rows,
+                    std::size_t src_cols,
+                    std::size_t cols,
+                    cudaStream_t stream,
+                    MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  host_select_columns(dst, src, columns, rows, src_cols, cols);
+}
+
+template <typename T, typename U>
+void transpose(T* dst,
+               U const* src,
+               std::size_t rows,
+               std::size_t cols,
+               std::size_t dst_rows,
+               cudaStream_t stream,
+               MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  host_transpose(dst, src, rows, cols, dst_rows);
+}
+
+template <typename T, typename U>
+void softmax(T* dst,
+             U const* src,
+             std::size_t rows,
+             std::size_t cols,
+             cudaStream_t stream,
+             MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  if (cols != 0) { host_softmax(dst, src, rows, cols); }
+}
+
+template <typename I, typename T>
+void argmax(I* dst,
+            T const* src,
+            std::size_t rows,
+            std::size_t cols,
+            cudaStream_t stream,
+            MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  if (cols != 0) { host_argmax(dst, src, rows, cols); }
+}
+
+template <typename I, typename T>
+void top_k(I* indices,
+           T* values,
+           T const* src,
+           std::size_t rows,
+           std::size_t cols,
+           std::size_t k,
+           cudaStream_t stream,
+           MemoryType mem_type)
+{
+  check_host_transform(mem_type);
+  if (k != 0) { host_top_k(indices, values, src, rows, cols, k); }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
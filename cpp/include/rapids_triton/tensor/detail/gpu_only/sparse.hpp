@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/detail/host_sparse.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* Sparse device tensors are assembled and densified through launchers
+ * registered by rapids_triton/tensor/sparse_tensor.cuh */
+struct concat_indptr_kernel_tag {};
+template <typename O>
+using concat_indptr_launcher =
+  void(O*, O const*, O const*, O const*, std::size_t, std::size_t, cudaStream_t);
+
+struct check_indptr_kernel_tag {};
+template <typename O>
+using check_indptr_launcher =
+  void(int*, O const*, O const*, O const*, std::size_t, std::size_t, cudaStream_t);
+
+struct densify_csr_kernel_tag {};
+template <typename T, typename U, typename O, typename I>
+using densify_csr_launcher =
+  void(T*, O const*, I const*, U const*, std::size_t, std::size_t, cudaStream_t);
+
+/** Whether row pointers of type O can be rebased on the device */
+template <typename O>
+auto device_rebase_available()
+{
+  return get_device_launcher<concat_indptr_kernel_tag, concat_indptr_launcher<O>>() != nullptr;
+}
+
+template <typename Tag, typename Launcher>
+auto* get_sparse_launcher()
+{
+  auto* result = get_device_launcher<Tag, Launcher>();
+  if (result == nullptr) {
+    throw TritonException(Error::Internal,
+                          "Sparse device tensors require registering their kernels from a "
+                          "translation unit compiled with a CUDA compiler");
+  }
+  return result;
+}
+
+template <typename O>
+void concat_indptr(O* dst,
+                   O const* src,
+                   O const* segments,
+                   O const* value_offsets,
+                   std::size_t num_segments,
+                   std::size_t src_len,
+                   cudaStream_t stream,
+                   MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_sparse_launcher<concat_indptr_kernel_tag, concat_indptr_launcher<O>>();
+    launch(dst, src, segments, value_offsets, num_segments, src_len, stream);
+  } else {
+    host_concat_indptr(dst, src, segments, value_offsets, num_segments);
+  }
+}
+
+/* Whether the packed row pointers of each segment are nondecreasing and
+ * span exactly the values of that segment. Row pointers in device memory
+ * are checked by a kernel, and the host waits on the stream for its
+ * result. */
+template <typename O>
+auto valid_indptr(O const* src,
+                  O const* segments,
+                  O const* value_offsets,
+                  std::size_t num_segments,
+                  std::size_t src_len,
+                  device_id_t device_id,
+                  cudaStream_t stream,
+                  MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_sparse_launcher<check_indptr_kernel_tag, check_indptr_launcher<O>>();
+    auto malformed = Buffer<int>(1, DeviceMemory, device_id, stream);
+    launch(malformed.data(), src, segments, value_offsets, num_segments, src_len, stream);
+    auto result = Buffer<int>(malformed, HostMemory, 0);
+    result.stream_synchronize();
+    return result.data()[0] == 0;
+  } else {
+    return host_valid_indptr(src, segments, value_offsets, num_segments);
+  }
+}
+
+template <typename T, typename U, typename O, typename I>
+void densify_csr(T* dst,
+                 O const* indptr,
+                 I const* indices,
+                 U const* values,
+                 std::size_t rows,
+                 std::size_t cols,
+                 cudaStream_t stream,
+                 MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch =
+      get_sparse_launcher<densify_csr_kernel_tag, densify_csr_launcher<T, U, O, I>>();
+    launch(dst, indptr, indices, values, rows, cols, stream);
+  } else {
+    std::fill(dst, dst + rows * cols, T{});
+    host_densify_csr(dst, indptr, indices, values, rows, cols);
+  }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
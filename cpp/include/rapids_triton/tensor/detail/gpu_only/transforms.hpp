@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/detail/host_transforms.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* Device transforms are launched through launchers registered by
+ * rapids_triton/tensor/transforms.cuh */
+struct sigmoid_kernel_tag {};
+template <typename T, typename U>
+using sigmoid_launcher = void(T*, U const*, std::size_t, cudaStream_t);
+
+struct threshold_kernel_tag {};
+template <typename T, typename U>
+using threshold_launcher = void(T*, U const*, std::size_t, transform_t<U>, cudaStream_t);
+
+struct standardize_kernel_tag {};
+template <typename T, typename U, typename V>
+using standardize_launcher =
+  void(T*, U const*, V const*, V const*, std::size_t, std::size_t, cudaStream_t);
+
+struct select_columns_kernel_tag {};
+template <typename T, typename U, typename I>
+using select_columns_launcher =
+  void(T*, U const*, I const*, std::size_t, std::size_t, std::size_t, cudaStream_t);
+
+struct transpose_kernel_tag {};
+template <typename T, typename U>
+using transpose_launcher = void(T*, U const*, std::size_t, std::size_t, std::size_t, cudaStream_t);
+
+struct softmax_kernel_tag {};
+template <typename T, typename U>
+using softmax_launcher = void(T*, U const*, std::size_t, std::size_t, cudaStream_t);
+
+struct argmax_kernel_tag {};
+template <typename I, typename T>
+using argmax_launcher = void(I*, T const*, std::size_t, std::size_t, cudaStream_t);
+
+struct top_k_kernel_tag {};
+template <typename I, typename T>
+using top_k_launcher = void(I*, T*, T const*, std::size_t, std::size_t, std::size_t, cudaStream_t);
+
+template <typename Tag, typename Launcher>
+auto* get_transform_launcher()
+{
+  auto* result = get_device_launcher<Tag, Launcher>();
+  if (result == nullptr) {
+    throw TritonException(Error::Internal,
+                          "Device transforms require registering their kernels from a "
+                          "translation unit compiled with a CUDA compiler");
+  }
+  return result;
+}
+
+template <typename T, typename U>
+void sigmoid(T* dst, U const* src, std::size_t len, cudaStream_t stream, MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_transform_launcher<sigmoid_kernel_tag, sigmoid_launcher<T, U>>();
+    if (len != 0) { launch(dst, src, len, stream); }
+  } else {
+    host_sigmoid(dst, src, len);
+  }
+}
+
+template <typename T, typename U>
+void threshold(T* dst,
+               U const* src,
+               std::size_t len,
+               transform_t<U> cutoff,
+               cudaStream_t stream,
+               MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_transform_launcher<threshold_kernel_tag, threshold_launcher<T, U>>();
+    if (len != 0) { launch(dst, src, len, cutoff, stream); }
+  } else {
+    host_threshold(dst, src, len, cutoff);
+  }
+}
+
+template <typename T, typename U, typename V>
+void standardize(T* dst,
+                 U const* src,
+                 V const* mean,
+                 V const* scale,
+                 std::size_t rows,
+                 std::size_t cols,
+                 cudaStream_t stream,
+                 MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch =
+      get_transform_launcher<standardize_kernel_tag, standardize_launcher<T, U, V>>();
+    if (rows * cols != 0) { launch(dst, src, mean, scale, rows, cols, stream); }
+  } else {
+    host_standardize(dst, src, mean, scale, rows, cols);
+  }
+}
+
+template <typename T, typename U, typename I>
+void select_columns(T* dst,
+                    U const* src,
+                    I const* columns,
+                    std::size_t rows,
+                    std::size_t src_cols,
+                    std::size_t cols,
+                    cudaStream_t stream,
+                    MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch =
+      get_transform_launcher<select_columns_kernel_tag, select_columns_launcher<T, U, I>>();
+    if (rows * cols != 0) { launch(dst, src, columns, rows, src_cols, cols, stream); }
+  } else {
+    host_select_columns(dst, src, columns, rows, src_cols, cols);
+  }
+}
+
+template <typename T, typename U>
+void transpose(T* dst,
+               U const* src,
+               std::size_t rows,
+               std::size_t cols,
+               std::size_t dst_rows,
+               cudaStream_t stream,
+               MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_transform_launcher<transpose_kernel_tag, transpose_launcher<T, U>>();
+    if (dst_rows != 0 && cols != 0) { launch(dst, src, rows, cols, dst_rows, stream); }
+  } else {
+    host_transpose(dst, src, rows, cols, dst_rows);
+  }
+}
+
+template <typename T, typename U>
+void softmax(T* dst,
+             U const* src,
+             std::size_t rows,
+             std::size_t cols,
+             cudaStream_t stream,
+             MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_transform_launcher<softmax_kernel_tag, softmax_launcher<T, U>>();
+    if (rows != 0 && cols != 0) { launch(dst, src, rows, cols, stream); }
+  } else if (cols != 0) {
+    host_softmax(dst, src, rows, cols);
+  }
+}
+
+template <typename I, typename T>
+void argmax(I* dst,
+            T const* src,
+            std::size_t rows,
+            std::size_t cols,
+            cudaStream_t stream,
+            MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_transform_launcher<argmax_kernel_tag, argmax_launcher<I, T>>();
+    if (rows != 0 && cols != 0) { launch(dst, src, rows, cols, stream); }
+  } else if (cols != 0) {
+    host_argmax(dst, src, rows, cols);
+  }
+}
+
+template <typename I, typename T>
+void top_k(I* indices,
+           T* values,
+           T const* src,
+           std::size_t rows,
+           std::size_t cols,
+           std::size_t k,
+           cudaStream_t stream,
+           MemoryType mem_type)
+{
+  if (mem_type == DeviceMemory) {
+    auto* launch = get_transform_launcher<top_k_kernel_tag, top_k_launcher<I, T>>();
+    if (rows != 0 && k != 0) { launch(indices, values, src, rows, cols, k, stream); }
+  } else if (k != 0) {
+    host_top_k(indices, values, src, rows, cols, k);
+  }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* Write the row pointers of the CSR matrix formed by stacking the matrices
+ * of several requests. The row pointers of segment s occupy the elements
+ * [segments[s], segments[s + 1]) of src, and its values begin at
+ * element value_offsets[s] of the stacked values. dst receives one entry
+ * for each row of every segment plus one. */
+template <typename O>
+void host_concat_indptr(
+  O* dst, O const* src, O const* segments, O const* value_offsets, std::size_t num_segments)
+{
+  dst[0] = O{};
+  auto out = std::size_t{1};
+  for (auto s = std::size_t{}; s < num_segments; ++s) {
+    auto first = src[segments[s]];
+    for (auto i = segments[s] + 1; i < segments[s + 1]; ++i) {
+      dst[out++] = src[i] - first + value_offsets[s];
+    }
+  }
+}
+
+/* Whether the row pointers of each segment, laid out as for
+ * host_concat_indptr, are nondecreasing and span exactly the
+ * value_offsets[s + 1] - value_offsets[s] values of that segment */
+template <typename O>
+auto host_valid_indptr(O const* src,
+                       O const* segments,
+                       O const* value_offsets,
+                       std::size_t num_segments)
+{
+  for (auto s = std::size_t{}; s < num_segments; ++s) {
+    if (segments[s + 1] <= segments[s]) { return false; }
+    for (auto i = segments[s] + 1; i < segments[s + 1]; ++i) {
+      if (src[i] < src[i - 1]) { return false; }
+    }
+    if (src[segments[s + 1] - 1] - src[segments[s]] != value_offsets[s + 1] - value_offsets[s]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Write the dense rows of a CSR matrix to dst, which must already hold
+ * zeros. Column indices outside [0, cols) are ignored. */
+template <typename T, typename U, typename O, typename I>
+void host_densify_csr(
+  T* dst, O const* indptr, I const* indices, U const* values, std::size_t rows, std::size_t cols)
+{
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    for (auto i = indptr[row]; i < indptr[row + 1]; ++i) {
+      auto col = indices[i];
+      if (col >= 0 && static_cast<std::size_t>(col) < cols) {
+        dst[row * cols + col] = static_cast<T>(values[i]);
+      }
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
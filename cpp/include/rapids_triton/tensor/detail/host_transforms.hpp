@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/* The type in which elements of type T are transformed: double for double
+ * and float for everything else, including half-precision types */
+template <typename T>
+using transform_t =
+  std::conditional_t<std::is_same_v<std::remove_const_t<T>, double>, double, float>;
+
+/* Element-wise loops are written without early exits or data-dependent
+ * control flow so that compilers vectorize them for arithmetic types. dst
+ * may be the same array as src. */
+template <typename T, typename U>
+void host_sigmoid(T* dst, U const* src, std::size_t len)
+{
+  using compute_t = transform_t<U>;
+  for (auto i = std::size_t{}; i < len; ++i) {
+    auto value = static_cast<compute_t>(src[i]);
+    dst[i]     = static_cast<T>(compute_t{1} / (compute_t{1} + std::exp(-value)));
+  }
+}
+
+template <typename T, typename U>
+void host_threshold(T* dst, U const* src, std::size_t len, transform_t<U> cutoff)
+{
+  using compute_t = transform_t<U>;
+  for (auto i = std::size_t{}; i < len; ++i) {
+    dst[i] = static_cast<T>(static_cast<compute_t>(src[i]) > cutoff ? 1 : 0);
+  }
+}
+
+template <typename T, typename U, typename V>
+void host_standardize(T* dst,
+                      U const* src,
+                      V const* mean,
+                      V const* scale,
+                      std::size_t rows,
+                      std::size_t cols)
+{
+  using compute_t = transform_t<U>;
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    auto* dst_row       = dst + row * cols;
+    auto const* src_row = src + row * cols;
+    for (auto col = std::size_t{}; col < cols; ++col) {
+      dst_row[col] = static_cast<T>(
+        (static_cast<compute_t>(src_row[col]) - static_cast<compute_t>(mean[col])) /
+        static_cast<compute_t>(scale[col]));
+    }
+  }
+}
+
+template <typename T, typename U, typename I>
+void host_select_columns(
+  T* dst, U const* src, I const* columns, std::size_t rows, std::size_t src_cols, std::size_t cols)
+{
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    auto* dst_row       = dst + row * cols;
+    auto const* src_row = src + row * src_cols;
+    for (auto col = std::size_t{}; col < cols; ++col) {
+      dst_row[col] = static_cast<T>(src_row[columns[col]]);
+    }
+  }
+}
+
+/* Tiles are small enough that a tile of the source and of the destination
+ * both fit comfortably in the L1 cache */
+auto constexpr host_transpose_tile = std::size_t{32};
+
+template <typename T, typename U>
+void host_transpose(
+  T* dst, U const* src, std::size_t rows, std::size_t cols, std::size_t dst_rows)
+{
+  for (auto row_begin = std::size_t{}; row_begin < dst_rows; row_begin += host_transpose_tile) {
+    auto row_end = std::min(row_begin + host_transpose_tile, dst_rows);
+    for (auto col_begin = std::size_t{}; col_begin < cols; col_begin += host_transpose_tile) {
+      auto col_end = std::min(col_begin + host_transpose_tile, cols);
+      for (auto col = col_begin; col < col_end; ++col) {
+        auto* dst_col = dst + col * dst_rows;
+        for (auto row = row_begin; row < row_end; ++row) {
+          dst_col[row] = (row < rows) ? static_cast<T>(src[row * cols + col]) : T{};
+        }
+      }
+    }
+  }
+}
+
+template <typename T, typename U>
+void host_softmax(T* dst, U const* src, std::size_t rows, std::size_t cols)
+{
+  using compute_t = transform_t<U>;
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    auto* dst_row       = dst + row * cols;
+    auto const* src_row = src + row * cols;
+    // Subtracting the row's maximum keeps exp from overflowing
+    auto max_value = static_cast<compute_t>(src_row[0]);
+    for (auto col = std::size_t{1}; col < cols; ++col) {
+      max_value = std::max(max_value, static_cast<compute_t>(src_row[col]));
+    }
+    auto sum = compute_t{};
+    for (auto col = std::size_t{}; col < cols; ++col) {
+      sum += std::exp(static_cast<compute_t>(src_row[col]) - max_value);
+    }
+    for (auto col = std::size_t{}; col < cols; ++col) {
+      dst_row[col] =
+        static_cast<T>(std::exp(static_cast<compute_t>(src_row[col]) - max_value) / sum);
+    }
+  }
+}
+
+template <typename I, typename T>
+void host_argmax(I* dst, T const* src, std::size_t rows, std::size_t cols)
+{
+  using compute_t = transform_t<T>;
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    auto const* src_row = src + row * cols;
+    auto best           = std::size_t{};
+    for (auto col = std::size_t{1}; col < cols; ++col) {
+      if (static_cast<compute_t>(src_row[col]) > static_cast<compute_t>(src_row[best])) {
+        best = col;
+      }
+    }
+    dst[row] = static_cast<I>(best);
+  }
+}
+
+template <typename I, typename T>
+void host_top_k(
+  I* indices, T* values, T const* src, std::size_t rows, std::size_t cols, std::size_t k)
+{
+  using compute_t = transform_t<T>;
+  for (auto row = std::size_t{}; row < rows; ++row) {
+    auto const* src_row = src + row * cols;
+    auto* row_indices   = indices + row * k;
+    auto* row_values    = values + row * k;
+    // The row's k largest elements so far are kept in decreasing order
+    auto found = std::size_t{};
+    for (auto col = std::size_t{}; col < cols; ++col) {
+      auto value = static_cast<compute_t>(src_row[col]);
+      if (found == k && !(value > static_cast<compute_t>(row_values[k - 1]))) { continue; }
+      auto position = std::min(found, k - 1);
+      while (position > 0 && value > static_cast<compute_t>(row_values[position - 1])) {
+        row_values[position]  = row_values[position - 1];
+        row_indices[position] = row_indices[position - 1];
+        --position;
+      }
+      row_values[position]  = src_row[col];
+      row_indices[position] = static_cast<I>(col);
+      found                 = std::min(found + 1, k);
+    }
+  }
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
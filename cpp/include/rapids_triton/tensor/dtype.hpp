@@ -18,26 +18,32 @@
 #include <triton/core/tritonserver.h>
 #include <cstdint>
 #include <iostream>
+#include <rapids_triton/cpu_only/half_replacement.hpp>
 #include <rapids_triton/utils/const_agnostic.hpp>
 
 namespace triton {
 namespace backend {
 namespace rapids {
 
-using DType                 = TRITONSERVER_DataType;
-auto constexpr DTypeBool    = TRITONSERVER_TYPE_BOOL;
-auto constexpr DTypeUint8   = TRITONSERVER_TYPE_UINT8;
-auto constexpr DTypeChar    = DTypeUint8;
-auto constexpr DTypeByte    = DTypeUint8;
-auto constexpr DTypeUint16  = TRITONSERVER_TYPE_UINT16;
-auto constexpr DTypeUint32  = TRITONSERVER_TYPE_UINT32;
-auto constexpr DTypeUint64  = TRITONSERVER_TYPE_UINT64;
-auto constexpr DTypeInt8    = TRITONSERVER_TYPE_INT8;
-auto constexpr DTypeInt16   = TRITONSERVER_TYPE_INT16;
-auto constexpr DTypeInt32   = TRITONSERVER_TYPE_INT32;
-auto constexpr DTypeInt64   = TRITONSERVER_TYPE_INT64;
-auto constexpr DTypeFloat32 = TRITONSERVER_TYPE_FP32;
-auto constexpr DTypeFloat64 = TRITONSERVER_TYPE_FP64;
+using DType                  = TRITONSERVER_DataType;
+auto constexpr DTypeBool     = TRITONSERVER_TYPE_BOOL;
+auto constexpr DTypeUint8    = TRITONSERVER_TYPE_UINT8;
+auto constexpr DTypeChar     = DTypeUint8;
+auto constexpr DTypeByte     = DTypeUint8;
+auto constexpr DTypeUint16   = TRITONSERVER_TYPE_UINT16;
+auto constexpr DTypeUint32   = TRITONSERVER_TYPE_UINT32;
+auto constexpr DTypeUint64   = TRITONSERVER_TYPE_UINT64;
+auto constexpr DTypeInt8     = TRITONSERVER_TYPE_INT8;
+auto constexpr DTypeInt16    = TRITONSERVER_TYPE_INT16;
+auto constexpr DTypeInt32    = TRITONSERVER_TYPE_INT32;
+auto constexpr DTypeInt64    = TRITONSERVER_TYPE_INT64;
+auto constexpr DTypeFloat16  = TRITONSERVER_TYPE_FP16;
+auto constexpr DTypeBFloat16 = TRITONSERVER_TYPE_BF16;
+auto constexpr DTypeFloat32  = TRITONSERVER_TYPE_FP32;
+auto constexpr DTypeFloat64  = TRITONSERVER_TYPE_FP64;
+/* Variable-length strings, which are represented by StringTensor rather than
+ * a Tensor of any fixed-size element type */
+auto constexpr DTypeBytes    = TRITONSERVER_TYPE_BYTES;
 
 template <DType D>
 struct TritonType {
@@ -137,6 +143,26 @@ struct TritonDtype<T, const_agnostic_same_t<T, std::int64_t>> {
   static constexpr DType value = DTypeInt64;
 };
 
+template <>
+struct TritonType<DTypeFloat16> {
+  typedef __half type;
+};
+
+template <typename T>
+struct TritonDtype<T, const_agnostic_same_t<T, __half>> {
+  static constexpr DType value = DTypeFloat16;
+};
+
+template <>
+struct TritonType<DTypeBFloat16> {
+  typedef __nv_bfloat16 type;
+};
+
+template <typename T>
+struct TritonDtype<T, const_agnostic_same_t<T, __nv_bfloat16>> {
+  static constexpr DType value = DTypeBFloat16;
+};
+
 template <>
 struct TritonType<DTypeFloat32> {
   typedef float type;
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+namespace triton {
+namespace backend {
+namespace rapids {
+/**
+ * @brief The order in which the elements of a tensor of rows are stored
+ *
+ * Row-major tensors store each row contiguously, as Triton delivers them.
+ * Column-major tensors store each column contiguously, as many tree and
+ * linear algebra libraries prefer.
+ */
+enum struct TensorLayout { row_major, column_major };
+auto constexpr RowMajor    = TensorLayout::row_major;
+auto constexpr ColumnMajor = TensorLayout::column_major;
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Call `fn(rows, first_row)` in parallel for consecutive blocks of
+ * rows of a host tensor, where `rows` is a TensorView of the block and
+ * `first_row` is the index of its first row
+ *
+ * No data is copied and ownership of the tensor's buffer is unchanged; the
+ * tensor must simply outlive the call. At least `min_rows` rows are given to
+ * each call except possibly the last.
+ */
+template <typename T, typename F>
+void parallel_for_rows(thread_pool& pool,
+                       TensorView<T> const& tensor,
+                       F&& fn,
+                       std::size_t min_rows = 1)
+{
+  if (!is_host_memory(tensor.mem_type())) {
+    throw TritonException(Error::Internal, "parallel_for_rows requires a host tensor");
+  }
+  if (tensor.shape().empty()) {
+    throw TritonException(Error::Internal, "parallel_for_rows requires a tensor with rows");
+  }
+  auto row_count = tensor.shape()[0];
+  auto chunks    = 4 * (pool.size() + 1);
+  auto grain     = std::max((row_count + chunks - 1) / chunks, min_rows);
+  pool.parallel_for(std::size_t{}, row_count, grain, [&tensor, &fn](auto begin, auto end) {
+    fn(tensor.rows(begin, end), begin);
+  });
+}
+
+template <typename T, typename F>
+void parallel_for_rows(thread_pool& pool, BaseTensor<T>& tensor, F&& fn, std::size_t min_rows = 1)
+{
+  parallel_for_rows(pool, TensorView<T>{tensor}, std::forward<F>(fn), min_rows);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <rapids_triton/utils/narrow.hpp>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A batch of tensors of differing shapes packed into one buffer
+ *
+ * Segment i holds the data of request i and occupies the elements
+ * [offsets[i], offsets[i + 1]) of the packed buffer, with no padding between
+ * segments. Offsets are available both on the host (`segment_offset`) and,
+ * for use in kernels, as a buffer in the same memory location as the data
+ * (`offsets`).
+ */
+template <typename T>
+struct RaggedTensor {
+  using size_type   = std::size_t;
+  using offset_type = std::int64_t;
+
+  RaggedTensor() : shapes_{}, host_offsets_{}, offsets_{}, buffer_{} {}
+
+  RaggedTensor(std::vector<std::vector<size_type>>&& shapes,
+               std::vector<size_type>&& host_offsets,
+               Buffer<T>&& buffer)
+    : shapes_{std::move(shapes)},
+      host_offsets_{std::move(host_offsets)},
+      offsets_{make_offsets(host_offsets_, buffer)},
+      buffer_{std::move(buffer)}
+  {
+    if (host_offsets_.size() != shapes_.size() + 1 || host_offsets_.back() != buffer_.size()) {
+      throw TritonException(Error::Internal, "RaggedTensor offsets do not match data");
+    }
+  }
+
+  auto num_segments() const noexcept { return shapes_.size(); }
+  auto const& shape(size_type segment) const { return shapes_.at(segment); }
+  auto const& shapes() const noexcept { return shapes_; }
+  auto segment_offset(size_type segment) const { return host_offsets_.at(segment); }
+  auto segment_size(size_type segment) const
+  {
+    return host_offsets_.at(segment + 1) - host_offsets_[segment];
+  }
+  /** Return a view of the data for a single segment */
+  auto segment(size_type segment)
+  {
+    return TensorView<T>(buffer_.data() + segment_offset(segment),
+                         shape(segment),
+                         buffer_.mem_type(),
+                         buffer_.device(),
+                         buffer_.stream());
+  }
+
+  auto const& offsets() const noexcept { return offsets_; }
+  auto size() const { return buffer_.size(); }
+  auto data() const { return buffer_.data(); }
+  auto& buffer() { return buffer_; }
+
+  auto constexpr dtype() const { return TritonDtype<T>::value; }
+  auto mem_type() const { return buffer_.mem_type(); }
+  auto stream() const { return buffer_.stream(); }
+  auto device() const { return buffer_.device(); }
+
+  void stream_synchronize() const
+  {
+    if (mem_type() == DeviceMemory) { buffer_.stream_synchronize(); }
+  }
+
+ private:
+  std::vector<std::vector<size_type>> shapes_;
+  std::vector<size_type> host_offsets_;
+  Buffer<offset_type> offsets_;
+  Buffer<T> buffer_;
+
+  static auto make_offsets(std::vector<size_type> const& host_offsets, Buffer<T> const& data)
+  {
+    auto result = Buffer<offset_type>(host_offsets.size(), HostMemory, 0, data.stream());
+    std::transform(
+      std::begin(host_offsets), std::end(host_offsets), result.data(), [](auto offset) {
+        return narrow<offset_type>(offset);
+      });
+    if (!is_host_memory(data.mem_type())) {
+      result = Buffer<offset_type>(result, data.mem_type(), data.device());
+    }
+    return result;
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/detail/host_copy.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A single logical tensor whose rows are stored in several separate
+ * segments
+ *
+ * SegmentedTensors are used to represent outputs which are written directly
+ * into the response buffers of each request in a batch. Segment i holds the
+ * rows of the output corresponding to request i, in order. Because segments
+ * are views of memory owned by Triton, a SegmentedTensor requires no
+ * finalize call.
+ */
+template <typename T>
+struct SegmentedTensor {
+  using size_type = typename TensorView<T>::size_type;
+
+  SegmentedTensor(std::vector<size_type>&& shape, std::vector<TensorView<T>>&& segments)
+    : shape_{std::move(shape)}, segments_{std::move(segments)}
+  {
+  }
+
+  auto const& shape() const noexcept { return shape_; }
+  auto size() const noexcept
+  {
+    return std::reduce(shape_.begin(), shape_.end(), size_type{1}, std::multiplies<>());
+  }
+  auto const& segments() const noexcept { return segments_; }
+  auto const& segment(size_type index) const { return segments_.at(index); }
+  auto num_segments() const noexcept { return segments_.size(); }
+
+ private:
+  std::vector<size_type> shape_;
+  std::vector<TensorView<T>> segments_;
+};
+
+/**
+ * @brief Scatter the rows of src into the segments of dst
+ */
+template <typename T,
+          typename U,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T>>>
+void copy(SegmentedTensor<T>& dst, TensorView<U> const& src)
+{
+  if (src.size() != dst.size()) {
+    throw TritonException(Error::Internal, "bad copy into segmented tensor");
+  }
+  auto& segments = dst.segments();
+  auto host_only =
+    is_host_memory(src.mem_type()) && src.is_contiguous() && !src.shape().empty() &&
+    std::all_of(std::begin(segments), std::end(segments), [](auto& segment) {
+      return is_host_memory(segment.mem_type()) && segment.is_contiguous();
+    });
+  if (host_only) {
+    // Gather all rows in a single call rather than one copy per segment
+    auto row_size = (src.shape()[0] == 0) ? std::size_t{} : src.size() / src.shape()[0];
+    auto copies   = detail::host_copy_list{src.size() * sizeof(T)};
+    auto offset   = std::size_t{};
+    for (auto& segment : segments) {
+      auto rows = segment.shape().empty() ? std::size_t{1} : segment.shape()[0];
+      if (segment.size() != 0) {
+        if (segment.size() != rows * row_size || offset + segment.size() > src.size()) {
+          throw TritonException(Error::Internal, "bad copy into segmented tensor");
+        }
+        copies.add(segment.data(), src.data() + offset, segment.size() * sizeof(T));
+      }
+      offset += rows * row_size;
+    }
+    copies.flush();
+    return;
+  }
+  std::accumulate(std::begin(dst.segments()),
+                  std::end(dst.segments()),
+                  typename TensorView<U>::size_type{},
+                  [&src](auto row, auto& segment) {
+                    auto rows = segment.shape().empty() ? std::size_t{1} : segment.shape()[0];
+                    if (segment.size() != 0) { copy(segment, src.rows(row, row + rows)); }
+                    return row + rows;
+                  });
+}
+
+template <typename T,
+          typename U,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T>>>
+void copy(SegmentedTensor<T>& dst, BaseTensor<U>& src)
+{
+  copy(dst, TensorView<U>{src});
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
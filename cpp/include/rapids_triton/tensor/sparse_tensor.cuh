@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __CUDACC__
+#error "rapids_triton/tensor/sparse_tensor.cuh must be compiled with a CUDA compiler"
+#endif
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/tensor/sparse_tensor.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+#include <type_traits>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+auto constexpr sparse_threads_per_block = std::size_t{256};
+auto constexpr max_sparse_blocks        = std::size_t{4096};
+
+inline auto sparse_blocks(std::size_t work_items)
+{
+  return std::min((work_items + sparse_threads_per_block - 1) / sparse_threads_per_block,
+                  max_sparse_blocks);
+}
+
+/* The segment holding element i of the packed row pointers, found by
+ * binary search over the (few) segment offsets */
+template <typename O>
+__device__ auto find_segment(O const* segments, std::size_t num_segments, std::size_t i)
+{
+  auto low  = std::size_t{};
+  auto high = num_segments;
+  while (high - low > 1) {
+    auto mid = (low + high) / 2;
+    if (static_cast<std::size_t>(segments[mid]) <= i) {
+      low = mid;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/* One thread per element of the packed row pointers */
+template <typename O>
+__global__ void concat_indptr_kernel(O* dst,
+                                     O const* src,
+                                     O const* segments,
+                                     O const* value_offsets,
+                                     std::size_t num_segments,
+                                     std::size_t src_len)
+{
+  auto stride = std::size_t{blockDim.x} * gridDim.x;
+  for (auto i = std::size_t{blockIdx.x} * blockDim.x + threadIdx.x; i < src_len; i += stride) {
+    auto low = find_segment(segments, num_segments, i);
+    // The first row pointer of each later segment repeats the last of the
+    // segment before it
+    if (low == 0 || i != static_cast<std::size_t>(segments[low])) {
+      dst[i - low] = src[i] - src[segments[low]] + value_offsets[low];
+    }
+  }
+}
+
+/* One thread per element of the packed row pointers, each of which flags
+ * the row pointers as malformed if it is less than the element before it
+ * in its segment or, for the last element of a segment, if the segment
+ * does not span exactly its values */
+template <typename O>
+__global__ void check_indptr_kernel(int* malformed,
+                                    O const* src,
+                                    O const* segments,
+                                    O const* value_offsets,
+                                    std::size_t num_segments,
+                                    std::size_t src_len)
+{
+  auto stride = std::size_t{blockDim.x} * gridDim.x;
+  for (auto i = std::size_t{blockIdx.x} * blockDim.x + threadIdx.x; i < src_len; i += stride) {
+    auto low   = find_segment(segments, num_segments, i);
+    auto first = static_cast<std::size_t>(segments[low]);
+    auto last  = static_cast<std::size_t>(segments[low + 1]) - 1;
+    if ((i != first && src[i] < src[i - 1]) ||
+        (i == last && src[i] - src[first] != value_offsets[low + 1] - value_offsets[low])) {
+      *malformed = 1;
+    }
+  }
+}
+
+template <typename T, typename U, typename O, typename I>
+__global__ void densify_csr_kernel(
+  T* dst, O const* indptr, I const* indices, U const* values, std::size_t rows, std::size_t cols)
+{
+  auto stride = std::size_t{blockDim.x} * gridDim.x;
+  for (auto row = std::size_t{blockIdx.x} * blockDim.x + threadIdx.x; row < rows;
+       row += stride) {
+    for (auto i = indptr[row]; i < indptr[row + 1]; ++i) {
+      auto col = indices[i];
+      if (col >= 0 && static_cast<std::size_t>(col) < cols) {
+        dst[row * cols + col] = static_cast<T>(values[i]);
+      }
+    }
+  }
+}
+
+template <typename O>
+void launch_concat_indptr(O* dst,
+                          O const* src,
+                          O const* segments,
+                          O const* value_offsets,
+                          std::size_t num_segments,
+                          std::size_t src_len,
+                          cudaStream_t stream)
+{
+  cuda_check(cudaMemsetAsync(dst, 0, sizeof(O), stream));
+  if (src_len != 0) {
+    concat_indptr_kernel<<<sparse_blocks(src_len), sparse_threads_per_block, 0, stream>>>(
+      dst, src, segments, value_offsets, num_segments, src_len);
+    cuda_check(cudaPeekAtLastError());
+  }
+}
+
+template <typename O>
+void launch_check_indptr(int* malformed,
+                         O const* src,
+                         O const* segments,
+                         O const* value_offsets,
+                         std::size_t num_segments,
+                         std::size_t src_len,
+                         cudaStream_t stream)
+{
+  cuda_check(cudaMemsetAsync(malformed, 0, sizeof(int), stream));
+  if (src_len != 0) {
+    check_indptr_kernel<<<sparse_blocks(src_len), sparse_threads_per_block, 0, stream>>>(
+      malformed, src, segments, value_offsets, num_segments, src_len);
+    cuda_check(cudaPeekAtLastError());
+  }
+}
+
+template <typename T, typename U, typename O, typename I>
+void launch_densify_csr(T* dst,
+                        O const* indptr,
+                        I const* indices,
+                        U const* values,
+                        std::size_t rows,
+                        std::size_t cols,
+                        cudaStream_t stream)
+{
+  cuda_check(cudaMemsetAsync(dst, 0, rows * cols * sizeof(T), stream));
+  if (rows != 0 && cols != 0) {
+    densify_csr_kernel<<<sparse_blocks(rows), sparse_threads_per_block, 0, stream>>>(
+      dst, indptr, indices, values, rows, cols);
+    cuda_check(cudaPeekAtLastError());
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Check and rebase the row pointers of sparse inputs on the device
+ * in every translation unit, including those compiled without a CUDA
+ * compiler
+ *
+ * Until this is called, `Batch::get_sparse_input` checks and rebases row
+ * pointers on the host.
+ */
+inline void register_device_sparse_inputs()
+{
+  using offset_type = SparseTensor<float>::offset_type;
+  detail::set_device_launcher<detail::check_indptr_kernel_tag,
+                              detail::check_indptr_launcher<offset_type>>(
+    &detail::launch_check_indptr<offset_type>);
+  detail::set_device_launcher<detail::concat_indptr_kernel_tag,
+                              detail::concat_indptr_launcher<offset_type>>(
+    &detail::launch_concat_indptr<offset_type>);
+}
+
+/**
+ * @brief Densify device sparse tensors of U into tensors of T in every
+ * translation unit, including those compiled without a CUDA compiler
+ *
+ * Until this is called, `densify` throws for such tensors.
+ */
+template <typename T, typename U>
+void register_device_densify()
+{
+  using value_type  = std::remove_const_t<U>;
+  using offset_type = typename SparseTensor<U>::offset_type;
+  using index_type  = typename SparseTensor<U>::index_type;
+  detail::set_device_launcher<detail::densify_csr_kernel_tag,
+                              detail::densify_csr_launcher<T, value_type, offset_type, index_type>>(
+    &detail::launch_densify_csr<T, value_type, offset_type, index_type>);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
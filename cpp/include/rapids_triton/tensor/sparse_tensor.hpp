@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <rapids_triton/tensor/detail/gpu_only/sparse.hpp>
+#else
+#include <rapids_triton/tensor/detail/cpu_only/sparse.hpp>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A matrix of rows stored in compressed sparse row (CSR) format
+ *
+ * The nonzero elements of row i are values()[j] in columns indices()[j] for
+ * j in [indptr()[i], indptr()[i + 1]). All three buffers lie in the same
+ * memory location, so they may be passed directly to kernels.
+ */
+template <typename T>
+struct SparseTensor {
+  using size_type   = std::size_t;
+  using offset_type = std::int64_t;
+  using index_type  = std::int64_t;
+
+  SparseTensor() : rows_{}, cols_{}, indptr_{}, indices_{}, values_{} {}
+
+  SparseTensor(size_type rows,
+               size_type cols,
+               Buffer<offset_type>&& indptr,
+               Buffer<index_type const>&& indices,
+               Buffer<T>&& values)
+    : rows_{rows},
+      cols_{cols},
+      indptr_{std::move(indptr)},
+      indices_{std::move(indices)},
+      values_{std::move(values)}
+  {
+    if (indptr_.size() != rows_ + 1 || indices_.size() != values_.size() ||
+        is_host_memory(indptr_.mem_type()) != is_host_memory(values_.mem_type()) ||
+        is_host_memory(indices_.mem_type()) != is_host_memory(values_.mem_type())) {
+      throw TritonException(Error::Internal, "SparseTensor components do not match");
+    }
+  }
+
+  auto rows() const noexcept { return rows_; }
+  auto cols() const noexcept { return cols_; }
+  /** The number of stored (nonzero) elements */
+  auto nnz() const { return values_.size(); }
+
+  auto const& indptr() const noexcept { return indptr_; }
+  auto const& indices() const noexcept { return indices_; }
+  auto const& values() const noexcept { return values_; }
+  auto& values() noexcept { return values_; }
+
+  auto constexpr dtype() const { return TritonDtype<T>::value; }
+  auto mem_type() const { return values_.mem_type(); }
+  auto stream() const { return values_.stream(); }
+  auto device() const { return values_.device(); }
+
+  void stream_synchronize() const
+  {
+    if (mem_type() == DeviceMemory) { values_.stream_synchronize(); }
+  }
+
+ private:
+  size_type rows_;
+  size_type cols_;
+  Buffer<offset_type> indptr_;
+  Buffer<index_type const> indices_;
+  Buffer<T> values_;
+};
+
+/**
+ * @brief Write the dense rows of a sparse tensor to dst
+ *
+ * dst must hold rows() * cols() elements in the same memory location as
+ * src, e.g. scratch storage or an output obtained from the batch. Host
+ * tensors are densified by the calling thread; device tensors by a kernel
+ * launched on dst's stream, which is only possible once it has been
+ * registered with `register_device_densify` (see
+ * rapids_triton/tensor/sparse_tensor.cuh).
+ * Column indices outside [0, cols()) are ignored.
+ */
+template <typename T, typename U>
+void densify(BaseTensor<T>& dst, SparseTensor<U> const& src)
+{
+  if (dst.size() != src.rows() * src.cols() ||
+      is_host_memory(dst.mem_type()) != is_host_memory(src.mem_type()) ||
+      (dst.mem_type() == DeviceMemory && dst.device() != src.device())) {
+    throw TritonException(Error::Internal, "bad densification of sparse tensor");
+  }
+  auto range = nvtx_range{"densify: ", src.nnz(), " nonzero elements"};
+  detail::densify_csr(dst.data(),
+                      src.indptr().data(),
+                      src.indices().data(),
+                      src.values().data(),
+                      src.rows(),
+                      src.cols(),
+                      dst.stream(),
+                      dst.mem_type());
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/narrow.hpp>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A tensor of variable-length strings (Triton's BYTES type)
+ *
+ * Strings are stored in the flattened layout used by GPU string libraries
+ * such as cuDF: all characters are concatenated in a single `chars` buffer,
+ * and element i occupies the range [offsets[i], offsets[i + 1]) of that
+ * buffer. The offsets buffer therefore has one more entry than the tensor
+ * has elements.
+ */
+struct StringTensor {
+  using size_type   = std::size_t;
+  using offset_type = std::int32_t;
+
+  StringTensor() : shape_{}, offsets_{}, chars_{} {}
+  StringTensor(std::vector<size_type>&& shape, Buffer<offset_type>&& offsets, Buffer<char>&& chars)
+    : shape_{std::move(shape)}, offsets_{std::move(offsets)}, chars_{std::move(chars)}
+  {
+  }
+
+  /**
+   * @brief Create a copy of this tensor in the given memory location,
+   * requiring one copy for the offsets and one for the characters
+   */
+  StringTensor(StringTensor const& other, MemoryType memory_type, device_id_t device = 0)
+    : shape_{other.shape_},
+      offsets_{other.offsets_, memory_type, device},
+      chars_{other.chars_, memory_type, device}
+  {
+  }
+
+  auto const& shape() const { return shape_; }
+  /** The number of strings in this tensor */
+  auto size() const { return offsets_.size() == 0 ? size_type{} : offsets_.size() - 1; }
+  auto& offsets() { return offsets_; }
+  auto const& offsets() const { return offsets_; }
+  auto& chars() { return chars_; }
+  auto const& chars() const { return chars_; }
+
+  auto constexpr dtype() const { return DTypeBytes; }
+  auto mem_type() const { return chars_.mem_type(); }
+  auto stream() const { return chars_.stream(); }
+  auto device() const { return chars_.device(); }
+
+  /** Return the string at the given index of a tensor stored on the host */
+  auto operator[](size_type index) const
+  {
+    if (!is_host_memory(mem_type())) {
+      throw TritonException(Error::Internal, "Cannot index device StringTensor on host");
+    }
+    auto begin = offsets_.data()[index];
+    auto end   = offsets_.data()[index + 1];
+    return std::string_view(chars_.data() + begin, narrow<std::size_t>(end - begin));
+  }
+
+  void stream_synchronize() const
+  {
+    if (mem_type() == DeviceMemory) { chars_.stream_synchronize(); }
+  }
+
+ private:
+  std::vector<size_type> shape_;
+  Buffer<offset_type> offsets_;
+  Buffer<char> chars_;
+};
+
+/**
+ * @brief Parse strings in Triton's serialized BYTES format into a host
+ * StringTensor
+ *
+ * In the serialized format, each element is a 4-byte little-endian length
+ * followed by that many bytes of data.
+ *
+ * @param shape The shape of the tensor, whose elements must match the number
+ * of serialized strings
+ * @param serialized Pointer to the serialized data on the host
+ * @param bytes Size of the serialized data in bytes
+ */
+inline auto parse_serialized_strings(std::vector<std::size_t>&& shape,
+                                     char const* serialized,
+                                     std::size_t bytes,
+                                     cudaStream_t stream = 0)
+{
+  using offset_type = StringTensor::offset_type;
+  auto count        = std::size_t{1};
+  for (auto dim : shape) {
+    count *= dim;
+  }
+  auto constexpr length_bytes = sizeof(std::uint32_t);
+  if (count * length_bytes > bytes) {
+    throw TritonException(Error::InvalidArg, "BYTES input is smaller than its shape requires");
+  }
+
+  auto offsets = Buffer<offset_type>(count + 1, HostMemory, 0, stream);
+  auto chars   = Buffer<char>(bytes - count * length_bytes, HostMemory, 0, stream);
+
+  auto* offset_data = offsets.data();
+  auto* char_data   = chars.data();
+  auto position     = std::size_t{};
+  auto char_count   = std::size_t{};
+  offset_data[0]    = offset_type{};
+  for (auto i = std::size_t{}; i < count; ++i) {
+    if (bytes - position < length_bytes) {
+      throw TritonException(Error::InvalidArg, "BYTES input is truncated");
+    }
+    auto const* raw_length = reinterpret_cast<unsigned char const*>(serialized + position);
+    auto length            = std::size_t{raw_length[0]} | std::size_t{raw_length[1]} << 8 |
+                  std::size_t{raw_length[2]} << 16 | std::size_t{raw_length[3]} << 24;
+    position += length_bytes;
+    if (bytes - position < length) {
+      throw TritonException(Error::InvalidArg, "BYTES input is truncated");
+    }
+    std::memcpy(char_data + char_count, serialized + position, length);
+    position += length;
+    char_count += length;
+    offset_data[i + 1] = narrow<offset_type>(char_count);
+  }
+  if (position != bytes) {
+    throw TritonException(Error::InvalidArg, "BYTES input is larger than its shape requires");
+  }
+
+  return StringTensor{std::move(shape), std::move(offsets), std::move(chars)};
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
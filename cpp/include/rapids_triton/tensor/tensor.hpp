@@ -16,9 +16,11 @@
 
 #pragma once
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -34,9 +36,13 @@
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
 #include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/detail/host_copy.hpp>
 #include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/tensor/tensor_shape.hpp>
 #include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/cuda_event.hpp>
 #include <rapids_triton/utils/narrow.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
 
 namespace triton {
 namespace backend {
@@ -46,8 +52,8 @@ struct BaseTensor {
   using size_type = typename Buffer<T>::size_type;
 
   BaseTensor() : shape_{}, buffer_{} {}
-  BaseTensor(std::vector<size_type> const& shape, Buffer<T>&& buffer)
-    : shape_(shape), buffer_{std::move(buffer)}
+  BaseTensor(TensorShape shape, Buffer<T>&& buffer)
+    : shape_(std::move(shape)), buffer_{std::move(buffer)}
   {
   }
 
@@ -57,27 +63,18 @@ struct BaseTensor {
    * @brief Construct a BaseTensor from a collection of buffers
    *
    * Given a collection of buffers, collate them all into one buffer stored in
-   * a new BaseTensor
+   * a new BaseTensor, which owns its data. Each run of adjacent buffers is
+   * copied with a single call. If all of the data are in host memory, the
+   * runs are collected and copied together.
    */
   template <typename Iter>
-  BaseTensor(std::vector<size_type> const& shape,
+  BaseTensor(TensorShape shape,
              Iter begin,
              Iter end,
              MemoryType mem_type,
              device_id_t device,
              cudaStream_t stream)
-    : shape_(shape), buffer_([&begin, &end, &mem_type, &device, &stream]() {
-        auto total_size = std::transform_reduce(
-          begin, end, size_type{}, std::plus<>{}, [](auto&& buffer) { return buffer.size(); });
-
-        auto result = Buffer<T>(total_size, mem_type, device, stream);
-
-        std::accumulate(begin, end, size_type{}, [&result](auto offset, auto& buffer) {
-          copy(result, buffer, offset);
-          return offset + buffer.size();
-        });
-        return result;
-      }())
+    : shape_(std::move(shape)), buffer_{collate(begin, end, mem_type, device, stream, false)}
   {
   }
 
@@ -98,9 +95,87 @@ struct BaseTensor {
 
   void set_stream(cudaStream_t new_stream) { buffer_.set_stream(new_stream); }
 
+ protected:
+  /* Collate the given buffers into one, which views their data in place if
+   * allowed and they already lie next to one another in the requested
+   * memory location */
+  template <typename Iter>
+  static auto collate(Iter begin,
+                      Iter end,
+                      MemoryType mem_type,
+                      device_id_t device,
+                      cudaStream_t stream,
+                      bool allow_view)
+  {
+    auto total_size = std::transform_reduce(
+      begin, end, size_type{}, std::plus<>{}, [](auto&& buffer) { return buffer.size(); });
+
+    using source_buffer = std::remove_cv_t<std::remove_reference_t<decltype(*begin)>>;
+    auto constexpr can_alias = std::is_same_v<std::remove_pointer_t<decltype(begin->data())>, T>;
+
+    auto result = Buffer<T>{};
+
+    if (can_alias && allow_view && begin != end &&
+        satisfies_memory_type(begin->mem_type(), mem_type) && begin->device() == device &&
+        find_run_end(begin, end) == end) {
+      if constexpr (can_alias) {
+        result = Buffer<T>(begin->data(), total_size, mem_type, device, stream);
+      }
+    } else {
+      result         = Buffer<T>(total_size, mem_type, device, stream);
+      auto host_only = is_host_memory(mem_type) && std::all_of(begin, end, [](auto&& buffer) {
+                         return is_host_memory(buffer.mem_type());
+                       });
+      // The result is newly allocated, so it may be written even if T is const
+      auto* raw_result = const_cast<std::remove_const_t<T>*>(result.data());
+      auto copies      = detail::host_copy_list{host_only ? total_size * sizeof(T) : 0};
+      auto offset      = size_type{};
+      for (auto run_begin = begin; run_begin != end;) {
+        auto run_end  = find_run_end(run_begin, end);
+        auto run_size = std::transform_reduce(
+          run_begin, run_end, size_type{}, std::plus<>{}, [](auto&& buffer) {
+            return buffer.size();
+          });
+        if (host_only) {
+          copies.add(raw_result + offset, run_begin->data(), run_size * sizeof(T));
+        } else {
+          auto run = source_buffer(run_begin->data(),
+                                   run_size,
+                                   run_begin->mem_type(),
+                                   run_begin->device(),
+                                   run_begin->stream());
+          copy(result, run, offset);
+        }
+        offset += run_size;
+        run_begin = run_end;
+      }
+      copies.flush();
+    }
+    return result;
+  }
+
  private:
-  std::vector<size_type> shape_;
+  TensorShape shape_;
   Buffer<T> buffer_;
+
+  /* Return an iterator to the first buffer which does not directly follow
+   * its predecessor in memory */
+  template <typename Iter>
+  static auto find_run_end(Iter begin, Iter end)
+  {
+    auto result = begin;
+    if (result != end) {
+      auto next = std::next(result);
+      while (next != end && next->mem_type() == result->mem_type() &&
+             next->device() == result->device() && next->stream() == result->stream() &&
+             result->data() + result->size() == next->data()) {
+        result = next;
+        ++next;
+      }
+      result = next;
+    }
+    return result;
+  }
 };
 
 template <typename T>
@@ -111,31 +186,141 @@ BaseTensor<T>::~BaseTensor()
 template <typename T>
 struct Tensor final : BaseTensor<T> {
   Tensor() : BaseTensor<T>{} {}
-  Tensor(std::vector<typename BaseTensor<T>::size_type> const& shape, Buffer<T>&& buffer)
-    : BaseTensor<T>(shape, std::move(buffer))
+  Tensor(TensorShape shape, Buffer<T>&& buffer)
+    : BaseTensor<T>(std::move(shape), std::move(buffer))
   {
   }
 
   template <typename Iter>
-  Tensor(std::vector<typename BaseTensor<T>::size_type> const& shape,
+  Tensor(TensorShape shape,
          Iter begin,
          Iter end,
          MemoryType mem_type,
          device_id_t device,
          cudaStream_t stream)
-    : BaseTensor<T>(shape, begin, end, mem_type, device, stream)
+    : BaseTensor<T>(std::move(shape), begin, end, mem_type, device, stream)
+  {
+  }
+
+  /**
+   * @brief Collate a collection of buffers as the constructor above does,
+   * but without copying them if possible
+   *
+   * If the buffers already lie next to one another in the requested memory
+   * location (including the case of a single buffer), the new Tensor holds a
+   * non-owning view of their data, so the original buffers must outlive it.
+   * Otherwise, they are copied into a Tensor which owns its data.
+   */
+  template <typename Iter>
+  static auto view_of(TensorShape shape,
+                      Iter begin,
+                      Iter end,
+                      MemoryType mem_type,
+                      device_id_t device,
+                      cudaStream_t stream)
   {
+    return Tensor<T>(std::move(shape),
+                     BaseTensor<T>::collate(begin, end, mem_type, device, stream, true));
   }
 };
 
 template <typename T>
 struct OutputTensor final : BaseTensor<T> {
-  OutputTensor(std::vector<typename BaseTensor<T>::size_type>&& shape,
+  OutputTensor(TensorShape shape,
+               Buffer<T>&& buffer,
+               std::string const& name,
+               std::shared_ptr<BackendOutputResponder> responder,
+               cudaStream_t response_stream)
+    : BaseTensor<T>(std::move(shape), std::move(buffer)),
+      name_{name},
+      responder_{responder},
+      response_buffer_{},
+      response_stream_{response_stream},
+      sent_rows_{},
+      deliver_{}
+  {
+  }
+  OutputTensor(TensorShape shape,
                Buffer<T>&& buffer,
                std::string const& name,
                std::shared_ptr<BackendOutputResponder> responder)
-    : BaseTensor<T>(std::move(shape), std::move(buffer)), name_{name}, responder_{responder}
+    : OutputTensor(std::move(shape), std::move(buffer), name, responder, buffer.stream())
+  {
+  }
+  /**
+   * @brief Construct an output whose data are delivered by copying directly
+   * into a single response's output buffer rather than through a
+   * BackendOutputResponder
+   *
+   * If the tensor's own buffer is the response buffer, no copy is performed
+   * on finalization.
+   */
+  OutputTensor(TensorShape shape,
+               Buffer<T>&& buffer,
+               std::string const& name,
+               Buffer<T>&& response_buffer,
+               cudaStream_t response_stream)
+    : BaseTensor<T>(std::move(shape), std::move(buffer)),
+      name_{name},
+      responder_{},
+      response_buffer_{std::move(response_buffer)},
+      response_stream_{response_stream},
+      sent_rows_{},
+      deliver_{}
+  {
+  }
+  /**
+   * @brief Construct an output whose data are delivered by the Batch rather
+   * than by finalizing this tensor, e.g. a view of part of another output
+   *
+   * Finalizing such an output has no effect.
+   */
+  OutputTensor(TensorShape shape,
+               Buffer<T>&& buffer,
+               std::string const& name)
+    : BaseTensor<T>(std::move(shape), std::move(buffer)),
+      name_{name},
+      responder_{},
+      response_buffer_{},
+      response_stream_{BaseTensor<T>::stream()},
+      sent_rows_{},
+      deliver_{}
+  {
+  }
+  /**
+   * @brief Construct an output whose data are delivered by the given
+   * function when this tensor is finalized
+   *
+   * This is used for outputs which the Batch must transform before they are
+   * sent, e.g. those with post-processing stages.
+   */
+  OutputTensor(TensorShape shape,
+               Buffer<T>&& buffer,
+               std::string const& name,
+               std::function<void()> deliver)
+    : BaseTensor<T>(std::move(shape), std::move(buffer)),
+      name_{name},
+      responder_{},
+      response_buffer_{},
+      response_stream_{BaseTensor<T>::stream()},
+      sent_rows_{},
+      deliver_{std::move(deliver)}
+  {
+  }
+
+  /**
+   * @brief Deliver only the first `rows` rows of this tensor to responses
+   *
+   * This is used for outputs of batches padded up to a larger bucket size,
+   * so that the rows computed for padding never reach clients.
+   */
+  void trim_rows(typename BaseTensor<T>::size_type rows)
   {
+    auto& shape = BaseTensor<T>::shape();
+    if (shape.empty() || rows > shape[0]) {
+      throw TritonException(Error::Internal, "cannot trim output to more rows than it holds");
+    }
+    sent_rows_ = rows;
   }
   /**
    * @brief Prepare final output data from this tensor for responding to
@@ -147,9 +332,28 @@ struct OutputTensor final : BaseTensor<T> {
    * and what types will be stored in those tensors, the rapids_triton
    * library cannot store references to those tensors that might otherwise be
    * used to finalize them.
+   *
+   * This method does not block the host. If the tensor's data is on device
+   * and was produced on a stream other than the one used for responses, an
+   * event is recorded on the tensor's stream and the response stream is made
+   * to wait on it. Any necessary host synchronization happens once for all
+   * outputs when the Batch is finalized.
    */
   void finalize()
   {
+    auto range =
+      nvtx_range{"finalize output ", name_, ": ", BaseTensor<T>::size() * sizeof(T), " bytes"};
+
+    if (deliver_) {
+      deliver_();
+      return;
+    }
+    if (response_buffer_) {
+      finalize_direct();
+      return;
+    }
+    if (!responder_) { return; }
+
     auto& shape       = BaseTensor<T>::shape();
     auto triton_shape = std::vector<std::int64_t>{};
     triton_shape.reserve(shape.size());
@@ -157,22 +361,75 @@ struct OutputTensor final : BaseTensor<T> {
       std::begin(shape), std::end(shape), std::back_inserter(triton_shape), [](auto& val) {
         return narrow<int64_t>(val);
       });
+    // Padding rows are at the end, so trimming only changes the shape sent
+    if (sent_rows_) { triton_shape[0] = narrow<int64_t>(*sent_rows_); }
 
-    // Must call the following because BackendOutputResponder does not expose
-    // its stream, so we cannot be certain that our data is not being
-    // processed on another stream.
-    BaseTensor<T>::stream_synchronize();
+    // BackendOutputResponder enqueues its copies on the response stream, so
+    // that stream must not run ahead of the work which produced this data
+    // (which may include asynchronous copies into host memory).
+    if constexpr (IS_GPU_BUILD) {
+      if (BaseTensor<T>::stream() != response_stream_) {
+        auto ready = cuda_event{};
+        ready.record(BaseTensor<T>::stream());
+        ready.wait(response_stream_);
+      }
+    }
     responder_->ProcessTensor(name_.c_str(),
                               TritonDtype<T>::value,
                               triton_shape,
                               reinterpret_cast<char*>(BaseTensor<T>::data()),
                               BaseTensor<T>::mem_type(),
                               BaseTensor<T>::device());
+    // Storage owned by this tensor must outlive the copies just enqueued
+    BaseTensor<T>::buffer().set_stream(response_stream_);
   }
 
  private:
   std::string name_;
   std::shared_ptr<BackendOutputResponder> responder_;
+  std::optional<Buffer<T>> response_buffer_;
+  cudaStream_t response_stream_;
+  std::optional<typename BaseTensor<T>::size_type> sent_rows_;
+  std::function<void()> deliver_;
+
+  /* The number of elements delivered to responses */
+  auto sent_size()
+  {
+    auto const& shape = BaseTensor<T>::shape();
+    if (!sent_rows_) { return BaseTensor<T>::size(); }
+    return std::reduce(std::next(std::begin(shape)),
+                       std::end(shape),
+                       *sent_rows_,
+                       std::multiplies<>());
+  }
+
+  void finalize_direct()
+  {
+    auto& buffer = BaseTensor<T>::buffer();
+    auto device_involved =
+      buffer.mem_type() == DeviceMemory || response_buffer_->mem_type() == DeviceMemory;
+    // Responses are sent once the response stream has been synchronized, so
+    // it must not run ahead of the work which produced this data.
+    if constexpr (IS_GPU_BUILD) {
+      if (device_involved && buffer.stream() != response_stream_) {
+        auto ready = cuda_event{};
+        ready.record(buffer.stream());
+        ready.wait(response_stream_);
+      }
+    }
+    if (response_buffer_->data() != buffer.data()) {
+      // Copy on the response stream (e.g. a dedicated copy stream) so that
+      // the transfer can overlap with later work on the tensor's stream
+      auto source = Buffer<T>{buffer.data(),
+                              buffer.size(),
+                              buffer.mem_type(),
+                              buffer.device(),
+                              device_involved ? response_stream_ : buffer.stream()};
+      response_buffer_->set_stream(source.stream());
+      rapids::copy(*response_buffer_, source, 0, sent_size());
+      buffer.set_stream(source.stream());
+    }
+  }
 };
 
 template <typename T,
@@ -193,6 +450,22 @@ void copy(BaseTensor<T>& dst, BaseTensor<U>& src)
 template <typename T, typename Iter>
 void copy(Iter begin, Iter end, BaseTensor<T>& src)
 {
+  auto host_only = is_host_memory(src.mem_type()) && std::all_of(begin, end, [](auto& dst) {
+                     return is_host_memory(dst.mem_type());
+                   });
+  if (host_only) {
+    auto copies = detail::host_copy_list{src.size() * sizeof(T)};
+    auto offset = typename BaseTensor<T>::size_type{};
+    std::for_each(begin, end, [&src, &copies, &offset](auto& dst) {
+      if (offset + dst.size() > src.size()) {
+        throw TritonException(Error::Internal, "bad copy between buffers");
+      }
+      copies.add(dst.data(), src.data() + offset, dst.size() * sizeof(T));
+      offset += dst.size();
+    });
+    copies.flush();
+    return;
+  }
   std::accumulate(begin, end, typename BaseTensor<T>::size_type{}, [&src](auto offset, auto& dst) {
     auto end_offset = offset + dst.size();
     copy(dst.buffer(), src.buffer(), offset, end_offset);
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief The shape of a tensor
+ *
+ * Up to `inline_dims` dimensions are stored within the object itself, so that
+ * creating a tensor of typical rank requires no allocation for its shape;
+ * shapes of higher rank are stored in a vector. A TensorShape converts
+ * implicitly to and from `std::vector<std::size_t>`.
+ */
+struct TensorShape {
+  using value_type     = std::size_t;
+  using size_type      = std::size_t;
+  using iterator       = value_type*;
+  using const_iterator = value_type const*;
+
+  static auto constexpr inline_dims = std::size_t{4};
+
+  TensorShape() noexcept : size_{}, inline_{}, overflow_{} {}
+  TensorShape(std::initializer_list<value_type> dims) : TensorShape(dims.begin(), dims.end()) {}
+  TensorShape(std::vector<value_type> const& dims) : TensorShape(dims.begin(), dims.end()) {}
+
+  template <typename Iter, typename = typename std::iterator_traits<Iter>::iterator_category>
+  TensorShape(Iter begin, Iter end) : size_{}, inline_{}, overflow_{}
+  {
+    size_ = static_cast<size_type>(std::distance(begin, end));
+    if (size_ <= inline_dims) {
+      std::copy(begin, end, inline_.begin());
+    } else {
+      overflow_.assign(begin, end);
+    }
+  }
+
+  auto size() const noexcept { return size_; }
+  auto empty() const noexcept { return size_ == 0; }
+
+  auto* data() noexcept { return size_ <= inline_dims ? inline_.data() : overflow_.data(); }
+  auto const* data() const noexcept
+  {
+    return size_ <= inline_dims ? inline_.data() : overflow_.data();
+  }
+
+  auto begin() noexcept { return data(); }
+  auto end() noexcept { return data() + size_; }
+  auto begin() const noexcept { return data(); }
+  auto end() const noexcept { return data() + size_; }
+
+  auto& operator[](size_type index) noexcept { return data()[index]; }
+  auto const& operator[](size_type index) const noexcept { return data()[index]; }
+  auto& front() noexcept { return *begin(); }
+  auto const& front() const noexcept { return *begin(); }
+  auto& back() noexcept { return *(end() - 1); }
+  auto const& back() const noexcept { return *(end() - 1); }
+
+  operator std::vector<value_type>() const { return std::vector<value_type>(begin(), end()); }
+
+  friend bool operator==(TensorShape const& lhs, TensorShape const& rhs) noexcept
+  {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+  friend bool operator!=(TensorShape const& lhs, TensorShape const& rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+ private:
+  size_type size_;
+  std::array<value_type, inline_dims> inline_;
+  std::vector<value_type> overflow_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
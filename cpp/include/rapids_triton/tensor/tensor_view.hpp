@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A non-owning, possibly strided view of tensor data
+ *
+ * TensorViews allow a Tensor (or any other block of memory) to be
+ * partitioned, e.g. by rows for individual requests or for processing on
+ * separate streams or threads, without allocating or copying. The viewed
+ * data must outlive the view. Strides are given in elements, with the
+ * default being a contiguous row-major layout.
+ */
+template <typename T>
+struct TensorView {
+  using size_type  = std::size_t;
+  using value_type = T;
+
+  TensorView() noexcept
+    : data_{nullptr}, shape_{}, strides_{}, mem_type_{HostMemory}, device_{}, stream_{}
+  {
+  }
+
+  TensorView(T* data,
+             std::vector<size_type> shape,
+             MemoryType mem_type,
+             device_id_t device,
+             cudaStream_t stream,
+             std::vector<size_type> strides = std::vector<size_type>{})
+    : data_{data},
+      shape_{std::move(shape)},
+      strides_{strides.empty() ? contiguous_strides(shape_) : std::move(strides)},
+      mem_type_{mem_type},
+      device_{device},
+      stream_{stream}
+  {
+    if (strides_.size() != shape_.size()) {
+      throw TritonException(Error::Internal, "TensorView strides do not match shape");
+    }
+  }
+
+  /**
+   * @brief Construct a view of all of the data in a tensor
+   */
+  template <typename U,
+            typename = std::enable_if_t<
+              std::is_convertible_v<U*, T*> &&
+              std::is_same_v<std::remove_const_t<U>, std::remove_const_t<T>>>>
+  TensorView(BaseTensor<U>& tensor)
+    : TensorView(
+        tensor.data(), tensor.shape(), tensor.mem_type(), tensor.device(), tensor.stream())
+  {
+  }
+
+  auto* data() const noexcept { return data_; }
+  auto const& shape() const noexcept { return shape_; }
+  auto const& strides() const noexcept { return strides_; }
+  auto size() const noexcept
+  {
+    return std::reduce(shape_.begin(), shape_.end(), size_type{1}, std::multiplies<>());
+  }
+  auto constexpr dtype() const { return TritonDtype<T>::value; }
+  auto mem_type() const noexcept { return mem_type_; }
+  auto device() const noexcept { return device_; }
+  auto stream() const noexcept { return stream_; }
+
+  /** Return true if the viewed data is laid out contiguously in row-major
+   * order */
+  auto is_contiguous() const { return strides_ == contiguous_strides(shape_); }
+
+  /**
+   * @brief Return a view of rows [begin, end) along the first dimension
+   */
+  auto rows(size_type begin, size_type end) const
+  {
+    if (shape_.empty() || begin > end || end > shape_[0]) {
+      throw TritonException(Error::Internal, "invalid row range for TensorView");
+    }
+    auto new_shape = shape_;
+    new_shape[0]   = end - begin;
+    return TensorView<T>{
+      data_ + begin * strides_[0], std::move(new_shape), mem_type_, device_, stream_, strides_};
+  }
+
+  /**
+   * @brief Return a view of the same data with a different shape
+   *
+   * Only contiguous views may be reshaped, and the new shape must contain
+   * the same number of elements.
+   */
+  auto reshape(std::vector<size_type> new_shape) const
+  {
+    auto new_size =
+      std::reduce(new_shape.begin(), new_shape.end(), size_type{1}, std::multiplies<>());
+    if (!is_contiguous() || new_size != size()) {
+      throw TritonException(Error::Internal, "invalid reshape of TensorView");
+    }
+    return TensorView<T>{data_, std::move(new_shape), mem_type_, device_, stream_};
+  }
+
+  /**
+   * @brief Return a non-owning Buffer over the viewed data
+   *
+   * Only contiguous views may be converted to Buffers.
+   */
+  auto buffer() const
+  {
+    if (!is_contiguous()) {
+      throw TritonException(Error::Internal, "cannot construct Buffer from strided TensorView");
+    }
+    return Buffer<T>{data_, size(), mem_type_, device_, stream_};
+  }
+
+  void set_stream(cudaStream_t new_stream) noexcept { stream_ = new_stream; }
+
+ private:
+  T* data_;
+  std::vector<size_type> shape_;
+  std::vector<size_type> strides_;
+  MemoryType mem_type_;
+  device_id_t device_;
+  cudaStream_t stream_;
+
+  static auto contiguous_strides(std::vector<size_type> const& shape)
+  {
+    auto result = std::vector<size_type>(shape.size());
+    auto stride = size_type{1};
+    for (auto i = shape.size(); i > 0; --i) {
+      result[i - 1] = stride;
+      stride *= shape[i - 1];
+    }
+    return result;
+  }
+};
+
+template <typename T>
+TensorView(BaseTensor<T>&) -> TensorView<T>;
+
+/**
+ * @brief Copy data between views of the same size
+ *
+ * Both views must be contiguous.
+ */
+template <typename T,
+          typename U,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T>>>
+void copy(TensorView<T> const& dst, TensorView<U> const& src)
+{
+  if (dst.size() != src.size()) {
+    throw TritonException(Error::Internal, "bad copy between tensor views");
+  }
+  auto dst_buffer = dst.buffer();
+  copy(dst_buffer, src.buffer());
+}
+
+template <typename T,
+          typename U,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T>>>
+void copy(BaseTensor<T>& dst, TensorView<U> const& src)
+{
+  copy(TensorView<T>{dst}, src);
+}
+
+template <typename T,
+          typename U,
+          typename = std::enable_if_t<std::is_same_v<std::remove_const_t<U>, T>>>
+void copy(TensorView<T> const& dst, BaseTensor<U>& src)
+{
+  copy(dst, TensorView<U>{src});
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
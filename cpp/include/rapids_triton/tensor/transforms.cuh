@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifndef __CUDACC__
+#error "rapids_triton/tensor/transforms.cuh must be compiled with a CUDA compiler"
+#endif
+#include <cuda_runtime_api.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/tensor/transforms.hpp>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+auto constexpr transform_threads_per_block = std::size_t{256};
+auto constexpr max_transform_blocks        = std::size_t{4096};
+auto constexpr transform_warp_size         = std::size_t{32};
+
+/* Blocks needed for one thread per work item, up to a limit beyond which
+ * each thread strides over several items */
+inline auto transform_blocks(std::size_t work_items)
+{
+  return std::min((work_items + transform_threads_per_block - 1) / transform_threads_per_block,
+                  max_transform_blocks);
+}
+
+__device__ inline auto transform_thread_index()
+{
+  return std::size_t{blockIdx.x} * blockDim.x + threadIdx.x;
+}
+
+__device__ inline auto transform_thread_count() { return std::size_t{blockDim.x} * gridDim.x; }
+
+/* Element-wise kernels read and write vectors of up to 16 bytes (e.g. four
+ * floats or eight halves) at a time when both buffers are aligned to them,
+ * so that each thread issues one wide load and store per vector. Elements
+ * past the last whole vector are transformed one at a time. */
+template <typename T, typename U>
+auto constexpr transform_vector_size = std::size_t{16} / std::max(sizeof(T), sizeof(U));
+
+template <typename T, std::size_t N>
+struct alignas(sizeof(T) * N) transform_vector {
+  T items[N];
+};
+
+template <typename T, typename U>
+auto transform_vectorized(T const* dst, U const* src)
+{
+  auto constexpr vector_size = transform_vector_size<T, U>;
+  auto dst_address           = reinterpret_cast<std::uintptr_t>(dst);
+  auto src_address           = reinterpret_cast<std::uintptr_t>(src);
+  return vector_size > 1 && dst_address % (sizeof(T) * vector_size) == 0 &&
+         src_address % (sizeof(U) * vector_size) == 0;
+}
+
+/* Threads needed to transform len elements with or without vectors */
+template <typename T, typename U>
+auto transform_work_items(std::size_t len, bool vectorized)
+{
+  auto constexpr vector_size = transform_vector_size<T, U>;
+  return vectorized ? len / vector_size + len % vector_size : len;
+}
+
+/* Set each element i of dst to op(src[i], i) */
+template <typename T, typename U, typename F>
+__device__ void transform_elements(T* dst, U const* src, std::size_t len, bool vectorized, F op)
+{
+  auto constexpr vector_size = transform_vector_size<T, U>;
+  auto vectors               = vectorized ? len / vector_size : std::size_t{};
+  for (auto v = transform_thread_index(); v < vectors; v += transform_thread_count()) {
+    auto in  = reinterpret_cast<transform_vector<U, vector_size> const*>(src)[v];
+    auto out = transform_vector<T, vector_size>{};
+    for (auto j = std::size_t{}; j < vector_size; ++j) {
+      out.items[j] = op(in.items[j], v * vector_size + j);
+    }
+    reinterpret_cast<transform_vector<T, vector_size>*>(dst)[v] = out;
+  }
+  for (auto i = vectors * vector_size + transform_thread_index(); i < len;
+       i += transform_thread_count()) {
+    dst[i] = op(src[i], i);
+  }
+}
+
+template <typename T, typename U>
+__global__ void sigmoid_kernel(T* dst, U const* src, std::size_t len, bool vectorized)
+{
+  using compute_t = transform_t<U>;
+  transform_elements(dst, src, len, vectorized, [](U item, std::size_t) {
+    auto value = static_cast<compute_t>(item);
+    return static_cast<T>(compute_t{1} / (compute_t{1} + exp(-value)));
+  });
+}
+
+template <typename T, typename U>
+__global__ void threshold_kernel(
+  T* dst, U const* src, std::size_t len, transform_t<U> cutoff, bool vectorized)
+{
+  using compute_t = transform_t<U>;
+  transform_elements(dst, src, len, vectorized, [cutoff](U item, std::size_t) {
+    return static_cast<T>(static_cast<compute_t>(item) > cutoff ? 1 : 0);
+  });
+}
+
+template <typename T, typename U, typename V>
+__global__ void standardize_kernel(T* dst,
+                                   U const* src,
+                                   V const* mean,
+                                   V const* scale,
+                                   std::size_t len,
+                                   std::size_t cols,
+                                   bool vectorized)
+{
+  using compute_t = transform_t<U>;
+  transform_elements(dst, src, len, vectorized, [mean, scale, cols](U item, std::size_t i) {
+    auto col = i % cols;
+    return static_cast<T>((static_cast<compute_t>(item) - static_cast<compute_t>(mean[col])) /
+                          static_cast<compute_t>(scale[col]));
+  });
+}
+
+template <typename T, typename U, typename I>
+__global__ void select_columns_kernel(
+  T* dst, U const* src, I const* columns, std::size_t len, std::size_t src_cols, std::size_t cols)
+{
+  for (auto i = transform_thread_index(); i < len; i += transform_thread_count()) {
+    auto row = i / cols;
+    dst[i]   = static_cast<T>(src[row * src_cols + columns[i % cols]]);
+  }
+}
+
+/* Transposes stage each tile in shared memory so that both the reads of
+ * rows and the writes of columns are coalesced. The tile's extra column
+ * keeps the threads of a warp from reading the same shared memory bank. */
+auto constexpr transpose_tile      = std::size_t{32};
+auto constexpr transpose_tile_rows = std::size_t{8};
+auto constexpr max_transpose_tiles = std::size_t{65535};
+
+template <typename T, typename U>
+__global__ void transpose_kernel(
+  T* dst, U const* src, std::size_t rows, std::size_t cols, std::size_t dst_rows)
+{
+  __shared__ T tile[transpose_tile][transpose_tile + 1];
+  auto tile_col = std::size_t{blockIdx.x} * transpose_tile;
+  for (auto tile_row = std::size_t{blockIdx.y} * transpose_tile; tile_row < dst_rows;
+       tile_row += std::size_t{gridDim.y} * transpose_tile) {
+    for (auto i = std::size_t{threadIdx.y}; i < transpose_tile; i += transpose_tile_rows) {
+      auto row = tile_row + i;
+      auto col = tile_col + threadIdx.x;
+      if (row < dst_rows && col < cols) {
+        tile[i][threadIdx.x] = (row < rows) ? static_cast<T>(src[row * cols + col]) : T{};
+      }
+    }
+    __syncthreads();
+    for (auto i = std::size_t{threadIdx.y}; i < transpose_tile; i += transpose_tile_rows) {
+      auto row = tile_row + threadIdx.x;
+      auto col = tile_col + i;
+      if (row < dst_rows && col < cols) { dst[col * dst_rows + row] = tile[threadIdx.x][i]; }
+    }
+    __syncthreads();
+  }
+}
+
+/* Row-wise kernels assign one warp to each row, with each lane striding over
+ * the row's columns before the lanes' partial results are combined */
+template <typename T>
+__device__ auto warp_max(T value)
+{
+  for (auto offset = transform_warp_size / 2; offset > 0; offset /= 2) {
+    auto other = __shfl_xor_sync(0xffffffff, value, offset);
+    value      = other > value ? other : value;
+  }
+  return value;
+}
+
+template <typename T>
+__device__ auto warp_sum(T value)
+{
+  for (auto offset = transform_warp_size / 2; offset > 0; offset /= 2) {
+    value += __shfl_xor_sync(0xffffffff, value, offset);
+  }
+  return value;
+}
+
+template <typename T, typename U>
+__global__ void softmax_kernel(T* dst, U const* src, std::size_t rows, std::size_t cols)
+{
+  using compute_t = transform_t<U>;
+  auto lane       = threadIdx.x % transform_warp_size;
+  auto warps      = transform_thread_count() / transform_warp_size;
+  for (auto row = transform_thread_index() / transform_warp_size; row < rows; row += warps) {
+    auto* dst_row       = dst + row * cols;
+    auto const* src_row = src + row * cols;
+    // Subtracting the row's maximum keeps exp from overflowing
+    auto max_value = static_cast<compute_t>(src_row[0]);
+    for (auto col = lane; col < cols; col += transform_warp_size) {
+      auto value = static_cast<compute_t>(src_row[col]);
+      max_value  = value > max_value ? value : max_value;
+    }
+    max_value = warp_max(max_value);
+    auto sum  = compute_t{};
+    for (auto col = lane; col < cols; col += transform_warp_size) {
+      sum += exp(static_cast<compute_t>(src_row[col]) - max_value);
+    }
+    sum = warp_sum(sum);
+    for (auto col = lane; col < cols; col += transform_warp_size) {
+      dst_row[col] = static_cast<T>(exp(static_cast<compute_t>(src_row[col]) - max_value) / sum);
+    }
+  }
+}
+
+template <typename I, typename T>
+__global__ void argmax_kernel(I* dst, T const* src, std::size_t rows, std::size_t cols)
+{
+  using compute_t = transform_t<T>;
+  auto lane       = threadIdx.x % transform_warp_size;
+  auto warps      = transform_thread_count() / transform_warp_size;
+  for (auto row = transform_thread_index() / transform_warp_size; row < rows; row += warps) {
+    auto const* src_row = src + row * cols;
+    auto best_value     = static_cast<compute_t>(src_row[0]);
+    auto best_index     = std::size_t{};
+    for (auto col = lane; col < cols; col += transform_warp_size) {
+      auto value = static_cast<compute_t>(src_row[col]);
+      if (value > best_value) {
+        best_value = value;
+        best_index = col;
+      }
+    }
+    // Ties are broken in favor of the lowest index, as on the host
+    for (auto offset = transform_warp_size / 2; offset > 0; offset /= 2) {
+      auto other_value = __shfl_xor_sync(0xffffffff, best_value, offset);
+      auto other_index = __shfl_xor_sync(0xffffffff, best_index, offset);
+      if (other_value > best_value || (other_value == best_value && other_index < best_index)) {
+        best_value = other_value;
+        best_index = other_index;
+      }
+    }
+    if (lane == 0) { dst[row] = static_cast<I>(best_index); }
+  }
+}
+
+/* Rows are assigned one to a thread, since each keeps its k largest
+ * elements in order; this is intended for small k */
+template <typename I, typename T>
+__global__ void top_k_kernel(
+  I* indices, T* values, T const* src, std::size_t rows, std::size_t cols, std::size_t k)
+{
+  using compute_t = transform_t<T>;
+  for (auto row = transform_thread_index(); row < rows; row += transform_thread_count()) {
+    auto const* src_row = src + row * cols;
+    auto* row_indices   = indices + row * k;
+    auto* row_values    = values + row * k;
+    auto found          = std::size_t{};
+    for (auto col = std::size_t{}; col < cols; ++col) {
+      auto value = static_cast<compute_t>(src_row[col]);
+      if (found == k && !(value > static_cast<compute_t>(row_values[k - 1]))) { continue; }
+      auto position = found < k ? found : k - 1;
+      while (position > 0 && value > static_cast<compute_t>(row_values[position - 1])) {
+        row_values[position]  = row_values[position - 1];
+        row_indices[position] = row_indices[position - 1];
+        --position;
+      }
+      row_values[position]  = src_row[col];
+      row_indices[position] = static_cast<I>(col);
+      found                 = found < k ? found + 1 : k;
+    }
+  }
+}
+
+template <typename T, typename U>
+void launch_sigmoid(T* dst, U const* src, std::size_t len, cudaStream_t stream)
+{
+  auto vectorized = transform_vectorized(dst, src);
+  auto blocks     = transform_blocks(transform_work_items<T, U>(len, vectorized));
+  sigmoid_kernel<<<blocks, transform_threads_per_block, 0, stream>>>(dst, src, len, vectorized);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename T, typename U>
+void launch_threshold(
+  T* dst, U const* src, std::size_t len, transform_t<U> cutoff, cudaStream_t stream)
+{
+  auto vectorized = transform_vectorized(dst, src);
+  auto blocks     = transform_blocks(transform_work_items<T, U>(len, vectorized));
+  threshold_kernel<<<blocks, transform_threads_per_block, 0, stream>>>(
+    dst, src, len, cutoff, vectorized);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename T, typename U, typename V>
+void launch_standardize(T* dst,
+                        U const* src,
+                        V const* mean,
+                        V const* scale,
+                        std::size_t rows,
+                        std::size_t cols,
+                        cudaStream_t stream)
+{
+  auto len        = rows * cols;
+  auto vectorized = transform_vectorized(dst, src);
+  auto blocks     = transform_blocks(transform_work_items<T, U>(len, vectorized));
+  standardize_kernel<<<blocks, transform_threads_per_block, 0, stream>>>(
+    dst, src, mean, scale, len, cols, vectorized);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename T, typename U, typename I>
+void launch_select_columns(T* dst,
+                           U const* src,
+                           I const* columns,
+                           std::size_t rows,
+                           std::size_t src_cols,
+                           std::size_t cols,
+                           cudaStream_t stream)
+{
+  auto len = rows * cols;
+  select_columns_kernel<<<transform_blocks(len), transform_threads_per_block, 0, stream>>>(
+    dst, src, columns, len, src_cols, cols);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename T, typename U>
+void launch_transpose(T* dst,
+                      U const* src,
+                      std::size_t rows,
+                      std::size_t cols,
+                      std::size_t dst_rows,
+                      cudaStream_t stream)
+{
+  auto tiles = [](std::size_t len) { return (len + transpose_tile - 1) / transpose_tile; };
+  auto grid  = dim3(tiles(cols), std::min(tiles(dst_rows), max_transpose_tiles));
+  auto block = dim3(transpose_tile, transpose_tile_rows);
+  transpose_kernel<<<grid, block, 0, stream>>>(dst, src, rows, cols, dst_rows);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename T, typename U>
+void launch_softmax(T* dst, U const* src, std::size_t rows, std::size_t cols, cudaStream_t stream)
+{
+  softmax_kernel<<<transform_blocks(rows * transform_warp_size),
+                   transform_threads_per_block,
+                   0,
+                   stream>>>(dst, src, rows, cols);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename I, typename T>
+void launch_argmax(I* dst, T const* src, std::size_t rows, std::size_t cols, cudaStream_t stream)
+{
+  argmax_kernel<<<transform_blocks(rows * transform_warp_size),
+                  transform_threads_per_block,
+                  0,
+                  stream>>>(dst, src, rows, cols);
+  cuda_check(cudaPeekAtLastError());
+}
+
+template <typename I, typename T>
+void launch_top_k(I* indices,
+                  T* values,
+                  T const* src,
+                  std::size_t rows,
+                  std::size_t cols,
+                  std::size_t k,
+                  cudaStream_t stream)
+{
+  top_k_kernel<<<transform_blocks(rows), transform_threads_per_block, 0, stream>>>(
+    indices, values, src, rows, cols, k);
+  cuda_check(cudaPeekAtLastError());
+}
+
+}  // namespace detail
+
+/*
+ * Each of the following registers the kernels of the transform of the same
+ * name in rapids_triton/tensor/transforms.hpp for the given element types,
+ * so that device tensors of those types are transformed in every
+ * translation unit, including those compiled without a CUDA compiler. Until
+ * they are registered, transforms of device tensors throw.
+ */
+
+template <typename T, typename U>
+void register_device_sigmoid()
+{
+  detail::set_device_launcher<detail::sigmoid_kernel_tag, detail::sigmoid_launcher<T, U>>(
+    &detail::launch_sigmoid<T, U>);
+}
+
+template <typename T, typename U>
+void register_device_threshold()
+{
+  detail::set_device_launcher<detail::threshold_kernel_tag, detail::threshold_launcher<T, U>>(
+    &detail::launch_threshold<T, U>);
+}
+
+template <typename T, typename U, typename V>
+void register_device_standardize()
+{
+  detail::set_device_launcher<detail::standardize_kernel_tag,
+                              detail::standardize_launcher<T, U, V>>(
+    &detail::launch_standardize<T, U, V>);
+}
+
+template <typename T, typename U, typename I>
+void register_device_select_columns()
+{
+  detail::set_device_launcher<detail::select_columns_kernel_tag,
+                              detail::select_columns_launcher<T, U, I>>(
+    &detail::launch_select_columns<T, U, I>);
+}
+
+template <typename T, typename U>
+void register_device_transpose()
+{
+  detail::set_device_launcher<detail::transpose_kernel_tag, detail::transpose_launcher<T, U>>(
+    &detail::launch_transpose<T, U>);
+}
+
+template <typename T, typename U>
+void register_device_softmax()
+{
+  detail::set_device_launcher<detail::softmax_kernel_tag, detail::softmax_launcher<T, U>>(
+    &detail::launch_softmax<T, U>);
+}
+
+template <typename I, typename T>
+void register_device_argmax()
+{
+  detail::set_device_launcher<detail::argmax_kernel_tag, detail::argmax_launcher<I, T>>(
+    &detail::launch_argmax<I, T>);
+}
+
+template <typename I, typename T>
+void register_device_top_k()
+{
+  detail::set_device_launcher<detail::top_k_kernel_tag, detail::top_k_launcher<I, T>>(
+    &detail::launch_top_k<I, T>);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <rapids_triton/tensor/detail/gpu_only/transforms.hpp>
+#else
+#include <rapids_triton/tensor/detail/cpu_only/transforms.hpp>
+#endif
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/*
+ * Common pre- and post-processing stages for tensors of rows, such as a
+ * model's raw outputs. Each reads src and writes dst, which may be an
+ * output obtained from the batch so that the result is written directly to
+ * it without another pass. The tensors must lie in the same memory location.
+ * Host tensors are transformed by the calling thread with loops written to
+ * be vectorized; device tensors are transformed by kernels launched on dst's
+ * stream, which is only possible once the kernel for their element types has
+ * been registered (see rapids_triton/tensor/transforms.cuh). Element-wise
+ * transforms may be applied in place. A tensor's rows lie along its first
+ * dimension, and all remaining dimensions form the columns of each row.
+ */
+
+namespace detail {
+template <typename T>
+auto transform_rows(BaseTensor<T> const& tensor)
+{
+  return tensor.shape().empty() ? std::size_t{1} : tensor.shape()[0];
+}
+
+template <typename T>
+auto transform_cols(BaseTensor<T> const& tensor)
+{
+  auto rows = transform_rows(tensor);
+  return rows == 0 ? std::size_t{} : tensor.size() / rows;
+}
+
+template <typename T, typename U>
+void check_transform(BaseTensor<T> const& dst, BaseTensor<U> const& src, std::size_t dst_size)
+{
+  if (dst.size() != dst_size || is_host_memory(dst.mem_type()) != is_host_memory(src.mem_type()) ||
+      (dst.mem_type() == DeviceMemory && dst.device() != src.device())) {
+    throw TritonException(Error::Internal, "bad transform between tensors");
+  }
+}
+}  // namespace detail
+
+/** Store the logistic sigmoid of each element of src in dst */
+template <typename T, typename U>
+void sigmoid(BaseTensor<T>& dst, BaseTensor<U> const& src)
+{
+  detail::check_transform(dst, src, src.size());
+  auto range = nvtx_range{"sigmoid: ", src.size(), " elements"};
+  detail::sigmoid(dst.data(), src.data(), src.size(), dst.stream(), dst.mem_type());
+}
+
+/** Store 1 in dst for each element of src greater than cutoff and 0 for
+ * every other element */
+template <typename T, typename U>
+void threshold(BaseTensor<T>& dst, BaseTensor<U> const& src, detail::transform_t<U> cutoff)
+{
+  detail::check_transform(dst, src, src.size());
+  auto range = nvtx_range{"threshold: ", src.size(), " elements"};
+  detail::threshold(dst.data(), src.data(), src.size(), cutoff, dst.stream(), dst.mem_type());
+}
+
+/**
+ * @brief Store each element of src less the mean of its column, divided by
+ * the column's scale (e.g. its standard deviation), in dst
+ *
+ * mean and scale hold one value for each column and must lie in the same
+ * memory location as the tensors.
+ */
+template <typename T, typename U, typename V>
+void standardize(BaseTensor<T>& dst,
+                 BaseTensor<U> const& src,
+                 Buffer<V> const& mean,
+                 Buffer<V> const& scale)
+{
+  detail::check_transform(dst, src, src.size());
+  auto rows = detail::transform_rows(src);
+  auto cols = detail::transform_cols(src);
+  if (mean.size() != cols || scale.size() != cols ||
+      is_host_memory(mean.mem_type()) != is_host_memory(src.mem_type()) ||
+      is_host_memory(scale.mem_type()) != is_host_memory(src.mem_type())) {
+    throw TritonException(Error::Internal,
+                          "standardization requires one mean and scale for each column");
+  }
+  auto range = nvtx_range{"standardize: ", src.size(), " elements"};
+  detail::standardize(
+    dst.data(), src.data(), mean.data(), scale.data(), rows, cols, dst.stream(), dst.mem_type());
+}
+
+/**
+ * @brief Store the given columns of each row of src, in the given order, in
+ * the same row of dst
+ *
+ * columns holds the index in src of each column of dst and must lie in the
+ * same memory location as the tensors, which must not overlap.
+ */
+template <typename T, typename U, typename I>
+void select_columns(BaseTensor<T>& dst, BaseTensor<U> const& src, Buffer<I> const& columns)
+{
+  auto rows = detail::transform_rows(src);
+  detail::check_transform(dst, src, rows * columns.size());
+  if (is_host_memory(columns.mem_type()) != is_host_memory(src.mem_type())) {
+    throw TritonException(Error::Internal, "column indices must lie with the tensors");
+  }
+  auto range = nvtx_range{"select_columns: ", rows, " rows"};
+  detail::select_columns(dst.data(),
+                         src.data(),
+                         columns.data(),
+                         rows,
+                         detail::transform_cols(src),
+                         columns.size(),
+                         dst.stream(),
+                         dst.mem_type());
+}
+
+/**
+ * @brief Store src in dst in column-major order, so that the rows of each
+ * column are contiguous
+ *
+ * dst must have the same columns as src and may have more rows, which are
+ * filled with zeros so that padding a batch requires no separate pass.
+ */
+template <typename T, typename U>
+void transpose(BaseTensor<T>& dst, BaseTensor<U> const& src)
+{
+  auto rows     = detail::transform_rows(src);
+  auto cols     = detail::transform_cols(src);
+  auto dst_rows = detail::transform_rows(dst);
+  detail::check_transform(dst, src, dst_rows * cols);
+  if (dst_rows < rows) {
+    throw TritonException(Error::Internal, "transpose destination has too few rows");
+  }
+  auto range = nvtx_range{"transpose: ", rows, " rows of ", cols, " columns"};
+  detail::transpose(
+    dst.data(), src.data(), rows, cols, dst_rows, dst.stream(), dst.mem_type());
+}
+
+/** Store the softmax of each row of src in the same row of dst */
+template <typename T, typename U>
+void softmax(BaseTensor<T>& dst, BaseTensor<U> const& src)
+{
+  detail::check_transform(dst, src, src.size());
+  auto rows  = detail::transform_rows(src);
+  auto range = nvtx_range{"softmax: ", rows, " rows"};
+  detail::softmax(
+    dst.data(), src.data(), rows, detail::transform_cols(src), dst.stream(), dst.mem_type());
+}
+
+/** Store the column index of the largest element of each row of src in dst,
+ * which has one element for each row; ties go to the lowest index */
+template <typename I, typename T>
+void argmax(BaseTensor<I>& dst, BaseTensor<T> const& src)
+{
+  auto rows = detail::transform_rows(src);
+  detail::check_transform(dst, src, rows);
+  auto range = nvtx_range{"argmax: ", rows, " rows"};
+  detail::argmax(
+    dst.data(), src.data(), rows, detail::transform_cols(src), dst.stream(), dst.mem_type());
+}
+
+/**
+ * @brief Store the column indices and values of the k largest elements of
+ * each row of src, in decreasing order of value
+ *
+ * k is taken from the size of indices and values, which hold k elements for
+ * each row and must have the same size. Rows are processed one to a device
+ * thread, so this is intended for small k.
+ */
+template <typename I, typename T>
+void top_k(BaseTensor<I>& indices, BaseTensor<T>& values, BaseTensor<T> const& src)
+{
+  auto rows = detail::transform_rows(src);
+  auto cols = detail::transform_cols(src);
+  auto k    = rows == 0 ? std::size_t{} : indices.size() / rows;
+  if (k > cols || k * rows != indices.size()) {
+    throw TritonException(Error::Internal,
+                          "top_k requires k elements per row, with k no more than the columns");
+  }
+  detail::check_transform(indices, src, k * rows);
+  detail::check_transform(values, src, k * rows);
+  auto range = nvtx_range{"top_k: ", rows, " rows"};
+  detail::top_k(
+    indices.data(), values.data(), src.data(), rows, cols, k, indices.stream(), indices.mem_type());
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
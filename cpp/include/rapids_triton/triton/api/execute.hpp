@@ -20,97 +20,548 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
 #include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/batch/priority.hpp>
+#include <rapids_triton/batch/result_cache.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/memory_budget.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/triton/metrics.hpp>
 #include <rapids_triton/triton/model.hpp>
 #include <rapids_triton/triton/model_instance.hpp>
+#include <rapids_triton/triton/performance_snapshot.hpp>
+#include <rapids_triton/triton/requests.hpp>
+#include <rapids_triton/triton/responses.hpp>
 #include <rapids_triton/triton/statistics.hpp>
-#include <rapids_triton/utils/narrow.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace triton {
 namespace backend {
 namespace rapids {
 namespace triton_api {
+namespace detail {
+inline void record_latency(latency_metrics* metrics,
+                           Batch const& batch,
+                           time_point start_time,
+                           time_point predict_end_time,
+                           time_point end_time)
+{
+  if (metrics != nullptr) {
+    metrics->observe_batch(start_time,
+                           batch.compute_start_time(),
+                           predict_end_time,
+                           batch.compute_end_time(),
+                           end_time);
+    try {
+      if (auto device_time = batch.device_compute_time(); device_time) {
+        metrics->observe(execute_phase::device, *device_time);
+      }
+      metrics->publish();
+    } catch (TritonException const& err) {
+      log_warn(__FILE__, __LINE__) << "Failed to publish latency metrics: " << err.what();
+    }
+  }
+}
+
+inline void record_staging(staging_metrics const* metrics, Batch const& batch)
+{
+  if (metrics != nullptr) {
+    try {
+      metrics->publish(batch.staged_input_bytes(), batch.saved_output_copy_bytes());
+    } catch (TritonException const& err) {
+      log_warn(__FILE__, __LINE__) << "Failed to publish staging metrics: " << err.what();
+    }
+  }
+}
+
+inline void record_memory_usage(memory_metrics const* metrics, memory_budget const* budget)
+{
+  if (metrics != nullptr && budget != nullptr) {
+    try {
+      metrics->publish(budget->current(), budget->peak());
+    } catch (TritonException const& err) {
+      log_warn(__FILE__, __LINE__) << "Failed to publish memory metrics: " << err.what();
+    }
+  }
+}
+
+inline void record_performance(performance_counters* counters,
+                               Batch const& batch,
+                               std::size_t request_count,
+                               std::size_t rows)
+{
+  if (counters != nullptr) { counters->observe(batch.activity(), request_count, rows); }
+}
+
+/* Log the allocation trace if a report has been requested by signal */
+inline void report_allocation_trace(allocation_trace* trace)
+{
+  if (trace != nullptr && trace->dump_requested()) {
+    log_info(__FILE__, __LINE__) << trace->report();
+  }
+}
+
+/* Respond to requests whose results are cached, setting each to nullptr
+ * once it is released, and return the remaining requests and their cache
+ * keys */
+inline auto serve_cached_requests(TRITONBACKEND_ModelInstance& instance,
+                                  result_cache& cache,
+                                  TRITONBACKEND_Request** raw_requests,
+                                  std::size_t request_count,
+                                  time_point start_time)
+{
+  auto range  = nvtx_range{"result cache lookup: ", request_count, " requests"};
+  auto misses = std::vector<TRITONBACKEND_Request*>{};
+  auto keys   = std::vector<std::optional<request_key>>{};
+  misses.reserve(request_count);
+  keys.reserve(request_count);
+  for (auto i = std::size_t{}; i < request_count; ++i) {
+    auto* request = raw_requests[i];
+    auto key      = get_request_key(request);
+    auto cached   = key ? cache.find(*key) : nullptr;
+    if (cached) {
+      try {
+        send_cached_response(request, *cached);
+        auto end_time = std::chrono::steady_clock::now();
+        report_statistics(instance, *request, start_time, start_time, start_time, end_time);
+        release_requests(&request, &request + 1);
+        raw_requests[i] = nullptr;
+        continue;
+      } catch (TritonException const& err) {
+        log_warn(__FILE__, __LINE__) << "Failed to send cached result: " << err.what();
+      }
+    }
+    misses.push_back(request);
+    keys.push_back(std::move(key));
+  }
+  return std::make_pair(std::move(misses), std::move(keys));
+}
+
+/* Send the given error in response to each of the given requests and
+ * release them. The error is deleted once it has been sent. */
+template <typename Iter>
+void fail_requests(Iter begin, Iter end, TRITONSERVER_Error* err)
+{
+  auto responses = std::vector<TRITONBACKEND_Response*>{};
+  try {
+    if (begin != end) { construct_responses(begin, end, responses); }
+  } catch (TritonException const&) {
+    TRITONSERVER_ErrorDelete(err);
+    throw;
+  }
+  send_responses(std::begin(responses), std::end(responses), err);
+  TRITONSERVER_ErrorDelete(err);
+  release_requests(begin, end);
+}
+
+/* Fail and remove each request whose deadline passed while it waited to be
+ * processed, given the time at which each was received */
+inline void drop_expired_requests(std::vector<TRITONBACKEND_Request*>& requests,
+                                  std::vector<time_point> const& received)
+{
+  auto now       = std::chrono::steady_clock::now();
+  auto remaining = std::vector<TRITONBACKEND_Request*>{};
+  auto expired   = std::vector<TRITONBACKEND_Request*>{};
+  remaining.reserve(requests.size());
+  for (auto i = std::size_t{}; i < requests.size(); ++i) {
+    auto deadline = get_request_deadline(requests[i], received[i]);
+    if (deadline && *deadline <= now) {
+      expired.push_back(requests[i]);
+    } else {
+      remaining.push_back(requests[i]);
+    }
+  }
+  if (!expired.empty()) {
+    requests = std::move(remaining);
+    auto err =
+      TritonException(Error::Unavailable, "request timed out before it could be processed");
+    fail_requests(std::begin(expired), std::end(expired), err.error());
+  }
+}
+
+/* The number of rows in the given requests, counting each request of an
+ * unbatched model as one row */
+template <typename Iter>
+auto count_rows(Iter begin, Iter end, std::size_t max_batch_size)
+{
+  return (max_batch_size > 0) ? get_triton_batch_rows(begin, end)
+                              : static_cast<std::size_t>(std::distance(begin, end));
+}
+
+/* Predict on the given requests as one batch and send their responses.
+ * If rows is nonzero, the time taken is recorded in the instance's latency
+ * estimates. Each request is set to nullptr once the batch has taken
+ * responsibility for releasing it. */
+template <typename ModelState, typename ModelInstanceState>
+void execute_batch(TRITONBACKEND_ModelInstance* instance,
+                   ModelState* model_state,
+                   ModelInstanceState* instance_state,
+                   TRITONBACKEND_Request** raw_requests,
+                   std::size_t request_count,
+                   std::size_t rows,
+                   time_point start_time)
+{
+  auto& model         = instance_state->get_model();
+  auto max_batch_size = model.template get_config_param<std::size_t>("max_batch_size");
+  auto* estimator     = &instance_state->get_latency_estimator();
+  auto* latency       = instance_state->get_batch_latency_model();
+  auto* owned         = raw_requests;
+  auto owned_count    = request_count;
+
+  // Requests with cached results are answered here and never reach predict
+  auto* cache         = model_state->get_shared_state()->get_result_cache();
+  auto cache_requests = std::vector<TRITONBACKEND_Request*>{};
+  auto cache_keys     = std::vector<std::optional<request_key>>{};
+  if (cache != nullptr) {
+    std::tie(cache_requests, cache_keys) =
+      serve_cached_requests(*instance, *cache, raw_requests, request_count, start_time);
+    if (cache_requests.empty()) { return; }
+    if (rows != 0 && cache_requests.size() != request_count) {
+      rows = count_rows(std::begin(cache_requests), std::end(cache_requests), max_batch_size);
+    }
+    raw_requests  = cache_requests.data();
+    request_count = cache_requests.size();
+  }
+
+  auto* pipeline       = instance_state->get_pipeline();
+  auto* metrics        = instance_state->get_latency_metrics();
+  auto* memory_metrics = instance_state->get_memory_metrics();
+  auto* staging        = instance_state->get_staging_metrics();
+  auto* budget         = instance_state->get_memory_budget().get();
+  auto* trace          = instance_state->get_allocation_trace().get();
+  auto* performance    = instance_state->get_performance_counters();
+  auto stream          = (pipeline == nullptr) ? model.get_stream() : pipeline->next_stream();
+  // Rows are counted for performance snapshots even if no latency estimate
+  // needs them
+  auto snapshot_rows = (performance != nullptr && rows == 0)
+                         ? count_rows(raw_requests, raw_requests + request_count, max_batch_size)
+                         : rows;
+
+  // Allocations made on this thread for the batch are traced, if the model
+  // traces its allocations
+  auto trace_scope = scoped_allocation_trace{instance_state->get_allocation_trace()};
+
+  // Batches are returned to the instance for reuse once they are destroyed
+  auto batch = instance_state->acquire_batch(raw_requests,
+                                             request_count,
+                                             *(model_state->TritonMemoryManager()),
+                                             model_state->EnablePinnedInput(),
+                                             model_state->EnablePinnedOutput(),
+                                             max_batch_size,
+                                             stream);
+  // Small batches are predicted on the host if the model dispatches by size,
+  // as are batches not admitted to the device in time if the model falls
+  // back to the host; this is decided before any input is placed
+  auto* dispatch       = instance_state->get_hybrid_dispatch();
+  auto* admission      = instance_state->get_predict_admission();
+  auto const& fallback = instance_state->get_host_fallback_wait();
+  if (admission != nullptr) { batch->use_admission(*admission); }
+  if (dispatch != nullptr || (fallback && admission != nullptr)) {
+    auto batch_rows = (rows != 0)
+                        ? rows
+                        : count_rows(raw_requests, raw_requests + request_count, max_batch_size);
+    if ((dispatch != nullptr && dispatch->to_host(batch_rows)) ||
+        (fallback && !batch->try_admit_device_work(batch_rows, *fallback))) {
+      batch->dispatch_to_host();
+    }
+  }
+  auto on_host = batch->dispatched_to_host();
+  if (cache != nullptr) { batch->cache_results(*cache, std::move(cache_keys)); }
+  batch->use_transforms(model_state->get_shared_state()->get_transforms());
+  if (auto const& compression = model_state->get_shared_state()->get_compression();
+      !compression.empty()) {
+    batch->use_compression(compression, &model.get_thread_pool());
+  }
+  if (auto* copies = instance_state->get_copy_streams(); copies != nullptr) {
+    batch->use_copy_streams(copies->input.get(), copies->output.get());
+  }
+  if (auto* streams = instance_state->get_collection_streams(); streams != nullptr) {
+    batch->use_concurrent_collection(model.get_thread_pool(), *streams);
+  }
+  if (auto bytes = instance_state->get_pinned_staging_bytes(); bytes != 0 && !on_host) {
+    batch->reserve_pinned_staging(bytes);
+  }
+  if (instance_state->uses_device_timing() && !on_host) { batch->use_device_timing(); }
+  // Requests with malformed inputs fail alone rather than with the batch
+  auto valid_requests =
+    batch->isolate_invalid_requests(model_state->get_shared_state()->get_input_specs());
+
+  if constexpr (IS_GPU_BUILD) {
+    if (model.get_deployment_type() == GPUDeployment) {
+      cuda_check(cudaSetDevice(model.get_device_id()));
+    }
+  }
+
+  // Device allocations made on this thread while processing the batch are
+  // charged to the model's budget, if it has one
+  auto budget_scope = scoped_memory_budget{instance_state->get_memory_budget()};
+
+  auto predict_err        = static_cast<TRITONSERVER_Error*>(nullptr);
+  auto predict_start_time = std::chrono::steady_clock::now();
+  auto* graphs            = on_host ? nullptr : instance_state->get_predict_graphs();
+  // Only batched models have rows to divide among predict calls
+  auto max_rows = (max_batch_size > 0) ? model.max_rows_per_predict() : std::size_t{};
+  auto predict  = [&model, &on_host](Batch& slice) {
+    if (on_host) {
+      model.predict_on_host(slice);
+    } else {
+      model.predict(slice);
+    }
+  };
+  try {
+    batch->begin_device_compute();
+    // A batch whose requests were all isolated has nothing to predict
+    if (valid_requests != 0) {
+      auto predict_range = nvtx_range{"predict"};
+      if (graphs != nullptr) {
+        batch->predict_with_graph(*graphs, predict);
+      } else {
+        // Graphs pad their inputs to their own buckets
+        if (auto const& buckets = instance_state->get_batch_buckets(); !buckets.empty()) {
+          batch->pad_to_bucket(buckets);
+        }
+        batch->for_each_row_slice(max_rows, predict);
+      }
+    }
+    batch->end_device_compute();
+  } catch (TritonException& err) {
+    predict_err = err.error();
+  }
+  // A batch which exhausted device memory is predicted again on the host if
+  // the model falls back to the host
+  if (predict_err != nullptr && fallback && graphs == nullptr && !on_host &&
+      TRITONSERVER_ErrorCode(predict_err) == Error::Unavailable) {
+    try {
+      if (batch->redispatch_to_host()) {
+        TRITONSERVER_ErrorDelete(predict_err);
+        predict_err   = nullptr;
+        on_host       = true;
+        auto range    = nvtx_range{"predict on host fallback"};
+        batch->for_each_row_slice(max_rows, predict);
+      }
+    } catch (TritonException& err) {
+      if (predict_err != nullptr) { TRITONSERVER_ErrorDelete(predict_err); }
+      predict_err = err.error();
+    }
+  }
+  auto predict_end_time = std::chrono::steady_clock::now();
+
+  // The batch takes ownership of predict_err when it completes
+  auto needs_sync = batch->finalize_outputs();
+  // Inputs are collected and outputs placed during predict, so staging is
+  // known at this point
+  detail::record_staging(staging, *batch);
+
+  if (pipeline == nullptr) {
+    batch->complete(predict_err, needs_sync);
+    std::fill(owned, owned + owned_count, nullptr);
+    auto end_time = std::chrono::steady_clock::now();
+    if (rows != 0) {
+      estimator->observe(rows, end_time - predict_start_time);
+      if (latency != nullptr) { latency->observe(rows, end_time - batch->compute_start_time()); }
+    }
+    report_statistics(*instance,
+                      request_count,
+                      start_time,
+                      batch->compute_start_time(),
+                      batch->compute_end_time(),
+                      end_time);
+    detail::record_latency(metrics, *batch, start_time, predict_end_time, end_time);
+    detail::record_memory_usage(memory_metrics, budget);
+    detail::record_performance(performance, *batch, request_count, snapshot_rows);
+    detail::report_allocation_trace(trace);
+  } else {
+    // Responses are sent from the pipeline's background thread so that
+    // this thread may return to Triton and begin the next batch
+    pipeline->submit([instance,
+                      metrics,
+                      memory_metrics,
+                      budget,
+                      trace,
+                      performance,
+                      estimator,
+                      latency,
+                      rows,
+                      snapshot_rows,
+                      request_count,
+                      start_time,
+                      predict_start_time,
+                      predict_end_time,
+                      predict_err,
+                      needs_sync,
+                      batch = std::shared_ptr<Batch>{std::move(batch)}]() {
+      batch->complete(predict_err, needs_sync);
+      auto end_time = std::chrono::steady_clock::now();
+      if (rows != 0) {
+        estimator->observe(rows, end_time - predict_start_time);
+        if (latency != nullptr) { latency->observe(rows, end_time - batch->compute_start_time()); }
+      }
+      report_statistics(*instance,
+                        request_count,
+                        start_time,
+                        batch->compute_start_time(),
+                        batch->compute_end_time(),
+                        end_time);
+      detail::record_latency(metrics, *batch, start_time, predict_end_time, end_time);
+      detail::record_memory_usage(memory_metrics, budget);
+      detail::record_performance(performance, *batch, request_count, snapshot_rows);
+      detail::report_allocation_trace(trace);
+    });
+    std::fill(owned, owned + owned_count, nullptr);
+  }
+}
+
+/* Process the given requests, answering those with deadlines first as a
+ * batch of their own if the whole batch is expected to exceed the
+ * instance's latency budget. As in execute_batch, each request is set to
+ * nullptr once it is released, so that after an error the caller fails
+ * only those still held. */
+template <typename ModelState, typename ModelInstanceState>
+void execute_requests(TRITONBACKEND_ModelInstance* instance,
+                      ModelState* model_state,
+                      ModelInstanceState* instance_state,
+                      std::vector<TRITONBACKEND_Request*>& requests,
+                      time_point start_time)
+{
+  auto& model         = instance_state->get_model();
+  auto max_batch_size = model.template get_config_param<std::size_t>("max_batch_size");
+  auto budget         = instance_state->get_latency_budget();
+
+  // Rows are only counted if some latency estimate needs them
+  auto measured = budget.count() != 0 || instance_state->get_batch_latency_model() != nullptr;
+  auto rows = measured ? count_rows(std::begin(requests), std::end(requests), max_batch_size)
+                       : std::size_t{};
+
+  auto urgent = std::size_t{};
+  if (budget.count() != 0 && instance_state->get_latency_estimator().estimate(rows) > budget) {
+    auto deadlines = std::vector<std::optional<time_point>>{};
+    deadlines.reserve(requests.size());
+    for (auto* request : requests) {
+      deadlines.push_back(get_request_deadline(request, start_time));
+    }
+    urgent = partition_urgent(requests, deadlines);
+  }
+
+  if (urgent != 0 && urgent < requests.size()) {
+    auto urgent_rows =
+      count_rows(std::begin(requests), std::begin(requests) + urgent, max_batch_size);
+    execute_batch(
+      instance, model_state, instance_state, requests.data(), urgent, urgent_rows, start_time);
+    execute_batch(instance,
+                  model_state,
+                  instance_state,
+                  requests.data() + urgent,
+                  requests.size() - urgent,
+                  rows - urgent_rows,
+                  start_time);
+  } else {
+    execute_batch(
+      instance, model_state, instance_state, requests.data(), requests.size(), rows, start_time);
+  }
+}
+
+/* Respond to an error thrown by execute. Triton takes back every request if
+ * execute returns an error, so the error is only returned if none has been
+ * released; otherwise the requests still held are failed here. */
+inline TRITONSERVER_Error* fail_execution(std::vector<TRITONBACKEND_Request*>& requests,
+                                          std::size_t request_count,
+                                          TritonException const& err)
+{
+  auto held = std::remove(std::begin(requests), std::end(requests), nullptr);
+  if (static_cast<std::size_t>(std::distance(std::begin(requests), held)) == request_count) {
+    return err.error();
+  }
+  try {
+    fail_requests(std::begin(requests), held, err.error());
+  } catch (TritonException const& fail_err) {
+    log_error(__FILE__, __LINE__) << "Failed to respond to requests: " << fail_err.what();
+  }
+  return nullptr;
+}
+
+/* Process a batch of requests released by an instance's accumulator, given
+ * the time at which each was added to it. Requests whose timeouts passed
+ * while they were held are failed without being processed. Since execute
+ * has already returned for these requests, any error is sent in response
+ * to those not yet released rather than returned to Triton. */
+template <typename ModelState, typename ModelInstanceState>
+void execute_accumulated(TRITONBACKEND_ModelInstance* instance,
+                         ModelState* model_state,
+                         ModelInstanceState* instance_state,
+                         std::vector<TRITONBACKEND_Request*>& requests,
+                         std::vector<time_point> const& received)
+{
+  auto range = nvtx_range{"execute accumulated: ", requests.size(), " requests"};
+  // Requests are held in the order in which they were added
+  auto start_time = received.front();
+  try {
+    instance_state->bind_thread();
+    drop_expired_requests(requests, received);
+    if (requests.empty()) { return; }
+    execute_requests(instance, model_state, instance_state, requests, start_time);
+  } catch (TritonException& err) {
+    // Requests already answered from the cache or by an earlier batch have
+    // been set to nullptr
+    auto held = std::remove(std::begin(requests), std::end(requests), nullptr);
+    fail_requests(std::begin(requests), held, err.error());
+  }
+}
+}  // namespace detail
+
 template <typename ModelState, typename ModelInstanceState>
 auto* execute(TRITONBACKEND_ModelInstance* instance,
               TRITONBACKEND_Request** raw_requests,
               std::size_t request_count)
 {
   auto start_time = std::chrono::steady_clock::now();
+  auto range      = nvtx_range{"execute: ", request_count, " requests"};
 
   auto* result = static_cast<TRITONSERVER_Error*>(nullptr);
+  // Requests are set to nullptr as they are released
+  auto requests = std::vector<TRITONBACKEND_Request*>(raw_requests, raw_requests + request_count);
 
   try {
     auto* model_state    = get_model_state<ModelState>(*get_model_from_instance(*instance));
     auto* instance_state = get_instance_state<ModelInstanceState>(*instance);
     auto& model          = instance_state->get_model();
     auto max_batch_size  = model.template get_config_param<std::size_t>("max_batch_size");
+    // Instances loaded asynchronously may still be loading
+    instance_state->wait_for_load();
+    // Host buffers for the batch are allocated on this thread
+    instance_state->bind_thread();
 
-    /* Note: It is safe to keep a reference to the model in this closure
-     * and a pointer to the instance in the next because the batch goes
-     * out of scope at the end of this block and Triton guarantees that
-     * the liftimes of both the instance and model extend beyond this
-     * function call. */
-    auto output_shape_fetcher = [&model](std::string const& name, Batch::size_type batch_dim) {
-      auto result       = std::vector<Batch::size_type>{};
-      auto config_shape = model.get_output_shape(name);
-      if (config_shape.size() > 0 && config_shape[0] < 0) { config_shape[0] = batch_dim; }
-      std::transform(
-        std::begin(config_shape),
-        std::end(config_shape),
-        std::back_inserter(result),
-        [](auto& coord) {
-          if (coord < 0) {
-            throw TritonException(
-              Error::Internal,
-              "Backends with variable-shape outputs must request desired output shape");
-          } else {
-            return narrow<std::size_t>(coord);
-          }
-        });
-      return result;
-    };
-    auto statistics_reporter = [instance](TRITONBACKEND_Request* request,
-                                          time_point req_start,
-                                          time_point req_comp_start,
-                                          time_point req_comp_end,
-                                          time_point req_end) {
-      report_statistics(*instance, *request, req_start, req_comp_start, req_comp_end, req_end);
-    };
-
-    auto batch = Batch(raw_requests,
-                       request_count,
-                       *(model_state->TritonMemoryManager()),
-                       std::move(output_shape_fetcher),
-                       std::move(statistics_reporter),
-                       model_state->EnablePinnedInput(),
-                       model_state->EnablePinnedOutput(),
-                       max_batch_size,
-                       model.get_stream());
-
-    if constexpr (IS_GPU_BUILD) {
-      if (model.get_deployment_type() == GPUDeployment) {
-        cuda_check(cudaSetDevice(model.get_device_id()));
-      }
+    // Traffic is captured as received, before any request is dropped
+    if (auto* capture = model_state->get_shared_state()->get_traffic_capture();
+        capture != nullptr) {
+      capture->record(raw_requests, request_count);
     }
 
-    auto predict_err = static_cast<TRITONSERVER_Error*>(nullptr);
-    try {
-      model.predict(batch);
-    } catch (TritonException& err) {
-      predict_err = err.error();
+    // Held requests are processed on the accumulator's thread
+    if (auto* accumulator = instance_state->get_accumulator(); accumulator != nullptr) {
+      for (auto i = std::size_t{}; i < requests.size(); ++i) {
+        accumulator->add(
+          requests[i],
+          detail::count_rows(requests.data() + i, requests.data() + i + 1, max_batch_size));
+        requests[i] = nullptr;
+      }
+      return result;
     }
-
-    auto& compute_start_time = batch.compute_start_time();
-    auto compute_end_time    = std::chrono::steady_clock::now();
-    batch.finalize(predict_err);
-    auto end_time = std::chrono::steady_clock::now();
-
-    report_statistics(
-      *instance, request_count, start_time, compute_start_time, compute_end_time, end_time);
+    // Requests whose timeouts passed before they could be processed (e.g.
+    // while waiting for the instance to load) are failed without being
+    // processed
+    detail::drop_expired_requests(requests,
+                                  std::vector<time_point>(requests.size(), start_time));
+    if (requests.empty()) { return result; }
+    detail::execute_requests(instance, model_state, instance_state, requests, start_time);
   } catch (TritonException& err) {
-    result = err.error();
+    result = detail::fail_execution(requests, request_count, err);
   }
 
   return result;
@@ -22,12 +22,14 @@
 #endif
 #include <triton/backend/backend_common.h>
 
+#include <cstddef>
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
 #include <rapids_triton/memory/resource.hpp>
 #include <rapids_triton/triton/backend.hpp>
 #include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/nvtx.hpp>
 #include <string>
 
 namespace triton {
@@ -39,6 +41,7 @@ inline auto* initialize(TRITONBACKEND_Backend* backend)
   auto* result = static_cast<TRITONSERVER_Error*>(nullptr);
   try {
     auto name = get_backend_name(*backend);
+    set_nvtx_domain(name);
 
     log_info(__FILE__, __LINE__) << "TRITONBACKEND_Initialize: " << name;
 
@@ -46,6 +49,12 @@ inline auto* initialize(TRITONBACKEND_Backend* backend)
       throw TritonException{Error::Unsupported,
                             "triton backend API version does not support this backend"};
     }
+    // Logging is shared by every model in the process, so whether it is
+    // asynchronous is a backend setting rather than a model parameter
+    if (get_backend_config_param(*backend, "async_logging", false)) {
+      enable_async_logging(
+        get_backend_config_param(*backend, "async_logging_capacity", std::size_t{4096}));
+    }
     if constexpr (IS_GPU_BUILD) {
       auto device_count = int{};
       auto cuda_err     = cudaGetDeviceCount(&device_count);
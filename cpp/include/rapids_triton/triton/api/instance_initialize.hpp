@@ -18,12 +18,21 @@
 
 #include <triton/backend/backend_common.h>
 #include <triton/backend/backend_model_instance.h>
+#include <cstddef>
+#include <optional>
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/host_resource.hpp>
+#include <rapids_triton/memory/pool_config.hpp>
+#include <rapids_triton/memory/resource.hpp>
+#include <rapids_triton/model/shard_group.hpp>
+#include <rapids_triton/triton/api/execute.hpp>
 #include <rapids_triton/triton/deployment.hpp>
 #include <rapids_triton/triton/logging.hpp>
 #include <rapids_triton/triton/model.hpp>
 #include <rapids_triton/triton/model_instance.hpp>
+#include <rapids_triton/triton/model_state.hpp>
+#include <string>
 
 namespace triton {
 namespace backend {
@@ -49,18 +58,63 @@ auto* instance_initialize(TRITONBACKEND_ModelInstance* instance)
 
     auto* triton_model = get_model_from_instance(*instance);
     auto* model_state  = get_model_state<ModelState>(*triton_model);
+    auto shared_state  = model_state->get_shared_state();
+    if (shared_state->template get_config_param<bool>("host_memory_pool", false)) {
+      auto host_pool_maximum_size = std::optional<std::size_t>{
+        shared_state->template get_config_param<std::size_t>("host_memory_pool_maximum_size",
+                                                             std::size_t{})};
+      if (*host_pool_maximum_size == 0) { host_pool_maximum_size = std::nullopt; }
+      setup_host_memory_resource(
+        true, IS_GPU_BUILD && deployment_type == GPUDeployment, host_pool_maximum_size);
+    }
     if constexpr (IS_GPU_BUILD) {
-      setup_memory_resource(device_id, model_state->TritonMemoryManager());
+      auto device_pool  = std::optional<pool_config>{};
+      auto pool_initial_size =
+        shared_state->template get_config_param<std::size_t>("device_memory_pool_initial_size",
+                                                             std::size_t{});
+      if (pool_initial_size > 0) {
+        device_pool = pool_config{pool_initial_size, std::nullopt};
+        auto pool_maximum_size =
+          shared_state->template get_config_param<std::size_t>("device_memory_pool_maximum_size",
+                                                               std::size_t{});
+        if (pool_maximum_size > 0) { device_pool->maximum_size = pool_maximum_size; }
+        if (shared_state->template get_config_param<bool>("device_memory_pool_shared", false)) {
+          device_pool->shared_library = shared_state->template get_config_param<std::string>(
+            "device_memory_pool_shared_library", std::string{"librapids_triton_shared_pool.so"});
+        }
+      }
+      setup_memory_resource(device_id, model_state->TritonMemoryManager(), device_pool);
+      if (deployment_type == GPUDeployment) {
+        for (auto shard_device : parse_device_list(
+               shared_state->template get_config_param<std::string>("shard_devices",
+                                                                    std::string{}))) {
+          setup_memory_resource(shard_device, model_state->TritonMemoryManager(), device_pool);
+        }
+      }
     }
 
     auto rapids_model = std::make_unique<ModelInstanceState>(*model_state, instance);
-    if constexpr (IS_GPU_BUILD) {
-      auto& model = rapids_model->get_model();
-      if (model.get_deployment_type() == GPUDeployment) {
-        cuda_check(cudaSetDevice(model.get_device_id()));
+    if (model_state->async_load()) {
+      // The shared state is awaited here so that Triton does not report the
+      // model ready before it has loaded, and so that its failure fails the
+      // model's load; each instance's own load then runs in the background,
+      // returning to Triton so that other instances can begin loading in
+      // parallel
+      rapids::detail::wait_for_load(model_state->get_shared_load());
+      rapids_model->load_async(model_state->get_shared_load());
+    } else {
+      if constexpr (IS_GPU_BUILD) {
+        auto& model = rapids_model->get_model();
+        if (model.get_deployment_type() == GPUDeployment) {
+          cuda_check(cudaSetDevice(model.get_device_id()));
+        }
       }
+      rapids_model->load();
     }
-    rapids_model->load();
+    rapids_model->start_accumulator(
+      [instance, model_state, state = rapids_model.get()](auto& requests, auto const& received) {
+        detail::execute_accumulated(instance, model_state, state, requests, received);
+      });
 
     set_instance_state<ModelInstanceState>(*instance, std::move(rapids_model));
   } catch (TritonException& err) {
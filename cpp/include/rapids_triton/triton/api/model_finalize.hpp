@@ -31,7 +31,7 @@ auto* model_finalize(TRITONBACKEND_Model* model)
   auto* result = static_cast<TRITONSERVER_Error*>(nullptr);
   try {
     auto model_state = get_model_state<ModelState>(*model);
-    if (model_state != nullptr) { model_state->get_shared_state()->unload(); }
+    if (model_state != nullptr) { model_state->unload(); }
 
     log_info(__FILE__, __LINE__) << "TRITONBACKEND_ModelFinalize: delete model state";
 
@@ -17,6 +17,7 @@
 #pragma once
 #include <triton/backend/backend_common.h>
 #include <triton/backend/backend_model.h>
+#include <cstddef>
 #include <rapids_triton/exceptions.hpp>
 #include <rapids_triton/triton/logging.hpp>
 #include <rapids_triton/triton/model.hpp>
@@ -38,6 +39,14 @@ auto* model_initialize(TRITONBACKEND_Model* model)
                                  << version << ")";
 
     auto rapids_model_state = std::make_unique<ModelState>(*model);
+    auto shared_state       = rapids_model_state->get_shared_state();
+    // Asynchronous logging is process-wide and so is configured for the
+    // backend; a model's own setting could otherwise change it for all
+    // other models
+    if (shared_state->template get_config_param<bool>("async_logging", false)) {
+      log_warn(__FILE__, __LINE__) << "Ignoring the async_logging parameter of " << name
+                                   << "; set it with --backend-config instead";
+    }
     rapids_model_state->load();
 
     set_model_state(*model, std::move(rapids_model_state));
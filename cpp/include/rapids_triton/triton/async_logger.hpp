@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <triton/core/tritonserver.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A logger which hands messages to a background thread for delivery
+ * to Triton, so that logging threads never wait on the server's log
+ *
+ * Messages are placed in a fixed-capacity lock-free ring buffer which any
+ * number of threads may write to concurrently. If the ring is full, the
+ * message is dropped rather than waiting for room, and the number of
+ * dropped messages is reported once there is room again. Messages still
+ * queued when the logger is destroyed are delivered first.
+ */
+struct async_logger {
+  explicit async_logger(std::size_t capacity = std::size_t{4096})
+    : mask_{ring_size(capacity) - 1},
+      slots_{std::make_unique<slot[]>(mask_ + 1)},
+      enqueue_pos_{},
+      dequeue_pos_{},
+      dropped_{},
+      waiting_{false},
+      shutdown_{false},
+      lock_{},
+      wake_{},
+      worker_{}
+  {
+    for (auto i = std::size_t{}; i <= mask_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker_ = std::thread{[this]() { run(); }};
+  }
+
+  async_logger(async_logger const& other) = delete;
+  async_logger& operator=(async_logger const& other) = delete;
+
+  ~async_logger()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      shutdown_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+  }
+
+  auto capacity() const noexcept { return mask_ + 1; }
+  /** Number of messages dropped because the ring was full */
+  auto dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Queue a message for delivery without waiting
+   *
+   * @return false if the ring was full and the message was dropped
+   */
+  bool push(TRITONSERVER_LogLevel level,
+            char const* filename,
+            int line,
+            std::string&& message) noexcept
+  {
+    auto pos   = enqueue_pos_.load(std::memory_order_relaxed);
+    auto* cell = static_cast<slot*>(nullptr);
+    while (true) {
+      cell          = &slots_[pos & mask_];
+      auto sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff     = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->level    = level;
+    cell->filename = filename;
+    cell->line     = line;
+    cell->message  = std::move(message);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    if (waiting_.load(std::memory_order_acquire)) { wake_.notify_one(); }
+    return true;
+  }
+
+ private:
+  struct slot {
+    std::atomic<std::size_t> sequence;
+    TRITONSERVER_LogLevel level;
+    char const* filename;
+    int line;
+    std::string message;
+  };
+
+  std::size_t mask_;
+  std::unique_ptr<slot[]> slots_;
+  std::atomic<std::size_t> enqueue_pos_;
+  // Only read and written by the worker thread
+  std::size_t dequeue_pos_;
+  std::atomic<std::size_t> dropped_;
+  std::atomic<bool> waiting_;
+  bool shutdown_;
+  std::mutex lock_;
+  std::condition_variable wake_;
+  std::thread worker_;
+
+  static std::size_t ring_size(std::size_t capacity)
+  {
+    auto result = std::size_t{2};
+    while (result < capacity) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  /* Deliver every message currently queued, returning whether any were */
+  bool drain(std::size_t& reported_drops)
+  {
+    auto result = false;
+    while (true) {
+      auto& cell    = slots_[dequeue_pos_ & mask_];
+      auto sequence = cell.sequence.load(std::memory_order_acquire);
+      if (sequence != dequeue_pos_ + 1) { break; }
+      TRITONSERVER_LogMessage(cell.level, cell.filename, cell.line, cell.message.c_str());
+      cell.message.clear();
+      cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+      ++dequeue_pos_;
+      result = true;
+    }
+    auto drops = dropped();
+    if (drops != reported_drops) {
+      auto message = std::to_string(drops - reported_drops) +
+                     " log messages dropped because the asynchronous log was full";
+      TRITONSERVER_LogMessage(TRITONSERVER_LOG_WARN, __FILE__, __LINE__, message.c_str());
+      reported_drops = drops;
+    }
+    return result;
+  }
+
+  void run()
+  {
+    auto reported_drops = std::size_t{};
+    while (true) {
+      if (drain(reported_drops)) { continue; }
+      auto lock = std::unique_lock<std::mutex>{lock_};
+      if (shutdown_) { break; }
+      waiting_.store(true, std::memory_order_release);
+      // Producers notify without holding the lock, so a wakeup may be missed;
+      // the timeout bounds the delay in that case
+      wake_.wait_for(lock, std::chrono::milliseconds{10});
+      waiting_.store(false, std::memory_order_relaxed);
+    }
+    drain(reported_drops);
+  }
+};
+
+namespace detail {
+struct async_logger_holder {
+  async_logger_holder() : current{nullptr}, logger{} {}
+  ~async_logger_holder() { current.store(nullptr, std::memory_order_release); }
+
+  std::atomic<async_logger*> current;
+  std::unique_ptr<async_logger> logger;
+};
+
+inline auto& get_async_logger_holder()
+{
+  static auto holder = async_logger_holder{};
+  return holder;
+}
+}  // namespace detail
+
+/** The process-wide asynchronous logger, or nullptr if messages are logged
+ * synchronously */
+inline auto* get_async_logger()
+{
+  return detail::get_async_logger_holder().current.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Deliver all subsequent log messages from a background thread
+ *
+ * The logger is process-wide; the first call determines its capacity and
+ * later calls have no effect.
+ */
+inline void enable_async_logging(std::size_t capacity = std::size_t{4096})
+{
+  static auto lock = std::mutex{};
+  auto guard       = std::lock_guard<std::mutex>{lock};
+  auto& holder     = detail::get_async_logger_holder();
+  if (!holder.logger) {
+    holder.logger = std::make_unique<async_logger>(capacity);
+    holder.current.store(holder.logger.get(), std::memory_order_release);
+  }
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <triton/backend/backend_common.h>
 #include <triton/core/tritonbackend.h>
 #include <cstdint>
 #include <rapids_triton/exceptions.hpp>
 #include <rapids_triton/triton/logging.hpp>
+#include <sstream>
 #include <string>
+#include <type_traits>
 
 namespace triton {
 namespace backend {
@@ -56,6 +59,44 @@ inline auto check_backend_version(TRITONBACKEND_Backend& backend)
   return ((version.major == TRITONBACKEND_API_VERSION_MAJOR) &&
           (version.minor >= TRITONBACKEND_API_VERSION_MINOR));
 }
+
+/**
+ * @brief Get the value of a setting given to the server for this backend
+ * with `--backend-config=<backend>,<name>=<value>`, or default_value if it
+ * was not given
+ *
+ * Backend settings apply to every model served by the backend, so they are
+ * the place for anything which is process-wide.
+ */
+template <typename T>
+auto get_backend_config_param(TRITONBACKEND_Backend& backend,
+                              std::string const& name,
+                              T default_value)
+{
+  auto* message = static_cast<TRITONSERVER_Message*>(nullptr);
+  triton_check(TRITONBACKEND_BackendConfig(&backend, &message));
+  auto const* buffer = static_cast<char const*>(nullptr);
+  auto size          = std::size_t{};
+  triton_check(TRITONSERVER_MessageSerializeToJson(message, &buffer, &size));
+  auto config = common::TritonJson::Value{};
+  triton_check(config.Parse(buffer, size));
+
+  auto cmdline = common::TritonJson::Value{};
+  if (!config.Find("cmdline", &cmdline) || !cmdline.Find(name.c_str())) { return default_value; }
+  auto text = std::string{};
+  triton_check(cmdline.MemberAsString(name.c_str(), &text));
+  auto input_stream = std::istringstream{text};
+  auto result       = T{};
+  if constexpr (std::is_same_v<T, bool>) {
+    input_stream >> std::boolalpha >> result;
+  } else {
+    input_stream >> result;
+  }
+  if (input_stream.fail()) {
+    throw TritonException(Error::InvalidArg, "Bad value for backend setting " + name);
+  }
+  return result;
+}
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <cstddef>
+#include <vector>
 
 #include <triton/backend/backend_common.h>
 #include <rapids_triton/exceptions.hpp>
@@ -32,6 +33,42 @@ inline auto get_max_batch_size(common::TritonJson::Value& config)
   triton_check(config.MemberAsInt("max_batch_size", &reported));
   return narrow<std::size_t>(reported);
 }
+
+/** Whether the model uses Triton's decoupled transaction policy, which
+ * allows any number of responses to be sent for each request */
+inline auto is_decoupled(common::TritonJson::Value& config)
+{
+  auto result = false;
+  auto policy = common::TritonJson::Value{};
+  if (config.Find("model_transaction_policy", &policy) && policy.Find("decoupled")) {
+    triton_check(policy.MemberAsBool("decoupled", &result));
+  }
+  return result;
+}
+
+/**
+ * @brief Convert the configured shape of an output to the shape of its
+ * tensor for a batch with the given number of rows
+ *
+ * Only the batch dimension may be left for rapids_triton to determine.
+ */
+inline auto resolve_output_shape(std::vector<int64_t> const& config_shape, std::size_t batch_dim)
+{
+  auto result = std::vector<std::size_t>{};
+  result.reserve(config_shape.size());
+  for (auto coord : config_shape) {
+    if (coord >= 0) {
+      result.push_back(narrow<std::size_t>(coord));
+    } else if (result.empty()) {
+      result.push_back(batch_dim);
+    } else {
+      throw TritonException(
+        Error::Internal,
+        "Outputs with variable-shape dimensions must be retrieved with an explicit shape");
+    }
+  }
+  return result;
+}
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
@@ -19,9 +19,12 @@
 #include <stdint.h>
 #include <triton/core/tritonbackend.h>
 #include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
 #include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/utils/narrow.hpp>
 #include <sstream>
 #include <string>
@@ -37,29 +40,117 @@ inline auto* get_triton_input(TRITONBACKEND_Request* request, std::string const&
   return result;
 }
 
-template <typename T, typename Iter>
-auto get_triton_input_shape(Iter requests_begin, Iter requests_end, std::string const& name)
+inline void check_input_dtype(std::string const& name, DType reported_dtype, DType required_dtype)
+{
+  if (reported_dtype != required_dtype) {
+    auto log_stream = std::stringstream{};
+    log_stream << "incorrect type " << reported_dtype << " for input " << name
+               << " with required type " << required_dtype;
+    throw(TritonException(Error::Internal, log_stream.str()));
+  }
+}
+
+/**
+ * @brief The type and shape which the model configuration requires of one
+ * input
+ *
+ * The shape includes the batch dimension of batched models, and a
+ * dimension of -1 may take any size.
+ */
+struct input_spec {
+  std::string name;
+  DType dtype;
+  std::vector<int64_t> shape;
+  bool optional;
+};
+
+/**
+ * @brief Check that the given request provides an input of the type and
+ * shape required by the given specification
+ *
+ * @throws TritonException with code Error::InvalidArg if it does not
+ */
+inline void check_triton_input(TRITONBACKEND_Request* request, input_spec const& spec)
+{
+  auto* input = static_cast<TRITONBACKEND_Input*>(nullptr);
+  if (auto* err = TRITONBACKEND_RequestInput(request, spec.name.c_str(), &input); err != nullptr) {
+    TRITONSERVER_ErrorDelete(err);
+    if (spec.optional) { return; }
+    throw TritonException(Error::InvalidArg, "request has no input named " + spec.name);
+  }
+
+  auto reported_dtype     = DType{};
+  auto const* input_shape = static_cast<int64_t*>(nullptr);
+  auto input_dims         = uint32_t{};
+  triton_check(TRITONBACKEND_InputProperties(
+    input, nullptr, &reported_dtype, &input_shape, &input_dims, nullptr, nullptr));
+  if (reported_dtype != spec.dtype) {
+    auto log_stream = std::stringstream{};
+    log_stream << "incorrect type " << reported_dtype << " for input " << spec.name
+               << " with required type " << spec.dtype;
+    throw TritonException(Error::InvalidArg, log_stream.str());
+  }
+  auto matches = input_dims == spec.shape.size() &&
+                 std::equal(input_shape,
+                            input_shape + input_dims,
+                            std::begin(spec.shape),
+                            [](auto reported, auto required) {
+                              return required < 0 || reported == required;
+                            });
+  if (!matches) {
+    auto log_stream = std::stringstream{};
+    log_stream << "input " << spec.name << " has shape [";
+    for (auto i = uint32_t{}; i < input_dims; ++i) {
+      log_stream << (i == 0 ? "" : ",") << input_shape[i];
+    }
+    log_stream << "] which does not match its configured shape";
+    throw TritonException(Error::InvalidArg, log_stream.str());
+  }
+}
+
+/**
+ * @brief Return the shape of the named input for the batch formed by
+ * concatenating all requests along their first dimension
+ *
+ * All requests must agree on every dimension after the first; inputs whose
+ * inner dimensions vary from request to request should be retrieved with
+ * get_triton_input_shapes instead.
+ */
+template <typename Iter>
+auto get_triton_input_shape(Iter requests_begin,
+                            Iter requests_end,
+                            std::string const& name,
+                            DType required_dtype)
 {
   auto result = std::vector<std::size_t>{};
 
   auto reported_dtype     = DType{};
   auto const* input_shape = static_cast<int64_t*>(nullptr);
   auto input_dims         = uint32_t{};
+  auto const* first_shape = static_cast<int64_t*>(nullptr);
+  auto first_dims         = uint32_t{};
 
   auto batch_dim = std::accumulate(
     requests_begin,
     requests_end,
     int64_t{},
-    [&reported_dtype, &input_shape, &input_dims, &name](auto total, auto& request) {
+    [&reported_dtype, &input_shape, &input_dims, &first_shape, &first_dims, &name, required_dtype](
+      auto total, auto& request) {
       auto* input = get_triton_input(request, name);
       triton_check(TRITONBACKEND_InputProperties(
         input, nullptr, &reported_dtype, &input_shape, &input_dims, nullptr, nullptr));
+      check_input_dtype(name, reported_dtype, required_dtype);
 
-      if (reported_dtype != TritonDtype<T>::value) {
-        auto log_stream = std::stringstream{};
-        log_stream << "incorrect type " << reported_dtype << " for input with required type "
-                   << TritonDtype<T>::value;
-        throw(TritonException(Error::Internal, log_stream.str()));
+      if (first_shape == nullptr) {
+        first_shape = input_shape;
+        first_dims  = input_dims;
+      } else if (input_dims != first_dims ||
+                 (input_dims != 0 &&
+                  !std::equal(input_shape + 1, input_shape + input_dims, first_shape + 1))) {
+        throw TritonException(Error::InvalidArg,
+                              "input " + name +
+                                " has different inner dimensions in different requests; "
+                                "it must be retrieved as a ragged input");
       }
 
       if (input_dims != 0) { total += *input_shape; }
@@ -75,6 +166,202 @@ auto get_triton_input_shape(Iter requests_begin, Iter requests_end, std::string
 
   return result;
 }
+
+template <typename T, typename Iter>
+auto get_triton_input_shape(Iter requests_begin, Iter requests_end, std::string const& name)
+{
+  return get_triton_input_shape(requests_begin, requests_end, name, TritonDtype<T>::value);
+}
+
+/**
+ * @brief Return the shape of the named input in each request separately
+ *
+ * This is used for ragged inputs, whose requests need not agree on any
+ * dimension.
+ */
+template <typename Iter>
+auto get_triton_input_shapes(Iter requests_begin,
+                             Iter requests_end,
+                             std::string const& name,
+                             DType required_dtype)
+{
+  auto result = std::vector<std::vector<std::size_t>>{};
+  result.reserve(std::distance(requests_begin, requests_end));
+  std::transform(
+    requests_begin,
+    requests_end,
+    std::back_inserter(result),
+    [&name, required_dtype](auto& request) {
+      auto* input             = get_triton_input(request, name);
+      auto reported_dtype     = DType{};
+      auto const* input_shape = static_cast<int64_t*>(nullptr);
+      auto input_dims         = uint32_t{};
+      triton_check(TRITONBACKEND_InputProperties(
+        input, nullptr, &reported_dtype, &input_shape, &input_dims, nullptr, nullptr));
+      check_input_dtype(name, reported_dtype, required_dtype);
+
+      auto shape = std::vector<std::size_t>{};
+      shape.reserve(input_dims);
+      std::transform(input_shape,
+                     input_shape + input_dims,
+                     std::back_inserter(shape),
+                     [](auto& val) { return narrow<std::size_t>(val); });
+      return shape;
+    });
+  return result;
+}
+
+/**
+ * @brief Return the data type of the named input, which must be the same for
+ * all requests
+ */
+template <typename Iter>
+auto get_triton_input_dtype(Iter requests_begin, Iter requests_end, std::string const& name)
+{
+  auto result = TRITONSERVER_TYPE_INVALID;
+  std::for_each(requests_begin, requests_end, [&result, &name](auto& request) {
+    auto* input         = get_triton_input(request, name);
+    auto reported_dtype = DType{};
+    triton_check(TRITONBACKEND_InputProperties(
+      input, nullptr, &reported_dtype, nullptr, nullptr, nullptr, nullptr));
+    if (result == TRITONSERVER_TYPE_INVALID) {
+      result = reported_dtype;
+    } else if (reported_dtype != result) {
+      throw TritonException(Error::InvalidArg,
+                            "input " + name + " has different types in different requests");
+    }
+  });
+  return result;
+}
+
+/**
+ * @brief Return the total size in bytes of the named input across all
+ * requests
+ *
+ * This is needed for inputs such as BYTES tensors whose size cannot be
+ * determined from their shape alone.
+ */
+template <typename Iter>
+auto get_triton_input_byte_size(Iter requests_begin, Iter requests_end, std::string const& name)
+{
+  return std::accumulate(
+    requests_begin, requests_end, std::size_t{}, [&name](auto total, auto& request) {
+      auto* input    = get_triton_input(request, name);
+      auto byte_size = uint64_t{};
+      triton_check(TRITONBACKEND_InputProperties(
+        input, nullptr, nullptr, nullptr, nullptr, &byte_size, nullptr));
+      return total + narrow<std::size_t>(byte_size);
+    });
+}
+
+/**
+ * @brief Return the size of the first dimension of the named input for each
+ * request
+ */
+template <typename Iter>
+auto get_triton_input_rows(Iter requests_begin, Iter requests_end, std::string const& name)
+{
+  auto result = std::vector<std::size_t>{};
+  result.reserve(std::distance(requests_begin, requests_end));
+  std::transform(requests_begin, requests_end, std::back_inserter(result), [&name](auto& request) {
+    auto* input             = get_triton_input(request, name);
+    auto const* input_shape = static_cast<int64_t*>(nullptr);
+    auto input_dims         = uint32_t{};
+    triton_check(TRITONBACKEND_InputProperties(
+      input, nullptr, nullptr, &input_shape, &input_dims, nullptr, nullptr));
+    return (input_dims == 0) ? std::size_t{} : narrow<std::size_t>(*input_shape);
+  });
+  return result;
+}
+
+/**
+ * @brief Return the total size of the first dimension of the first input of
+ * all requests, i.e. the number of rows in a batch of these requests
+ */
+template <typename Iter>
+auto get_triton_batch_rows(Iter requests_begin, Iter requests_end)
+{
+  return std::accumulate(
+    requests_begin, requests_end, std::size_t{}, [](auto rows, auto& request) {
+      auto* input = static_cast<TRITONBACKEND_Input*>(nullptr);
+      triton_check(TRITONBACKEND_RequestInputByIndex(request, 0, &input));
+      auto const* input_shape = static_cast<int64_t*>(nullptr);
+      auto input_dims         = uint32_t{};
+      triton_check(TRITONBACKEND_InputProperties(
+        input, nullptr, nullptr, &input_shape, &input_dims, nullptr, nullptr));
+      return rows + ((input_dims == 0) ? std::size_t{} : narrow<std::size_t>(*input_shape));
+    });
+}
+
+/**
+ * @brief The bytes occupied by batches of the given number of rows of every
+ * input with fixed dimensions
+ *
+ * Inputs with variable dimensions (other than the batch dimension) or of
+ * type BYTES are omitted, since their size cannot be known in advance.
+ */
+inline auto fixed_input_bytes(std::vector<input_spec> const& specs, std::size_t rows)
+{
+  auto result = std::size_t{};
+  for (auto const& spec : specs) {
+    if (spec.dtype == DTypeBytes || spec.shape.empty()) { continue; }
+    auto fixed = std::all_of(
+      std::next(std::begin(spec.shape)), std::end(spec.shape), [](auto dim) { return dim >= 0; });
+    if (!fixed) { continue; }
+    auto row_bytes = std::size_t{TRITONSERVER_DataTypeByteSize(spec.dtype)};
+    std::for_each(std::next(std::begin(spec.shape)), std::end(spec.shape), [&row_bytes](auto dim) {
+      row_bytes *= narrow<std::size_t>(dim);
+    });
+    result += rows * row_bytes;
+  }
+  return result;
+}
+
+/** The number of bytes of an input held in one memory location */
+struct input_placement {
+  MemoryType mem_type;
+  device_id_t device;
+  std::size_t bytes;
+};
+
+/**
+ * @brief Return where the data of the named input reside across all
+ * requests, as the number of bytes held in each distinct location
+ *
+ * Buffers are inspected in place, without copying, so this reflects e.g.
+ * CUDA shared memory regions registered by the client. Pinned host memory is
+ * reported as HostMemory. Locations are listed in order of first appearance.
+ */
+template <typename Iter>
+auto get_triton_input_placements(Iter requests_begin, Iter requests_end, std::string const& name)
+{
+  auto result = std::vector<input_placement>{};
+  std::for_each(requests_begin, requests_end, [&result, &name](auto& request) {
+    auto* input       = get_triton_input(request, name);
+    auto buffer_count = uint32_t{};
+    triton_check(TRITONBACKEND_InputProperties(
+      input, nullptr, nullptr, nullptr, nullptr, nullptr, &buffer_count));
+    for (auto i = uint32_t{}; i < buffer_count; ++i) {
+      auto const* buffer = static_cast<void const*>(nullptr);
+      auto byte_size     = uint64_t{};
+      auto mem_type      = HostMemory;
+      auto device        = int64_t{};
+      triton_check(TRITONBACKEND_InputBuffer(input, i, &buffer, &byte_size, &mem_type, &device));
+      if (mem_type == TRITONSERVER_MEMORY_CPU_PINNED) { mem_type = HostMemory; }
+      if (mem_type == HostMemory) { device = int64_t{}; }
+      auto placement =
+        std::find_if(std::begin(result), std::end(result), [mem_type, device](auto& entry) {
+          return entry.mem_type == mem_type && entry.device == device;
+        });
+      if (placement == std::end(result)) {
+        result.push_back(input_placement{mem_type, narrow<device_id_t>(device), std::size_t{}});
+        placement = std::prev(std::end(result));
+      }
+      placement->bytes += narrow<std::size_t>(byte_size);
+    }
+  });
+  return result;
+}
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
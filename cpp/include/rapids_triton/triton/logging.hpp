@@ -17,33 +17,63 @@
 #pragma once
 #include <triton/core/tritonserver.h>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/async_logger.hpp>
 
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace triton {
 namespace backend {
 namespace rapids {
 
 namespace {
-/** Log message at indicated level */
+/** Whether Triton will record messages at the indicated level */
+inline auto log_enabled(TRITONSERVER_LogLevel level) { return TRITONSERVER_LogIsEnabled(level); }
+
+/**
+ * @brief Log message at indicated level
+ *
+ * If asynchronous logging is enabled, the message is queued for a background
+ * thread rather than passed to Triton directly.
+ */
+inline void log(TRITONSERVER_LogLevel level, char const* filename, int line, std::string&& message)
+{
+  if (!log_enabled(level)) { return; }
+  if (auto* logger = get_async_logger(); logger != nullptr) {
+    logger->push(level, filename, line, std::move(message));
+  } else {
+    triton_check(TRITONSERVER_LogMessage(level, filename, line, message.c_str()));
+  }
+}
 inline void log(TRITONSERVER_LogLevel level, char const* filename, int line, char const* message)
 {
-  triton_check(TRITONSERVER_LogMessage(level, filename, line, message));
+  if (!log_enabled(level)) { return; }
+  if (auto* logger = get_async_logger(); logger != nullptr) {
+    logger->push(level, filename, line, std::string{message});
+  } else {
+    triton_check(TRITONSERVER_LogMessage(level, filename, line, message));
+  }
 }
 }  // namespace
 
+/**
+ * @brief A stream which logs everything written to it as one message when it
+ * is flushed or destroyed
+ *
+ * If Triton is not recording messages at the stream's level, the stream is
+ * placed in a failed state on construction so that nothing written to it is
+ * formatted.
+ */
 struct log_stream : public std::ostream {
   log_stream(TRITONSERVER_LogLevel level, char const* filename, int line)
     : std::ostream{}, buffer_{level, filename, line}
   {
     rdbuf(&buffer_);
+    if (!log_enabled(level)) { setstate(std::ios_base::badbit); }
   }
-  log_stream(TRITONSERVER_LogLevel level) : std::ostream{}, buffer_{level, __FILE__, __LINE__}
-  {
-    rdbuf(&buffer_);
-  }
+  log_stream(TRITONSERVER_LogLevel level) : log_stream{level, __FILE__, __LINE__} {}
 
   ~log_stream()
   {
@@ -65,8 +95,8 @@ struct log_stream : public std::ostream {
     {
       auto msg = str();
       if (!msg.empty()) {
-        log(level_, filename_, line_, msg.c_str());
         str("");
+        log(level_, filename_, line_, std::move(msg));
       }
       return 0;
     }
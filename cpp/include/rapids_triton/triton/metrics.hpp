@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <triton/core/tritonserver.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/triton/statistics.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/** The phases of batch processing for which latency is tracked */
+enum struct execute_phase : std::size_t {
+  collection,  // From receipt of the batch until the last input is collected
+  compute,     // From the last input collection until predict returns
+  output,      // Finalization of outputs after predict returns
+  completion,  // Synchronization and sending of responses
+  total,       // From receipt of the batch until responses are sent
+  device       // Device time taken by the work enqueued during predict
+};
+auto constexpr execute_phase_count = std::size_t{6};
+
+inline auto const* phase_name(execute_phase phase)
+{
+  auto static constexpr names = std::array<char const*, execute_phase_count>{
+    "collection", "compute", "output", "completion", "total", "device"};
+  return names[static_cast<std::size_t>(phase)];
+}
+
+/**
+ * @brief A fixed-bucket latency histogram which may be updated concurrently
+ * without locking
+ *
+ * Bucket i counts observations of at most 2^i microseconds, and the final
+ * bucket counts all observations too long for any other bucket. Updates are
+ * relaxed atomic increments, so readers may see the counts of a concurrent
+ * observation before its sum.
+ */
+struct latency_histogram {
+  static auto constexpr bucket_count = std::size_t{24};
+
+  latency_histogram() : buckets_{}, sum_{}, count_{} {}
+
+  /** Upper bound in microseconds of the given bucket or nullopt for the
+   * final bucket, which has no upper bound */
+  static auto upper_bound(std::size_t bucket)
+  {
+    auto result = std::optional<std::uint64_t>{};
+    if (bucket + 1 < bucket_count) { result = std::uint64_t{1} << bucket; }
+    return result;
+  }
+
+  void observe(std::chrono::nanoseconds duration) noexcept
+  {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    auto value  = static_cast<std::uint64_t>(micros < 0 ? 0 : micros);
+    auto bucket = std::size_t{};
+    while (bucket + 1 < bucket_count && (std::uint64_t{1} << bucket) < value) {
+      ++bucket;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /** Number of observations which fell into the given bucket */
+  auto bucket(std::size_t index) const noexcept
+  {
+    return buckets_[index].load(std::memory_order_relaxed);
+  }
+  /** Sum of all observations in microseconds */
+  auto sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+  /** Total number of observations */
+  auto count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  std::array<std::atomic<std::uint64_t>, bucket_count> buckets_;
+  std::atomic<std::uint64_t> sum_;
+  std::atomic<std::uint64_t> count_;
+};
+
+namespace detail {
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+inline void ignore_triton_error(TRITONSERVER_Error* err) noexcept
+{
+  if (err != nullptr) { TRITONSERVER_ErrorDelete(err); }
+}
+
+struct triton_metric_family {
+  triton_metric_family(char const* name,
+                       char const* description,
+                       TRITONSERVER_MetricKind kind = TRITONSERVER_METRIC_KIND_COUNTER)
+    : family_{nullptr}
+  {
+    triton_check(TRITONSERVER_MetricFamilyNew(&family_, kind, name, description));
+  }
+  triton_metric_family(triton_metric_family const& other) = delete;
+  triton_metric_family& operator=(triton_metric_family const& other) = delete;
+  ~triton_metric_family() { ignore_triton_error(TRITONSERVER_MetricFamilyDelete(family_)); }
+
+  auto* get() const noexcept { return family_; }
+
+ private:
+  TRITONSERVER_MetricFamily* family_;
+};
+
+struct triton_metric {
+  triton_metric(triton_metric_family const& family,
+                 std::vector<std::pair<std::string, std::string>> const& labels)
+    : metric_{nullptr}
+  {
+    auto parameters = std::vector<TRITONSERVER_Parameter const*>{};
+    parameters.reserve(labels.size());
+    for (auto& label : labels) {
+      parameters.push_back(TRITONSERVER_ParameterNew(
+        label.first.c_str(), TRITONSERVER_PARAMETER_STRING, label.second.c_str()));
+    }
+    auto* err = TRITONSERVER_MetricNew(&metric_, family.get(), parameters.data(), parameters.size());
+    for (auto* parameter : parameters) {
+      TRITONSERVER_ParameterDelete(const_cast<TRITONSERVER_Parameter*>(parameter));
+    }
+    triton_check(err);
+  }
+  triton_metric(triton_metric&& other) noexcept : metric_{other.metric_}
+  {
+    other.metric_ = nullptr;
+  }
+  triton_metric(triton_metric const& other) = delete;
+  triton_metric& operator=(triton_metric const& other) = delete;
+  ~triton_metric()
+  {
+    if (metric_ != nullptr) { ignore_triton_error(TRITONSERVER_MetricDelete(metric_)); }
+  }
+
+  void increment(std::uint64_t value) const
+  {
+    triton_check(TRITONSERVER_MetricIncrement(metric_, static_cast<double>(value)));
+  }
+
+  /** Set the value of a gauge */
+  void set(std::uint64_t value) const
+  {
+    triton_check(TRITONSERVER_MetricSet(metric_, static_cast<double>(value)));
+  }
+
+ private:
+  TRITONSERVER_Metric* metric_;
+};
+
+/** The metric families used for latency histograms, which are shared by all
+ * model instances in the process */
+struct latency_metric_families {
+  latency_metric_families()
+    : buckets{"rapids_triton_phase_latency_us_bucket",
+              "Cumulative count of backend processing phases completed within le microseconds"},
+      sum{"rapids_triton_phase_latency_us_sum",
+          "Total microseconds spent in backend processing phases"},
+      count{"rapids_triton_phase_latency_us_count", "Number of backend processing phases completed"}
+  {
+  }
+
+  triton_metric_family buckets;
+  triton_metric_family sum;
+  triton_metric_family count;
+};
+
+inline auto get_latency_metric_families()
+{
+  static auto lock     = std::mutex{};
+  static auto families = std::weak_ptr<latency_metric_families>{};
+  auto guard           = std::lock_guard<std::mutex>{lock};
+  auto result          = families.lock();
+  if (!result) {
+    result   = std::make_shared<latency_metric_families>();
+    families = result;
+  }
+  return result;
+}
+
+/** The metric families used for device memory usage, which are shared by all
+ * model instances in the process */
+struct memory_metric_families {
+  memory_metric_families()
+    : usage{"rapids_triton_device_memory_bytes",
+            "Bytes of device memory currently held against a model's budget",
+            TRITONSERVER_METRIC_KIND_GAUGE},
+      peak{"rapids_triton_device_memory_peak_bytes",
+           "Largest number of bytes of device memory held against a model's budget",
+           TRITONSERVER_METRIC_KIND_GAUGE}
+  {
+  }
+
+  triton_metric_family usage;
+  triton_metric_family peak;
+};
+
+inline auto get_memory_metric_families()
+{
+  static auto lock     = std::mutex{};
+  static auto families = std::weak_ptr<memory_metric_families>{};
+  auto guard           = std::lock_guard<std::mutex>{lock};
+  auto result          = families.lock();
+  if (!result) {
+    result   = std::make_shared<memory_metric_families>();
+    families = result;
+  }
+  return result;
+}
+
+/** The metric families used for staged input bytes and avoided output
+ * copies, which are shared by all model instances in the process */
+struct staging_metric_families {
+  staging_metric_families()
+    : staged{"rapids_triton_input_staged_bytes",
+             "Bytes of input data copied between memory locations during input collection"},
+      saved{"rapids_triton_output_copy_bytes_saved",
+            "Bytes of output data which did not need to be copied between memory locations "
+            "because outputs were placed where their responses wanted them"}
+  {
+  }
+
+  triton_metric_family staged;
+  triton_metric_family saved;
+};
+
+inline auto get_staging_metric_families()
+{
+  static auto lock     = std::mutex{};
+  static auto families = std::weak_ptr<staging_metric_families>{};
+  auto guard           = std::lock_guard<std::mutex>{lock};
+  auto result          = families.lock();
+  if (!result) {
+    result   = std::make_shared<staging_metric_families>();
+    families = result;
+  }
+  return result;
+}
+#endif
+}  // namespace detail
+
+/**
+ * @brief Per-instance latency histograms for each phase of batch processing
+ *
+ * Histograms are updated on every batch and periodically published to
+ * Triton's metrics endpoint as counters which follow the Prometheus histogram
+ * naming convention (`rapids_triton_phase_latency_us_bucket`, `_sum` and
+ * `_count`), labeled by model, version, instance and phase. Triton has no
+ * native histogram metric kind, so quantiles can be computed from these
+ * series with `histogram_quantile` in the usual way. Publication requires
+ * that rapids_triton be built with TRITON_ENABLE_METRICS against a version
+ * of Triton which provides the custom metrics API; otherwise histograms are
+ * collected but not published.
+ */
+struct latency_metrics {
+  latency_metrics(std::string const& model_name,
+                  std::uint64_t model_version,
+                  std::string const& instance_name)
+    : histograms_{}
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+      ,
+      families_{detail::get_latency_metric_families()},
+      bucket_counters_{},
+      sum_counters_{},
+      count_counters_{},
+      published_(execute_phase_count * (latency_histogram::bucket_count + 2)),
+      publish_lock_{}
+#endif
+  {
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+    auto version = std::to_string(model_version);
+    for (auto phase = std::size_t{}; phase < execute_phase_count; ++phase) {
+      auto labels = std::vector<std::pair<std::string, std::string>>{
+        {"model", model_name},
+        {"version", version},
+        {"instance", instance_name},
+        {"phase", phase_name(static_cast<execute_phase>(phase))}};
+      sum_counters_.emplace_back(families_->sum, labels);
+      count_counters_.emplace_back(families_->count, labels);
+      labels.emplace_back("le", "");
+      for (auto bucket = std::size_t{}; bucket < latency_histogram::bucket_count; ++bucket) {
+        auto bound           = latency_histogram::upper_bound(bucket);
+        labels.back().second = bound ? std::to_string(*bound) : std::string{"+Inf"};
+        bucket_counters_.emplace_back(families_->buckets, labels);
+      }
+    }
+#endif
+  }
+
+  void observe(execute_phase phase, std::chrono::nanoseconds duration) noexcept
+  {
+    histograms_[static_cast<std::size_t>(phase)].observe(duration);
+  }
+
+  /**
+   * @brief Record the duration of each phase of a batch from the timestamps
+   * of its phase boundaries
+   */
+  void observe_batch(time_point start_time,
+                     time_point compute_start_time,
+                     time_point predict_end_time,
+                     time_point compute_end_time,
+                     time_point end_time) noexcept
+  {
+    observe(execute_phase::collection, compute_start_time - start_time);
+    observe(execute_phase::compute, predict_end_time - compute_start_time);
+    observe(execute_phase::output, compute_end_time - predict_end_time);
+    observe(execute_phase::completion, end_time - compute_end_time);
+    observe(execute_phase::total, end_time - start_time);
+  }
+
+  auto const& get_histogram(execute_phase phase) const
+  {
+    return histograms_[static_cast<std::size_t>(phase)];
+  }
+
+  /**
+   * @brief Push all observations made since the last call to Triton
+   *
+   * If another thread is already publishing, this call returns immediately,
+   * and its observations will be included in the next publication.
+   */
+  void publish()
+  {
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+    auto guard = std::unique_lock<std::mutex>{publish_lock_, std::try_to_lock};
+    if (!guard.owns_lock()) { return; }
+    auto index          = std::size_t{};
+    auto push_increment = [this, &index](detail::triton_metric const& counter,
+                                         std::uint64_t value) {
+      auto& published = published_[index++];
+      if (value > published) {
+        counter.increment(value - published);
+        published = value;
+      }
+    };
+    for (auto phase = std::size_t{}; phase < execute_phase_count; ++phase) {
+      auto& histogram = histograms_[phase];
+      auto cumulative  = std::uint64_t{};
+      for (auto bucket = std::size_t{}; bucket < latency_histogram::bucket_count; ++bucket) {
+        cumulative += histogram.bucket(bucket);
+        push_increment(bucket_counters_[phase * latency_histogram::bucket_count + bucket],
+                       cumulative);
+      }
+      push_increment(sum_counters_[phase], histogram.sum());
+      push_increment(count_counters_[phase], histogram.count());
+    }
+#endif
+  }
+
+ private:
+  std::array<latency_histogram, execute_phase_count> histograms_;
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+  std::shared_ptr<detail::latency_metric_families> families_;
+  std::vector<detail::triton_metric> bucket_counters_;
+  std::vector<detail::triton_metric> sum_counters_;
+  std::vector<detail::triton_metric> count_counters_;
+  std::vector<std::uint64_t> published_;
+  std::mutex publish_lock_;
+#endif
+};
+
+/**
+ * @brief Gauges reporting the current and peak device memory held against
+ * a model's memory budget
+ *
+ * Values are published to Triton's metrics endpoint as
+ * `rapids_triton_device_memory_bytes` and
+ * `rapids_triton_device_memory_peak_bytes`, labeled by model, version,
+ * instance and device. As with latency_metrics, nothing is published unless
+ * rapids_triton is built with TRITON_ENABLE_METRICS.
+ */
+struct memory_metrics {
+  memory_metrics(std::string const& model_name,
+                 std::uint64_t model_version,
+                 std::string const& instance_name,
+                 device_id_t device)
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+    : families_{detail::get_memory_metric_families()},
+      usage_{families_->usage,
+             {{"model", model_name},
+              {"version", std::to_string(model_version)},
+              {"instance", instance_name},
+              {"device", std::to_string(device)}}},
+      peak_{families_->peak,
+            {{"model", model_name},
+             {"version", std::to_string(model_version)},
+             {"instance", instance_name},
+             {"device", std::to_string(device)}}}
+#endif
+  {
+  }
+
+  void publish(std::size_t current, std::size_t peak) const
+  {
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+    usage_.set(current);
+    peak_.set(peak);
+#endif
+  }
+
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+ private:
+  std::shared_ptr<detail::memory_metric_families> families_;
+  detail::triton_metric usage_;
+  detail::triton_metric peak_;
+#endif
+};
+
+/**
+ * @brief Counters of the input bytes which one instance had to copy between
+ * memory locations (see Batch::staged_input_bytes) and of the output bytes
+ * it did not need to copy (see Batch::saved_output_copy_bytes)
+ *
+ * The counts are published to Triton's metrics endpoint as
+ * `rapids_triton_input_staged_bytes` and
+ * `rapids_triton_output_copy_bytes_saved`, labeled by model, version and
+ * instance. As with latency_metrics, nothing is published unless
+ * rapids_triton is built with TRITON_ENABLE_METRICS.
+ */
+struct staging_metrics {
+  staging_metrics(std::string const& model_name,
+                  std::uint64_t model_version,
+                  std::string const& instance_name)
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+    : families_{detail::get_staging_metric_families()},
+      staged_{families_->staged,
+              {{"model", model_name},
+               {"version", std::to_string(model_version)},
+               {"instance", instance_name}}},
+      saved_{families_->saved,
+             {{"model", model_name},
+              {"version", std::to_string(model_version)},
+              {"instance", instance_name}}}
+#endif
+  {
+  }
+
+  void publish(std::size_t staged_bytes, std::size_t saved_bytes = 0) const
+  {
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+    if (staged_bytes != 0) { staged_.increment(staged_bytes); }
+    if (saved_bytes != 0) { saved_.increment(saved_bytes); }
+#endif
+  }
+
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+ private:
+  std::shared_ptr<detail::staging_metric_families> families_;
+  detail::triton_metric staged_;
+  detail::triton_metric saved_;
+#endif
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
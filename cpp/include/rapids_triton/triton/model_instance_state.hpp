@@ -16,10 +16,40 @@
 
 #pragma once
 #include <triton/backend/backend_model_instance.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
+#include <optional>
+#include <rapids_triton/batch/accumulator.hpp>
+#include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/batch/batch_pool.hpp>
+#include <rapids_triton/batch/hybrid_dispatch.hpp>
+#include <rapids_triton/batch/pipeline.hpp>
+#include <rapids_triton/batch/predict_graph.hpp>
+#include <rapids_triton/batch/priority.hpp>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/memory_budget.hpp>
+#include <rapids_triton/model/artifact.hpp>
+#include <rapids_triton/triton/config.hpp>
+#include <rapids_triton/triton/deployment.hpp>
+#include <rapids_triton/triton/input.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/triton/metrics.hpp>
 #include <rapids_triton/triton/model_instance.hpp>
 #include <rapids_triton/triton/model_state.hpp>
+#include <rapids_triton/triton/performance_snapshot.hpp>
+#include <rapids_triton/triton/statistics.hpp>
+#include <rapids_triton/utils/narrow.hpp>
+#include <rapids_triton/utils/numa.hpp>
+#include <rapids_triton/utils/stream_pool.hpp>
+#include <string>
+#include <vector>
 
 namespace triton {
 namespace backend {
@@ -36,17 +66,536 @@ struct ModelInstanceState : public BackendModelInstance {
              Kind(),
              JoinPath({model_state.RepositoryPath(),
                        std::to_string(model_state.Version()),
-                       ArtifactFilename()}))
+                       ArtifactFilename()})),
+      output_shape_fetcher_{[this](std::string const& name, Batch::size_type batch_dim) {
+        return resolve_output_shape(model_.get_output_shape(name), batch_dim);
+      }},
+      statistics_reporter_{[triton_model_instance](TRITONBACKEND_Request* request,
+                                                   time_point const& req_start,
+                                                   time_point const& req_comp_start,
+                                                   time_point const& req_comp_end,
+                                                   time_point const& req_end) {
+        report_statistics(
+          *triton_model_instance, *request, req_start, req_comp_start, req_comp_end, req_end);
+      }},
+      copy_streams_{},
+      collection_streams_{},
+      pinned_staging_bytes_{},
+      batches_{output_shape_fetcher_, statistics_reporter_},
+      pipeline_{},
+      metrics_{},
+      memory_budget_{},
+      predict_admission_{},
+      memory_metrics_{},
+      staging_metrics_{},
+      performance_counters_{},
+      device_timing_{false},
+      allocation_trace_{model_state.get_shared_state()->get_allocation_trace()},
+      batch_buckets_{},
+      predict_graphs_{},
+      hybrid_dispatch_{},
+      host_fallback_wait_{},
+      latency_budget_{model_.latency_budget()},
+      latency_estimate_{},
+      batch_latency_{},
+      numa_node_{},
+      load_{},
+      loaded_{false},
+      watcher_{},
+      accumulator_{},
+      performance_exporter_{}
   {
+    if (IS_GPU_BUILD && model_.get_deployment_type() == GPUDeployment &&
+        model_.template get_config_param<bool>("numa_affinity", true)) {
+      numa_node_ = get_device_numa_node(model_.get_device_id());
+      if (numa_node_) {
+        log_info(__FILE__, __LINE__)
+          << "Binding threads of " << Name() << " to NUMA node " << *numa_node_;
+      }
+    }
+    auto depth = model_.max_in_flight_batches();
+    if (depth > 1 || model_.use_completion_thread()) {
+      pipeline_ = std::make_unique<batch_pipeline>(
+        depth, model_.get_device_id(), model_.get_deployment_type(), CudaStream(), numa_node_);
+    }
+    if (IS_METRICS_BUILD && model_.template get_config_param<bool>("latency_metrics", true)) {
+      try {
+        metrics_ =
+          std::make_unique<latency_metrics>(model_state.Name(), model_state.Version(), Name());
+      } catch (TritonException const& err) {
+        log_warn(__FILE__, __LINE__)
+          << "Latency metrics unavailable for " << Name() << ": " << err.what();
+      }
+    }
+    // Padding would be undone by dividing batches into row slices
+    auto max_batch_size = model_.template get_config_param<std::size_t>("max_batch_size");
+    if (max_batch_size > 0 && model_.max_rows_per_predict() == 0) {
+      batch_buckets_ = model_.batch_buckets();
+    }
+    // Pinned staging is sized for a full batch of every fixed-size input
+    if (IS_GPU_BUILD && model_.get_deployment_type() == GPUDeployment && max_batch_size > 0 &&
+        model_state.EnablePinnedInput()) {
+      pinned_staging_bytes_ =
+        fixed_input_bytes(model_state.get_shared_state()->get_input_specs(), max_batch_size);
+    }
+    if (max_batch_size > 0 && model_.accumulation_target().count() != 0) {
+      batch_latency_ = std::make_unique<batch_latency_model>(batch_buckets_, max_batch_size);
+    }
+    if (model_.use_concurrent_input_collection()) {
+      collection_streams_.emplace();
+      // One stream for each input, so that any inputs can be gathered at once
+      if (IS_GPU_BUILD && model_.get_deployment_type() == GPUDeployment) {
+        auto input_count = model_state.get_shared_state()->get_input_specs().size();
+        for (auto i = std::size_t{}; i < input_count; ++i) {
+          collection_streams_->push_back(model_.acquire_stream());
+        }
+      }
+    }
+    if (IS_GPU_BUILD && model_.get_deployment_type() == GPUDeployment) {
+      if (model_.use_copy_streams()) {
+        copy_streams_ = std::make_unique<instance_copy_streams>(
+          instance_copy_streams{model_.acquire_stream(), model_.acquire_stream()});
+      }
+      auto* shared_state = model_state.get_shared_state().get();
+      memory_budget_     = shared_state->get_memory_budget(model_.get_device_id());
+      predict_admission_ = shared_state->get_predict_admission(model_.get_device_id());
+      // Device time is only reported as a latency metric
+      device_timing_ = metrics_ && model_.use_device_timing();
+      if (model_.use_host_fallback()) {
+        auto wait_ms =
+          model_.template get_config_param<std::uint64_t>("host_fallback_wait_ms", std::uint64_t{});
+        host_fallback_wait_ = std::chrono::milliseconds{wait_ms};
+      }
+      if (model_.use_hybrid_dispatch()) {
+        hybrid_dispatch_ = std::make_unique<hybrid_dispatch>(
+          model_.template get_config_param<std::size_t>("hybrid_dispatch_max_host_rows",
+                                                        std::size_t{}));
+      }
+      // Graphs are bound to fixed storage, so they cannot be shared by
+      // several batches in flight at once
+      if (model_.use_cuda_graphs() && !pipeline_ && max_batch_size > 0 &&
+          model_.max_rows_per_predict() == 0) {
+        predict_graphs_ = std::make_unique<predict_graph_cache>(max_batch_size, batch_buckets_);
+      }
+    }
+    if (IS_METRICS_BUILD && memory_budget_) {
+      try {
+        memory_metrics_ = std::make_unique<memory_metrics>(
+          model_state.Name(), model_state.Version(), Name(), model_.get_device_id());
+      } catch (TritonException const& err) {
+        log_warn(__FILE__, __LINE__)
+          << "Memory metrics unavailable for " << Name() << ": " << err.what();
+      }
+    }
+    if (IS_METRICS_BUILD) {
+      try {
+        staging_metrics_ =
+          std::make_unique<staging_metrics>(model_state.Name(), model_state.Version(), Name());
+      } catch (TritonException const& err) {
+        log_warn(__FILE__, __LINE__)
+          << "Staging metrics unavailable for " << Name() << ": " << err.what();
+      }
+    }
+    export_performance_snapshots();
   }
 
   auto& get_model() const { return model_; }
 
-  void load() { model_.load(); }
-  void unload() { model_.unload(); }
+  /** Return a Batch for the given requests, reusing a previously completed
+   * batch of this instance where possible */
+  auto acquire_batch(TRITONBACKEND_Request** raw_requests,
+                     request_size_t count,
+                     TRITONBACKEND_MemoryManager& triton_mem_manager,
+                     bool use_pinned_input,
+                     bool use_pinned_output,
+                     Batch::size_type max_batch_size,
+                     cudaStream_t stream)
+  {
+    return batches_.acquire(raw_requests,
+                            count,
+                            triton_mem_manager,
+                            use_pinned_input,
+                            use_pinned_output,
+                            max_batch_size,
+                            stream);
+  }
+
+  /** Return the pipeline used to complete batches in the background or
+   * nullptr if batches for this instance are completed on the execute
+   * thread */
+  auto* get_pipeline() const { return pipeline_.get(); }
+
+  /** Return the streams on which this instance's batches transfer inputs
+   * and outputs or nullptr if transfers share each batch's stream */
+  auto* get_copy_streams() const { return copy_streams_.get(); }
+
+  /** Return the streams on which this instance's batches gather inputs
+   * concurrently or nullptr if inputs are gathered one at a time. The
+   * streams are empty for CPU deployments. */
+  auto const* get_collection_streams() const
+  {
+    return collection_streams_ ? &*collection_streams_ : nullptr;
+  }
+
+  /** The pinned staging storage reserved by each of this instance's
+   * batches (see Batch::reserve_pinned_staging) */
+  auto get_pinned_staging_bytes() const { return pinned_staging_bytes_; }
+
+  /** Return the latency histograms for this instance or nullptr if latency
+   * metrics are disabled */
+  auto* get_latency_metrics() const { return metrics_.get(); }
+
+  /** Whether the device time taken by predict is measured for each of this
+   * instance's batches */
+  auto uses_device_timing() const { return device_timing_; }
+
+  /** Return the trace recording this instance's allocations or nullptr if
+   * they are not traced */
+  auto const& get_allocation_trace() const { return allocation_trace_; }
+
+  /** Return the budget charged for device memory allocated by this
+   * instance's batches or nullptr if its allocations are unbudgeted */
+  auto const& get_memory_budget() const { return memory_budget_; }
+
+  /** Return the choice between the model's host and device paths for each
+   * batch or nullptr if every batch is predicted by predict */
+  auto* get_hybrid_dispatch() const { return hybrid_dispatch_.get(); }
+
+  /** Return how long a batch waits for admission to the device before
+   * falling back to the host, or std::nullopt if it never falls back */
+  auto const& get_host_fallback_wait() const { return host_fallback_wait_; }
+
+  /** Return the limit on device work in flight shared with the model's
+   * other instances on this device or nullptr if it is unlimited */
+  auto* get_predict_admission() const { return predict_admission_.get(); }
+
+  /** Return the gauges used to report this instance's budgeted memory usage
+   * or nullptr if they are not published */
+  auto* get_memory_metrics() const { return memory_metrics_.get(); }
+
+  /** Return the counter of input bytes staged between memory locations by
+   * this instance or nullptr if it is not published */
+  auto* get_staging_metrics() const { return staging_metrics_.get(); }
+
+  /** Return the counters of this instance's batch activity exported in
+   * periodic snapshots or nullptr if snapshots are disabled */
+  auto* get_performance_counters() const { return performance_counters_.get(); }
+
+  /** Batch sizes to which this instance's batches are padded */
+  auto const& get_batch_buckets() const { return batch_buckets_; }
+
+  /** Return the CUDA graphs used to replay predict or nullptr if this
+   * instance does not use graphs */
+  auto* get_predict_graphs() const { return predict_graphs_.get(); }
+
+  /** The latency a batch may add to requests with deadlines before they are
+   * processed separately, or zero for no limit */
+  auto get_latency_budget() const { return latency_budget_; }
+
+  /** The running estimate of this instance's time to process each row */
+  auto& get_latency_estimator() { return latency_estimate_; }
+
+  /** Return the measured latency of this instance's batches of each size or
+   * nullptr if it is not measured */
+  auto* get_batch_latency_model() const { return batch_latency_.get(); }
+
+  /**
+   * @brief Begin holding requests in an accumulation queue, if this
+   * instance's model sets an accumulation target
+   *
+   * @param process Called on the queue's background thread to process each
+   * accumulated batch of requests
+   */
+  void start_accumulator(request_accumulator::process_fn process)
+  {
+    if (batch_latency_) {
+      accumulator_ = std::make_unique<request_accumulator>(
+        model_.accumulation_target(),
+        model_.template get_config_param<std::size_t>("max_batch_size"),
+        *batch_latency_,
+        std::move(process));
+    }
+  }
+
+  /** Return the queue in which requests are accumulated or nullptr if each
+   * call to execute is processed at once */
+  auto* get_accumulator() const { return accumulator_.get(); }
+
+  void load()
+  {
+    auto trace_scope = scoped_allocation_trace{allocation_trace_};
+    {
+      auto site = scoped_allocation_site{allocation_site::model_load};
+      model_.load();
+    }
+    warmup();
+    watch_artifact();
+  }
+
+  /**
+   * @brief Call the model's warmup hook and then pass a synthetic batch of
+   * each of its warmup batch sizes through predict
+   *
+   * Synthetic batches are padded and divided into row slices as batches of
+   * requests would be, but are not replayed through CUDA graphs. Since
+   * warmup is only an optimization, a failed synthetic batch is logged
+   * rather than failing the load. If the model's hybrid dispatch threshold
+   * must be learned, each size is then timed on both the host and the
+   * device.
+   */
+  void warmup()
+  {
+    model_.warmup();
+    auto sizes       = model_.warmup_batch_sizes();
+    auto calibrating = hybrid_dispatch_ && hybrid_dispatch_->needs_calibration();
+    if (sizes.empty()) {
+      if (calibrating) {
+        log_warn(__FILE__, __LINE__) << "No warmup_batch_sizes from which to learn hybrid "
+                                     << "dispatch for " << Name()
+                                     << "; all batches will be predicted on the device";
+      }
+      return;
+    }
+    auto max_batch_size = model_.template get_config_param<std::size_t>("max_batch_size");
+    if (max_batch_size == 0) { sizes.resize(1); }
+    auto budget_scope = scoped_memory_budget{memory_budget_};
+    auto samples      = std::vector<dispatch_sample>{};
+    for (auto rows : sizes) {
+      if (max_batch_size > 0 && rows > max_batch_size) {
+        log_warn(__FILE__, __LINE__) << "Skipping warmup batch of " << rows << " rows for "
+                                     << Name() << ", which exceeds max_batch_size";
+        continue;
+      }
+      auto warmed = run_warmup_batch(rows, false).has_value();
+      if (calibrating && warmed && run_warmup_batch(rows, true)) {
+        // Each path is timed only once it has been warmed up
+        auto host_time   = run_warmup_batch(rows, true);
+        auto device_time = run_warmup_batch(rows, false);
+        if (host_time && device_time) { samples.push_back({rows, *host_time, *device_time}); }
+      }
+    }
+    if (calibrating) {
+      hybrid_dispatch_->calibrate(std::move(samples));
+      log_info(__FILE__, __LINE__) << "Batches of up to " << hybrid_dispatch_->max_host_rows()
+                                   << " rows will be predicted on the host for " << Name();
+    }
+    log_info(__FILE__, __LINE__) << "Finished warmup of " << Name();
+  }
+
+  /**
+   * @brief Pass one synthetic batch of the given number of rows through
+   * predict, or through predict_on_host if on_host is true
+   *
+   * @return The time taken to process the batch or std::nullopt if it failed
+   */
+  std::optional<std::chrono::nanoseconds> run_warmup_batch(std::size_t rows, bool on_host)
+  {
+    auto max_batch_size = model_.template get_config_param<std::size_t>("max_batch_size");
+    auto& model_state   = static_cast<TritonModelState<RapidsSharedState>&>(*Model());
+    auto start          = std::chrono::steady_clock::now();
+
+    auto batch = batches_.acquire(nullptr,
+                                  request_size_t{},
+                                  *(model_state.TritonMemoryManager()),
+                                  false,
+                                  false,
+                                  max_batch_size,
+                                  model_.get_stream());
+    if (on_host) { batch->dispatch_to_host(); }
+    batch->synthesize_inputs(model_state.get_shared_state()->get_input_specs(), rows);
+    batch->use_transforms(model_state.get_shared_state()->get_transforms());
+    batch->use_compression(model_state.get_shared_state()->get_compression());
+    auto result = std::optional<std::chrono::nanoseconds>{};
+    try {
+      if (!batch_buckets_.empty()) { batch->pad_to_bucket(batch_buckets_); }
+      auto max_rows = (max_batch_size > 0) ? model_.max_rows_per_predict() : std::size_t{};
+      batch->for_each_row_slice(max_rows, [this, on_host](Batch& slice) {
+        if (on_host) {
+          model_.predict_on_host(slice);
+        } else {
+          model_.predict(slice);
+        }
+      });
+      result.emplace();
+    } catch (TritonException const& err) {
+      log_warn(__FILE__, __LINE__) << "Warmup batch of " << rows << " rows"
+                                   << (on_host ? " on the host" : "") << " failed for " << Name()
+                                   << ": " << err.what();
+    }
+    // Completing the batch waits for its work before it is reused
+    batch->finalize(nullptr);
+    if constexpr (IS_GPU_BUILD) {
+      // Synthetic batches send no responses, so their device work must be
+      // awaited for it to be timed
+      if (result && !on_host) { cuda_check(cudaStreamSynchronize(batch->stream())); }
+    }
+    if (result) { *result = std::chrono::steady_clock::now() - start; }
+    return result;
+  }
+
+  /**
+   * @brief Reload the model whenever its artifact is replaced, if the
+   * `reload_poll_interval_ms` configuration parameter is set
+   *
+   * Each reload runs on the watcher's thread while this instance continues
+   * to process batches (see Model::reload).
+   */
+  void watch_artifact()
+  {
+    auto interval = std::chrono::milliseconds{
+      model_.template get_config_param<std::uint64_t>("reload_poll_interval_ms", std::uint64_t{})};
+    if (interval.count() == 0) { return; }
+    watcher_ = std::make_unique<artifact_watcher>(model_.get_filepath(), interval, [this]() {
+      bind_thread();
+      if constexpr (IS_GPU_BUILD) {
+        if (model_.get_deployment_type() == GPUDeployment) {
+          cuda_check(cudaSetDevice(model_.get_device_id()));
+        }
+      }
+      log_info(__FILE__, __LINE__) << "Reloading " << Name() << " from " << model_.get_filepath();
+      model_.reload();
+      log_info(__FILE__, __LINE__) << "Reloaded " << Name();
+    });
+  }
+
+  /**
+   * @brief Export a snapshot of this instance's batch activity every
+   * `performance_snapshot_interval_s` seconds, if that is set
+   *
+   * Snapshots are appended to `performance_snapshot_path` as lines of JSON
+   * or, if no path is set, logged at `performance_snapshot_log_level`
+   * ("info" by default).
+   */
+  void export_performance_snapshots()
+  {
+    auto interval = std::chrono::seconds{model_.template get_config_param<std::uint64_t>(
+      "performance_snapshot_interval_s", std::uint64_t{})};
+    if (interval.count() == 0) { return; }
+    auto path  = model_.template get_config_param<std::string>("performance_snapshot_path",
+                                                               std::string{});
+    auto level = parse_log_level(
+      model_.template get_config_param<std::string>("performance_snapshot_log_level", "info"));
+    performance_counters_ = std::make_unique<performance_counters>();
+    try {
+      performance_exporter_ = std::make_unique<performance_exporter>(
+        Name(), interval, path, level, *performance_counters_);
+    } catch (TritonException const& err) {
+      log_warn(__FILE__, __LINE__)
+        << "Performance snapshots unavailable for " << Name() << ": " << err.what();
+      performance_counters_.reset();
+    }
+  }
+
+  /**
+   * @brief Load this instance on a background thread once the given shared
+   * state load (if valid) has completed
+   *
+   * Batches received before loading completes wait for it in execute.
+   */
+  void load_async(std::shared_future<void> shared_load)
+  {
+    load_ = detail::launch_load([this, shared_load]() {
+      detail::wait_for_load(shared_load);
+      bind_thread();
+      if constexpr (IS_GPU_BUILD) {
+        if (model_.get_deployment_type() == GPUDeployment) {
+          cuda_check(cudaSetDevice(model_.get_device_id()));
+        }
+      }
+      load();
+      loaded_.store(true, std::memory_order_release);
+    });
+  }
+
+  /**
+   * @brief Bind the calling thread to the NUMA node nearest this instance's
+   * device, if it is known
+   *
+   * Host allocations made by the thread afterwards (including staging and
+   * pinned buffers and any host pool blocks) are then placed on that node.
+   * This can be disabled by setting `numa_affinity` to false.
+   */
+  void bind_thread() const
+  {
+    if (numa_node_) { bind_thread_to_numa_node(*numa_node_); }
+  }
+
+  /** Block until this instance has loaded, rethrowing any load error */
+  void wait_for_load() const
+  {
+    if (!loaded_.load(std::memory_order_acquire)) { detail::wait_for_load(load_); }
+  }
+
+  void unload()
+  {
+    // Requests still held are processed before the model is unloaded
+    accumulator_.reset();
+    if (load_.valid()) {
+      try {
+        load_.get();
+      } catch (TritonException const& err) {
+        // A failed load leaves nothing to unload
+        return;
+      }
+    }
+    // The watcher is started by load, so it is only stopped once load is done
+    watcher_.reset();
+    if (pipeline_) { pipeline_->drain(); }
+    // Reported so that budgets and pools can be sized for predict's workspace
+    auto scratch_bytes = batches_.scratch_high_water_mark();
+    if (scratch_bytes != 0) {
+      log_info(__FILE__, __LINE__)
+        << "Scratch high-water mark for " << Name() << ": " << scratch_bytes << " bytes";
+    }
+    model_.unload();
+  }
 
  private:
   RapidsModel model_;
+  std::function<std::vector<Batch::size_type>(std::string const&, Batch::size_type)>
+    output_shape_fetcher_;
+  std::function<void(TRITONBACKEND_Request*,
+                     time_point const&,
+                     time_point const&,
+                     time_point const&,
+                     time_point const&)>
+    statistics_reporter_;
+  struct instance_copy_streams {
+    pooled_stream input;
+    pooled_stream output;
+  };
+  // Declared after the model, whose pool they are returned to, and before
+  // the batches which use them
+  std::unique_ptr<instance_copy_streams> copy_streams_;
+  std::optional<std::vector<pooled_stream>> collection_streams_;
+  std::size_t pinned_staging_bytes_;
+  // Declared before the pipeline so that any batch still held by the
+  // pipeline is returned before the pool is destroyed
+  batch_pool batches_;
+  std::unique_ptr<batch_pipeline> pipeline_;
+  std::unique_ptr<latency_metrics> metrics_;
+  std::shared_ptr<memory_budget> memory_budget_;
+  std::shared_ptr<predict_admission> predict_admission_;
+  std::unique_ptr<memory_metrics> memory_metrics_;
+  std::unique_ptr<staging_metrics> staging_metrics_;
+  std::unique_ptr<performance_counters> performance_counters_;
+  bool device_timing_;
+  std::shared_ptr<allocation_trace> allocation_trace_;
+  std::vector<std::size_t> batch_buckets_;
+  std::unique_ptr<predict_graph_cache> predict_graphs_;
+  std::unique_ptr<hybrid_dispatch> hybrid_dispatch_;
+  std::optional<std::chrono::milliseconds> host_fallback_wait_;
+  std::chrono::microseconds latency_budget_;
+  latency_estimator latency_estimate_;
+  std::unique_ptr<batch_latency_model> batch_latency_;
+  std::optional<int> numa_node_;
+  std::shared_future<void> load_;
+  std::atomic<bool> loaded_;
+  // Declared last so that their threads stop before anything they use is
+  // destroyed
+  std::unique_ptr<artifact_watcher> watcher_;
+  std::unique_ptr<request_accumulator> accumulator_;
+  std::unique_ptr<performance_exporter> performance_exporter_;
 };
 
 }  // namespace rapids
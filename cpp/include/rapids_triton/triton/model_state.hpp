@@ -16,27 +16,120 @@
 
 #pragma once
 #include <triton/backend/backend_model.h>
+#include <exception>
+#include <future>
 #include <memory>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/triton/logging.hpp>
 #include <rapids_triton/triton/model.hpp>
+#include <utility>
 
 namespace triton {
 namespace backend {
 namespace rapids {
+namespace detail {
+/**
+ * @brief Run a loading task on a new thread
+ *
+ * Exceptions other than TritonException are converted to TritonException so
+ * that they can be reported to Triton when the result is retrieved.
+ */
+template <typename F>
+auto launch_load(F&& task)
+{
+  return std::async(std::launch::async,
+                    [task = std::forward<F>(task)]() mutable {
+                      try {
+                        task();
+                      } catch (TritonException const& err) {
+                        throw;
+                      } catch (std::exception const& err) {
+                        throw TritonException(Error::Internal, err.what());
+                      }
+                    })
+    .share();
+}
+
+/**
+ * @brief Wait for a load started with launch_load, rethrowing any error
+ *
+ * Every waiter receives its own copy of the error, since each may be
+ * returned to Triton, which takes ownership of it.
+ */
+inline void wait_for_load(std::shared_future<void> const& load)
+{
+  if (load.valid()) {
+    try {
+      load.get();
+    } catch (TritonException const& err) {
+      throw TritonException(TRITONSERVER_ErrorCode(err.error()), err.what());
+    }
+  }
+}
+}  // namespace detail
+
 template <typename RapidsSharedState>
 struct TritonModelState : public BackendModel {
   TritonModelState(TRITONBACKEND_Model& triton_model)
     : BackendModel(&triton_model),
-      state_{std::make_shared<RapidsSharedState>(get_model_config(triton_model))}
+      state_{std::make_shared<RapidsSharedState>(get_model_config(triton_model))},
+      async_load_{state_->template get_config_param<bool>("async_load", false)},
+      shared_load_{}
   {
   }
 
-  void load() { state_->load(); }
-  void unload() { state_->unload(); }
+  /**
+   * @brief Load the shared state
+   *
+   * If the `async_load` configuration parameter is true, the shared state is
+   * loaded on a background thread, and this method returns immediately.
+   * Instances should wait on `get_shared_load` before using it.
+   */
+  void load()
+  {
+    if (async_load_) {
+      shared_load_ = detail::launch_load([state = state_]() { traced_load(*state); });
+    } else {
+      traced_load(*state_);
+    }
+  }
+  void unload()
+  {
+    if (shared_load_.valid()) {
+      try {
+        shared_load_.get();
+      } catch (TritonException const& err) {
+        // A failed load leaves nothing to unload
+        return;
+      }
+    }
+    state_->unload();
+    if (auto const& trace = state_->get_allocation_trace(); trace) {
+      log_info(__FILE__, __LINE__) << trace->report();
+    }
+  }
 
   auto get_shared_state() { return state_; }
 
+  /** Whether instances of this model should be loaded asynchronously */
+  auto async_load() const { return async_load_; }
+
+  /** Return the pending load of the shared state, which is not valid if the
+   * shared state was loaded synchronously */
+  auto const& get_shared_load() const { return shared_load_; }
+
  private:
   std::shared_ptr<RapidsSharedState> state_;
+  bool async_load_;
+  std::shared_future<void> shared_load_;
+
+  static void traced_load(RapidsSharedState& state)
+  {
+    auto trace_scope = scoped_allocation_trace{state.get_allocation_trace()};
+    auto site        = scoped_allocation_site{allocation_site::model_load};
+    state.load();
+  }
 };
 
 }  // namespace rapids
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <triton/core/tritonserver.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <rapids_triton/batch/batch_activity.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/** The activity of an instance's batches over one snapshot interval */
+struct performance_snapshot {
+  // Batches are counted by rows in buckets of powers of two: bucket 0 holds
+  // batches of no rows (i.e. of non-batched models), bucket i > 0 those of
+  // [2^(i-1), 2^i) rows and the last bucket everything larger
+  static auto constexpr row_buckets = std::size_t{18};
+
+  std::size_t batches{};
+  std::size_t requests{};
+  std::size_t rows{};
+  std::size_t max_requests_per_batch{};
+  std::array<std::size_t, row_buckets> batches_by_rows{};
+  batch_activity::bytes_by_location input_bytes{};
+  batch_activity::bytes_by_location output_bytes{};
+  std::size_t synchronizations{};
+  std::size_t scratch_hits{};
+  std::size_t scratch_misses{};
+
+  static std::size_t row_bucket(std::size_t rows)
+  {
+    auto bucket = std::size_t{};
+    for (; rows != 0 && bucket + 1 < row_buckets; rows >>= 1) {
+      ++bucket;
+    }
+    return bucket;
+  }
+
+  /** The smallest number of rows counted in the given bucket */
+  static std::size_t row_bucket_floor(std::size_t bucket)
+  {
+    return (bucket == 0) ? std::size_t{} : (std::size_t{1} << (bucket - 1));
+  }
+
+  /**
+   * @brief Format this snapshot as a single line of JSON
+   *
+   * @param instance The name of the instance whose activity it records
+   * @param interval The time over which the activity was recorded
+   */
+  std::string to_json(std::string const& instance, std::chrono::duration<double> interval) const
+  {
+    auto out = std::ostringstream{};
+    out << "{\"instance\":\"";
+    for (auto c : instance) {
+      if (c == '"' || c == '\\') { out << '\\'; }
+      out << c;
+    }
+    out << "\",\"interval_s\":" << interval.count() << ",\"batches\":" << batches
+        << ",\"requests\":" << requests << ",\"rows\":" << rows
+        << ",\"max_requests_per_batch\":" << max_requests_per_batch << ",\"batches_by_rows\":{";
+    auto first = true;
+    for (auto i = std::size_t{}; i < row_buckets; ++i) {
+      if (batches_by_rows[i] == 0) { continue; }
+      out << (first ? "" : ",") << '"' << row_bucket_floor(i) << "\":" << batches_by_rows[i];
+      first = false;
+    }
+    out << "},\"input_bytes\":" << locations(input_bytes)
+        << ",\"output_bytes\":" << locations(output_bytes)
+        << ",\"synchronizations\":" << synchronizations << ",\"scratch_hits\":" << scratch_hits
+        << ",\"scratch_misses\":" << scratch_misses << "}";
+    return out.str();
+  }
+
+ private:
+  static std::string locations(batch_activity::bytes_by_location const& bytes)
+  {
+    return "{\"host\":" + std::to_string(bytes[0]) + ",\"pinned\":" + std::to_string(bytes[1]) +
+           ",\"device\":" + std::to_string(bytes[2]) + "}";
+  }
+};
+
+/**
+ * @brief Counters of the activity of an instance's batches since the last
+ * snapshot was taken
+ *
+ * Batches are observed from the executing thread or the pipeline's
+ * completion thread while snapshots are taken by an exporter's thread. Each
+ * counter is independent, so all are updated with relaxed atomics; a
+ * snapshot taken while a batch is being observed may attribute parts of
+ * that batch to consecutive snapshots.
+ */
+struct performance_counters {
+  using counter = std::atomic<std::size_t>;
+
+  /** Add one completed batch of the given requests and rows */
+  void observe(batch_activity const& activity, std::size_t requests, std::size_t rows) noexcept
+  {
+    batches_.fetch_add(1, std::memory_order_relaxed);
+    requests_.fetch_add(requests, std::memory_order_relaxed);
+    rows_.fetch_add(rows, std::memory_order_relaxed);
+    auto max_requests = max_requests_per_batch_.load(std::memory_order_relaxed);
+    while (max_requests < requests &&
+           !max_requests_per_batch_.compare_exchange_weak(
+             max_requests, requests, std::memory_order_relaxed)) {}
+    auto bucket = performance_snapshot::row_bucket(rows);
+    batches_by_rows_[bucket].fetch_add(1, std::memory_order_relaxed);
+    for (auto i = std::size_t{}; i < input_bytes_.size(); ++i) {
+      input_bytes_[i].fetch_add(activity.input_bytes[i], std::memory_order_relaxed);
+      output_bytes_[i].fetch_add(activity.output_bytes[i], std::memory_order_relaxed);
+    }
+    synchronizations_.fetch_add(activity.synchronizations, std::memory_order_relaxed);
+    scratch_hits_.fetch_add(activity.scratch_hits, std::memory_order_relaxed);
+    scratch_misses_.fetch_add(activity.scratch_misses, std::memory_order_relaxed);
+  }
+
+  /** Return the activity observed since the last call and reset every
+   * counter */
+  performance_snapshot take() noexcept
+  {
+    auto result                   = performance_snapshot{};
+    result.batches                = exchange(batches_);
+    result.requests               = exchange(requests_);
+    result.rows                   = exchange(rows_);
+    result.max_requests_per_batch = exchange(max_requests_per_batch_);
+    for (auto i = std::size_t{}; i < batches_by_rows_.size(); ++i) {
+      result.batches_by_rows[i] = exchange(batches_by_rows_[i]);
+    }
+    for (auto i = std::size_t{}; i < input_bytes_.size(); ++i) {
+      result.input_bytes[i]  = exchange(input_bytes_[i]);
+      result.output_bytes[i] = exchange(output_bytes_[i]);
+    }
+    result.synchronizations = exchange(synchronizations_);
+    result.scratch_hits     = exchange(scratch_hits_);
+    result.scratch_misses   = exchange(scratch_misses_);
+    return result;
+  }
+
+ private:
+  counter batches_{};
+  counter requests_{};
+  counter rows_{};
+  counter max_requests_per_batch_{};
+  std::array<counter, performance_snapshot::row_buckets> batches_by_rows_{};
+  std::array<counter, 3> input_bytes_{};
+  std::array<counter, 3> output_bytes_{};
+  counter synchronizations_{};
+  counter scratch_hits_{};
+  counter scratch_misses_{};
+
+  static std::size_t exchange(counter& value) noexcept
+  {
+    return value.exchange(std::size_t{}, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Export a snapshot of an instance's performance_counters at a fixed
+ * interval from a background thread
+ *
+ * Each snapshot is one line of JSON covering the interval since the last,
+ * appended to a file if a path is given and otherwise logged at the given
+ * level. Intervals in which no batch completed are skipped, and the
+ * remaining activity is exported when the exporter is destroyed.
+ */
+struct performance_exporter {
+  performance_exporter(std::string instance,
+                       std::chrono::milliseconds interval,
+                       std::string const& path,
+                       TRITONSERVER_LogLevel level,
+                       performance_counters& counters)
+    : instance_{std::move(instance)},
+      interval_{interval},
+      file_{nullptr, &std::fclose},
+      level_{level},
+      counters_{counters},
+      shutdown_{false},
+      lock_{},
+      cv_{},
+      worker_{}
+  {
+    if (!path.empty()) {
+      file_.reset(std::fopen(path.c_str(), "a"));
+      if (!file_) {
+        throw TritonException(
+          Error::Internal,
+          "Could not open performance snapshot file " + path + ": " + std::strerror(errno));
+      }
+    }
+    worker_ = std::thread{[this]() { run(); }};
+  }
+
+  performance_exporter(performance_exporter const& other) = delete;
+  performance_exporter& operator=(performance_exporter const& other) = delete;
+
+  ~performance_exporter()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      shutdown_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+ private:
+  std::string instance_;
+  std::chrono::milliseconds interval_;
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> file_;
+  TRITONSERVER_LogLevel level_;
+  performance_counters& counters_;
+  bool shutdown_;
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::thread worker_;
+
+  void run()
+  {
+    auto start = std::chrono::steady_clock::now();
+    auto lock  = std::unique_lock<std::mutex>{lock_};
+    auto done  = false;
+    while (!done) {
+      done     = cv_.wait_for(lock, interval_, [this]() { return shutdown_; });
+      auto end = std::chrono::steady_clock::now();
+      lock.unlock();
+      export_snapshot(counters_.take(), end - start);
+      lock.lock();
+      start = end;
+    }
+  }
+
+  void export_snapshot(performance_snapshot const& snapshot,
+                       std::chrono::duration<double> interval) noexcept
+  {
+    if (snapshot.batches == 0) { return; }
+    try {
+      auto line = snapshot.to_json(instance_, interval);
+      if (file_) {
+        line += '\n';
+        if (std::fputs(line.c_str(), file_.get()) < 0 || std::fflush(file_.get()) != 0) {
+          log_warn(__FILE__, __LINE__) << "Failed to write performance snapshot for " << instance_;
+        }
+      } else {
+        log(level_, __FILE__, __LINE__, std::move(line));
+      }
+    } catch (std::exception const& err) {
+      log_error(__FILE__, __LINE__)
+        << "Failed to export performance snapshot for " << instance_ << ": " << err.what();
+    }
+  }
+};
+
+/**
+ * @brief Parse the name of a Triton log level ("error", "warn", "info" or
+ * "verbose")
+ */
+inline auto parse_log_level(std::string const& name)
+{
+  if (name == "error") { return TRITONSERVER_LOG_ERROR; }
+  if (name == "warn") { return TRITONSERVER_LOG_WARN; }
+  if (name == "info") { return TRITONSERVER_LOG_INFO; }
+  if (name == "verbose") { return TRITONSERVER_LOG_VERBOSE; }
+  throw TritonException(Error::InvalidArg, "Unknown log level " + name);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -19,6 +19,11 @@
 #include <triton/backend/backend_common.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
 #include <rapids_triton/exceptions.hpp>
 #include <rapids_triton/triton/logging.hpp>
 
@@ -27,6 +32,104 @@ namespace backend {
 namespace rapids {
 using request_size_t = uint32_t;
 
+/**
+ * @brief The sequence batcher's control information for one request
+ *
+ * For models without sequence batching, the correlation ID is 0 and neither
+ * flag is set.
+ */
+struct sequence_control {
+  std::uint64_t correlation_id;
+  bool start;
+  bool end;
+};
+
+inline auto get_sequence_control(TRITONBACKEND_Request* request)
+{
+  auto result = sequence_control{};
+  auto flags  = uint32_t{};
+  triton_check(TRITONBACKEND_RequestCorrelationId(request, &result.correlation_id));
+  triton_check(TRITONBACKEND_RequestFlags(request, &flags));
+  result.start = (flags & TRITONSERVER_REQUEST_FLAG_SEQUENCE_START) != 0;
+  result.end   = (flags & TRITONSERVER_REQUEST_FLAG_SEQUENCE_END) != 0;
+  return result;
+}
+
+/**
+ * @brief Return the timeout set by the client for the given request in
+ * microseconds, or 0 if it has none
+ *
+ * Timeouts are exposed to backends from TRITONBACKEND API version 1.16;
+ * with earlier versions, no request has a timeout.
+ */
+inline std::uint64_t get_request_timeout(TRITONBACKEND_Request* request)
+{
+  auto result = std::uint64_t{};
+#if TRITONBACKEND_API_VERSION_MAJOR > 1 || TRITONBACKEND_API_VERSION_MINOR >= 16
+  triton_check(TRITONBACKEND_RequestTimeoutMicroseconds(request, &result));
+#endif
+  return result;
+}
+
+/**
+ * @brief Return the time by which the given request must complete, or
+ * std::nullopt if it has no timeout
+ *
+ * Triton does not report when a request arrived, so its timeout is counted
+ * from the time at which the backend received it.
+ */
+inline std::optional<std::chrono::steady_clock::time_point> get_request_deadline(
+  TRITONBACKEND_Request* request, std::chrono::steady_clock::time_point received)
+{
+  auto timeout = get_request_timeout(request);
+  if (timeout == 0) { return std::nullopt; }
+  return received + std::chrono::microseconds{timeout};
+}
+
+/**
+ * @brief The memory location in which the client would like to receive the
+ * named output of the given request, or std::nullopt if it is unknown
+ *
+ * Clients which registered CUDA shared memory for an output prefer device
+ * memory. Output buffer properties are exposed to backends from
+ * TRITONBACKEND API version 1.6; with earlier versions, no preference is
+ * known.
+ */
+inline std::optional<TRITONSERVER_MemoryType> get_output_placement(TRITONBACKEND_Request* request,
+                                                                   char const* name)
+{
+  auto result = std::optional<TRITONSERVER_MemoryType>{};
+#if TRITONBACKEND_API_VERSION_MAJOR > 1 || TRITONBACKEND_API_VERSION_MINOR >= 6
+  auto byte_size   = std::size_t{};
+  auto mem_type    = TRITONSERVER_MEMORY_CPU;
+  auto mem_type_id = std::int64_t{};
+  auto* err =
+    TRITONBACKEND_RequestOutputBufferProperties(request, name, &byte_size, &mem_type, &mem_type_id);
+  if (err == nullptr) {
+    result = (mem_type == TRITONSERVER_MEMORY_GPU) ? TRITONSERVER_MEMORY_GPU
+                                                   : TRITONSERVER_MEMORY_CPU;
+  } else {
+    TRITONSERVER_ErrorDelete(err);
+  }
+#endif
+  return result;
+}
+
+/** The names of the outputs the client asked for in the given request */
+inline auto get_requested_outputs(TRITONBACKEND_Request* request)
+{
+  auto output_count = std::uint32_t{};
+  triton_check(TRITONBACKEND_RequestOutputCount(request, &output_count));
+  auto result = std::vector<std::string>{};
+  result.reserve(output_count);
+  for (auto i = std::uint32_t{}; i < output_count; ++i) {
+    auto* name = static_cast<char const*>(nullptr);
+    triton_check(TRITONBACKEND_RequestOutputName(request, i, &name));
+    result.emplace_back(name);
+  }
+  return result;
+}
+
 template <typename Iter>
 void release_requests(Iter begin, Iter end)
 {
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <triton/core/tritonbackend.h>
+#include <algorithm>
+#include <cstddef>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/triton/responses.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief A handle for sending several responses to a single request
+ *
+ * ResponseStreams may only be used by models with Triton's decoupled
+ * transaction policy. Each call to `get_output` adds an output to the
+ * response currently being assembled, and `send` transmits that response to
+ * the client immediately, e.g. as soon as one chunk of a long-running
+ * prediction has finished. The response's outputs are synchronized with
+ * the streams on which they were requested before it is sent.
+ *
+ * A stream is closed by `close` or by the Batch which created it once the
+ * batch is complete. Closing sends Triton's final flag; no further
+ * responses may be sent after that.
+ */
+struct ResponseStream {
+  using size_type = std::size_t;
+
+  explicit ResponseStream(TRITONBACKEND_Request* request)
+    : factory_{nullptr}, pending_{nullptr}, pending_streams_{}, closed_{false}
+  {
+    triton_check(TRITONBACKEND_ResponseFactoryNew(&factory_, request));
+  }
+
+  ResponseStream(ResponseStream const& other) = delete;
+  ResponseStream& operator=(ResponseStream const& other) = delete;
+  ResponseStream(ResponseStream&& other) noexcept
+    : factory_{std::exchange(other.factory_, nullptr)},
+      pending_{std::exchange(other.pending_, nullptr)},
+      pending_streams_{std::move(other.pending_streams_)},
+      closed_{std::exchange(other.closed_, true)}
+  {
+  }
+  ResponseStream& operator=(ResponseStream&& other) = delete;
+
+  ~ResponseStream()
+  {
+    try {
+      close();
+    } catch (TritonException const& err) {
+      log_error(__FILE__, __LINE__, err.what());
+    }
+    if (pending_ != nullptr) { TRITONBACKEND_ResponseDelete(pending_); }
+    if (factory_ != nullptr) { TRITONBACKEND_ResponseFactoryDelete(factory_); }
+  }
+
+  /**
+   * @brief Add an output of the given shape to the next response, returning
+   * a non-owning Buffer over its final location
+   *
+   * Triton may provide the buffer in a different memory location than the
+   * one requested; use rapids::copy to fill it if in doubt.
+   */
+  template <typename T>
+  auto get_output(std::string const& name,
+                  std::vector<size_type> const& shape,
+                  MemoryType memory_type,
+                  device_id_t device_id,
+                  cudaStream_t stream)
+  {
+    if (closed_) { throw TritonException(Error::Internal, "ResponseStream already closed"); }
+    if (pending_ == nullptr) {
+      triton_check(TRITONBACKEND_ResponseNewFromFactory(&pending_, factory_));
+    }
+    if (std::find(std::begin(pending_streams_), std::end(pending_streams_), stream) ==
+        std::end(pending_streams_)) {
+      pending_streams_.push_back(stream);
+    }
+    return get_response_buffer<T>(pending_, name, shape, memory_type, device_id, stream);
+  }
+
+  /**
+   * @brief Send the response assembled so far
+   *
+   * If final is true, the stream is closed along with this response.
+   */
+  void send(bool final = false)
+  {
+    if (closed_) { throw TritonException(Error::Internal, "ResponseStream already closed"); }
+    if (pending_ == nullptr) {
+      if (final) { close(); }
+      return;
+    }
+    if constexpr (IS_GPU_BUILD) {
+      std::for_each(std::begin(pending_streams_), std::end(pending_streams_), [](auto stream) {
+        cuda_check(cudaStreamSynchronize(stream));
+      });
+    }
+    pending_streams_.clear();
+    auto flags = final ? TRITONSERVER_RESPONSE_COMPLETE_FINAL : std::uint32_t{};
+    closed_    = final;
+    triton_check(TRITONBACKEND_ResponseSend(std::exchange(pending_, nullptr), flags, nullptr));
+  }
+
+  /**
+   * @brief Send an error to the client and close the stream, discarding any
+   * response assembled but not yet sent
+   */
+  void send_error(TRITONSERVER_Error* err)
+  {
+    if (closed_) { throw TritonException(Error::Internal, "ResponseStream already closed"); }
+    if (pending_ != nullptr) { TRITONBACKEND_ResponseDelete(std::exchange(pending_, nullptr)); }
+    auto* response = static_cast<TRITONBACKEND_Response*>(nullptr);
+    triton_check(TRITONBACKEND_ResponseNewFromFactory(&response, factory_));
+    closed_ = true;
+    send_response(response, TRITONSERVER_RESPONSE_COMPLETE_FINAL, err);
+  }
+
+  /**
+   * @brief Close the stream, sending any response which has been assembled
+   * but not yet sent
+   */
+  void close()
+  {
+    if (!closed_) {
+      if (pending_ != nullptr) {
+        send(true);
+      } else {
+        closed_ = true;
+        triton_check(
+          TRITONBACKEND_ResponseFactorySendFlags(factory_, TRITONSERVER_RESPONSE_COMPLETE_FINAL));
+      }
+    }
+  }
+
+  auto closed() const noexcept { return closed_; }
+
+ private:
+  TRITONBACKEND_ResponseFactory* factory_;
+  TRITONBACKEND_Response* pending_;
+  std::vector<cudaStream_t> pending_streams_;
+  bool closed_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
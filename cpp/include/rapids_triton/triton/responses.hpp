@@ -17,25 +17,41 @@
 #pragma once
 #include <triton/core/tritonbackend.h>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <numeric>
+#include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/triton/device.hpp>
 #include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/narrow.hpp>
+#include <string>
 #include <vector>
 
 namespace triton {
 namespace backend {
 namespace rapids {
 
+/**
+ * @brief Construct a response for each request, replacing the contents of
+ * the given vector so that its storage may be reused between batches
+ */
 template <typename Iter>
-auto construct_responses(Iter requests_begin, Iter requests_end)
+void construct_responses(Iter requests_begin,
+                         Iter requests_end,
+                         std::vector<TRITONBACKEND_Response*>& responses)
 {
-  auto responses = std::vector<TRITONBACKEND_Response*>{};
-
   auto requests_size = std::distance(requests_begin, requests_end);
   if (!(requests_size > 0)) {
     throw TritonException(Error::Internal,
                           "Invalid iterators for requests when constructing responses");
   }
+  responses.clear();
   responses.reserve(requests_size);
 
   std::transform(requests_begin, requests_end, std::back_inserter(responses), [](auto* request) {
@@ -43,31 +59,169 @@ auto construct_responses(Iter requests_begin, Iter requests_end)
     triton_check(TRITONBACKEND_ResponseNew(&response, request));
     return response;
   });
-  return responses;
 }
 
 template <typename Iter>
-void send_responses(Iter begin, Iter end, TRITONSERVER_Error* err)
+auto construct_responses(Iter requests_begin, Iter requests_end)
+{
+  auto responses = std::vector<TRITONBACKEND_Response*>{};
+  construct_responses(requests_begin, requests_end, responses);
+  return responses;
+}
+
+/**
+ * @brief Add the named output to a response, returning its final buffer as a
+ * non-owning Buffer of bytes
+ *
+ * Triton may provide the buffer in a different memory location than the one
+ * requested.
+ */
+inline auto get_response_buffer(TRITONBACKEND_Response* response,
+                                std::string const& name,
+                                DType dtype,
+                                std::vector<std::size_t> const& shape,
+                                MemoryType memory_type,
+                                device_id_t device_id,
+                                cudaStream_t stream)
+{
+  if (response == nullptr) {
+    throw TritonException(Error::Internal, "Response construction failed");
+  }
+  auto triton_shape = std::vector<int64_t>{};
+  triton_shape.reserve(shape.size());
+  std::transform(
+    std::begin(shape), std::end(shape), std::back_inserter(triton_shape), [](auto& val) {
+      return narrow<int64_t>(val);
+    });
+  auto size = std::reduce(shape.begin(), shape.end(), std::size_t{1}, std::multiplies<>()) *
+              TRITONSERVER_DataTypeByteSize(dtype);
+
+  auto* output = static_cast<TRITONBACKEND_Output*>(nullptr);
+  triton_check(TRITONBACKEND_ResponseOutput(response,
+                                            &output,
+                                            name.c_str(),
+                                            dtype,
+                                            triton_shape.data(),
+                                            narrow<uint32_t>(triton_shape.size())));
+  auto* raw_buffer        = static_cast<void*>(nullptr);
+  auto reported_mem_type  = memory_type;
+  auto reported_device_id = int64_t{device_id};
+  triton_check(
+    TRITONBACKEND_OutputBuffer(output, &raw_buffer, size, &reported_mem_type, &reported_device_id));
+  if (!IS_GPU_BUILD && reported_mem_type == DeviceMemory) {
+    throw TritonException(Error::Internal, "Device output buffer provided in non-GPU build");
+  }
+  return Buffer<std::byte>(static_cast<std::byte*>(raw_buffer),
+                           size,
+                           reported_mem_type,
+                           narrow<device_id_t>(reported_device_id),
+                           stream);
+}
+
+/**
+ * @brief Add the named output to a response, returning its final buffer as a
+ * non-owning Buffer
+ *
+ * Triton may provide the buffer in a different memory location than the one
+ * requested.
+ */
+template <typename T>
+auto get_response_buffer(TRITONBACKEND_Response* response,
+                         std::string const& name,
+                         std::vector<std::size_t> const& shape,
+                         MemoryType memory_type,
+                         device_id_t device_id,
+                         cudaStream_t stream)
 {
-  std::for_each(begin, end, [err](auto& response) {
-    decltype(err) err_copy;
-    if (err != nullptr) {
-      err_copy = TRITONSERVER_ErrorNew(TRITONSERVER_ErrorCode(err), TRITONSERVER_ErrorMessage(err));
-    } else {
-      err_copy = err;
+  auto buffer = get_response_buffer(
+    response, name, TritonDtype<T>::value, shape, memory_type, device_id, stream);
+  return Buffer<T>(reinterpret_cast<T*>(buffer.data()),
+                   buffer.size() / sizeof(T),
+                   buffer.mem_type(),
+                   buffer.device(),
+                   stream);
+}
+
+/**
+ * @brief Send a single response with the given flags, logging rather than
+ * throwing on failure
+ *
+ * Triton copies the code and message of the error when the response is sent
+ * and does not take ownership of it, so the same error may be sent with any
+ * number of responses.
+ */
+inline void send_response(TRITONBACKEND_Response* response,
+                          std::uint32_t flags,
+                          TRITONSERVER_Error* err)
+{
+  if (response == nullptr) {
+    log_error(__FILE__, __LINE__) << "Failure in response collation";
+  } else {
+    try {
+      triton_check(TRITONBACKEND_ResponseSend(response, flags, err));
+    } catch (TritonException& err) {
+      log_error(__FILE__, __LINE__, err.what());
     }
+  }
+}
 
-    if (response == nullptr) {
-      log_error(__FILE__, __LINE__) << "Failure in response collation";
-    } else {
-      try {
-        triton_check(
-          TRITONBACKEND_ResponseSend(response, TRITONSERVER_RESPONSE_COMPLETE_FINAL, err_copy));
-      } catch (TritonException& err) {
-        log_error(__FILE__, __LINE__, err.what());
-      }
+namespace detail {
+/* Send a final response for each of the given responses with the error
+ * returned for its index, logging one line for all responses which could not
+ * be sent rather than one per response */
+template <typename Iter, typename ErrorLookup>
+void send_final_responses(Iter begin, Iter end, ErrorLookup error_for)
+{
+  auto total    = std::size_t{};
+  auto failures = std::size_t{};
+  auto reason   = std::string{};
+  for (auto iter = begin; iter != end; ++iter, ++total) {
+    auto* response = *iter;
+    auto* send_err = static_cast<TRITONSERVER_Error*>(nullptr);
+    if (response != nullptr) {
+      send_err = TRITONBACKEND_ResponseSend(
+        response, TRITONSERVER_RESPONSE_COMPLETE_FINAL, error_for(total));
+      if (send_err == nullptr) { continue; }
     }
-  });
+    if (failures == 0) {
+      reason = (send_err == nullptr) ? "Failure in response collation"
+                                     : TRITONSERVER_ErrorMessage(send_err);
+    }
+    if (send_err != nullptr) { TRITONSERVER_ErrorDelete(send_err); }
+    ++failures;
+  }
+  if (failures != 0) {
+    log_error(__FILE__, __LINE__) << "Failed to send " << failures << " of " << total
+                                  << " responses: " << reason;
+  }
+}
+}  // namespace detail
+
+/**
+ * @brief Send a final response for each of the given responses, all with
+ * the same error (or none)
+ */
+template <typename Iter>
+void send_responses(Iter begin, Iter end, TRITONSERVER_Error* err)
+{
+  detail::send_final_responses(begin, end, [err](std::size_t) { return err; });
+}
+
+/**
+ * @brief Send a final response for each of the given responses with the
+ * error at the corresponding index of errors
+ *
+ * A null error indicates that the corresponding request succeeded, so only
+ * the requests with errors fail.
+ */
+template <typename Iter>
+void send_responses(Iter begin, Iter end, std::vector<TRITONSERVER_Error*> const& errors)
+{
+  if (errors.size() != static_cast<std::size_t>(std::distance(begin, end))) {
+    throw TritonException(Error::Internal, "one error entry is required for each response");
+  }
+  detail::send_final_responses(
+    begin, end, [&errors](std::size_t index) { return errors[index]; });
 }
 
 }  // namespace rapids
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <triton/core/tritonbackend.h>
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#include <rapids_triton/memory/detail/gpu_only/copy.hpp>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#include <rapids_triton/memory/detail/cpu_only/copy.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/traffic_file.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Records the requests given to a model to a traffic capture file
+ * (see utils/traffic_file.hpp) for later replay
+ *
+ * Each call to `record` encodes the shapes of every input of the given
+ * requests, together with their data for the sampled fraction of batches,
+ * and hands the record to a background thread which appends it to the file.
+ * Executing threads therefore never wait on the filesystem; if more than
+ * `max_pending_bytes` of records are waiting to be written, further records
+ * are dropped and the number dropped is logged. The file is replaced when
+ * the capture is created, and records still waiting when it is destroyed
+ * are written first.
+ */
+struct traffic_capture {
+  traffic_capture(std::string const& path, double data_rate, std::size_t max_pending_bytes)
+    : path_{path},
+      file_{std::fopen(path.c_str(), "wb"), &std::fclose},
+      data_rate_{std::clamp(data_rate, 0.0, 1.0)},
+      max_pending_bytes_{max_pending_bytes},
+      start_{std::chrono::steady_clock::now()},
+      batches_{},
+      dropped_{},
+      failed_{false},
+      pending_{},
+      pending_bytes_{},
+      shutdown_{false},
+      lock_{},
+      wake_{},
+      worker_{}
+  {
+    if (!file_) {
+      throw TritonException(Error::Internal,
+                            "Could not open traffic capture " + path + ": " + std::strerror(errno));
+    }
+    pending_.push_back(encode_traffic_header(std::chrono::system_clock::now()));
+    pending_bytes_ = pending_.back().size();
+    worker_        = std::thread{[this]() { run(); }};
+  }
+
+  traffic_capture(traffic_capture const& other) = delete;
+  traffic_capture& operator=(traffic_capture const& other) = delete;
+
+  ~traffic_capture()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      shutdown_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+  }
+
+  auto const& path() const noexcept { return path_; }
+  /** Number of batches not captured because too many records were waiting
+   * to be written */
+  auto dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Capture one batch of requests
+   *
+   * Failures to read the requests are logged rather than thrown, so that
+   * capture never affects how the batch itself is processed.
+   */
+  void record(TRITONBACKEND_Request* const* requests, std::size_t request_count) noexcept
+  {
+    if (failed_.load(std::memory_order_relaxed)) { return; }
+    auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start_);
+    // Data are kept for batches spread evenly at the configured rate
+    auto index     = batches_.fetch_add(1, std::memory_order_relaxed);
+    auto with_data = static_cast<std::uint64_t>((index + 1) * data_rate_) >
+                     static_cast<std::uint64_t>(index * data_rate_);
+    try {
+      auto record = traffic_record{offset, request_count};
+      for (auto i = std::size_t{}; i < request_count; ++i) {
+        add_request(record, requests[i], with_data);
+      }
+      enqueue(std::move(record).release());
+    } catch (TritonException const& err) {
+      log_warn(__FILE__, __LINE__) << "Could not capture batch: " << err.what();
+    } catch (std::bad_alloc const&) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::string path_;
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> file_;
+  double data_rate_;
+  std::size_t max_pending_bytes_;
+  std::chrono::steady_clock::time_point start_;
+  std::atomic<std::uint64_t> batches_;
+  std::atomic<std::size_t> dropped_;
+  std::atomic<bool> failed_;
+  std::deque<std::vector<std::byte>> pending_;
+  std::size_t pending_bytes_;
+  bool shutdown_;
+  std::mutex lock_;
+  std::condition_variable wake_;
+  std::thread worker_;
+
+  static void add_request(traffic_record& record, TRITONBACKEND_Request* request, bool with_data)
+  {
+    auto input_count = std::uint32_t{};
+    triton_check(TRITONBACKEND_RequestInputCount(request, &input_count));
+    record.add_request(input_count);
+    for (auto i = std::uint32_t{}; i < input_count; ++i) {
+      auto* input       = static_cast<TRITONBACKEND_Input*>(nullptr);
+      auto* name        = static_cast<char const*>(nullptr);
+      auto dtype        = DType{};
+      auto* shape       = static_cast<int64_t const*>(nullptr);
+      auto dims         = std::uint32_t{};
+      auto byte_size    = std::uint64_t{};
+      auto buffer_count = std::uint32_t{};
+      triton_check(TRITONBACKEND_RequestInputByIndex(request, i, &input));
+      triton_check(TRITONBACKEND_InputProperties(
+        input, &name, &dtype, &shape, &dims, &byte_size, &buffer_count));
+      auto* dst = record.add_input(name, dtype, shape, dims, byte_size, with_data);
+      for (auto j = std::uint32_t{}; dst != nullptr && j < buffer_count; ++j) {
+        auto* data     = static_cast<void const*>(nullptr);
+        auto size      = std::uint64_t{};
+        auto mem_type  = TRITONSERVER_MEMORY_CPU;
+        auto device_id = int64_t{};
+        triton_check(TRITONBACKEND_InputBuffer(input, j, &data, &size, &mem_type, &device_id));
+        size = std::min(size, byte_size);
+        detail::copy(dst,
+                     static_cast<std::byte const*>(data),
+                     size,
+                     cudaStream_t{},
+                     HostMemory,
+                     mem_type);
+        if (mem_type == DeviceMemory) { cuda_check(cudaStreamSynchronize(cudaStream_t{})); }
+        dst += size;
+        byte_size -= size;
+      }
+    }
+  }
+
+  void enqueue(std::vector<std::byte>&& bytes)
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      if (pending_bytes_ + bytes.size() > max_pending_bytes_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      pending_bytes_ += bytes.size();
+      pending_.push_back(std::move(bytes));
+    }
+    wake_.notify_one();
+  }
+
+  void run()
+  {
+    auto reported_drops = std::size_t{};
+    auto lock           = std::unique_lock<std::mutex>{lock_};
+    while (true) {
+      wake_.wait(lock, [this]() { return shutdown_ || !pending_.empty(); });
+      if (pending_.empty()) { break; }
+      auto records = std::move(pending_);
+      pending_.clear();
+      lock.unlock();
+      auto written = std::size_t{};
+      for (auto const& bytes : records) {
+        if (!failed_.load(std::memory_order_relaxed) &&
+            std::fwrite(bytes.data(), 1, bytes.size(), file_.get()) != bytes.size()) {
+          log_error(__FILE__, __LINE__) << "Traffic capture to " << path_
+                                        << " stopped: " << std::strerror(errno);
+          failed_.store(true, std::memory_order_relaxed);
+        }
+        written += bytes.size();
+      }
+      std::fflush(file_.get());
+      auto drops = dropped();
+      if (drops != reported_drops) {
+        log_warn(__FILE__, __LINE__) << drops - reported_drops
+                                     << " batches not captured because the traffic capture to "
+                                     << path_ << " fell behind";
+        reported_drops = drops;
+      }
+      lock.lock();
+      pending_bytes_ -= written;
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
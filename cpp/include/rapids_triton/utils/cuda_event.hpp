@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <chrono>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief An owning handle to a CUDA event used to order work between streams
+ * or between a stream and the host
+ *
+ * Events are created with timing disabled unless timing is requested, since
+ * most are used solely for synchronization.
+ */
+struct cuda_event {
+  cuda_event() : cuda_event{false} {}
+
+  /** Create an event which may be used to measure elapsed device time if
+   * timing is true */
+  explicit cuda_event(bool timing) : event_{}
+  {
+    if constexpr (IS_GPU_BUILD) {
+      cuda_check(cudaEventCreateWithFlags(&event_, timing ? 0u : cudaEventDisableTiming));
+    } else {
+      throw TritonException(Error::Internal, "CUDA event used in non-GPU build");
+    }
+  }
+
+  cuda_event(cuda_event const& other) = delete;
+  cuda_event& operator=(cuda_event const& other) = delete;
+
+  cuda_event(cuda_event&& other) noexcept : event_{std::exchange(other.event_, cudaEvent_t{})} {}
+  cuda_event& operator=(cuda_event&& other) noexcept
+  {
+    std::swap(event_, other.event_);
+    return *this;
+  }
+
+  ~cuda_event()
+  {
+    if (event_ != cudaEvent_t{}) { cudaEventDestroy(event_); }
+  }
+
+  /** Capture all work currently enqueued on the given stream */
+  void record(cudaStream_t stream) { cuda_check(cudaEventRecord(event_, stream)); }
+
+  /** Make all future work on the given stream wait for the captured work */
+  void wait(cudaStream_t stream) const { cuda_check(cudaStreamWaitEvent(stream, event_, 0)); }
+
+  /** Block the host until the captured work is complete */
+  void synchronize() const { cuda_check(cudaEventSynchronize(event_)); }
+
+  /** Return true if the captured work is complete */
+  auto query() const { return cudaEventQuery(event_) == cudaSuccess; }
+
+  /**
+   * @brief Return the device time elapsed between the given event and this
+   * one
+   *
+   * Both events must have been created with timing enabled and recorded,
+   * and this event's captured work must be complete.
+   */
+  auto elapsed_since(cuda_event const& start) const
+  {
+    auto millis = float{};
+    cuda_check(cudaEventElapsedTime(&millis, start.event_, event_));
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<float, std::milli>{millis});
+  }
+
+  auto get() const noexcept { return event_; }
+
+ private:
+  cudaEvent_t event_;
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
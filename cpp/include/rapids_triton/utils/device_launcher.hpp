@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <atomic>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+
+/*
+ * Kernels can only be compiled by a CUDA compiler, but the functions which
+ * launch them are also called from translation units compiled without one,
+ * and every translation unit must see the same definition of them. They
+ * therefore reach kernels only through launchers registered at runtime,
+ * each identified by a tag naming its kernel and by its function type. The
+ * `.cuh` header defining a kernel provides functions which register its
+ * launcher for given element types, and which must be called from a
+ * translation unit compiled with a CUDA compiler.
+ */
+template <typename Tag, typename Launcher>
+inline std::atomic<Launcher*> device_launcher{nullptr};
+
+/** Return the registered launcher, or nullptr if none has been registered */
+template <typename Tag, typename Launcher>
+auto* get_device_launcher()
+{
+  return device_launcher<Tag, Launcher>.load(std::memory_order_acquire);
+}
+
+template <typename Tag, typename Launcher>
+void set_device_launcher(Launcher* launcher)
+{
+  device_launcher<Tag, Launcher>.store(launcher, std::memory_order_release);
+}
+
+}  // namespace detail
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -25,12 +25,19 @@ namespace triton {
 namespace backend {
 namespace rapids {
 
-/** Struct for setting cuda device within a code block */
+/** Struct for setting cuda device within a code block
+ *
+ * If the requested device is already current, no device is set on entry or
+ * exit, so that only a single runtime call is made.
+ */
 struct device_setter {
-  device_setter(device_id_t device) : prev_device_{} {
+  device_setter(device_id_t device) : prev_device_{}, changed_{false} {
     if constexpr(IS_GPU_BUILD) {
       cuda_check(cudaGetDevice(&prev_device_));
-      cuda_check(cudaSetDevice(device));
+      if (prev_device_ != device) {
+        cuda_check(cudaSetDevice(device));
+        changed_ = true;
+      }
     } else {
       throw TritonException(Error::Internal, "Device setter used in non-GPU build");
     }
@@ -38,11 +45,12 @@ struct device_setter {
 
   ~device_setter() {
     if constexpr(IS_GPU_BUILD) {
-      cudaSetDevice(prev_device_);
+      if (changed_) { cudaSetDevice(prev_device_); }
     }
   }
  private:
   device_id_t prev_device_;
+  bool changed_;
 };
 
 }  // namespace rapids
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+template <typename Signature>
+struct function_ref;
+
+/**
+ * @brief A non-owning reference to a callable object
+ *
+ * Unlike std::function, a function_ref never allocates and can be
+ * constructed from any callable object with a compatible signature. The
+ * referenced callable must outlive the function_ref and any copies of it.
+ */
+template <typename R, typename... Args>
+struct function_ref<R(Args...)> {
+  template <typename F,
+            typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, function_ref> &&
+                                        std::is_object_v<std::remove_reference_t<F>> &&
+                                        std::is_invocable_r_v<R, F&, Args...>>>
+  function_ref(F&& callable) noexcept
+    : callable_{const_cast<void*>(static_cast<void const*>(std::addressof(callable)))},
+      invoke_{[](void* callable, Args... args) -> R {
+        return (*static_cast<std::add_pointer_t<F>>(callable))(std::forward<Args>(args)...);
+      }}
+  {
+  }
+
+  R operator()(Args... args) const { return invoke_(callable_, std::forward<Args>(args)...); }
+
+ private:
+  void* callable_;
+  R (*invoke_)(void*, Args...);
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <optional>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <string>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+/* The NUMA node to which the calling thread has been bound, or -1 */
+inline auto& current_numa_node()
+{
+  thread_local auto node = -1;
+  return node;
+}
+
+inline auto read_first_line(std::string const& path)
+{
+  auto result = std::optional<std::string>{};
+  auto input  = std::ifstream{path};
+  auto line   = std::string{};
+  if (input && std::getline(input, line)) { result = line; }
+  return result;
+}
+
+/* Prefer the given node for all future page allocations by the calling
+ * thread, as by set_mempolicy(MPOL_PREFERRED) */
+inline auto prefer_numa_node(int node)
+{
+  auto result = false;
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+  auto constexpr mpol_preferred = 1;
+  auto constexpr bits_per_word  = sizeof(unsigned long) * 8;
+  auto mask = std::vector<unsigned long>(node / bits_per_word + 1, 0UL);
+  mask[node / bits_per_word] |= 1UL << (node % bits_per_word);
+  result =
+    syscall(SYS_set_mempolicy, mpol_preferred, mask.data(), mask.size() * bits_per_word + 1) == 0;
+#endif
+  return result;
+}
+}  // namespace detail
+
+/**
+ * @brief Return the NUMA node nearest to the given device, or std::nullopt if
+ * it cannot be determined (e.g. on single-node hosts or in non-GPU builds)
+ */
+inline auto get_device_numa_node(device_id_t device)
+{
+  auto result = std::optional<int>{};
+#ifdef TRITON_ENABLE_GPU
+  char bus_id[32] = {};
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != cudaSuccess) {
+    cudaGetLastError();
+    return result;
+  }
+  auto path = std::string{bus_id};
+  std::transform(std::begin(path), std::end(path), std::begin(path), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  auto node_text = detail::read_first_line("/sys/bus/pci/devices/" + path + "/numa_node");
+  if (node_text) {
+    try {
+      auto node = std::stoi(*node_text);
+      if (node >= 0) { result = node; }
+    } catch (std::exception const&) {
+    }
+  }
+#endif
+  return result;
+}
+
+/** The CPUs belonging to the given NUMA node, or an empty vector if they
+ * cannot be determined */
+inline auto get_numa_node_cpus(int node)
+{
+  auto result = std::vector<int>{};
+  auto cpus   = detail::read_first_line("/sys/devices/system/node/node" + std::to_string(node) +
+                                      "/cpulist");
+  if (cpus && !cpus->empty()) {
+    try {
+      result = detail::parse_cpu_list(*cpus);
+    } catch (TritonException const&) {
+      result.clear();
+    }
+  }
+  return result;
+}
+
+/** The NUMA node to which the calling thread was bound with
+ * bind_thread_to_numa_node, or -1 if it has not been bound */
+inline auto get_thread_numa_node() { return detail::current_numa_node(); }
+
+/**
+ * @brief Bind the calling thread to the CPUs of a NUMA node and prefer that
+ * node for its memory allocations
+ *
+ * Host memory first touched by the thread afterwards, including pinned
+ * memory allocated through CUDA, is placed on that node where possible.
+ * Binding a thread which is already bound to the node does nothing, and a
+ * failure to bind is only reported once for each thread.
+ *
+ * @return true if the thread was bound to the node
+ */
+inline auto bind_thread_to_numa_node(int node)
+{
+  thread_local auto failed_node = -1;
+  if (detail::current_numa_node() == node) { return true; }
+  if (failed_node == node) { return false; }
+  auto result = false;
+#ifdef __linux__
+  auto cpus = get_numa_node_cpus(node);
+  if (!cpus.empty()) {
+    auto cpu_set = cpu_set_t{};
+    CPU_ZERO(&cpu_set);
+    for (auto cpu : cpus) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+  }
+  if (result && !detail::prefer_numa_node(node)) {
+    log_warn(__FILE__, __LINE__) << "Could not prefer NUMA node " << node
+                                 << " for host allocations";
+  }
+#endif
+  if (result) {
+    detail::current_numa_node() = node;
+  } else {
+    failed_node = node;
+    log_warn(__FILE__, __LINE__) << "Could not bind thread to NUMA node " << node;
+  }
+  return result;
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+#include <nvtx3/nvToolsExt.h>
+#endif
+#include <rapids_triton/build_control.hpp>
+#include <sstream>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+namespace detail {
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+inline auto& nvtx_domain()
+{
+  static auto domain = nvtxDomainHandle_t{};
+  return domain;
+}
+#endif
+}  // namespace detail
+
+/**
+ * @brief Set the name of the NVTX domain in which rapids_triton ranges are
+ * reported
+ *
+ * This is called with the name of the backend when the backend is
+ * initialized. It has no effect unless rapids_triton is built with NVTX
+ * enabled.
+ */
+inline void set_nvtx_domain(std::string const& name)
+{
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+  if (detail::nvtx_domain() == nullptr) { detail::nvtx_domain() = nvtxDomainCreateA(name.c_str()); }
+#endif
+}
+
+/**
+ * @brief An NVTX range which lasts for the lifetime of this object
+ *
+ * The range name is formed by concatenating all constructor arguments. When
+ * rapids_triton is built without NVTX, constructing a range does nothing,
+ * and its arguments are not formatted.
+ */
+struct nvtx_range {
+  template <typename... Args>
+  explicit nvtx_range(Args const&... name_parts)
+  {
+    if constexpr (IS_NVTX_BUILD) {
+      auto name = std::ostringstream{};
+      (name << ... << name_parts);
+      push(name.str());
+    }
+  }
+
+  nvtx_range(nvtx_range const& other) = delete;
+  nvtx_range& operator=(nvtx_range const& other) = delete;
+
+  ~nvtx_range()
+  {
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+    nvtxDomainRangePop(detail::nvtx_domain());
+#endif
+  }
+
+ private:
+  void push(std::string const& name)
+  {
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+    auto attributes          = nvtxEventAttributes_t{};
+    attributes.version       = NVTX_VERSION;
+    attributes.size          = NVTX_EVENT_ATTRIB_STRUCT_SIZE;
+    attributes.messageType   = NVTX_MESSAGE_TYPE_ASCII;
+    attributes.message.ascii = name.c_str();
+    nvtxDomainRangePushEx(detail::nvtx_domain(), &attributes);
+#endif
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
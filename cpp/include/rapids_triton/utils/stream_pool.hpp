@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <algorithm>
+#include <mutex>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/device.hpp>
+#include <rapids_triton/utils/cuda_event.hpp>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/**
+ * @brief Make all future work on the waiting stream wait for all work
+ * currently enqueued on the signaling stream, without blocking the host
+ */
+inline void stream_wait(cudaStream_t waiting, cudaStream_t signaling)
+{
+  if constexpr (IS_GPU_BUILD) {
+    if (waiting != signaling) {
+      auto event = cuda_event{};
+      event.record(signaling);
+      event.wait(waiting);
+    }
+  }
+}
+
+struct stream_pool;
+
+/**
+ * @brief A stream acquired from a stream_pool, which is returned to the pool
+ * when this object goes out of scope
+ *
+ * Work enqueued on the stream need not be complete when it is returned to
+ * the pool; later users of the stream will simply be ordered after it.
+ */
+struct pooled_stream {
+  pooled_stream(stream_pool* pool, cudaStream_t stream) noexcept : pool_{pool}, stream_{stream}
+  {
+  }
+
+  pooled_stream(pooled_stream const& other) = delete;
+  pooled_stream& operator=(pooled_stream const& other) = delete;
+
+  pooled_stream(pooled_stream&& other) noexcept
+    : pool_{std::exchange(other.pool_, nullptr)}, stream_{other.stream_}
+  {
+  }
+  pooled_stream& operator=(pooled_stream&& other) noexcept
+  {
+    std::swap(pool_, other.pool_);
+    std::swap(stream_, other.stream_);
+    return *this;
+  }
+
+  ~pooled_stream();
+
+  auto get() const noexcept { return stream_; }
+
+  /** Make work on this stream wait for work already enqueued on another */
+  void wait_for(cudaStream_t other) const { stream_wait(stream_, other); }
+
+  /** Make work on another stream wait for work already enqueued on this one
+   */
+  void join_into(cudaStream_t other) const { stream_wait(other, stream_); }
+
+ private:
+  stream_pool* pool_;
+  cudaStream_t stream_;
+};
+
+/**
+ * @brief A collection of CUDA streams on a single device which may be
+ * acquired and released for concurrent work within a batch
+ *
+ * Streams are created on demand and reused once released. All streams are
+ * destroyed along with the pool, so no pooled_stream may outlive the pool
+ * which created it.
+ */
+struct stream_pool {
+  stream_pool(device_id_t device_id) : device_id_{device_id}, streams_{}, available_{}, lock_{} {}
+
+  stream_pool(stream_pool const& other) = delete;
+  stream_pool& operator=(stream_pool const& other) = delete;
+
+  ~stream_pool()
+  {
+    std::for_each(std::begin(streams_), std::end(streams_), [](auto stream) {
+      cudaStreamDestroy(stream);
+    });
+  }
+
+  auto acquire()
+  {
+    auto stream = cudaStream_t{};
+    if constexpr (IS_GPU_BUILD) {
+      auto lock = std::lock_guard<std::mutex>{lock_};
+      if (available_.empty()) {
+        auto prev_device = device_id_t{};
+        cuda_check(cudaGetDevice(&prev_device));
+        cuda_check(cudaSetDevice(device_id_));
+        auto result = cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking);
+        cudaSetDevice(prev_device);
+        cuda_check(result);
+        streams_.push_back(stream);
+      } else {
+        stream = available_.back();
+        available_.pop_back();
+      }
+    } else {
+      throw TritonException(Error::Internal, "Stream pool used in non-GPU build");
+    }
+    return pooled_stream{this, stream};
+  }
+
+  void release(cudaStream_t stream)
+  {
+    auto lock = std::lock_guard<std::mutex>{lock_};
+    available_.push_back(stream);
+  }
+
+ private:
+  device_id_t device_id_;
+  std::vector<cudaStream_t> streams_;
+  std::vector<cudaStream_t> available_;
+  std::mutex lock_;
+};
+
+inline pooled_stream::~pooled_stream()
+{
+  if (pool_ != nullptr) {
+    try {
+      pool_->release(stream_);
+    } catch (std::system_error const& ignored_err) {
+      // The stream is simply not reused if the pool cannot be locked
+    }
+  }
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
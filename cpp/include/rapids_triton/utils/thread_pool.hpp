@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/logging.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace detail {
+inline auto parse_cpu_index(std::string const& text)
+{
+  auto input  = std::istringstream{text};
+  auto result = int{-1};
+  input >> result;
+  if (input.fail() || !input.eof() || result < 0) {
+    throw TritonException(Error::InvalidArg, std::string("Bad CPU index ") + text);
+  }
+  return result;
+}
+
+/* Parse a list of CPU indices such as "0-3,8,10-11" */
+inline auto parse_cpu_list(std::string const& list)
+{
+  auto result = std::vector<int>{};
+  auto input  = std::istringstream{list};
+  auto entry  = std::string{};
+  while (std::getline(input, entry, ',')) {
+    auto separator = entry.find('-');
+    auto first     = parse_cpu_index(entry.substr(0, separator));
+    auto last      = first;
+    if (separator != std::string::npos) { last = parse_cpu_index(entry.substr(separator + 1)); }
+    if (last < first) {
+      throw TritonException(Error::InvalidArg, std::string("Bad CPU range ") + entry);
+    }
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+inline void pin_current_thread(int cpu)
+{
+#ifdef __linux__
+  auto cpus = cpu_set_t{};
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0) {
+    log_warn(__FILE__, __LINE__) << "Could not pin worker thread to CPU " << cpu;
+  }
+#else
+  log_warn(__FILE__, __LINE__) << "CPU affinity is not supported on this platform";
+#endif
+}
+}  // namespace detail
+
+/**
+ * @brief A pool of worker threads for parallelizing host work within a batch
+ *
+ * Each worker owns a queue of tasks. Tasks submitted from a worker are added
+ * to that worker's own queue, and other tasks are distributed among the
+ * queues in rotation. Workers take tasks from the back of their own queue
+ * and, when it is empty, steal from the front of the others'. If CPUs are
+ * given, worker i is pinned to CPU `cpus[i % cpus.size()]`, which allows a
+ * pool to be confined to the cores of a single NUMA node.
+ */
+struct thread_pool {
+  explicit thread_pool(std::size_t thread_count, std::vector<int> const& cpus = std::vector<int>{})
+    : queues_{}, workers_{}, next_queue_{}, pending_{}, stopping_{false}, sleep_lock_{}, wake_{}
+  {
+    queues_.reserve(thread_count);
+    for (auto i = std::size_t{}; i < thread_count; ++i) {
+      queues_.push_back(std::make_unique<task_queue>());
+    }
+    workers_.reserve(thread_count);
+    for (auto i = std::size_t{}; i < thread_count; ++i) {
+      auto cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+      workers_.emplace_back([this, i, cpu]() {
+        if (cpu >= 0) { detail::pin_current_thread(cpu); }
+        run(i);
+      });
+    }
+  }
+
+  thread_pool(thread_pool const& other) = delete;
+  thread_pool& operator=(thread_pool const& other) = delete;
+
+  /** Complete all submitted tasks and join the workers */
+  ~thread_pool()
+  {
+    {
+      auto lock = std::lock_guard<std::mutex>{sleep_lock_};
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    std::for_each(std::begin(workers_), std::end(workers_), [](auto& worker) { worker.join(); });
+  }
+
+  auto size() const noexcept { return workers_.size(); }
+
+  /**
+   * @brief Run a task asynchronously on one of the workers
+   *
+   * Exceptions thrown by the task are logged rather than propagated.
+   */
+  void submit(std::function<void()>&& task)
+  {
+    if (workers_.empty()) {
+      run_task(task);
+      return;
+    }
+    auto& current = current_worker();
+    auto index    = (current.first == this)
+                      ? current.second
+                      : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+      auto lock = std::lock_guard<std::mutex>{queues_[index]->lock};
+      queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+      auto lock = std::lock_guard<std::mutex>{sleep_lock_};
+      ++pending_;
+    }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief Call `fn(chunk_begin, chunk_end)` for consecutive chunks of at
+   * most `grain` indices covering [begin, end), blocking until all have
+   * completed
+   *
+   * The calling thread processes chunks alongside the workers, so this may
+   * safely be called from within a task running on the pool. If any call to
+   * `fn` throws, the first exception is rethrown once all chunks are done.
+   */
+  template <typename F>
+  void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, F&& fn)
+  {
+    if (begin >= end) { return; }
+    grain       = std::max(grain, std::size_t{1});
+    auto chunks = (end - begin + grain - 1) / grain;
+    if (chunks == 1 || workers_.empty()) {
+      fn(begin, end);
+      return;
+    }
+
+    auto state   = std::make_shared<parallel_state>();
+    auto process = [state, chunks, begin, end, grain, &fn]() {
+      auto chunk = state->next.fetch_add(1);
+      while (chunk < chunks) {
+        auto chunk_begin = begin + chunk * grain;
+        try {
+          fn(chunk_begin, std::min(chunk_begin + grain, end));
+        } catch (...) {
+          auto lock = std::lock_guard<std::mutex>{state->lock};
+          if (!state->error) { state->error = std::current_exception(); }
+        }
+        if (state->done.fetch_add(1) + 1 == chunks) {
+          auto lock = std::lock_guard<std::mutex>{state->lock};
+          state->complete.notify_all();
+        }
+        chunk = state->next.fetch_add(1);
+      }
+    };
+    auto helpers = std::min(workers_.size(), chunks - 1);
+    for (auto i = std::size_t{}; i < helpers; ++i) {
+      submit(process);
+    }
+    process();
+
+    auto lock = std::unique_lock<std::mutex>{state->lock};
+    state->complete.wait(lock, [&state, chunks]() { return state->done.load() == chunks; });
+    if (state->error) { std::rethrow_exception(state->error); }
+  }
+
+  /** Call parallel_for with a grain giving each thread several chunks */
+  template <typename F>
+  void parallel_for(std::size_t begin, std::size_t end, F&& fn)
+  {
+    auto chunks = 4 * (workers_.size() + 1);
+    auto grain  = (end > begin) ? (end - begin + chunks - 1) / chunks : std::size_t{1};
+    parallel_for(begin, end, grain, std::forward<F>(fn));
+  }
+
+ private:
+  struct task_queue {
+    std::deque<std::function<void()>> tasks;
+    std::mutex lock;
+  };
+
+  struct parallel_state {
+    std::atomic<std::size_t> next{};
+    std::atomic<std::size_t> done{};
+    std::exception_ptr error{};
+    std::mutex lock{};
+    std::condition_variable complete{};
+  };
+
+  std::vector<std::unique_ptr<task_queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> next_queue_;
+  // Number of submitted tasks which no worker has yet claimed
+  std::size_t pending_;
+  bool stopping_;
+  std::mutex sleep_lock_;
+  std::condition_variable wake_;
+
+  static std::pair<thread_pool*, std::size_t>& current_worker()
+  {
+    thread_local auto worker = std::pair<thread_pool*, std::size_t>{nullptr, 0};
+    return worker;
+  }
+
+  static void run_task(std::function<void()>& task)
+  {
+    try {
+      task();
+    } catch (std::exception const& err) {
+      log_error(__FILE__, __LINE__, err.what());
+    }
+  }
+
+  bool take_task(std::size_t index, std::function<void()>& task)
+  {
+    for (auto i = std::size_t{}; i < queues_.size(); ++i) {
+      auto& queue = *queues_[(index + i) % queues_.size()];
+      auto lock   = std::lock_guard<std::mutex>{queue.lock};
+      if (!queue.tasks.empty()) {
+        if (i == 0) {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+        } else {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run(std::size_t index)
+  {
+    current_worker() = std::make_pair(this, index);
+    auto task        = std::function<void()>{};
+    while (true) {
+      {
+        auto lock = std::unique_lock<std::mutex>{sleep_lock_};
+        wake_.wait(lock, [this]() { return stopping_ || pending_ > 0; });
+        if (pending_ == 0) { break; }
+        --pending_;
+      }
+      // Tasks are queued before they are counted, so a claimed task is
+      // always available in some queue
+      if (take_task(index, task)) {
+        run_task(task);
+        task = nullptr;
+      }
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
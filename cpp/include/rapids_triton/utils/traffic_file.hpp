@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+/*
+ * A traffic capture is a header followed by one record per captured batch,
+ * each written with a single append. All values are in native byte order and
+ * every field is 8-byte aligned, so that a mapped capture can be read in
+ * place:
+ *
+ *   header:  char magic[8], u32 version, u32 reserved, u64 start_ns
+ *   record:  u64 record_bytes, u64 offset_ns, u32 request_count, u32 reserved
+ *            then per request: u32 input_count, u32 reserved
+ *            then per input:   u32 name_bytes, u32 dtype, u32 dims, u32 flags,
+ *                              u64 byte_size, name (padded), i64 shape[dims],
+ *                              data (padded, present if flags has bit 0 set)
+ *
+ * start_ns is the time at which capture began in nanoseconds since the
+ * system clock's epoch, and offset_ns the time of each batch relative to it.
+ */
+namespace detail {
+auto constexpr traffic_magic        = "RTTRAFIC";
+auto constexpr traffic_version      = std::uint32_t{1};
+auto constexpr traffic_has_data     = std::uint32_t{1};
+auto constexpr traffic_header_bytes = std::size_t{24};
+
+inline auto traffic_padded(std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+
+template <typename T>
+void append_traffic_value(std::vector<std::byte>& bytes, T value)
+{
+  auto offset = bytes.size();
+  bytes.resize(offset + sizeof(T));
+  std::memcpy(bytes.data() + offset, &value, sizeof(T));
+}
+
+template <typename T>
+auto read_traffic_value(std::byte const* src)
+{
+  auto result = T{};
+  std::memcpy(&result, src, sizeof(T));
+  return result;
+}
+
+[[noreturn]] inline void throw_traffic_error(std::string const& path, std::string const& problem)
+{
+  throw TritonException(Error::InvalidArg,
+                        "Could not read traffic capture " + path + ": " + problem);
+}
+}  // namespace detail
+
+/** Encode the header of a traffic capture begun at the given time */
+inline auto encode_traffic_header(std::chrono::system_clock::time_point start)
+{
+  auto result = std::vector<std::byte>(8);
+  std::memcpy(result.data(), detail::traffic_magic, 8);
+  detail::append_traffic_value(result, detail::traffic_version);
+  detail::append_traffic_value(result, std::uint32_t{});
+  detail::append_traffic_value(
+    result,
+    static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count()));
+  return result;
+}
+
+/**
+ * @brief Encodes the record of one captured batch
+ *
+ * Requests are added in order, each followed by all of its inputs.
+ */
+struct traffic_record {
+  traffic_record(std::chrono::nanoseconds offset, std::size_t request_count) : bytes_{}
+  {
+    detail::append_traffic_value(bytes_, std::uint64_t{});
+    detail::append_traffic_value(bytes_, static_cast<std::uint64_t>(offset.count()));
+    detail::append_traffic_value(bytes_, static_cast<std::uint32_t>(request_count));
+    detail::append_traffic_value(bytes_, std::uint32_t{});
+  }
+
+  void add_request(std::size_t input_count)
+  {
+    detail::append_traffic_value(bytes_, static_cast<std::uint32_t>(input_count));
+    detail::append_traffic_value(bytes_, std::uint32_t{});
+  }
+
+  /**
+   * @brief Add an input to the most recently added request
+   *
+   * @return the location to which the input's byte_size bytes of data should
+   * be written if with_data is true, or nullptr otherwise. It is only valid
+   * until the next input is added.
+   */
+  std::byte* add_input(std::string const& name,
+                       DType dtype,
+                       std::int64_t const* shape,
+                       std::size_t dims,
+                       std::size_t byte_size,
+                       bool with_data)
+  {
+    detail::append_traffic_value(bytes_, static_cast<std::uint32_t>(name.size()));
+    detail::append_traffic_value(bytes_, static_cast<std::uint32_t>(dtype));
+    detail::append_traffic_value(bytes_, static_cast<std::uint32_t>(dims));
+    detail::append_traffic_value(bytes_, with_data ? detail::traffic_has_data : std::uint32_t{});
+    detail::append_traffic_value(bytes_, static_cast<std::uint64_t>(byte_size));
+    auto offset = bytes_.size();
+    bytes_.resize(offset + detail::traffic_padded(name.size()));
+    std::memcpy(bytes_.data() + offset, name.data(), name.size());
+    for (auto i = std::size_t{}; i < dims; ++i) {
+      detail::append_traffic_value(bytes_, shape[i]);
+    }
+    auto* result = static_cast<std::byte*>(nullptr);
+    if (with_data) {
+      offset = bytes_.size();
+      bytes_.resize(offset + detail::traffic_padded(byte_size));
+      result = bytes_.data() + offset;
+    }
+    return result;
+  }
+
+  auto size() const noexcept { return bytes_.size(); }
+
+  /** The encoded record, which may no longer be added to */
+  auto release() &&
+  {
+    auto record_bytes = static_cast<std::uint64_t>(bytes_.size());
+    std::memcpy(bytes_.data(), &record_bytes, sizeof(record_bytes));
+    return std::move(bytes_);
+  }
+
+ private:
+  std::vector<std::byte> bytes_;
+};
+
+/** One input of a captured request */
+struct traffic_input {
+  std::string name;
+  DType dtype;
+  std::vector<std::int64_t> shape;
+  std::size_t byte_size;
+  /** The captured bytes of the input, or nullptr if they were not sampled */
+  std::byte const* data;
+};
+
+struct traffic_request {
+  std::vector<traffic_input> inputs;
+};
+
+/** One captured batch, received `offset` after capture began */
+struct traffic_batch {
+  std::chrono::nanoseconds offset;
+  std::vector<traffic_request> requests;
+};
+
+/**
+ * @brief A read-only, memory-mapped view of a traffic capture
+ *
+ * The captured input data are not copied: every traffic_input's data points
+ * into the mapping, which is released when the reader is destroyed. A record
+ * cut short at the end of the file, as left by a process which stopped while
+ * capturing, is ignored.
+ */
+struct traffic_reader {
+  explicit traffic_reader(std::string const& path)
+    : data_{nullptr}, size_{}, start_time_{}, batches_{}
+  {
+    auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) { detail::throw_traffic_error(path, std::strerror(errno)); }
+    struct stat info {};
+    auto mapped = fstat(fd, &info) == 0;
+    if (mapped && info.st_size != 0) {
+      size_      = static_cast<std::size_t>(info.st_size);
+      auto* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      mapped     = data != MAP_FAILED;
+      data_      = mapped ? static_cast<std::byte const*>(data) : nullptr;
+    }
+    auto err = errno;
+    ::close(fd);
+    if (!mapped) {
+      size_ = 0;
+      detail::throw_traffic_error(path, std::strerror(err));
+    }
+    try {
+      parse(path);
+    } catch (...) {
+      unmap();
+      throw;
+    }
+  }
+
+  traffic_reader(traffic_reader const& other) = delete;
+  traffic_reader& operator=(traffic_reader const& other) = delete;
+
+  ~traffic_reader() { unmap(); }
+
+  /** The time at which capture began */
+  auto start_time() const noexcept { return start_time_; }
+  /** Every complete batch in the capture, in the order received */
+  auto const& batches() const noexcept { return batches_; }
+
+ private:
+  std::byte const* data_;
+  std::size_t size_;
+  std::chrono::system_clock::time_point start_time_;
+  std::vector<traffic_batch> batches_;
+
+  void unmap() noexcept
+  {
+    if (data_ != nullptr) { munmap(const_cast<std::byte*>(data_), size_); }
+    data_ = nullptr;
+  }
+
+  void parse(std::string const& path)
+  {
+    if (size_ < detail::traffic_header_bytes ||
+        std::memcmp(data_, detail::traffic_magic, 8) != 0) {
+      detail::throw_traffic_error(path, "not a traffic capture");
+    }
+    auto version = detail::read_traffic_value<std::uint32_t>(data_ + 8);
+    if (version != detail::traffic_version) {
+      detail::throw_traffic_error(path, "unsupported version " + std::to_string(version));
+    }
+    start_time_ = std::chrono::system_clock::time_point{
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds{
+        detail::read_traffic_value<std::uint64_t>(data_ + 16)})};
+
+    auto offset = detail::traffic_header_bytes;
+    while (size_ - offset >= 24) {
+      auto record_bytes = detail::read_traffic_value<std::uint64_t>(data_ + offset);
+      if (record_bytes > size_ - offset) { break; }
+      auto end = offset + record_bytes;
+      // Every read within the record is checked against its end
+      auto read = [&](std::size_t bytes) {
+        if (bytes > end - offset) { detail::throw_traffic_error(path, "corrupt record"); }
+        auto* result = data_ + offset;
+        offset += detail::traffic_padded(bytes);
+        return result;
+      };
+      auto batch = traffic_batch{};
+      read(8);
+      batch.offset  = std::chrono::nanoseconds{detail::read_traffic_value<std::int64_t>(read(8))};
+      auto requests = detail::read_traffic_value<std::uint32_t>(read(8));
+      for (auto i = std::uint32_t{}; i < requests; ++i) {
+        auto request = traffic_request{};
+        auto inputs  = detail::read_traffic_value<std::uint32_t>(read(8));
+        for (auto j = std::uint32_t{}; j < inputs; ++j) {
+          auto const* header = read(24);
+          auto name_bytes    = detail::read_traffic_value<std::uint32_t>(header);
+          auto dtype         = detail::read_traffic_value<std::uint32_t>(header + 4);
+          auto dims          = detail::read_traffic_value<std::uint32_t>(header + 8);
+          auto flags         = detail::read_traffic_value<std::uint32_t>(header + 12);
+          auto input         = traffic_input{};
+          input.dtype        = static_cast<DType>(dtype);
+          input.byte_size    = detail::read_traffic_value<std::uint64_t>(header + 16);
+          auto const* name   = read(name_bytes);
+          input.name         = std::string{reinterpret_cast<char const*>(name), name_bytes};
+          auto const* shape  = read(std::size_t{dims} * sizeof(std::int64_t));
+          input.shape.resize(dims);
+          std::memcpy(input.shape.data(), shape, std::size_t{dims} * sizeof(std::int64_t));
+          input.data = (flags & detail::traffic_has_data) ? read(input.byte_size) : nullptr;
+          request.inputs.push_back(std::move(input));
+        }
+        batch.requests.push_back(std::move(request));
+      }
+      batches_.push_back(std::move(batch));
+      offset = end;
+    }
+  }
+};
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
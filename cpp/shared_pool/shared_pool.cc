@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * The device memory pools shared by every backend in the process which loads
+ * this library (see rapids_triton/memory/detail/gpu_only/shared_pool.hpp).
+ * Since rapids_triton is header-only, each backend otherwise holds its own
+ * copy of the device resource table; the dynamic loader maps this library
+ * only once, so the pools defined here are common to all of them.
+ */
+
+#include <cuda_runtime_api.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <rmm/mr/device/cuda_memory_resource.hpp>
+#include <rmm/mr/device/pool_memory_resource.hpp>
+
+namespace {
+using shared_pool_t = rmm::mr::pool_memory_resource<rmm::mr::cuda_memory_resource>;
+
+struct shared_pools {
+  std::mutex mtx{};
+  rmm::mr::cuda_memory_resource upstream{};
+  std::map<int, std::unique_ptr<shared_pool_t>> pools{};
+};
+
+auto& get_shared_pools()
+{
+  static auto result = shared_pools{};
+  return result;
+}
+}  // namespace
+
+/* Return the pool for the given device, creating it with the given initial
+ * and maximum (0 for none) size on the first call for that device. Returns
+ * nullptr if the pool cannot be created. */
+extern "C" __attribute__((visibility("default"))) void* rapids_triton_shared_device_pool_v1(
+  int device_id, std::size_t initial_size, std::size_t maximum_size)
+{
+  auto& shared = get_shared_pools();
+  auto lock    = std::lock_guard<std::mutex>{shared.mtx};
+  auto& pool   = shared.pools[device_id];
+  if (!pool) {
+    // The pool reserves its initial allocation on the current device
+    auto prev_device = int{};
+    if (cudaGetDevice(&prev_device) != cudaSuccess || cudaSetDevice(device_id) != cudaSuccess) {
+      return nullptr;
+    }
+    try {
+      pool = std::make_unique<shared_pool_t>(
+        &shared.upstream,
+        initial_size,
+        maximum_size == 0 ? std::optional<std::size_t>{} : std::optional<std::size_t>{maximum_size});
+    } catch (...) {
+    }
+    cudaSetDevice(prev_device);
+  }
+  return static_cast<rmm::mr::device_memory_resource*>(pool.get());
+}
@@ -23,10 +23,16 @@
 #endif
 #include <names.h>
 #include <shared_state.h>
+#include <synthetic_load.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <memory>
 #include <optional>
+#include <string>
 #include <rapids_triton/batch/batch.hpp>        // rapids::Batch
+#include <rapids_triton/exceptions.hpp>         // rapids::TritonException
 #include <rapids_triton/memory/types.hpp>       // rapids::MemoryType
 #include <rapids_triton/model/model.hpp>        // rapids::Model
 #include <rapids_triton/tensor/tensor.hpp>      // rapids::copy
@@ -73,7 +79,8 @@ struct RapidsModel : rapids::Model<RapidsSharedState> {
    * a predict function requires four steps:
    * 1. Call `get_input` on the provided `Batch` object for each of the input
    *    tensors named in the config file for this backend. This provides a
-   *    `Tensor` object containing the input data.
+   *    `Tensor` object containing the input data. For models with several
+   *    inputs, `get_inputs` can be used to retrieve all of them at once.
    * 2. Call `get_output` on the provided `Batch` object for each of the output
    *    tensors named in the config file for this backend. This provides a
    *    `Tensor` object to which output values can be written.
@@ -81,21 +88,38 @@ struct RapidsModel : rapids::Model<RapidsSharedState> {
    *    the output Tensors. `some_tensor.data()` can be used to retrieve a raw
    *    pointer to the underlying data.
    * 4. Call the `finalize` method on all output tensors.
+   *
+   * Outputs whose shape is only known at predict time may instead be
+   * requested with an explicit shape, as done here when `output_width` is
+   * set.
    **************************************************************************/
   void predict(rapids::Batch& batch) const
   {
     // 1. Acquire a tensor representing the input named "input__0"
     auto input = get_input<float>(batch, "input__0");
-    // 2. Acquire a tensor representing the output named "output__0"
-    auto output = get_output<float>(batch, "output__0");
+    auto rows  = input.shape()[0];
+
+    // Spend the time and memory configured to imitate a real model (see
+    // synthetic_load.h). By default, this does nothing.
+    add_synthetic_load(batch, rows);
+
+    auto width = get_config_param(output_width);
+    if (width == 0) {
+      // 2. Acquire a tensor representing the output named "output__0"
+      auto output = get_output<float>(batch, "output__0");
 
-    // 3. Perform inference. In this example, we simply copy the data from the
-    // input to the output tensor.
-    rapids::copy(output, input);
+      // 3. Perform inference. In this example, we simply copy the data from
+      // the input to the output tensor.
+      rapids::copy(output, input);
 
-    // 4. Call finalize on all output tensors. In this case, we have just one
-    // output, so we call finalize on it.
-    output.finalize();
+      // 4. Call finalize on all output tensors. In this case, we have just
+      // one output, so we call finalize on it.
+      output.finalize();
+    } else {
+      auto output = get_output<float>(batch, "output__0", {rows, width});
+      zero_fill(output.data(), output.size() * sizeof(float), output.mem_type(), batch.stream());
+      output.finalize();
+    }
   }
 
   /***************************************************************************
@@ -116,7 +140,19 @@ struct RapidsModel : rapids::Model<RapidsSharedState> {
    * These methods need not be explicitly implemented if no loading/unloading
    * logic is required, but we show them here for illustrative purposes.
    **************************************************************************/
-  void load() {}
+  void load()
+  {
+    auto placement = get_config_param<std::string>("memory_placement", std::string{"any"});
+    if (placement == "host") {
+      placement_ = rapids::HostMemory;
+    } else if (placement == "device") {
+      placement_ = (get_deployment_type() == rapids::GPUDeployment) ? rapids::DeviceMemory
+                                                                    : rapids::HostMemory;
+    } else if (placement != "any") {
+      throw rapids::TritonException(rapids::Error::InvalidArg,
+                                    "memory_placement must be host, device or any");
+    }
+  }
   void unload() {}
 
   /***************************************************************************
@@ -136,8 +172,9 @@ struct RapidsModel : rapids::Model<RapidsSharedState> {
    * on-device (or vice versa), `preferred_mem_type_in` and
    * `preferred_mem_type_out` can be used for even more precise control.
    *
-   * In this example, we simply return `std::nullopt` to indicate that the
-   * model has no preference on its input/output data locations. Note that the
+   * In this example, we return the location given by the `memory_placement`
+   * parameter, or `std::nullopt` by default to indicate that the model has no
+   * preference on its input/output data locations. Note that the
    * Batch being processed is taken as input to this function to facilitate
    * implementations that may switch their preferred memory location based on
    * properties of the batch.
@@ -147,7 +184,35 @@ struct RapidsModel : rapids::Model<RapidsSharedState> {
    **************************************************************************/
   std::optional<rapids::MemoryType> preferred_mem_type(rapids::Batch& batch) const
   {
-    return std::nullopt;
+    return placement_;
+  }
+
+ private:
+  std::optional<rapids::MemoryType> placement_;
+
+  /* Spend the host time, device time and scratch memory per row given by the
+   * parameters in synthetic_load.h */
+  void add_synthetic_load(rapids::Batch& batch, std::size_t rows) const
+  {
+    auto on_device     = get_deployment_type() == rapids::GPUDeployment;
+    auto scratch_bytes = rows * get_config_param(scratch_bytes_per_row);
+    auto allocations   = std::max(get_config_param(scratch_allocations), std::size_t{1});
+    if (scratch_bytes != 0) {
+      auto mem_type = on_device ? rapids::DeviceMemory : rapids::HostMemory;
+      for (auto i = std::size_t{}; i < allocations; ++i) {
+        auto bytes   = scratch_bytes / allocations + (i < scratch_bytes % allocations ? 1 : 0);
+        auto scratch = get_scratch<char>(batch, bytes, mem_type);
+        zero_fill(scratch.data(), bytes, mem_type, batch.stream());
+      }
+    }
+
+#ifdef TRITON_ENABLE_GPU
+    if (on_device) {
+      spin_on_device(std::chrono::nanoseconds(rows * get_config_param(device_ns_per_row)),
+                     batch.stream());
+    }
+#endif
+    spin_on_host(std::chrono::nanoseconds(rows * get_config_param(host_ns_per_row)));
   }
 };
 
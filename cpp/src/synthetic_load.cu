@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <synthetic_load.h>
+
+#include <chrono>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>  // rapids::cuda_check
+
+namespace triton {
+namespace backend {
+namespace NAMESPACE {
+
+namespace {
+__device__ std::uint64_t global_timer_ns()
+{
+  auto result = std::uint64_t{};
+  asm volatile("mov.u64 %0, %%globaltimer;" : "=l"(result));
+  return result;
+}
+
+__global__ void spin_kernel(std::uint64_t duration_ns)
+{
+  auto start = global_timer_ns();
+  while (global_timer_ns() - start < duration_ns) {}
+}
+}  // namespace
+
+void spin_on_device(std::chrono::nanoseconds duration, cudaStream_t stream)
+{
+  if (duration.count() > 0) {
+    spin_kernel<<<1, 1, 0, stream>>>(static_cast<std::uint64_t>(duration.count()));
+    rapids::cuda_check(cudaPeekAtLastError());
+  }
+}
+
+}  // namespace NAMESPACE
+}  // namespace backend
+}  // namespace triton
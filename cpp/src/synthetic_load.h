@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <names.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <rapids_triton/exceptions.hpp>              // rapids::cuda_check
+#include <rapids_triton/memory/types.hpp>            // rapids::MemoryType
+#include <rapids_triton/model/config_parameter.hpp>  // rapids::config_parameter
+
+namespace triton {
+namespace backend {
+namespace NAMESPACE {
+
+/* The identity model doubles as a stand-in for real models when testing
+ * server, batching and deployment settings. Each of the following parameters
+ * adds a cost proportional to the rows of each batch, and none adds any cost
+ * by default. */
+
+/* Device time spent per row, on one thread block of the model's device, in
+ * GPU deployments */
+inline auto constexpr device_ns_per_row =
+  rapids::config_parameter<std::uint64_t>{"device_ns_per_row", 0};
+/* Host time spent per row on the thread calling predict */
+inline auto constexpr host_ns_per_row =
+  rapids::config_parameter<std::uint64_t>{"host_ns_per_row", 0};
+/* Columns of the output, which is zero-filled rather than copied from the
+ * input if this is nonzero */
+inline auto constexpr output_width = rapids::config_parameter<std::size_t>{"output_width", 0};
+/* Bytes of scratch memory allocated and zero-filled per row */
+inline auto constexpr scratch_bytes_per_row =
+  rapids::config_parameter<std::size_t>{"scratch_bytes_per_row", 0};
+/* Number of allocations over which each batch's scratch memory is divided */
+inline auto constexpr scratch_allocations =
+  rapids::config_parameter<std::size_t>{"scratch_allocations", 1};
+
+/* Busy-wait on the calling thread for the given time */
+inline void spin_on_host(std::chrono::nanoseconds duration)
+{
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {}
+}
+
+#ifdef TRITON_ENABLE_GPU
+/* Occupy one thread block of the current device for the given time once
+ * work already enqueued on the stream completes. Defined in
+ * synthetic_load.cu. */
+void spin_on_device(std::chrono::nanoseconds duration, cudaStream_t stream);
+#endif
+
+/* Set the given bytes to zero, asynchronously on the stream if they are on
+ * the device */
+inline void zero_fill(void* data,
+                      std::size_t bytes,
+                      rapids::MemoryType mem_type,
+                      cudaStream_t stream)
+{
+  if (mem_type == rapids::DeviceMemory) {
+#ifdef TRITON_ENABLE_GPU
+    rapids::cuda_check(cudaMemsetAsync(data, 0, bytes, stream));
+#endif
+  } else {
+    std::memset(data, 0, bytes);
+  }
+}
+
+}  // namespace NAMESPACE
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/batch/accumulator.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, batch_latency_model)
+{
+  auto latency = batch_latency_model{{}, 8};
+  EXPECT_EQ(latency.p99(4).count(), 0);
+
+  latency.observe(4, std::chrono::microseconds{100});
+  EXPECT_EQ(latency.p99(4).count(), 100);
+  // Unobserved buckets are scaled from the nearest observed bucket
+  EXPECT_EQ(latency.p99(1).count(), 25);
+  EXPECT_EQ(latency.p99(8).count(), 200);
+  EXPECT_EQ(latency.best_rows(std::chrono::microseconds{150}), 4);
+
+  // Variation in latency raises the 99th percentile above the mean
+  latency.observe(3, std::chrono::microseconds{200});
+  EXPECT_EQ(latency.p99(4).count(), 150);
+  EXPECT_EQ(latency.p99(100).count(), 300);
+  EXPECT_EQ(latency.best_rows(std::chrono::microseconds{10}), 1);
+}
+
+TEST(RapidsTriton, request_accumulator)
+{
+  auto latency   = batch_latency_model{{}, 8};
+  auto processed = std::vector<std::vector<TRITONBACKEND_Request*>>{};
+  auto requests  = std::vector<TRITONBACKEND_Request*>{};
+  {
+    auto accumulator = request_accumulator{
+      std::chrono::seconds{1}, 8, latency, [&processed](auto& batch, auto) {
+        processed.push_back(batch);
+      }};
+    for (auto i = std::uintptr_t{1}; i <= 4; ++i) {
+      requests.push_back(reinterpret_cast<TRITONBACKEND_Request*>(i));
+      accumulator.add(requests.back(), 2);
+    }
+  }
+  ASSERT_EQ(processed.size(), 1);
+  EXPECT_EQ(processed[0], requests);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <rapids_triton/batch/admission.hpp>
+#include <thread>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, predict_admission)
+{
+  auto admission = predict_admission{0, 2, false};
+  EXPECT_EQ(admission.weight(100), 1);
+
+  auto first    = admission_ticket{admission, 1};
+  auto second   = admission_ticket{admission, 1};
+  auto admitted = std::atomic<bool>{false};
+  auto waiter   = std::thread{[&admission, &admitted]() {
+    auto third = admission_ticket{admission, 1};
+    admitted.store(true);
+  }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  EXPECT_FALSE(admitted.load());
+
+  auto moved = std::move(first);
+  EXPECT_FALSE(first);
+  moved.release();
+  waiter.join();
+  EXPECT_TRUE(admitted.load());
+}
+
+TEST(RapidsTriton, weighted_predict_admission)
+{
+  auto admission = predict_admission{0, 64, true};
+  EXPECT_EQ(admission.weight(0), 1);
+  EXPECT_EQ(admission.weight(16), 16);
+  // Batches larger than the limit run alone rather than never
+  EXPECT_EQ(admission.weight(1000), 64);
+
+  auto large    = admission_ticket{admission, 48};
+  auto admitted = std::atomic<bool>{false};
+  auto waiter   = std::thread{[&admission, &admitted]() {
+    auto oversized = admission_ticket{admission, 1000};
+    admitted.store(true);
+  }};
+  auto small = admission_ticket{admission, 16};
+  std::this_thread::sleep_for(std::chrono::milliseconds{20});
+  EXPECT_FALSE(admitted.load());
+  large.release();
+  small.release();
+  waiter.join();
+  EXPECT_TRUE(admitted.load());
+}
+
+TEST(RapidsTriton, try_predict_admission)
+{
+  auto admission = predict_admission{0, 1, false};
+  auto held      = admission_ticket::try_admit(admission, 1, std::chrono::milliseconds{});
+  EXPECT_TRUE(held);
+  EXPECT_FALSE(admission_ticket::try_admit(admission, 1, std::chrono::milliseconds{10}));
+
+  auto releaser = std::thread{[&held]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    held.release();
+  }};
+  EXPECT_TRUE(admission_ticket::try_admit(admission, 1, std::chrono::seconds{10}));
+  releaser.join();
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -14,4 +14,225 @@
  * limitations under the License.
  */
 
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
 #include <rapids_triton/batch/batch.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/input.hpp>
+#include <rapids_triton/triton/statistics.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+/* Calls made by batches to the Triton backend API. Requests and responses
+ * passed to these functions are never dereferenced, so tests may use
+ * arbitrary non-null values for them. */
+struct fake_backend_calls {
+  std::vector<TRITONBACKEND_Request*> released{};
+  std::vector<std::string> sent_errors{};
+  std::size_t sent_successes{};
+};
+
+auto fake_backend = fake_backend_calls{};
+}  // namespace
+
+// The server library linked by the tests only implements the backend API
+// for requests it created, so these definitions take its place
+extern "C" {
+TRITONSERVER_Error* TRITONBACKEND_ResponseNew(TRITONBACKEND_Response** response,
+                                              TRITONBACKEND_Request* request)
+{
+  *response = reinterpret_cast<TRITONBACKEND_Response*>(request);
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_ResponseSend(TRITONBACKEND_Response*,
+                                               uint32_t const,
+                                               TRITONSERVER_Error* error)
+{
+  if (error == nullptr) {
+    ++fake_backend.sent_successes;
+  } else {
+    fake_backend.sent_errors.emplace_back(TRITONSERVER_ErrorMessage(error));
+  }
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestRelease(TRITONBACKEND_Request* request, uint32_t)
+{
+  fake_backend.released.push_back(request);
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_RequestInputByIndex(TRITONBACKEND_Request*,
+                                                      uint32_t const,
+                                                      TRITONBACKEND_Input** input)
+{
+  *input = nullptr;
+  return nullptr;
+}
+
+TRITONSERVER_Error* TRITONBACKEND_InputProperties(TRITONBACKEND_Input*,
+                                                  char const**,
+                                                  TRITONSERVER_DataType*,
+                                                  int64_t const** shape,
+                                                  uint32_t* dims_count,
+                                                  uint64_t*,
+                                                  uint32_t*)
+{
+  // Each request holds a single row
+  static auto const rows = int64_t{1};
+  *shape                 = &rows;
+  *dims_count            = 1;
+  return nullptr;
+}
+}
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace {
+auto fake_requests(std::size_t count)
+{
+  auto result = std::vector<TRITONBACKEND_Request*>{};
+  for (auto i = std::uintptr_t{1}; i <= count; ++i) {
+    result.push_back(reinterpret_cast<TRITONBACKEND_Request*>(i));
+  }
+  return result;
+}
+}  // namespace
+
+TEST(RapidsTriton, failed_batch_releases_requests)
+{
+  fake_backend  = fake_backend_calls{};
+  auto requests = fake_requests(3);
+  auto reported = std::size_t{};
+  auto report   = [&reported](TRITONBACKEND_Request*,
+                            time_point const&,
+                            time_point const&,
+                            time_point const&,
+                            time_point const&) { ++reported; };
+  auto no_outputs = [](std::string const&, std::size_t) { return std::vector<std::size_t>{}; };
+  auto* memory_manager = reinterpret_cast<TRITONBACKEND_MemoryManager*>(&reported);
+
+  auto batch = Batch(requests.data(),
+                     requests.size(),
+                     *memory_manager,
+                     no_outputs,
+                     report,
+                     false,
+                     false,
+                     8,
+                     cudaStream_t{});
+  auto* err = static_cast<TRITONSERVER_Error*>(nullptr);
+  try {
+    batch.for_each_row_slice(2, [](Batch&) {
+      throw TritonException(Error::Internal, "predict failed");
+    });
+  } catch (TritonException const& predict_err) {
+    err = predict_err.error();
+  }
+  ASSERT_NE(err, nullptr);
+  // The batch deletes the error once it has been sent
+  batch.finalize(err);
+
+  // Every request receives the error and is released, but statistics are
+  // only reported for requests which succeed
+  EXPECT_THAT(fake_backend.sent_errors, ::testing::Each(std::string{"predict failed"}));
+  EXPECT_EQ(fake_backend.sent_errors.size(), requests.size());
+  EXPECT_EQ(fake_backend.sent_successes, 0);
+  EXPECT_EQ(fake_backend.released, requests);
+  EXPECT_EQ(reported, 0);
+}
+
+TEST(RapidsTriton, failed_request_in_batch)
+{
+  fake_backend  = fake_backend_calls{};
+  auto requests = fake_requests(3);
+  auto reported = std::vector<TRITONBACKEND_Request*>{};
+  auto report   = [&reported](TRITONBACKEND_Request* request,
+                            time_point const&,
+                            time_point const&,
+                            time_point const&,
+                            time_point const&) { reported.push_back(request); };
+  auto no_outputs = [](std::string const&, std::size_t) { return std::vector<std::size_t>{}; };
+  auto* memory_manager = reinterpret_cast<TRITONBACKEND_MemoryManager*>(&reported);
+
+  auto batch = Batch(requests.data(),
+                     requests.size(),
+                     *memory_manager,
+                     no_outputs,
+                     report,
+                     false,
+                     false,
+                     8,
+                     cudaStream_t{});
+  {
+    // The batch keeps its own copy of the error
+    auto err = TritonException(Error::InvalidArg, "bad request");
+    batch.fail_request(1, err);
+    TRITONSERVER_ErrorDelete(err.error());
+  }
+  EXPECT_TRUE(batch.request_failed(1));
+  batch.finalize(nullptr);
+
+  EXPECT_THAT(fake_backend.sent_errors, ::testing::ElementsAre("bad request"));
+  EXPECT_EQ(fake_backend.sent_successes, 2);
+  EXPECT_EQ(fake_backend.released, requests);
+  EXPECT_THAT(reported, ::testing::ElementsAre(requests[0], requests[2]));
+}
+
+TEST(RapidsTriton, synthetic_batch)
+{
+  fake_backend    = fake_backend_calls{};
+  auto no_outputs = [](std::string const&, std::size_t) { return std::vector<std::size_t>{}; };
+  auto no_report  = [](TRITONBACKEND_Request*,
+                      time_point const&,
+                      time_point const&,
+                      time_point const&,
+                      time_point const&) {};
+  auto* memory_manager = reinterpret_cast<TRITONBACKEND_MemoryManager*>(&fake_backend);
+
+  // Warmup batches are constructed with no requests
+  auto batch = Batch(nullptr,
+                     request_size_t{},
+                     *memory_manager,
+                     no_outputs,
+                     no_report,
+                     false,
+                     false,
+                     8,
+                     cudaStream_t{});
+  batch.synthesize_inputs({input_spec{"input", DTypeFloat32, {-1, 3}, false}}, 5);
+
+  auto slice_rows = std::vector<std::size_t>{};
+  auto values     = std::vector<float>{};
+  batch.for_each_row_slice(2, [&slice_rows, &values](Batch& slice) {
+    auto input = slice.get_input<float const>("input", HostMemory, 0, cudaStream_t{});
+    ASSERT_EQ(input.shape().size(), 2);
+    EXPECT_EQ(input.shape()[1], 3);
+    slice_rows.push_back(input.shape()[0]);
+    values.insert(values.end(), input.data(), input.data() + input.size());
+  });
+  batch.finalize(nullptr);
+
+  EXPECT_THAT(slice_rows, ::testing::ElementsAre(2, 2, 1));
+  EXPECT_EQ(values.size(), 15);
+  EXPECT_THAT(values, ::testing::Each(0.0f));
+  // Synthetic batches have no responses to send or requests to release
+  EXPECT_EQ(fake_backend.sent_successes, 0);
+  EXPECT_TRUE(fake_backend.sent_errors.empty());
+  EXPECT_TRUE(fake_backend.released.empty());
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/batch/bucket.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, parse_batch_buckets)
+{
+  EXPECT_TRUE(parse_batch_buckets("").empty());
+  EXPECT_THAT(parse_batch_buckets("32, 8,128,8"), ::testing::ElementsAre(8, 32, 128));
+  EXPECT_THROW(parse_batch_buckets("8,,32"), TritonException);
+  EXPECT_THROW(parse_batch_buckets("8,0"), TritonException);
+  EXPECT_THROW(parse_batch_buckets("8,x"), TritonException);
+  EXPECT_THROW(parse_batch_buckets("8 16"), TritonException);
+}
+
+TEST(RapidsTriton, find_bucket)
+{
+  auto buckets = std::vector<std::size_t>{8, 32, 128};
+  EXPECT_EQ(find_bucket(buckets, 1), 8);
+  EXPECT_EQ(find_bucket(buckets, 8), 8);
+  EXPECT_EQ(find_bucket(buckets, 9), 32);
+  EXPECT_EQ(find_bucket(buckets, 128), 128);
+  EXPECT_FALSE(find_bucket(buckets, 129).has_value());
+  EXPECT_FALSE(find_bucket(std::vector<std::size_t>{}, 1).has_value());
+}
+
+TEST(RapidsTriton, dispatch_bucket)
+{
+  auto dispatched = std::size_t{};
+  EXPECT_TRUE((dispatch_bucket<8, 32>(32, [&](auto rows) { dispatched = decltype(rows)::value; })));
+  EXPECT_EQ(dispatched, 32);
+  EXPECT_FALSE((dispatch_bucket<8, 32>(16, [&](auto) { dispatched = 0; })));
+  EXPECT_EQ(dispatched, 32);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
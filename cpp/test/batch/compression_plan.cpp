@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/batch/compression_plan.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, parse_compressed_input)
+{
+  auto input = parse_compressed_input("zstd:512");
+  EXPECT_EQ(input.codec, compression_codec::zstd);
+  EXPECT_EQ(input.row_elements, 512);
+  EXPECT_EQ(parse_compressed_input("lz4:1").codec, compression_codec::lz4);
+
+  EXPECT_THROW(parse_compressed_input("lz4"), TritonException);
+  EXPECT_THROW(parse_compressed_input("gzip:512"), TritonException);
+  EXPECT_THROW(parse_compressed_input("zstd:0"), TritonException);
+  EXPECT_THROW(parse_compressed_input("zstd:-4"), TritonException);
+  EXPECT_THROW(parse_compressed_input("zstd:4x"), TritonException);
+}
+
+TEST(RapidsTriton, make_compression_plan)
+{
+  auto plan = make_compression_plan(std::vector<std::pair<std::string, std::string>>{
+    {"input_compression:y", "lz4:8"},
+    {"input_transform:x", "scale:2"},
+    {"input_compression:x", "zstd:16"}});
+  ASSERT_EQ(plan.inputs.size(), 2);
+  ASSERT_NE(plan.input("x"), nullptr);
+  EXPECT_EQ(plan.input("x")->codec, compression_codec::zstd);
+  EXPECT_EQ(plan.input("x")->row_elements, 16);
+  ASSERT_NE(plan.input("y"), nullptr);
+  EXPECT_EQ(plan.input("y")->codec, compression_codec::lz4);
+  EXPECT_EQ(plan.input("z"), nullptr);
+
+  EXPECT_TRUE(make_compression_plan({{"input_transform:x", "scale:2"}}).empty());
+  EXPECT_THROW(make_compression_plan({{"input_compression:x", "zstd"}}), TritonException);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
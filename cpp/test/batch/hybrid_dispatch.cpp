@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <rapids_triton/batch/hybrid_dispatch.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, learn_host_threshold)
+{
+  using us = std::chrono::microseconds;
+  // Sizes are considered in order of rows, whatever order they were measured
+  auto samples = std::vector<dispatch_sample>{{64, us{90}, us{100}},
+                                              {1, us{10}, us{100}},
+                                              {1024, us{900}, us{200}},
+                                              {8, us{20}, us{100}}};
+  EXPECT_EQ(learn_host_threshold(samples), 64);
+
+  // A size faster on the device ends the range sent to the host, even if a
+  // larger size is faster on the host
+  samples = std::vector<dispatch_sample>{
+    {1, us{10}, us{100}}, {8, us{200}, us{100}}, {64, us{50}, us{100}}};
+  EXPECT_EQ(learn_host_threshold(samples), 1);
+
+  samples = std::vector<dispatch_sample>{{1, us{200}, us{100}}};
+  EXPECT_EQ(learn_host_threshold(samples), 0);
+  EXPECT_EQ(learn_host_threshold(std::vector<dispatch_sample>{}), 0);
+}
+
+TEST(RapidsTriton, hybrid_dispatch)
+{
+  auto learned = hybrid_dispatch{};
+  EXPECT_TRUE(learned.needs_calibration());
+  EXPECT_FALSE(learned.to_host(1));
+  learned.calibrate({{1, std::chrono::microseconds{10}, std::chrono::microseconds{100}},
+                     {16, std::chrono::microseconds{50}, std::chrono::microseconds{100}}});
+  EXPECT_EQ(learned.max_host_rows(), 16);
+  EXPECT_TRUE(learned.to_host(16));
+  EXPECT_FALSE(learned.to_host(17));
+  EXPECT_FALSE(learned.to_host(0));
+
+  auto configured = hybrid_dispatch{32};
+  EXPECT_FALSE(configured.needs_calibration());
+  EXPECT_TRUE(configured.to_host(32));
+  EXPECT_FALSE(configured.to_host(33));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
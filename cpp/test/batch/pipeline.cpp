@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <rapids_triton/batch/pipeline.hpp>
+#include <rapids_triton/triton/deployment.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, batch_pipeline)
+{
+  auto completed = std::vector<int>{};
+  {
+    auto pipeline = batch_pipeline{3, 0, CPUDeployment, cudaStream_t{}};
+    EXPECT_EQ(pipeline.next_stream(), cudaStream_t{});
+    for (auto i = 0; i < 10; ++i) {
+      pipeline.submit([&completed, i]() { completed.push_back(i); });
+    }
+    pipeline.drain();
+    EXPECT_EQ(completed.size(), 10);
+    pipeline.submit([&completed]() { completed.push_back(10); });
+  }
+  // Work submitted before the pipeline is destroyed should still complete
+  EXPECT_THAT(completed, ::testing::ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+}
+
+TEST(RapidsTriton, completion_only_pipeline)
+{
+  auto completed = std::vector<int>{};
+  {
+    // A pipeline of depth 1 reuses the default stream for every batch
+    auto pipeline = batch_pipeline{1, 0, CPUDeployment, cudaStream_t{}};
+    EXPECT_EQ(pipeline.next_stream(), cudaStream_t{});
+    EXPECT_EQ(pipeline.next_stream(), cudaStream_t{});
+    for (auto i = 0; i < 3; ++i) {
+      pipeline.submit([&completed, i]() { completed.push_back(i); });
+    }
+  }
+  EXPECT_THAT(completed, ::testing::ElementsAre(0, 1, 2));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/batch/predict_graph.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, predict_graph_cache)
+{
+  auto graphs = predict_graph_cache{48};
+  EXPECT_EQ(graphs.bucket_rows(1), 1);
+  EXPECT_EQ(graphs.bucket_rows(3), 4);
+  EXPECT_EQ(graphs.bucket_rows(16), 16);
+  EXPECT_EQ(graphs.bucket_rows(17), 32);
+  EXPECT_EQ(graphs.bucket_rows(33), 48);
+
+  auto& graph = graphs.get(5);
+  EXPECT_EQ(graph.rows(), 8);
+  EXPECT_EQ(&graphs.get(7), &graph);
+  EXPECT_NE(&graphs.get(9), &graph);
+  EXPECT_EQ(graph.get_status(), predict_graph::status::unrecorded);
+}
+
+TEST(RapidsTriton, predict_graph_cache_buckets)
+{
+  auto graphs = predict_graph_cache{64, {12, 40}};
+  EXPECT_EQ(graphs.bucket_rows(1), 12);
+  EXPECT_EQ(graphs.bucket_rows(12), 12);
+  EXPECT_EQ(graphs.bucket_rows(13), 40);
+  EXPECT_EQ(graphs.bucket_rows(41), 64);
+  EXPECT_EQ(graphs.get(20).rows(), 40);
+}
+
+TEST(RapidsTriton, predict_graph)
+{
+  auto graph = predict_graph{4};
+  graph.inputs().push_back(graph_tensor{"input", DTypeFloat32, {4, 2}, std::nullopt, 0, {}, {}});
+  EXPECT_NE(graph.find_input("input", DTypeFloat32), nullptr);
+  EXPECT_EQ(graph.find_input("input", DTypeInt32), nullptr);
+  EXPECT_EQ(graph.find_output("input", DTypeFloat32), nullptr);
+
+  // A recording which requested no outputs cannot be captured
+  graph.finish_recording();
+  EXPECT_EQ(graph.get_status(), predict_graph::status::disabled);
+  EXPECT_TRUE(graph.inputs().empty());
+
+  auto recorded = predict_graph{4};
+  recorded.inputs().push_back(graph_tensor{"input", DTypeFloat32, {4}, std::nullopt, 0, {}, {}});
+  recorded.outputs().push_back(
+    graph_tensor{"output", DTypeFloat32, {4}, std::nullopt, 0, {}, {}});
+  recorded.finish_recording();
+  EXPECT_EQ(recorded.get_status(), predict_graph::status::recorded);
+  recorded.disable();
+  EXPECT_EQ(recorded.get_status(), predict_graph::status::disabled);
+  EXPECT_TRUE(recorded.outputs().empty());
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
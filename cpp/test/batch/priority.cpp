@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <rapids_triton/batch/priority.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, latency_estimator)
+{
+  auto estimator = latency_estimator{};
+  EXPECT_EQ(estimator.estimate(100).count(), 0);
+
+  estimator.observe(10, std::chrono::microseconds{100});
+  EXPECT_EQ(estimator.estimate(100).count(), 1000);
+
+  // Later observations move the estimate only part of the way
+  estimator.observe(10, std::chrono::microseconds{900});
+  EXPECT_EQ(estimator.estimate(100).count(), 2000);
+
+  estimator.observe(0, std::chrono::microseconds{100000});
+  EXPECT_EQ(estimator.estimate(100).count(), 2000);
+}
+
+TEST(RapidsTriton, partition_urgent)
+{
+  using time_point = std::chrono::steady_clock::time_point;
+  auto now         = std::chrono::steady_clock::now();
+  auto requests    = std::vector<int>{0, 1, 2, 3, 4};
+  auto deadlines   = std::vector<std::optional<time_point>>{
+    std::nullopt, now + std::chrono::milliseconds{2}, std::nullopt, now, std::nullopt};
+
+  EXPECT_EQ(partition_urgent(requests, deadlines), 2);
+  EXPECT_THAT(requests, ::testing::ElementsAre(1, 3, 0, 2, 4));
+  EXPECT_EQ(deadlines[0], now + std::chrono::milliseconds{2});
+  EXPECT_EQ(deadlines[1], now);
+  EXPECT_FALSE(deadlines[2].has_value());
+
+  auto bulk           = std::vector<int>{0, 1};
+  auto bulk_deadlines = std::vector<std::optional<time_point>>(2);
+  EXPECT_EQ(partition_urgent(bulk, bulk_deadlines), 0);
+  EXPECT_THAT(bulk, ::testing::ElementsAre(0, 1));
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
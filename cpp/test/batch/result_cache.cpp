@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/batch/result_cache.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <thread>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace {
+auto make_result(std::byte value)
+{
+  auto data      = Buffer<std::byte>(std::size_t{4}, HostMemory);
+  data.data()[0] = value;
+  auto result    = cached_result{};
+  result.push_back(cached_output{"output__0", DTypeUint8, {4}, std::move(data)});
+  return result;
+}
+}  // namespace
+
+TEST(RapidsTriton, hash_bytes)
+{
+  auto data    = std::vector<std::uint8_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  auto other   = data;
+  other.back() = 12;
+  auto hash    = detail::hash_bytes(detail::hash_seed, data.data(), data.size());
+  EXPECT_EQ(hash, detail::hash_bytes(detail::hash_seed, data.data(), data.size()));
+  EXPECT_NE(hash, detail::hash_bytes(detail::hash_seed, other.data(), other.size()));
+  EXPECT_NE(hash, detail::hash_bytes(detail::hash_seed, data.data(), data.size() - 1));
+  EXPECT_EQ(detail::hash_bytes(detail::hash_seed, data.data(), 0), detail::hash_seed);
+}
+
+TEST(RapidsTriton, result_cache)
+{
+  EXPECT_THROW(result_cache(0), TritonException);
+
+  auto key1 = make_request_key("1");
+  auto key2 = make_request_key("2");
+  auto key3 = make_request_key("3");
+
+  auto cache = result_cache{2};
+  EXPECT_EQ(cache.find(key1), nullptr);
+  cache.insert(key1, make_result(std::byte{1}));
+  cache.insert(key2, make_result(std::byte{2}));
+  ASSERT_NE(cache.find(key1), nullptr);
+  EXPECT_EQ(cache.find(key1)->at(0).data.data()[0], std::byte{1});
+  EXPECT_EQ(cache.find(key1)->at(0).shape, std::vector<std::size_t>{4});
+
+  // key2 is now the least-recently used entry
+  cache.insert(key3, make_result(std::byte{3}));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.find(key2), nullptr);
+  EXPECT_NE(cache.find(key1), nullptr);
+  EXPECT_NE(cache.find(key3), nullptr);
+
+  cache.insert(key3, make_result(std::byte{4}));
+  EXPECT_EQ(cache.find(key3)->at(0).data.data()[0], std::byte{4});
+  EXPECT_EQ(cache.size(), 2);
+
+  // A key whose hash collides with a cached one must not receive its result
+  auto collision = request_key{key1.hash, "not 1"};
+  EXPECT_EQ(cache.find(collision), nullptr);
+  cache.insert(collision, make_result(std::byte{5}));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.find(key1), nullptr);
+  ASSERT_NE(cache.find(collision), nullptr);
+  EXPECT_EQ(cache.find(collision)->at(0).data.data()[0], std::byte{5});
+
+  auto expiring = result_cache{2, std::chrono::milliseconds{1}};
+  expiring.insert(key1, make_result(std::byte{1}));
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  EXPECT_EQ(expiring.find(key1), nullptr);
+  EXPECT_EQ(expiring.size(), 0);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rapids_triton/batch/transform_plan.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, parse_transform_stages)
+{
+  auto inputs = parse_transform_stages("columns:2:0:1, scale:0.5,offset:-1", false);
+  ASSERT_EQ(inputs.size(), 3);
+  EXPECT_EQ(inputs[0].op, transform_op::columns);
+  EXPECT_THAT(inputs[0].args, ::testing::ElementsAre(2.0, 0.0, 1.0));
+  EXPECT_EQ(inputs[1].op, transform_op::scale);
+  EXPECT_THAT(inputs[1].args, ::testing::ElementsAre(0.5));
+  EXPECT_EQ(inputs[2].op, transform_op::offset);
+  EXPECT_THAT(inputs[2].args, ::testing::ElementsAre(-1.0));
+
+  auto outputs = parse_transform_stages("softmax,threshold:0.5,fp16", true);
+  ASSERT_EQ(outputs.size(), 3);
+  EXPECT_EQ(outputs[0].op, transform_op::softmax);
+  EXPECT_EQ(outputs[1].op, transform_op::threshold);
+  EXPECT_EQ(outputs[2].op, transform_op::fp16);
+
+  EXPECT_TRUE(parse_transform_stages("", true).empty());
+  // Stages are specific to inputs or outputs
+  EXPECT_THROW(parse_transform_stages("softmax", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("scale:2", true), TritonException);
+  // Columns must come first and casts last
+  EXPECT_THROW(parse_transform_stages("scale:2,columns:1:0", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("fp16,sigmoid", true), TritonException);
+  EXPECT_THROW(parse_transform_stages("columns:1:-1", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("columns:0.5", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("scale:0", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("scale", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("offset:x", false), TritonException);
+  EXPECT_THROW(parse_transform_stages("sigmoid:1", true), TritonException);
+  EXPECT_THROW(parse_transform_stages("sigmoid,,fp32", true), TritonException);
+}
+
+TEST(RapidsTriton, make_transform_plan)
+{
+  auto parameters = std::vector<std::pair<std::string, std::string>>{
+    {"input_transform:input__0", "scale:2"},
+    {"max_batch_size", "8"},
+    {"output_transform:output__1", "sigmoid"},
+    {"output_transform:output__0", "softmax,fp16"}};
+  auto plan = make_transform_plan(parameters);
+  EXPECT_FALSE(plan.empty());
+  ASSERT_NE(plan.input_stages("input__0"), nullptr);
+  EXPECT_EQ(plan.input_stages("input__0")->front().op, transform_op::scale);
+  EXPECT_EQ(plan.input_stages("input__1"), nullptr);
+  EXPECT_EQ(plan.input_stages("output__0"), nullptr);
+  ASSERT_NE(plan.output_stages("output__0"), nullptr);
+  EXPECT_EQ(plan.output_stages("output__0")->size(), 2);
+  ASSERT_NE(plan.output_stages("output__1"), nullptr);
+  EXPECT_EQ(plan.output_stages("output__1")->front().op, transform_op::sigmoid);
+
+  EXPECT_TRUE(make_transform_plan({{"max_batch_size", "8"}}).empty());
+  EXPECT_THROW(make_transform_plan({{"output_transform:output__0", "scale:2"}}), TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -29,6 +29,16 @@ TEST(RapidsTriton, build_control)
 #else
   ASSERT_EQ(IS_GPU_BUILD, false) << "IS_GPU_BUILD constant has wrong value\n";
 #endif
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_NVTX)
+  ASSERT_EQ(IS_NVTX_BUILD, true) << "IS_NVTX_BUILD constant has wrong value\n";
+#else
+  ASSERT_EQ(IS_NVTX_BUILD, false) << "IS_NVTX_BUILD constant has wrong value\n";
+#endif
+#ifdef RAPIDS_TRITON_ENABLE_METRICS
+  ASSERT_EQ(IS_METRICS_BUILD, true) << "IS_METRICS_BUILD constant has wrong value\n";
+#else
+  ASSERT_EQ(IS_METRICS_BUILD, false) << "IS_METRICS_BUILD constant has wrong value\n";
+#endif
 }
 }  // namespace rapids
 }  // namespace backend
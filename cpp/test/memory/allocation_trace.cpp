@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <rapids_triton/memory/allocation_trace.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <string>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, allocation_trace)
+{
+  auto trace = std::make_shared<allocation_trace>("model");
+  {
+    auto allocation = detail::traced_allocation{allocation_location::host, 64, cudaStream_t{}};
+    EXPECT_EQ(trace->live_bytes(), 0);
+  }
+  {
+    auto scope = scoped_allocation_trace{trace};
+    auto site  = scoped_allocation_site{allocation_site::input};
+    {
+      // The outermost site takes precedence
+      auto inner      = scoped_allocation_site{allocation_site::scratch};
+      auto allocation = detail::traced_allocation{allocation_location::device, 100, cudaStream_t{}};
+      auto moved      = std::move(allocation);
+      EXPECT_EQ(trace->live_bytes(), 100);
+    }
+    auto buffer = Buffer<char>(std::size_t{4096}, HostMemory);
+    EXPECT_EQ(trace->live_bytes(), 4096);
+  }
+  EXPECT_EQ(trace->live_bytes(), 0);
+  EXPECT_EQ(trace->peak_bytes(), 4096);
+  EXPECT_EQ(trace->allocation_count(allocation_site::input, allocation_location::device), 1);
+  EXPECT_EQ(trace->allocation_count(allocation_site::scratch, allocation_location::device), 0);
+  EXPECT_EQ(trace->allocation_count(allocation_site::input, allocation_location::host), 1);
+
+  auto report = trace->report();
+  EXPECT_NE(report.find("model"), std::string::npos);
+  EXPECT_NE(report.find("input device: 1 allocations, 100 bytes"), std::string::npos);
+  EXPECT_FALSE(trace->dump_requested());
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
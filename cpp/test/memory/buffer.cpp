@@ -20,11 +20,13 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstring>
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
 #include <rapids_triton/memory/buffer.hpp>
 #include <rapids_triton/memory/types.hpp>
+#include <utility>
 #include <vector>
 
 namespace triton {
@@ -102,6 +104,63 @@ TEST(RapidsTriton, non_owning_device_buffer)
 #endif
 }
 
+TEST(RapidsTriton, buffer_stream_handoff)
+{
+  auto data = std::vector<int>{1, 2, 3};
+#ifdef TRITON_ENABLE_GPU
+  auto stream_a = cudaStream_t{};
+  auto stream_b = cudaStream_t{};
+  cudaStreamCreate(&stream_a);
+  cudaStreamCreate(&stream_b);
+  {
+    auto src = Buffer<int>(data.data(), data.size(), HostMemory, 0, stream_a);
+    auto dst = Buffer<int>(data.size(), DeviceMemory, 0, stream_a);
+    copy(dst, src);
+
+    // Work on the new stream must be ordered after the copy on the old one
+    dst.set_stream(stream_b);
+    EXPECT_EQ(dst.stream(), stream_b);
+    auto out = Buffer<int>(data.size(), HostMemory, 0, stream_b);
+    copy(out, dst);
+    out.stream_synchronize();
+    EXPECT_THAT(std::vector<int>(out.data(), out.data() + out.size()),
+                ::testing::ElementsAreArray(data));
+  }
+  cudaStreamSynchronize(stream_b);
+  cudaStreamDestroy(stream_a);
+  cudaStreamDestroy(stream_b);
+#else
+  auto buffer = Buffer<int>(data.data(), data.size(), HostMemory);
+  buffer.set_stream(cudaStream_t{});
+  EXPECT_EQ(buffer.stream(), cudaStream_t{});
+#endif
+}
+
+TEST(RapidsTriton, buffer_to_device)
+{
+  auto data   = std::vector<int>{1, 2, 3};
+  auto buffer = Buffer<int>(data.data(), data.size(), HostMemory);
+#ifdef TRITON_ENABLE_GPU
+  auto device_buffer = buffer.to_device(0);
+  EXPECT_EQ(device_buffer.mem_type(), DeviceMemory);
+  EXPECT_EQ(device_buffer.device(), 0);
+  EXPECT_NE(device_buffer.data(), buffer.data());
+
+  auto device_count = int{};
+  cudaGetDeviceCount(&device_count);
+  auto target      = device_count > 1 ? 1 : 0;
+  auto peer_buffer = device_buffer.to_device(target);
+  EXPECT_EQ(peer_buffer.device(), target);
+
+  auto out = Buffer<int>(peer_buffer, HostMemory);
+  out.stream_synchronize();
+  EXPECT_THAT(std::vector<int>(out.data(), out.data() + out.size()),
+              ::testing::ElementsAreArray(data));
+#else
+  EXPECT_THROW(buffer.to_device(0), TritonException);
+#endif
+}
+
 TEST(RapidsTriton, host_buffer)
 {
   auto data   = std::vector<int>{1, 2, 3};
@@ -131,6 +190,55 @@ TEST(RapidsTriton, non_owning_host_buffer)
   EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
 }
 
+TEST(RapidsTriton, inline_host_buffer)
+{
+  auto data   = std::vector<int>{1, 2, 3};
+  auto buffer = Buffer<int>(data.size(), HostMemory);
+  std::copy(std::begin(data), std::end(data), buffer.data());
+
+  auto moved = std::move(buffer);
+  ASSERT_EQ(moved.mem_type(), HostMemory);
+  ASSERT_EQ(moved.size(), data.size());
+  auto data_out = std::vector<int>(moved.data(), moved.data() + moved.size());
+  EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+
+  // Buffers too large to be stored inline are allocated as usual
+  auto large       = Buffer<int>(std::size_t{1024}, HostMemory);
+  auto* raw        = large.data();
+  auto large_moved = std::move(large);
+  EXPECT_EQ(large_moved.data(), raw);
+}
+
+TEST(RapidsTriton, pinned_buffer)
+{
+  auto data   = std::vector<int>{1, 2, 3};
+  auto buffer = Buffer<int>(data.size(), PinnedMemory, 0, 0);
+
+  ASSERT_EQ(buffer.mem_type(), IS_GPU_BUILD ? PinnedMemory : HostMemory);
+  ASSERT_EQ(buffer.size(), data.size());
+  ASSERT_NE(buffer.data(), nullptr);
+
+  std::memcpy(
+    static_cast<void*>(buffer.data()), static_cast<void*>(data.data()), data.size() * sizeof(int));
+
+  auto host_buffer = Buffer<int>(buffer, HostMemory);
+  ASSERT_EQ(host_buffer.mem_type(), HostMemory);
+  auto data_out = std::vector<int>(host_buffer.data(), host_buffer.data() + host_buffer.size());
+  EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+}
+
+TEST(RapidsTriton, non_owning_pinned_buffer)
+{
+  auto data   = std::vector<int>{1, 2, 3};
+  auto buffer = Buffer<int>(data.data(), data.size(), PinnedMemory);
+
+  ASSERT_EQ(buffer.mem_type(), PinnedMemory);
+  ASSERT_EQ(buffer.data(), data.data());
+  EXPECT_TRUE(is_host_memory(buffer.mem_type()));
+  EXPECT_TRUE(satisfies_memory_type(buffer.mem_type(), HostMemory));
+  EXPECT_FALSE(satisfies_memory_type(HostMemory, PinnedMemory));
+}
+
 TEST(RapidsTriton, copy_buffer)
 {
   auto data        = std::vector<int>{1, 2, 3};
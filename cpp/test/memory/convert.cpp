@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/convert.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, convert_buffer)
+{
+  auto data   = std::vector<double>{1.0, -2.5, 3.25};
+  auto source = Buffer<double>(data.data(), data.size(), HostMemory);
+
+  auto floats = Buffer<float>(data.size(), HostMemory);
+  convert(floats, source);
+  EXPECT_THAT(std::vector<float>(floats.data(), floats.data() + floats.size()),
+              ::testing::ElementsAre(1.0f, -2.5f, 3.25f));
+
+  auto ints = Buffer<std::int32_t>(data.size(), HostMemory);
+  convert(ints, source);
+  EXPECT_THAT(std::vector<std::int32_t>(ints.data(), ints.data() + ints.size()),
+              ::testing::ElementsAre(1, -2, 3));
+
+  auto halves = Buffer<__half>(data.size(), HostMemory);
+  convert(halves, source);
+  auto round_trip = Buffer<float>(data.size(), HostMemory);
+  convert(round_trip, halves);
+  EXPECT_THAT(std::vector<float>(round_trip.data(), round_trip.data() + round_trip.size()),
+              ::testing::ElementsAre(1.0f, -2.5f, 3.25f));
+
+  auto too_small = Buffer<float>(data.size() - 1, HostMemory);
+  EXPECT_THROW(convert(too_small, source), TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cuda_fp16.h>
+#include <cuda_runtime_api.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/convert.cuh>
+#include <rapids_triton/memory/convert.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+namespace {
+auto device_available()
+{
+  auto device_count = int{};
+  return cudaGetDeviceCount(&device_count) == cudaSuccess && device_count > 0;
+}
+
+template <typename T>
+auto to_host(Buffer<T> const& buffer)
+{
+  auto result = Buffer<T>(buffer, HostMemory);
+  result.stream_synchronize();
+  return std::vector<T>(result.data(), result.data() + result.size());
+}
+}  // namespace
+
+TEST(RapidsTriton, device_convert_buffer)
+{
+  if (!device_available()) { GTEST_SKIP() << "Device conversion requires a device"; }
+  register_device_conversion<float, double>();
+  register_device_conversion<std::int32_t, double>();
+  register_device_conversion<__half, double>();
+  register_device_conversion<float, __half>();
+
+  // More elements than one block of threads converts
+  auto data = std::vector<double>(1000);
+  for (auto i = std::size_t{}; i < data.size(); ++i) {
+    data[i] = static_cast<double>(i % 41) * 0.25 - 5.0;
+  }
+  auto source        = Buffer<double>(data.data(), data.size(), HostMemory);
+  auto device_source = Buffer<double>(source, DeviceMemory);
+
+  auto floats = Buffer<float>(data.size(), HostMemory);
+  convert(floats, source);
+  auto device_floats = Buffer<float>(data.size(), DeviceMemory);
+  convert(device_floats, device_source);
+  EXPECT_THAT(to_host(device_floats), ::testing::ElementsAreArray(floats.data(), floats.size()));
+
+  auto ints = Buffer<std::int32_t>(data.size(), HostMemory);
+  convert(ints, source);
+  auto device_ints = Buffer<std::int32_t>(data.size(), DeviceMemory);
+  convert(device_ints, device_source);
+  EXPECT_THAT(to_host(device_ints), ::testing::ElementsAreArray(ints.data(), ints.size()));
+
+  // Every value is a multiple of 0.25 small enough to be exact in halves
+  auto halves = Buffer<__half>(data.size(), HostMemory);
+  convert(halves, source);
+  auto round_trip = Buffer<float>(data.size(), HostMemory);
+  convert(round_trip, halves);
+  auto device_halves = Buffer<__half>(data.size(), DeviceMemory);
+  convert(device_halves, device_source);
+  auto device_round_trip = Buffer<float>(data.size(), DeviceMemory);
+  convert(device_round_trip, device_halves);
+  EXPECT_THAT(to_host(device_round_trip),
+              ::testing::ElementsAreArray(round_trip.data(), round_trip.size()));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
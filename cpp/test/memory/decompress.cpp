@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+#ifdef RAPIDS_TRITON_ENABLE_COMPRESSION
+#include <lz4.h>
+#include <zstd.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/compression_codec.hpp>
+#include <rapids_triton/memory/decompress.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/string_tensor.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <string>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace {
+/* Serialize rows in Triton's BYTES format */
+auto serialize(std::vector<std::string> const& rows)
+{
+  auto result = std::string{};
+  for (auto const& row : rows) {
+    auto length = static_cast<std::uint32_t>(row.size());
+    for (auto i = 0; i < 4; ++i) {
+      result.push_back(static_cast<char>((length >> (8 * i)) & 0xff));
+    }
+    result += row;
+  }
+  return result;
+}
+
+#ifdef RAPIDS_TRITON_ENABLE_COMPRESSION
+auto compress(compression_codec codec, std::vector<float> const& row)
+{
+  auto const* src = reinterpret_cast<char const*>(row.data());
+  auto bytes      = row.size() * sizeof(float);
+  auto result     = std::string{};
+  if (codec == compression_codec::lz4) {
+    result.resize(LZ4_compressBound(static_cast<int>(bytes)));
+    result.resize(LZ4_compress_default(
+      src, result.data(), static_cast<int>(bytes), static_cast<int>(result.size())));
+  } else {
+    result.resize(ZSTD_compressBound(bytes));
+    result.resize(ZSTD_compress(result.data(), result.size(), src, bytes, 1));
+  }
+  return result;
+}
+#endif
+}  // namespace
+
+TEST(RapidsTriton, decompress_rows)
+{
+  auto rows      = std::vector<std::vector<float>>{{1, 2, 3, 4}, {0, 0, 0, 0}, {5, 5, 5, 6}};
+  auto row_bytes = rows[0].size() * sizeof(float);
+  for (auto codec : {compression_codec::lz4, compression_codec::zstd}) {
+    auto compressed = std::vector<std::string>{};
+#ifdef RAPIDS_TRITON_ENABLE_COMPRESSION
+    for (auto const& row : rows) {
+      compressed.push_back(compress(codec, row));
+    }
+#else
+    compressed.assign(rows.size(), std::string(4, 'x'));
+#endif
+    auto serialized = serialize(compressed);
+    auto tensor     = parse_serialized_strings(
+      std::vector<std::size_t>{rows.size()}, serialized.data(), serialized.size());
+    auto result = std::vector<float>(rows.size() * rows[0].size());
+    auto dst    = Buffer<std::byte>(
+      reinterpret_cast<std::byte*>(result.data()), result.size() * sizeof(float), HostMemory);
+    if constexpr (detail::host_decompression_available) {
+      auto pool = thread_pool{2};
+      decompress_rows(dst, tensor, codec, row_bytes, &pool);
+      for (auto i = std::size_t{}; i < rows.size(); ++i) {
+        EXPECT_EQ(std::memcmp(result.data() + i * rows[i].size(), rows[i].data(), row_bytes), 0);
+      }
+      // Rows must decompress to exactly the expected size
+      auto short_dst = Buffer<std::byte>(
+        reinterpret_cast<std::byte*>(result.data()), rows.size() * 2 * sizeof(float), HostMemory);
+      EXPECT_THROW(decompress_rows(short_dst, tensor, codec, 2 * sizeof(float)), TritonException);
+    } else {
+      EXPECT_THROW(decompress_rows(dst, tensor, codec, row_bytes), TritonException);
+    }
+  }
+}
+
+#if defined(TRITON_ENABLE_GPU) && defined(RAPIDS_TRITON_ENABLE_COMPRESSION)
+TEST(RapidsTriton, device_decompress_rows)
+{
+  auto device_count = int{};
+  if (!detail::device_decompression_available || cudaGetDeviceCount(&device_count) != cudaSuccess ||
+      device_count < 1) {
+    GTEST_SKIP() << "Device decompression requires nvCOMP and a device";
+  }
+  auto rows      = std::vector<std::vector<float>>{{1, 2, 3, 4}, {0, 0, 0, 0}, {5, 5, 5, 6}};
+  auto row_bytes = rows[0].size() * sizeof(float);
+  for (auto codec : {compression_codec::lz4, compression_codec::zstd}) {
+    auto compressed = std::vector<std::string>{};
+    for (auto const& row : rows) {
+      compressed.push_back(compress(codec, row));
+    }
+    auto serialized = serialize(compressed);
+    auto tensor     = parse_serialized_strings(
+      std::vector<std::size_t>{rows.size()}, serialized.data(), serialized.size());
+    auto dst = Buffer<std::byte>(rows.size() * row_bytes, DeviceMemory);
+    decompress_rows(dst, tensor, codec, row_bytes);
+    auto result = Buffer<std::byte>(dst, HostMemory);
+    result.stream_synchronize();
+    for (auto i = std::size_t{}; i < rows.size(); ++i) {
+      EXPECT_EQ(std::memcmp(result.data() + i * row_bytes, rows[i].data(), row_bytes), 0);
+    }
+    // Rows are checked once decompression is complete
+    auto short_dst = Buffer<std::byte>(rows.size() * 2 * sizeof(float), DeviceMemory);
+    EXPECT_THROW(decompress_rows(short_dst, tensor, codec, 2 * sizeof(float)), TritonException);
+  }
+}
+#endif
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
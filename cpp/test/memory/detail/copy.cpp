@@ -57,6 +57,39 @@ TEST(RapidsTriton, copy)
 #endif
 }
 
+TEST(RapidsTriton, peer_copy)
+{
+  auto data     = std::vector<int>{1, 2, 3};
+  auto data_out = std::vector<int>(data.size());
+  detail::copy(data_out.data(), data.data(), data.size(), 0, HostMemory, HostMemory, 0, 1);
+  EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+#ifdef TRITON_ENABLE_GPU
+  auto device_count = int{};
+  cudaGetDeviceCount(&device_count);
+  if (device_count < 2) { GTEST_SKIP() << "Peer copies require at least two devices"; }
+
+  auto* ptr_0 = static_cast<int*>(nullptr);
+  auto* ptr_1 = static_cast<int*>(nullptr);
+  cudaSetDevice(0);
+  cudaMalloc(reinterpret_cast<void**>(&ptr_0), sizeof(int) * data.size());
+  cudaMemcpy(ptr_0, data.data(), sizeof(int) * data.size(), cudaMemcpyHostToDevice);
+  cudaSetDevice(1);
+  cudaMalloc(reinterpret_cast<void**>(&ptr_1), sizeof(int) * data.size());
+  cudaSetDevice(0);
+
+  detail::copy(ptr_1, ptr_0, data.size(), 0, DeviceMemory, DeviceMemory, 1, 0);
+  cudaDeviceSynchronize();
+  data_out = std::vector<int>(data.size());
+  cudaMemcpy(data_out.data(), ptr_1, sizeof(int) * data.size(), cudaMemcpyDeviceToHost);
+  EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+
+  cudaFree(ptr_0);
+  cudaSetDevice(1);
+  cudaFree(ptr_1);
+  cudaSetDevice(0);
+#endif
+}
+
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <numeric>
+#include <rapids_triton/memory/detail/host_copy.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, host_copy)
+{
+  // Unaligned ends around the non-temporal path
+  auto bytes = detail::non_temporal_copy_bytes + 37;
+  auto data  = std::vector<unsigned char>(bytes + 1);
+  std::iota(std::begin(data), std::end(data), 0);
+  auto data_out = std::vector<unsigned char>(bytes + 1);
+  detail::host_copy(data_out.data() + 1, data.data() + 1, bytes);
+  EXPECT_EQ(data_out[0], 0);
+  EXPECT_TRUE(std::equal(std::begin(data) + 1, std::end(data), std::begin(data_out) + 1));
+
+  detail::host_copy(nullptr, nullptr, 0);
+}
+
+TEST(RapidsTriton, host_copy_segments)
+{
+  auto small      = std::vector<int>{1, 2, 3};
+  auto small_out  = std::vector<int>(small.size());
+  auto empty      = std::vector<int>{};
+  auto large_size = detail::parallel_copy_bytes / sizeof(int) + 5;
+  auto large      = std::vector<int>(large_size);
+  std::iota(std::begin(large), std::end(large), 0);
+  auto large_out = std::vector<int>(large_size);
+
+  auto segments = std::vector<detail::host_copy_segment>{
+    {small_out.data(), small.data(), small.size() * sizeof(int)},
+    {empty.data(), empty.data(), 0},
+    {large_out.data(), large.data(), large_size * sizeof(int)}};
+  detail::host_copy(segments.data(), segments.data() + segments.size());
+  EXPECT_THAT(small_out, ::testing::ElementsAreArray(small));
+  EXPECT_EQ(large_out, large);
+
+  small_out = std::vector<int>(small.size());
+  large_out = std::vector<int>(large_size);
+  auto copies = detail::host_copy_list{(small.size() + large_size) * sizeof(int)};
+  copies.add(large_out.data(), large.data(), large_size * sizeof(int));
+  copies.add(small_out.data(), small.data(), small.size() * sizeof(int));
+  copies.flush();
+  EXPECT_THAT(small_out, ::testing::ElementsAreArray(small));
+  EXPECT_EQ(large_out, large);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
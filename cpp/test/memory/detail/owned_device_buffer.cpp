@@ -25,6 +25,8 @@
 
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/memory_budget.hpp>
+#include <memory>
 #include <vector>
 
 namespace triton {
@@ -50,6 +52,17 @@ TEST(RapidsTriton, owned_device_buffer)
              sizeof(int) * data.size(),
              cudaMemcpyDeviceToHost);
   EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+
+  auto budget = std::make_shared<memory_budget>(device_id, sizeof(int) * data.size());
+  {
+    auto scope    = scoped_memory_budget{budget};
+    auto budgeted = detail::owned_device_buffer<int, IS_GPU_BUILD>(device_id, data.size(), stream);
+    EXPECT_EQ(budget->current(), sizeof(int) * data.size());
+    using dev_buffer = detail::owned_device_buffer<int, IS_GPU_BUILD>;
+    EXPECT_THROW(dev_buffer(device_id, 1, stream), TritonException);
+  }
+  EXPECT_EQ(budget->current(), 0);
+  EXPECT_EQ(budget->peak(), sizeof(int) * data.size());
   cudaStreamDestroy(stream);
 #else
   // Workaround for ungraceful handling of multiple template parameters in
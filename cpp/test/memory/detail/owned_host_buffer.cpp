@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <rapids_triton/memory/detail/host_resource.hpp>
+#include <rapids_triton/memory/detail/owned_host_buffer.hpp>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, owned_host_buffer)
+{
+  auto data = std::vector<int>{1, 2, 3};
+  auto mr   = detail::pageable_host_resource{};
+
+  auto buffer = detail::owned_host_buffer<int>(data.size(), cudaStream_t{}, &mr);
+  std::copy(std::begin(data), std::end(data), buffer.get());
+  auto data_out = std::vector<int>(buffer.get(), buffer.get() + data.size());
+  EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+
+  auto* ptr  = buffer.get();
+  auto moved = std::move(buffer);
+  EXPECT_EQ(moved.get(), ptr);
+  EXPECT_EQ(buffer.get(), nullptr);
+
+  auto empty = detail::owned_host_buffer<int>(0, cudaStream_t{}, &mr);
+  EXPECT_EQ(empty.get(), nullptr);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
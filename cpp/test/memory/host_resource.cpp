@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/memory/detail/host_resource.hpp>
+#include <rapids_triton/memory/host_resource.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, host_pool_resource)
+{
+  auto upstream = detail::pageable_host_resource{};
+  auto pool     = detail::host_pool_resource{&upstream, std::size_t{1024}};
+
+  auto* first = pool.allocate(100);
+  EXPECT_EQ(pool.cached_bytes(), 0);
+  pool.deallocate(first, 100);
+  EXPECT_EQ(pool.cached_bytes(), 256);
+
+  // Blocks in the same size class should be reused
+  auto* second = pool.allocate(200);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(pool.cached_bytes(), 0);
+
+  // Blocks beyond the maximum cache size should be returned upstream
+  auto* large = pool.allocate(2048);
+  pool.deallocate(large, 2048);
+  EXPECT_EQ(pool.cached_bytes(), 0);
+  pool.deallocate(second, 200);
+  EXPECT_EQ(pool.cached_bytes(), 256);
+}
+
+TEST(RapidsTriton, set_host_memory_resource)
+{
+  auto* initial_mr = get_host_memory_resource();
+  EXPECT_NE(initial_mr, nullptr);
+  setup_host_memory_resource(true, false);
+  auto* pool_mr = get_host_memory_resource();
+  EXPECT_NE(dynamic_cast<detail::host_pool_resource*>(pool_mr), nullptr);
+  EXPECT_EQ(pool_mr->is_pinned(), false);
+
+  // Once a pool has been installed, further setup calls should not replace it
+  setup_host_memory_resource(false);
+  EXPECT_EQ(get_host_memory_resource(), pool_mr);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
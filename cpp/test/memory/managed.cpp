@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/managed.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, managed_buffer)
+{
+  auto data = std::vector<int>{1, 2, 3, 4};
+#ifdef TRITON_ENABLE_GPU
+  auto buffer = Buffer<int>::managed(data.size(), 0, 0);
+
+  ASSERT_TRUE(buffer.is_managed());
+  ASSERT_EQ(buffer.mem_type(), DeviceMemory);
+  ASSERT_EQ(buffer.size(), data.size());
+
+  // Managed memory may be written directly by the host
+  std::copy(std::begin(data), std::end(data), buffer.data());
+  advise_read_mostly(buffer);
+  advise_resident(buffer, 0, 2);
+  prefetch(buffer, buffer.stream(), 0, 2);
+  buffer.stream_synchronize();
+
+  auto host_buffer = Buffer<int>(buffer, HostMemory);
+  auto data_out    = std::vector<int>(host_buffer.data(), host_buffer.data() + host_buffer.size());
+  EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
+#else
+  EXPECT_THROW(Buffer<int>::managed(data.size(), 0, 0), TritonException);
+#endif
+}
+
+TEST(RapidsTriton, managed_hints_require_managed_buffer)
+{
+  auto buffer = Buffer<int>(4, HostMemory);
+  EXPECT_FALSE(buffer.is_managed());
+  EXPECT_THROW(prefetch(buffer, buffer.stream()), TritonException);
+  EXPECT_THROW(advise_read_mostly(buffer), TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/memory_budget.hpp>
+#include <thread>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, memory_budget)
+{
+  auto budget = std::make_shared<memory_budget>(0, 100);
+  EXPECT_TRUE(budget->try_reserve(60));
+  EXPECT_FALSE(budget->try_reserve(60));
+  EXPECT_THROW(budget->reserve(60), TritonException);
+  EXPECT_THROW(budget->reserve(200), TritonException);
+  budget->release(60);
+  EXPECT_EQ(budget->current(), 0);
+  EXPECT_EQ(budget->peak(), 60);
+
+  {
+    auto reservation = budget_reservation{budget, 40};
+    EXPECT_EQ(budget->current(), 40);
+    auto moved = std::move(reservation);
+    EXPECT_EQ(budget->current(), 40);
+  }
+  EXPECT_EQ(budget->current(), 0);
+  EXPECT_EQ(budget->peak(), 60);
+}
+
+TEST(RapidsTriton, memory_budget_wait)
+{
+  auto budget = std::make_shared<memory_budget>(0, 100, std::chrono::seconds{10});
+  auto held   = std::make_unique<budget_reservation>(budget, 80);
+  auto waiter = std::thread{[&budget]() { auto reservation = budget_reservation{budget, 50}; }};
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  held.reset();
+  waiter.join();
+  EXPECT_EQ(budget->current(), 0);
+  EXPECT_EQ(budget->peak(), 80);
+}
+
+TEST(RapidsTriton, scoped_memory_budget)
+{
+  auto budget = std::make_shared<memory_budget>(1, 100);
+  EXPECT_FALSE(get_memory_budget(1));
+  {
+    auto scope = scoped_memory_budget{budget};
+    EXPECT_EQ(get_memory_budget(1), budget);
+    EXPECT_FALSE(get_memory_budget(0));
+    {
+      auto inner = scoped_memory_budget{nullptr};
+      EXPECT_FALSE(get_memory_budget(1));
+    }
+    EXPECT_EQ(get_memory_budget(1), budget);
+  }
+  EXPECT_FALSE(get_memory_budget(1));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
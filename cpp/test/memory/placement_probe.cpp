@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/placement_probe.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, fit_transfer_model)
+{
+  using std::chrono::nanoseconds;
+  // 10 us of latency and 10 bytes per nanosecond
+  auto samples = std::vector<std::pair<std::size_t, nanoseconds>>{
+    {std::size_t{1000}, nanoseconds{10100}},
+    {std::size_t{100000}, nanoseconds{20000}},
+    {std::size_t{1000000}, nanoseconds{110000}}};
+  auto model = fit_transfer_model(samples);
+  EXPECT_NEAR(model.latency.count(), 10000, 1);
+  EXPECT_NEAR(model.ns_per_byte, 0.1, 1e-6);
+  EXPECT_NEAR(model.break_even_bytes(), 100000, 10);
+  EXPECT_NEAR(model.break_even_bytes(nanoseconds{5000}), 150000, 10);
+
+  auto flat =
+    fit_transfer_model({{std::size_t{1}, nanoseconds{5}}, {std::size_t{2}, nanoseconds{5}}});
+  EXPECT_EQ(flat.break_even_bytes(), std::numeric_limits<std::size_t>::max());
+  EXPECT_THROW(fit_transfer_model({{std::size_t{1}, nanoseconds{5}}}), TritonException);
+}
+
+TEST(RapidsTriton, memory_placement)
+{
+  using std::chrono::nanoseconds;
+  auto probe = placement_probe{transfer_model{nanoseconds{8000}, 0.1},
+                               transfer_model{nanoseconds{18000}, 0.1},
+                               nanoseconds{2000}};
+  auto placement = memory_placement{probe, 100, 10};
+  EXPECT_EQ(placement.min_device_input_bytes(), 100000);
+  EXPECT_EQ(placement.min_device_output_bytes(), 200000);
+  EXPECT_EQ(placement.input_mem_type(999), HostMemory);
+  EXPECT_EQ(placement.input_mem_type(1000), DeviceMemory);
+  EXPECT_EQ(placement.output_mem_type(19999), HostMemory);
+  EXPECT_EQ(placement.output_mem_type(20000), DeviceMemory);
+
+  // Data of unknown size are left on the device
+  auto unknown = memory_placement{probe, 0, 0};
+  EXPECT_EQ(unknown.input_mem_type(1), DeviceMemory);
+  EXPECT_EQ(unknown.output_mem_type(1), DeviceMemory);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -19,6 +19,7 @@
 #include <rmm/cuda_device.hpp>
 #include <rmm/mr/device/cuda_memory_resource.hpp>
 #include <rmm/mr/device/per_device_resource.hpp>
+#include <rapids_triton/memory/detail/gpu_only/resource.hpp>
 #endif
 
 #include <gmock/gmock.h>
@@ -26,6 +27,7 @@
 
 #include <rapids_triton/build_control.hpp>
 #include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/pool_config.hpp>
 #include <rapids_triton/memory/resource.hpp>
 
 namespace triton {
@@ -42,11 +44,34 @@ TEST(RapidsTriton, set_memory_resource)
   setup_memory_resource(device_id);
   EXPECT_EQ(rmm::mr::get_current_device_resource()->is_equal(rmm::mr::cuda_memory_resource{}),
             false);
+  EXPECT_EQ(detail::get_memory_resource(device_id), rmm::mr::get_current_device_resource());
+  EXPECT_THROW(setup_memory_resource(-1), TritonException);
 #else
   setup_memory_resource(0);
 #endif
 }
 
+TEST(RapidsTriton, set_pool_memory_resource)
+{
+#ifdef TRITON_ENABLE_GPU
+  auto device_id = int{};
+  cuda_check(cudaGetDevice(&device_id));
+  setup_memory_resource(device_id, nullptr, pool_config{std::size_t{1} << 20, std::nullopt});
+  auto* pool_mr = rmm::mr::get_current_device_resource();
+  EXPECT_NE(dynamic_cast<detail::pool_resource*>(pool_mr), nullptr);
+  EXPECT_EQ(detail::get_memory_resource(device_id), pool_mr);
+
+  // Once a pool has been installed, further setup calls should not replace it
+  setup_memory_resource(device_id);
+  EXPECT_EQ(rmm::mr::get_current_device_resource(), pool_mr);
+  setup_memory_resource(device_id, nullptr, pool_config{std::size_t{2} << 20, std::nullopt});
+  EXPECT_EQ(rmm::mr::get_current_device_resource(), pool_mr);
+  EXPECT_EQ(detail::get_memory_resource(device_id), pool_mr);
+#else
+  setup_memory_resource(0, nullptr, pool_config{std::size_t{1} << 20, std::nullopt});
+#endif
+}
+
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
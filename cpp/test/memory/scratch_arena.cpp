@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#else
+#include <rapids_triton/cpu_only/cuda_runtime_replacement.hpp>
+#endif
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/scratch_arena.hpp>
+#include <rapids_triton/memory/types.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, scratch_arena)
+{
+  auto arena = scratch_arena{HostMemory, 0};
+  auto first = arena.allocate<float>(10, cudaStream_t{});
+  EXPECT_EQ(first.size(), 10);
+  EXPECT_EQ(first.mem_type(), HostMemory);
+  auto second = arena.allocate<std::int64_t>(3, cudaStream_t{});
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second.data()) % scratch_arena::alignment, 0);
+  EXPECT_EQ(reinterpret_cast<std::byte*>(second.data()),
+            reinterpret_cast<std::byte*>(first.data()) + scratch_arena::alignment);
+  EXPECT_EQ(arena.used_bytes(), 2 * scratch_arena::alignment);
+
+  // Requests beyond the current block are served from a new block
+  auto large = arena.allocate<char>(scratch_arena::min_block_bytes, cudaStream_t{});
+  auto peak  = 2 * scratch_arena::alignment + scratch_arena::min_block_bytes;
+  EXPECT_EQ(arena.used_bytes(), peak);
+  EXPECT_EQ(arena.high_water_mark(), peak);
+  large.data()[0] = 'a';
+
+  // After reset, a single block large enough for the high-water mark is used
+  arena.reset();
+  EXPECT_EQ(arena.used_bytes(), 0);
+  EXPECT_EQ(arena.capacity(), 0);
+  auto reused   = arena.allocate<char>(1, cudaStream_t{});
+  auto capacity = arena.capacity();
+  EXPECT_GE(capacity, peak);
+  arena.allocate<char>(peak - scratch_arena::alignment, cudaStream_t{});
+  EXPECT_EQ(arena.capacity(), capacity);
+  arena.reset();
+  EXPECT_EQ(arena.allocate<char>(1, cudaStream_t{}).data(), reused.data());
+  EXPECT_EQ(arena.high_water_mark(), peak);
+}
+
+TEST(RapidsTriton, scratch_arena_reserve)
+{
+  auto arena = scratch_arena{HostMemory, 0};
+  arena.reserve(4 * scratch_arena::min_block_bytes, cudaStream_t{});
+  auto capacity = arena.capacity();
+  EXPECT_GE(capacity, 4 * scratch_arena::min_block_bytes);
+  EXPECT_EQ(arena.high_water_mark(), 0);
+
+  // Allocations within the reservation use the reserved block
+  auto first = arena.allocate<char>(scratch_arena::min_block_bytes, cudaStream_t{});
+  arena.allocate<char>(2 * scratch_arena::min_block_bytes, cudaStream_t{});
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  // Reserving has no effect while storage is allocated, and a smaller
+  // reservation keeps the existing block
+  arena.reserve(8 * scratch_arena::min_block_bytes, cudaStream_t{});
+  EXPECT_EQ(arena.capacity(), capacity);
+  arena.reset();
+  arena.reserve(scratch_arena::min_block_bytes, cudaStream_t{});
+  EXPECT_EQ(arena.allocate<char>(1, cudaStream_t{}).data(), first.data());
+}
+
+TEST(RapidsTriton, scratch_arena_device)
+{
+  auto arena = scratch_arena{DeviceMemory, 0};
+#ifdef TRITON_ENABLE_GPU
+  auto stream = cudaStream_t{};
+  cudaStreamCreate(&stream);
+  auto first = arena.allocate<float>(10, stream);
+  EXPECT_EQ(first.mem_type(), DeviceMemory);
+  arena.reset();
+  // Reuse on another stream is ordered after work on the first
+  auto second = arena.allocate<float>(10, cudaStream_t{});
+  EXPECT_EQ(second.data(), first.data());
+  arena.reset();
+  cudaStreamSynchronize(stream);
+  cudaStreamDestroy(stream);
+#else
+  EXPECT_THROW(arena.allocate<float>(10, cudaStream_t{}), TritonException);
+#endif
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
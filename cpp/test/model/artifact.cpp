@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/model/artifact.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, mapped_artifact)
+{
+  auto path     = ::testing::TempDir() + "rapids_triton_artifact.bin";
+  auto contents = std::string{"model weights"};
+  {
+    auto file = std::ofstream{path, std::ios::binary};
+    file << contents;
+  }
+
+  auto artifact = mapped_artifact{path, artifact_options{true, true}};
+  EXPECT_EQ(artifact.size(), contents.size());
+  auto view = artifact.view();
+  EXPECT_EQ(view.mem_type(), HostMemory);
+  EXPECT_EQ(view.size(), contents.size());
+  EXPECT_EQ(std::string(reinterpret_cast<char const*>(view.data()), view.size()), contents);
+
+  auto moved = std::move(artifact);
+  EXPECT_EQ(artifact.data(), nullptr);
+  EXPECT_EQ(moved.data(), view.data());
+
+#ifdef TRITON_ENABLE_GPU
+  auto device_buffer = moved.to_device(0);
+  EXPECT_EQ(device_buffer.mem_type(), DeviceMemory);
+  auto out = Buffer<std::byte>(device_buffer, HostMemory);
+  out.stream_synchronize();
+  EXPECT_EQ(std::string(reinterpret_cast<char const*>(out.data()), out.size()), contents);
+#else
+  EXPECT_THROW(moved.to_device(0), TritonException);
+#endif
+  std::remove(path.c_str());
+
+  EXPECT_THROW(mapped_artifact{path}, TritonException);
+}
+
+TEST(RapidsTriton, artifact_watcher)
+{
+  auto path = ::testing::TempDir() + "rapids_triton_watched_artifact.bin";
+  {
+    auto file = std::ofstream{path, std::ios::binary};
+    file << "old weights";
+  }
+
+  auto changes = std::atomic<int>{};
+  {
+    auto watcher =
+      artifact_watcher{path, std::chrono::milliseconds{5}, [&changes]() { ++changes; }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_EQ(changes.load(), 0);
+
+    {
+      auto file = std::ofstream{path, std::ios::binary};
+      file << "new model weights";
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (changes.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  }
+  EXPECT_EQ(changes.load(), 1);
+  std::remove(path.c_str());
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/model/composition.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace {
+auto stage(std::string name, std::vector<std::string> inputs, std::vector<std::string> outputs)
+{
+  return composition_stage{std::move(name), std::move(inputs), std::move(outputs), {}};
+}
+}  // namespace
+
+TEST(RapidsTriton, composition_order)
+{
+  // Stages given out of order run after their producers
+  auto stages = std::vector<composition_stage>{stage("classify", {"features"}, {"label"}),
+                                               stage("score", {"input__0"}, {"score"}),
+                                               stage("embed", {"input__0"}, {"features"})};
+  auto model  = composition{std::move(stages)};
+  auto names = std::vector<std::string>{};
+  std::transform(std::begin(model.stages()),
+                 std::end(model.stages()),
+                 std::back_inserter(names),
+                 [](auto const& entry) { return entry.name; });
+  EXPECT_EQ(names, (std::vector<std::string>{"score", "embed", "classify"}));
+  // Only tensors consumed by another stage stay within the batch
+  EXPECT_EQ(model.intermediates(), std::vector<std::string>{"features"});
+}
+
+TEST(RapidsTriton, composition_invalid)
+{
+  EXPECT_THROW(composition(std::vector<composition_stage>{stage("a", {"y"}, {"x"}),
+                                                          stage("b", {"x"}, {"y"})}),
+               TritonException);
+  EXPECT_THROW(composition(std::vector<composition_stage>{stage("a", {"input__0"}, {"x"}),
+                                                          stage("b", {"input__0"}, {"x"})}),
+               TritonException);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
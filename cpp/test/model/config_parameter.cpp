@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/model/config_parameter.hpp>
+#include <string>
+#include <type_traits>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, config_parameter)
+{
+  auto constexpr optional_param = config_parameter<std::size_t>{"optional", 4};
+  static_assert(std::is_same_v<decltype(optional_param)::value_type, std::size_t>);
+  EXPECT_EQ(std::string{optional_param.name}, std::string{"optional"});
+  ASSERT_TRUE(optional_param.default_value.has_value());
+  EXPECT_EQ(*optional_param.default_value, 4);
+
+  auto constexpr required_param = config_parameter<bool>{"required"};
+  EXPECT_FALSE(required_param.default_value.has_value());
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
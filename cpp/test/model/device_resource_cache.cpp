@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/model/device_resource_cache.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, device_resource_cache)
+{
+  auto cache       = device_resource_cache{};
+  auto build_count = 0;
+  auto factory     = [&build_count]() {
+    ++build_count;
+    return std::vector<float>{1.0f, 2.0f};
+  };
+
+  auto first  = cache.get<std::vector<float>>("weights", 0, factory);
+  auto second = cache.get<std::vector<float>>("weights", 0, factory);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(build_count, 1);
+
+  auto other_device = cache.get<std::vector<float>>("weights", 1, factory);
+  EXPECT_NE(first, other_device);
+  EXPECT_EQ(build_count, 2);
+
+  auto shared = cache.get<int>("count", 0, []() { return std::make_shared<int>(3); });
+  EXPECT_EQ(*shared, 3);
+  EXPECT_THROW(cache.get<float>("count", 0, []() { return 1.0f; }), TritonException);
+
+  // Once all holders release a resource, it is constructed again
+  first.reset();
+  second.reset();
+  auto rebuilt = cache.get<std::vector<float>>("weights", 0, factory);
+  EXPECT_EQ(build_count, 3);
+  EXPECT_EQ(rebuilt->size(), 2);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/model/schema.hpp>
+#include <rapids_triton/triton/config.hpp>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, tensor_schema)
+{
+  auto constexpr inputs =
+    tensor_schema{tensor_field<float, 2>{"input__0"}, tensor_field<int, 1>{"input__1"}};
+  auto constexpr outputs = tensor_schema{tensor_field<double, 2>{"output__0"}};
+  static_assert(decltype(inputs)::size == 2);
+  static_assert(std::is_same_v<decltype(inputs)::field_type<1>::value_type, int>);
+  static_assert(decltype(inputs)::field_type<0>::rank == 2);
+  EXPECT_EQ(std::string{inputs.field<1>().name}, "input__1");
+
+  auto schema = bound_schema<std::remove_const_t<decltype(inputs)>,
+                             std::remove_const_t<decltype(outputs)>>{
+    inputs, outputs, {std::vector<std::int64_t>{-1, 3}}};
+  EXPECT_EQ(std::string{schema.outputs.field<0>().name}, "output__0");
+  EXPECT_THAT(resolve_output_shape(schema.output_shapes[0], 5), ::testing::ElementsAre(5, 3));
+  EXPECT_THROW(resolve_output_shape(std::vector<std::int64_t>{-1, -1}, 5), TritonException);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
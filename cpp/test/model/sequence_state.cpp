@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/model/sequence_state.hpp>
+#include <rapids_triton/triton/requests.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, sequence_state_store)
+{
+  auto store = SequenceStateStore<float>{2, 3, HostMemory};
+  EXPECT_EQ(store.capacity(), 2);
+  EXPECT_EQ(store.state_size(), 3);
+
+  auto slots = store.assign({sequence_control{7, true, false}, sequence_control{9, true, false}});
+  ASSERT_EQ(slots.size(), 2);
+  EXPECT_NE(slots[0].index, slots[1].index);
+  EXPECT_TRUE(slots[0].fresh);
+  EXPECT_TRUE(slots[1].fresh);
+  store.state(slots[0].index).data()[2] = 4.0f;
+
+  // Continuing requests receive the same slot with state intact
+  auto next = store.assign({sequence_control{7, false, true}});
+  EXPECT_EQ(next[0].index, slots[0].index);
+  EXPECT_FALSE(next[0].fresh);
+  EXPECT_EQ(store.state(next[0].index).data()[2], 4.0f);
+  EXPECT_EQ(store.active_sequences(), 2);
+
+  // The slot of an ended sequence is reclaimed by the next batch
+  auto reused = store.assign({sequence_control{11, true, false}});
+  EXPECT_EQ(reused[0].index, slots[0].index);
+  EXPECT_TRUE(reused[0].fresh);
+  EXPECT_EQ(store.active_sequences(), 2);
+
+  // With all slots held, the least-recently used sequence is evicted
+  auto evicting =
+    store.assign({sequence_control{11, false, false}, sequence_control{13, true, false}});
+  EXPECT_EQ(evicting[0].index, reused[0].index);
+  EXPECT_EQ(evicting[1].index, slots[1].index);
+  auto evicted = store.assign({sequence_control{9, false, false}});
+  EXPECT_TRUE(evicted[0].fresh);
+
+  EXPECT_THROW(store.assign({sequence_control{0, true, false}}), TritonException);
+  EXPECT_THROW(store.assign({sequence_control{21, true, false},
+                             sequence_control{22, true, false},
+                             sequence_control{23, true, false}}),
+               TritonException);
+  EXPECT_THROW(store.state(2), TritonException);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/model/shard_group.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, parse_device_list)
+{
+  EXPECT_TRUE(parse_device_list("").empty());
+  EXPECT_THAT(parse_device_list("2, 0,1"), ::testing::ElementsAre(2, 0, 1));
+  EXPECT_THROW(parse_device_list("0,0"), TritonException);
+  EXPECT_THROW(parse_device_list("0,-1"), TritonException);
+  EXPECT_THROW(parse_device_list("0,gpu1"), TritonException);
+}
+
+TEST(RapidsTriton, partition_rows)
+{
+  auto ranges = partition_rows(10, 3);
+  ASSERT_EQ(ranges.size(), 3);
+  EXPECT_EQ(ranges[0].begin, 0);
+  EXPECT_EQ(ranges[0].count, 4);
+  EXPECT_EQ(ranges[1].begin, 4);
+  EXPECT_EQ(ranges[1].count, 3);
+  EXPECT_EQ(ranges[2].begin, 7);
+  EXPECT_EQ(ranges[2].count, 3);
+
+  ranges = partition_rows(1, 2);
+  EXPECT_EQ(ranges[0].count, 1);
+  EXPECT_EQ(ranges[1].begin, 1);
+  EXPECT_EQ(ranges[1].count, 0);
+}
+
+TEST(RapidsTriton, shard_group)
+{
+#ifdef TRITON_ENABLE_GPU
+  auto device_count = int{};
+  cudaGetDeviceCount(&device_count);
+  if (device_count < 1) { GTEST_SKIP() << "Sharding requires a device"; }
+
+  auto devices = std::vector<device_id_t>(device_count);
+  std::iota(std::begin(devices), std::end(devices), device_id_t{});
+  auto shards  = shard_group{devices};
+  auto data    = std::vector<float>{1, 2, 3, 4, 5, 6};
+  auto input   = Tensor<float>({3, 2}, Buffer<float>(data.data(), data.size(), HostMemory));
+  auto streams = shards.acquire_streams(cudaStream_t{}, 0);
+
+  auto parts = shards.partition(input, streams);
+  ASSERT_EQ(parts.size(), shards.size());
+  EXPECT_EQ(parts[0].shape()[1], 2);
+
+  auto gathered = Tensor<float>({3, 2}, Buffer<float>(data.size(), HostMemory));
+  shards.gather(parts, gathered, streams);
+  gathered.stream_synchronize();
+  EXPECT_THAT(std::vector<float>(gathered.data(), gathered.data() + gathered.size()),
+              ::testing::ElementsAreArray(data));
+
+  auto copies  = shards.broadcast(input, streams);
+  auto reduced = Tensor<float>({3, 2}, Buffer<float>(data.size(), HostMemory));
+  shards.reduce(copies, reduced, streams);
+  reduced.stream_synchronize();
+  EXPECT_FLOAT_EQ(reduced.data()[5], 6.0f * shards.size());
+  shards.join(streams, cudaStream_t{});
+#else
+  EXPECT_THROW(shard_group{std::vector<device_id_t>{0}}, TritonException);
+#endif
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cuda_runtime_api.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/model/shard_group.cuh>
+#include <rapids_triton/model/shard_group.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+namespace {
+template <typename T>
+auto to_host(Buffer<T> const& buffer)
+{
+  auto result = Buffer<T>(buffer, HostMemory);
+  result.stream_synchronize();
+  return std::vector<T>(result.data(), result.data() + result.size());
+}
+}  // namespace
+
+TEST(RapidsTriton, device_reduction)
+{
+  auto device_count = int{};
+  if (cudaGetDeviceCount(&device_count) != cudaSuccess || device_count < 1) {
+    GTEST_SKIP() << "Device reduction requires a device";
+  }
+  register_device_reduction<float>();
+
+  // More elements than one block of threads sums
+  auto size    = std::size_t{1000};
+  auto data    = std::vector<float>(size);
+  auto partial = std::vector<float>(size);
+  for (auto i = std::size_t{}; i < size; ++i) {
+    data[i]    = static_cast<float>(i % 29);
+    partial[i] = static_cast<float>(i % 13) * 0.5f;
+  }
+  auto expected = std::vector<float>(size);
+  std::transform(data.begin(), data.end(), partial.begin(), expected.begin(), std::plus<>{});
+
+  auto dst = Buffer<float>(Buffer<float>{data.data(), size, HostMemory}, DeviceMemory);
+  auto src = Buffer<float>(Buffer<float>{partial.data(), size, HostMemory}, DeviceMemory);
+  detail::accumulate(dst.data(), src.data(), size, dst.stream());
+  EXPECT_THAT(to_host(dst), ::testing::ElementsAreArray(expected));
+
+  // Reducing into a device output matches reducing into a host output
+  auto devices = std::vector<device_id_t>(device_count);
+  std::iota(std::begin(devices), std::end(devices), device_id_t{});
+  auto shards  = shard_group{devices};
+  auto input   = Tensor<float>({size}, Buffer<float>(data.data(), size, HostMemory));
+  auto streams = shards.acquire_streams(cudaStream_t{}, 0);
+  auto copies  = shards.broadcast(input, streams);
+
+  auto host_reduced = Tensor<float>({size}, Buffer<float>(size, HostMemory));
+  shards.reduce(copies, host_reduced, streams);
+  host_reduced.stream_synchronize();
+  auto device_reduced = Tensor<float>({size}, Buffer<float>(size, DeviceMemory));
+  shards.reduce(copies, device_reduced, streams);
+  EXPECT_THAT(to_host(device_reduced.buffer()),
+              ::testing::ElementsAreArray(host_reduced.data(), size));
+  shards.join(streams, cudaStream_t{});
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
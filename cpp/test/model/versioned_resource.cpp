@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <rapids_triton/model/versioned_resource.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, versioned_resource)
+{
+  auto resource = versioned_resource<int>{};
+  EXPECT_EQ(resource.get(), nullptr);
+  EXPECT_EQ(resource.version(), 0);
+
+  resource.publish(std::make_shared<int const>(1));
+  auto in_flight = resource.get();
+  auto released  = std::weak_ptr<int const>{in_flight};
+  EXPECT_EQ(*in_flight, 1);
+  EXPECT_EQ(resource.version(), 1);
+
+  // Readers holding the old copy keep it alive after a new one is published
+  resource.publish(std::make_shared<int const>(2));
+  EXPECT_EQ(*resource.get(), 2);
+  EXPECT_EQ(*in_flight, 1);
+  EXPECT_EQ(resource.version(), 2);
+
+  in_flight.reset();
+  EXPECT_TRUE(released.expired());
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <rapids_triton/tensor/dtype.hpp>
 
 namespace triton {
@@ -42,10 +43,35 @@ TEST(RapidsTriton, dtype)
   check_dtype_conversion<DTypeInt16>();
   check_dtype_conversion<DTypeInt32>();
   check_dtype_conversion<DTypeInt64>();
+  check_dtype_conversion<DTypeFloat16>();
+  check_dtype_conversion<DTypeBFloat16>();
   check_dtype_conversion<DTypeFloat32>();
   check_dtype_conversion<DTypeFloat64>();
 }
 
+TEST(RapidsTriton, half_precision_types)
+{
+  EXPECT_EQ(sizeof(__half), 2);
+  EXPECT_EQ(sizeof(__nv_bfloat16), 2);
+
+  for (auto value : {0.0f, -0.0f, 1.0f, -1.5f, 0.25f, 65504.0f}) {
+    EXPECT_EQ(__half2float(__float2half(value)), value);
+  }
+  // Smallest subnormal half
+  EXPECT_EQ(__half2float(__float2half(5.9604645e-08f)), 5.9604645e-08f);
+  // Round to nearest even
+  EXPECT_EQ(__half2float(__float2half(2049.0f)), 2048.0f);
+  EXPECT_EQ(__half2float(__float2half(2051.0f)), 2052.0f);
+  EXPECT_TRUE(std::isinf(__half2float(__float2half(1.0e6f))));
+  EXPECT_TRUE(std::isnan(__half2float(__float2half(std::nanf("")))));
+
+  for (auto value : {0.0f, 1.0f, -3.0f, 0x1p100f}) {
+    EXPECT_EQ(__bfloat162float(__float2bfloat16(value)), value);
+  }
+  EXPECT_EQ(__bfloat162float(__float2bfloat16(1.00390625f)), 1.0f);
+  EXPECT_TRUE(std::isnan(__bfloat162float(__float2bfloat16(std::nanf("")))));
+}
+
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/parallel_for_rows.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, parallel_for_rows)
+{
+  auto pool   = thread_pool{2};
+  auto tensor = Tensor<float>(std::vector<std::size_t>{10, 3},
+                              Buffer<float>(std::size_t{30}, HostMemory));
+  parallel_for_rows(pool, tensor, [](auto rows, auto first_row) {
+    for (auto i = std::size_t{}; i < rows.shape()[0]; ++i) {
+      for (auto j = std::size_t{}; j < 3; ++j) {
+        rows.data()[i * 3 + j] = static_cast<float>(first_row + i);
+      }
+    }
+  });
+  for (auto i = std::size_t{}; i < 30; ++i) {
+    EXPECT_EQ(tensor.data()[i], static_cast<float>(i / 3));
+  }
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
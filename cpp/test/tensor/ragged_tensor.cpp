@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/ragged_tensor.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, ragged_tensor)
+{
+  auto data   = std::vector<float>{1, 2, 3, 4, 5, 6, 7};
+  auto shapes = std::vector<std::vector<std::size_t>>{{1, 3}, {2, 1}, {2, 1}};
+  auto tensor = RaggedTensor<float>(std::vector<std::vector<std::size_t>>(shapes),
+                                    std::vector<std::size_t>{0, 3, 5, 7},
+                                    Buffer<float>(data.data(), data.size(), HostMemory));
+
+  EXPECT_EQ(tensor.num_segments(), 3);
+  EXPECT_EQ(tensor.size(), data.size());
+  EXPECT_EQ(tensor.shape(1), shapes[1]);
+  EXPECT_EQ(tensor.segment_offset(2), 5);
+  EXPECT_EQ(tensor.segment_size(0), 3);
+  EXPECT_EQ(tensor.offsets().mem_type(), HostMemory);
+  EXPECT_THAT(std::vector<RaggedTensor<float>::offset_type>(
+                tensor.offsets().data(), tensor.offsets().data() + tensor.offsets().size()),
+              ::testing::ElementsAre(0, 3, 5, 7));
+
+  auto segment = tensor.segment(1);
+  EXPECT_EQ(segment.shape(), shapes[1]);
+  EXPECT_EQ(segment.data(), data.data() + 3);
+
+  EXPECT_THROW(RaggedTensor<float>(std::vector<std::vector<std::size_t>>(shapes),
+                                   std::vector<std::size_t>{0, 3, 5, 6},
+                                   Buffer<float>(data.data(), data.size(), HostMemory)),
+               TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
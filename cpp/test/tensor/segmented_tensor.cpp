@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/tensor/segmented_tensor.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, segmented_tensor_copy)
+{
+  auto data      = std::vector<int>{1, 2, 3, 4, 5, 6};
+  auto response1 = std::vector<int>(2);
+  auto response2 = std::vector<int>(4);
+
+  auto segments = std::vector<TensorView<int>>{};
+  segments.emplace_back(response1.data(), std::vector<std::size_t>{1, 2}, HostMemory, 0, nullptr);
+  segments.emplace_back(response2.data(), std::vector<std::size_t>{2, 2}, HostMemory, 0, nullptr);
+  auto output = SegmentedTensor<int>({3, 2}, std::move(segments));
+  EXPECT_EQ(output.num_segments(), 2);
+  EXPECT_EQ(output.size(), 6);
+
+  copy(output, TensorView<int const>{data.data(), {3, 2}, HostMemory, 0, cudaStream_t{}});
+  EXPECT_THAT(response1, ::testing::ElementsAre(1, 2));
+  EXPECT_THAT(response2, ::testing::ElementsAre(3, 4, 5, 6));
+
+  EXPECT_THROW(
+    copy(output, TensorView<int const>{data.data(), {2, 2}, HostMemory, 0, cudaStream_t{}}),
+    TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
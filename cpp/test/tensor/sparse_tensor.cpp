@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/sparse_tensor.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, sparse_tensor_densify)
+{
+  auto indptr  = std::vector<std::int64_t>{0, 2, 2, 3};
+  auto indices = std::vector<std::int64_t>{0, 3, 1};
+  auto values  = std::vector<float>{1, 2, 3};
+  auto tensor =
+    SparseTensor<float>(3,
+                        4,
+                        Buffer<std::int64_t>(indptr.data(), indptr.size(), HostMemory),
+                        Buffer<std::int64_t const>(indices.data(), indices.size(), HostMemory),
+                        Buffer<float>(values.data(), values.size(), HostMemory));
+  EXPECT_EQ(tensor.rows(), 3);
+  EXPECT_EQ(tensor.cols(), 4);
+  EXPECT_EQ(tensor.nnz(), 3);
+
+  auto dense_data = std::vector<float>(12, -1.0f);
+  auto dense      = Tensor<float>(std::vector<std::size_t>{3, 4},
+                             Buffer<float>(dense_data.data(), dense_data.size(), HostMemory));
+  densify(dense, tensor);
+  EXPECT_THAT(dense_data, ::testing::ElementsAre(1, 0, 0, 2, 0, 0, 0, 0, 0, 3, 0, 0));
+
+  EXPECT_THROW(SparseTensor<float>(4,
+                                   4,
+                                   Buffer<std::int64_t>(indptr.data(), indptr.size(), HostMemory),
+                                   Buffer<std::int64_t const>(indices.data(), 3, HostMemory),
+                                   Buffer<float>(values.data(), values.size(), HostMemory)),
+               TritonException);
+}
+
+TEST(RapidsTriton, sparse_concat_indptr)
+{
+  // Two requests of two and one rows, whose row pointers need not start at
+  // zero
+  auto packed        = std::vector<std::int64_t>{0, 1, 3, 5, 7};
+  auto segments      = std::vector<std::int64_t>{0, 3, 5};
+  auto value_offsets = std::vector<std::int64_t>{0, 3, 5};
+  auto result        = std::vector<std::int64_t>(4);
+  detail::host_concat_indptr(
+    result.data(), packed.data(), segments.data(), value_offsets.data(), segments.size() - 1);
+  EXPECT_THAT(result, ::testing::ElementsAre(0, 1, 3, 5));
+}
+
+TEST(RapidsTriton, sparse_valid_indptr)
+{
+  auto segments      = std::vector<std::int64_t>{0, 3, 5};
+  auto value_offsets = std::vector<std::int64_t>{0, 3, 5};
+  auto valid         = std::vector<std::int64_t>{0, 1, 3, 5, 7};
+  EXPECT_TRUE(detail::host_valid_indptr(
+    valid.data(), segments.data(), value_offsets.data(), segments.size() - 1));
+
+  // Row pointers which span the wrong number of values
+  auto short_span = std::vector<std::int64_t>{0, 1, 2, 5, 7};
+  EXPECT_FALSE(detail::host_valid_indptr(
+    short_span.data(), segments.data(), value_offsets.data(), segments.size() - 1));
+
+  // Row pointers which span the right number of values but decrease
+  auto decreasing = std::vector<std::int64_t>{0, 4, 3, 5, 7};
+  EXPECT_FALSE(detail::host_valid_indptr(
+    decreasing.data(), segments.data(), value_offsets.data(), segments.size() - 1));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cuda_runtime_api.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/sparse_tensor.cuh>
+#include <rapids_triton/tensor/sparse_tensor.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+namespace {
+auto device_available()
+{
+  auto device_count = int{};
+  return cudaGetDeviceCount(&device_count) == cudaSuccess && device_count > 0;
+}
+
+template <typename T>
+auto to_device(std::vector<T>& data)
+{
+  return Buffer<T>(Buffer<T>{data.data(), data.size(), HostMemory}, DeviceMemory);
+}
+
+template <typename T>
+auto to_host(T* data, std::size_t size)
+{
+  auto result = Buffer<T>(Buffer<T>{data, size, DeviceMemory}, HostMemory);
+  result.stream_synchronize();
+  return std::vector<T>(result.data(), result.data() + result.size());
+}
+}  // namespace
+
+TEST(RapidsTriton, device_sparse_indptr)
+{
+  if (!device_available()) { GTEST_SKIP() << "Device row pointers require a device"; }
+  register_device_sparse_inputs();
+
+  // Three requests of two, one and three rows, whose row pointers need not
+  // start at zero
+  auto segments      = std::vector<std::int64_t>{0, 3, 5, 9};
+  auto value_offsets = std::vector<std::int64_t>{0, 3, 5, 6};
+  auto num_segments  = segments.size() - 1;
+  auto valid         = std::vector<std::int64_t>{0, 1, 3, 5, 7, 2, 2, 3, 3};
+  auto short_span    = std::vector<std::int64_t>{0, 1, 3, 5, 7, 2, 2, 3, 4};
+  auto decreasing    = std::vector<std::int64_t>{0, 4, 3, 5, 7, 2, 2, 3, 3};
+
+  auto device_segments      = to_device(segments);
+  auto device_value_offsets = to_device(value_offsets);
+  for (auto* packed : {&valid, &short_span, &decreasing}) {
+    auto device_packed = to_device(*packed);
+    EXPECT_EQ(detail::valid_indptr(device_packed.data(),
+                                   device_segments.data(),
+                                   device_value_offsets.data(),
+                                   num_segments,
+                                   packed->size(),
+                                   0,
+                                   cudaStream_t{},
+                                   DeviceMemory),
+              detail::host_valid_indptr(
+                packed->data(), segments.data(), value_offsets.data(), num_segments));
+  }
+
+  auto rows     = valid.size() - num_segments + 1;
+  auto expected = std::vector<std::int64_t>(rows);
+  detail::host_concat_indptr(
+    expected.data(), valid.data(), segments.data(), value_offsets.data(), num_segments);
+  auto device_valid = to_device(valid);
+  auto result       = Buffer<std::int64_t>(rows, DeviceMemory);
+  detail::concat_indptr(result.data(),
+                        device_valid.data(),
+                        device_segments.data(),
+                        device_value_offsets.data(),
+                        num_segments,
+                        valid.size(),
+                        cudaStream_t{},
+                        DeviceMemory);
+  EXPECT_THAT(to_host(result.data(), rows), ::testing::ElementsAreArray(expected));
+}
+
+TEST(RapidsTriton, device_sparse_tensor_densify)
+{
+  if (!device_available()) { GTEST_SKIP() << "Device densification requires a device"; }
+  register_device_densify<float, float>();
+
+  // Include an empty row and a column index outside the matrix, which is
+  // ignored
+  auto indptr  = std::vector<std::int64_t>{0, 2, 2, 5};
+  auto indices = std::vector<std::int64_t>{0, 3, 1, 7, 2};
+  auto values  = std::vector<float>{1, 2, 3, 4, 5};
+  auto tensor =
+    SparseTensor<float>(3,
+                        4,
+                        Buffer<std::int64_t>(indptr.data(), indptr.size(), HostMemory),
+                        Buffer<std::int64_t const>(indices.data(), indices.size(), HostMemory),
+                        Buffer<float>(values.data(), values.size(), HostMemory));
+  auto expected = Tensor<float>({3, 4}, Buffer<float>(12, HostMemory));
+  densify(expected, tensor);
+
+  auto device_indptr  = to_device(indptr);
+  auto device_indices = to_device(indices);
+  auto device_values  = to_device(values);
+  auto device_tensor  = SparseTensor<float>(
+    3,
+    4,
+    Buffer<std::int64_t>(device_indptr.data(), indptr.size(), DeviceMemory),
+    Buffer<std::int64_t const>(device_indices.data(), indices.size(), DeviceMemory),
+    Buffer<float>(device_values.data(), values.size(), DeviceMemory));
+  auto result = Tensor<float>({3, 4}, Buffer<float>(12, DeviceMemory));
+  densify(result, device_tensor);
+  EXPECT_THAT(to_host(result.data(), 12), ::testing::ElementsAreArray(expected.data(), 12));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
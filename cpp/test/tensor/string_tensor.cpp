@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/string_tensor.hpp>
+#include <string>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+namespace {
+auto serialize(std::vector<std::string> const& strings)
+{
+  auto result = std::string{};
+  for (auto const& str : strings) {
+    auto length = str.size();
+    for (auto i = 0; i < 4; ++i) {
+      result.push_back(static_cast<char>((length >> (8 * i)) & 0xff));
+    }
+    result += str;
+  }
+  return result;
+}
+}  // namespace
+
+TEST(RapidsTriton, string_tensor)
+{
+  auto strings    = std::vector<std::string>{"cat", "", "category", "dog"};
+  auto serialized = serialize(strings);
+
+  auto tensor =
+    parse_serialized_strings(std::vector<std::size_t>{2, 2}, serialized.data(), serialized.size());
+  EXPECT_EQ(tensor.shape(), (std::vector<std::size_t>{2, 2}));
+  EXPECT_EQ(tensor.size(), strings.size());
+  EXPECT_EQ(tensor.dtype(), DTypeBytes);
+  EXPECT_EQ(tensor.mem_type(), HostMemory);
+  EXPECT_EQ(tensor.chars().size(), 14);
+  EXPECT_EQ(tensor.offsets().size(), strings.size() + 1);
+  EXPECT_EQ(tensor.offsets().data()[4], 14);
+  for (auto i = std::size_t{}; i < strings.size(); ++i) {
+    EXPECT_EQ(tensor[i], strings[i]);
+  }
+
+  auto copied = StringTensor(tensor, HostMemory);
+  EXPECT_NE(copied.chars().data(), tensor.chars().data());
+  EXPECT_EQ(copied[2], strings[2]);
+#ifdef TRITON_ENABLE_GPU
+  auto device_tensor = StringTensor(tensor, DeviceMemory, 0);
+  EXPECT_EQ(device_tensor.mem_type(), DeviceMemory);
+  EXPECT_EQ(device_tensor.size(), strings.size());
+  EXPECT_THROW(device_tensor[0], TritonException);
+#else
+  EXPECT_THROW(StringTensor(tensor, DeviceMemory, 0), TritonException);
+#endif
+}
+
+TEST(RapidsTriton, malformed_string_tensor)
+{
+  auto serialized = serialize({"cat", "dog"});
+  EXPECT_THROW(
+    parse_serialized_strings(std::vector<std::size_t>{3}, serialized.data(), serialized.size()),
+    TritonException);
+  EXPECT_THROW(
+    parse_serialized_strings(std::vector<std::size_t>{1}, serialized.data(), serialized.size()),
+    TritonException);
+  EXPECT_THROW(
+    parse_serialized_strings(std::vector<std::size_t>{2}, serialized.data(), serialized.size() - 1),
+    TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -85,6 +85,46 @@ TEST(RapidsTriton, multi_buffer_tensor)
   EXPECT_THAT(data_out, ::testing::ElementsAreArray(data));
 }
 
+TEST(RapidsTriton, multi_buffer_tensor_collation)
+{
+  auto shape = std::vector<std::size_t>{4};
+  auto data  = std::vector<int>{1, 2, 3, 4};
+
+  // Adjacent buffers are copied by the constructor but may be viewed in place
+  auto adjacent = std::vector<Buffer<int>>{};
+  adjacent.emplace_back(data.data(), 2, HostMemory);
+  adjacent.emplace_back(data.data() + 2, 2, HostMemory);
+  auto owned = Tensor<int>(shape, adjacent.begin(), adjacent.end(), HostMemory, 0, cudaStream_t{});
+  EXPECT_NE(owned.data(), data.data());
+  EXPECT_THAT(std::vector<int>(owned.data(), owned.data() + owned.size()),
+              ::testing::ElementsAreArray(data));
+  auto view =
+    Tensor<int>::view_of(shape, adjacent.begin(), adjacent.end(), HostMemory, 0, cudaStream_t{});
+  EXPECT_EQ(view.data(), data.data());
+  EXPECT_EQ(view.size(), data.size());
+
+  // A single buffer is also copied unless a view is requested
+  auto single = std::vector<Buffer<int>>{};
+  single.emplace_back(data.data(), data.size(), HostMemory);
+  EXPECT_NE(Tensor<int>(shape, single.begin(), single.end(), HostMemory, 0, cudaStream_t{}).data(),
+            data.data());
+  EXPECT_EQ(
+    Tensor<int>::view_of(shape, single.begin(), single.end(), HostMemory, 0, cudaStream_t{}).data(),
+    data.data());
+
+  // Non-adjacent buffers must be copied
+  auto other  = std::vector<int>{5, 6};
+  auto gapped = std::vector<Buffer<int>>{};
+  gapped.emplace_back(data.data(), 2, HostMemory);
+  gapped.emplace_back(other.data(), 2, HostMemory);
+  gapped.emplace_back(data.data() + 2, 2, HostMemory);
+  auto collated = Tensor<int>::view_of(
+    std::vector<std::size_t>{6}, gapped.begin(), gapped.end(), HostMemory, 0, cudaStream_t{});
+  EXPECT_NE(collated.data(), data.data());
+  auto data_out = std::vector<int>(collated.data(), collated.data() + collated.size());
+  EXPECT_THAT(data_out, ::testing::ElementsAre(1, 2, 5, 6, 3, 4));
+}
+
 TEST(RapidsTriton, tensor_copy)
 {
   auto shape = std::vector<std::size_t>{2, 2};
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/tensor/tensor_shape.hpp>
+#include <utility>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, inline_tensor_shape)
+{
+  auto shape = TensorShape{2, 3};
+  EXPECT_EQ(shape.size(), 2);
+  EXPECT_THAT(shape, ::testing::ElementsAre(2, 3));
+  shape[0] = 4;
+  EXPECT_EQ(shape, (std::vector<std::size_t>{4, 3}));
+  EXPECT_NE(shape, TensorShape{4});
+
+  auto copied   = shape;
+  copied.back() = 5;
+  EXPECT_THAT(copied, ::testing::ElementsAre(4, 5));
+  EXPECT_THAT(shape, ::testing::ElementsAre(4, 3));
+  EXPECT_TRUE(TensorShape{}.empty());
+}
+
+TEST(RapidsTriton, large_tensor_shape)
+{
+  auto dims  = std::vector<std::size_t>{1, 2, 3, 4, 5, 6};
+  auto shape = TensorShape{dims};
+  EXPECT_EQ(shape.size(), dims.size());
+  EXPECT_THAT(shape, ::testing::ElementsAreArray(dims));
+
+  auto moved = std::move(shape);
+  EXPECT_THAT(moved, ::testing::ElementsAreArray(dims));
+  auto as_vector = std::vector<std::size_t>(moved);
+  EXPECT_EQ(as_vector, dims);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/tensor_view.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, tensor_view_rows)
+{
+  auto data   = std::vector<int>{1, 2, 3, 4, 5, 6};
+  auto tensor = Tensor<int>({3, 2}, Buffer<int>{data.data(), data.size(), HostMemory});
+  auto view   = TensorView{tensor};
+
+  EXPECT_EQ(view.data(), data.data());
+  EXPECT_THAT(view.strides(), ::testing::ElementsAre(2, 1));
+  EXPECT_EQ(view.is_contiguous(), true);
+
+  auto middle = view.rows(1, 2);
+  EXPECT_EQ(middle.data(), data.data() + 2);
+  EXPECT_THAT(middle.shape(), ::testing::ElementsAre(1, 2));
+  EXPECT_EQ(middle.size(), 2);
+
+  auto flat = view.rows(1, 3).reshape({4});
+  EXPECT_THAT(flat.shape(), ::testing::ElementsAre(4));
+  EXPECT_EQ(flat.data(), data.data() + 2);
+
+  EXPECT_THROW(view.rows(2, 4), TritonException);
+  EXPECT_THROW(view.reshape({4}), TritonException);
+}
+
+TEST(RapidsTriton, tensor_view_copy)
+{
+  auto data   = std::vector<int>{1, 2, 3, 4};
+  auto output = std::vector<int>(2);
+  auto src    = TensorView<int const>{data.data(), {2, 2}, HostMemory, 0, cudaStream_t{}};
+  auto dst    = TensorView<int>{output.data(), {1, 2}, HostMemory, 0, cudaStream_t{}};
+
+  copy(dst, src.rows(1, 2));
+  EXPECT_THAT(output, ::testing::ElementsAre(3, 4));
+
+  auto strided = TensorView<int const>{data.data(), {2}, HostMemory, 0, cudaStream_t{}, {2}};
+  EXPECT_EQ(strided.is_contiguous(), false);
+  EXPECT_THROW(copy(dst.reshape({2}), strided), TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/transforms.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, elementwise_transforms)
+{
+  auto data   = std::vector<float>{0.0f, 2.0f, -2.0f, 0.5f};
+  auto src    = Tensor<float>({2, 2}, Buffer<float>{data.data(), data.size(), HostMemory});
+  auto result = std::vector<float>(data.size());
+  auto dst    = Tensor<float>({2, 2}, Buffer<float>{result.data(), result.size(), HostMemory});
+
+  sigmoid(dst, src);
+  EXPECT_THAT(result,
+              ::testing::ElementsAre(::testing::FloatEq(0.5f),
+                                     ::testing::FloatNear(0.8807971f, 1e-6f),
+                                     ::testing::FloatNear(0.1192029f, 1e-6f),
+                                     ::testing::FloatNear(0.6224593f, 1e-6f)));
+
+  auto labels     = std::vector<std::int32_t>(data.size());
+  auto labels_dst = Tensor<std::int32_t>(
+    {2, 2}, Buffer<std::int32_t>{labels.data(), labels.size(), HostMemory});
+  threshold(labels_dst, src, 0.25f);
+  EXPECT_THAT(labels, ::testing::ElementsAre(0, 1, 0, 1));
+
+  auto mean  = std::vector<float>{1.0f, 0.5f};
+  auto scale = std::vector<float>{2.0f, 0.5f};
+  standardize(dst,
+              src,
+              Buffer<float>{mean.data(), mean.size(), HostMemory},
+              Buffer<float>{scale.data(), scale.size(), HostMemory});
+  EXPECT_THAT(result, ::testing::ElementsAre(-0.5f, 3.0f, -1.5f, 0.0f));
+
+  // Element-wise transforms may be applied in place
+  sigmoid(dst, dst);
+  EXPECT_FLOAT_EQ(result[3], 0.5f);
+
+  auto too_small = Tensor<float>({1}, Buffer<float>{result.data(), 1, HostMemory});
+  EXPECT_THROW(sigmoid(too_small, src), TritonException);
+}
+
+TEST(RapidsTriton, row_transforms)
+{
+  auto data = std::vector<float>{1.0f, 3.0f, 2.0f, 5.0f, 5.0f, -1.0f};
+  auto src  = Tensor<float>({2, 3}, Buffer<float>{data.data(), data.size(), HostMemory});
+
+  auto probabilities = std::vector<float>(data.size());
+  auto softmax_dst   = Tensor<float>(
+    {2, 3}, Buffer<float>{probabilities.data(), probabilities.size(), HostMemory});
+  softmax(softmax_dst, src);
+  EXPECT_NEAR(probabilities[0] + probabilities[1] + probabilities[2], 1.0f, 1e-6f);
+  EXPECT_NEAR(probabilities[1], 0.6652410f, 1e-6f);
+  EXPECT_FLOAT_EQ(probabilities[3], probabilities[4]);
+
+  auto classes    = std::vector<std::int64_t>(2);
+  auto argmax_dst =
+    Tensor<std::int64_t>({2}, Buffer<std::int64_t>{classes.data(), classes.size(), HostMemory});
+  argmax(argmax_dst, src);
+  EXPECT_THAT(classes, ::testing::ElementsAre(1, 0));
+
+  auto indices     = std::vector<std::int32_t>(4);
+  auto values      = std::vector<float>(4);
+  auto indices_dst = Tensor<std::int32_t>(
+    {2, 2}, Buffer<std::int32_t>{indices.data(), indices.size(), HostMemory});
+  auto values_dst =
+    Tensor<float>({2, 2}, Buffer<float>{values.data(), values.size(), HostMemory});
+  top_k(indices_dst, values_dst, src);
+  EXPECT_THAT(indices, ::testing::ElementsAre(1, 2, 0, 1));
+  EXPECT_THAT(values, ::testing::ElementsAre(3.0f, 2.0f, 5.0f, 5.0f));
+
+  auto columns   = std::vector<std::int32_t>{2, 0, 1};
+  auto reordered = std::vector<float>(data.size());
+  auto reordered_dst =
+    Tensor<float>({2, 3}, Buffer<float>{reordered.data(), reordered.size(), HostMemory});
+  select_columns(reordered_dst,
+                 src,
+                 Buffer<std::int32_t>{columns.data(), columns.size(), HostMemory});
+  EXPECT_THAT(reordered, ::testing::ElementsAre(2.0f, 1.0f, 3.0f, -1.0f, 5.0f, 5.0f));
+
+  // k may not exceed the number of columns
+  auto too_many_indices = Tensor<std::int32_t>({2, 4}, Buffer<std::int32_t>(8, HostMemory));
+  auto too_many_values  = Tensor<float>({2, 4}, Buffer<float>(8, HostMemory));
+  EXPECT_THROW(top_k(too_many_indices, too_many_values, src), TritonException);
+}
+
+TEST(RapidsTriton, transpose)
+{
+  // Span several host tiles in each dimension
+  auto rows = std::size_t{70};
+  auto cols = std::size_t{33};
+  auto data = std::vector<float>(rows * cols);
+  for (auto i = std::size_t{}; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i);
+  }
+  auto src = Tensor<float>({rows, cols}, Buffer<float>{data.data(), data.size(), HostMemory});
+
+  // Extra rows of the destination are filled with zeros
+  auto padded_rows = rows + 2;
+  auto result      = std::vector<float>(padded_rows * cols, -1.0f);
+  auto dst =
+    Tensor<float>({padded_rows, cols}, Buffer<float>{result.data(), result.size(), HostMemory});
+  transpose(dst, src);
+  for (auto col = std::size_t{}; col < cols; ++col) {
+    for (auto row = std::size_t{}; row < padded_rows; ++row) {
+      auto expected = (row < rows) ? data[row * cols + col] : 0.0f;
+      EXPECT_EQ(result[col * padded_rows + row], expected);
+    }
+  }
+
+  auto too_few_rows = Tensor<float>({rows - 1, cols}, Buffer<float>((rows - 1) * cols, HostMemory));
+  EXPECT_THROW(transpose(too_few_rows, src), TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <cuda_runtime_api.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <rapids_triton/memory/buffer.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/tensor/tensor.hpp>
+#include <rapids_triton/tensor/transforms.cuh>
+#include <rapids_triton/tensor/transforms.hpp>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+namespace {
+auto device_available()
+{
+  auto device_count = int{};
+  return cudaGetDeviceCount(&device_count) == cudaSuccess && device_count > 0;
+}
+
+template <typename T>
+auto to_device(std::vector<T>& data)
+{
+  return Buffer<T>(Buffer<T>{data.data(), data.size(), HostMemory}, DeviceMemory);
+}
+
+template <typename T>
+auto to_host(T* data, std::size_t size)
+{
+  auto result = Buffer<T>(Buffer<T>{data, size, DeviceMemory}, HostMemory);
+  result.stream_synchronize();
+  return std::vector<T>(result.data(), result.data() + result.size());
+}
+}  // namespace
+
+TEST(RapidsTriton, device_elementwise_transforms)
+{
+  if (!device_available()) { GTEST_SKIP() << "Device transforms require a device"; }
+  register_device_sigmoid<float, float>();
+  register_device_threshold<std::int32_t, float>();
+  register_device_standardize<float, float, float>();
+
+  // Neither a multiple of the vector size nor of the block size, so that
+  // both the vector loop and the scalar tail run
+  auto rows = std::size_t{1001};
+  auto cols = std::size_t{3};
+  auto size = rows * cols;
+  auto data = std::vector<float>(size + 1);
+  for (auto i = std::size_t{}; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i % 17) * 0.25f - 2.0f;
+  }
+  auto mean  = std::vector<float>{1.0f, 0.5f, -0.25f};
+  auto scale = std::vector<float>{2.0f, 0.5f, 4.0f};
+
+  auto device_data  = to_device(data);
+  auto device_mean  = to_device(mean);
+  auto device_scale = to_device(scale);
+
+  // Offsetting the source by one element misaligns it for vector loads
+  for (auto offset : {std::size_t{}, std::size_t{1}}) {
+    auto src = Tensor<float>({rows, cols}, Buffer<float>{data.data() + offset, size, HostMemory});
+    auto device_src =
+      Tensor<float>({rows, cols}, Buffer<float>{device_data.data() + offset, size, DeviceMemory});
+
+    auto expected = Tensor<float>({rows, cols}, Buffer<float>(size, HostMemory));
+    auto result   = Tensor<float>({rows, cols}, Buffer<float>(size, DeviceMemory));
+    sigmoid(expected, src);
+    sigmoid(result, device_src);
+    EXPECT_THAT(to_host(result.data(), size),
+                ::testing::Pointwise(::testing::FloatNear(1e-6f),
+                                     std::vector<float>(expected.data(), expected.data() + size)));
+
+    auto expected_labels =
+      Tensor<std::int32_t>({rows, cols}, Buffer<std::int32_t>(size, HostMemory));
+    auto labels = Tensor<std::int32_t>({rows, cols}, Buffer<std::int32_t>(size, DeviceMemory));
+    threshold(expected_labels, src, 0.3f);
+    threshold(labels, device_src, 0.3f);
+    EXPECT_THAT(to_host(labels.data(), size),
+                ::testing::ElementsAreArray(expected_labels.data(), size));
+
+    standardize(expected,
+                src,
+                Buffer<float>{mean.data(), mean.size(), HostMemory},
+                Buffer<float>{scale.data(), scale.size(), HostMemory});
+    standardize(result, device_src, device_mean, device_scale);
+    EXPECT_THAT(to_host(result.data(), size),
+                ::testing::Pointwise(::testing::FloatNear(1e-6f),
+                                     std::vector<float>(expected.data(), expected.data() + size)));
+  }
+}
+
+TEST(RapidsTriton, device_row_transforms)
+{
+  if (!device_available()) { GTEST_SKIP() << "Device transforms require a device"; }
+  register_device_select_columns<float, float, std::int32_t>();
+  register_device_transpose<float, float>();
+  register_device_softmax<float, float>();
+  register_device_argmax<std::int64_t, float>();
+  register_device_top_k<std::int32_t, float>();
+
+  // Span several tiles in each dimension, with distinct values so that
+  // ties cannot order the host and device results differently
+  auto rows = std::size_t{70};
+  auto cols = std::size_t{33};
+  auto size = rows * cols;
+  auto data = std::vector<float>(size);
+  for (auto i = std::size_t{}; i < size; ++i) {
+    data[i] = static_cast<float>((i * 37) % size) * 0.01f;
+  }
+  auto device_data = to_device(data);
+  auto src         = Tensor<float>({rows, cols}, Buffer<float>{data.data(), size, HostMemory});
+  auto device_src =
+    Tensor<float>({rows, cols}, Buffer<float>{device_data.data(), size, DeviceMemory});
+
+  auto columns        = std::vector<std::int32_t>{32, 0, 7, 7, 16};
+  auto device_columns = to_device(columns);
+  auto selected_size  = rows * columns.size();
+  auto expected_selected =
+    Tensor<float>({rows, columns.size()}, Buffer<float>(selected_size, HostMemory));
+  auto selected =
+    Tensor<float>({rows, columns.size()}, Buffer<float>(selected_size, DeviceMemory));
+  select_columns(
+    expected_selected, src, Buffer<std::int32_t>{columns.data(), columns.size(), HostMemory});
+  select_columns(selected, device_src, device_columns);
+  EXPECT_THAT(to_host(selected.data(), selected_size),
+              ::testing::ElementsAreArray(expected_selected.data(), selected_size));
+
+  auto padded_rows     = rows + 2;
+  auto transposed_size = padded_rows * cols;
+  auto expected_transposed =
+    Tensor<float>({padded_rows, cols}, Buffer<float>(transposed_size, HostMemory));
+  auto transposed =
+    Tensor<float>({padded_rows, cols}, Buffer<float>(transposed_size, DeviceMemory));
+  transpose(expected_transposed, src);
+  transpose(transposed, device_src);
+  EXPECT_THAT(to_host(transposed.data(), transposed_size),
+              ::testing::ElementsAreArray(expected_transposed.data(), transposed_size));
+
+  auto expected_probabilities = Tensor<float>({rows, cols}, Buffer<float>(size, HostMemory));
+  auto probabilities          = Tensor<float>({rows, cols}, Buffer<float>(size, DeviceMemory));
+  softmax(expected_probabilities, src);
+  softmax(probabilities, device_src);
+  EXPECT_THAT(
+    to_host(probabilities.data(), size),
+    ::testing::Pointwise(
+      ::testing::FloatNear(1e-6f),
+      std::vector<float>(expected_probabilities.data(), expected_probabilities.data() + size)));
+
+  auto expected_classes = Tensor<std::int64_t>({rows}, Buffer<std::int64_t>(rows, HostMemory));
+  auto classes          = Tensor<std::int64_t>({rows}, Buffer<std::int64_t>(rows, DeviceMemory));
+  argmax(expected_classes, src);
+  argmax(classes, device_src);
+  EXPECT_THAT(to_host(classes.data(), rows),
+              ::testing::ElementsAreArray(expected_classes.data(), rows));
+
+  auto k                = std::size_t{3};
+  auto expected_indices =
+    Tensor<std::int32_t>({rows, k}, Buffer<std::int32_t>(rows * k, HostMemory));
+  auto expected_values = Tensor<float>({rows, k}, Buffer<float>(rows * k, HostMemory));
+  auto indices = Tensor<std::int32_t>({rows, k}, Buffer<std::int32_t>(rows * k, DeviceMemory));
+  auto values  = Tensor<float>({rows, k}, Buffer<float>(rows * k, DeviceMemory));
+  top_k(expected_indices, expected_values, src);
+  top_k(indices, values, device_src);
+  EXPECT_THAT(to_host(indices.data(), rows * k),
+              ::testing::ElementsAreArray(expected_indices.data(), rows * k));
+  EXPECT_THAT(to_host(values.data(), rows * k),
+              ::testing::ElementsAreArray(expected_values.data(), rows * k));
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/triton/async_logger.hpp>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, async_logger)
+{
+  auto logger = async_logger{3};
+  EXPECT_EQ(logger.capacity(), 4);
+  for (auto i = 0; i < 16; ++i) {
+    logger.push(
+      TRITONSERVER_LOG_INFO, __FILE__, __LINE__, "Async test message " + std::to_string(i));
+  }
+  // Messages are only dropped while the ring is full
+  EXPECT_LE(logger.dropped(), 16);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -38,6 +38,13 @@ TEST(RapidsTriton, stream_logging)
   log_error() << "Streamed error test message";
 }
 
+TEST(RapidsTriton, disabled_stream_logging)
+{
+  auto stream = log_debug(__FILE__, __LINE__);
+  EXPECT_EQ(stream.bad(), !TRITONSERVER_LogIsEnabled(TRITONSERVER_LOG_VERBOSE));
+  stream << "Debug test message " << 1;
+}
+
 }  // namespace rapids
 }  // namespace backend
 }  // namespace triton
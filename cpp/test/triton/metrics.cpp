@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <rapids_triton/triton/metrics.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, latency_histogram)
+{
+  auto histogram = latency_histogram{};
+  histogram.observe(std::chrono::nanoseconds{500});
+  histogram.observe(std::chrono::microseconds{1});
+  histogram.observe(std::chrono::microseconds{3});
+  histogram.observe(std::chrono::seconds{60});
+  EXPECT_EQ(histogram.count(), 4);
+  EXPECT_EQ(histogram.sum(), 60000004);
+  EXPECT_EQ(histogram.bucket(0), 2);
+  EXPECT_EQ(histogram.bucket(1), 0);
+  EXPECT_EQ(histogram.bucket(2), 1);
+  EXPECT_EQ(histogram.bucket(latency_histogram::bucket_count - 1), 1);
+  EXPECT_EQ(*latency_histogram::upper_bound(3), 8);
+  EXPECT_FALSE(latency_histogram::upper_bound(latency_histogram::bucket_count - 1).has_value());
+}
+
+TEST(RapidsTriton, latency_metrics)
+{
+  auto metrics    = latency_metrics{"model", 1, "instance"};
+  auto start_time = std::chrono::steady_clock::now();
+  metrics.observe_batch(start_time,
+                        start_time + std::chrono::microseconds{10},
+                        start_time + std::chrono::microseconds{30},
+                        start_time + std::chrono::microseconds{40},
+                        start_time + std::chrono::microseconds{100});
+  EXPECT_EQ(metrics.get_histogram(execute_phase::collection).sum(), 10);
+  EXPECT_EQ(metrics.get_histogram(execute_phase::compute).sum(), 20);
+  EXPECT_EQ(metrics.get_histogram(execute_phase::output).sum(), 10);
+  EXPECT_EQ(metrics.get_histogram(execute_phase::completion).sum(), 60);
+  EXPECT_EQ(metrics.get_histogram(execute_phase::total).sum(), 100);
+  EXPECT_EQ(metrics.get_histogram(execute_phase::total).count(), 1);
+  metrics.publish();
+  EXPECT_EQ(std::string{phase_name(execute_phase::completion)}, std::string{"completion"});
+}
+
+TEST(RapidsTriton, memory_metrics)
+{
+  auto metrics = memory_metrics{"model", 1, "instance", 0};
+  metrics.publish(std::size_t{1} << 20, std::size_t{1} << 21);
+}
+
+TEST(RapidsTriton, staging_metrics)
+{
+  auto metrics = staging_metrics{"model", 1, "instance"};
+  metrics.publish(std::size_t{});
+  metrics.publish(std::size_t{1} << 20);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
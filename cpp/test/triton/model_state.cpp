@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/triton/model_state.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, launch_load)
+{
+  auto loaded = false;
+  auto load   = detail::launch_load([&loaded]() { loaded = true; });
+  detail::wait_for_load(load);
+  EXPECT_TRUE(loaded);
+  // Waiting is idempotent, and a default-constructed future needs no wait
+  detail::wait_for_load(load);
+  detail::wait_for_load(std::shared_future<void>{});
+
+  auto failed = detail::launch_load([]() { throw std::runtime_error("bad load"); });
+  EXPECT_THROW(detail::wait_for_load(failed), TritonException);
+  EXPECT_THROW(detail::wait_for_load(failed), TritonException);
+
+  // Each waiter may hand its error to Triton, so each receives its own
+  auto first = static_cast<TRITONSERVER_Error*>(nullptr);
+  try {
+    detail::wait_for_load(failed);
+  } catch (TritonException const& err) {
+    first = err.error();
+  }
+  try {
+    detail::wait_for_load(failed);
+  } catch (TritonException const& err) {
+    EXPECT_NE(err.error(), first);
+    EXPECT_EQ(std::string{err.what()}, std::string{TRITONSERVER_ErrorMessage(first)});
+  }
+  TRITONSERVER_ErrorDelete(first);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <rapids_triton/batch/batch_activity.hpp>
+#include <rapids_triton/memory/types.hpp>
+#include <rapids_triton/triton/performance_snapshot.hpp>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, performance_counters)
+{
+  auto activity = batch_activity{};
+  activity.add_input(HostMemory, 100);
+  activity.add_input(DeviceMemory, 400);
+  activity.add_output(PinnedMemory, 20);
+  activity.synchronizations = 2;
+  activity.scratch_hits     = 3;
+  activity.scratch_misses   = 1;
+
+  auto counters = performance_counters{};
+  counters.observe(activity, 3, 5);
+  counters.observe(activity, 1, 64);
+  counters.observe(batch_activity{}, 2, 0);
+
+  auto snapshot = counters.take();
+  EXPECT_EQ(snapshot.batches, 3);
+  EXPECT_EQ(snapshot.requests, 6);
+  EXPECT_EQ(snapshot.rows, 69);
+  EXPECT_EQ(snapshot.max_requests_per_batch, 3);
+  EXPECT_EQ(snapshot.batches_by_rows[0], 1);
+  EXPECT_EQ(snapshot.batches_by_rows[3], 1);
+  EXPECT_EQ(snapshot.batches_by_rows[7], 1);
+  EXPECT_EQ(snapshot.input_bytes[0], 200);
+  EXPECT_EQ(snapshot.input_bytes[2], 800);
+  EXPECT_EQ(snapshot.output_bytes[1], 40);
+  EXPECT_EQ(snapshot.synchronizations, 4);
+  EXPECT_EQ(snapshot.scratch_hits, 6);
+  EXPECT_EQ(snapshot.scratch_misses, 2);
+
+  // Taking a snapshot begins the next interval
+  EXPECT_EQ(counters.take().batches, 0);
+  EXPECT_EQ(performance_snapshot::row_bucket(std::size_t{1} << 40),
+            performance_snapshot::row_buckets - 1);
+}
+
+TEST(RapidsTriton, performance_snapshot_json)
+{
+  auto snapshot                   = performance_snapshot{};
+  snapshot.batches                = 2;
+  snapshot.requests               = 3;
+  snapshot.rows                   = 9;
+  snapshot.max_requests_per_batch = 2;
+  snapshot.batches_by_rows[1]     = 1;
+  snapshot.batches_by_rows[4]     = 1;
+  snapshot.input_bytes[2]         = 72;
+  snapshot.output_bytes[0]        = 36;
+  snapshot.synchronizations       = 2;
+  snapshot.scratch_misses         = 1;
+
+  EXPECT_EQ(snapshot.to_json("model \"a\"_0", std::chrono::duration<double>{1.5}),
+            "{\"instance\":\"model \\\"a\\\"_0\",\"interval_s\":1.5,\"batches\":2,"
+            "\"requests\":3,\"rows\":9,\"max_requests_per_batch\":2,"
+            "\"batches_by_rows\":{\"1\":1,\"8\":1},"
+            "\"input_bytes\":{\"host\":0,\"pinned\":0,\"device\":72},"
+            "\"output_bytes\":{\"host\":36,\"pinned\":0,\"device\":0},"
+            "\"synchronizations\":2,\"scratch_hits\":0,\"scratch_misses\":1}");
+}
+
+TEST(RapidsTriton, performance_exporter)
+{
+  auto path     =
+    (std::filesystem::temp_directory_path() / "rapids_triton_performance_snapshot.jsonl").string();
+  auto counters = performance_counters{};
+  std::remove(path.c_str());
+  {
+    auto exporter = performance_exporter{
+      "instance_0", std::chrono::milliseconds{10}, path, TRITONSERVER_LOG_INFO, counters};
+    counters.observe(batch_activity{}, 1, 1);
+  }
+  // Activity not yet exported is written when the exporter stops
+  auto file  = std::ifstream{path};
+  auto lines = std::size_t{};
+  auto line  = std::string{};
+  while (std::getline(file, line)) {
+    EXPECT_EQ(line.rfind("{\"instance\":\"instance_0\"", 0), 0);
+    ++lines;
+  }
+  EXPECT_EQ(lines, 1);
+  std::remove(path.c_str());
+
+  EXPECT_THROW(performance_exporter("instance_0",
+                                    std::chrono::milliseconds{10},
+                                    "/nonexistent/snapshots.jsonl",
+                                    TRITONSERVER_LOG_INFO,
+                                    counters),
+               TritonException);
+  EXPECT_EQ(parse_log_level("verbose"), TRITONSERVER_LOG_VERBOSE);
+  EXPECT_THROW(parse_log_level("loud"), TritonException);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+#include <gtest/gtest.h>
+
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/utils/cuda_event.hpp>
+#include <utility>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, cuda_event)
+{
+#ifdef TRITON_ENABLE_GPU
+  auto stream = cudaStream_t{};
+  cudaStreamCreate(&stream);
+  auto event = cuda_event{};
+  event.record(stream);
+  event.wait(cudaStream_t{});
+  event.synchronize();
+  EXPECT_EQ(event.query(), true);
+
+  auto moved = std::move(event);
+  EXPECT_EQ(event.get(), cudaEvent_t{});
+  EXPECT_NE(moved.get(), cudaEvent_t{});
+  cudaStreamDestroy(stream);
+#else
+  EXPECT_THROW(cuda_event{}, TritonException);
+#endif
+}
+
+TEST(RapidsTriton, timing_cuda_event)
+{
+#ifdef TRITON_ENABLE_GPU
+  auto stream = cudaStream_t{};
+  cudaStreamCreate(&stream);
+  auto start = cuda_event{true};
+  auto end   = cuda_event{true};
+  start.record(stream);
+  end.record(stream);
+  end.synchronize();
+  EXPECT_GE(end.elapsed_since(start).count(), 0);
+  cudaStreamDestroy(stream);
+#else
+  EXPECT_THROW(cuda_event{true}, TritonException);
+#endif
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <rapids_triton/utils/device_launcher.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace {
+struct fill_tag {};
+struct other_tag {};
+template <typename T>
+using fill_launcher = void(T*, std::size_t);
+
+template <typename T>
+void fill(T* dst, std::size_t len)
+{
+  for (auto i = std::size_t{}; i < len; ++i) {
+    dst[i] = T{1};
+  }
+}
+}  // namespace
+
+TEST(RapidsTriton, device_launcher)
+{
+  EXPECT_EQ((detail::get_device_launcher<fill_tag, fill_launcher<int>>()), nullptr);
+  detail::set_device_launcher<fill_tag, fill_launcher<int>>(&fill<int>);
+  auto* launch = detail::get_device_launcher<fill_tag, fill_launcher<int>>();
+  ASSERT_NE(launch, nullptr);
+  auto data = int{};
+  launch(&data, 1);
+  EXPECT_EQ(data, 1);
+  // Launchers are registered separately for each kernel and element type
+  EXPECT_EQ((detail::get_device_launcher<fill_tag, fill_launcher<float>>()), nullptr);
+  EXPECT_EQ((detail::get_device_launcher<other_tag, fill_launcher<int>>()), nullptr);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
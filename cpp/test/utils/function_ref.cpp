@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/utils/function_ref.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, function_ref)
+{
+  auto total   = 0;
+  auto counter = [&total](int value) {
+    total += value;
+    return total;
+  };
+  auto ref = function_ref<int(int)>{counter};
+  EXPECT_EQ(ref(2), 2);
+  EXPECT_EQ(ref(3), 5);
+  EXPECT_EQ(total, 5);
+
+  auto copy = ref;
+  EXPECT_EQ(copy(1), 6);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
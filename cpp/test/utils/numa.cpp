@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/utils/numa.hpp>
+#include <thread>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, numa)
+{
+  EXPECT_EQ(get_thread_numa_node(), -1);
+  EXPECT_TRUE(get_numa_node_cpus(-1).empty());
+  EXPECT_FALSE(get_device_numa_node(-1).has_value());
+
+  // Bind a separate thread so that the test thread's affinity is unchanged
+  if (get_numa_node_cpus(0).empty()) { GTEST_SKIP() << "NUMA topology unavailable"; }
+  auto bound = false;
+  auto node  = -1;
+  std::thread{[&bound, &node]() {
+    bound = bind_thread_to_numa_node(0);
+    node  = get_thread_numa_node();
+  }}.join();
+  EXPECT_TRUE(bound);
+  EXPECT_EQ(node, 0);
+  EXPECT_EQ(get_thread_numa_node(), -1);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
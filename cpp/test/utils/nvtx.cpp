@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <rapids_triton/utils/nvtx.hpp>
+#include <string>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+
+TEST(RapidsTriton, nvtx_range)
+{
+  set_nvtx_domain("rapids_triton_test");
+  auto outer = nvtx_range{"outer"};
+  {
+    auto inner = nvtx_range{"inner: ", 4, " requests, ", std::string{"16 bytes"}};
+  }
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TRITON_ENABLE_GPU
+#include <cuda_runtime_api.h>
+#endif
+#include <gtest/gtest.h>
+
+#include <rapids_triton/build_control.hpp>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/utils/stream_pool.hpp>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, stream_pool)
+{
+  auto pool = stream_pool{0};
+#ifdef TRITON_ENABLE_GPU
+  auto first_stream = cudaStream_t{};
+  {
+    auto first  = pool.acquire();
+    auto second = pool.acquire();
+    EXPECT_NE(first.get(), second.get());
+    first.wait_for(second.get());
+    second.join_into(first.get());
+    first_stream = first.get();
+  }
+  // Released streams should be reused rather than creating new ones
+  auto reused = pool.acquire();
+  EXPECT_EQ(reused.get(), first_stream);
+#else
+  EXPECT_THROW(pool.acquire(), TritonException);
+  stream_wait(cudaStream_t{}, cudaStream_t{});
+#endif
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2021, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/utils/thread_pool.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+TEST(RapidsTriton, parse_cpu_list)
+{
+  EXPECT_EQ(detail::parse_cpu_list(""), std::vector<int>{});
+  EXPECT_EQ(detail::parse_cpu_list("0-3,8"), (std::vector<int>{0, 1, 2, 3, 8}));
+  EXPECT_THROW(detail::parse_cpu_list("3-1"), TritonException);
+  EXPECT_THROW(detail::parse_cpu_list("a"), TritonException);
+}
+
+TEST(RapidsTriton, thread_pool)
+{
+  auto pool = thread_pool{3};
+  EXPECT_EQ(pool.size(), 3);
+
+  auto values = std::vector<int>(1000);
+  pool.parallel_for(0, values.size(), 7, [&values](auto begin, auto end) {
+    for (auto i = begin; i < end; ++i) {
+      values[i] = static_cast<int>(i);
+    }
+  });
+  EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 999 * 1000 / 2);
+
+  // Nested parallel loops must not deadlock
+  auto count = std::atomic<std::size_t>{};
+  pool.parallel_for(0, 8, 1, [&pool, &count](auto begin, auto end) {
+    pool.parallel_for(0, 100, [&count](auto begin, auto end) { count += end - begin; });
+  });
+  EXPECT_EQ(count.load(), 800);
+
+  EXPECT_THROW(pool.parallel_for(0, 10, 1,
+                                 [](auto begin, auto end) {
+                                   if (begin == 5) { throw std::runtime_error("failed"); }
+                                 }),
+               std::runtime_error);
+
+  auto submitted = std::atomic<int>{};
+  {
+    auto other = thread_pool{2};
+    for (auto i = 0; i < 10; ++i) {
+      other.submit([&submitted]() { ++submitted; });
+    }
+  }
+  EXPECT_EQ(submitted.load(), 10);
+
+  // Pools without workers run everything on the calling thread
+  auto empty = thread_pool{0};
+  auto total = std::size_t{};
+  empty.parallel_for(0, 10, 3, [&total](auto begin, auto end) { total += end - begin; });
+  EXPECT_EQ(total, 10);
+}
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2022, NVIDIA CORPORATION.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <rapids_triton/exceptions.hpp>
+#include <rapids_triton/tensor/dtype.hpp>
+#include <rapids_triton/utils/traffic_file.hpp>
+#include <string>
+#include <vector>
+
+namespace triton {
+namespace backend {
+namespace rapids {
+namespace {
+struct temporary_file {
+  temporary_file(std::string const& name)
+    : path{(std::filesystem::temp_directory_path() / name).string()}
+  {
+  }
+  ~temporary_file() { std::filesystem::remove(path); }
+
+  void write(std::vector<std::vector<std::byte>> const& chunks) const
+  {
+    auto stream = std::ofstream{path, std::ios::binary};
+    for (auto const& chunk : chunks) {
+      stream.write(reinterpret_cast<char const*>(chunk.data()), chunk.size());
+    }
+  }
+
+  std::string path;
+};
+
+auto encode_batch(std::chrono::nanoseconds offset, bool with_data)
+{
+  auto shape0 = std::vector<std::int64_t>{2, 3};
+  auto data0  = std::vector<float>{0, 1, 2, 3, 4, 5};
+  auto shape1 = std::vector<std::int64_t>{1};
+  auto data1  = std::vector<std::int32_t>{7};
+  auto record = traffic_record{offset, 2};
+  record.add_request(2);
+  auto* dst = record.add_input("input__0",
+                               DTypeFloat32,
+                               shape0.data(),
+                               shape0.size(),
+                               data0.size() * sizeof(float),
+                               with_data);
+  if (with_data) { std::memcpy(dst, data0.data(), data0.size() * sizeof(float)); }
+  dst = record.add_input(
+    "id", DTypeInt32, shape1.data(), shape1.size(), sizeof(std::int32_t), with_data);
+  if (with_data) { std::memcpy(dst, data1.data(), sizeof(std::int32_t)); }
+  record.add_request(0);
+  return std::move(record).release();
+}
+}  // namespace
+
+TEST(RapidsTriton, traffic_file_round_trip)
+{
+  auto file  = temporary_file{"rapids_triton_traffic_round_trip"};
+  auto start = std::chrono::system_clock::time_point{std::chrono::seconds{1650000000}};
+  file.write({encode_traffic_header(start),
+              encode_batch(std::chrono::nanoseconds{0}, true),
+              encode_batch(std::chrono::nanoseconds{2500}, false)});
+
+  auto reader = traffic_reader{file.path};
+  EXPECT_EQ(reader.start_time(), start);
+  ASSERT_EQ(reader.batches().size(), 2);
+
+  auto const& first = reader.batches()[0];
+  EXPECT_EQ(first.offset, std::chrono::nanoseconds{0});
+  ASSERT_EQ(first.requests.size(), 2);
+  ASSERT_EQ(first.requests[0].inputs.size(), 2);
+  EXPECT_EQ(first.requests[1].inputs.size(), 0);
+  auto const& input = first.requests[0].inputs[0];
+  EXPECT_EQ(input.name, "input__0");
+  EXPECT_EQ(input.dtype, DTypeFloat32);
+  EXPECT_EQ(input.shape, (std::vector<std::int64_t>{2, 3}));
+  ASSERT_EQ(input.byte_size, 6 * sizeof(float));
+  ASSERT_NE(input.data, nullptr);
+  auto values = std::vector<float>(6);
+  std::memcpy(values.data(), input.data, input.byte_size);
+  EXPECT_EQ(values, (std::vector<float>{0, 1, 2, 3, 4, 5}));
+  auto id = std::int32_t{};
+  std::memcpy(&id, first.requests[0].inputs[1].data, sizeof(id));
+  EXPECT_EQ(id, 7);
+
+  auto const& second = reader.batches()[1];
+  EXPECT_EQ(second.offset, std::chrono::nanoseconds{2500});
+  ASSERT_EQ(second.requests.size(), 2);
+  EXPECT_EQ(second.requests[0].inputs[1].name, "id");
+  EXPECT_EQ(second.requests[0].inputs[1].shape, (std::vector<std::int64_t>{1}));
+  EXPECT_EQ(second.requests[0].inputs[0].data, nullptr);
+  EXPECT_EQ(second.requests[0].inputs[1].data, nullptr);
+}
+
+TEST(RapidsTriton, traffic_file_truncated)
+{
+  auto file  = temporary_file{"rapids_triton_traffic_truncated"};
+  auto batch = encode_batch(std::chrono::nanoseconds{0}, true);
+  auto cut   = batch;
+  cut.resize(cut.size() / 2);
+  file.write({encode_traffic_header(std::chrono::system_clock::now()), batch, cut});
+
+  auto reader = traffic_reader{file.path};
+  EXPECT_EQ(reader.batches().size(), 1);
+}
+
+TEST(RapidsTriton, traffic_file_invalid)
+{
+  auto file = temporary_file{"rapids_triton_traffic_invalid"};
+  file.write({std::vector<std::byte>(64, std::byte{1})});
+  EXPECT_THROW(traffic_reader{file.path}, TritonException);
+  EXPECT_THROW(traffic_reader{file.path + ".missing"}, TritonException);
+}
+
+}  // namespace rapids
+}  // namespace backend
+}  // namespace triton
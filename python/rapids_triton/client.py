@@ -12,13 +12,22 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import threading
 import time
+from collections import deque
+from concurrent.futures import Future
+from uuid import uuid4
+
+import numpy as np
 
 from rapids_triton.triton.client import get_triton_client
 from rapids_triton.triton.io import create_triton_input, create_triton_output
 
 from rapids_triton.triton.dtype import dtype_to_triton_name
 from rapids_triton.triton.response import get_response_data
+from rapids_triton.triton.shared_memory import (
+    SHARED_MEMORY_TYPES, SharedMemoryPool, unregister_region
+)
 from tritonclient import utils as triton_utils
 
 
@@ -28,7 +37,8 @@ class Client(object):
             protocol='grpc',
             host='localhost',
             port=None,
-            concurrency=4):
+            concurrency=4,
+            reuse_shared_memory=True):
         self.triton_client = get_triton_client(
             protocol=protocol,
             host=host,
@@ -36,6 +46,18 @@ class Client(object):
             concurrency=concurrency
         )
         self._protocol = protocol
+        # Shared-memory regions are registered once and reused across calls
+        # unless reuse_shared_memory is False
+        self._shared_memory_pools = {
+            shared_mem: SharedMemoryPool(
+                self.triton_client, shared_mem=shared_mem
+            )
+            for shared_mem in SHARED_MEMORY_TYPES
+        } if reuse_shared_memory else {}
+        # Callbacks of requests awaiting a response on the gRPC stream, by
+        # request ID, or None if no stream is open
+        self._stream_lock = threading.Lock()
+        self._stream_requests = None
 
     @property
     def protocol(self):
@@ -48,7 +70,8 @@ class Client(object):
             name,
             dtype,
             protocol=self.protocol,
-            shared_mem=shared_mem
+            shared_mem=shared_mem,
+            pool=self._shared_memory_pools.get(shared_mem)
         )
 
     def create_output(self, size, name, shared_mem=None):
@@ -57,7 +80,8 @@ class Client(object):
             size,
             name,
             protocol=self.protocol,
-            shared_mem=shared_mem
+            shared_mem=shared_mem,
+            pool=self._shared_memory_pools.get(shared_mem)
         )
 
     def wait_for_server(self, timeout):
@@ -72,13 +96,51 @@ class Client(object):
                 raise RuntimeError("Server startup timeout expired")
             time.sleep(1)
 
+    def release_shared_memory(self, name, shared_mem='cuda'):
+        """Release a shared-memory region used by an input or output once
+        the response using it has been read"""
+        if shared_mem in self._shared_memory_pools:
+            self._shared_memory_pools[shared_mem].release(name)
+        else:
+            unregister_region(self.triton_client, shared_mem, name)
+
     def clear_shared_memory(self):
+        for pool in self._shared_memory_pools.values():
+            pool.clear()
         self.triton_client.unregister_cuda_shared_memory()
         self.triton_client.unregister_system_shared_memory()
 
     def get_model_config(self, model_name):
         return self.triton_client.get_model_config(model_name).config
 
+    def _create_request(self, input_data, output_sizes, shared_mem):
+        """Create the inputs and outputs of a request, releasing any
+        shared memory already acquired if one cannot be created"""
+        inputs = []
+        outputs = {}
+        try:
+            for name, arr in input_data.items():
+                inputs.append(self.create_input(
+                    arr,
+                    name,
+                    dtype_to_triton_name(arr.dtype),
+                    shared_mem=shared_mem
+                ))
+
+            for name, size in output_sizes.items():
+                outputs[name] = self.create_output(
+                    size, name, shared_mem=shared_mem
+                )
+        except Exception:
+            self._release_request(inputs, outputs, shared_mem)
+            raise
+        return inputs, outputs
+
+    def _release_request(self, inputs, outputs, shared_mem):
+        for io in inputs + list(outputs.values()):
+            if io.name is not None:
+                self.release_shared_memory(io.name, shared_mem)
+
     def predict(
             self,
             model_name,
@@ -89,22 +151,11 @@ class Client(object):
             attempts=1):
         model_version = str(model_version)
 
+        inputs, outputs = [], {}
         try:
-            inputs = [
-                self.create_input(
-                    arr,
-                    name,
-                    dtype_to_triton_name(arr.dtype),
-                    shared_mem=shared_mem
-                )
-                for name, arr in input_data.items()
-            ]
-
-            outputs = {
-                name: self.create_output(size, name, shared_mem=shared_mem)
-                for name, size in output_sizes.items()
-            }
-
+            inputs, outputs = self._create_request(
+                input_data, output_sizes, shared_mem
+            )
             response = self.triton_client.infer(
                 model_name,
                 model_version=model_version,
@@ -113,6 +164,7 @@ class Client(object):
             )
 
         except triton_utils.InferenceServerException:
+            self._release_request(inputs, outputs, shared_mem)
             if attempts > 1:
                 return self.predict(
                     model_name,
@@ -124,18 +176,176 @@ class Client(object):
                 )
             raise
         result = {
-            name: get_response_data(response, handle, name)
+            name: get_response_data(response, handle, name, shared_mem)
             for name, (_, handle, _) in outputs.items()
         }
 
-        for input_ in inputs:
-            if input_.name is not None:
-                self.triton_client.unregister_cuda_shared_memory(
-                    name=input_.name
+        self._release_request(inputs, outputs, shared_mem)
+        return result
+
+    def predict_async(
+            self,
+            model_name,
+            input_data,
+            output_sizes,
+            model_version='1',
+            shared_mem=None,
+            stream=False):
+        """Send a request without waiting for its response
+
+        Any number of requests may be outstanding at once, so that a single
+        thread can keep the server busy. Only the gRPC protocol is supported.
+
+        :param bool stream: Send the request over this client's gRPC stream,
+            which is opened on first use, rather than as a separate RPC
+        :return: A concurrent.futures.Future resolving to the same dict of
+            outputs as predict
+        """
+        if self.protocol != 'grpc':
+            raise RuntimeError(
+                "Asynchronous prediction requires the grpc protocol"
+            )
+        model_version = str(model_version)
+        future = Future()
+
+        inputs, outputs = self._create_request(
+            input_data, output_sizes, shared_mem
+        )
+
+        def complete(response, error):
+            try:
+                if error is not None:
+                    raise error
+                future.set_result({
+                    name: get_response_data(
+                        response, handle, name, shared_mem
+                    )
+                    for name, (_, handle, _) in outputs.items()
+                })
+            except Exception as err:
+                future.set_exception(err)
+            finally:
+                self._release_request(inputs, outputs, shared_mem)
+
+        request = dict(
+            inputs=[input_.input for input_ in inputs],
+            outputs=[output_.output for output_ in outputs.values()],
+            model_version=model_version
+        )
+        try:
+            if stream:
+                request_id = uuid4().hex
+                with self._stream_lock:
+                    if self._stream_requests is None:
+                        self.triton_client.start_stream(
+                            callback=self._complete_streamed
+                        )
+                        self._stream_requests = {}
+                    self._stream_requests[request_id] = complete
+                self.triton_client.async_stream_infer(
+                    model_name, request_id=request_id, **request
                 )
-        for output_ in outputs.values():
-            if output_.name is not None:
-                self.triton_client.unregister_cuda_shared_memory(
-                    name=output_.name
+            else:
+                self.triton_client.async_infer(
+                    model_name, callback=complete, **request
                 )
-        return result
+        except Exception:
+            if stream:
+                with self._stream_lock:
+                    if self._stream_requests is not None:
+                        self._stream_requests.pop(request_id, None)
+            self._release_request(inputs, outputs, shared_mem)
+            raise
+        return future
+
+    def _complete_streamed(self, response, error):
+        with self._stream_lock:
+            if response is not None:
+                request_id = response.get_response().id
+                callbacks = [self._stream_requests.pop(request_id, None)]
+            else:
+                # Errors on the stream do not identify their request, so
+                # every outstanding streamed request fails
+                callbacks = list(self._stream_requests.values())
+                self._stream_requests.clear()
+        for callback in callbacks:
+            if callback is not None:
+                callback(response, error)
+
+    def stop_stream(self):
+        """Close the gRPC stream opened by predict_async, failing any
+        request still awaiting a response on it"""
+        with self._stream_lock:
+            if self._stream_requests is None:
+                return
+            self.triton_client.stop_stream()
+            callbacks = list(self._stream_requests.values())
+            self._stream_requests = None
+        for callback in callbacks:
+            callback(None, RuntimeError("Stream closed before response"))
+
+    def predict_batched(
+            self,
+            model_name,
+            input_data,
+            output_sizes,
+            batch_size=None,
+            max_in_flight=4,
+            model_version='1',
+            shared_mem=None,
+            stream=False):
+        """Predict on inputs of any number of rows by splitting them into
+        micro-batches which are pipelined through predict_async
+
+        Offline scoring of a large array in a single request leaves the
+        server idle while it is serialized and sent and the client idle
+        while it is processed. Here up to max_in_flight micro-batches are
+        outstanding at once, so that transfer and execution overlap.
+
+        :param input_data: A dict of input arrays by name, which must share
+            their first (batch) dimension
+        :param output_sizes: A dict of the size in bytes of each output for
+            all rows of input_data; each micro-batch's outputs are sized in
+            proportion to its rows
+        :param int batch_size: The rows in each micro-batch, or None for the
+            model's max_batch_size
+        :param int max_in_flight: The number of micro-batches which may be
+            outstanding at once
+        :return: A dict of output arrays by name, concatenated along their
+            first dimension in the order of the input rows
+        """
+        rows = len(next(iter(input_data.values())))
+        if batch_size is None:
+            batch_size = self.get_model_config(model_name).max_batch_size
+        if batch_size <= 0 or batch_size >= rows:
+            return self.predict(
+                model_name,
+                input_data,
+                output_sizes,
+                model_version=model_version,
+                shared_mem=shared_mem
+            )
+
+        pending = deque()
+        results = []
+        for begin in range(0, rows, batch_size):
+            end = min(begin + batch_size, rows)
+            if len(pending) >= max_in_flight:
+                results.append(pending.popleft().result())
+            pending.append(self.predict_async(
+                model_name,
+                {name: arr[begin:end] for name, arr in input_data.items()},
+                {
+                    name: size * (end - begin) // rows
+                    for name, size in output_sizes.items()
+                },
+                model_version=model_version,
+                shared_mem=shared_mem,
+                stream=stream
+            ))
+        results.extend(future.result() for future in pending)
+
+        return {
+            name: np.concatenate([result[name] for result in results])
+            for name in results[0]
+        }
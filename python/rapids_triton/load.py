@@ -0,0 +1,285 @@
+# Copyright (c) 2022, NVIDIA CORPORATION.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import threading
+import time
+
+import numpy as np
+
+from rapids_triton.client import Client
+from tritonclient import utils as triton_utils
+
+PERCENTILES = (50, 90, 99, 99.9)
+
+# Cumulative durations reported in a model's inference statistics
+STATISTICS_DURATIONS = (
+    'success', 'queue', 'compute_input', 'compute_infer', 'compute_output'
+)
+
+
+def get_model_statistics(client, model_name, model_version='1'):
+    """Return the cumulative inference statistics Triton reports for a model
+
+    :param Client client: A client connected to the server
+    :param str model_name: The name of the model
+    :param str model_version: The version of the model
+    :return: A dict with the total number of inferences, executions and
+        successful requests and, for each entry of STATISTICS_DURATIONS, the
+        nanoseconds spent summed over requests
+    """
+    if client.protocol == 'grpc':
+        response = client.triton_client.get_inference_statistics(
+            model_name, model_version=str(model_version), as_json=True
+        )
+    else:
+        response = client.triton_client.get_inference_statistics(
+            model_name, model_version=str(model_version)
+        )
+    stats = response['model_stats'][0]
+    inference_stats = stats.get('inference_stats', {})
+    # Protobuf encodes 64-bit integers in JSON as strings, and omits zeros
+    result = {
+        'inference_count': int(stats.get('inference_count', 0)),
+        'execution_count': int(stats.get('execution_count', 0)),
+        'success_count': int(
+            inference_stats.get('success', {}).get('count', 0)
+        )
+    }
+    for name in STATISTICS_DURATIONS:
+        result[name] = int(inference_stats.get(name, {}).get('ns', 0))
+    return result
+
+
+class LoadReport(object):
+    """The outcome of a run of :func:`run_load`
+
+    Latencies are in milliseconds. Server times are the mean per request
+    over the measured interval, as reported by Triton's statistics
+    endpoint.
+    """
+    def __init__(self, latencies, rows, failures, duration, before, after):
+        self.requests = len(latencies)
+        self.rows = rows
+        self.failures = failures
+        self.duration = duration
+        latencies = np.array(latencies) * 1e3
+        self.latency_mean = (
+            float(latencies.mean()) if latencies.size else 0.0
+        )
+        self.latency_percentiles = {
+            percentile: (
+                float(np.percentile(latencies, percentile))
+                if latencies.size else 0.0
+            )
+            for percentile in PERCENTILES
+        }
+
+        self.server_inferences = (
+            after['inference_count'] - before['inference_count']
+        )
+        self.server_executions = (
+            after['execution_count'] - before['execution_count']
+        )
+        server_requests = max(
+            after['success_count'] - before['success_count'], 1
+        )
+        self.server_times = {
+            name: (after[name] - before[name]) / 1e6 / server_requests
+            for name in STATISTICS_DURATIONS
+        }
+
+    @property
+    def throughput(self):
+        """Completed requests per second"""
+        return self.requests / self.duration
+
+    @property
+    def row_throughput(self):
+        """Rows of completed requests per second"""
+        return self.rows / self.duration
+
+    def as_dict(self):
+        """Return the report's measurements as a JSON-serializable dict"""
+        return {
+            'requests': self.requests,
+            'rows': self.rows,
+            'failures': self.failures,
+            'duration': self.duration,
+            'throughput': self.throughput,
+            'row_throughput': self.row_throughput,
+            'latency_mean': self.latency_mean,
+            'latency_percentiles': {
+                f'p{percentile:g}': value
+                for percentile, value in self.latency_percentiles.items()
+            },
+            'server_inferences': self.server_inferences,
+            'server_executions': self.server_executions,
+            'server_times': self.server_times
+        }
+
+    def __str__(self):
+        percentiles = ', '.join(
+            f'p{percentile:g} {value:.2f}'
+            for percentile, value in self.latency_percentiles.items()
+        )
+        server_times = ', '.join(
+            f'{name} {value:.3f}'
+            for name, value in self.server_times.items()
+        )
+        mean_batch = self.server_inferences / max(self.server_executions, 1)
+        return '\n'.join([
+            f'Requests: {self.requests} completed, {self.failures} failed'
+            f' in {self.duration:.2f} s',
+            f'Throughput: {self.throughput:.1f} requests/s,'
+            f' {self.row_throughput:.1f} rows/s',
+            f'Latency (ms): mean {self.latency_mean:.2f}, {percentiles}',
+            f'Server executions: {self.server_executions},'
+            f' mean batch {mean_batch:.1f} rows',
+            f'Server time (ms): {server_times}'
+        ])
+
+
+def _batch_size_sampler(batch_sizes):
+    """Return a function drawing the rows of a request from batch_sizes,
+    which may be an int, a sequence of ints chosen among uniformly, or a
+    function of a numpy Generator"""
+    if callable(batch_sizes):
+        return batch_sizes
+    if np.ndim(batch_sizes) == 0:
+        return lambda rng: int(batch_sizes)
+    choices = np.asarray(batch_sizes)
+    return lambda rng: int(rng.choice(choices))
+
+
+def run_load(
+        model_name,
+        make_inputs,
+        output_sizes,
+        concurrency=4,
+        batch_sizes=1,
+        target_qps=None,
+        duration=10.0,
+        warmup=2.0,
+        model_version='1',
+        shared_mem=None,
+        protocol='grpc',
+        host='localhost',
+        port=None,
+        seed=0):
+    """Send requests to a model for a fixed time and measure their latency
+
+    Each of `concurrency` workers has its own Client and sends one request
+    at a time. Without a target rate, every worker sends its next request as
+    soon as the last completes. With `target_qps`, requests are instead
+    scheduled at that rate and latency is measured from each request's
+    scheduled time, so that time spent waiting for a free worker is counted
+    rather than hidden.
+
+    :param str model_name: The name of the model
+    :param make_inputs: A function of a row count and a numpy Generator
+        returning a dict of input arrays by name
+    :param output_sizes: A function of a row count returning a dict of the
+        size in bytes of each output by name
+    :param int concurrency: The number of requests which may be outstanding
+        at once
+    :param batch_sizes: The rows in each request: an int, a sequence of ints
+        from which each request's is chosen uniformly, or a function of a
+        numpy Generator returning an int
+    :param float target_qps: The rate at which requests are sent, or None to
+        send them as fast as the workers allow
+    :param float duration: The seconds for which load is measured
+    :param float warmup: The seconds of load sent before measurement begins
+    :param str model_version: The version of the model
+    :param shared_mem: None, 'cuda' or 'system' for the memory through which
+        inputs and outputs are passed
+    :param str protocol: 'grpc' or 'http'
+    :param str host: The host of the server
+    :param int port: The port of the server, or None for the protocol's
+        standard port
+    :param int seed: The seed from which each worker's inputs are generated
+    :return: A LoadReport for the measured interval
+    """
+    sample_rows = _batch_size_sampler(batch_sizes)
+    clients = [
+        Client(protocol=protocol, host=host, port=port, concurrency=1)
+        for _ in range(concurrency)
+    ]
+    stats_client = Client(protocol=protocol, host=host, port=port)
+    lock = threading.Lock()
+    latencies = []
+    rows = 0
+    failures = 0
+    next_request = 0
+
+    start = time.perf_counter()
+    measure_start = start + warmup
+    measure_end = measure_start + duration
+
+    def worker(client, worker_seed):
+        nonlocal rows, failures, next_request
+        rng = np.random.default_rng(worker_seed)
+        while True:
+            if target_qps is None:
+                scheduled = time.perf_counter()
+            else:
+                with lock:
+                    index = next_request
+                    next_request += 1
+                scheduled = start + index / target_qps
+                delay = scheduled - time.perf_counter()
+                if delay > 0:
+                    time.sleep(delay)
+            if scheduled >= measure_end:
+                break
+            request_rows = sample_rows(rng)
+            inputs = make_inputs(request_rows, rng)
+            sizes = output_sizes(request_rows)
+            if target_qps is None:
+                scheduled = time.perf_counter()
+            try:
+                client.predict(
+                    model_name,
+                    inputs,
+                    sizes,
+                    model_version=model_version,
+                    shared_mem=shared_mem
+                )
+                succeeded = True
+            except triton_utils.InferenceServerException:
+                succeeded = False
+            end = time.perf_counter()
+            if scheduled < measure_start:
+                continue
+            with lock:
+                if succeeded:
+                    latencies.append(end - scheduled)
+                    rows += request_rows
+                else:
+                    failures += 1
+
+    threads = [
+        threading.Thread(target=worker, args=(client, (seed, i)), daemon=True)
+        for i, client in enumerate(clients)
+    ]
+    for thread in threads:
+        thread.start()
+
+    time.sleep(max(measure_start - time.perf_counter(), 0))
+    before = get_model_statistics(stats_client, model_name, model_version)
+    time.sleep(max(measure_end - time.perf_counter(), 0))
+    after = get_model_statistics(stats_client, model_name, model_version)
+    for thread in threads:
+        thread.join()
+
+    return LoadReport(latencies, rows, failures, duration, before, after)
@@ -16,6 +16,7 @@ import os
 
 import numpy as np
 
+from rapids_triton.load import LoadReport, get_model_statistics, run_load
 from rapids_triton.logging import logger
 from rapids_triton.triton.client import STANDARD_PORTS
 from rapids_triton.client import Client
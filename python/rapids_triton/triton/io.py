@@ -17,12 +17,10 @@ from uuid import uuid4
 
 import tritonclient.http as triton_http
 import tritonclient.grpc as triton_grpc
-from rapids_triton.utils.safe_import import ImportReplacement
+from rapids_triton.triton.shared_memory import (
+    SHARED_MEMORY_TYPES, create_region, register_region, set_region_contents
+)
 from tritonclient import utils as triton_utils
-try:
-    import tritonclient.utils.cuda_shared_memory as shm
-except OSError:  # CUDA libraries not available
-    shm = ImportReplacement('tritonclient.utils.cuda_shared_memory')
 
 
 TritonInput = namedtuple('TritonInput', ('name', 'input'))
@@ -37,19 +35,29 @@ def set_unshared_input_data(triton_input, data, protocol='grpc'):
     return None
 
 
-def set_shared_input_data(triton_client, triton_input, data, protocol='grpc'):
+def set_shared_input_data(
+        triton_client,
+        triton_input,
+        data,
+        protocol='grpc',
+        shared_mem='cuda',
+        pool=None):
     input_size = data.size * data.itemsize
 
+    if pool is not None:
+        input_name, input_handle = pool.acquire(input_size)
+        set_region_contents(shared_mem, input_handle, data)
+        triton_input.set_shared_memory(input_name, input_size)
+        return input_name
+
     input_name = 'input_{}'.format(uuid4().hex)
 
-    input_handle = shm.create_shared_memory_region(
-        input_name, input_size, 0
-    )
+    input_handle = create_region(shared_mem, input_name, input_size)
 
-    shm.set_shared_memory_region(input_handle, [data])
+    set_region_contents(shared_mem, input_handle, data)
 
-    triton_client.register_cuda_shared_memory(
-        input_name, shm.get_raw_handle(input_handle), 0, input_size
+    register_region(
+        triton_client, shared_mem, input_name, input_handle, input_size
     )
 
     triton_input.set_shared_memory(input_name, input_size)
@@ -62,20 +70,32 @@ def set_input_data(
         triton_input,
         data,
         protocol='grpc',
-        shared_mem=None):
+        shared_mem=None,
+        pool=None):
     if shared_mem is None:
         return set_unshared_input_data(
             triton_input, data, protocol=protocol
         )
-    if shared_mem == 'cuda':
+    if shared_mem in SHARED_MEMORY_TYPES:
         return set_shared_input_data(
-            triton_client, triton_input, data, protocol=protocol
+            triton_client,
+            triton_input,
+            data,
+            protocol=protocol,
+            shared_mem=shared_mem,
+            pool=pool
         )
     raise RuntimeError("Unsupported shared memory type")
 
 
 def create_triton_input(
-        triton_client, data, name, dtype, protocol='grpc', shared_mem=None):
+        triton_client,
+        data,
+        name,
+        dtype,
+        protocol='grpc',
+        shared_mem=None,
+        pool=None):
     if protocol == 'grpc':
         triton_input = triton_grpc.InferInput(name, data.shape, dtype)
     else:
@@ -86,23 +106,28 @@ def create_triton_input(
         triton_input,
         data,
         protocol=protocol,
-        shared_mem=shared_mem
+        shared_mem=shared_mem,
+        pool=pool
     )
 
     return TritonInput(name=input_name, input=triton_input)
 
 
-def create_output_handle(triton_client, triton_output, size, shared_mem=None):
+def create_output_handle(
+        triton_client, triton_output, size, shared_mem=None, pool=None):
     if shared_mem is None:
         return (None, None)
 
+    if pool is not None:
+        output_name, output_handle = pool.acquire(size)
+        triton_output.set_shared_memory(output_name, size)
+        return output_name, output_handle
+
     output_name = 'output_{}'.format(uuid4().hex)
-    output_handle = shm.create_shared_memory_region(
-        output_name, size, 0
-    )
+    output_handle = create_region(shared_mem, output_name, size)
 
-    triton_client.register_cuda_shared_memory(
-        output_name, shm.get_raw_handle(output_handle), 0, size
+    register_region(
+        triton_client, shared_mem, output_name, output_handle, size
     )
 
     triton_output.set_shared_memory(output_name, size)
@@ -111,7 +136,12 @@ def create_output_handle(triton_client, triton_output, size, shared_mem=None):
 
 
 def create_triton_output(
-        triton_client, size, name, protocol='grpc', shared_mem=None):
+        triton_client,
+        size,
+        name,
+        protocol='grpc',
+        shared_mem=None,
+        pool=None):
     """Set up output memory in Triton
 
     Parameters
@@ -124,6 +154,11 @@ def create_triton_output(
         The model-defined name for this output
     protocol : 'grpc' or 'http'
         The protocol used for communication with the server
+    shared_mem : None, 'cuda' or 'system'
+        The type of shared memory in which the output is returned
+    pool : SharedMemoryPool or None
+        The pool from which a shared-memory region is taken, or None to
+        create and register a new region
     """
     if protocol == 'grpc':
         triton_output = triton_grpc.InferRequestedOutput(name)
@@ -133,7 +168,7 @@ def create_triton_output(
         )
 
     output_name, output_handle = create_output_handle(
-        triton_client, triton_output, size, shared_mem=shared_mem
+        triton_client, triton_output, size, shared_mem=shared_mem, pool=pool
     )
 
     return TritonOutput(
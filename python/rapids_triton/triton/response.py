@@ -15,14 +15,11 @@
 from tritonclient import utils as triton_utils
 
 from rapids_triton.triton.message import TritonMessage
-from rapids_triton.utils.safe_import import ImportReplacement
-try:
-    import tritonclient.utils.cuda_shared_memory as shm
-except OSError:  # CUDA libraries not available
-    shm = ImportReplacement('tritonclient.utils.cuda_shared_memory')
+from rapids_triton.triton.shared_memory import get_region_contents
 
 
-def get_response_data(response, output_handle, output_name):
+def get_response_data(
+        response, output_handle, output_name, shared_mem='cuda'):
     """Convert Triton response to NumPy array"""
     if output_handle is None:
         return response.as_numpy(output_name)
@@ -30,7 +27,8 @@ def get_response_data(response, output_handle, output_name):
         network_result = TritonMessage(
             response.get_output(output_name)
         )
-        return shm.get_contents_as_numpy(
+        return get_region_contents(
+            shared_mem,
             output_handle,
             triton_utils.triton_to_np_dtype(network_result.datatype),
             network_result.shape
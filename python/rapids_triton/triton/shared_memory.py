@@ -0,0 +1,175 @@
+# Copyright (c) 2022, NVIDIA CORPORATION.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import threading
+from collections import defaultdict
+from uuid import uuid4
+
+from rapids_triton.utils.safe_import import ImportReplacement
+try:
+    import tritonclient.utils.cuda_shared_memory as shm
+except OSError:  # CUDA libraries not available
+    shm = ImportReplacement('tritonclient.utils.cuda_shared_memory')
+try:
+    import tritonclient.utils.shared_memory as system_shm
+except OSError:  # Shared-memory library not available
+    system_shm = ImportReplacement('tritonclient.utils.shared_memory')
+
+SHARED_MEMORY_TYPES = ('cuda', 'system')
+
+
+def create_region(shared_mem, name, byte_size, device_id=0):
+    """Create a shared-memory region of the given type ('cuda' or 'system')
+    and return its handle"""
+    if shared_mem == 'cuda':
+        return shm.create_shared_memory_region(name, byte_size, device_id)
+    if shared_mem == 'system':
+        return system_shm.create_shared_memory_region(
+            name, '/{}'.format(name), byte_size
+        )
+    raise RuntimeError("Unsupported shared memory type")
+
+
+def register_region(
+        triton_client, shared_mem, name, handle, byte_size, device_id=0):
+    """Register a region created with create_region with the server"""
+    if shared_mem == 'cuda':
+        triton_client.register_cuda_shared_memory(
+            name, shm.get_raw_handle(handle), device_id, byte_size
+        )
+    else:
+        triton_client.register_system_shared_memory(
+            name, '/{}'.format(name), byte_size
+        )
+
+
+def unregister_region(triton_client, shared_mem, name):
+    if shared_mem == 'cuda':
+        triton_client.unregister_cuda_shared_memory(name=name)
+    else:
+        triton_client.unregister_system_shared_memory(name=name)
+
+
+def destroy_region(shared_mem, handle):
+    if shared_mem == 'cuda':
+        shm.destroy_shared_memory_region(handle)
+    else:
+        system_shm.destroy_shared_memory_region(handle)
+
+
+def set_region_contents(shared_mem, handle, data):
+    """Copy a numpy array to the start of a region"""
+    if shared_mem == 'cuda':
+        shm.set_shared_memory_region(handle, [data])
+    else:
+        system_shm.set_shared_memory_region(handle, [data])
+
+
+def get_region_contents(shared_mem, handle, dtype, shape):
+    """Read a numpy array of the given type and shape from the start of a
+    region"""
+    if shared_mem == 'cuda':
+        return shm.get_contents_as_numpy(handle, dtype, shape)
+    # Unlike the CUDA version, this is a view of the region, which may be
+    # reused once released
+    return system_shm.get_contents_as_numpy(handle, dtype, shape).copy()
+
+
+class SharedMemoryPool:
+    """A pool of shared-memory regions which are registered with the server
+    once and then reused
+
+    Creating and registering a region for every input and output of every
+    request costs more RPCs than the inference itself. Regions are instead
+    sized in powers of two and kept once released, so that a later tensor of
+    similar size reuses one which the server already knows.
+
+    Parameters
+    ----------
+    triton_client : Triton client object
+        The client used to register regions with the server
+    shared_mem : 'cuda' or 'system'
+        The type of shared memory in the pool
+    device_id : int
+        The device on which CUDA regions are allocated
+    min_byte_size : int
+        The size of the smallest region
+    """
+    def __init__(
+            self,
+            triton_client,
+            shared_mem='cuda',
+            device_id=0,
+            min_byte_size=4096):
+        if shared_mem not in SHARED_MEMORY_TYPES:
+            raise RuntimeError("Unsupported shared memory type")
+        self.triton_client = triton_client
+        self.shared_mem = shared_mem
+        self.device_id = device_id
+        self.min_byte_size = min_byte_size
+        self._lock = threading.Lock()
+        self._free = defaultdict(list)
+        # Every region the pool has created, by name, as (handle, byte_size)
+        self._regions = {}
+
+    def _bucket(self, byte_size):
+        bucket = self.min_byte_size
+        while bucket < byte_size:
+            bucket *= 2
+        return bucket
+
+    def acquire(self, byte_size):
+        """Return the name and handle of a registered region holding at least
+        byte_size bytes, which is reserved until it is released"""
+        bucket = self._bucket(byte_size)
+        with self._lock:
+            if self._free[bucket]:
+                name = self._free[bucket].pop()
+                return name, self._regions[name][0]
+
+        name = 'rapids_triton_{}'.format(uuid4().hex)
+        handle = create_region(self.shared_mem, name, bucket, self.device_id)
+        try:
+            register_region(
+                self.triton_client,
+                self.shared_mem,
+                name,
+                handle,
+                bucket,
+                self.device_id
+            )
+        except Exception:
+            destroy_region(self.shared_mem, handle)
+            raise
+        with self._lock:
+            self._regions[name] = (handle, bucket)
+        return name, handle
+
+    def release(self, name):
+        """Return a region obtained from acquire to the pool"""
+        with self._lock:
+            region = self._regions.get(name)
+            if region is not None:
+                self._free[region[1]].append(name)
+
+    def clear(self):
+        """Unregister and free every region the pool has created, none of
+        which may still be in use"""
+        with self._lock:
+            regions = self._regions
+            self._regions = {}
+            self._free = defaultdict(list)
+        for name, (handle, _) in regions.items():
+            unregister_region(self.triton_client, self.shared_mem, name)
+            destroy_region(self.shared_mem, handle)
@@ -0,0 +1,55 @@
+# Copyright (c) 2022, NVIDIA CORPORATION.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import numpy as np
+import pytest
+
+from rapids_triton import Client
+from rapids_triton.testing import get_random_seed, run_load
+
+
+def make_inputs(rows, rng):
+    return {'input__0': rng.random((rows, 1), dtype='float32')}
+
+
+def output_sizes(rows):
+    return {'output__0': rows * np.dtype('float32').itemsize}
+
+
+@pytest.fixture(scope='session')
+def client():
+    client = Client()
+    client.wait_for_server(60)
+    return client
+
+
+@pytest.mark.parametrize("model_name", ['identity'])
+@pytest.mark.parametrize("target_qps", [None, 200])
+def test_load(client, model_name, target_qps):
+    report = run_load(
+        model_name,
+        make_inputs,
+        output_sizes,
+        concurrency=4,
+        batch_sizes=[1, 16, 256],
+        target_qps=target_qps,
+        duration=2.0,
+        warmup=0.5,
+        seed=get_random_seed()
+    )
+    print(report)
+    assert report.failures == 0
+    assert report.requests > 0
+    percentiles = list(report.latency_percentiles.values())
+    assert percentiles == sorted(percentiles)
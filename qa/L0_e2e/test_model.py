@@ -23,7 +23,7 @@ from rapids_triton.testing import get_random_seed, arrays_close
 TOTAL_SAMPLES = 8192
 
 def valid_shm_modes():
-    modes = [None]
+    modes = [None, 'system']
     if os.environ.get('CPU_ONLY', 0) == 0:
         modes.append('cuda')
     return modes
@@ -67,3 +67,28 @@ def test_model(client, model_name, shared_mem, model_inputs, model_output_sizes)
             atol=1e-5,
             assert_close=True
         )
+
+
+@pytest.mark.parametrize("model_name", ['identity'])
+@pytest.mark.parametrize("shared_mem", valid_shm_modes())
+@pytest.mark.parametrize("stream", [False, True])
+def test_model_batched(
+        client, model_name, shared_mem, stream, model_inputs,
+        model_output_sizes):
+    result = client.predict_batched(
+        model_name,
+        model_inputs,
+        model_output_sizes,
+        batch_size=1000,
+        shared_mem=shared_mem,
+        stream=stream
+    )
+    ground_truth = get_ground_truth(model_inputs)
+
+    for output_name in sorted(ground_truth.keys()):
+        arrays_close(
+            result[output_name],
+            ground_truth[output_name],
+            atol=1e-5,
+            assert_close=True
+        )
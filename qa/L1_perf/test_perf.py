@@ -0,0 +1,137 @@
+# Copyright (c) 2022, NVIDIA CORPORATION.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Throughput regression checks for the identity model
+
+Each configuration's LoadReport is written to PERF_RESULTS as JSON, keyed by
+model repository, device, shared memory type and batch size. Its row
+throughput must be within PERF_TOLERANCE (as a fraction) of the throughput
+recorded for the same key in PERF_BASELINES. Configurations without a
+baseline are recorded but not checked. Set PERF_UPDATE_BASELINES=1 to write
+this run's throughput as the new baselines, and SKIP_PERF=1 to skip the
+stage.
+"""
+
+import json
+import os
+
+import numpy as np
+import pytest
+
+from rapids_triton import Client
+from rapids_triton.testing import get_random_seed, run_load
+
+QA_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BASELINES_PATH = os.environ.get(
+    'PERF_BASELINES', os.path.join(QA_DIR, 'L1_perf', 'baselines.json')
+)
+RESULTS_PATH = os.environ.get(
+    'PERF_RESULTS', os.path.join(QA_DIR, 'logs', 'perf_results.json')
+)
+TOLERANCE = float(os.environ.get('PERF_TOLERANCE', 0.2))
+DURATION = float(os.environ.get('PERF_DURATION', 5.0))
+UPDATE_BASELINES = os.environ.get('PERF_UPDATE_BASELINES', '0') != '0'
+
+pytestmark = pytest.mark.skipif(
+    os.environ.get('SKIP_PERF', '0') != '0', reason='SKIP_PERF is set'
+)
+
+
+def valid_shm_modes():
+    modes = [None]
+    if os.environ.get('CPU_ONLY', 0) == 0:
+        modes.append('cuda')
+    return modes
+
+
+def configuration_key(shared_mem, rows):
+    repo = os.path.basename(
+        os.environ.get('MODEL_REPO', 'model_repository').rstrip('/')
+    )
+    device = 'gpu' if os.environ.get('CPU_ONLY', 0) == 0 else 'cpu'
+    return '/'.join((repo, device, shared_mem or 'none', str(rows)))
+
+
+def load_json(path):
+    try:
+        with open(path) as json_file:
+            return json.load(json_file)
+    except FileNotFoundError:
+        return {}
+
+
+def save_json(path, data):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, 'w') as json_file:
+        json.dump(data, json_file, indent=2, sort_keys=True)
+        json_file.write('\n')
+
+
+def make_inputs(rows, rng):
+    return {'input__0': rng.random((rows, 1), dtype='float32')}
+
+
+def output_sizes(rows):
+    return {'output__0': rows * np.dtype('float32').itemsize}
+
+
+@pytest.fixture(scope='session')
+def client():
+    client = Client()
+    client.wait_for_server(60)
+    return client
+
+
+@pytest.fixture(scope='module')
+def results():
+    """Reports of this module's runs, merged into PERF_RESULTS once all
+    have finished so that runs against other repositories are kept"""
+    results = {}
+    yield results
+    save_json(RESULTS_PATH, {**load_json(RESULTS_PATH), **results})
+    if UPDATE_BASELINES:
+        baselines = load_json(BASELINES_PATH)
+        for key, report in results.items():
+            baselines[key] = {'row_throughput': report['row_throughput']}
+        save_json(BASELINES_PATH, baselines)
+
+
+@pytest.mark.parametrize("model_name", ['identity'])
+@pytest.mark.parametrize("shared_mem", valid_shm_modes())
+@pytest.mark.parametrize("rows", [1, 64, 1024])
+def test_perf(client, results, model_name, shared_mem, rows):
+    report = run_load(
+        model_name,
+        make_inputs,
+        output_sizes,
+        concurrency=4,
+        batch_sizes=rows,
+        duration=DURATION,
+        warmup=1.0,
+        shared_mem=shared_mem,
+        seed=get_random_seed()
+    )
+    print(report)
+    key = configuration_key(shared_mem, rows)
+    results[key] = report.as_dict()
+
+    assert report.failures == 0
+    assert report.requests > 0
+    baseline = load_json(BASELINES_PATH).get(key)
+    if baseline is not None and not UPDATE_BASELINES:
+        minimum = baseline['row_throughput'] * (1 - TOLERANCE)
+        assert report.row_throughput >= minimum, (
+            f'{key}: {report.row_throughput:.1f} rows/s is below the'
+            f' baseline of {baseline["row_throughput"]:.1f} rows/s'
+        )
@@ -20,7 +20,8 @@ SERVER_ARGS=""
 UUID="$(cat /proc/sys/kernel/random/uuid)"
 CONTAINER_NAME="rapids_triton-ci-$UUID"
 DOCKER_RUN=0
-DOCKER_ARGS="-d -p 8000:8000 -p 8001:8001 -p 8002:8002 --name ${CONTAINER_NAME}"
+# The host IPC namespace lets tests pass inputs in system shared memory
+DOCKER_ARGS="-d -p 8000:8000 -p 8001:8001 -p 8002:8002 --ipc=host --name ${CONTAINER_NAME}"
 TRITON_PID=""
 LOG_DIR="${QA_DIR}/logs"
 SERVER_LOG="${LOG_DIR}/${UUID}-server.log"
@@ -35,6 +36,8 @@ then
   MODEL_REPO="${QA_DIR}/L0_e2e/model_repository"
 fi
 MODEL_REPO="$(readlink -f $MODEL_REPO)"
+# The performance stage keys its results by model repository
+export MODEL_REPO
 
 DOCKER_ARGS="${DOCKER_ARGS} -v ${MODEL_REPO}:/models"
 